@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+/*  Compares FlatHashMap with HashMap and std::unordered_map.
+
+    Each map has the same keys inserted, looked up in a shuffled order, looked up with keys
+    that aren't there, iterated over and then removed. Run it with the number of keys as an
+    argument to try different sizes.
+*/
+
+namespace
+{
+//==============================================================================
+template <typename Key>
+struct JuceHashMap
+{
+    static constexpr const char* name = "HashMap";
+
+    void insert (const Key& key, int value)     { map.set (key, value); }
+    int lookup (const Key& key) const           { return map[key]; }
+    void erase (const Key& key)                 { map.remove (key); }
+
+    juce::int64 sum() const
+    {
+        juce::int64 total = 0;
+
+        for (auto value : map)
+            total += value;
+
+        return total;
+    }
+
+    juce::HashMap<Key, int> map;
+};
+
+template <typename Key>
+struct StdUnorderedMap
+{
+    static constexpr const char* name = "std::unordered_map";
+
+    void insert (const Key& key, int value)     { map[key] = value; }
+    void erase (const Key& key)                 { map.erase (key); }
+
+    int lookup (const Key& key) const
+    {
+        const auto found = map.find (key);
+        return found != map.end() ? found->second : 0;
+    }
+
+    juce::int64 sum() const
+    {
+        juce::int64 total = 0;
+
+        for (auto& item : map)
+            total += item.second;
+
+        return total;
+    }
+
+    std::unordered_map<Key, int> map;
+};
+
+template <typename Key>
+struct JuceFlatHashMap
+{
+    static constexpr const char* name = "FlatHashMap";
+
+    void insert (const Key& key, int value)     { map.set (key, value); }
+    void erase (const Key& key)                 { map.remove (key); }
+
+    int lookup (const Key& key) const
+    {
+        const auto* value = map.getValuePointer (key);
+        return value != nullptr ? *value : 0;
+    }
+
+    juce::int64 sum() const
+    {
+        juce::int64 total = 0;
+
+        for (auto value : map)
+            total += value;
+
+        return total;
+    }
+
+    juce::FlatHashMap<Key, int> map;
+};
+
+//==============================================================================
+// Stops the compiler from optimising away the results
+volatile juce::int64 sink = 0;
+
+template <typename Function>
+double timeInMilliseconds (Function&& function)
+{
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    function();
+    return juce::Time::getMillisecondCounterHiRes() - start;
+}
+
+template <typename Map, typename Key>
+void runBenchmark (const std::vector<Key>& keys, const std::vector<Key>& missingKeys)
+{
+    std::vector<Key> shuffled (keys);
+    std::shuffle (shuffled.begin(), shuffled.end(), std::mt19937 (1234));
+
+    Map map;
+
+    const auto insertTime = timeInMilliseconds ([&]
+    {
+        for (size_t i = 0; i < keys.size(); ++i)
+            map.insert (keys[i], (int) i);
+    });
+
+    const auto lookupTime = timeInMilliseconds ([&]
+    {
+        juce::int64 total = 0;
+
+        for (auto& key : shuffled)
+            total += map.lookup (key);
+
+        sink = total;
+    });
+
+    const auto missTime = timeInMilliseconds ([&]
+    {
+        juce::int64 total = 0;
+
+        for (auto& key : missingKeys)
+            total += map.lookup (key);
+
+        sink = total;
+    });
+
+    const auto iterateTime = timeInMilliseconds ([&] { sink = map.sum(); });
+
+    const auto eraseTime = timeInMilliseconds ([&]
+    {
+        for (auto& key : shuffled)
+            map.erase (key);
+    });
+
+    std::printf ("  %-20s %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                 Map::name, insertTime, lookupTime, missTime, iterateTime, eraseTime);
+}
+
+template <typename Key>
+void runBenchmarks (const char* title, const std::vector<Key>& keys, const std::vector<Key>& missingKeys)
+{
+    std::printf ("\n%s (%d keys, times in ms)\n", title, (int) keys.size());
+    std::printf ("  %-20s %10s %10s %10s %10s %10s\n", "", "insert", "lookup", "miss", "iterate", "erase");
+
+    runBenchmark<JuceHashMap<Key>> (keys, missingKeys);
+    runBenchmark<StdUnorderedMap<Key>> (keys, missingKeys);
+    runBenchmark<JuceFlatHashMap<Key>> (keys, missingKeys);
+}
+} // namespace
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const auto numKeys = argc > 1 ? juce::jmax (1, juce::String (argv[1]).getIntValue()) : 1000000;
+
+    juce::Random random (42);
+
+    // Even numbers are inserted and odd ones are looked up as misses
+    std::vector<int> intKeys, missingIntKeys;
+
+    for (int i = 0; i < numKeys; ++i)
+    {
+        const auto key = random.nextInt() & ~1;
+        intKeys.push_back (key);
+        missingIntKeys.push_back (key | 1);
+    }
+
+    runBenchmarks ("int keys", intKeys, missingIntKeys);
+
+    std::vector<juce::String> stringKeys, missingStringKeys;
+
+    for (auto key : intKeys)
+    {
+        stringKeys.push_back ("parameter_" + juce::String::toHexString (key));
+        missingStringKeys.push_back ("missing_" + juce::String::toHexString (key));
+    }
+
+    runBenchmarks ("String keys", stringKeys, missingStringKeys);
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*  Times some typical String workloads, and counts the heap allocations that each one makes.
+
+    Pass a number on the command line to scale the number of iterations. The allocations are
+    counted by replacing the global operator new, so memory that's allocated with std::malloc,
+    such as a HeapBlock's, isn't included. That can't be done when JUCE's own allocation hooks
+    are enabled, so the counts are only shown when they're off.
+*/
+
+#if ! JUCE_ENABLE_ALLOCATION_HOOKS
+namespace
+{
+std::atomic<size_t> numAllocations { 0 };
+}
+
+void* operator new (size_t size)
+{
+    numAllocations.fetch_add (1, std::memory_order_relaxed);
+
+    if (auto* p = std::malloc (size > 0 ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (size_t size)                  { return operator new (size); }
+void operator delete (void* p) noexcept             { std::free (p); }
+void operator delete[] (void* p) noexcept           { std::free (p); }
+void operator delete (void* p, size_t) noexcept     { std::free (p); }
+void operator delete[] (void* p, size_t) noexcept   { std::free (p); }
+#endif
+
+namespace
+{
+using namespace juce;
+
+// Stops the compiler from optimising away the results
+volatile size_t sink = 0;
+
+size_t getNumAllocations() noexcept
+{
+   #if JUCE_ENABLE_ALLOCATION_HOOKS
+    return 0;
+   #else
+    return numAllocations.load();
+   #endif
+}
+
+template <typename Function>
+void run (const char* name, int numIterations, Function&& function)
+{
+    const auto startAllocations = getNumAllocations();
+    const auto start = Time::getMillisecondCounterHiRes();
+
+    size_t total = 0;
+
+    for (int i = 0; i < numIterations; ++i)
+        total += function (i);
+
+    const auto elapsed = Time::getMillisecondCounterHiRes() - start;
+    const auto allocations = getNumAllocations() - startAllocations;
+    sink = total;
+
+    std::printf ("  %-32s %10.2f %12.1f %14.2f\n",
+                 name, elapsed, elapsed * 1.0e6 / numIterations, (double) allocations / numIterations);
+}
+
+const char* const jsonDocument = R"({
+    "name": "Lead synth",
+    "gain": 0.75,
+    "voices": 8,
+    "tags": [ "bright", "mono", "lead" ],
+    "envelope": { "attack": 0.01, "decay": 0.2, "sustain": 0.8, "release": 0.5 }
+})";
+} // namespace
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    const auto scale = argc > 1 ? jmax (1, String (argv[1]).getIntValue()) : 1;
+    const auto n = 1000000 * scale;
+
+    std::printf ("%-34s %10s %12s %14s\n", "", "total ms", "ns per op", "allocs per op");
+
+    run ("copy a short token", n, [] (int)
+    {
+        String token ("id");
+        String copy (token);
+        return (size_t) copy.length();
+    });
+
+    run ("build an id", n, [] (int i)
+    {
+        const auto id = "p" + String (i & 1023);
+        return (size_t) id.length();
+    });
+
+    const String folder ("/home/user"), subFolder ("Documents"), fileName ("file.txt");
+
+    run ("join a path", n, [&] (int)
+    {
+        const auto path = folder + "/" + subFolder + "/" + fileName;
+        return (size_t) path.length();
+    });
+
+    run ("append 1000 short strings", n / 1000, [] (int)
+    {
+        String text;
+
+        for (int j = 0; j < 1000; ++j)
+            text += "ab";
+
+        return (size_t) text.length();
+    });
+
+    run ("append 1000 numbers", n / 1000, [] (int)
+    {
+        String text;
+
+        for (int j = 0; j < 1000; ++j)
+            text << j << ", ";
+
+        return (size_t) text.length();
+    });
+
+    run ("format a log message", n / 4, [] (int i)
+    {
+        String message;
+        message << "value " << i << " at " << 0.5 << " seconds";
+        return (size_t) message.length();
+    });
+
+    const std::string_view view ("some text from a parser");
+
+    run ("create from a string_view", n, [&] (int)
+    {
+        const String text (view);
+        return (size_t) text.length();
+    });
+
+    const String text (view);
+
+    run ("compare with a string_view", n, [&] (int)
+    {
+        return (size_t) (text == view ? 1 : 0);
+    });
+
+    StringArray items;
+
+    for (int i = 0; i < 1000; ++i)
+        items.add ("item" + String (i));
+
+    run ("copy a StringArray of 1000", n / 1000, [&] (int)
+    {
+        const StringArray copy (items);
+        return (size_t) copy.size();
+    });
+
+    const String jsonText (jsonDocument);
+    const std::string_view jsonView (jsonDocument);
+
+    run ("JSON::parse", n / 100, [&] (int)
+    {
+        return (size_t) JSON::parse (jsonText).getDynamicObject()->getProperties().size();
+    });
+
+    run ("JSON::parseUTF8", n / 100, [&] (int)
+    {
+        return (size_t) JSON::parseUTF8 (jsonView).getDynamicObject()->getProperties().size();
+    });
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A non-owning view of a set of channels of audio data.
+
+    An AudioBufferView is just a pointer to an array of channel pointers, plus a range
+    of channels and samples, so it can be created, copied and narrowed down with
+    getChannelRange() and getSampleRange() without ever touching the heap. This makes it
+    a cheap way to pass around parts of an AudioBuffer, or blocks of memory handed out
+    by an AudioScratchArena, on the audio thread.
+
+    The view doesn't keep the data alive, so the buffer it refers to must outlive it,
+    and mustn't be resized while the view is in use.
+
+    @see AudioBuffer, AudioScratchArena
+
+    @tags{Audio}
+*/
+template <typename SampleType>
+class AudioBufferView
+{
+public:
+    //==============================================================================
+    /** Creates an empty view. */
+    AudioBufferView() noexcept = default;
+
+    /** Creates a view of a set of channels.
+
+        @param channelData      an array of pointers to the channels' data. This array
+                                must stay valid for as long as the view is used
+        @param numChannelsIn    the number of channels in the channelData array
+        @param startSampleIn    the index of the first sample in each channel to use
+        @param numSamplesIn     the number of samples in the view
+    */
+    AudioBufferView (SampleType* const* channelData, int numChannelsIn, int startSampleIn, int numSamplesIn) noexcept
+        : channels (channelData),
+          numChannels (numChannelsIn),
+          startSample (startSampleIn),
+          numSamples (numSamplesIn)
+    {
+        jassert (numChannels >= 0 && startSample >= 0 && numSamples >= 0);
+        jassert (channels != nullptr || numChannels == 0);
+    }
+
+    /** Creates a view of a set of channels, starting at their first samples. */
+    AudioBufferView (SampleType* const* channelData, int numChannelsIn, int numSamplesIn) noexcept
+        : AudioBufferView (channelData, numChannelsIn, 0, numSamplesIn)
+    {
+    }
+
+    /** Creates a view of the whole of an AudioBuffer. */
+    AudioBufferView (AudioBuffer<SampleType>& buffer) noexcept
+        : AudioBufferView (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), 0, buffer.getNumSamples())
+    {
+    }
+
+    /** Creates a view of a range of samples in an AudioBuffer. */
+    AudioBufferView (AudioBuffer<SampleType>& buffer, int startSampleIn, int numSamplesIn) noexcept
+        : AudioBufferView (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), startSampleIn, numSamplesIn)
+    {
+        jassert (startSampleIn + numSamplesIn <= buffer.getNumSamples());
+    }
+
+    //==============================================================================
+    /** Returns the number of channels in the view. */
+    int getNumChannels() const noexcept                     { return numChannels; }
+
+    /** Returns the number of samples in each channel of the view. */
+    int getNumSamples() const noexcept                      { return numSamples; }
+
+    /** Returns true if the view has no channels or no samples. */
+    bool isEmpty() const noexcept                           { return numChannels == 0 || numSamples == 0; }
+
+    /** Returns a writeable pointer to one of the view's channels.
+        The sample index is relative to the start of the view.
+    */
+    SampleType* getWritePointer (int channelNumber, int sampleIndex = 0) const noexcept
+    {
+        jassert (isPositiveAndBelow (channelNumber, numChannels));
+        jassert (isPositiveAndNotGreaterThan (sampleIndex, numSamples));
+        return channels[channelNumber] + startSample + sampleIndex;
+    }
+
+    /** Returns a read-only pointer to one of the view's channels.
+        The sample index is relative to the start of the view.
+    */
+    const SampleType* getReadPointer (int channelNumber, int sampleIndex = 0) const noexcept
+    {
+        return getWritePointer (channelNumber, sampleIndex);
+    }
+
+    /** Returns one of the samples in the view. */
+    SampleType getSample (int channelNumber, int sampleIndex) const noexcept
+    {
+        jassert (isPositiveAndBelow (sampleIndex, numSamples));
+        return *getReadPointer (channelNumber, sampleIndex);
+    }
+
+    /** Sets one of the samples in the view. */
+    void setSample (int channelNumber, int sampleIndex, SampleType newValue) const noexcept
+    {
+        jassert (isPositiveAndBelow (sampleIndex, numSamples));
+        *getWritePointer (channelNumber, sampleIndex) = newValue;
+    }
+
+    //==============================================================================
+    /** Returns a view of a range of this view's channels. */
+    AudioBufferView getChannelRange (int firstChannel, int numChannelsToUse) const noexcept
+    {
+        jassert (firstChannel >= 0 && numChannelsToUse >= 0 && firstChannel + numChannelsToUse <= numChannels);
+        return { channels + firstChannel, numChannelsToUse, startSample, numSamples };
+    }
+
+    /** Returns a view of a range of this view's samples.
+        The start index is relative to the start of this view.
+    */
+    AudioBufferView getSampleRange (int firstSample, int numSamplesToUse) const noexcept
+    {
+        jassert (firstSample >= 0 && numSamplesToUse >= 0 && firstSample + numSamplesToUse <= numSamples);
+        return { channels, numChannels, startSample + firstSample, numSamplesToUse };
+    }
+
+    //==============================================================================
+    /** Clears all the samples in the view. */
+    void clear() const noexcept
+    {
+        for (int i = 0; i < numChannels; ++i)
+            FloatVectorOperations::clear (getWritePointer (i), numSamples);
+    }
+
+    /** Multiplies all the samples in the view by a gain. */
+    void applyGain (SampleType gain) const noexcept
+    {
+        if (approximatelyEqual (gain, (SampleType) 1))
+            return;
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            if (approximatelyEqual (gain, (SampleType) 0))
+                FloatVectorOperations::clear (getWritePointer (i), numSamples);
+            else
+                FloatVectorOperations::multiply (getWritePointer (i), gain, numSamples);
+        }
+    }
+
+    /** Copies the contents of another view into this one.
+        Only the channels and samples that both views have in common are copied.
+    */
+    void copyFrom (const AudioBufferView& source) const noexcept
+    {
+        const auto channelsToCopy = jmin (numChannels, source.numChannels);
+        const auto samplesToCopy = jmin (numSamples, source.numSamples);
+
+        for (int i = 0; i < channelsToCopy; ++i)
+            FloatVectorOperations::copy (getWritePointer (i), source.getReadPointer (i), samplesToCopy);
+    }
+
+    /** Adds the contents of another view to this one, with an optional gain.
+        Only the channels and samples that both views have in common are used.
+    */
+    void addFrom (const AudioBufferView& source, SampleType gain = (SampleType) 1) const noexcept
+    {
+        const auto channelsToAdd = jmin (numChannels, source.numChannels);
+        const auto samplesToAdd = jmin (numSamples, source.numSamples);
+
+        for (int i = 0; i < channelsToAdd; ++i)
+        {
+            if (approximatelyEqual (gain, (SampleType) 1))
+                FloatVectorOperations::add (getWritePointer (i), source.getReadPointer (i), samplesToAdd);
+            else
+                FloatVectorOperations::addWithMultiply (getWritePointer (i), source.getReadPointer (i), gain, samplesToAdd);
+        }
+    }
+
+    /** Returns the highest absolute sample value within the view. */
+    SampleType getMagnitude() const noexcept
+    {
+        SampleType magnitude = 0;
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            const auto r = FloatVectorOperations::findMinAndMax (getReadPointer (i), numSamples);
+            magnitude = jmax (magnitude, r.getStart(), -r.getStart(), jmax (r.getEnd(), -r.getEnd()));
+        }
+
+        return magnitude;
+    }
+
+private:
+    //==============================================================================
+    SampleType* const* channels = nullptr;
+    int numChannels = 0, startSample = 0, numSamples = 0;
+};
+
+} // namespace juce
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+AudioScratchArena::~AudioScratchArena() = default;
+
+void AudioScratchArena::prepare (size_t numBytes)
+{
+    storage.malloc (numBytes + defaultAlignment);
+
+    auto address = (size_t) reinterpret_cast<pointer_sized_uint> (storage.get());
+    alignedStorage = storage.get() + (alignUp (address, defaultAlignment) - address);
+
+    capacity = numBytes;
+    numBytesUsed = 0;
+    peakNumBytesUsed = 0;
+    numFailedAllocations = 0;
+}
+
+void AudioScratchArena::release()
+{
+    storage.free();
+    alignedStorage = nullptr;
+    capacity = 0;
+    numBytesUsed = 0;
+}
+
+void* AudioScratchArena::allocate (size_t numBytes, size_t alignment) noexcept
+{
+    jassert (isPowerOfTwo (alignment));
+
+    const auto start = alignUp (numBytesUsed, alignment);
+
+    if (alignedStorage == nullptr || start + numBytes > capacity)
+    {
+        // The arena is full - you'll need to reserve more space in prepare()!
+        jassertfalse;
+        ++numFailedAllocations;
+        return nullptr;
+    }
+
+    numBytesUsed = start + numBytes;
+    peakNumBytesUsed = jmax (peakNumBytesUsed, numBytesUsed);
+
+    return alignedStorage + start;
+}
+
+} // namespace juce
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A block of pre-allocated memory that hands out temporary buffers on the audio thread.
+
+    Call prepare() with the amount of memory you'll need before the audio starts, then at
+    the start of each audio callback call reset(), and use allocateBuffer() to get as many
+    temporary AudioBufferViews as you need. Each allocation just moves a pointer along, so
+    it never locks or calls malloc, and all the memory is reclaimed at once by the next
+    reset(). All the channels handed out are aligned to defaultAlignment bytes.
+
+    If the arena runs out of space, the allocation fails: an empty view is returned and
+    the failure is counted by getNumFailedAllocations(), rather than the arena growing.
+
+    An arena must only be used by one thread at a time.
+
+    @code
+    void prepareToPlay (int samplesPerBlock, double) override
+    {
+        arena.prepare (AudioScratchArena::getBytesNeeded<float> (2, samplesPerBlock, 4));
+    }
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+    {
+        arena.reset();
+        auto temp = arena.allocateBuffer<float> (2, info.numSamples);
+        ...
+    }
+    @endcode
+
+    @see AudioBufferView
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioScratchArena
+{
+public:
+    //==============================================================================
+    /** Creates an empty arena. Call prepare() before allocating anything from it. */
+    AudioScratchArena() noexcept = default;
+
+    /** Destructor. */
+    ~AudioScratchArena();
+
+    //==============================================================================
+    /** The alignment used for each channel of audio handed out by the arena. */
+    static constexpr size_t defaultAlignment = 32;
+
+    /** Returns the number of bytes of arena space needed to allocate a number of
+        buffers of a given size.
+    */
+    template <typename SampleType>
+    static size_t getBytesNeeded (int numChannels, int numSamples, int numBuffers = 1) noexcept
+    {
+        const auto channelListSize = alignUp (sizeof (SampleType*) * (size_t) numChannels, alignof (SampleType*));
+        const auto channelSize = alignUp (sizeof (SampleType) * (size_t) numSamples, defaultAlignment);
+
+        return (size_t) numBuffers * (channelListSize + channelSize * (size_t) numChannels + defaultAlignment);
+    }
+
+    //==============================================================================
+    /** Allocates the arena's memory.
+        This must not be called while the audio thread might be using the arena.
+    */
+    void prepare (size_t numBytes);
+
+    /** Frees the arena's memory. */
+    void release();
+
+    /** Makes all the arena's memory available again.
+        Any views previously handed out by the arena must no longer be used.
+    */
+    void reset() noexcept                                   { numBytesUsed = 0; }
+
+    //==============================================================================
+    /** Allocates a raw block of memory from the arena.
+        Returns nullptr if there isn't enough space left.
+    */
+    void* allocate (size_t numBytes, size_t alignment = defaultAlignment) noexcept;
+
+    /** Allocates a temporary buffer from the arena.
+
+        Returns an empty view if there isn't enough space left.
+
+        @param numChannels      the number of channels needed
+        @param numSamples       the number of samples needed in each channel
+        @param clearData        if true, the returned buffer will be filled with zeros
+    */
+    template <typename SampleType>
+    AudioBufferView<SampleType> allocateBuffer (int numChannels, int numSamples, bool clearData = true) noexcept
+    {
+        jassert (numChannels >= 0 && numSamples >= 0);
+
+        const auto channelSize = alignUp (sizeof (SampleType) * (size_t) numSamples, defaultAlignment);
+        const auto marker = numBytesUsed;
+
+        auto* channelList = static_cast<SampleType**> (allocate (sizeof (SampleType*) * (size_t) numChannels, alignof (SampleType*)));
+        auto* sampleData = static_cast<char*> (allocate (channelSize * (size_t) numChannels));
+
+        if (channelList == nullptr || sampleData == nullptr)
+        {
+            numBytesUsed = marker;
+            return {};
+        }
+
+        for (int i = 0; i < numChannels; ++i)
+            channelList[i] = reinterpret_cast<SampleType*> (sampleData + channelSize * (size_t) i);
+
+        AudioBufferView<SampleType> view (channelList, numChannels, numSamples);
+
+        if (clearData)
+            view.clear();
+
+        return view;
+    }
+
+    //==============================================================================
+    /** Returns the size of the arena in bytes. */
+    size_t getCapacity() const noexcept                     { return capacity; }
+
+    /** Returns the number of bytes currently allocated from the arena. */
+    size_t getNumBytesUsed() const noexcept                 { return numBytesUsed; }
+
+    /** Returns the highest number of bytes that have been in use since prepare() was called. */
+    size_t getPeakNumBytesUsed() const noexcept             { return peakNumBytesUsed; }
+
+    /** Returns the number of allocations that have failed because the arena was full. */
+    int getNumFailedAllocations() const noexcept            { return numFailedAllocations; }
+
+    //==============================================================================
+    /**
+        Frees all the memory that was allocated from an arena during the lifetime of this
+        object, so that a function can use the arena for its own temporary buffers without
+        eating into the space available to the rest of the callback.
+
+        @tags{Audio}
+    */
+    class ScopedRewind
+    {
+    public:
+        explicit ScopedRewind (AudioScratchArena& arenaToUse) noexcept
+            : arena (arenaToUse), marker (arenaToUse.numBytesUsed)
+        {
+        }
+
+        ~ScopedRewind() noexcept
+        {
+            arena.numBytesUsed = marker;
+        }
+
+    private:
+        AudioScratchArena& arena;
+        const size_t marker;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRewind)
+    };
+
+private:
+    //==============================================================================
+    static constexpr size_t alignUp (size_t value, size_t alignment) noexcept
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    HeapBlock<char> storage;
+    char* alignedStorage = nullptr;
+    size_t capacity = 0, numBytesUsed = 0, peakNumBytesUsed = 0;
+    int numFailedAllocations = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioScratchArena)
+};
+
+} // namespace juce
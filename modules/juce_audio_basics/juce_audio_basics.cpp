@@ -79,17 +79,22 @@
 #include "buffers/juce_FloatVectorOperations.cpp"
 #include "buffers/juce_AudioChannelSet.cpp"
 #include "buffers/juce_AudioProcessLoadMeasurer.cpp"
+#include "buffers/juce_AudioScratchArena.cpp"
 #include "utilities/juce_IIRFilter.cpp"
+#include "utilities/juce_IIRFilterBank.cpp"
 #include "utilities/juce_LagrangeInterpolator.cpp"
 #include "utilities/juce_WindowedSincInterpolator.cpp"
 #include "utilities/juce_Interpolators.cpp"
 #include "utilities/juce_SmoothedValue.cpp"
+#include "utilities/juce_FDNReverb.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
 #include "midi/juce_MidiKeyboardState.cpp"
 #include "midi/juce_MidiMessage.cpp"
 #include "midi/juce_MidiMessageSequence.cpp"
 #include "midi/juce_MidiRPN.cpp"
+#include "midi/juce_CompactMidiSequence.cpp"
+#include "midi/juce_MidiFileStreamReader.cpp"
 #include "mpe/juce_MPEValue.cpp"
 #include "mpe/juce_MPENote.cpp"
 #include "mpe/juce_MPEZoneLayout.cpp"
@@ -100,8 +105,10 @@
 #include "mpe/juce_MPESynthesiser.cpp"
 #include "mpe/juce_MPEUtils.cpp"
 #include "sources/juce_BufferingAudioSource.cpp"
+#include "sources/juce_PrefetchingAudioSource.cpp"
 #include "sources/juce_ChannelRemappingAudioSource.cpp"
 #include "sources/juce_IIRFilterAudioSource.cpp"
+#include "sources/juce_LockFreeMixerAudioSource.cpp"
 #include "sources/juce_MemoryAudioSource.cpp"
 #include "sources/juce_MixerAudioSource.cpp"
 #include "sources/juce_ResamplingAudioSource.cpp"
@@ -104,19 +104,26 @@ JUCE_BEGIN_IGNORE_WARNINGS_MSVC (4661)
 #include "buffers/juce_FloatVectorOperations.h"
 JUCE_END_IGNORE_WARNINGS_MSVC
 #include "buffers/juce_AudioSampleBuffer.h"
+#include "buffers/juce_AudioBufferView.h"
+#include "buffers/juce_AudioScratchArena.h"
 #include "buffers/juce_AudioChannelSet.h"
 #include "buffers/juce_AudioProcessLoadMeasurer.h"
 #include "utilities/juce_Decibels.h"
 #include "utilities/juce_IIRFilter.h"
+#include "utilities/juce_IIRFilterBank.h"
 #include "utilities/juce_GenericInterpolator.h"
 #include "utilities/juce_Interpolators.h"
 #include "utilities/juce_SmoothedValue.h"
+#include "utilities/juce_SmoothedValueBank.h"
+#include "utilities/juce_FDNReverb.h"
 #include "utilities/juce_Reverb.h"
 #include "utilities/juce_ADSR.h"
 #include "midi/juce_MidiMessage.h"
 #include "midi/juce_MidiBuffer.h"
 #include "midi/juce_MidiMessageSequence.h"
 #include "midi/juce_MidiFile.h"
+#include "midi/juce_CompactMidiSequence.h"
+#include "midi/juce_MidiFileStreamReader.h"
 #include "midi/juce_MidiKeyboardState.h"
 #include "midi/juce_MidiRPN.h"
 #include "mpe/juce_MPEValue.h"
@@ -131,8 +138,10 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "sources/juce_AudioSource.h"
 #include "sources/juce_PositionableAudioSource.h"
 #include "sources/juce_BufferingAudioSource.h"
+#include "sources/juce_PrefetchingAudioSource.h"
 #include "sources/juce_ChannelRemappingAudioSource.h"
 #include "sources/juce_IIRFilterAudioSource.h"
+#include "sources/juce_LockFreeMixerAudioSource.h"
 #include "sources/juce_MemoryAudioSource.h"
 #include "sources/juce_MixerAudioSource.h"
 #include "sources/juce_ResamplingAudioSource.h"
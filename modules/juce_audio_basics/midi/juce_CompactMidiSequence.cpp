@@ -0,0 +1,544 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace CompactMidiHelpers
+{
+    enum NoteKind
+    {
+        notANote,
+        noteOff,
+        noteOn
+    };
+
+    // Matches MidiMessage::isNoteOn() and isNoteOff(), where a note-on with a velocity of 0 is a note-off
+    static NoteKind getNoteKind (const uint8* data, int size) noexcept
+    {
+        if (size < 3)
+            return notANote;
+
+        const auto type = data[0] & 0xf0;
+
+        if (type == 0x80)
+            return noteOff;
+
+        if (type == 0x90)
+            return data[2] != 0 ? noteOn : noteOff;
+
+        return notANote;
+    }
+
+    static constexpr uint8 metaEventStatus = 0xff;
+}
+
+//==============================================================================
+CompactMidiSequence::CompactMidiSequence (const MidiMessageSequence& sequence)
+{
+    const auto numEvents = sequence.getNumEvents();
+    int numBytes = 0;
+
+    for (auto* event : sequence)
+        numBytes += event->message.getRawDataSize();
+
+    ensureStorageAllocated (numEvents, numBytes);
+
+    for (auto* event : sequence)
+        addEvent (event->message);
+
+    for (int i = 0; i < numEvents; ++i)
+        if (sequence.getEventPointer (i)->noteOffObject != nullptr)
+            noteOffIndices.set (i, sequence.getIndexOfMatchingKeyUp (i));
+}
+
+//==============================================================================
+void CompactMidiSequence::clear() noexcept
+{
+    times.clearQuick();
+    statuses.clearQuick();
+    offsets.clearQuick();
+    bytes.clearQuick();
+    noteOffIndices.clearQuick();
+}
+
+void CompactMidiSequence::ensureStorageAllocated (int numEvents, int numBytes)
+{
+    times.ensureStorageAllocated (numEvents);
+    statuses.ensureStorageAllocated (numEvents);
+    offsets.ensureStorageAllocated (numEvents);
+    noteOffIndices.ensureStorageAllocated (numEvents);
+    bytes.ensureStorageAllocated (numBytes);
+}
+
+void CompactMidiSequence::addEvent (double time, const uint8* data, int numBytes)
+{
+    jassert (data != nullptr && numBytes > 0);
+
+    times.add (time);
+    statuses.add (data[0]);
+    offsets.add (bytes.size());
+    bytes.addArray (data, numBytes);
+    noteOffIndices.add (-1);
+}
+
+void CompactMidiSequence::addEvent (const MidiMessage& message)
+{
+    addEvent (message.getTimeStamp(), message.getRawData(), message.getRawDataSize());
+}
+
+void CompactMidiSequence::addSequence (const CompactMidiSequence& other, double timeAdjustment)
+{
+    const auto firstNewEvent = getNumEvents();
+    const auto byteOffset = bytes.size();
+
+    ensureStorageAllocated (firstNewEvent + other.getNumEvents(), byteOffset + other.bytes.size());
+
+    for (auto time : other.times)
+        times.add (time + timeAdjustment);
+
+    for (auto offset : other.offsets)
+        offsets.add (offset + byteOffset);
+
+    for (auto index : other.noteOffIndices)
+        noteOffIndices.add (index >= 0 ? index + firstNewEvent : -1);
+
+    statuses.addArray (other.statuses);
+    bytes.addArray (other.bytes);
+}
+
+void CompactMidiSequence::sort()
+{
+    const auto numEvents = getNumEvents();
+
+    Array<uint8> kinds;
+    kinds.ensureStorageAllocated (numEvents);
+
+    for (int i = 0; i < numEvents; ++i)
+        kinds.add ((uint8) CompactMidiHelpers::getNoteKind (getEventData (i), getEventDataSize (i)));
+
+    Array<int> order;
+    order.ensureStorageAllocated (numEvents);
+
+    for (int i = 0; i < numEvents; ++i)
+        order.add (i);
+
+    // (the same ordering that MidiFile uses when reading a track)
+    std::stable_sort (order.begin(), order.end(), [this, &kinds] (int a, int b)
+    {
+        const auto t1 = times.getUnchecked (a);
+        const auto t2 = times.getUnchecked (b);
+
+        if (t1 < t2)  return true;
+        if (t2 < t1)  return false;
+
+        return kinds.getUnchecked (a) == CompactMidiHelpers::noteOff
+            && kinds.getUnchecked (b) == CompactMidiHelpers::noteOn;
+    });
+
+    applyOrder (order);
+    noteOffIndices.fill (-1);
+}
+
+void CompactMidiSequence::applyOrder (const Array<int>& order)
+{
+    CompactMidiSequence sorted;
+    sorted.ensureStorageAllocated (order.size(), bytes.size());
+
+    for (auto index : order)
+        sorted.addEvent (times.getUnchecked (index), getEventData (index), getEventDataSize (index));
+
+    *this = std::move (sorted);
+}
+
+void CompactMidiSequence::updateMatchedPairs()
+{
+    using namespace CompactMidiHelpers;
+
+    // A single pass that remembers the note-on still waiting for its note-off on each key.
+    // A note-on arriving while its key is still held needs a note-off inserted just before
+    // it: these are linked with a negative index until they've been inserted.
+    int heldNotes[16][128];
+    std::fill (&heldNotes[0][0], &heldNotes[0][0] + 16 * 128, -1);
+
+    Array<int> insertionPoints;
+    const auto numEvents = getNumEvents();
+
+    noteOffIndices.fill (-1);
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        auto* data = getEventData (i);
+        const auto kind = getNoteKind (data, getEventDataSize (i));
+
+        if (kind == notANote)
+            continue;
+
+        auto& held = heldNotes[data[0] & 0x0f][data[1] & 0x7f];
+
+        if (held >= 0)
+        {
+            if (kind == noteOn)
+            {
+                noteOffIndices.set (held, -2 - insertionPoints.size());
+                insertionPoints.add (i);
+            }
+            else
+            {
+                noteOffIndices.set (held, i);
+            }
+
+            held = -1;
+        }
+
+        if (kind == noteOn)
+            held = i;
+    }
+
+    if (insertionPoints.isEmpty())
+        return;
+
+    // Insert all the new note-offs in one go, shifting the indices of the links to match
+    auto getNewIndex = [&insertionPoints] (int oldIndex)
+    {
+        if (oldIndex <= -2)
+        {
+            const auto insertion = -2 - oldIndex;
+            return insertionPoints.getUnchecked (insertion) + insertion;
+        }
+
+        if (oldIndex < 0)
+            return -1;
+
+        const auto numBefore = std::upper_bound (insertionPoints.begin(), insertionPoints.end(), oldIndex) - insertionPoints.begin();
+        return oldIndex + (int) numBefore;
+    };
+
+    CompactMidiSequence result;
+    result.ensureStorageAllocated (numEvents + insertionPoints.size(), bytes.size() + 3 * insertionPoints.size());
+
+    for (int i = 0, nextInsertion = 0; i < numEvents; ++i)
+    {
+        auto* data = getEventData (i);
+
+        if (nextInsertion < insertionPoints.size() && insertionPoints.getUnchecked (nextInsertion) == i)
+        {
+            const uint8 noteOffData[] = { (uint8) (0x80 | (data[0] & 0x0f)), data[1], 0 };
+            result.addEvent (times.getUnchecked (i), noteOffData, 3);
+            ++nextInsertion;
+        }
+
+        result.addEvent (times.getUnchecked (i), data, getEventDataSize (i));
+        result.noteOffIndices.set (result.getNumEvents() - 1, getNewIndex (noteOffIndices.getUnchecked (i)));
+    }
+
+    *this = std::move (result);
+}
+
+void CompactMidiSequence::addTimeToEvents (double delta) noexcept
+{
+    for (auto& time : times)
+        time += delta;
+}
+
+//==============================================================================
+const uint8* CompactMidiSequence::getEventData (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, getNumEvents()));
+    return bytes.begin() + offsets.getUnchecked (index);
+}
+
+int CompactMidiSequence::getEventDataSize (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, getNumEvents()));
+
+    const auto end = index + 1 < offsets.size() ? offsets.getUnchecked (index + 1) : bytes.size();
+    return end - offsets.getUnchecked (index);
+}
+
+MidiMessage CompactMidiSequence::getEventMessage (int index) const
+{
+    return MidiMessage (getEventData (index), getEventDataSize (index), getEventTime (index));
+}
+
+double CompactMidiSequence::getStartTime() const noexcept
+{
+    return times.isEmpty() ? 0.0 : times.getFirst();
+}
+
+double CompactMidiSequence::getEndTime() const noexcept
+{
+    return times.isEmpty() ? 0.0 : times.getLast();
+}
+
+int CompactMidiSequence::getNextIndexAtTime (double time) const noexcept
+{
+    return (int) (std::lower_bound (times.begin(), times.end(), time) - times.begin());
+}
+
+int CompactMidiSequence::getIndexOfMatchingNoteOff (int index) const noexcept
+{
+    return isPositiveAndBelow (index, noteOffIndices.size()) ? noteOffIndices.getUnchecked (index) : -1;
+}
+
+double CompactMidiSequence::getTimeOfMatchingNoteOff (int index) const noexcept
+{
+    const auto noteOffIndex = getIndexOfMatchingNoteOff (index);
+    return noteOffIndex >= 0 ? times.getUnchecked (noteOffIndex) : 0.0;
+}
+
+//==============================================================================
+int CompactMidiSequence::addEventsToBuffer (MidiBuffer& dest,
+                                            int startIndex,
+                                            double startTime,
+                                            double endTime,
+                                            double sampleRate) const
+{
+    const auto numEvents = getNumEvents();
+    const auto lastPosition = jmax (0, roundToInt ((endTime - startTime) * sampleRate) - 1);
+    auto index = jmax (0, startIndex);
+
+    for (; index < numEvents; ++index)
+    {
+        const auto time = times.getUnchecked (index);
+
+        if (time >= endTime)
+            break;
+
+        // meta events only mean something inside a file, so they aren't played
+        if (statuses.getUnchecked (index) == CompactMidiHelpers::metaEventStatus)
+            continue;
+
+        const auto position = jlimit (0, lastPosition, roundToInt ((time - startTime) * sampleRate));
+        dest.addEvent (getEventData (index), getEventDataSize (index), position);
+    }
+
+    return index;
+}
+
+MidiMessageSequence CompactMidiSequence::toMidiMessageSequence() const
+{
+    MidiMessageSequence result;
+    const auto numEvents = getNumEvents();
+
+    for (int i = 0; i < numEvents; ++i)
+        result.addEvent (getEventMessage (i));
+
+    // the events must be in time order for the indices to match up
+    jassert (result.getNumEvents() == numEvents);
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        const auto noteOffIndex = noteOffIndices.getUnchecked (i);
+
+        if (noteOffIndex >= 0)
+            result.getEventPointer (i)->noteOffObject = result.getEventPointer (noteOffIndex);
+    }
+
+    return result;
+}
+
+//==============================================================================
+namespace CompactMidiHelpers
+{
+    static void readTrack (CompactMidiSequence& dest, const uint8* data, int size)
+    {
+        double time = 0;
+        uint8 lastStatusByte = 0;
+
+        MemoryBlock eventData (16);
+
+        // a rough guess, which saves most of the reallocation as the arrays grow
+        dest.ensureStorageAllocated (size / 4, size);
+
+        while (size > 0)
+        {
+            const auto delay = MidiMessage::readVariableLengthValue (data, size);
+
+            if (! delay.isValid())
+                break;
+
+            data += delay.bytesUsed;
+            size -= delay.bytesUsed;
+            time += delay.value;
+
+            if (size <= 0)
+                break;
+
+            const auto event = MidiFileHelpers::readFileEvent (data, size, lastStatusByte);
+
+            if (event.numBytesUsed <= 0)
+                break;
+
+            size -= event.numBytesUsed;
+            data += event.numBytesUsed;
+
+            eventData.ensureSize ((size_t) event.getSize());
+            event.copyTo (static_cast<uint8*> (eventData.getData()));
+            dest.addEvent (time, static_cast<const uint8*> (eventData.getData()), event.getSize());
+
+            if ((event.getStatusByte() & 0xf0) != 0xf0)
+                lastStatusByte = event.getStatusByte();
+        }
+    }
+}
+
+bool CompactMidiFile::readFrom (const void* sourceData, size_t numBytes, bool createMatchingNoteOffs, int* fileType)
+{
+    clear();
+
+    auto size = numBytes;
+    auto d = static_cast<const uint8*> (sourceData);
+
+    const auto optHeader = MidiFileHelpers::parseMidiHeader (d, size);
+
+    if (! optHeader.hasValue())
+        return false;
+
+    const auto header = *optHeader;
+    timeFormat = header.timeFormat;
+
+    d += header.bytesRead;
+    size -= (size_t) header.bytesRead;
+
+    for (int track = 0; track < header.numberOfTracks; ++track)
+    {
+        const auto optChunkType = MidiFileHelpers::tryRead<uint32> (d, size);
+
+        if (! optChunkType.hasValue())
+            return false;
+
+        const auto optChunkSize = MidiFileHelpers::tryRead<uint32> (d, size);
+
+        if (! optChunkSize.hasValue())
+            return false;
+
+        const auto chunkSize = *optChunkSize;
+
+        if (size < chunkSize)
+            return false;
+
+        if (*optChunkType == ByteOrder::bigEndianInt ("MTrk"))
+        {
+            auto* sequence = tracks.add (new CompactMidiSequence());
+            CompactMidiHelpers::readTrack (*sequence, d, (int) chunkSize);
+            sequence->sort();
+
+            if (createMatchingNoteOffs)
+                sequence->updateMatchedPairs();
+        }
+
+        size -= chunkSize;
+        d += chunkSize;
+    }
+
+    const auto successful = (size == 0);
+
+    if (successful && fileType != nullptr)
+        *fileType = header.fileType;
+
+    return successful;
+}
+
+bool CompactMidiFile::readFrom (const File& file, bool createMatchingNoteOffs, int* fileType)
+{
+    MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() != nullptr)
+        return readFrom (mappedFile.getData(), mappedFile.getSize(), createMatchingNoteOffs, fileType);
+
+    FileInputStream stream (file);
+    return stream.openedOk() && readFrom (stream, createMatchingNoteOffs, fileType);
+}
+
+bool CompactMidiFile::readFrom (InputStream& sourceStream, bool createMatchingNoteOffs, int* fileType)
+{
+    clear();
+    MemoryBlock data;
+
+    const int maxSensibleMidiFileSize = 200 * 1024 * 1024;
+
+    if (! sourceStream.readIntoMemoryBlock (data, maxSensibleMidiFileSize))
+        return false;
+
+    return readFrom (data.getData(), data.getSize(), createMatchingNoteOffs, fileType);
+}
+
+void CompactMidiFile::clear() noexcept
+{
+    tracks.clear();
+}
+
+double CompactMidiFile::getLastTimestamp() const noexcept
+{
+    double t = 0.0;
+
+    for (auto* track : tracks)
+        t = jmax (t, track->getEndTime());
+
+    return t;
+}
+
+void CompactMidiFile::convertTimestampTicksToSeconds()
+{
+    if (timeFormat == 0)
+        return;
+
+    // (tick, seconds per quarter note) for each tempo event, in the same order as MidiFile::findAllTempoEvents()
+    Array<std::pair<double, double>> tempoChanges;
+
+    for (auto* track : tracks)
+    {
+        for (int i = 0; i < track->getNumEvents(); ++i)
+        {
+            auto* data = track->getEventData (i);
+            const auto size = track->getEventDataSize (i);
+
+            if (MidiFileHelpers::isTempoEvent (data, size))
+                tempoChanges.add ({ track->getEventTime (i), MidiFileHelpers::getTempoSecondsPerQuarterNote (data, size) });
+        }
+    }
+
+    std::stable_sort (tempoChanges.begin(), tempoChanges.end(),
+                      [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+    MidiFileHelpers::TempoMap tempoMap (timeFormat);
+
+    for (auto& change : tempoChanges)
+        tempoMap.addTempoChange (change.first, change.second);
+
+    for (auto* track : tracks)
+        for (auto& time : track->times)
+            time = tempoMap.ticksToSeconds (time);
+}
+
+MidiFile CompactMidiFile::toMidiFile() const
+{
+    MidiFile result;
+    result.setTicksPerQuarterNote (timeFormat);
+
+    for (auto* track : tracks)
+        result.addTrack (track->toMidiMessageSequence());
+
+    return result;
+}
+
+} // namespace juce
@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A sequence of timestamped midi events, stored as flat arrays.
+
+    Unlike MidiMessageSequence, which allocates a MidiEventHolder and a MidiMessage for
+    every event, this keeps the times, the status bytes and the raw bytes of all the
+    events in a few contiguous arrays, so a sequence with a million events is a handful
+    of allocations, and scanning it only touches the data that's needed.
+
+    The events must be in time order for getNextIndexAtTime() and updateMatchedPairs()
+    to work, which sort() guarantees. Any index returned by the methods here is only
+    valid until the sequence is next modified.
+
+    @see CompactMidiFile, MidiMessageSequence
+
+    @tags{Audio}
+*/
+class JUCE_API  CompactMidiSequence
+{
+public:
+    //==============================================================================
+    /** Creates an empty sequence. */
+    CompactMidiSequence() = default;
+
+    /** Creates a copy of a MidiMessageSequence, including its matched note pairs. */
+    explicit CompactMidiSequence (const MidiMessageSequence& sequence);
+
+    CompactMidiSequence (const CompactMidiSequence&) = default;
+    CompactMidiSequence& operator= (const CompactMidiSequence&) = default;
+    CompactMidiSequence (CompactMidiSequence&&) noexcept = default;
+    CompactMidiSequence& operator= (CompactMidiSequence&&) noexcept = default;
+
+    //==============================================================================
+    /** Removes all the events. */
+    void clear() noexcept;
+
+    /** Pre-allocates space for a number of events, with a total number of bytes. */
+    void ensureStorageAllocated (int numEvents, int numBytes);
+
+    /** Appends an event to the end of the sequence.
+
+        This doesn't keep the sequence sorted, so call sort() afterwards if the events
+        weren't added in time order.
+    */
+    void addEvent (double time, const uint8* data, int numBytes);
+
+    /** Appends a message to the end of the sequence, using its timestamp. */
+    void addEvent (const MidiMessage& message);
+
+    /** Appends all the events of another sequence, adding an offset to their times. */
+    void addSequence (const CompactMidiSequence& other, double timeAdjustment = 0.0);
+
+    /** Sorts the events by time.
+
+        The sort is stable, except that a note-off will be moved before a note-on that has
+        the same time, so that a note that's retriggered isn't cut short. Matched note
+        pairs are forgotten, so call updateMatchedPairs() again after this.
+    */
+    void sort();
+
+    /** Links each note-on with the note-off that follows it.
+
+        This works like MidiMessageSequence::updateMatchedPairs(): when a note-on is found
+        while the same note is still held, a note-off is inserted just before it. It's a
+        single pass over the events, so it's quick to call even on very long sequences.
+    */
+    void updateMatchedPairs();
+
+    /** Adds an offset to the times of all the events. */
+    void addTimeToEvents (double delta) noexcept;
+
+    //==============================================================================
+    /** Returns the number of events. */
+    int getNumEvents() const noexcept                   { return times.size(); }
+
+    /** Returns the total size of all the events' data. */
+    int getTotalNumBytes() const noexcept               { return bytes.size(); }
+
+    /** Returns the time of an event. */
+    double getEventTime (int index) const noexcept      { return times[index]; }
+
+    /** Returns the status byte of an event. */
+    uint8 getEventStatus (int index) const noexcept     { return statuses[index]; }
+
+    /** Returns the raw data of an event, starting with its status byte. */
+    const uint8* getEventData (int index) const noexcept;
+
+    /** Returns the number of bytes in an event. */
+    int getEventDataSize (int index) const noexcept;
+
+    /** Returns an event as a MidiMessage, with its time as the timestamp. */
+    MidiMessage getEventMessage (int index) const;
+
+    /** Returns the time of the first event, or 0 if there are none. */
+    double getStartTime() const noexcept;
+
+    /** Returns the time of the last event, or 0 if there are none. */
+    double getEndTime() const noexcept;
+
+    /** Returns the index of the first event at or after the given time.
+
+        This is a binary search, so it's the quick way to find a playback position.
+        If all the events are before the time, this returns getNumEvents().
+    */
+    int getNextIndexAtTime (double time) const noexcept;
+
+    /** Returns the index of the note-off that matches the note-on at this index, or -1.
+
+        This is only known after updateMatchedPairs() has been called.
+    */
+    int getIndexOfMatchingNoteOff (int index) const noexcept;
+
+    /** Returns the time of the note-off matching the note-on at this index, or 0. */
+    double getTimeOfMatchingNoteOff (int index) const noexcept;
+
+    //==============================================================================
+    /** Adds the events from a range of times to a MidiBuffer.
+
+        The events at or after startIndex and before endTime are added, at sample positions
+        measured from startTime. Events before startTime go at the start of the buffer.
+        The index of the first event that wasn't added is returned, so a player can pass
+        it back in for the next block without searching again.
+    */
+    int addEventsToBuffer (MidiBuffer& dest,
+                           int startIndex,
+                           double startTime,
+                           double endTime,
+                           double sampleRate) const;
+
+    /** Returns a copy of this sequence as a MidiMessageSequence, with the matched note
+        pairs linked.
+    */
+    MidiMessageSequence toMidiMessageSequence() const;
+
+private:
+    //==============================================================================
+    friend class CompactMidiFile;
+
+    void applyOrder (const Array<int>& order);
+
+    Array<double> times;
+    Array<uint8> statuses;
+    Array<int> offsets;
+    Array<uint8> bytes;
+    Array<int> noteOffIndices;
+
+    JUCE_LEAK_DETECTOR (CompactMidiSequence)
+};
+
+//==============================================================================
+/**
+    Loads standard midi files into CompactMidiSequence objects.
+
+    This reads the same files as MidiFile, producing the same events, but it parses them
+    straight from memory (or from a memory-mapped file) into flat arrays, and converts
+    ticks to seconds with a precomputed tempo map, so even very large files load quickly.
+
+    @see CompactMidiSequence, MidiFile, MidiFileStreamReader
+
+    @tags{Audio}
+*/
+class JUCE_API  CompactMidiFile
+{
+public:
+    //==============================================================================
+    /** Creates an empty file. */
+    CompactMidiFile() = default;
+
+    //==============================================================================
+    /** Reads a midi file from a block of memory.
+
+        Any existing tracks are removed. As with MidiFile::readFrom(), the events are left
+        with their times in ticks until convertTimestampTicksToSeconds() is called.
+
+        @param data                    the contents of the file
+        @param numBytes                the size of the data
+        @param createMatchingNoteOffs  if true, any missing note-offs are added and the
+                                       note pairs are matched
+        @param fileType                if non-null, receives the midi file's type
+        @returns true if the file was read successfully
+    */
+    bool readFrom (const void* data, size_t numBytes, bool createMatchingNoteOffs = true, int* fileType = nullptr);
+
+    /** Reads a midi file, memory-mapping it rather than copying it into memory first. */
+    bool readFrom (const File& file, bool createMatchingNoteOffs = true, int* fileType = nullptr);
+
+    /** Reads a midi file from a stream. */
+    bool readFrom (InputStream& sourceStream, bool createMatchingNoteOffs = true, int* fileType = nullptr);
+
+    /** Removes all the tracks. */
+    void clear() noexcept;
+
+    //==============================================================================
+    /** Returns the number of tracks. */
+    int getNumTracks() const noexcept                               { return tracks.size(); }
+
+    /** Returns one of the tracks, or nullptr if the index is out of range. */
+    const CompactMidiSequence* getTrack (int index) const noexcept  { return tracks[index]; }
+
+    /** Returns the time format: see MidiFile::getTimeFormat(). */
+    short getTimeFormat() const noexcept                            { return timeFormat; }
+
+    /** Returns the latest time of any event in the file. */
+    double getLastTimestamp() const noexcept;
+
+    /** Converts the times of all the events from ticks to seconds, using the file's
+        time format and tempo events.
+    */
+    void convertTimestampTicksToSeconds();
+
+    /** Returns a MidiFile with the same tracks. */
+    MidiFile toMidiFile() const;
+
+private:
+    //==============================================================================
+    OwnedArray<CompactMidiSequence> tracks;
+    short timeFormat = (short) (unsigned short) 0xe728;
+
+    JUCE_LEAK_DETECTOR (CompactMidiFile)
+};
+
+} // namespace juce
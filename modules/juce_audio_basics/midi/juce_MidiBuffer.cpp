@@ -94,6 +94,16 @@ namespace MidiBufferHelpers
 
         return d;
     }
+
+    // Returns the event at a cached offset, if the offset still points at the last event
+    static const uint8* findLastEvent (const uint8* d, const uint8* endData, int cachedOffset) noexcept
+    {
+        if (! isPositiveAndBelow (cachedOffset, (int) (endData - d)))
+            return nullptr;
+
+        auto* event = d + cachedOffset;
+        return event + getEventTotalSize (event) == endData ? event : nullptr;
+    }
 }
 
 //==============================================================================
@@ -123,17 +133,88 @@ MidiBuffer::MidiBuffer (const MidiMessage& message) noexcept
     addEvent (message, 0);
 }
 
-void MidiBuffer::swapWith (MidiBuffer& other) noexcept      { data.swapWith (other.data); }
-void MidiBuffer::clear() noexcept                           { data.clearQuick(); }
+MidiBuffer::MidiBuffer (const MidiBuffer& other)
+    : numDroppedEvents (other.numDroppedEvents),
+      lastEventOffset (other.lastEventOffset)
+{
+    setFixedCapacity (other.fixedCapacity);
+    data.addArray (other.data.begin(), other.data.size());
+}
+
+MidiBuffer& MidiBuffer::operator= (const MidiBuffer& other)
+{
+    if (this != &other)
+    {
+        // Copying into the existing storage, rather than replacing the array, keeps any
+        // space that has been reserved by setFixedCapacity()
+        setFixedCapacity (other.fixedCapacity);
+        data.clearQuick();
+        data.addArray (other.data.begin(), other.data.size());
+        numDroppedEvents = other.numDroppedEvents;
+        lastEventOffset = other.lastEventOffset;
+    }
+
+    return *this;
+}
+
+MidiBuffer::MidiBuffer (MidiBuffer&& other) noexcept
+    : data (std::move (other.data)),
+      scratch (std::move (other.scratch)),
+      scratchSize (std::exchange (other.scratchSize, 0)),
+      fixedCapacity (std::exchange (other.fixedCapacity, 0)),
+      numDroppedEvents (std::exchange (other.numDroppedEvents, 0)),
+      lastEventOffset (std::exchange (other.lastEventOffset, -1))
+{
+}
+
+MidiBuffer& MidiBuffer::operator= (MidiBuffer&& other) noexcept
+{
+    // Moving into a temporary resets the other buffer, and the temporary frees this one's old storage
+    if (this != &other)
+        MidiBuffer (std::move (other)).swapWith (*this);
+
+    return *this;
+}
+
+void MidiBuffer::clear() noexcept                           { data.clearQuick(); lastEventOffset = -1; }
 void MidiBuffer::ensureSize (size_t minimumNumBytes)        { data.ensureStorageAllocated ((int) minimumNumBytes); }
 bool MidiBuffer::isEmpty() const noexcept                   { return data.size() == 0; }
 
+void MidiBuffer::swapWith (MidiBuffer& other) noexcept
+{
+    data.swapWith (other.data);
+    scratch.swapWith (other.scratch);
+    std::swap (scratchSize, other.scratchSize);
+    std::swap (fixedCapacity, other.fixedCapacity);
+    std::swap (numDroppedEvents, other.numDroppedEvents);
+    std::swap (lastEventOffset, other.lastEventOffset);
+}
+
 void MidiBuffer::clear (int startSample, int numSamples)
 {
     auto start = MidiBufferHelpers::findEventAfter (data.begin(), data.end(), startSample - 1);
     auto end   = MidiBufferHelpers::findEventAfter (start,        data.end(), startSample + numSamples - 1);
 
-    data.removeRange ((int) (start - data.begin()), (int) (end - start));
+    if (fixedCapacity == 0)
+    {
+        data.removeRange ((int) (start - data.begin()), (int) (end - start));
+    }
+    else if (end > start)
+    {
+        // Array::removeRange() would give back the storage that was reserved for the
+        // fixed capacity, so the events that are kept are copied out and back instead
+        const auto numBefore = (size_t) (start - data.begin());
+        const auto numAfter = (size_t) (data.end() - end);
+
+        ensureScratchSize ((size_t) data.size());
+        memcpy (scratch.get(), data.begin(), numBefore);
+        memcpy (scratch.get() + numBefore, end, numAfter);
+
+        data.clearQuick();
+        data.addArray (scratch.get(), (int) (numBefore + numAfter));
+    }
+
+    lastEventOffset = -1;
 }
 
 bool MidiBuffer::addEvent (const MidiMessage& m, int sampleNumber)
@@ -154,10 +235,53 @@ bool MidiBuffer::addEvent (const void* newData, int maxBytes, int sampleNumber)
         return false;
     }
 
-    auto newItemSize = (size_t) numBytes + sizeof (int32) + sizeof (uint16);
-    auto offset = (int) (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
+    return appendEvent (newData, numBytes, sampleNumber, true);
+}
+
+bool MidiBuffer::addEventUnsorted (const MidiMessage& m, int sampleNumber)
+{
+    return addEventUnsorted (m.getRawData(), m.getRawDataSize(), sampleNumber);
+}
+
+bool MidiBuffer::addEventUnsorted (const void* newData, int maxBytes, int sampleNumber)
+{
+    auto numBytes = MidiBufferHelpers::findActualEventLength (static_cast<const uint8*> (newData), maxBytes);
+
+    if (numBytes <= 0)
+        return true;
+
+    if (std::numeric_limits<uint16>::max() < numBytes)
+    {
+        // This method only supports messages smaller than (1 << 16) bytes
+        return false;
+    }
+
+    return appendEvent (newData, numBytes, sampleNumber, false);
+}
+
+bool MidiBuffer::appendEvent (const void* newData, int numBytes, int sampleNumber, bool mustStaySorted)
+{
+    auto newItemSize = (int) ((size_t) numBytes + sizeof (int32) + sizeof (uint16));
+
+    if (fixedCapacity > 0 && (size_t) (data.size() + newItemSize) > fixedCapacity)
+    {
+        ++numDroppedEvents;
+        return false;
+    }
+
+    auto offset = data.size();
+
+    // If the new event doesn't go at the end, fall back to searching for its position
+    if (mustStaySorted && data.size() > 0)
+    {
+        const auto* lastEvent = MidiBufferHelpers::findLastEvent (data.begin(), data.end(), lastEventOffset);
+
+        if (lastEvent == nullptr || sampleNumber < MidiBufferHelpers::getEventTime (lastEvent))
+            offset = (int) (MidiBufferHelpers::findEventAfter (data.begin(), data.end(), sampleNumber) - data.begin());
+    }
 
-    data.insertMultiple (offset, 0, (int) newItemSize);
+    const auto isAppending = (offset == data.size());
+    data.insertMultiple (offset, 0, newItemSize);
 
     auto* d = data.begin() + offset;
     writeUnaligned<int32>  (d, sampleNumber);
@@ -166,9 +290,113 @@ bool MidiBuffer::addEvent (const void* newData, int maxBytes, int sampleNumber)
     d += sizeof (uint16);
     memcpy (d, newData, (size_t) numBytes);
 
+    if (isAppending)
+        lastEventOffset = offset;
+    else if (lastEventOffset >= 0)
+        lastEventOffset += newItemSize;
+
     return true;
 }
 
+void MidiBuffer::sortEvents()
+{
+    struct SortEntry
+    {
+        int32 time;
+        int32 offset;
+    };
+
+    int numEvents = 0;
+    auto isSorted = true;
+    auto previousTime = std::numeric_limits<int>::lowest();
+
+    for (auto d = data.begin(); d < data.end(); d += MidiBufferHelpers::getEventTotalSize (d))
+    {
+        const auto time = MidiBufferHelpers::getEventTime (d);
+        isSorted = isSorted && time >= previousTime;
+        previousTime = time;
+        ++numEvents;
+    }
+
+    if (isSorted)
+        return;
+
+    // The scratch space holds a copy of the event data, followed by two arrays of sort entries
+    const auto numDataBytes = (data.size() + 7) & ~7;
+    ensureScratchSize ((size_t) numDataBytes + 2 * (size_t) numEvents * sizeof (SortEntry));
+
+    auto* eventCopy = scratch.get();
+    auto* entries = reinterpret_cast<SortEntry*> (eventCopy + numDataBytes);
+    auto* mergeBuffer = entries + numEvents;
+
+    memcpy (eventCopy, data.begin(), (size_t) data.size());
+
+    int index = 0;
+
+    for (auto d = eventCopy; d < eventCopy + data.size(); d += MidiBufferHelpers::getEventTotalSize (d))
+        entries[index++] = { MidiBufferHelpers::getEventTime (d), (int32) (d - eventCopy) };
+
+    // A bottom-up merge sort, which is stable and doesn't need any more memory
+    for (int width = 1; width < numEvents; width *= 2)
+    {
+        for (int left = 0; left < numEvents; left += 2 * width)
+        {
+            const auto middle = jmin (left + width, numEvents);
+            const auto right = jmin (left + 2 * width, numEvents);
+
+            std::merge (entries + left, entries + middle, entries + middle, entries + right, mergeBuffer + left,
+                        [] (const SortEntry& a, const SortEntry& b) { return a.time < b.time; });
+        }
+
+        std::swap (entries, mergeBuffer);
+    }
+
+    auto* dest = data.begin();
+
+    for (int i = 0; i < numEvents; ++i)
+    {
+        const auto* source = eventCopy + entries[i].offset;
+        const auto size = MidiBufferHelpers::getEventTotalSize (source);
+
+        memcpy (dest, source, size);
+        lastEventOffset = (int) (dest - data.begin());
+        dest += size;
+    }
+}
+
+void MidiBuffer::setFixedCapacity (size_t maxNumBytes)
+{
+    fixedCapacity = maxNumBytes;
+
+    if (maxNumBytes > 0)
+    {
+        // Every event takes at least 7 bytes, which bounds the space needed by sortEvents()
+        const auto maxNumEvents = maxNumBytes / 7;
+
+        const auto scratchNeeded = ((maxNumBytes + 7) & ~(size_t) 7) + 2 * maxNumEvents * 2 * sizeof (int32);
+
+        data.ensureStorageAllocated ((int) maxNumBytes);
+
+        if (scratchNeeded > scratchSize)
+        {
+            scratch.malloc (scratchNeeded);
+            scratchSize = scratchNeeded;
+        }
+    }
+}
+
+void MidiBuffer::ensureScratchSize (size_t numBytes)
+{
+    if (numBytes > scratchSize)
+    {
+        // The fixed capacity should have reserved enough space for this!
+        jassert (fixedCapacity == 0);
+
+        scratch.malloc (numBytes);
+        scratchSize = numBytes;
+    }
+}
+
 void MidiBuffer::addEvents (const MidiBuffer& otherBuffer,
                             int startSample, int numSamples, int sampleDeltaToAdd)
 {
@@ -204,6 +432,9 @@ int MidiBuffer::getLastEventTime() const noexcept
     if (data.size() == 0)
         return 0;
 
+    if (auto* lastEvent = MidiBufferHelpers::findLastEvent (data.begin(), data.end(), lastEventOffset))
+        return MidiBufferHelpers::getEventTime (lastEvent);
+
     auto endData = data.end();
 
     for (auto d = data.begin();;)
@@ -168,6 +168,24 @@ public:
     /** Creates a MidiBuffer containing a single midi message. */
     explicit MidiBuffer (const MidiMessage& message) noexcept;
 
+    /** Creates a copy of another buffer, including its fixed capacity. */
+    MidiBuffer (const MidiBuffer&);
+
+    /** Copies another buffer, including its fixed capacity.
+        If this buffer already has enough storage, the copy doesn't allocate.
+    */
+    MidiBuffer& operator= (const MidiBuffer&);
+
+    /** Moves another buffer's contents and fixed capacity into a new one, leaving the
+        other buffer empty, with no fixed capacity.
+    */
+    MidiBuffer (MidiBuffer&&) noexcept;
+
+    /** Moves another buffer's contents and fixed capacity into this one, leaving the
+        other buffer empty, with no fixed capacity.
+    */
+    MidiBuffer& operator= (MidiBuffer&&) noexcept;
+
     //==============================================================================
     /** Removes all events from the buffer. */
     void clear() noexcept;
@@ -215,6 +233,9 @@ public:
         If an event is added whose sample position is the same as one or more events
         already in the buffer, the new event will be placed after the existing ones.
 
+        Adding events in time order is the fast path: an event that isn't earlier than the
+        last one is simply appended, without searching the buffer for its position.
+
         The event data will be inspected to calculate the number of bytes in length that
         the midi event really takes up, so maxBytesOfMidiData may be longer than the data
         that actually gets stored. E.g. if you pass in a note-on and a length of 4 bytes,
@@ -248,6 +269,62 @@ public:
                     int numSamples,
                     int sampleDeltaToAdd);
 
+    //==============================================================================
+    /** Appends an event to the end of the buffer, without keeping the buffer sorted.
+
+        This is much quicker than addEvent() when merging events that arrive out of order,
+        e.g. from several sources, as nothing has to be searched or moved. Once all the
+        events have been appended, you must call sortEvents() before the buffer is iterated
+        or any of the other methods are used.
+
+        Returns true on success, or false on failure.
+
+        @see sortEvents
+    */
+    bool addEventUnsorted (const void* rawMidiData,
+                           int maxBytesOfMidiData,
+                           int sampleNumber);
+
+    /** Appends an event to the end of the buffer, without keeping the buffer sorted.
+        @see sortEvents
+    */
+    bool addEventUnsorted (const MidiMessage& midiMessage, int sampleNumber);
+
+    /** Sorts the events in the buffer by their timestamps.
+
+        The sort is stable, so events with the same timestamp stay in the order in which
+        they were added. If the buffer has a fixed capacity, this doesn't allocate.
+
+        @see addEventUnsorted
+    */
+    void sortEvents();
+
+    //==============================================================================
+    /** Reserves a fixed amount of storage, so that the buffer can be used on a realtime thread.
+
+        After this has been called, adding events will never reallocate the buffer's storage.
+        Instead, any event that doesn't fit in the remaining space is dropped, and counted by
+        getNumDroppedEvents(). Call this from your prepare method, with a size big enough
+        for the busiest block you expect. Passing 0 turns the buffer back into one that grows
+        as needed.
+
+        The storage belongs to this object, so copying the buffer will allocate, unless
+        it's copied into a buffer that already has enough storage. Removing events with
+        clear() keeps the storage too.
+    */
+    void setFixedCapacity (size_t maxNumBytes);
+
+    /** Returns the capacity set by setFixedCapacity(), or 0 if the buffer can grow. */
+    size_t getFixedCapacity() const noexcept                { return fixedCapacity; }
+
+    /** Returns the number of events that were dropped because the buffer's fixed capacity
+        was full.
+    */
+    int getNumDroppedEvents() const noexcept                { return numDroppedEvents; }
+
+    /** Resets the count returned by getNumDroppedEvents(). */
+    void resetNumDroppedEvents() noexcept                   { numDroppedEvents = 0; }
+
     /** Returns the sample number of the first event in the buffer.
         If the buffer's empty, this will just return 0.
     */
@@ -356,6 +433,15 @@ public:
     Array<uint8> data;
 
 private:
+    bool appendEvent (const void* rawMidiData, int numBytes, int sampleNumber, bool mustStaySorted);
+    void ensureScratchSize (size_t numBytes);
+
+    HeapBlock<uint8> scratch;
+    size_t scratchSize = 0;
+    size_t fixedCapacity = 0;
+    int numDroppedEvents = 0;
+    int lastEventOffset = -1;
+
     JUCE_LEAK_DETECTOR (MidiBuffer)
 };
 
@@ -163,47 +163,179 @@ namespace MidiFileHelpers
         return { result };
     }
 
-    static double convertTicksToSeconds (double time,
-                                         const MidiMessageSequence& tempoEvents,
-                                         int timeFormat)
+    /*  Converts tick positions to seconds. The tempo changes are turned into a table of
+        breakpoints up front, so that each conversion is a binary search rather than a
+        walk through all the tempo events before it. As in a MIDI file, a tempo change
+        only affects the events that come after it, not the ones at the same tick.
+    */
+    class TempoMap
     {
-        if (timeFormat < 0)
-            return time / (-(timeFormat >> 8) * (timeFormat & 0xff));
+    public:
+        explicit TempoMap (int format)
+            : timeFormat (format),
+              tickLength (format > 0 ? 1.0 / (format & 0x7fff) : 0.0),
+              secondsPerTick (0.5 * tickLength)
+        {
+        }
 
-        double lastTime = 0, correctedTime = 0;
-        auto tickLen = 1.0 / (timeFormat & 0x7fff);
-        auto secsPerTick = 0.5 * tickLen;
-        auto numEvents = tempoEvents.getNumEvents();
+        /** Tempo changes must be added in time order. */
+        void addTempoChange (double tick, double secondsPerQuarterNote)
+        {
+            lastSeconds += (tick - lastTick) * secondsPerTick;
+            lastTick = tick;
+            secondsPerTick = tickLength * secondsPerQuarterNote;
 
-        for (int i = 0; i < numEvents; ++i)
+            if (! points.isEmpty() && points.getReference (points.size() - 1).tick == tick)
+                points.getReference (points.size() - 1).secondsPerTick = secondsPerTick;
+            else
+                points.add ({ tick, lastSeconds, secondsPerTick });
+        }
+
+        double ticksToSeconds (double tick) const noexcept
         {
-            auto& m = tempoEvents.getEventPointer (i)->message;
-            auto eventTime = m.getTimeStamp();
+            if (timeFormat < 0)
+                return tick / (-(timeFormat >> 8) * (timeFormat & 0xff));
 
-            if (eventTime >= time)
-                break;
+            auto next = std::lower_bound (points.begin(), points.end(), tick,
+                                          [] (const Point& p, double t) { return p.tick < t; });
+
+            if (next == points.begin())
+                return tick * 0.5 * tickLength;
+
+            auto& point = *(next - 1);
+            return point.seconds + (tick - point.tick) * point.secondsPerTick;
+        }
+
+    private:
+        struct Point
+        {
+            double tick, seconds, secondsPerTick;
+        };
+
+        Array<Point> points;
+        int timeFormat;
+        double tickLength, secondsPerTick, lastTick = 0, lastSeconds = 0;
+    };
+
+    /*  The bytes of an event in a track chunk, found without creating a MidiMessage.
+        The event is the header followed by the body: channel messages are entirely
+        in the header (with running status resolved, and padded as MidiMessage does),
+        while sysex and meta events point into the file for their bodies.
+    */
+    struct FileEvent
+    {
+        uint8 header[3] {};
+        int headerSize = 0;
+        const uint8* body = nullptr;
+        int bodySize = 0;
+        int numBytesUsed = 0;
+
+        int getSize() const noexcept        { return headerSize + bodySize; }
+        uint8 getStatusByte() const noexcept { return header[0]; }
 
-            correctedTime += (eventTime - lastTime) * secsPerTick;
-            lastTime = eventTime;
+        void copyTo (uint8* dest) const noexcept
+        {
+            memcpy (dest, header, (size_t) headerSize);
 
-            if (m.isTempoMetaEvent())
-                secsPerTick = tickLen * m.getTempoSecondsPerQuarterNote();
+            if (bodySize > 0)
+                memcpy (dest + headerSize, body, (size_t) bodySize);
+        }
+    };
+
+    // Parses an event in the same way as MidiMessage's file-reading constructor
+    static FileEvent readFileEvent (const uint8* src, int sz, uint8 lastStatusByte) noexcept
+    {
+        FileEvent result;
+        auto byte = (unsigned int) *src;
 
-            while (i + 1 < numEvents)
+        if (byte < 0x80)
+        {
+            byte = (unsigned int) lastStatusByte;
+            result.numBytesUsed = -1;
+        }
+        else
+        {
+            --sz;
+            ++src;
+        }
+
+        if (byte < 0x80)
+            return {};
+
+        result.header[0] = (uint8) byte;
+        result.headerSize = 1;
+
+        if (byte == 0xf0)
+        {
+            auto d = src;
+            bool haveReadAllLengthBytes = false;
+            int numVariableLengthSysexBytes = 0;
+
+            while (d < src + sz)
             {
-                auto& m2 = tempoEvents.getEventPointer (i + 1)->message;
+                if (*d >= 0x80)
+                {
+                    if (*d == 0xf7)
+                    {
+                        ++d;
+                        break;
+                    }
 
-                if (! approximatelyEqual (m2.getTimeStamp(), eventTime))
-                    break;
+                    if (haveReadAllLengthBytes)
+                        break;
 
-                if (m2.isTempoMetaEvent())
-                    secsPerTick = tickLen * m2.getTempoSecondsPerQuarterNote();
+                    ++numVariableLengthSysexBytes;
+                }
+                else if (! haveReadAllLengthBytes)
+                {
+                    haveReadAllLengthBytes = true;
+                    ++numVariableLengthSysexBytes;
+                }
 
-                ++i;
+                ++d;
             }
+
+            result.body = src + numVariableLengthSysexBytes;
+            result.bodySize = (int) (d - result.body);
+            result.numBytesUsed += numVariableLengthSysexBytes + 1 + result.bodySize;
         }
+        else if (byte == 0xff)
+        {
+            const auto bytesLeft = MidiMessage::readVariableLengthValue (src + 1, sz - 1);
+            const auto size = jmin (sz + 1, bytesLeft.bytesUsed + 2 + bytesLeft.value);
 
-        return correctedTime + (time - lastTime) * secsPerTick;
+            result.body = src;
+            result.bodySize = size - 1;
+            result.numBytesUsed += size;
+        }
+        else
+        {
+            const auto size = MidiMessage::getMessageLengthFromFirstByte ((uint8) byte);
+
+            for (int i = 1; i < size; ++i)
+                result.header[i] = (sz >= i ? src[i - 1] : 0);
+
+            result.headerSize = size;
+            result.numBytesUsed += jmin (size, sz + 1);
+        }
+
+        return result;
+    }
+
+    static bool isTempoEvent (const uint8* data, int size) noexcept
+    {
+        return size > 2 && data[0] == 0xff && data[1] == 81;
+    }
+
+    static double getTempoSecondsPerQuarterNote (const uint8* data, int size) noexcept
+    {
+        const auto length = MidiMessage::readVariableLengthValue (data + 2, size - 2);
+
+        if (! length.isValid() || length.value < 3 || size < 2 + length.bytesUsed + 3)
+            return 0.0;
+
+        auto d = data + 2 + length.bytesUsed;
+        return (((unsigned int) d[0] << 16) | ((unsigned int) d[1] << 8) | d[2]) / 1000000.0;
     }
 
     template <typename MethodType>
@@ -446,21 +578,21 @@ void MidiFile::readNextTrack (const uint8* data, int size, bool createMatchingNo
 //==============================================================================
 void MidiFile::convertTimestampTicksToSeconds()
 {
+    if (timeFormat == 0)
+        return;
+
     MidiMessageSequence tempoEvents;
     findAllTempoEvents (tempoEvents);
-    findAllTimeSigEvents (tempoEvents);
 
-    if (timeFormat != 0)
-    {
-        for (auto* ms : tracks)
-        {
-            for (int j = ms->getNumEvents(); --j >= 0;)
-            {
-                auto& m = ms->getEventPointer (j)->message;
-                m.setTimeStamp (MidiFileHelpers::convertTicksToSeconds (m.getTimeStamp(), tempoEvents, timeFormat));
-            }
-        }
-    }
+    MidiFileHelpers::TempoMap tempoMap (timeFormat);
+
+    for (auto* tempoEvent : tempoEvents)
+        tempoMap.addTempoChange (tempoEvent->message.getTimeStamp(),
+                                 tempoEvent->message.getTempoSecondsPerQuarterNote());
+
+    for (auto* ms : tracks)
+        for (auto* event : *ms)
+            event->message.setTimeStamp (tempoMap.ticksToSeconds (event->message.getTimeStamp()));
 }
 
 //==============================================================================
@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+struct MidiFileStreamReader::Track
+{
+    Track (const uint8* chunkData, int chunkSize) noexcept
+        : start (chunkData), size (chunkSize)
+    {
+        rewind();
+    }
+
+    void rewind() noexcept
+    {
+        data = start;
+        remaining = size;
+        lastStatusByte = 0;
+        nextTick = 0.0;
+        readNextEvent();
+    }
+
+    // Parses the next event of the track, in the same way as MidiFile does
+    void readNextEvent() noexcept
+    {
+        hasEvent = false;
+
+        if (remaining <= 0)
+            return;
+
+        const auto delay = MidiMessage::readVariableLengthValue (data, remaining);
+
+        if (! delay.isValid())
+            return;
+
+        data += delay.bytesUsed;
+        remaining -= delay.bytesUsed;
+
+        if (remaining <= 0)
+            return;
+
+        event = MidiFileHelpers::readFileEvent (data, remaining, lastStatusByte);
+
+        if (event.numBytesUsed <= 0)
+            return;
+
+        data += event.numBytesUsed;
+        remaining -= event.numBytesUsed;
+        nextTick += delay.value;
+        hasEvent = true;
+
+        if ((event.getStatusByte() & 0xf0) != 0xf0)
+            lastStatusByte = event.getStatusByte();
+    }
+
+    const uint8* start;
+    int size;
+
+    const uint8* data = nullptr;
+    int remaining = 0;
+    uint8 lastStatusByte = 0;
+    double nextTick = 0.0;
+    bool hasEvent = false;
+    MidiFileHelpers::FileEvent event;
+};
+
+//==============================================================================
+MidiFileStreamReader::MidiFileStreamReader (const File& file)
+    : mappedFile (std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly))
+{
+    if (mappedFile->getData() != nullptr)
+        open (static_cast<const uint8*> (mappedFile->getData()), mappedFile->getSize());
+}
+
+MidiFileStreamReader::MidiFileStreamReader (const void* data, size_t numBytes)
+{
+    if (data != nullptr)
+        open (static_cast<const uint8*> (data), numBytes);
+}
+
+MidiFileStreamReader::~MidiFileStreamReader() = default;
+
+int MidiFileStreamReader::getNumTracks() const noexcept
+{
+    return (int) tracks.size();
+}
+
+void MidiFileStreamReader::open (const uint8* d, size_t size)
+{
+    const auto optHeader = MidiFileHelpers::parseMidiHeader (d, size);
+
+    if (! optHeader.hasValue())
+        return;
+
+    const auto header = *optHeader;
+    timeFormat = header.timeFormat;
+    fileType = header.fileType;
+
+    d += header.bytesRead;
+    size -= (size_t) header.bytesRead;
+
+    tracks.reserve ((size_t) header.numberOfTracks);
+
+    for (int track = 0; track < header.numberOfTracks; ++track)
+    {
+        const auto optChunkType = MidiFileHelpers::tryRead<uint32> (d, size);
+        const auto optChunkSize = MidiFileHelpers::tryRead<uint32> (d, size);
+
+        if (! optChunkType.hasValue() || ! optChunkSize.hasValue() || size < *optChunkSize)
+            return;
+
+        if (*optChunkType == ByteOrder::bigEndianInt ("MTrk"))
+            tracks.emplace_back (d, (int) *optChunkSize);
+
+        size -= *optChunkSize;
+        d += *optChunkSize;
+    }
+
+    valid = (size == 0);
+
+    // Walk through all the events once, to find the space needed for the largest
+    // one, and the length of the file
+    int maxEventSize = 1;
+
+    for (auto& track : tracks)
+    {
+        for (; track.hasEvent; track.readNextEvent())
+            maxEventSize = jmax (maxEventSize, track.event.getSize());
+    }
+
+    eventData.malloc ((size_t) maxEventSize);
+
+    rewind();
+
+    for (int index; (index = findNextTrack()) >= 0;)
+        consumeEvent (index, nullptr);
+
+    lengthInSeconds = lastSeconds;
+
+    rewind();
+}
+
+//==============================================================================
+void MidiFileStreamReader::rewind() noexcept
+{
+    for (auto& track : tracks)
+        track.rewind();
+
+    if (timeFormat > 0)
+    {
+        tickLength = 1.0 / (timeFormat & 0x7fff);
+        secondsPerTick = 0.5 * tickLength;
+    }
+    else if (timeFormat < 0)
+    {
+        tickLength = 0.0;
+        secondsPerTick = 1.0 / (-(timeFormat >> 8) * (timeFormat & 0xff));
+    }
+    else
+    {
+        // (as with MidiFile, a time format of 0 leaves the times in ticks)
+        tickLength = 0.0;
+        secondsPerTick = 1.0;
+    }
+
+    lastTick = 0.0;
+    lastSeconds = 0.0;
+}
+
+int MidiFileStreamReader::findNextTrack() const noexcept
+{
+    int result = -1;
+
+    for (int i = 0; i < (int) tracks.size(); ++i)
+    {
+        auto& track = tracks[(size_t) i];
+
+        if (track.hasEvent && (result < 0 || track.nextTick < tracks[(size_t) result].nextTick))
+            result = i;
+    }
+
+    return result;
+}
+
+double MidiFileStreamReader::getTimeOfNextEventInTrack (int trackIndex) const noexcept
+{
+    return lastSeconds + (tracks[(size_t) trackIndex].nextTick - lastTick) * secondsPerTick;
+}
+
+void MidiFileStreamReader::consumeEvent (int trackIndex, Event* result) noexcept
+{
+    auto& track = tracks[(size_t) trackIndex];
+    auto& event = track.event;
+
+    lastSeconds = getTimeOfNextEventInTrack (trackIndex);
+    lastTick = track.nextTick;
+
+    event.copyTo (eventData);
+
+    // a tempo change only affects the events after it
+    if (timeFormat > 0 && MidiFileHelpers::isTempoEvent (eventData, event.getSize()))
+        secondsPerTick = tickLength * MidiFileHelpers::getTempoSecondsPerQuarterNote (eventData, event.getSize());
+
+    if (result != nullptr)
+    {
+        result->data = eventData;
+        result->numBytes = event.getSize();
+        result->time = lastSeconds;
+        result->track = trackIndex;
+    }
+
+    track.readNextEvent();
+}
+
+bool MidiFileStreamReader::readNextEvent (Event& event) noexcept
+{
+    const auto trackIndex = findNextTrack();
+
+    if (trackIndex < 0)
+        return false;
+
+    consumeEvent (trackIndex, &event);
+    return true;
+}
+
+double MidiFileStreamReader::getNextEventTime() const noexcept
+{
+    const auto trackIndex = findNextTrack();
+    return trackIndex >= 0 ? getTimeOfNextEventInTrack (trackIndex) : lengthInSeconds;
+}
+
+bool MidiFileStreamReader::isFinished() const noexcept
+{
+    return findNextTrack() < 0;
+}
+
+void MidiFileStreamReader::seek (double timeInSeconds) noexcept
+{
+    if (timeInSeconds <= lastSeconds)
+        rewind();
+
+    for (int index; (index = findNextTrack()) >= 0 && getTimeOfNextEventInTrack (index) < timeInSeconds;)
+        consumeEvent (index, nullptr);
+}
+
+//==============================================================================
+void MidiFileStreamReader::renderNextBlock (MidiBuffer& dest, double blockStartTime, int numSamples, double sampleRate)
+{
+    const auto blockEndTime = blockStartTime + numSamples / sampleRate;
+    const auto lastPosition = jmax (0, numSamples - 1);
+    Event event;
+
+    for (int index; (index = findNextTrack()) >= 0 && getTimeOfNextEventInTrack (index) < blockEndTime;)
+    {
+        consumeEvent (index, &event);
+
+        if (event.data[0] == 0xff)
+            continue;
+
+        const auto position = jlimit (0, lastPosition, roundToInt ((event.time - blockStartTime) * sampleRate));
+        dest.addEvent (event.data, event.numBytes, position);
+    }
+}
+
+} // namespace juce
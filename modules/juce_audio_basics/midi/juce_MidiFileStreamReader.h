@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Plays the events of a standard midi file directly from its data.
+
+    Instead of loading the whole file into sequences first, this keeps a read position
+    in each track and merges them as it goes, converting ticks to seconds on the fly.
+    With a memory-mapped file the operating system pages the data in as it's needed,
+    so a huge file can start playing straight away, and only a few bytes of state are
+    kept per track.
+
+    The file is checked when the reader is created, after which reading, rewinding and
+    renderNextBlock() don't allocate or lock. When the reader is given a block of memory
+    they can be called from the audio thread. A memory-mapped file is paged in by the
+    operating system as it's read, which can wait for the disk, so for realtime playback
+    the file should be loaded into memory first.
+
+    Seeking walks through all the events on the way to the new time, so it should be done
+    before playback starts, or on a thread other than the audio thread.
+
+    @code
+    MidiFileStreamReader reader (midiFile);
+    reader.seek (startTime);
+
+    // then in each audio callback:
+    reader.renderNextBlock (midiBuffer, blockStartTime, numSamples, sampleRate);
+    @endcode
+
+    @see CompactMidiFile, MidiFile
+
+    @tags{Audio}
+*/
+class JUCE_API  MidiFileStreamReader
+{
+public:
+    //==============================================================================
+    /** Opens a midi file by memory-mapping it. */
+    explicit MidiFileStreamReader (const File& file);
+
+    /** Reads a midi file from a block of memory, which must stay valid until the
+        reader is deleted.
+    */
+    MidiFileStreamReader (const void* data, size_t numBytes);
+
+    /** Destructor. */
+    ~MidiFileStreamReader();
+
+    //==============================================================================
+    /** Returns true if the file was opened and its header and tracks were valid. */
+    bool isValid() const noexcept                       { return valid; }
+
+    /** Returns the type of the midi file. */
+    int getFileType() const noexcept                    { return fileType; }
+
+    /** Returns the time format: see MidiFile::getTimeFormat(). */
+    short getTimeFormat() const noexcept                { return timeFormat; }
+
+    /** Returns the number of tracks that are being read. */
+    int getNumTracks() const noexcept;
+
+    /** Returns the time of the last event, in seconds. */
+    double getLengthInSeconds() const noexcept          { return lengthInSeconds; }
+
+    //==============================================================================
+    /** An event that has been read. Its data stays valid until the next event is read. */
+    struct Event
+    {
+        const uint8* data = nullptr;
+        int numBytes = 0;
+        double time = 0.0;
+        int track = 0;
+
+        /** Returns a copy of the event as a MidiMessage. */
+        MidiMessage getMessage() const      { return MidiMessage (data, numBytes, time); }
+    };
+
+    /** Reads the next event, from whichever track has the earliest one.
+
+        Events are returned in time order, with the events of lower-numbered tracks first
+        when several have the same time. Returns false when there are no more events.
+    */
+    bool readNextEvent (Event& event) noexcept;
+
+    /** Returns the time of the event that readNextEvent() would return next, or the
+        length of the file if there are none left.
+    */
+    double getNextEventTime() const noexcept;
+
+    /** Returns true if all the events have been read. */
+    bool isFinished() const noexcept;
+
+    /** Goes back to the start of the file. */
+    void rewind() noexcept;
+
+    /** Moves the read position to the first event at or after a time, in seconds.
+
+        This reads through every event between the current position and the new one, going
+        back to the start of the file first if the new time is earlier, so it can take as
+        long as reading the whole file. It isn't suitable for calling on the audio thread.
+    */
+    void seek (double timeInSeconds) noexcept;
+
+    //==============================================================================
+    /** Adds the events for the next block of audio to a MidiBuffer.
+
+        All the remaining events before blockStartTime + numSamples / sampleRate are added,
+        at their sample positions within the block. Any that are late go at the start of
+        the block. Meta events are skipped, as they only mean something inside a file.
+        The MidiBuffer may need to allocate, unless it has a fixed capacity.
+    */
+    void renderNextBlock (MidiBuffer& dest, double blockStartTime, int numSamples, double sampleRate);
+
+private:
+    //==============================================================================
+    struct Track;
+
+    void open (const uint8* data, size_t numBytes);
+    int findNextTrack() const noexcept;
+    double getTimeOfNextEventInTrack (int trackIndex) const noexcept;
+    void consumeEvent (int trackIndex, Event* event) noexcept;
+
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    std::vector<Track> tracks;
+    HeapBlock<uint8> eventData;
+
+    bool valid = false;
+    int fileType = 0;
+    short timeFormat = 0;
+    double lengthInSeconds = 0.0;
+
+    double tickLength = 0.0, secondsPerTick = 0.0;
+    double lastTick = 0.0, lastSeconds = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiFileStreamReader)
+};
+
+} // namespace juce
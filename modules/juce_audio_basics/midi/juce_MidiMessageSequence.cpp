@@ -137,14 +137,10 @@ int MidiMessageSequence::getIndexOf (const MidiEventHolder* event) const noexcep
 
 int MidiMessageSequence::getNextIndexAtTime (double timeStamp) const noexcept
 {
-    auto numEvents = list.size();
-    int i;
-
-    for (i = 0; i < numEvents; ++i)
-        if (list.getUnchecked (i)->message.getTimeStamp() >= timeStamp)
-            break;
+    auto found = std::lower_bound (list.begin(), list.end(), timeStamp,
+                                   [] (const MidiEventHolder* e, double t) { return e->message.getTimeStamp() < t; });
 
-    return i;
+    return (int) (found - list.begin());
 }
 
 //==============================================================================
@@ -242,42 +238,66 @@ void MidiMessageSequence::sort() noexcept
 
 void MidiMessageSequence::updateMatchedPairs() noexcept
 {
+    // A single pass that remembers the note-on still waiting for its note-off on each key.
+    // A note-on arriving while its key is still held gets a note-off inserted just before it.
+    MidiEventHolder* heldNotes[16][128] = {};
+    Array<std::pair<int, MidiEventHolder*>> insertions;
+
     for (int i = 0; i < list.size(); ++i)
     {
         auto* meh = list.getUnchecked (i);
-        auto& m1 = meh->message;
+        auto& m = meh->message;
+        const auto isNoteOn = m.isNoteOn();
 
-        if (m1.isNoteOn())
-        {
-            meh->noteOffObject = nullptr;
-            auto note = m1.getNoteNumber();
-            auto chan = m1.getChannel();
-            auto len = list.size();
+        if (! isNoteOn && ! m.isNoteOff())
+            continue;
 
-            for (int j = i + 1; j < len; ++j)
-            {
-                auto* meh2 = list.getUnchecked (j);
-                auto& m = meh2->message;
+        auto& held = heldNotes[m.getChannel() - 1][m.getNoteNumber()];
 
-                if (m.getNoteNumber() == note && m.getChannel() == chan)
-                {
-                    if (m.isNoteOff())
-                    {
-                        meh->noteOffObject = meh2;
-                        break;
-                    }
-
-                    if (m.isNoteOn())
-                    {
-                        auto newEvent = new MidiEventHolder (MidiMessage::noteOff (chan, note));
-                        list.insert (j, newEvent);
-                        newEvent->message.setTimeStamp (m.getTimeStamp());
-                        meh->noteOffObject = newEvent;
-                        break;
-                    }
-                }
+        if (held != nullptr)
+        {
+            if (isNoteOn)
+            {
+                auto newEvent = new MidiEventHolder (MidiMessage::noteOff (m.getChannel(), m.getNoteNumber()));
+                newEvent->message.setTimeStamp (m.getTimeStamp());
+                insertions.add ({ i, newEvent });
+                held->noteOffObject = newEvent;
+            }
+            else
+            {
+                held->noteOffObject = meh;
             }
+
+            held = nullptr;
         }
+
+        if (isNoteOn)
+        {
+            meh->noteOffObject = nullptr;
+            held = meh;
+        }
+    }
+
+    if (insertions.isEmpty())
+        return;
+
+    // Now make room for all the new note-offs at once, moving the events up from the end
+    auto oldSize = list.size();
+
+    for (int i = 0; i < insertions.size(); ++i)
+        list.add (nullptr);
+
+    auto* events = list.data();
+    auto dest = list.size();
+
+    for (int i = insertions.size(); --i >= 0;)
+    {
+        auto [index, newEvent] = insertions.getReference (i);
+
+        while (oldSize > index)
+            events[--dest] = events[--oldSize];
+
+        events[--dest] = newEvent;
     }
 }
 
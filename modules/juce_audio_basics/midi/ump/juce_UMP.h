@@ -44,11 +44,13 @@
 #include "juce_UMPView.h"
 #include "juce_UMPIterator.h"
 #include "juce_UMPackets.h"
+#include "juce_UMPEventBuffer.h"
 #include "juce_UMPFactory.h"
 #include "juce_UMPConversion.h"
 #include "juce_UMPMidi1ToBytestreamTranslator.h"
 #include "juce_UMPMidi1ToMidi2DefaultTranslator.h"
 #include "juce_UMPConverters.h"
+#include "juce_UMPBufferConversion.h"
 #include "juce_UMPDispatcher.h"
 #include "juce_UMPReceiver.h"
 
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#ifndef DOXYGEN
+
+namespace juce::universal_midi_packets
+{
+
+/**
+    Converts whole buffers of events between MIDI 1.0 bytestream, MIDI 1.0 UMP and
+    MIDI 2.0 UMP formats.
+
+    Each function walks its source buffer once, converting every event in place and
+    appending the results straight to the destination at the same sample positions.
+    The messages in a MidiBuffer are already complete, so they're converted directly
+    rather than going through the byte-by-byte parsing of BytestreamToUMPDispatcher.
+    If the destination has a fixed capacity, none of these allocate, except for
+    Midi1ToBytestreamTranslator when a sysex message outgrows its reserved storage.
+
+    @tags{Audio}
+*/
+struct BufferConversion
+{
+    /** Converts the messages in a MidiBuffer to MIDI 1.0 UMP packets. A sysex message
+        may become several packets, all at the same sample position.
+    */
+    static void toMidi1 (const MidiBuffer& source, EventBuffer& dest)
+    {
+        for (const auto metadata : source)
+        {
+            Conversion::toMidi1 (BytestreamMidiView (metadata), [&] (const View& view)
+            {
+                dest.addEvent (view, metadata.samplePosition);
+            });
+        }
+    }
+
+    /** Converts the messages in a MidiBuffer to MIDI 2.0 UMP packets.
+
+        The translator holds the state of any RPN, NRPN and bank select sequences that
+        span several messages, so use the same one for consecutive blocks of a stream.
+    */
+    static void toMidi2 (const MidiBuffer& source, EventBuffer& dest, Midi1ToMidi2DefaultTranslator& translator)
+    {
+        for (const auto metadata : source)
+        {
+            Conversion::toMidi1 (BytestreamMidiView (metadata), [&] (const View& view)
+            {
+                translator.dispatch (view, [&] (const View& translated)
+                {
+                    dest.addEvent (translated, metadata.samplePosition);
+                });
+            });
+        }
+    }
+
+    /** Converts MIDI 1.0 channel voice packets to MIDI 2.0, passing any other packets
+        through unchanged.
+    */
+    static void midi1ToMidi2 (const EventBuffer& source, EventBuffer& dest, Midi1ToMidi2DefaultTranslator& translator)
+    {
+        for (const auto event : source)
+        {
+            if (Utils::getMessageType (event.packet[0]) != 0x2)
+            {
+                dest.addEvent (event.packet, event.samplePosition);
+                continue;
+            }
+
+            translator.dispatch (event.packet, [&] (const View& translated)
+            {
+                dest.addEvent (translated, event.samplePosition);
+            });
+        }
+    }
+
+    /** Converts MIDI 2.0 channel voice packets to MIDI 1.0, passing any other packets
+        through unchanged. MIDI 2.0 messages with no MIDI 1.0 equivalent are dropped.
+    */
+    static void midi2ToMidi1 (const EventBuffer& source, EventBuffer& dest)
+    {
+        for (const auto event : source)
+        {
+            if (Utils::getMessageType (event.packet[0]) != 0x4)
+            {
+                dest.addEvent (event.packet, event.samplePosition);
+                continue;
+            }
+
+            Conversion::midi2ToMidi1DefaultTranslation (event.packet, [&] (const View& translated)
+            {
+                dest.addEvent (translated, event.samplePosition);
+            });
+        }
+    }
+
+    /** Converts MIDI 1.0 or MIDI 2.0 UMP packets to bytestream messages in a MidiBuffer.
+
+        The translator reassembles sysex messages that span several packets, which will
+        be added at the position of their first packet.
+    */
+    static void toMidiBuffer (const EventBuffer& source, MidiBuffer& dest, Midi1ToBytestreamTranslator& translator)
+    {
+        const auto addMessage = [&dest] (const BytestreamMidiView& message)
+        {
+            dest.addEvent (message.bytes.data(), (int) message.bytes.size(), (int) message.timestamp);
+        };
+
+        for (const auto event : source)
+        {
+            const auto time = (double) event.samplePosition;
+
+            Conversion::midi2ToMidi1DefaultTranslation (event.packet, [&] (const View& midi1)
+            {
+                translator.dispatch (midi1, time, addMessage);
+            });
+        }
+    }
+};
+
+} // namespace juce::universal_midi_packets
+
+#endif
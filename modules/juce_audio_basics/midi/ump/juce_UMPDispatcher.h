@@ -156,6 +156,35 @@ public:
         concatenator.pushMidiData (begin, int (end - begin), timestamp, (void*) nullptr, inputCallback);
     }
 
+    /** Converts a range of bytes, adding the packets to an EventBuffer at a sample position. */
+    void dispatch (const uint8_t* begin, const uint8_t* end, int samplePosition, EventBuffer& dest)
+    {
+        dispatch (begin, end, (double) samplePosition, [&dest, samplePosition] (const View& view)
+        {
+            dest.addEvent (view, samplePosition);
+        });
+    }
+
+    /** Converts all the messages in a MidiBuffer, adding the packets to an EventBuffer at
+        the same sample positions.
+
+        The messages in a MidiBuffer are already complete, so they skip the parsing that the
+        other dispatch() functions use to find the messages in a stream of bytes.
+    */
+    void dispatch (const MidiBuffer& source, EventBuffer& dest)
+    {
+        for (const auto metadata : source)
+        {
+            Conversion::toMidi1 (BytestreamMidiView (metadata), [&] (const View& view)
+            {
+                converter.convert (view, [&] (const View& converted)
+                {
+                    dest.addEvent (converted, metadata.samplePosition);
+                });
+            });
+        }
+    }
+
 private:
     MidiDataConcatenator concatenator;
     GenericUMPConverter converter;
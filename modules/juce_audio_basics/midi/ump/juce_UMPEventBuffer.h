@@ -0,0 +1,298 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#ifndef DOXYGEN
+
+namespace juce::universal_midi_packets
+{
+
+/**
+    Holds a sequence of Universal MIDI Packets, each with a sample position.
+
+    This is the UMP equivalent of MidiBuffer. The events are kept in time order in a single
+    block of 32-bit words, each one being a word holding the sample position followed by
+    the words of the packet, so iterating the buffer just walks through memory and hands
+    out Views of the packets in place.
+
+    For use in a processBlock() callback, call setFixedCapacity() when preparing, after
+    which adding events never allocates.
+
+    @see BufferConversion, Packets
+
+    @tags{Audio}
+*/
+class EventBuffer
+{
+public:
+    /** An event in the buffer. The View points into the buffer's storage. */
+    struct Event
+    {
+        View packet;
+        int samplePosition = 0;
+    };
+
+    /** Iterates the events in an EventBuffer. */
+    class Iterator
+    {
+    public:
+        using difference_type    = std::ptrdiff_t;
+        using value_type         = Event;
+        using reference          = Event;
+        using pointer            = void;
+        using iterator_category  = std::forward_iterator_tag;
+
+        Iterator() noexcept = default;
+        explicit Iterator (const uint32_t* d) noexcept : ptr (d) {}
+
+        Event operator*() const noexcept        { return { View (ptr + 1), (int) ptr[0] }; }
+
+        Iterator& operator++() noexcept
+        {
+            ptr += 1 + Utils::getNumWordsForMessageType (ptr[1]);
+            return *this;
+        }
+
+        Iterator operator++ (int) noexcept
+        {
+            auto copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        bool operator== (const Iterator& other) const noexcept  { return ptr == other.ptr; }
+        bool operator!= (const Iterator& other) const noexcept  { return ptr != other.ptr; }
+
+        /** Returns a pointer to the storage of the event, i.e. to its sample position word. */
+        const uint32_t* data() const noexcept   { return ptr; }
+
+    private:
+        const uint32_t* ptr = nullptr;
+    };
+
+    //==============================================================================
+    /** Creates an empty buffer. */
+    EventBuffer() = default;
+
+    /** Creates a copy of another buffer, including its fixed capacity. */
+    EventBuffer (const EventBuffer& other)
+        : fixedCapacity (other.fixedCapacity),
+          numEvents (other.numEvents),
+          lastSamplePosition (other.lastSamplePosition),
+          numDroppedEvents (other.numDroppedEvents)
+    {
+        // A copied vector only reserves what it needs, so the fixed capacity is reserved first
+        storage.reserve (std::max (fixedCapacity, other.storage.size()));
+        storage.assign (other.storage.begin(), other.storage.end());
+    }
+
+    /** Copies another buffer, including its fixed capacity.
+        If this buffer already has enough storage, the copy doesn't allocate.
+    */
+    EventBuffer& operator= (const EventBuffer& other)
+    {
+        if (this != &other)
+        {
+            storage.reserve (std::max (other.fixedCapacity, other.storage.size()));
+            storage.assign (other.storage.begin(), other.storage.end());
+            fixedCapacity = other.fixedCapacity;
+            numEvents = other.numEvents;
+            lastSamplePosition = other.lastSamplePosition;
+            numDroppedEvents = other.numDroppedEvents;
+        }
+
+        return *this;
+    }
+
+    /** Moves another buffer's contents and fixed capacity into a new one, leaving the
+        other buffer empty, with no fixed capacity.
+    */
+    EventBuffer (EventBuffer&& other) noexcept
+        : storage (std::move (other.storage)),
+          fixedCapacity (std::exchange (other.fixedCapacity, 0)),
+          numEvents (std::exchange (other.numEvents, 0)),
+          lastSamplePosition (std::exchange (other.lastSamplePosition, 0)),
+          numDroppedEvents (std::exchange (other.numDroppedEvents, 0))
+    {
+        other.storage.clear();
+    }
+
+    /** Moves another buffer's contents and fixed capacity into this one, leaving the
+        other buffer empty, with no fixed capacity.
+    */
+    EventBuffer& operator= (EventBuffer&& other) noexcept
+    {
+        if (this != &other)
+            EventBuffer (std::move (other)).swapWith (*this);
+
+        return *this;
+    }
+
+    //==============================================================================
+    /** Adds a packet at a sample position.
+
+        Events with the same sample position stay in the order in which they were added.
+        Adding an event at or after the last one is the quick case, and only copies the
+        packet's words to the end of the buffer.
+
+        Returns false if the buffer has a fixed capacity and the event didn't fit.
+    */
+    bool addEvent (const View& packet, int samplePosition)
+    {
+        const auto numPacketWords = (size_t) packet.size();
+        const auto numWords = 1 + numPacketWords;
+
+        if (fixedCapacity > 0 && storage.size() + numWords > fixedCapacity)
+        {
+            ++numDroppedEvents;
+            return false;
+        }
+
+        std::array<uint32_t, 5> words;
+        words[0] = (uint32_t) samplePosition;
+        std::copy (packet.begin(), packet.begin() + numPacketWords, words.begin() + 1);
+
+        auto insertPosition = storage.end();
+
+        if (numEvents > 0 && samplePosition < lastSamplePosition)
+            insertPosition = storage.begin() + (findNextSamplePosition (samplePosition + 1).data() - storage.data());
+        else
+            lastSamplePosition = samplePosition;
+
+        storage.insert (insertPosition, words.begin(), words.begin() + numWords);
+        ++numEvents;
+        return true;
+    }
+
+    template <size_t numWords>
+    bool addEvent (const Packet<numWords>& packet, int samplePosition)
+    {
+        jassert (Utils::getNumWordsForMessageType (packet[0]) == numWords);
+        return addEvent (View (packet.data()), samplePosition);
+    }
+
+    /** Adds the events from a range of another buffer, offsetting their positions by
+        sampleDeltaToAdd.
+    */
+    void addEvents (const EventBuffer& other, int startSample, int numSamples, int sampleDeltaToAdd)
+    {
+        for (auto it = other.findNextSamplePosition (startSample); it != other.cend(); ++it)
+        {
+            const auto event = *it;
+
+            if (numSamples >= 0 && event.samplePosition >= startSample + numSamples)
+                break;
+
+            addEvent (event.packet, event.samplePosition + sampleDeltaToAdd);
+        }
+    }
+
+    /** Removes all the events, keeping the storage. */
+    void clear() noexcept
+    {
+        storage.clear();
+        numEvents = 0;
+        lastSamplePosition = 0;
+    }
+
+    /** Swaps the contents of two buffers. */
+    void swapWith (EventBuffer& other) noexcept
+    {
+        storage.swap (other.storage);
+        std::swap (numEvents, other.numEvents);
+        std::swap (lastSamplePosition, other.lastSamplePosition);
+        std::swap (fixedCapacity, other.fixedCapacity);
+        std::swap (numDroppedEvents, other.numDroppedEvents);
+    }
+
+    //==============================================================================
+    /** Returns true if there are no events. */
+    bool isEmpty() const noexcept                   { return numEvents == 0; }
+
+    /** Returns the number of events. */
+    int getNumEvents() const noexcept               { return numEvents; }
+
+    /** Returns the number of 32-bit words in use, including the sample positions. */
+    size_t getNumWords() const noexcept             { return storage.size(); }
+
+    /** Returns the number of 32-bit words that can be held before the storage has to grow. */
+    size_t getNumWordsAllocated() const noexcept    { return storage.capacity(); }
+
+    /** Returns the sample position of the first event, or 0 if there are none. */
+    int getFirstEventTime() const noexcept          { return isEmpty() ? 0 : (int) storage.front(); }
+
+    /** Returns the sample position of the last event, or 0 if there are none. */
+    int getLastEventTime() const noexcept           { return lastSamplePosition; }
+
+    /** Returns an iterator to the first event at or after a sample position. */
+    Iterator findNextSamplePosition (int samplePosition) const noexcept
+    {
+        auto it = cbegin();
+
+        for (const auto end = cend(); it != end && (int) *it.data() < samplePosition; ++it)
+        {}
+
+        return it;
+    }
+
+    Iterator cbegin() const noexcept                { return Iterator (storage.data()); }
+    Iterator cend() const noexcept                  { return Iterator (storage.data() + storage.size()); }
+    Iterator begin() const noexcept                 { return cbegin(); }
+    Iterator end() const noexcept                   { return cend(); }
+
+    //==============================================================================
+    /** Reserves storage for a number of 32-bit words, so that the buffer doesn't need to
+        grow until it holds that much.
+    */
+    void reserve (size_t numWords)                  { storage.reserve (numWords); }
+
+    /** Reserves a fixed amount of storage, so that the buffer can be used on a realtime thread.
+
+        After this has been called, adding events will never reallocate the buffer's storage.
+        Instead, any event that doesn't fit in the remaining space is dropped, and counted by
+        getNumDroppedEvents(). Each event takes one word for its sample position, plus one to
+        four for its packet. Passing 0 turns the buffer back into one that grows as needed.
+    */
+    void setFixedCapacity (size_t maxNumWords)
+    {
+        storage.reserve (maxNumWords);
+        fixedCapacity = maxNumWords;
+    }
+
+    /** Returns the capacity set by setFixedCapacity(), or 0 if the buffer can grow. */
+    size_t getFixedCapacity() const noexcept        { return fixedCapacity; }
+
+    /** Returns the number of events that were dropped because the buffer's fixed capacity
+        was full.
+    */
+    int getNumDroppedEvents() const noexcept        { return numDroppedEvents; }
+
+    /** Resets the count returned by getNumDroppedEvents(). */
+    void resetNumDroppedEvents() noexcept           { numDroppedEvents = 0; }
+
+private:
+    std::vector<uint32_t> storage;
+    size_t fixedCapacity = 0;
+    int numEvents = 0, lastSamplePosition = 0, numDroppedEvents = 0;
+};
+
+} // namespace juce::universal_midi_packets
+
+#endif
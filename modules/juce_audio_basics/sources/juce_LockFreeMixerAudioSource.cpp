@@ -0,0 +1,449 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+struct LockFreeMixerAudioSource::Input  : public ReferenceCountedObject
+{
+    Input (AudioSource* s, bool shouldDelete)
+        : source (s), deleteWhenRemoved (shouldDelete)
+    {
+    }
+
+    AudioSource* source;
+    const bool deleteWhenRemoved;
+    AudioBuffer<float> scratch;
+
+    JUCE_DECLARE_NON_COPYABLE (Input)
+};
+
+struct LockFreeMixerAudioSource::InputList  : public ReferenceCountedObject
+{
+    ReferenceCountedArray<Input> inputs;
+};
+
+//==============================================================================
+class LockFreeMixerAudioSource::Worker  : public Thread
+{
+public:
+    Worker (LockFreeMixerAudioSource& o, int index)
+        : Thread ("Mixer worker " + String (index)), owner (o)
+    {
+    }
+
+    ~Worker() override
+    {
+        signalThreadShouldExit();
+        owner.workAvailable.signal();
+        stopThread (1000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+            if (owner.workAvailable.wait (100))
+                owner.runRenderJobs();
+    }
+
+private:
+    LockFreeMixerAudioSource& owner;
+};
+
+class LockFreeMixerAudioSource::Collector  : public Thread
+{
+public:
+    explicit Collector (LockFreeMixerAudioSource& o)
+        : Thread ("Mixer garbage collector"), owner (o)
+    {
+        startThread (Priority::low);
+    }
+
+    ~Collector() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (2000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (50);
+            owner.collectGarbage (false);
+        }
+    }
+
+private:
+    LockFreeMixerAudioSource& owner;
+};
+
+//==============================================================================
+LockFreeMixerAudioSource::LockFreeMixerAudioSource()
+{
+    publish (new InputList());
+    collector = std::make_unique<Collector> (*this);
+}
+
+LockFreeMixerAudioSource::~LockFreeMixerAudioSource()
+{
+    collector.reset();
+    workers.clear();
+
+    removeAllInputs();
+    collectGarbage (true);
+}
+
+//==============================================================================
+uint64 LockFreeMixerAudioSource::publish (ReferenceCountedObjectPtr<InputList> newList)
+{
+    uint64 callbackTicket;
+
+    {
+        const ScopedLock sl (editLock);
+
+        auto oldList = listHolder;
+        listHolder = newList;
+        currentList = newList.get();
+
+        // Any callback that starts after this point will see the new list, so the old one can
+        // be released once all the callbacks that had already started have finished.
+        callbackTicket = callbacksStarted.load();
+
+        if (oldList != nullptr)
+            retiredLists.add ({ oldList, callbackTicket });
+    }
+
+    if (collector != nullptr)
+        collector->notify();
+
+    return callbackTicket;
+}
+
+void LockFreeMixerAudioSource::releaseRemovedInputs (const ReferenceCountedArray<Input>& removed, uint64 callbackTicket)
+{
+    // The audio thread may still be rendering these inputs until the callbacks that started before
+    // they were removed have finished. Releasing them here, rather than when the old lists are
+    // collected, means a source that's added again can't be released while it's back in use.
+    while (callbacksFinished.load() < callbackTicket)
+        Thread::sleep (1);
+
+    for (auto* input : removed)
+    {
+        input->source->releaseResources();
+
+        if (input->deleteWhenRemoved)
+            delete input->source;
+
+        input->source = nullptr;
+    }
+}
+
+void LockFreeMixerAudioSource::collectGarbage (bool force)
+{
+    Array<ReferenceCountedObjectPtr<InputList>> toRelease;
+
+    {
+        const ScopedLock sl (editLock);
+        const auto finished = callbacksFinished.load();
+
+        for (int i = retiredLists.size(); --i >= 0;)
+        {
+            if (force || finished >= retiredLists.getReference (i).second)
+            {
+                toRelease.add (retiredLists.getReference (i).first);
+                retiredLists.remove (i);
+            }
+        }
+    }
+
+    // The lists (and any inputs that are no longer referenced) are released here, outside the lock
+    toRelease.clear();
+}
+
+//==============================================================================
+void LockFreeMixerAudioSource::addInputSource (AudioSource* input, const bool deleteWhenRemoved)
+{
+    if (input == nullptr)
+        return;
+
+    ReferenceCountedObjectPtr<InputList> newList (new InputList());
+    double localRate;
+    int localBufferSize, localNumChannels;
+
+    {
+        const ScopedLock sl (editLock);
+
+        for (auto* existing : listHolder->inputs)
+            if (existing->source == input)
+                return;
+
+        newList->inputs = listHolder->inputs;
+        localRate = currentSampleRate;
+        localBufferSize = bufferSizeExpected;
+        localNumChannels = preparedNumChannels;
+    }
+
+    ReferenceCountedObjectPtr<Input> newInput (new Input (input, deleteWhenRemoved));
+
+    if (localRate > 0.0)
+    {
+        input->prepareToPlay (localBufferSize, localRate);
+        newInput->scratch.setSize (localNumChannels, localBufferSize);
+    }
+
+    newList->inputs.add (newInput);
+    publish (newList);
+}
+
+void LockFreeMixerAudioSource::removeInputSource (AudioSource* input)
+{
+    if (input == nullptr)
+        return;
+
+    ReferenceCountedObjectPtr<InputList> newList (new InputList());
+    ReferenceCountedArray<Input> removed;
+
+    {
+        const ScopedLock sl (editLock);
+
+        for (auto* existing : listHolder->inputs)
+            (existing->source != input ? newList->inputs : removed).add (existing);
+
+        if (removed.isEmpty())
+            return;
+    }
+
+    releaseRemovedInputs (removed, publish (newList));
+}
+
+void LockFreeMixerAudioSource::removeAllInputs()
+{
+    ReferenceCountedArray<Input> removed;
+
+    {
+        const ScopedLock sl (editLock);
+
+        if (listHolder != nullptr)
+            removed = listHolder->inputs;
+    }
+
+    releaseRemovedInputs (removed, publish (new InputList()));
+}
+
+int LockFreeMixerAudioSource::getNumInputs() const noexcept
+{
+    const ScopedLock sl (editLock);
+    return listHolder != nullptr ? listHolder->inputs.size() : 0;
+}
+
+//==============================================================================
+void LockFreeMixerAudioSource::setMaximumNumChannels (int numChannels)
+{
+    jassert (numChannels > 0);
+
+    // This only takes effect at the next call to prepareToPlay()
+    const ScopedLock sl (editLock);
+    maxNumChannels = jmax (1, numChannels);
+}
+
+void LockFreeMixerAudioSource::setNumWorkerThreads (int numThreads)
+{
+    // The worker pool can't be changed while the audio thread may be using it!
+    jassert (currentSampleRate == 0.0);
+
+    workers.clear();
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto* worker = workers.add (new Worker (*this, i));
+
+        if (! worker->startRealtimeThread ({}))
+            worker->startThread (Thread::Priority::highest);
+    }
+}
+
+int LockFreeMixerAudioSource::getNumWorkerThreads() const noexcept
+{
+    return workers.size();
+}
+
+//==============================================================================
+void LockFreeMixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    ReferenceCountedObjectPtr<InputList> list;
+
+    {
+        const ScopedLock sl (editLock);
+
+        currentSampleRate = sampleRate;
+        bufferSizeExpected = samplesPerBlockExpected;
+        preparedNumChannels = maxNumChannels;
+        list = listHolder;
+    }
+
+    tempBuffer.setSize (preparedNumChannels, samplesPerBlockExpected);
+
+    for (auto* input : list->inputs)
+    {
+        input->source->prepareToPlay (samplesPerBlockExpected, sampleRate);
+        input->scratch.setSize (preparedNumChannels, samplesPerBlockExpected);
+    }
+}
+
+void LockFreeMixerAudioSource::releaseResources()
+{
+    ReferenceCountedObjectPtr<InputList> list;
+
+    {
+        const ScopedLock sl (editLock);
+
+        currentSampleRate = 0.0;
+        bufferSizeExpected = 0;
+        preparedNumChannels = 0;
+        list = listHolder;
+    }
+
+    for (auto* input : list->inputs)
+    {
+        input->source->releaseResources();
+        input->scratch.setSize (maxNumChannels, 0);
+    }
+
+    tempBuffer.setSize (maxNumChannels, 0);
+}
+
+//==============================================================================
+void LockFreeMixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    callbacksStarted.fetch_add (1);
+
+    auto* list = currentList.load();
+    const auto numInputs = list->inputs.size();
+
+    if (numInputs == 0)
+        info.clearActiveBufferRegion();
+    else if (numInputs == 1)
+        list->inputs.getUnchecked (0)->source->getNextAudioBlock (info);
+    else if (workers.isEmpty())
+        renderSerially (*list, info);
+    else
+        renderInParallel (*list, info);
+
+    callbacksFinished.fetch_add (1);
+}
+
+void LockFreeMixerAudioSource::renderSerially (InputList& list, const AudioSourceChannelInfo& info)
+{
+    const auto numChannels = info.buffer->getNumChannels();
+
+    // The temporary buffer should have been allocated in prepareToPlay() - if this asserts, you've
+    // either forgotten to call it, or need to call setMaximumNumChannels() with a bigger value.
+    // (The buffer itself may have been shrunk to fit a smaller block, so it isn't checked directly)
+    jassert (numChannels <= preparedNumChannels && info.numSamples <= bufferSizeExpected);
+
+    tempBuffer.setSize (jmax (1, numChannels), info.numSamples, false, false, true);
+    AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+
+    list.inputs.getUnchecked (0)->source->getNextAudioBlock (info);
+
+    for (int i = 1; i < list.inputs.size(); ++i)
+    {
+        list.inputs.getUnchecked (i)->source->getNextAudioBlock (info2);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            info.buffer->addFrom (chan, info.startSample, tempBuffer, chan, 0, info.numSamples);
+    }
+}
+
+void LockFreeMixerAudioSource::renderInParallel (InputList& list, const AudioSourceChannelInfo& info)
+{
+    const auto numChannels = info.buffer->getNumChannels();
+    const auto numInputs = list.inputs.size();
+
+    // Every input's scratch buffer was allocated for the prepared size, though it may have been
+    // shrunk since to fit a smaller block
+    if (numChannels > preparedNumChannels || info.numSamples > bufferSizeExpected)
+    {
+        // The scratch buffers are too small for this block, so they'd need reallocating..
+        jassertfalse;
+        renderSerially (list, info);
+        return;
+    }
+
+    jobList = &list;
+    jobNumChannels = numChannels;
+    jobNumSamples = info.numSamples;
+    jobCount = numInputs;
+    jobsDone = 0;
+
+    // The number of jobs and the next job index are packed together, so that a worker that wakes
+    // up late can't pick up a stale index and match it against a newer job count
+    jobTicket = ((uint64) (uint32) numInputs) << 32;
+
+    // The audio thread takes a share of the jobs itself, so there's no point waking more workers
+    // than there are other jobs. Signalling the semaphore never takes a lock.
+    workAvailable.signal (jmin (workers.size(), numInputs - 1));
+
+    runRenderJobs();
+
+    // Whichever thread finishes the last job signals this exactly once per block
+    jobsFinished.wait();
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        auto* dest = info.buffer->getWritePointer (chan, info.startSample);
+
+        FloatVectorOperations::copy (dest, list.inputs.getUnchecked (0)->scratch.getReadPointer (chan), info.numSamples);
+
+        for (int i = 1; i < numInputs; ++i)
+            FloatVectorOperations::add (dest, list.inputs.getUnchecked (i)->scratch.getReadPointer (chan), info.numSamples);
+    }
+}
+
+void LockFreeMixerAudioSource::runRenderJobs() noexcept
+{
+    for (;;)
+    {
+        auto ticket = jobTicket.load();
+        const auto count = (int) (ticket >> 32);
+        const auto index = (int) (ticket & 0xffffffff);
+
+        if (index >= count)
+            return;
+
+        if (! jobTicket.compare_exchange_weak (ticket, ticket + 1))
+            continue;
+
+        auto& scratch = jobList->inputs.getUnchecked (index)->scratch;
+        scratch.setSize (jobNumChannels, jobNumSamples, false, false, true);
+
+        AudioSourceChannelInfo info (&scratch, 0, jobNumSamples);
+        jobList->inputs.getUnchecked (index)->source->getNextAudioBlock (info);
+
+        if (jobsDone.fetch_add (1) + 1 == jobCount)
+            jobsFinished.signal();
+    }
+}
+
+} // namespace juce
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioSource that mixes together the output of a set of other AudioSources,
+    without ever taking a lock on the audio thread.
+
+    This works like MixerAudioSource, but the list of inputs is an immutable snapshot
+    that gets swapped atomically whenever an input is added or removed. Snapshots that
+    have been replaced are kept alive until the audio thread has finished any callback
+    that might still be using them, and are then released on a background thread, so
+    the audio thread never frees any memory.
+
+    Optionally, the inputs can be rendered in parallel: call setNumWorkerThreads() and
+    each input will be rendered into its own scratch buffer by a pool of realtime worker
+    threads (with the audio thread joining in), before all the scratch buffers are summed
+    into the output.
+
+    Methods that change the inputs or the configuration must be called from one thread
+    at a time (normally the message thread), and not concurrently with prepareToPlay()
+    or releaseResources().
+
+    @see MixerAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  LockFreeMixerAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a LockFreeMixerAudioSource. */
+    LockFreeMixerAudioSource();
+
+    /** Destructor. */
+    ~LockFreeMixerAudioSource() override;
+
+    //==============================================================================
+    /** Adds an input source to the mixer.
+
+        If the mixer is running, the input will be prepared with the mixer's current
+        settings before being published to the audio thread.
+
+        @param newInput             the source to add to the mixer
+        @param deleteWhenRemoved    if true, then this source will be deleted when
+                                    no longer needed by the mixer.
+    */
+    void addInputSource (AudioSource* newInput, bool deleteWhenRemoved);
+
+    /** Removes an input source.
+
+        This waits for any audio callback that might still be rendering the input to
+        finish, and then calls its releaseResources() method (and deletes it, if it was
+        added with deleteWhenRemoved) before returning, so the source can be added again
+        straight away.
+    */
+    void removeInputSource (AudioSource* input);
+
+    /** Removes all the input sources. */
+    void removeAllInputs();
+
+    /** Returns the number of inputs currently published to the audio thread. */
+    int getNumInputs() const noexcept;
+
+    //==============================================================================
+    /** Sets the highest number of channels that the mixer will be asked to render.
+
+        The per-input scratch buffers are sized using this value, so that no allocation
+        happens on the audio thread. The default is 2.
+    */
+    void setMaximumNumChannels (int numChannels);
+
+    /** Enables parallel rendering of the inputs.
+
+        With 0 worker threads (the default), the inputs are rendered one after the other
+        on the audio thread. With more, the workers and the audio thread share out the
+        inputs between them. The worker threads are realtime threads, so you shouldn't
+        create more of them than there are spare cores.
+    */
+    void setNumWorkerThreads (int numThreads);
+
+    /** Returns the number of worker threads used for parallel rendering. */
+    int getNumWorkerThreads() const noexcept;
+
+    //==============================================================================
+    /** Implementation of the AudioSource method.
+        This will call prepareToPlay() on all its input sources.
+    */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Implementation of the AudioSource method.
+        This will call releaseResources() on all its input sources.
+    */
+    void releaseResources() override;
+
+    /** Implementation of the AudioSource method. */
+    void getNextAudioBlock (const AudioSourceChannelInfo&) override;
+
+private:
+    //==============================================================================
+    struct Input;
+    struct InputList;
+    class Worker;
+    class Collector;
+
+    uint64 publish (ReferenceCountedObjectPtr<InputList>);
+    void releaseRemovedInputs (const ReferenceCountedArray<Input>&, uint64 callbackTicket);
+    void collectGarbage (bool force);
+    void renderSerially (InputList&, const AudioSourceChannelInfo&);
+    void renderInParallel (InputList&, const AudioSourceChannelInfo&);
+    void runRenderJobs() noexcept;
+
+    //==============================================================================
+    std::atomic<InputList*> currentList { nullptr };
+    std::atomic<uint64> callbacksStarted { 0 }, callbacksFinished { 0 };
+
+    CriticalSection editLock;
+    ReferenceCountedObjectPtr<InputList> listHolder;
+    Array<std::pair<ReferenceCountedObjectPtr<InputList>, uint64>> retiredLists;
+
+    AudioBuffer<float> tempBuffer;
+    double currentSampleRate = 0.0;
+    int bufferSizeExpected = 0, maxNumChannels = 2, preparedNumChannels = 0;
+
+    std::atomic<uint64> jobTicket { 0 };
+    std::atomic<int> jobsDone { 0 };
+    InputList* jobList = nullptr;
+    int jobNumChannels = 0, jobNumSamples = 0, jobCount = 0;
+    LightweightSemaphore workAvailable, jobsFinished;
+
+    OwnedArray<Worker> workers;
+    std::unique_ptr<Collector> collector;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LockFreeMixerAudioSource)
+};
+
+} // namespace juce
@@ -0,0 +1,438 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+class AudioPrefetchScheduler::DiskThread  : public Thread
+{
+public:
+    DiskThread (AudioPrefetchScheduler& o, int index)
+        : Thread ("Audio prefetch " + String (index)), owner (o)
+    {
+        startThread (Priority::high);
+    }
+
+    ~DiskThread() override
+    {
+        stopThread (5000);
+    }
+
+    void run() override
+    {
+        // When there's nothing to read, sleep until a stream is added, seeks, or has some
+        // of its data consumed
+        while (! threadShouldExit())
+        {
+            if (owner.serviceMostUrgentStream())
+                continue;
+
+            owner.workAvailable.wait();
+
+            if (! threadShouldExit())
+                --owner.numPendingWakeUps;
+        }
+    }
+
+private:
+    AudioPrefetchScheduler& owner;
+};
+
+//==============================================================================
+AudioPrefetchScheduler::AudioPrefetchScheduler (int numDiskThreads)
+{
+    jassert (numDiskThreads > 0);
+
+    for (int i = 0; i < jmax (1, numDiskThreads); ++i)
+        threads.add (new DiskThread (*this, i));
+}
+
+AudioPrefetchScheduler::~AudioPrefetchScheduler()
+{
+    // All the streams using this scheduler should have been deleted first!
+    jassert (streams.isEmpty());
+
+    for (auto* thread : threads)
+        thread->signalThreadShouldExit();
+
+    workAvailable.signal (threads.size());
+    threads.clear();
+}
+
+int AudioPrefetchScheduler::getNumStreams() const
+{
+    const ScopedLock sl (streamsLock);
+    return streams.size();
+}
+
+void AudioPrefetchScheduler::addStream (PrefetchingAudioSource* stream)
+{
+    {
+        const ScopedLock sl (streamsLock);
+        streams.addIfNotAlreadyThere (stream);
+    }
+
+    wakeUp();
+}
+
+void AudioPrefetchScheduler::removeStream (PrefetchingAudioSource* stream)
+{
+    {
+        const ScopedLock sl (streamsLock);
+        streams.removeFirstMatchingValue (stream);
+    }
+
+    // A disk thread may have picked this stream just before it was removed
+    while (stream->isServicing.load())
+        Thread::yield();
+}
+
+void AudioPrefetchScheduler::wakeUp() noexcept
+{
+    // This is called from the audio thread, so it mustn't take a lock. Only signalling while
+    // fewer wake-ups are pending than there are threads stops the count from building up
+    // while the threads are busy reading.
+    auto numPending = numPendingWakeUps.load();
+
+    while (numPending < threads.size())
+    {
+        if (numPendingWakeUps.compare_exchange_weak (numPending, numPending + 1))
+        {
+            workAvailable.signal();
+            ++numPending;
+        }
+    }
+}
+
+bool AudioPrefetchScheduler::serviceMostUrgentStream()
+{
+    PrefetchingAudioSource* mostUrgent = nullptr;
+
+    {
+        const ScopedLock sl (streamsLock);
+        auto shortestTime = std::numeric_limits<double>::max();
+
+        for (auto* stream : streams)
+        {
+            if (stream->isServicing.load() || ! stream->needsData())
+                continue;
+
+            const auto timeLeft = stream->getSecondsUntilUnderrun();
+
+            if (timeLeft < shortestTime)
+            {
+                shortestTime = timeLeft;
+                mostUrgent = stream;
+            }
+        }
+
+        if (mostUrgent == nullptr)
+            return false;
+
+        if (mostUrgent->isServicing.exchange (true))
+            return true;
+    }
+
+    const auto didRead = mostUrgent->readNextChunk();
+    mostUrgent->isServicing = false;
+    return didRead;
+}
+
+//==============================================================================
+PrefetchingAudioSource::PrefetchingAudioSource (PositionableAudioSource* s,
+                                                AudioPrefetchScheduler& sched,
+                                                bool deleteSourceWhenDeleted,
+                                                int bufferSizeSamples,
+                                                int numChannels,
+                                                bool prefillBufferOnPrepareToPlay)
+    : source (s, deleteSourceWhenDeleted),
+      scheduler (sched),
+      numberOfSamplesToBuffer (jmax ((int) chunkSize * 4, bufferSizeSamples)),
+      numberOfChannels (numChannels),
+      prefillBuffer (prefillBufferOnPrepareToPlay)
+{
+    jassert (source != nullptr);
+}
+
+PrefetchingAudioSource::~PrefetchingAudioSource()
+{
+    releaseResources();
+}
+
+//==============================================================================
+void PrefetchingAudioSource::prepareToPlay (int samplesPerBlockExpected, double newSampleRate)
+{
+    scheduler.removeStream (this);
+    isPrepared = false;
+
+    sampleRate = newSampleRate;
+    source->prepareToPlay (samplesPerBlockExpected, newSampleRate);
+
+    const auto bufferSizeNeeded = jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
+    const auto numChunks = (bufferSizeNeeded + chunkSize - 1) / chunkSize;
+
+    // An AbstractFifo can hold one item less than its size, so add a spare slot
+    ring.setSize (numberOfChannels, (numChunks + 1) * chunkSize);
+    ring.clear();
+    headers.calloc ((size_t) numChunks + 1);
+    fifo.setTotalSize (numChunks + 1);
+    fifo.reset();
+    readOffsetInChunk = 0;
+
+    producerGeneration = generation.load();
+    producerPosition = nextPlayPos.load();
+    sourceReadPosition = -1;
+    seekPosition = producerPosition;
+
+    isPrepared = true;
+    scheduler.addStream (this);
+
+    const auto prefillTarget = jmin ((int) newSampleRate / 4, (numChunks * chunkSize) / 2);
+
+    while (prefillBuffer && getReadAheadSamples() < prefillTarget)
+    {
+        scheduler.wakeUp();
+        Thread::sleep (5);
+    }
+}
+
+void PrefetchingAudioSource::releaseResources()
+{
+    scheduler.removeStream (this);
+    isPrepared = false;
+
+    ring.setSize (numberOfChannels, 0);
+
+    if (source != this)
+        source->releaseResources();
+}
+
+void PrefetchingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    // If a seek is in progress on another thread, the data isn't valid anyway
+    if (! isPrepared.load() || consumerActive.exchange (true))
+    {
+        info.clearActiveBufferRegion();
+        return;
+    }
+
+    const auto currentGeneration = generation.load();
+    const auto numChannelsToCopy = jmin (numberOfChannels, info.buffer->getNumChannels());
+    auto playPos = nextPlayPos.load();
+    auto underrun = false, freedChunks = false;
+    int done = 0;
+
+    while (done < info.numSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+        {
+            info.buffer->clear (info.startSample + done, info.numSamples - done);
+            playPos += info.numSamples - done;
+            underrun = true;
+            break;
+        }
+
+        const auto& header = headers[start1];
+        const auto chunkPos = header.position + readOffsetInChunk;
+        const auto available = header.numSamples - readOffsetInChunk;
+
+        if (header.generation != currentGeneration || chunkPos + available <= playPos)
+        {
+            // This chunk was read before a seek, or we've already played past it
+            fifo.finishedRead (1);
+            readOffsetInChunk = 0;
+            freedChunks = true;
+            continue;
+        }
+
+        if (chunkPos < playPos)
+        {
+            readOffsetInChunk += (int) (playPos - chunkPos);
+            continue;
+        }
+
+        if (chunkPos > playPos)
+        {
+            const auto gap = (int) jmin ((int64) (info.numSamples - done), chunkPos - playPos);
+            info.buffer->clear (info.startSample + done, gap);
+            done += gap;
+            playPos += gap;
+            underrun = true;
+            continue;
+        }
+
+        const auto numToCopy = jmin (available, info.numSamples - done);
+
+        for (int chan = 0; chan < numChannelsToCopy; ++chan)
+            info.buffer->copyFrom (chan, info.startSample + done,
+                                   ring, chan, start1 * chunkSize + readOffsetInChunk,
+                                   numToCopy);
+
+        done += numToCopy;
+        playPos += numToCopy;
+        readOffsetInChunk += numToCopy;
+
+        if (readOffsetInChunk >= header.numSamples)
+        {
+            fifo.finishedRead (1);
+            readOffsetInChunk = 0;
+            freedChunks = true;
+        }
+    }
+
+    if (underrun)
+        ++numUnderruns;
+
+    nextPlayPos = playPos;
+    consumerActive = false;
+
+    if (freedChunks)
+        scheduler.wakeUp();
+}
+
+//==============================================================================
+void PrefetchingAudioSource::setNextReadPosition (int64 newPosition)
+{
+    // Take over the consumer side of the FIFO, so that the stale chunks can be thrown away
+    // right now rather than on the next callback, and the disk threads can start refilling.
+    while (consumerActive.exchange (true))
+        Thread::yield();
+
+    discardAllChunks();
+    seekPosition = newPosition;
+    nextPlayPos = newPosition;
+    ++generation;
+
+    consumerActive = false;
+    scheduler.wakeUp();
+}
+
+int64 PrefetchingAudioSource::getNextReadPosition() const
+{
+    jassert (source->getTotalLength() > 0);
+    const auto pos = nextPlayPos.load();
+
+    return (source->isLooping() && pos > 0)
+                    ? pos % source->getTotalLength()
+                    : pos;
+}
+
+void PrefetchingAudioSource::discardAllChunks() noexcept
+{
+    fifo.finishedRead (fifo.getNumReady());
+    readOffsetInChunk = 0;
+}
+
+//==============================================================================
+PrefetchingAudioSource::Statistics PrefetchingAudioSource::getStatistics() const noexcept
+{
+    Statistics stats;
+    stats.numUnderruns = numUnderruns.load();
+    stats.readAheadSamples = getReadAheadSamples();
+    stats.capacitySamples = isPrepared.load() ? (fifo.getTotalSize() - 1) * chunkSize : 0;
+    stats.lastReadLatencyMs = lastReadLatencyMs.load();
+    stats.maxReadLatencyMs = maxReadLatencyMs.load();
+    return stats;
+}
+
+void PrefetchingAudioSource::resetStatistics() noexcept
+{
+    numUnderruns = 0;
+    maxReadLatencyMs = 0.0;
+}
+
+int PrefetchingAudioSource::getReadAheadSamples() const noexcept
+{
+    return fifo.getNumReady() * chunkSize;
+}
+
+double PrefetchingAudioSource::getSecondsUntilUnderrun() const noexcept
+{
+    return getReadAheadSamples() / jmax (1.0, sampleRate);
+}
+
+bool PrefetchingAudioSource::needsData() const noexcept
+{
+    return isPrepared.load() && fifo.getFreeSpace() > 0;
+}
+
+bool PrefetchingAudioSource::readNextChunk()
+{
+    if (! isPrepared.load())
+        return false;
+
+    const auto currentGeneration = generation.load();
+
+    if (currentGeneration != producerGeneration)
+    {
+        producerGeneration = currentGeneration;
+        producerPosition = seekPosition.load();
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+        return false;
+
+    const auto startTicks = Time::getHighResolutionTicks();
+
+    // A looping source wraps its own position, so the producer's position is wrapped the same
+    // way, and the source only needs to be told where to read after a seek
+    const auto totalLength = source->getTotalLength();
+
+    auto wrapPosition = [&] (int64 position)
+    {
+        return (source->isLooping() && totalLength > 0) ? position % totalLength : position;
+    };
+
+    const auto readPosition = wrapPosition (producerPosition);
+
+    if (readPosition != sourceReadPosition)
+        source->setNextReadPosition (readPosition);
+
+    AudioSourceChannelInfo info (&ring, start1 * chunkSize, chunkSize);
+    source->getNextAudioBlock (info);
+    sourceReadPosition = wrapPosition (readPosition + chunkSize);
+
+    const auto latencyMs = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks) * 1000.0;
+    lastReadLatencyMs = latencyMs;
+
+    for (auto previousMax = maxReadLatencyMs.load();
+         latencyMs > previousMax && ! maxReadLatencyMs.compare_exchange_weak (previousMax, latencyMs);)
+    {
+    }
+
+    auto& header = headers[start1];
+    header.generation = producerGeneration;
+    header.position = producerPosition;
+    header.numSamples = chunkSize;
+
+    producerPosition += chunkSize;
+    fifo.finishedWrite (1);
+    return true;
+}
+
+} // namespace juce
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class PrefetchingAudioSource;
+
+//==============================================================================
+/**
+    A pool of disk threads that keeps a set of PrefetchingAudioSource objects filled.
+
+    Rather than servicing its streams round-robin like a TimeSliceThread, each thread
+    always picks the registered stream that is closest to running out of data, so that
+    when there are many streams competing for the disk, the ones about to underrun are
+    served first. Several threads can be used, so that slow reads on one stream don't
+    hold up all the others.
+
+    The scheduler must not be deleted until all the PrefetchingAudioSource objects
+    using it have been deleted.
+
+    @see PrefetchingAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  AudioPrefetchScheduler
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler and starts its disk threads. */
+    explicit AudioPrefetchScheduler (int numDiskThreads = 2);
+
+    /** Destructor. */
+    ~AudioPrefetchScheduler();
+
+    /** Returns the number of disk threads in use. */
+    int getNumDiskThreads() const noexcept          { return threads.size(); }
+
+    /** Returns the number of streams currently registered. */
+    int getNumStreams() const;
+
+private:
+    //==============================================================================
+    friend class PrefetchingAudioSource;
+    class DiskThread;
+
+    void addStream (PrefetchingAudioSource*);
+    void removeStream (PrefetchingAudioSource*);
+    void wakeUp() noexcept;
+    bool serviceMostUrgentStream();
+
+    CriticalSection streamsLock;
+    Array<PrefetchingAudioSource*> streams;
+    OwnedArray<DiskThread> threads;
+    LightweightSemaphore workAvailable;
+    std::atomic<int> numPendingWakeUps { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPrefetchScheduler)
+};
+
+//==============================================================================
+/**
+    A PositionableAudioSource that reads ahead from another source using an
+    AudioPrefetchScheduler, and never locks on the audio thread.
+
+    This does the same job as BufferingAudioSource, but the read-ahead buffer is a
+    single-producer, single-consumer ring of fixed-size chunks managed by an AbstractFifo.
+    The disk thread fills whole chunks and publishes them, and the audio thread consumes
+    them, so the two sides never wait on each other.
+
+    Each chunk is tagged with the seek generation it was read for, so that data that was
+    in flight when setNextReadPosition() was called is simply skipped. If the audio thread
+    runs out of data, the missing samples are replaced with silence and the underrun is
+    counted in the statistics.
+
+    @see AudioPrefetchScheduler, BufferingAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  PrefetchingAudioSource  : public PositionableAudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a PrefetchingAudioSource.
+
+        @param source                       the input source to read from
+        @param scheduler                    the scheduler whose disk threads will read ahead
+        @param deleteSourceWhenDeleted      if true, then the input source object will
+                                            be deleted when this object is deleted
+        @param numberOfSamplesToBuffer      the size of the read-ahead buffer
+        @param numberOfChannels             the number of channels that will be played
+        @param prefillBufferOnPrepareToPlay if true, then calling prepareToPlay on this object will
+                                            block until the buffer has been partly filled
+    */
+    PrefetchingAudioSource (PositionableAudioSource* source,
+                            AudioPrefetchScheduler& scheduler,
+                            bool deleteSourceWhenDeleted,
+                            int numberOfSamplesToBuffer,
+                            int numberOfChannels = 2,
+                            bool prefillBufferOnPrepareToPlay = true);
+
+    /** Destructor. */
+    ~PrefetchingAudioSource() override;
+
+    //==============================================================================
+    /** Implementation of the AudioSource method. */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Implementation of the AudioSource method. */
+    void releaseResources() override;
+
+    /** Implementation of the AudioSource method. */
+    void getNextAudioBlock (const AudioSourceChannelInfo&) override;
+
+    //==============================================================================
+    /** Implements the PositionableAudioSource method.
+
+        This discards any data that has already been read ahead. If the audio thread is
+        in the middle of a callback, the call will wait for it to finish.
+    */
+    void setNextReadPosition (int64 newPosition) override;
+
+    /** Implements the PositionableAudioSource method. */
+    int64 getNextReadPosition() const override;
+
+    /** Implements the PositionableAudioSource method. */
+    int64 getTotalLength() const override       { return source->getTotalLength(); }
+
+    /** Implements the PositionableAudioSource method. */
+    bool isLooping() const override             { return source->isLooping(); }
+
+    //==============================================================================
+    /** A snapshot of the counters kept by a PrefetchingAudioSource. */
+    struct Statistics
+    {
+        int numUnderruns = 0;               /**< The number of callbacks that had to output some silence. */
+        int readAheadSamples = 0;           /**< The number of samples currently read ahead. */
+        int capacitySamples = 0;            /**< The size of the read-ahead buffer. */
+        double lastReadLatencyMs = 0.0;     /**< How long the most recent chunk took to read. */
+        double maxReadLatencyMs = 0.0;      /**< The longest time any chunk has taken to read. */
+    };
+
+    /** Returns the current statistics. This can be called from any thread. */
+    Statistics getStatistics() const noexcept;
+
+    /** Resets the underrun count and the maximum read latency. */
+    void resetStatistics() noexcept;
+
+private:
+    //==============================================================================
+    friend class AudioPrefetchScheduler;
+
+    struct ChunkHeader
+    {
+        uint32 generation = 0;
+        int64 position = 0;
+        int numSamples = 0;
+    };
+
+    enum { chunkSize = 512 };
+
+    double getSecondsUntilUnderrun() const noexcept;
+    bool needsData() const noexcept;
+    bool readNextChunk();
+    void discardAllChunks() noexcept;
+    int getReadAheadSamples() const noexcept;
+
+    //==============================================================================
+    OptionalScopedPointer<PositionableAudioSource> source;
+    AudioPrefetchScheduler& scheduler;
+    const int numberOfSamplesToBuffer, numberOfChannels;
+    const bool prefillBuffer;
+
+    AudioBuffer<float> ring;
+    HeapBlock<ChunkHeader> headers;
+    AbstractFifo fifo { 1 };
+
+    std::atomic<bool> consumerActive { false }, isPrepared { false }, isServicing { false };
+    std::atomic<uint32> generation { 0 };
+    std::atomic<int64> seekPosition { 0 }, nextPlayPos { 0 };
+    int readOffsetInChunk = 0;
+
+    uint32 producerGeneration = 0;
+    int64 producerPosition = 0, sourceReadPosition = -1;
+    double sampleRate = 44100.0;
+
+    std::atomic<int> numUnderruns { 0 };
+    std::atomic<double> lastReadLatencyMs { 0.0 }, maxReadLatencyMs { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PrefetchingAudioSource)
+};
+
+} // namespace juce
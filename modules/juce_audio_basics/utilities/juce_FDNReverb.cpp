@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+FDNReverb::FDNReverb()
+{
+    // Each output channel reads the lines through a different row of a Hadamard matrix
+    for (int row = 0; row < numLines; ++row)
+        for (int line = 0; line < numLines; ++line)
+            outputSigns[row][line] = (countNumberOfBits ((uint32) (row & line)) & 1) != 0 ? -1.0f : 1.0f;
+
+    setParameters (ReverbParameters());
+}
+
+FDNReverb::~FDNReverb() = default;
+
+//==============================================================================
+void FDNReverb::setParameters (const ReverbParameters& newParams)
+{
+    const float wetScaleFactor = 3.0f;
+    const float dryScaleFactor = 2.0f;
+
+    const float wet = newParams.wetLevel * wetScaleFactor;
+    dryGain.setTargetValue (newParams.dryLevel * dryScaleFactor);
+    wetGain1.setTargetValue (0.5f * wet * (1.0f + newParams.width));
+    wetGain2.setTargetValue (0.5f * wet * (1.0f - newParams.width));
+
+    if (isFrozen (newParams.freezeMode))
+    {
+        inputGain.setTargetValue (0.0f);
+        decayTime.setTargetValue (1000.0f);
+        damping.setTargetValue (0.0f);
+    }
+    else
+    {
+        // Maps the room size onto a decay time of between 0.2 and 8 seconds
+        inputGain.setTargetValue (0.35f);
+        decayTime.setTargetValue (0.2f + newParams.roomSize * newParams.roomSize * 7.8f);
+        damping.setTargetValue (newParams.damping * 0.7f);
+    }
+
+    parameters = newParams;
+}
+
+void FDNReverb::prepare (double sampleRate)
+{
+    jassert (sampleRate > 0);
+
+    // Mutually prime line lengths (at 44100Hz), spread between roughly 27ms and 67ms
+    static const short lineTunings[numLines] = { 1201, 1327, 1453, 1559, 1667, 1787, 1901, 2011,
+                                                 2129, 2243, 2357, 2473, 2591, 2713, 2833, 2963 };
+
+    currentSampleRate = sampleRate;
+    totalDelaySize = 0;
+
+    for (int line = 0; line < numLines; ++line)
+    {
+        lineLength[line] = jmax (1, (int) ((sampleRate * lineTunings[line]) / 44100.0));
+        lineOffset[line] = totalDelaySize;
+        totalDelaySize += lineLength[line];
+    }
+
+    delayData.malloc ((size_t) totalDelaySize);
+
+    const double smoothTime = 0.01;
+
+    for (auto* value : { &decayTime, &damping, &inputGain, &dryGain, &wetGain1, &wetGain2 })
+    {
+        value->reset (sampleRate, smoothTime);
+        value->setCurrentAndTargetValue (value->getTargetValue());
+    }
+
+    reset();
+}
+
+void FDNReverb::reset() noexcept
+{
+    if (totalDelaySize > 0)
+        FloatVectorOperations::clear (delayData, totalDelaySize);
+
+    for (int line = 0; line < numLines; ++line)
+    {
+        linePosition[line] = 0;
+        lowPassState[line] = 0.0f;
+    }
+}
+
+void FDNReverb::updateLineCoefficients (float decayValue, float dampingValue) noexcept
+{
+    // The gain for each line is chosen so that every line decays by 60dB in the same time
+    const auto samplesToDecay = (double) decayValue * currentSampleRate;
+
+    for (int line = 0; line < numLines; ++line)
+        lineGain[line] = isFrozen (parameters.freezeMode)
+                            ? 1.0f
+                            : (float) std::pow (10.0, -3.0 * lineLength[line] / samplesToDecay);
+
+    dampingCoefficient = dampingValue;
+}
+
+//==============================================================================
+void FDNReverb::process (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    jassert (isPrepared());
+    jassert (numChannels <= maxNumChannels);
+
+    numChannels = jmin (numChannels, (int) maxNumChannels);
+
+    if (! isPrepared() || numChannels <= 0)
+        return;
+
+    constexpr int subBlockSize = 32;
+    constexpr float householderScale = 2.0f / (float) numLines;
+    constexpr float outputScale = 0.25f; // 1 / sqrt (numLines)
+
+    const auto crossScale = numChannels > 1 ? 1.0f / (float) (numChannels - 1) : 0.0f;
+
+    alignas (16) float lineInput[numLines];
+    float wetOutput[maxNumChannels];
+
+    for (int start = 0; start < numSamples; start += subBlockSize)
+    {
+        const auto numThisTime = jmin (subBlockSize, numSamples - start);
+        updateLineCoefficients (decayTime.skip (numThisTime), damping.skip (numThisTime));
+
+        const auto damp = dampingCoefficient;
+
+        for (int i = start; i < start + numThisTime; ++i)
+        {
+            float sum = 0.0f;
+
+            for (int line = 0; line < numLines; ++line)
+            {
+                const auto delayed = delayData[lineOffset[line] + linePosition[line]];
+                auto filtered = delayed + damp * (lowPassState[line] - delayed);
+                JUCE_UNDENORMALISE (filtered);
+
+                lowPassState[line] = filtered;
+                lineOutput[line] = filtered;
+                sum += filtered;
+            }
+
+            sum *= householderScale;
+
+            const auto gainIn = inputGain.getNextValue();
+
+            if (numChannels <= numLines)
+            {
+                for (int line = 0; line < numLines; ++line)
+                    lineInput[line] = channels[line % numChannels][i];
+            }
+            else
+            {
+                std::fill (std::begin (lineInput), std::end (lineInput), 0.0f);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    lineInput[ch % numLines] += channels[ch][i];
+            }
+
+            for (int line = 0; line < numLines; ++line)
+            {
+                auto& position = linePosition[line];
+                delayData[lineOffset[line] + position] = (lineOutput[line] - sum) * lineGain[line] + lineInput[line] * gainIn;
+
+                if (++position >= lineLength[line])
+                    position = 0;
+            }
+
+            float totalWet = 0.0f;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* signs = outputSigns[1 + ch % (numLines - 1)];
+                float wet = 0.0f;
+
+                for (int line = 0; line < numLines; ++line)
+                    wet += signs[line] * lineOutput[line];
+
+                wetOutput[ch] = wet * outputScale;
+                totalWet += wetOutput[ch];
+            }
+
+            const auto dry  = dryGain.getNextValue();
+            const auto wet1 = wetGain1.getNextValue();
+            const auto wet2 = wetGain2.getNextValue();
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                channels[ch][i] = wetOutput[ch] * wet1
+                                   + (totalWet - wetOutput[ch]) * crossScale * wet2
+                                   + channels[ch][i] * dry;
+        }
+    }
+}
+
+void FDNReverb::process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    float* channels[maxNumChannels];
+    const auto numChannels = jmin (buffer.getNumChannels(), (int) maxNumChannels);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[ch] = buffer.getWritePointer (ch, startSample);
+
+    process (channels, numChannels, numSamples);
+}
+
+} // namespace juce
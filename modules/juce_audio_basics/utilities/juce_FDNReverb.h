@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/** Holds the parameters being used by a Reverb or FDNReverb object.
+
+    @see Reverb, FDNReverb
+
+    @tags{Audio}
+*/
+struct ReverbParameters
+{
+    float roomSize   = 0.5f;     /**< Room size, 0 to 1.0, where 1.0 is big, 0 is small. */
+    float damping    = 0.5f;     /**< Damping, 0 to 1.0, where 0 is not damped, 1.0 is fully damped. */
+    float wetLevel   = 0.33f;    /**< Wet level, 0 to 1.0 */
+    float dryLevel   = 0.4f;     /**< Dry level, 0 to 1.0 */
+    float width      = 1.0f;     /**< Reverb width, 0 to 1.0, where 1.0 is very wide. */
+    float freezeMode = 0.0f;     /**< Freeze mode - values < 0.5 are "normal" mode, values > 0.5
+                                      put the reverb into a continuous feedback loop. */
+};
+
+//==============================================================================
+/**
+    A feedback delay network reverb, for any number of channels.
+
+    The network has 16 delay lines with mutually prime lengths, each followed by a one-pole
+    damping filter, and mixed back into each other through a Householder matrix. All the
+    per-line state is kept in flat arrays of 16 values, so the loops over the lines can be
+    vectorised by the compiler.
+
+    Every input channel feeds a subset of the lines, and each output channel is taken from
+    all the lines through a different row of a Hadamard matrix, so the outputs are decorrelated
+    however many channels are processed. Parameter changes are smoothed, and the room size
+    and damping are applied every few samples rather than per sample.
+
+    This can be used on its own, or through Reverb by selecting Reverb::Algorithm::feedbackDelayNetwork.
+
+    @see Reverb
+
+    @tags{Audio}
+*/
+class JUCE_API  FDNReverb
+{
+public:
+    //==============================================================================
+    /** Creates a reverb. You must call prepare() before processing any audio. */
+    FDNReverb();
+
+    /** Destructor. */
+    ~FDNReverb();
+
+    //==============================================================================
+    /** Returns the reverb's current parameters. */
+    const ReverbParameters& getParameters() const noexcept    { return parameters; }
+
+    /** Applies a new set of parameters to the reverb.
+        The changes are smoothed, but this doesn't attempt to lock the reverb, so it must
+        be called on the same thread as the process methods.
+    */
+    void setParameters (const ReverbParameters& newParams);
+
+    /** Allocates the delay lines for the given sample rate. */
+    void prepare (double sampleRate);
+
+    /** Returns true if prepare() has been called. */
+    bool isPrepared() const noexcept                           { return totalDelaySize > 0; }
+
+    /** Clears the reverb's buffers. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Applies the reverb in place to a set of channels. */
+    void process (float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Applies the reverb in place to a region of an AudioBuffer. */
+    void process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+    //==============================================================================
+    /** The number of delay lines in the network. */
+    static constexpr int numLines = 16;
+
+    /** The highest number of channels that can be processed at once. */
+    static constexpr int maxNumChannels = 64;
+
+private:
+    //==============================================================================
+    void updateLineCoefficients (float decayValue, float dampingValue) noexcept;
+
+    static bool isFrozen (float freezeMode) noexcept           { return freezeMode >= 0.5f; }
+
+    ReverbParameters parameters;
+    double currentSampleRate = 44100.0;
+
+    HeapBlock<float> delayData;
+    int totalDelaySize = 0;
+    int lineLength[numLines] = {}, lineOffset[numLines] = {}, linePosition[numLines] = {};
+
+    alignas (16) float lineGain[numLines] = {};
+    alignas (16) float lowPassState[numLines] = {};
+    alignas (16) float lineOutput[numLines] = {};
+    alignas (16) float outputSigns[numLines][numLines] = {};
+    float dampingCoefficient = 0.0f;
+
+    SmoothedValue<float> decayTime, damping, inputGain, dryGain, wetGain1, wetGain2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FDNReverb)
+};
+
+} // namespace juce
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+IIRFilterBank::IIRFilterBank() noexcept = default;
+IIRFilterBank::~IIRFilterBank() = default;
+
+//==============================================================================
+void IIRFilterBank::prepare (int newNumLanes, int newNumSections, int smoothingLengthSamples, int maxPendingUpdates)
+{
+    jassert (newNumLanes > 0 && newNumSections > 0 && maxPendingUpdates > 0);
+
+    numLanes = jmax (1, newNumLanes);
+    numSections = jmax (1, newNumSections);
+    smoothingLength = jmax (0, smoothingLengthSamples);
+    smoothingRemaining = 0;
+
+    // Pad the lanes to a multiple of 4 so the inner loops always run over whole vectors
+    laneStride = (numLanes + 3) & ~3;
+
+    const auto numCoefficientValues = (size_t) (numCoefficients * numSections * laneStride);
+    current.calloc (numCoefficientValues);
+    target.calloc (numCoefficientValues);
+    delta.calloc (numCoefficientValues);
+    state.calloc ((size_t) (2 * numSections * laneStride));
+    laneData.calloc ((size_t) laneStride);
+    channelPointers.calloc ((size_t) numLanes);
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        FloatVectorOperations::fill (getCoefficients (current, 0, section), 1.0f, laneStride);
+        FloatVectorOperations::fill (getCoefficients (target, 0, section), 1.0f, laneStride);
+    }
+
+    pendingUpdates.clear();
+    pendingUpdates.resize ((size_t) maxPendingUpdates + 1);
+    updateFifo.setTotalSize (maxPendingUpdates + 1);
+    updateFifo.reset();
+
+    droppedUpdates = 0;
+    resetRequested = false;
+}
+
+//==============================================================================
+bool IIRFilterBank::pushUpdate (int lane, int section, const IIRCoefficients& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (section, numSections));
+
+    if (! isPositiveAndBelow (section, numSections))
+        return false;
+
+    const auto scope = updateFifo.write (1);
+
+    if (scope.blockSize1 == 0)
+    {
+        ++droppedUpdates;
+        return false;
+    }
+
+    auto& update = pendingUpdates[(size_t) scope.startIndex1];
+    update.lane = lane;
+    update.section = section;
+    update.coefficients = newCoefficients;
+    return true;
+}
+
+bool IIRFilterBank::setCoefficients (int lane, int section, const IIRCoefficients& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (lane, numLanes));
+
+    if (! isPositiveAndBelow (lane, numLanes))
+        return false;
+
+    return pushUpdate (lane, section, newCoefficients);
+}
+
+bool IIRFilterBank::setCoefficients (int section, const IIRCoefficients& newCoefficients) noexcept
+{
+    return pushUpdate (-1, section, newCoefficients);
+}
+
+bool IIRFilterBank::makeInactive (int lane, int section) noexcept
+{
+    return setCoefficients (lane, section, IIRCoefficients (1.0, 0.0, 0.0, 1.0, 0.0, 0.0));
+}
+
+void IIRFilterBank::reset() noexcept
+{
+    resetRequested = true;
+}
+
+//==============================================================================
+void IIRFilterBank::clearState() noexcept
+{
+    FloatVectorOperations::clear (state, 2 * numSections * laneStride);
+}
+
+void IIRFilterBank::applyPendingUpdates() noexcept
+{
+    const auto numReady = updateFifo.getNumReady();
+
+    if (numReady == 0)
+        return;
+
+    updateFifo.read (numReady).forEach ([this] (int index)
+    {
+        const auto& update = pendingUpdates[(size_t) index];
+        const auto firstLane = update.lane < 0 ? 0 : update.lane;
+        const auto lastLane = update.lane < 0 ? numLanes : update.lane + 1;
+
+        for (int c = 0; c < numCoefficients; ++c)
+        {
+            auto* dest = getCoefficients (target, c, update.section);
+
+            for (int lane = firstLane; lane < lastLane; ++lane)
+                dest[lane] = update.coefficients.coefficients[c];
+        }
+    });
+
+    const auto numValues = numCoefficients * numSections * laneStride;
+
+    if (smoothingLength == 0)
+    {
+        FloatVectorOperations::copy (current, target, numValues);
+        smoothingRemaining = 0;
+        return;
+    }
+
+    const auto scale = 1.0f / (float) smoothingLength;
+
+    for (int i = 0; i < numValues; ++i)
+        delta[i] = (target[i] - current[i]) * scale;
+
+    smoothingRemaining = smoothingLength;
+}
+
+void IIRFilterBank::process (float* const* channels, int numChannels, int numSamples) noexcept
+{
+    jassert (laneStride > 0);
+    jassert (numChannels <= numLanes);
+
+    if (resetRequested.exchange (false))
+        clearState();
+
+    applyPendingUpdates();
+
+    numChannels = jmin (numChannels, numLanes);
+
+    const auto numValues = numCoefficients * numSections * laneStride;
+    auto* lanes = laneData.get();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (smoothingRemaining > 0)
+        {
+            if (--smoothingRemaining == 0)
+                FloatVectorOperations::copy (current, target, numValues);
+            else
+                FloatVectorOperations::add (current, delta, numValues);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            lanes[ch] = channels[ch][i];
+
+        for (int ch = numChannels; ch < laneStride; ++ch)
+            lanes[ch] = 0.0f;
+
+        for (int section = 0; section < numSections; ++section)
+        {
+            const auto* c0 = getCoefficients (current, 0, section);
+            const auto* c1 = getCoefficients (current, 1, section);
+            const auto* c2 = getCoefficients (current, 2, section);
+            const auto* c3 = getCoefficients (current, 3, section);
+            const auto* c4 = getCoefficients (current, 4, section);
+            auto* v1 = state + (2 * section) * laneStride;
+            auto* v2 = v1 + laneStride;
+
+            for (int lane = 0; lane < laneStride; ++lane)
+            {
+                const auto in = lanes[lane];
+                const auto out = c0[lane] * in + v1[lane];
+
+                v1[lane] = c1[lane] * in - c3[lane] * out + v2[lane];
+                v2[lane] = c2[lane] * in - c4[lane] * out;
+                lanes[lane] = out;
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch][i] = lanes[ch];
+    }
+
+    for (int i = 0; i < 2 * numSections * laneStride; ++i)
+    {
+        JUCE_SNAP_TO_ZERO (state[i]);
+    }
+}
+
+void IIRFilterBank::process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    const auto numChannels = jmin (buffer.getNumChannels(), numLanes);
+    auto* const* channels = buffer.getArrayOfWritePointers();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        channelPointers[ch] = channels[ch] + startSample;
+
+    process (channelPointers, numChannels, numSamples);
+}
+
+} // namespace juce
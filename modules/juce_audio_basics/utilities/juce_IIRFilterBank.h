@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A bank of biquad filters that processes many channels side by side.
+
+    Each lane of the bank is one channel of audio, and each lane runs a cascade of
+    numSections biquads using the same transposed direct-form II structure as IIRFilter.
+    Coefficients and filter state are stored as structure-of-arrays, so that the inner
+    loop runs over lanes and can be vectorised by the compiler, instead of running one
+    channel at a time like a set of separate IIRFilter objects would.
+
+    The audio thread never takes a lock: setCoefficients() pushes the new values into a
+    lock-free FIFO, which is drained at the start of the next process() call. When a
+    smoothing length is set, the coefficients are then ramped linearly to their new
+    values over that many samples, which avoids zipper noise when sweeping an EQ.
+
+    Only one thread at a time should call setCoefficients() or makeInactive(), and only
+    one thread (normally the audio thread) should call process().
+
+    @see IIRFilter, IIRCoefficients
+
+    @tags{Audio}
+*/
+class JUCE_API  IIRFilterBank
+{
+public:
+    //==============================================================================
+    /** Creates an empty filter bank. Call prepare() before using it. */
+    IIRFilterBank() noexcept;
+
+    /** Destructor. */
+    ~IIRFilterBank();
+
+    //==============================================================================
+    /** Allocates the storage for the bank.
+
+        All sections start out inactive (passing audio through unchanged). This method
+        allocates memory, so it must not be called while process() may be running.
+
+        @param numLanes                 the number of channels that will be processed
+        @param numSections              the number of biquads cascaded in each lane
+        @param smoothingLengthSamples   the number of samples over which coefficient
+                                        changes are ramped, or 0 to apply them instantly
+        @param maxPendingUpdates        how many coefficient changes can be queued between
+                                        two calls to process()
+    */
+    void prepare (int numLanes,
+                  int numSections = 1,
+                  int smoothingLengthSamples = 0,
+                  int maxPendingUpdates = 512);
+
+    /** Returns the number of lanes (channels) the bank was prepared for. */
+    int getNumLanes() const noexcept                    { return numLanes; }
+
+    /** Returns the number of cascaded sections in each lane. */
+    int getNumSections() const noexcept                 { return numSections; }
+
+    //==============================================================================
+    /** Queues a new set of coefficients for one section of one lane.
+
+        This is lock-free and doesn't allocate. It returns false if the update queue
+        is full, in which case the change is dropped and counted in getNumDroppedUpdates(),
+        or if the lane or section is out of range, in which case nothing is queued.
+    */
+    bool setCoefficients (int lane, int section, const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Queues a new set of coefficients for one section of every lane. */
+    bool setCoefficients (int section, const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Turns one section of one lane into a pass-through. */
+    bool makeInactive (int lane, int section) noexcept;
+
+    /** Returns the number of coefficient updates that were dropped because the queue was full. */
+    int getNumDroppedUpdates() const noexcept           { return droppedUpdates.load(); }
+
+    //==============================================================================
+    /** Clears the processing state of all the filters.
+
+        This can be called from any thread: the state is cleared by the audio thread at
+        the start of the next process() call.
+    */
+    void reset() noexcept;
+
+    /** Filters a set of channels in place.
+
+        Channel i is processed by lane i. If fewer channels than lanes are passed in,
+        the remaining lanes are fed with silence.
+    */
+    void process (float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /** Filters a region of an AudioBuffer in place. */
+    void process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct PendingUpdate
+    {
+        int lane = 0, section = 0;
+        IIRCoefficients coefficients;
+    };
+
+    enum { numCoefficients = 5 };
+
+    bool pushUpdate (int lane, int section, const IIRCoefficients&) noexcept;
+    void applyPendingUpdates() noexcept;
+    void clearState() noexcept;
+
+    float* getCoefficients (HeapBlock<float>& block, int index, int section) const noexcept
+    {
+        return block + (index * numSections + section) * laneStride;
+    }
+
+    int numLanes = 0, numSections = 0, laneStride = 0;
+    int smoothingLength = 0, smoothingRemaining = 0;
+
+    HeapBlock<float> current, target, delta, state, laneData;
+    HeapBlock<float*> channelPointers;
+
+    std::vector<PendingUpdate> pendingUpdates;
+    AbstractFifo updateFifo { 1 };
+    std::atomic<int> droppedUpdates { 0 };
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterBank)
+};
+
+} // namespace juce
@@ -48,7 +48,10 @@ namespace juce
     Use setSampleRate() to prepare it, and then call processStereo() or processMono() to
     apply the reverb to your audio data.
 
-    @see ReverbAudioSource
+    It can also be switched over to use an FDNReverb with setAlgorithm(), in which case
+    processChannels() can be used to process any number of channels.
+
+    @see ReverbAudioSource, FDNReverb
 
     @tags{Audio}
 */
@@ -64,15 +67,13 @@ public:
 
     //==============================================================================
     /** Holds the parameters being used by a Reverb object. */
-    struct Parameters
+    using Parameters = ReverbParameters;
+
+    /** The algorithms that a Reverb can use. */
+    enum class Algorithm
     {
-        float roomSize   = 0.5f;     /**< Room size, 0 to 1.0, where 1.0 is big, 0 is small. */
-        float damping    = 0.5f;     /**< Damping, 0 to 1.0, where 0 is not damped, 1.0 is fully damped. */
-        float wetLevel   = 0.33f;    /**< Wet level, 0 to 1.0 */
-        float dryLevel   = 0.4f;     /**< Dry level, 0 to 1.0 */
-        float width      = 1.0f;     /**< Reverb width, 0 to 1.0, where 1.0 is very wide. */
-        float freezeMode = 0.0f;     /**< Freeze mode - values < 0.5 are "normal" mode, values > 0.5
-                                          put the reverb into a continuous feedback loop. */
+        freeverb,               /**< The classic stereo FreeVerb tunings. */
+        feedbackDelayNetwork    /**< An FDNReverb, which works for any number of channels. */
     };
 
     //==============================================================================
@@ -96,8 +97,26 @@ public:
         gain = isFrozen (newParams.freezeMode) ? 0.0f : 0.015f;
         parameters = newParams;
         updateDamping();
+
+        fdn.setParameters (newParams);
     }
 
+    //==============================================================================
+    /** Selects the algorithm used by the process methods.
+        The feedback delay network's buffers are only allocated when it's first selected, so
+        this may allocate memory, and must not be called in parallel with the process methods.
+    */
+    void setAlgorithm (Algorithm newAlgorithm)
+    {
+        algorithm = newAlgorithm;
+
+        if (algorithm == Algorithm::feedbackDelayNetwork && ! fdn.isPrepared())
+            fdn.prepare (currentSampleRate);
+    }
+
+    /** Returns the algorithm that is currently being used. */
+    Algorithm getAlgorithm() const noexcept             { return algorithm; }
+
     //==============================================================================
     /** Sets the sample rate that will be used for the reverb.
         You must call this before the process methods, in order to tell it the correct sample rate.
@@ -111,6 +130,11 @@ public:
         const int stereoSpread = 23;
         const int intSampleRate = (int) sampleRate;
 
+        currentSampleRate = sampleRate;
+
+        if (algorithm == Algorithm::feedbackDelayNetwork)
+            fdn.prepare (sampleRate);
+
         for (int i = 0; i < numCombs; ++i)
         {
             comb[0][i].setSize ((intSampleRate * combTunings[i]) / 44100);
@@ -142,6 +166,8 @@ public:
             for (int i = 0; i < numAllPasses; ++i)
                 allPass[j][i].clear();
         }
+
+        fdn.reset();
     }
 
     //==============================================================================
@@ -151,6 +177,13 @@ public:
         JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
         jassert (left != nullptr && right != nullptr);
 
+        if (algorithm == Algorithm::feedbackDelayNetwork)
+        {
+            float* channels[] = { left, right };
+            fdn.process (channels, 2, numSamples);
+            return;
+        }
+
         for (int i = 0; i < numSamples; ++i)
         {
             // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
@@ -188,6 +221,13 @@ public:
         JUCE_BEGIN_IGNORE_WARNINGS_MSVC (6011)
         jassert (samples != nullptr);
 
+        if (algorithm == Algorithm::feedbackDelayNetwork)
+        {
+            float* channels[] = { samples };
+            fdn.process (channels, 1, numSamples);
+            return;
+        }
+
         for (int i = 0; i < numSamples; ++i)
         {
             const float input = samples[i] * gain;
@@ -210,6 +250,21 @@ public:
         JUCE_END_IGNORE_WARNINGS_MSVC
     }
 
+    /** Applies the reverb to any number of channels of audio data.
+
+        With the FreeVerb algorithm only one or two channels are supported, and any others
+        are left untouched. The feedback delay network handles up to FDNReverb::maxNumChannels.
+    */
+    void processChannels (float* const* channels, const int numChannelsToProcess, const int numSamples) noexcept
+    {
+        if (algorithm == Algorithm::feedbackDelayNetwork)
+            fdn.process (channels, numChannelsToProcess, numSamples);
+        else if (numChannelsToProcess == 1)
+            processMono (channels[0], numSamples);
+        else if (numChannelsToProcess > 1)
+            processStereo (channels[0], channels[1], numSamples);
+    }
+
 private:
     //==============================================================================
     static bool isFrozen (const float freezeMode) noexcept  { return freezeMode >= 0.5f; }
@@ -329,6 +384,10 @@ private:
 
     SmoothedValue<float> damping, feedback, dryGain, wetGain1, wetGain2;
 
+    FDNReverb fdn;
+    Algorithm algorithm = Algorithm::freeverb;
+    double currentSampleRate = 44100.0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Reverb)
 };
 
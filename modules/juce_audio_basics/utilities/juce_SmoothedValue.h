@@ -107,8 +107,14 @@ public:
 
         if (isSmoothing())
         {
-            for (int i = 0; i < numSamples; ++i)
-                samples[i] *= getNextSmoothedValue();
+            FloatType gains[rampBlockSize];
+
+            for (int start = 0; start < numSamples; start += rampBlockSize)
+            {
+                const auto numThisTime = jmin ((int) rampBlockSize, numSamples - start);
+                getNextSmoothedValues (gains, numThisTime);
+                FloatVectorOperations::multiply (samples + start, gains, numThisTime);
+            }
         }
         else
         {
@@ -128,8 +134,14 @@ public:
 
         if (isSmoothing())
         {
-            for (int i = 0; i < numSamples; ++i)
-                samplesOut[i] = samplesIn[i] * getNextSmoothedValue();
+            FloatType gains[rampBlockSize];
+
+            for (int start = 0; start < numSamples; start += rampBlockSize)
+            {
+                const auto numThisTime = jmin ((int) rampBlockSize, numSamples - start);
+                getNextSmoothedValues (gains, numThisTime);
+                FloatVectorOperations::multiply (samplesOut + start, samplesIn + start, gains, numThisTime);
+            }
         }
         else
         {
@@ -144,22 +156,15 @@ public:
 
         if (isSmoothing())
         {
-            if (buffer.getNumChannels() == 1)
-            {
-                auto* samples = buffer.getWritePointer (0);
+            FloatType gains[rampBlockSize];
 
-                for (int i = 0; i < numSamples; ++i)
-                    samples[i] *= getNextSmoothedValue();
-            }
-            else
+            for (int start = 0; start < numSamples; start += rampBlockSize)
             {
-                for (auto i = 0; i < numSamples; ++i)
-                {
-                    auto gain = getNextSmoothedValue();
+                const auto numThisTime = jmin ((int) rampBlockSize, numSamples - start);
+                getNextSmoothedValues (gains, numThisTime);
 
-                    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
-                        buffer.setSample (channel, i, buffer.getSample (channel, i) * gain);
-                }
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    FloatVectorOperations::multiply (buffer.getWritePointer (channel, start), gains, numThisTime);
             }
         }
         else
@@ -170,9 +175,12 @@ public:
 
 private:
     //==============================================================================
-    FloatType getNextSmoothedValue() noexcept
+    // The gain ramps are computed into a stack buffer of this many samples at a time
+    enum { rampBlockSize = 64 };
+
+    void getNextSmoothedValues (FloatType* destination, int numSamples) noexcept
     {
-        return static_cast <SmoothedValueType*> (this)->getNextValue();
+        static_cast <SmoothedValueType*> (this)->getNextValues (destination, numSamples);
     }
 
 protected:
@@ -209,6 +217,72 @@ namespace ValueSmoothingTypes
     struct Multiplicative {};
 }
 
+#ifndef DOXYGEN
+namespace detail
+{
+    /*  Writes the next numSamples values of a smoothing ramp into a buffer, and advances the
+        ramp's state, giving the same values as stepping it one sample at a time.
+
+        Each value is computed from the start of the block rather than from the previous value,
+        so that the loop has no dependency between neighbouring samples and can be vectorised.
+    */
+    template <typename FloatType, typename SmoothingType>
+    void fillSmoothingRamp (FloatType* destination, int numSamples,
+                            FloatType& currentValue, FloatType target,
+                            FloatType step, int& countdown) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        const auto numRamping = jmin (numSamples, countdown);
+
+        if (numRamping > 0)
+        {
+            const auto start = currentValue;
+
+            if constexpr (std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear>)
+            {
+                for (int i = 0; i < numRamping; ++i)
+                    destination[i] = start + step * (FloatType) (i + 1);
+            }
+            else
+            {
+                // The first few values are stepped one at a time, and then every later value is
+                // derived from the one a whole group earlier
+                constexpr int groupSize = 8;
+                const auto numInFirstGroup = jmin (numRamping, groupSize);
+                auto value = start;
+
+                for (int i = 0; i < numInFirstGroup; ++i)
+                    destination[i] = (value *= step);
+
+                if (numRamping > groupSize)
+                {
+                    const auto groupStep = (FloatType) std::pow (step, groupSize);
+
+                    for (int i = groupSize; i < numRamping; ++i)
+                        destination[i] = destination[i - groupSize] * groupStep;
+                }
+            }
+
+            countdown -= numRamping;
+
+            if (countdown > 0)
+            {
+                currentValue = destination[numRamping - 1];
+            }
+            else
+            {
+                destination[numRamping - 1] = target;
+                currentValue = target;
+            }
+        }
+
+        if (numRamping < numSamples)
+            FloatVectorOperations::fill (destination + numRamping, target, numSamples - numRamping);
+    }
+} // namespace detail
+#endif
+
 //==============================================================================
 /**
     A utility class for values that need smoothing to avoid audio glitches.
@@ -326,6 +400,23 @@ public:
         return this->currentValue;
     }
 
+    /** Writes the next numSamples values into a buffer.
+
+        This gives the same result as calling getNextValue() numSamples times, but the
+        ramp is computed a block at a time in a way that the compiler can vectorise, so
+        it's much cheaper when you need a per-sample value for a whole block.
+
+        @param destination  the buffer to fill
+        @param numSamples   the number of values to write
+        @see getNextValue, skip
+    */
+    void getNextValues (FloatType* destination, int numSamples) noexcept
+    {
+        detail::fillSmoothingRamp<FloatType, SmoothingType> (destination, numSamples,
+                                                             this->currentValue, this->target,
+                                                             step, this->countdown);
+    }
+
     //==============================================================================
     /** Skip the next numSamples samples.
         This is identical to calling getNextValue numSamples times. It returns
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A set of smoothed values that are all updated together.
+
+    This behaves like an array of SmoothedValue objects, but the current values, targets,
+    step sizes and countdowns are each stored in their own contiguous array, so advancing
+    every value by a block of samples is a single loop that the compiler can vectorise.
+    That makes it suitable for plug-ins with lots of automatable parameters, where most of
+    the values only need updating once per block.
+
+    A typical process callback calls fillRamp() for the few values that need a per-sample
+    ramp, reads the others with getCurrentValue() (or getCurrentValues()), and then calls
+    skip() once to advance all of them to the end of the block.
+
+    Like SmoothedValue, this class isn't thread-safe: the targets should be set on the
+    same thread that advances the values.
+
+    @see SmoothedValue
+
+    @tags{Audio}
+*/
+template <typename FloatType, typename SmoothingType = ValueSmoothingTypes::Linear>
+class SmoothedValueBank
+{
+public:
+    //==============================================================================
+    /** Creates an empty bank. */
+    SmoothedValueBank() = default;
+
+    /** Creates a bank holding a number of values. */
+    explicit SmoothedValueBank (int initialNumValues) noexcept
+    {
+        setSize (initialNumValues);
+    }
+
+    //==============================================================================
+    /** Changes the number of values in the bank.
+
+        All the values are set to initialValue and stop smoothing. This allocates memory, so
+        shouldn't be called on the audio thread.
+    */
+    void setSize (int newNumValues,
+                  FloatType initialValue = (FloatType) (std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear> ? 0 : 1))
+    {
+        jassert (newNumValues >= 0);
+
+        // Multiplicative smoothed values cannot ever reach 0!
+        jassert (! (std::is_same_v<SmoothingType, ValueSmoothingTypes::Multiplicative>
+                    && approximatelyEqual (initialValue, (FloatType) 0)));
+
+        numValues = jmax (0, newNumValues);
+        current.malloc ((size_t) numValues);
+        target.malloc ((size_t) numValues);
+        step.calloc ((size_t) numValues);
+        countdown.calloc ((size_t) numValues);
+
+        for (int i = 0; i < numValues; ++i)
+            current[i] = target[i] = initialValue;
+    }
+
+    /** Returns the number of values in the bank. */
+    int size() const noexcept                                   { return numValues; }
+
+    //==============================================================================
+    /** Sets a new sample rate and ramp length for all the values.
+        Any values that are currently smoothing jump to their targets.
+    */
+    void reset (double sampleRate, double rampLengthInSeconds) noexcept
+    {
+        jassert (sampleRate > 0 && rampLengthInSeconds >= 0);
+        reset ((int) std::floor (rampLengthInSeconds * sampleRate));
+    }
+
+    /** Sets the ramp length for all the values directly in samples.
+        Any values that are currently smoothing jump to their targets.
+    */
+    void reset (int numSteps) noexcept
+    {
+        stepsToTarget = numSteps;
+
+        for (int i = 0; i < numValues; ++i)
+            setCurrentAndTargetValue (i, target[i]);
+    }
+
+    //==============================================================================
+    /** Sets the value that one of the entries should ramp towards. */
+    void setTargetValue (int index, FloatType newValue) noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues));
+
+        if (approximatelyEqual (newValue, target[index]))
+            return;
+
+        if (stepsToTarget <= 0)
+        {
+            setCurrentAndTargetValue (index, newValue);
+            return;
+        }
+
+        // Multiplicative smoothed values cannot ever reach 0!
+        jassert (! (std::is_same_v<SmoothingType, ValueSmoothingTypes::Multiplicative>
+                    && approximatelyEqual (newValue, (FloatType) 0)));
+
+        target[index] = newValue;
+        countdown[index] = stepsToTarget;
+
+        if constexpr (std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear>)
+            step[index] = (newValue - current[index]) / (FloatType) stepsToTarget;
+        else
+            step[index] = std::exp ((std::log (std::abs (newValue)) - std::log (std::abs (current[index]))) / (FloatType) stepsToTarget);
+    }
+
+    /** Sets both the current value and the target of one of the entries. */
+    void setCurrentAndTargetValue (int index, FloatType newValue) noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues));
+
+        current[index] = target[index] = newValue;
+        countdown[index] = 0;
+    }
+
+    //==============================================================================
+    /** Returns the current value of one of the entries. */
+    FloatType getCurrentValue (int index) const noexcept       { jassert (isPositiveAndBelow (index, numValues)); return current[index]; }
+
+    /** Returns the target of one of the entries. */
+    FloatType getTargetValue (int index) const noexcept        { jassert (isPositiveAndBelow (index, numValues)); return target[index]; }
+
+    /** Returns the array of current values, which has size() elements. */
+    const FloatType* getCurrentValues() const noexcept          { return current; }
+
+    /** Returns true if one of the entries is being smoothed. */
+    bool isSmoothing (int index) const noexcept                 { jassert (isPositiveAndBelow (index, numValues)); return countdown[index] > 0; }
+
+    /** Returns true if any of the entries is being smoothed. */
+    bool isAnySmoothing() const noexcept
+    {
+        int numSmoothing = 0;
+
+        for (int i = 0; i < numValues; ++i)
+            numSmoothing += countdown[i] > 0 ? 1 : 0;
+
+        return numSmoothing > 0;
+    }
+
+    //==============================================================================
+    /** Writes the next numSamples values of one entry into a buffer, without advancing it.
+
+        The values are the same as a SmoothedValue would return from getNextValue(). Call
+        skip() afterwards to move the whole bank on to the end of the block.
+    */
+    void fillRamp (int index, FloatType* destination, int numSamples) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, numValues));
+
+        auto value = current[index];
+        auto remaining = countdown[index];
+
+        detail::fillSmoothingRamp<FloatType, SmoothingType> (destination, numSamples, value,
+                                                             target[index], step[index], remaining);
+    }
+
+    /** Advances every entry in the bank by numSamples samples.
+
+        This is identical to calling skip (numSamples) on a set of SmoothedValue objects.
+    */
+    void skip (int numSamples) noexcept
+    {
+        jassert (numSamples >= 0);
+
+        if constexpr (std::is_same_v<SmoothingType, ValueSmoothingTypes::Linear>)
+        {
+            // No branches here, so that the whole bank is updated with vector instructions
+            for (int i = 0; i < numValues; ++i)
+            {
+                const auto numSteps = jmin (countdown[i], numSamples);
+                countdown[i] -= numSteps;
+
+                const auto advanced = current[i] + step[i] * (FloatType) numSteps;
+                current[i] = countdown[i] > 0 ? advanced : target[i];
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numValues; ++i)
+            {
+                if (countdown[i] == 0)
+                    continue;
+
+                const auto numSteps = jmin (countdown[i], numSamples);
+                countdown[i] -= numSteps;
+
+                current[i] = countdown[i] > 0 ? current[i] * (FloatType) std::pow (step[i], numSteps)
+                                              : target[i];
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    HeapBlock<FloatType> current, target, step;
+    HeapBlock<int> countdown;
+    int numValues = 0, stepsToTarget = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SmoothedValueBank)
+};
+
+} // namespace juce
@@ -265,6 +265,11 @@ void AudioDeviceManager::createAudioDeviceTypes (OwnedArray<AudioIODeviceType>&
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_Oboe());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_OpenSLES());
     addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_Android());
+
+   #if JUCE_NULL_AUDIO_DEVICES
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_Null());
+    addIfNotNull (list, AudioIODeviceType::createAudioIODeviceType_Offline());
+   #endif
 }
 
 void AudioDeviceManager::addAudioDeviceType (std::unique_ptr<AudioIODeviceType> newDeviceType)
@@ -1024,6 +1029,8 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float* const* inputChan
 
         tempBuffer.setSize (jmax (1, numOutputChannels), jmax (1, numSamples), false, false, true);
 
+        const ScopedAllocationTripwire allocationTripwire;
+
         callbacks.getUnchecked (0)->audioDeviceIOCallbackWithContext (inputChannelData,
                                                                       numInputChannels,
                                                                       outputChannelData,
@@ -1086,6 +1093,10 @@ void AudioDeviceManager::audioDeviceAboutToStartInt (AudioIODevice* const device
     {
         const ScopedLock sl (audioCallbackLock);
 
+        tempBuffer.setSize (jmax (1, device->getActiveOutputChannels().countNumberOfSetBits()),
+                            jmax (1, device->getCurrentBufferSizeSamples()),
+                            false, false, true);
+
         for (int i = callbacks.size(); --i >= 0;)
             callbacks.getUnchecked (i)->audioDeviceAboutToStart (device);
     }
@@ -53,6 +53,12 @@ struct AudioIODeviceCallbackContext
         an integer holding the current value; otherwise, this will be nullptr.
     */
     const uint64_t* hostTimeNs = nullptr;
+
+    /** If the device follows a transport (e.g. JACK's), this will point to a play head
+        that can be queried for the position during the callback; otherwise, this will
+        be nullptr.
+    */
+    AudioPlayHead* playHead = nullptr;
 };
 
 //==============================================================================
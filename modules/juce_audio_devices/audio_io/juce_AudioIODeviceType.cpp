@@ -123,6 +123,9 @@ void AudioIODeviceType::callDeviceChangeListeners()
  AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_Bela()         { return nullptr; }
 #endif
 
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_Null()       { return new NullAudioIODeviceType ("Null", NullAudioIODevice::Timing::realtime); }
+AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_Offline()    { return new NullAudioIODeviceType ("Offline", NullAudioIODevice::Timing::asFastAsPossible); }
+
 #if JUCE_ANDROID
  AudioIODeviceType* AudioIODeviceType::createAudioIODeviceType_Android()
  {
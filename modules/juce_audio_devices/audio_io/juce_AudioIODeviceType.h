@@ -183,6 +183,10 @@ public:
     static AudioIODeviceType* createAudioIODeviceType_Oboe();
     /** Creates a Bela device type if it's available on this platform, or returns null. */
     static AudioIODeviceType* createAudioIODeviceType_Bela();
+    /** Creates a device type with a single NullAudioIODevice, which makes its callbacks in realtime without any hardware. */
+    static AudioIODeviceType* createAudioIODeviceType_Null();
+    /** Creates a device type with a single NullAudioIODevice, which makes its callbacks as fast as possible. */
+    static AudioIODeviceType* createAudioIODeviceType_Offline();
 
    #ifndef DOXYGEN
     [[deprecated ("You should call the method which takes a WASAPIDeviceMode instead.")]]
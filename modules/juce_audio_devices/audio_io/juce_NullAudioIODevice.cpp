@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+NullAudioIODevice::NullAudioIODevice (const String& deviceName,
+                                      const String& deviceTypeName,
+                                      Timing timingToUse,
+                                      int numInputChannels,
+                                      int numOutputChannels)
+    : AudioIODevice (deviceName, deviceTypeName),
+      Thread ("JUCE " + deviceTypeName + " Audio"),
+      timing (timingToUse),
+      numInputs (jmax (0, numInputChannels)),
+      numOutputs (jmax (0, numOutputChannels))
+{
+}
+
+NullAudioIODevice::~NullAudioIODevice()
+{
+    close();
+}
+
+//==============================================================================
+void NullAudioIODevice::setOutputStream (OutputStream* streamToWriteTo, bool deleteStreamWhenFinished)
+{
+    const ScopedLock sl (callbackLock);
+
+    if (outputStream != nullptr)
+        outputStream->flush();
+
+    outputStream.set (streamToWriteTo, deleteStreamWhenFinished);
+}
+
+void NullAudioIODevice::setLengthToRender (int64 numSamples)
+{
+    {
+        const ScopedLock sl (lengthLock);
+        lengthToRender = numSamples;
+
+        if (numSamples < 0 || numSamplesRendered.load() < numSamples)
+            finishedEvent.reset();
+        else
+            finishedEvent.signal();
+    }
+
+    notify();
+}
+
+bool NullAudioIODevice::waitUntilFinished (int timeoutMilliseconds)
+{
+    return finishedEvent.wait ((double) timeoutMilliseconds);
+}
+
+//==============================================================================
+StringArray NullAudioIODevice::getOutputChannelNames()
+{
+    StringArray names;
+
+    for (int i = 0; i < numOutputs; ++i)
+        names.add ("Output " + String (i + 1));
+
+    return names;
+}
+
+StringArray NullAudioIODevice::getInputChannelNames()
+{
+    StringArray names;
+
+    for (int i = 0; i < numInputs; ++i)
+        names.add ("Input " + String (i + 1));
+
+    return names;
+}
+
+Array<double> NullAudioIODevice::getAvailableSampleRates()
+{
+    return { 22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+}
+
+Array<int> NullAudioIODevice::getAvailableBufferSizes()
+{
+    return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+}
+
+//==============================================================================
+String NullAudioIODevice::open (const BigInteger& inputChannels,
+                                const BigInteger& outputChannels,
+                                double sampleRate,
+                                int bufferSizeSamples)
+{
+    close();
+
+    currentSampleRate = sampleRate > 0 ? sampleRate : 44100.0;
+    currentBufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : getDefaultBufferSize();
+
+    activeInputChannels = inputChannels;
+    activeInputChannels.setRange (numInputs, jmax (0, activeInputChannels.getHighestBit() + 1 - numInputs), false);
+    activeOutputChannels = outputChannels;
+    activeOutputChannels.setRange (numOutputs, jmax (0, activeOutputChannels.getHighestBit() + 1 - numOutputs), false);
+
+    const auto numActiveInputs = activeInputChannels.countNumberOfSetBits();
+    const auto numActiveOutputs = activeOutputChannels.countNumberOfSetBits();
+
+    inputBuffer.setSize (jmax (1, numActiveInputs), currentBufferSize);
+    inputBuffer.clear();
+    outputBuffer.setSize (jmax (1, numActiveOutputs), currentBufferSize);
+    interleavedOutput.malloc ((size_t) (jmax (1, numActiveOutputs) * currentBufferSize));
+
+    inputChannelData.clearQuick();
+    outputChannelData.clearQuick();
+    outputReadPointers.clearQuick();
+
+    for (int i = 0; i < numActiveInputs; ++i)
+        inputChannelData.add (inputBuffer.getReadPointer (i));
+
+    for (int i = 0; i < numActiveOutputs; ++i)
+        outputChannelData.add (outputBuffer.getWritePointer (i));
+
+    outputReadPointers.addArray (outputChannelData);
+
+    deviceIsOpen = true;
+    return {};
+}
+
+void NullAudioIODevice::close()
+{
+    stop();
+    deviceIsOpen = false;
+}
+
+void NullAudioIODevice::start (AudioIODeviceCallback* newCallback)
+{
+    if (! deviceIsOpen || newCallback == nullptr)
+        return;
+
+    if (callback == newCallback)
+        return;
+
+    stop();
+
+    newCallback->audioDeviceAboutToStart (this);
+
+    {
+        const ScopedLock sl (callbackLock);
+        callback = newCallback;
+        numSamplesPending = 0;
+    }
+
+    numSamplesRendered = 0;
+    setLengthToRender (lengthToRender.load());
+    isStarted = true;
+
+    startThread (timing == Timing::realtime ? Priority::high : Priority::normal);
+}
+
+void NullAudioIODevice::stop()
+{
+    if (! isStarted)
+        return;
+
+    stopThread (4000);
+    isStarted = false;
+
+    AudioIODeviceCallback* lastCallback = nullptr;
+
+    {
+        const ScopedLock sl (callbackLock);
+        std::swap (lastCallback, callback);
+    }
+
+    if (lastCallback != nullptr)
+        lastCallback->audioDeviceStopped();
+
+    const ScopedLock sl (callbackLock);
+
+    if (outputStream != nullptr)
+        outputStream->flush();
+}
+
+//==============================================================================
+void NullAudioIODevice::run()
+{
+    const auto ticksPerSecond = Time::getHighResolutionTicksPerSecond();
+    const auto ticksPerBlock = (int64) ((double) ticksPerSecond * currentBufferSize / currentSampleRate);
+    auto nextBlockTime = Time::getHighResolutionTicks();
+
+    while (! threadShouldExit())
+    {
+        const auto length = lengthToRender.load();
+
+        if (length >= 0 && numSamplesRendered.load() >= length)
+        {
+            {
+                // (the length may have been raised again since it was read)
+                const ScopedLock sl (lengthLock);
+
+                if (lengthToRender.load() == length)
+                    finishedEvent.signal();
+            }
+
+            wait (-1);
+            nextBlockTime = Time::getHighResolutionTicks();
+            continue;
+        }
+
+        if (timing == Timing::realtime)
+        {
+            for (;;)
+            {
+                const auto ticksToWait = nextBlockTime - Time::getHighResolutionTicks();
+
+                if (ticksToWait <= 0 || threadShouldExit())
+                    break;
+
+                const auto msToWait = 1000.0 * (double) ticksToWait / (double) ticksPerSecond;
+
+                if (msToWait > 2.0)
+                    wait ((int) msToWait - 1);
+                else
+                    Thread::yield();
+            }
+
+            if (threadShouldExit())
+                break;
+
+            const auto now = Time::getHighResolutionTicks();
+
+            // If a callback took so long that a whole block has been missed, a real device
+            // would have glitched, so count it as an xrun and start the clock again from now
+            if (now - nextBlockTime > ticksPerBlock)
+            {
+                ++xrunCount;
+                nextBlockTime = now;
+            }
+
+            nextBlockTime += ticksPerBlock;
+
+            renderBlock ((uint64_t) (Time::highResolutionTicksToSeconds (now) * 1.0e9));
+        }
+        else
+        {
+            renderBlock ((uint64_t) ((double) numSamplesRendered.load() * 1.0e9 / currentSampleRate));
+        }
+    }
+}
+
+void NullAudioIODevice::renderBlock (uint64_t hostTimeNs)
+{
+    auto numSamples = currentBufferSize;
+    const auto length = lengthToRender.load();
+
+    if (length >= 0)
+        numSamples = (int) jlimit ((int64) 0, (int64) numSamples, length - numSamplesRendered.load());
+
+    const ScopedLock sl (callbackLock);
+
+    // When the end of the length to render falls part-way through a block, the rest of the
+    // block stays pending in the output buffer, and is written before the next callback is made
+    for (int numDone = 0; numDone < numSamples;)
+    {
+        if (numSamplesPending == 0)
+        {
+            if (callback != nullptr)
+            {
+                auto callbackTimeNs = hostTimeNs;
+
+                if (timing == Timing::asFastAsPossible)
+                    callbackTimeNs += (uint64_t) ((double) numDone * 1.0e9 / currentSampleRate);
+
+                AudioIODeviceCallbackContext context;
+                context.hostTimeNs = &callbackTimeNs;
+
+                callback->audioDeviceIOCallbackWithContext (inputChannelData.getRawDataPointer(),
+                                                            inputChannelData.size(),
+                                                            outputChannelData.getRawDataPointer(),
+                                                            outputChannelData.size(),
+                                                            currentBufferSize,
+                                                            context);
+            }
+            else
+            {
+                outputBuffer.clear();
+            }
+
+            numSamplesPending = currentBufferSize;
+        }
+
+        const auto numToWrite = jmin (numSamples - numDone, numSamplesPending);
+        writeOutput (currentBufferSize - numSamplesPending, numToWrite);
+
+        numSamplesPending -= numToWrite;
+        numDone += numToWrite;
+        numSamplesRendered += numToWrite;
+    }
+}
+
+void NullAudioIODevice::writeOutput (int startSample, int numSamples)
+{
+    if (outputStream == nullptr || outputChannelData.isEmpty())
+        return;
+
+    for (int i = 0; i < outputChannelData.size(); ++i)
+        outputReadPointers.set (i, outputChannelData.getUnchecked (i) + startSample);
+
+    using SourceFormat = AudioData::Format<AudioData::Float32, AudioData::NativeEndian>;
+    using DestFormat   = AudioData::Format<AudioData::Float32, AudioData::LittleEndian>;
+
+    AudioData::interleaveSamples (AudioData::NonInterleavedSource<SourceFormat> { outputReadPointers.getRawDataPointer(), outputReadPointers.size() },
+                                  AudioData::InterleavedDest<DestFormat>        { interleavedOutput.get(), outputChannelData.size() },
+                                  numSamples);
+
+    outputStream->write (interleavedOutput.get(), sizeof (float) * (size_t) (numSamples * outputChannelData.size()));
+}
+
+//==============================================================================
+class NullAudioIODeviceType final : public AudioIODeviceType
+{
+public:
+    NullAudioIODeviceType (const String& deviceTypeName, NullAudioIODevice::Timing timingToUse)
+        : AudioIODeviceType (deviceTypeName),
+          timing (timingToUse),
+          deviceName (deviceTypeName + " Device")
+    {
+    }
+
+    void scanForDevices() override {}
+
+    StringArray getDeviceNames (bool) const override                  { return StringArray (deviceName); }
+    int getDefaultDeviceIndex (bool) const override                   { return 0; }
+    bool hasSeparateInputsAndOutputs() const override                 { return false; }
+
+    int getIndexOfDevice (AudioIODevice* device, bool) const override
+    {
+        return device != nullptr && device->getName() == deviceName ? 0 : -1;
+    }
+
+    AudioIODevice* createDevice (const String& outputDeviceName, const String& inputDeviceName) override
+    {
+        if (outputDeviceName == deviceName || inputDeviceName == deviceName
+             || (outputDeviceName.isEmpty() && inputDeviceName.isEmpty()))
+            return new NullAudioIODevice (deviceName, getTypeName(), timing);
+
+        return nullptr;
+    }
+
+private:
+    const NullAudioIODevice::Timing timing;
+    const String deviceName;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NullAudioIODeviceType)
+};
+
+} // namespace juce
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An AudioIODevice with no hardware behind it.
+
+    The device runs its callback on its own thread, feeding it silent inputs and
+    discarding the outputs (or writing them to a stream, see setOutputStream()).
+    This lets audio code be run, bounced and benchmarked on machines without a
+    sound card, such as CI servers.
+
+    With Timing::realtime the callbacks are paced by the system clock, just like a
+    real device. With Timing::asFastAsPossible the next callback starts as soon as
+    the last one returns, so rendering can run faster than realtime. In both cases
+    the AudioDeviceManager's getCpuUsage() still reports the time spent in the
+    callback relative to the duration of the audio it produced.
+
+    You can create one directly, or get one from the device types returned by
+    AudioIODeviceType::createAudioIODeviceType_Null() and
+    AudioIODeviceType::createAudioIODeviceType_Offline().
+
+    @code
+    AudioDeviceManager manager;
+    manager.addAudioDeviceType (std::unique_ptr<AudioIODeviceType> (AudioIODeviceType::createAudioIODeviceType_Offline()));
+    manager.setCurrentAudioDeviceType ("Offline", true);
+
+    auto* device = dynamic_cast<NullAudioIODevice*> (manager.getCurrentAudioDevice());
+    device->setLengthToRender (0); // pause the device while the callback is attached
+
+    manager.addAudioCallback (&player);
+    device->setOutputStream (new FileOutputStream (file), true);
+    device->setLengthToRender (device->getNumSamplesRendered() + 10 * 48000);
+    device->waitUntilFinished();
+    manager.removeAudioCallback (&player);
+    @endcode
+
+    @tags{Audio}
+*/
+class JUCE_API  NullAudioIODevice  : public AudioIODevice,
+                                     private Thread
+{
+public:
+    //==============================================================================
+    /** How the device schedules its callbacks. */
+    enum class Timing
+    {
+        realtime,           /**< Each callback is made when a real device would need it. */
+        asFastAsPossible    /**< Each callback is made as soon as the previous one has finished. */
+    };
+
+    /** Creates a device.
+
+        @param deviceName           the name of the device
+        @param typeName             the name of the device type that the device belongs to
+        @param timing               how the callbacks should be scheduled
+        @param numInputChannels     the number of (silent) input channels the device has
+        @param numOutputChannels    the number of output channels the device has
+    */
+    NullAudioIODevice (const String& deviceName,
+                       const String& typeName,
+                       Timing timing,
+                       int numInputChannels = 2,
+                       int numOutputChannels = 2);
+
+    /** Destructor. */
+    ~NullAudioIODevice() override;
+
+    //==============================================================================
+    /** Returns the way the device schedules its callbacks. */
+    Timing getTiming() const noexcept                                   { return timing; }
+
+    /** Sets a stream that the device's active output channels will be written to.
+
+        The audio is written as interleaved, little-endian 32-bit floats, without a header.
+        Pass nullptr to stop writing the output. This can be called while the device is
+        playing: the stream is swapped between callbacks.
+    */
+    void setOutputStream (OutputStream* streamToWriteTo, bool deleteStreamWhenFinished);
+
+    /** Sets the position at which the device should pause.
+
+        Once getNumSamplesRendered() reaches this number, the device stays open and playing
+        but makes no more callbacks, and waitUntilFinished() returns. Raising the number
+        again resumes the callbacks. If the position falls part-way through a callback's
+        block, the rest of that block is kept and written out first when the device
+        resumes, so the output has no gaps. Zero pauses the device straight away, and a negative
+        number (the default) lets it run until it's stopped.
+
+        This can be called at any time, from any thread.
+    */
+    void setLengthToRender (int64 numSamples);
+
+    /** Returns the number of samples the device has rendered since it was last started. */
+    int64 getNumSamplesRendered() const noexcept                        { return numSamplesRendered.load(); }
+
+    /** Waits until the position set with setLengthToRender() has been reached.
+
+        Returns false if the timeout expired first.
+    */
+    bool waitUntilFinished (int timeoutMilliseconds = -1);
+
+    //==============================================================================
+    /** @internal */
+    StringArray getOutputChannelNames() override;
+    /** @internal */
+    StringArray getInputChannelNames() override;
+    /** @internal */
+    Array<double> getAvailableSampleRates() override;
+    /** @internal */
+    Array<int> getAvailableBufferSizes() override;
+    /** @internal */
+    int getDefaultBufferSize() override                                 { return 512; }
+    /** @internal */
+    String open (const BigInteger& inputChannels, const BigInteger& outputChannels,
+                 double sampleRate, int bufferSizeSamples) override;
+    /** @internal */
+    void close() override;
+    /** @internal */
+    bool isOpen() override                                              { return deviceIsOpen; }
+    /** @internal */
+    void start (AudioIODeviceCallback* callback) override;
+    /** @internal */
+    void stop() override;
+    /** @internal */
+    bool isPlaying() override                                           { return isStarted.load(); }
+    /** @internal */
+    String getLastError() override                                      { return {}; }
+    /** @internal */
+    int getCurrentBufferSizeSamples() override                          { return currentBufferSize; }
+    /** @internal */
+    double getCurrentSampleRate() override                              { return currentSampleRate; }
+    /** @internal */
+    int getCurrentBitDepth() override                                   { return 32; }
+    /** @internal */
+    BigInteger getActiveOutputChannels() const override                 { return activeOutputChannels; }
+    /** @internal */
+    BigInteger getActiveInputChannels() const override                  { return activeInputChannels; }
+    /** @internal */
+    int getOutputLatencyInSamples() override                            { return 0; }
+    /** @internal */
+    int getInputLatencyInSamples() override                             { return 0; }
+    /** @internal */
+    int getXRunCount() const noexcept override                          { return xrunCount.load(); }
+
+private:
+    //==============================================================================
+    void run() override;
+    void renderBlock (uint64_t hostTimeNs);
+    void writeOutput (int startSample, int numSamples);
+
+    const Timing timing;
+    const int numInputs, numOutputs;
+
+    double currentSampleRate = 44100.0;
+    int currentBufferSize = 0;
+    bool deviceIsOpen = false;
+    std::atomic<bool> isStarted { false };
+    BigInteger activeInputChannels, activeOutputChannels;
+
+    AudioBuffer<float> inputBuffer, outputBuffer;
+    Array<const float*> inputChannelData;
+    Array<float*> outputChannelData;
+    Array<const float*> outputReadPointers;
+    int numSamplesPending = 0;
+    HeapBlock<float> interleavedOutput;
+
+    CriticalSection callbackLock, lengthLock;
+    AudioIODeviceCallback* callback = nullptr;
+
+    OptionalScopedPointer<OutputStream> outputStream;
+    std::atomic<int64> lengthToRender { -1 };
+    std::atomic<int64> numSamplesRendered { 0 };
+    std::atomic<int> xrunCount { 0 };
+    WaitableEvent finishedEvent { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NullAudioIODevice)
+};
+
+} // namespace juce
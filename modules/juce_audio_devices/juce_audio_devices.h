@@ -126,6 +126,24 @@
  #define JUCE_ALSA 1
 #endif
 
+/** Config: JUCE_ALSA_USE_MMAP
+    If enabled, ALSA devices are opened with memory-mapped access when the driver supports it,
+    so that samples are converted straight into the hardware buffer rather than being copied
+    through a scratch buffer. Devices that can't be memory-mapped fall back to read/write access.
+*/
+#ifndef JUCE_ALSA_USE_MMAP
+ #define JUCE_ALSA_USE_MMAP 0
+#endif
+
+/** Config: JUCE_ALSA_RAW_MIDI
+    If enabled, the hardware MIDI inputs are also listed as raw MIDI devices, which are read
+    directly rather than through the ALSA sequencer. This avoids the sequencer's routing, so
+    it has a little less latency, but a raw device can only be opened by one client at a time.
+*/
+#ifndef JUCE_ALSA_RAW_MIDI
+ #define JUCE_ALSA_RAW_MIDI 0
+#endif
+
 /** Config: JUCE_JACK
     Enables JACK audio devices (Linux only).
 */
@@ -168,6 +186,15 @@
  #endif
 #endif
 
+/** Config: JUCE_NULL_AUDIO_DEVICES
+    Adds the "Null" and "Offline" device types, which have no hardware behind them, to the
+    list created by AudioDeviceManager::createAudioDeviceTypes(). They're always available
+    from AudioIODeviceType::createAudioIODeviceType_Null() and createAudioIODeviceType_Offline().
+*/
+#ifndef JUCE_NULL_AUDIO_DEVICES
+ #define JUCE_NULL_AUDIO_DEVICES 0
+#endif
+
 /** Config: JUCE_DISABLE_AUDIO_MIXING_WITH_OTHER_APPS
     Turning this on gives your app exclusive access to the system's audio
     on platforms which support it (currently iOS only).
@@ -179,6 +206,7 @@
 //==============================================================================
 #include "midi_io/juce_MidiDevices.h"
 #include "midi_io/juce_MidiMessageCollector.h"
+#include "midi_io/juce_LockFreeMidiMessageCollector.h"
 
 namespace juce
 {
@@ -197,6 +225,7 @@ namespace juce
 
 #include "audio_io/juce_AudioIODevice.h"
 #include "audio_io/juce_AudioIODeviceType.h"
+#include "audio_io/juce_NullAudioIODevice.h"
 #include "audio_io/juce_SystemAudioVolume.h"
 #include "sources/juce_AudioSourcePlayer.h"
 #include "sources/juce_AudioTransportSource.h"
@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  The queue is a bounded multi-producer ring of slots, each with a sequence number.
+    A slot whose sequence equals a write position is free for that position, and one
+    whose sequence is the position + 1 holds a message for it. Messages that are too
+    big for one slot use a run of consecutive ones. Because the single reader frees the
+    slots in order, a writer only needs to check the last slot of its run to know that
+    the whole run is free.
+*/
+struct LockFreeMidiMessageCollector::Slot
+{
+    static constexpr int dataSize = 44;
+
+    static size_t getNumSlotsNeeded (int numBytes) noexcept
+    {
+        return (size_t) jmax (1, (numBytes + dataSize - 1) / dataSize);
+    }
+
+    std::atomic<size_t> sequence { 0 };
+    double timeStamp = 0;
+    int numBytes = 0;
+    uint8 data[dataSize];
+};
+
+//==============================================================================
+LockFreeMidiMessageCollector::LockFreeMidiMessageCollector (size_t capacityInBytes)
+{
+    ensureStorageAllocated (capacityInBytes);
+}
+
+LockFreeMidiMessageCollector::~LockFreeMidiMessageCollector()
+{
+}
+
+//==============================================================================
+void LockFreeMidiMessageCollector::ensureStorageAllocated (size_t bytes)
+{
+    const auto numSlots = (size_t) nextPowerOfTwo ((int) jmax ((size_t) 16, bytes / (size_t) Slot::dataSize));
+
+    if (slots != nullptr && numSlots <= slotMask + 1)
+        return;
+
+    slots.reset (new Slot[numSlots]);
+    slotMask = numSlots - 1;
+
+    for (size_t i = 0; i < numSlots; ++i)
+        slots[i].sequence.store (i, std::memory_order_relaxed);
+
+    writePosition.store (0);
+    readPosition = 0;
+
+    const auto capacity = numSlots * (size_t) Slot::dataSize;
+    messageScratch.malloc (capacity);
+    pendingMessages.setFixedCapacity (capacity);
+    nextPendingMessages.setFixedCapacity (capacity);
+}
+
+void LockFreeMidiMessageCollector::reset (double newSampleRate)
+{
+    jassert (newSampleRate > 0);
+
+   #if JUCE_DEBUG
+    hasCalledReset = true;
+   #endif
+    sampleRate = newSampleRate;
+
+    // discard anything still in the queue
+    for (;;)
+    {
+        auto& slot = slots[readPosition & slotMask];
+
+        if (slot.sequence.load (std::memory_order_acquire) != readPosition + 1)
+            break;
+
+        const auto numSlots = Slot::getNumSlotsNeeded (slot.numBytes);
+
+        for (size_t i = 0; i < numSlots; ++i)
+            slots[(readPosition + i) & slotMask].sequence.store (readPosition + i + slotMask + 1, std::memory_order_release);
+
+        readPosition += numSlots;
+    }
+
+    pendingMessages.clear();
+    nextPendingMessages.clear();
+    clockBlockSize = 0;
+}
+
+//==============================================================================
+bool LockFreeMidiMessageCollector::addMessageToQueue (const MidiMessage& message)
+{
+   #if JUCE_DEBUG
+    jassert (hasCalledReset); // you need to call reset() to set the correct sample rate before using this object
+   #endif
+
+    // the messages that come in here need to be time-stamped correctly - see MidiInput
+    // for details of what the number should be.
+    jassert (! approximatelyEqual (message.getTimeStamp(), 0.0));
+
+    return push (message.getRawData(), message.getRawDataSize(), message.getTimeStamp());
+}
+
+bool LockFreeMidiMessageCollector::push (const uint8* data, int numBytes, double timeStamp) noexcept
+{
+    const auto numSlots = Slot::getNumSlotsNeeded (numBytes);
+
+    if (numSlots > slotMask + 1)
+    {
+        ++numDroppedMessages;
+        return false;
+    }
+
+    auto position = writePosition.load (std::memory_order_relaxed);
+
+    for (;;)
+    {
+        const auto lastPosition = position + numSlots - 1;
+        const auto sequence = slots[lastPosition & slotMask].sequence.load (std::memory_order_acquire);
+        const auto difference = (pointer_sized_int) sequence - (pointer_sized_int) lastPosition;
+
+        if (difference == 0)
+        {
+            if (writePosition.compare_exchange_weak (position, position + numSlots, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            // The queue is full - the audio thread isn't keeping up, or you need more space!
+            ++numDroppedMessages;
+            return false;
+        }
+        else
+        {
+            position = writePosition.load (std::memory_order_relaxed);
+        }
+    }
+
+    auto& first = slots[position & slotMask];
+    first.timeStamp = timeStamp;
+    first.numBytes = numBytes;
+
+    for (size_t i = 0; i < numSlots; ++i)
+    {
+        const auto offset = (int) i * Slot::dataSize;
+        memcpy (slots[(position + i) & slotMask].data, data + offset, (size_t) jmin (Slot::dataSize, numBytes - offset));
+    }
+
+    // publish the rest of the run before the first slot, which is what the reader checks
+    for (size_t i = 1; i < numSlots; ++i)
+        slots[(position + i) & slotMask].sequence.store (position + i + 1, std::memory_order_release);
+
+    first.sequence.store (position + 1, std::memory_order_release);
+    return true;
+}
+
+//==============================================================================
+void LockFreeMidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer, int numSamples)
+{
+    removeNextBlockOfMessages (destBuffer, numSamples, Time::getMillisecondCounterHiRes() * 0.001);
+}
+
+void LockFreeMidiMessageCollector::removeNextBlockOfMessages (MidiBuffer& destBuffer, int numSamples, double callbackTime)
+{
+   #if JUCE_DEBUG
+    jassert (hasCalledReset); // you need to call reset() to set the correct sample rate before using this object
+   #endif
+
+    jassert (numSamples > 0);
+
+    updateClock (callbackTime, numSamples);
+
+    // Messages held back from the last block go first. Their positions are stored as
+    // sample offsets from the time that block started, which is this block's previous time.
+    for (const auto metadata : pendingMessages)
+        addToBlock (destBuffer, metadata.data, metadata.numBytes,
+                    previousBlockTime + metadata.samplePosition / sampleRate, numSamples);
+
+    pendingMessages.clear();
+
+    for (;;)
+    {
+        auto& first = slots[readPosition & slotMask];
+
+        if (first.sequence.load (std::memory_order_acquire) != readPosition + 1)
+            break;
+
+        const auto numBytes = first.numBytes;
+        const auto timeStamp = first.timeStamp;
+        const auto numSlots = Slot::getNumSlotsNeeded (numBytes);
+        const uint8* data = first.data;
+
+        if (numSlots > 1)
+        {
+            for (size_t i = 0; i < numSlots; ++i)
+            {
+                const auto offset = (int) i * Slot::dataSize;
+                memcpy (messageScratch + offset, slots[(readPosition + i) & slotMask].data, (size_t) jmin (Slot::dataSize, numBytes - offset));
+            }
+
+            data = messageScratch;
+        }
+
+        addToBlock (destBuffer, data, numBytes, timeStamp, numSamples);
+
+        for (size_t i = 0; i < numSlots; ++i)
+            slots[(readPosition + i) & slotMask].sequence.store (readPosition + i + slotMask + 1, std::memory_order_release);
+
+        readPosition += numSlots;
+    }
+
+    pendingMessages.swapWith (nextPendingMessages);
+}
+
+void LockFreeMidiMessageCollector::addToBlock (MidiBuffer& destBuffer, const uint8* data, int numBytes,
+                                               double timeStamp, int numSamples)
+{
+    if (timeStamp >= currentBlockTime)
+    {
+        const auto offset = roundToInt ((timeStamp - currentBlockTime) * sampleRate);
+
+        if (nextPendingMessages.addEvent (data, numBytes, offset))
+            return;
+
+        timeStamp = currentBlockTime;
+    }
+
+    const auto proportion = (timeStamp - previousBlockTime) / (currentBlockTime - previousBlockTime);
+    const auto position = (int) (proportion * numSamples);
+
+    destBuffer.addEvent (data, numBytes, jlimit (0, numSamples - 1, position));
+}
+
+//==============================================================================
+/*  This is the delay-locked loop described by Fons Adriaensen in "Using a DLL to filter
+    time": it predicts when the next callback will happen, and corrects both that
+    prediction and its estimate of the block period by a fraction of the error.
+*/
+void LockFreeMidiMessageCollector::updateClock (double callbackTime, int numSamples) noexcept
+{
+    const auto nominalPeriod = numSamples / sampleRate;
+    const auto error = callbackTime - nextBlockTime;
+
+    // Start again if the block size has changed, or if the callbacks have stopped for a while
+    if (numSamples != clockBlockSize || std::abs (error) > 4.0 * nominalPeriod)
+    {
+        constexpr double bandwidthHz = 0.5;
+        const auto omega = MathConstants<double>::twoPi * bandwidthHz * nominalPeriod;
+
+        loopGainB = MathConstants<double>::sqrt2 * omega;
+        loopGainC = omega * omega;
+
+        clockBlockSize = numSamples;
+        blockPeriod = nominalPeriod;
+        previousBlockTime = callbackTime - nominalPeriod;
+        currentBlockTime = callbackTime;
+        nextBlockTime = callbackTime + nominalPeriod;
+        return;
+    }
+
+    previousBlockTime = currentBlockTime;
+    currentBlockTime = nextBlockTime;
+    nextBlockTime += loopGainB * error + blockPeriod;
+    blockPeriod += loopGainC * error;
+}
+
+//==============================================================================
+void LockFreeMidiMessageCollector::handleNoteOn (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity)
+{
+    MidiMessage m (MidiMessage::noteOn (midiChannel, midiNoteNumber, velocity));
+    m.setTimeStamp (Time::getMillisecondCounterHiRes() * 0.001);
+
+    addMessageToQueue (m);
+}
+
+void LockFreeMidiMessageCollector::handleNoteOff (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity)
+{
+    MidiMessage m (MidiMessage::noteOff (midiChannel, midiNoteNumber, velocity));
+    m.setTimeStamp (Time::getMillisecondCounterHiRes() * 0.001);
+
+    addMessageToQueue (m);
+}
+
+void LockFreeMidiMessageCollector::handleIncomingMidiMessage (MidiInput*, const MidiMessage& message)
+{
+    addMessageToQueue (message);
+}
+
+} // namespace juce
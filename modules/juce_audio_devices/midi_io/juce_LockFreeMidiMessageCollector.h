@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Collects incoming realtime MIDI messages and turns them into blocks for an audio
+    callback, without ever taking a lock.
+
+    This works like MidiMessageCollector, but any number of threads (e.g. several
+    MidiInputs) can add messages while the audio thread removes them, and neither side
+    ever waits for the other. Messages are stored in a fixed-size ring of preallocated
+    slots; if it fills up, new messages are dropped and counted by getNumDroppedMessages().
+
+    Rather than scaling the timestamps by the time since the last callback, the collector
+    runs a delay-locked loop on the times of the audio callbacks. This gives a smoothed
+    estimate of when each block started and how long it really lasts, which follows any
+    drift between the audio clock and the system clock. Each block then contains the
+    messages stamped during the previous block's period, at the matching sample positions,
+    so callback jitter doesn't turn into MIDI jitter. Messages stamped after the current
+    block started are kept back for the next one.
+
+    @see MidiMessageCollector
+
+    @tags{Audio}
+*/
+class JUCE_API  LockFreeMidiMessageCollector  : public MidiKeyboardState::Listener,
+                                                public MidiInputCallback
+{
+public:
+    //==============================================================================
+    /** Creates a collector with space for at least the given number of bytes of messages. */
+    explicit LockFreeMidiMessageCollector (size_t capacityInBytes = 65536);
+
+    /** Destructor. */
+    ~LockFreeMidiMessageCollector() override;
+
+    //==============================================================================
+    /** Clears any messages from the queue and restarts the clock model.
+
+        You need to call this method before starting to use the collector, so that
+        it knows the correct sample rate to use. It must not be called at the same
+        time as removeNextBlockOfMessages().
+    */
+    void reset (double sampleRate);
+
+    /** Takes an incoming real-time message and adds it to the queue.
+
+        The message's timestamp must be in seconds, on the same clock as
+        Time::getMillisecondCounterHiRes() * 0.001 (this is what MidiInput uses).
+
+        This can be called from any number of threads at once, and never blocks.
+        Returns false if the message had to be dropped because the queue was full.
+    */
+    bool addMessageToQueue (const MidiMessage& message);
+
+    /** Removes the pending messages for the next block and adds them to a buffer.
+
+        This should be called once per audio callback, at the start of the callback,
+        because the time at which it's called drives the clock model.
+
+        Precondition: numSamples must be greater than 0.
+    */
+    void removeNextBlockOfMessages (MidiBuffer& destBuffer, int numSamples);
+
+    /** Removes the pending messages for the next block, given the time at which the
+        audio callback started.
+
+        Use this if the audio device gives you a more accurate time for the callback
+        than the time at which you can call this method.
+
+        @param destBuffer           the buffer to add the messages to
+        @param numSamples           the number of samples in the block
+        @param callbackTimeSeconds  the time of the callback, on the same clock as the
+                                    messages' timestamps
+    */
+    void removeNextBlockOfMessages (MidiBuffer& destBuffer, int numSamples, double callbackTimeSeconds);
+
+    /** Makes sure the queue has space for at least this many bytes of messages.
+
+        This allocates, so it must not be called while messages are being added or
+        removed.
+    */
+    void ensureStorageAllocated (size_t bytes);
+
+    /** Returns the number of messages that have been dropped because the queue was full. */
+    int getNumDroppedMessages() const noexcept                  { return numDroppedMessages.load(); }
+
+    //==============================================================================
+    /** @internal */
+    void handleNoteOn (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity) override;
+    /** @internal */
+    void handleNoteOff (MidiKeyboardState*, int midiChannel, int midiNoteNumber, float velocity) override;
+    /** @internal */
+    void handleIncomingMidiMessage (MidiInput*, const MidiMessage&) override;
+
+private:
+    //==============================================================================
+    struct Slot;
+
+    bool push (const uint8* data, int numBytes, double timeStamp) noexcept;
+    void updateClock (double callbackTime, int numSamples) noexcept;
+    void addToBlock (MidiBuffer& destBuffer, const uint8* data, int numBytes, double timeStamp, int numSamples);
+
+    //==============================================================================
+    std::unique_ptr<Slot[]> slots;
+    size_t slotMask = 0;
+    std::atomic<size_t> writePosition { 0 };
+    size_t readPosition = 0;
+    std::atomic<int> numDroppedMessages { 0 };
+
+    HeapBlock<uint8> messageScratch;
+    MidiBuffer pendingMessages, nextPendingMessages;
+
+    double sampleRate = 44100.0;
+    double previousBlockTime = 0, currentBlockTime = 0, nextBlockTime = 0, blockPeriod = 0;
+    double loopGainB = 0, loopGainC = 0;
+    int clockBlockSize = 0;
+   #if JUCE_DEBUG
+    bool hasCalledReset = false;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LockFreeMidiMessageCollector)
+};
+
+} // namespace juce
@@ -225,16 +225,36 @@ public:
             return false;
         }
 
-        if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_INTERLEAVED) >= 0) // works better for plughw..
-            isInterleaved = true;
-        else if (snd_pcm_hw_params_set_access (handle, hwParams, SND_PCM_ACCESS_RW_NONINTERLEAVED) >= 0)
-            isInterleaved = false;
-        else
+        const snd_pcm_access_t accessModesToTry[] = {
+           #if JUCE_ALSA_USE_MMAP
+            SND_PCM_ACCESS_MMAP_INTERLEAVED,
+            SND_PCM_ACCESS_MMAP_NONINTERLEAVED,
+           #endif
+            SND_PCM_ACCESS_RW_INTERLEAVED, // works better for plughw..
+            SND_PCM_ACCESS_RW_NONINTERLEAVED
+        };
+
+        bool foundAccessMode = false;
+
+        for (auto accessMode : accessModesToTry)
+        {
+            if (snd_pcm_hw_params_set_access (handle, hwParams, accessMode) >= 0)
+            {
+                isInterleaved = (accessMode == SND_PCM_ACCESS_MMAP_INTERLEAVED || accessMode == SND_PCM_ACCESS_RW_INTERLEAVED);
+                isMMap = (accessMode == SND_PCM_ACCESS_MMAP_INTERLEAVED || accessMode == SND_PCM_ACCESS_MMAP_NONINTERLEAVED);
+                foundAccessMode = true;
+                break;
+            }
+        }
+
+        if (! foundAccessMode)
         {
             jassertfalse;
             return false;
         }
 
+        JUCE_ALSA_LOG ("access: mmap=" << (int) isMMap << ", interleaved=" << (int) isInterleaved);
+
         enum { isFloatBit = 1 << 16, isLittleEndianBit = 1 << 17, onlyUseLower24Bits = 1 << 18 };
 
         const int formatsToTry[] = { SND_PCM_FORMAT_FLOAT_LE,   32 | isFloatBit | isLittleEndianBit,
@@ -321,9 +341,93 @@ public:
 
         numChannelsRunning = numChannels;
 
+        if (isInterleaved && ! isMMap)
+            scratch.ensureSize ((size_t) ((int) sizeof (float) * bufferSize * numChannelsRunning), false);
+
         return true;
     }
 
+    //==============================================================================
+    /** Returns the number of frames that can be read or written without blocking,
+        recovering from an xrun if necessary. Returns a negative error code if the
+        device couldn't be recovered.
+    */
+    snd_pcm_sframes_t getNumFramesAvailable()
+    {
+        auto avail = snd_pcm_avail_update (handle);
+
+        if (avail < 0)
+        {
+            if (! recoverFromError ((int) avail))
+                return avail;
+
+            avail = snd_pcm_avail_update (handle);
+        }
+
+        return avail;
+    }
+
+    /** Starts the device if it has been prepared (or recovered from an xrun) but isn't running.
+        Read/write playback starts by itself, but capture and memory-mapped playback don't.
+    */
+    void startIfPrepared()
+    {
+        if (snd_pcm_state (handle) == SND_PCM_STATE_PREPARED)
+            JUCE_ALSA_FAILED (snd_pcm_start (handle));
+    }
+
+    int getNumPollDescriptors() const
+    {
+        return jmax (0, snd_pcm_poll_descriptors_count (handle));
+    }
+
+    int fillPollDescriptors (pollfd* fds, int maxNumDescriptors) const
+    {
+        return jmax (0, snd_pcm_poll_descriptors (handle, fds, (unsigned int) maxNumDescriptors));
+    }
+
+    /** Handles the results of a poll() on this device's descriptors, returning
+        false if the device has failed.
+    */
+    bool handlePollEvents (pollfd* fds, int numDescriptors)
+    {
+        unsigned short revents = 0;
+
+        if (JUCE_ALSA_FAILED (snd_pcm_poll_descriptors_revents (handle, fds, (unsigned int) numDescriptors, &revents)))
+            return false;
+
+        if ((revents & POLLERR) == 0)
+            return true;
+
+        switch (snd_pcm_state (handle))
+        {
+            case SND_PCM_STATE_XRUN:          return recoverFromError (-EPIPE);
+            case SND_PCM_STATE_SUSPENDED:     return recoverFromError (-ESTRPIPE);
+            case SND_PCM_STATE_DISCONNECTED:  error = "device disconnected"; return false;
+            default:                          return true;
+        }
+    }
+
+    //==============================================================================
+    bool recoverFromError (int err)
+    {
+        if (err == -EPIPE)
+        {
+            if (isInput)
+                ++overrunCount;
+            else
+                ++underrunCount;
+
+            JUCE_ALSA_LOG ((isInput ? "overrun" : "underrun") << " on " << deviceID);
+        }
+        else if (err == -ESTRPIPE)
+        {
+            ++suspendCount;
+        }
+
+        return ! JUCE_ALSA_FAILED (snd_pcm_recover (handle, err, 1 /* silent */));
+    }
+
     //==============================================================================
     bool writeToOutputDevice (AudioBuffer<float>& outputChannelBuffer, const int numSamples)
     {
@@ -331,6 +435,9 @@ public:
         float* const* const data = outputChannelBuffer.getArrayOfWritePointers();
         snd_pcm_sframes_t numDone = 0;
 
+        if (isMMap)
+            return transferMMap (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize ((size_t) ((int) sizeof (float) * numSamples * numChannelsRunning), false);
@@ -350,10 +457,7 @@ public:
 
         if (numDone < 0)
         {
-            if (numDone == -(EPIPE))
-                underrunCount++;
-
-            if (JUCE_ALSA_FAILED (snd_pcm_recover (handle, (int) numDone, 1 /* silent */)))
+            if (! recoverFromError ((int) numDone))
                 return false;
         }
 
@@ -368,6 +472,9 @@ public:
         jassert (numChannelsRunning <= inputChannelBuffer.getNumChannels());
         float* const* const data = inputChannelBuffer.getArrayOfWritePointers();
 
+        if (isMMap)
+            return transferMMap (data, numSamples);
+
         if (isInterleaved)
         {
             scratch.ensureSize ((size_t) ((int) sizeof (float) * numSamples * numChannelsRunning), false);
@@ -377,10 +484,7 @@ public:
 
             if (num < 0)
             {
-                if (num == -(EPIPE))
-                    overrunCount++;
-
-                if (JUCE_ALSA_FAILED (snd_pcm_recover (handle, (int) num, 1 /* silent */)))
+                if (! recoverFromError ((int) num))
                     return false;
             }
 
@@ -397,10 +501,7 @@ public:
 
             if (num < 0)
             {
-                if (num == -(EPIPE))
-                    overrunCount++;
-
-                if (JUCE_ALSA_FAILED (snd_pcm_recover (handle, (int) num, 1 /* silent */)))
+                if (! recoverFromError ((int) num))
                     return false;
             }
 
@@ -418,16 +519,95 @@ public:
     snd_pcm_t* handle;
     String error;
     int bitDepth, numChannelsRunning, latency;
-    int underrunCount = 0, overrunCount = 0;
+    std::atomic<int> underrunCount { 0 }, overrunCount { 0 }, suspendCount { 0 };
 
 private:
     //==============================================================================
     String deviceID;
     const bool isInput;
-    bool isInterleaved;
+    bool isInterleaved, isMMap = false;
     MemoryBlock scratch;
     std::unique_ptr<AudioData::Converter> converter;
 
+    //==============================================================================
+    static void* getAreaPointer (const snd_pcm_channel_area_t& area, snd_pcm_uframes_t offset) noexcept
+    {
+        return addBytesToPointer (area.addr, (area.first + (size_t) offset * area.step) / 8);
+    }
+
+    /** Converts samples directly between the float buffers and the hardware ring buffer. */
+    bool transferMMap (float* const* data, const int numSamples)
+    {
+        int numDone = 0;
+
+        while (numDone < numSamples)
+        {
+            auto avail = getNumFramesAvailable();
+
+            if (avail < 0)
+                return false;
+
+            if (avail == 0)
+            {
+                if (isInput)
+                    startIfPrepared();
+
+                const auto result = snd_pcm_wait (handle, 1000);
+
+                if (result < 0 && ! recoverFromError (result))
+                    return false;
+
+                if (result == 0)
+                {
+                    JUCE_ALSA_LOG ("Timed out waiting for " << deviceID << ": numDone: " << numDone << ", numSamples: " << numSamples);
+                    break;
+                }
+
+                continue;
+            }
+
+            const snd_pcm_channel_area_t* areas = nullptr;
+            snd_pcm_uframes_t offset = 0;
+            auto frames = (snd_pcm_uframes_t) jmin ((snd_pcm_sframes_t) (numSamples - numDone), avail);
+
+            const auto beginResult = snd_pcm_mmap_begin (handle, &areas, &offset, &frames);
+
+            if (beginResult < 0)
+            {
+                if (! recoverFromError (beginResult))
+                    return false;
+
+                continue;
+            }
+
+            for (int i = 0; i < numChannelsRunning; ++i)
+            {
+                if (isInput)
+                    converter->convertSamples (data[i] + numDone, getAreaPointer (areas[i], offset), (int) frames);
+                else
+                    converter->convertSamples (getAreaPointer (areas[i], offset), data[i] + numDone, (int) frames);
+            }
+
+            const auto committed = snd_pcm_mmap_commit (handle, offset, frames);
+
+            if (committed < 0 || (snd_pcm_uframes_t) committed != frames)
+            {
+                if (! recoverFromError (committed < 0 ? (int) committed : -EPIPE))
+                    return false;
+
+                continue;
+            }
+
+            numDone += (int) frames;
+
+            // unlike snd_pcm_writei, committing to the ring buffer doesn't start the stream
+            if (! isInput)
+                startIfPrepared();
+        }
+
+        return true;
+    }
+
     //==============================================================================
     template <class SampleType>
     struct ConverterHelper
@@ -635,6 +815,17 @@ public:
         if (outputDevice != nullptr && JUCE_ALSA_FAILED (snd_pcm_prepare (outputDevice->handle)))
             return;
 
+        numInputPollDescriptors = inputDevice != nullptr ? inputDevice->getNumPollDescriptors() : 0;
+        numOutputPollDescriptors = outputDevice != nullptr ? outputDevice->getNumPollDescriptors() : 0;
+        pollDescriptors.calloc ((size_t) jmax (1, numInputPollDescriptors + numOutputPollDescriptors));
+
+        // The input descriptors go first, so that either device can be polled on its own
+        if (inputDevice != nullptr)
+            numInputPollDescriptors = inputDevice->fillPollDescriptors (pollDescriptors, numInputPollDescriptors);
+
+        if (outputDevice != nullptr)
+            numOutputPollDescriptors = outputDevice->fillPollDescriptors (pollDescriptors + numInputPollDescriptors, numOutputPollDescriptors);
+
         startThread (Priority::high);
 
         int count = 1000;
@@ -674,8 +865,13 @@ public:
 
         stopThread (6000);
 
+        JUCE_ALSA_LOG ("xruns: underruns: " << getNumUnderruns() << ", overruns: " << getNumOverruns()
+                         << ", suspends: " << getNumSuspends());
+
         inputDevice.reset();
         outputDevice.reset();
+        pollDescriptors.free();
+        numInputPollDescriptors = numOutputPollDescriptors = 0;
 
         inputChannelBuffer.setSize (1, 1);
         outputChannelBuffer.setSize (1, 1);
@@ -693,21 +889,17 @@ public:
     {
         while (! threadShouldExit())
         {
-            if (inputDevice != nullptr && inputDevice->handle != nullptr)
+            if (! waitForDevices())
             {
-                if (outputDevice == nullptr || outputDevice->handle == nullptr)
-                {
-                    JUCE_ALSA_FAILED (snd_pcm_wait (inputDevice->handle, 2000));
-
-                    if (threadShouldExit())
-                        break;
-
-                    auto avail = snd_pcm_avail_update (inputDevice->handle);
+                JUCE_ALSA_LOG ("Device failure: " << error);
+                break;
+            }
 
-                    if (avail < 0)
-                        JUCE_ALSA_FAILED (snd_pcm_recover (inputDevice->handle, (int) avail, 0));
-                }
+            if (threadShouldExit())
+                break;
 
+            if (inputDevice != nullptr && inputDevice->handle != nullptr)
+            {
                 audioIoInProgress = true;
 
                 if (! inputDevice->readFromInputDevice (inputChannelBuffer, bufferSize))
@@ -744,16 +936,6 @@ public:
 
             if (outputDevice != nullptr && outputDevice->handle != nullptr)
             {
-                JUCE_ALSA_FAILED (snd_pcm_wait (outputDevice->handle, 2000));
-
-                if (threadShouldExit())
-                    break;
-
-                auto avail = snd_pcm_avail_update (outputDevice->handle);
-
-                if (avail < 0)
-                    JUCE_ALSA_FAILED (snd_pcm_recover (outputDevice->handle, (int) avail, 0));
-
                 audioIoInProgress = true;
 
                 if (! outputDevice->writeToOutputDevice (outputChannelBuffer, bufferSize))
@@ -782,15 +964,16 @@ public:
 
     int getXRunCount() const noexcept
     {
-        int result = 0;
-
-        if (outputDevice != nullptr)
-            result += outputDevice->underrunCount;
+        return getNumUnderruns() + getNumOverruns();
+    }
 
-        if (inputDevice != nullptr)
-            result += inputDevice->overrunCount;
+    int getNumUnderruns() const noexcept    { return outputDevice != nullptr ? outputDevice->underrunCount.load() : 0; }
+    int getNumOverruns() const noexcept     { return inputDevice != nullptr ? inputDevice->overrunCount.load() : 0; }
 
-        return result;
+    int getNumSuspends() const noexcept
+    {
+        return (outputDevice != nullptr ? outputDevice->suspendCount.load() : 0)
+             + (inputDevice != nullptr ? inputDevice->suspendCount.load() : 0);
     }
 
     //==============================================================================
@@ -816,6 +999,9 @@ private:
     Array<const float*> inputChannelDataForCallback;
     Array<float*> outputChannelDataForCallback;
 
+    HeapBlock<pollfd> pollDescriptors;
+    int numInputPollDescriptors = 0, numOutputPollDescriptors = 0;
+
     unsigned int minChansOut = 0, maxChansOut = 0;
     unsigned int minChansIn = 0, maxChansIn = 0;
 
@@ -829,6 +1015,85 @@ private:
         return true;
     }
 
+    //==============================================================================
+    static bool isActive (const std::unique_ptr<ALSADevice>& device) noexcept
+    {
+        return device != nullptr && device->handle != nullptr;
+    }
+
+    bool isReady (ALSADevice& device, bool& deviceFailed)
+    {
+        const auto avail = device.getNumFramesAvailable();
+
+        if (avail < 0)
+        {
+            error = device.error;
+            deviceFailed = true;
+            return false;
+        }
+
+        return avail >= bufferSize;
+    }
+
+    /** Waits with a single poll() on both devices until a whole block can be read from
+        the input and written to the output. Returns false if a device has failed.
+    */
+    bool waitForDevices()
+    {
+        while (! threadShouldExit())
+        {
+            bool deviceFailed = false;
+
+            if (isActive (inputDevice))
+                inputDevice->startIfPrepared();
+
+            const auto inputReady  = ! isActive (inputDevice)  || isReady (*inputDevice, deviceFailed);
+            const auto outputReady = ! isActive (outputDevice) || isReady (*outputDevice, deviceFailed);
+
+            if (deviceFailed)
+                return false;
+
+            if (inputReady && outputReady)
+                return true;
+
+            auto* fds = inputReady ? pollDescriptors + numInputPollDescriptors : pollDescriptors.get();
+            const auto numFds = (inputReady ? 0 : numInputPollDescriptors) + (outputReady ? 0 : numOutputPollDescriptors);
+
+            const auto result = poll (fds, (nfds_t) numFds, 2000);
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                error = "poll failed";
+                return false;
+            }
+
+            if (result == 0)
+            {
+                JUCE_ALSA_LOG ("Timed out waiting for the devices");
+                continue;
+            }
+
+            if (! inputReady && isActive (inputDevice)
+                 && ! inputDevice->handlePollEvents (pollDescriptors, numInputPollDescriptors))
+            {
+                error = inputDevice->error;
+                return false;
+            }
+
+            if (! outputReady && isActive (outputDevice)
+                 && ! outputDevice->handlePollEvents (pollDescriptors + numInputPollDescriptors, numOutputPollDescriptors))
+            {
+                error = outputDevice->error;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     void initialiseRatesAndChannels()
     {
         sampleRates.clear();
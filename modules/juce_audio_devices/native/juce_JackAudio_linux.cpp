@@ -94,6 +94,10 @@ JUCE_DECL_JACK_FUNCTION (int, jack_set_xrun_callback, (jack_client_t* client, Ja
 JUCE_DECL_JACK_FUNCTION (int, jack_port_flags, (const jack_port_t* port), (port))
 JUCE_DECL_JACK_FUNCTION (jack_port_t*, jack_port_by_name, (jack_client_t* client, const char* name), (client, name))
 JUCE_DECL_VOID_JACK_FUNCTION (jack_free, (void* ptr), (ptr))
+JUCE_DECL_JACK_FUNCTION (jack_transport_state_t, jack_transport_query, (const jack_client_t* client, jack_position_t* pos), (client, pos))
+JUCE_DECL_VOID_JACK_FUNCTION (jack_transport_start, (jack_client_t* client), (client))
+JUCE_DECL_VOID_JACK_FUNCTION (jack_transport_stop, (jack_client_t* client), (client))
+JUCE_DECL_JACK_FUNCTION (int, jack_transport_locate, (jack_client_t* client, jack_nframes_t frame), (client, frame))
 
 #if JUCE_DEBUG
  #define JACK_LOGGING_ENABLED 1
@@ -223,6 +227,12 @@ public:
 
             inChans.calloc (totalNumberOfInputChannels + 2);
             outChans.calloc (totalNumberOfOutputChannels + 2);
+
+            for (auto& ports : activePorts)
+            {
+                ports.inputs.calloc (totalNumberOfInputChannels + 1);
+                ports.outputs.calloc (totalNumberOfOutputChannels + 1);
+            }
         }
     }
 
@@ -381,7 +391,11 @@ public:
         if (deviceIsOpen && newCallback != callback)
         {
             if (newCallback != nullptr)
+            {
+                preparedNumInputs = activeInputChannels.countNumberOfSetBits();
+                preparedNumOutputs = activeOutputChannels.countNumberOfSetBits();
                 newCallback->audioDeviceAboutToStart (this);
+            }
 
             AudioIODeviceCallback* const oldCallback = callback;
 
@@ -414,7 +428,7 @@ public:
         int latency = 0;
 
         for (int i = 0; i < outputPorts.size(); i++)
-            latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, outputPorts[i]));
+            latency = jmax (latency, getPortLatency (outputPorts[i], false));
 
         return latency;
     }
@@ -424,7 +438,7 @@ public:
         int latency = 0;
 
         for (int i = 0; i < inputPorts.size(); i++)
-            latency = jmax (latency, (int) juce::jack_port_get_total_latency (client, inputPorts[i]));
+            latency = jmax (latency, getPortLatency (inputPorts[i], true));
 
         return latency;
     }
@@ -454,29 +468,149 @@ private:
     };
 
     //==============================================================================
-    void process (const int numSamples)
+    /*  Reports JACK's transport to the callback. The position is read once at the start of
+        each process cycle, so every call to getPosition() during the cycle agrees.
+    */
+    class JackPlayHead final : public AudioPlayHead
     {
-        int numActiveInChans = 0, numActiveOutChans = 0;
+    public:
+        explicit JackPlayHead (JackAudioIODevice& device)  : owner (device) {}
 
-        for (int i = 0; i < totalNumberOfInputChannels; ++i)
+        void update (jack_transport_state_t state, const jack_position_t& position) noexcept
         {
-            if (activeInputChannels[i])
-                if (auto* in = (jack_default_audio_sample_t*) juce::jack_port_get_buffer (inputPorts.getUnchecked (i),
-                                                                                          static_cast<jack_nframes_t> (numSamples)))
-                    inChans[numActiveInChans++] = (float*) in;
+            PositionInfo result;
+            result.setIsPlaying (state == JackTransportRolling);
+            result.setTimeInSamples ((int64_t) position.frame);
+
+            if (position.frame_rate > 0)
+                result.setTimeInSeconds ((double) position.frame / (double) position.frame_rate);
+
+            if ((position.valid & JackPositionBBT) != 0 && position.beat_type > 0.0f && position.ticks_per_beat > 0.0)
+            {
+                const auto quarterNotesPerBeat = 4.0 / (double) position.beat_type;
+                const auto barStartPpq = (double) (position.bar - 1) * (double) position.beats_per_bar * quarterNotesPerBeat;
+                const auto beatsIntoBar = (double) (position.beat - 1) + (double) position.tick / position.ticks_per_beat;
+
+                result.setBpm (position.beats_per_minute);
+                result.setTimeSignature (TimeSignature { (int) position.beats_per_bar, (int) position.beat_type });
+                result.setBarCount ((int64_t) (position.bar - 1));
+                result.setPpqPositionOfLastBarStart (barStartPpq);
+                result.setPpqPosition (barStartPpq + beatsIntoBar * quarterNotesPerBeat);
+            }
+
+            info = result;
         }
 
-        for (int i = 0; i < totalNumberOfOutputChannels; ++i)
+        Optional<PositionInfo> getPosition() const override    { return info; }
+        bool canControlTransport() override                    { return owner.client != nullptr; }
+
+        void transportPlay (bool shouldStartPlaying) override
+        {
+            if (owner.client == nullptr)
+                return;
+
+            if (shouldStartPlaying)
+                juce::jack_transport_start (owner.client);
+            else
+                juce::jack_transport_stop (owner.client);
+        }
+
+        void transportRewind() override
         {
+            if (owner.client != nullptr)
+                juce::jack_transport_locate (owner.client, 0);
+        }
+
+    private:
+        JackAudioIODevice& owner;
+        PositionInfo info;
+    };
+
+    //==============================================================================
+    /*  The ports that are connected, in channel order. There are two of these: the process
+        callback reads the current one while updateActivePorts() fills the other one in, and
+        then swaps them, so neither thread ever waits for the other for longer than a cycle.
+    */
+    struct ActivePorts
+    {
+        HeapBlock<jack_port_t*> inputs, outputs;
+        int numInputs = 0, numOutputs = 0;
+    };
+
+    void publishActivePorts()
+    {
+        const auto next = 1 - currentActivePorts.load();
+
+        // A process cycle that started before the last swap may still be reading this one
+        while (activePortsInUse.load() == next)
+            Thread::yield();
+
+        auto& ports = activePorts[next];
+        ports.numInputs = ports.numOutputs = 0;
+
+        for (int i = 0; i < totalNumberOfInputChannels; ++i)
+            if (activeInputChannels[i])
+                ports.inputs[ports.numInputs++] = inputPorts.getUnchecked (i);
+
+        for (int i = 0; i < totalNumberOfOutputChannels; ++i)
             if (activeOutputChannels[i])
-                if (auto* out = (jack_default_audio_sample_t*) juce::jack_port_get_buffer (outputPorts.getUnchecked (i),
-                                                                                           static_cast<jack_nframes_t> (numSamples)))
-                    outChans[numActiveOutChans++] = (float*) out;
+                ports.outputs[ports.numOutputs++] = outputPorts.getUnchecked (i);
+
+        currentActivePorts.store (next);
+    }
+
+    int getPortLatency (jack_port_t* port, bool isInput) const
+    {
+        // jack_port_get_latency_range() replaced jack_port_get_total_latency(), but isn't in older libraries
+        using LatencyRangeFn = void (*) (jack_port_t*, jack_latency_callback_mode_t, jack_latency_range_t*);
+        static const auto getLatencyRange = (LatencyRangeFn) juce_loadJackFunction ("jack_port_get_latency_range");
+
+        if (getLatencyRange != nullptr)
+        {
+            jack_latency_range_t range {};
+            getLatencyRange (port, isInput ? JackCaptureLatency : JackPlaybackLatency, &range);
+            return (int) range.max;
         }
 
-        const ScopedLock sl (callbackLock);
+        return (int) juce::jack_port_get_total_latency (client, port);
+    }
 
-        if (callback != nullptr)
+    //==============================================================================
+    void process (const int numSamples)
+    {
+        int portsIndex;
+
+        do
+        {
+            portsIndex = currentActivePorts.load();
+            activePortsInUse.store (portsIndex);
+        }
+        while (currentActivePorts.load() != portsIndex);
+
+        const auto& ports = activePorts[portsIndex];
+        int numActiveInChans = 0, numActiveOutChans = 0;
+
+        // These are JACK's own port buffers, which the callback reads and writes directly
+        for (int i = 0; i < ports.numInputs; ++i)
+            if (auto* in = (jack_default_audio_sample_t*) juce::jack_port_get_buffer (ports.inputs[i], static_cast<jack_nframes_t> (numSamples)))
+                inChans[numActiveInChans++] = (float*) in;
+
+        for (int i = 0; i < ports.numOutputs; ++i)
+            if (auto* out = (jack_default_audio_sample_t*) juce::jack_port_get_buffer (ports.outputs[i], static_cast<jack_nframes_t> (numSamples)))
+                outChans[numActiveOutChans++] = (float*) out;
+
+        activePortsInUse.store (-1);
+
+        jack_position_t position {};
+        playHead.update (juce::jack_transport_query (client, &position), position);
+
+        AudioIODeviceCallbackContext context;
+        context.playHead = &playHead;
+
+        // If the callback is being swapped on another thread, output silence rather than waiting
+        const ScopedTryLock sl (callbackLock);
+
+        if (sl.isLocked() && callback != nullptr)
         {
             if ((numActiveInChans + numActiveOutChans) > 0)
                 callback->audioDeviceIOCallbackWithContext (inChans.getData(),
@@ -484,7 +618,7 @@ private:
                                                             outChans,
                                                             numActiveOutChans,
                                                             numSamples,
-                                                            {});
+                                                            context);
         }
         else
         {
@@ -524,12 +658,19 @@ private:
         if (newOutputChannels != activeOutputChannels
              || newInputChannels != activeInputChannels)
         {
-            AudioIODeviceCallback* const oldCallback = callback;
+            // While the callback has no more channels than it was prepared for, the device keeps
+            // running and the process callback picks up the new ports on its next cycle. If there
+            // are more, the callback is restarted, so that it can allocate for them off the audio thread.
+            AudioIODeviceCallback* const oldCallback = (newOutputChannels.countNumberOfSetBits() > preparedNumOutputs
+                                                         || newInputChannels.countNumberOfSetBits() > preparedNumInputs)
+                                                           ? callback : nullptr;
 
-            stop();
+            if (oldCallback != nullptr)
+                stop();
 
             activeOutputChannels = newOutputChannels;
             activeInputChannels  = newInputChannels;
+            publishActivePorts();
 
             if (oldCallback != nullptr)
                 start (oldCallback);
@@ -586,6 +727,11 @@ private:
     int totalNumberOfOutputChannels = 0;
     Array<jack_port_t*> inputPorts, outputPorts;
     BigInteger activeInputChannels, activeOutputChannels;
+    int preparedNumInputs = 0, preparedNumOutputs = 0;
+
+    ActivePorts activePorts[2];
+    std::atomic<int> currentActivePorts { 0 }, activePortsInUse { -1 };
+    JackPlayHead playHead { *this };
 
     std::atomic<int> xruns { 0 };
 
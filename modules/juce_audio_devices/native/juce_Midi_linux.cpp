@@ -66,6 +66,9 @@ public:
 
         if (handle != nullptr)
         {
+            if (queueId >= 0)
+                snd_seq_free_queue (handle, queueId);
+
             snd_seq_delete_simple_port (handle, announcementsIn);
             snd_seq_close (handle);
         }
@@ -105,10 +108,34 @@ public:
 
         void connectWith (int sourceClient, int sourcePort) const noexcept
         {
-            if (isInput)
-                snd_seq_connect_from (client->get(), portId, sourceClient, sourcePort);
-            else
+            if (! isInput)
+            {
                 snd_seq_connect_to (client->get(), portId, sourceClient, sourcePort);
+                return;
+            }
+
+            // Ask the kernel to stamp each event with the real time of our queue as it arrives,
+            // rather than relying on the time at which the input thread gets around to it
+            snd_seq_port_subscribe_t* subscription = nullptr;
+            snd_seq_port_subscribe_alloca (&subscription);
+
+            snd_seq_addr_t sender, dest;
+            sender.client = (unsigned char) sourceClient;
+            sender.port = (unsigned char) sourcePort;
+            dest.client = (unsigned char) client->getId();
+            dest.port = (unsigned char) portId;
+
+            snd_seq_port_subscribe_set_sender (subscription, &sender);
+            snd_seq_port_subscribe_set_dest (subscription, &dest);
+
+            if (const auto queue = client->getQueueId(); queue >= 0)
+            {
+                snd_seq_port_subscribe_set_queue (subscription, queue);
+                snd_seq_port_subscribe_set_time_update (subscription, 1);
+                snd_seq_port_subscribe_set_time_real (subscription, 1);
+            }
+
+            snd_seq_subscribe_port (client->get(), subscription);
         }
 
         bool isValid() const noexcept
@@ -195,9 +222,23 @@ public:
                             : (SND_SEQ_PORT_CAP_READ  | (enableSubscription ? SND_SEQ_PORT_CAP_SUBS_READ : 0));
 
                 portName = name;
-                portId = snd_seq_create_simple_port (seqHandle, portName.toUTF8(), caps,
-                                                     SND_SEQ_PORT_TYPE_MIDI_GENERIC |
-                                                     SND_SEQ_PORT_TYPE_APPLICATION);
+
+                snd_seq_port_info_t* portInfo = nullptr;
+                snd_seq_port_info_alloca (&portInfo);
+
+                snd_seq_port_info_set_name (portInfo, portName.toRawUTF8());
+                snd_seq_port_info_set_capability (portInfo, caps);
+                snd_seq_port_info_set_type (portInfo, SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+
+                // Events from other clients that subscribe to this port get timestamped too
+                if (const auto queue = client->getQueueId(); isInput && queue >= 0)
+                {
+                    snd_seq_port_info_set_timestamping (portInfo, 1);
+                    snd_seq_port_info_set_timestamp_real (portInfo, 1);
+                    snd_seq_port_info_set_timestamp_queue (portInfo, queue);
+                }
+
+                portId = snd_seq_create_port (seqHandle, portInfo) >= 0 ? snd_seq_port_info_get_port (portInfo) : -1;
             }
         }
 
@@ -260,6 +301,23 @@ public:
 
     snd_seq_t* get() const noexcept     { return handle; }
     int getId() const noexcept          { return clientId; }
+    int getQueueId() const noexcept     { return queueId; }
+
+    /*  Returns the time at which an event arrived, in seconds on the same clock as
+        Time::getMillisecondCounterHiRes(). Events that the kernel has stamped with our
+        queue's real time are converted, and anything else gets the current time.
+    */
+    double getEventTime (const snd_seq_event_t* event) const noexcept
+    {
+        if (queueId >= 0
+            && event->queue == queueId
+            && (event->flags & SND_SEQ_TIME_STAMP_MASK) == SND_SEQ_TIME_STAMP_REAL)
+        {
+            return queueTimeOffset + (double) event->time.time.tv_sec + (double) event->time.time.tv_nsec * 1.0e-9;
+        }
+
+        return Time::getMillisecondCounterHiRes() * 0.001;
+    }
 
     Port* createPort (const String& name, bool forInput, bool enableSubscription)
     {
@@ -292,8 +350,11 @@ private:
         {
             snd_seq_nonblock (handle, SND_SEQ_NONBLOCK);
             snd_seq_set_client_name (handle, getAlsaMidiName().toRawUTF8());
+            snd_seq_set_input_buffer_size (handle, 64 * 1024);
             clientId = snd_seq_client_id (handle);
 
+            startTimestampQueue();
+
             // It's good idea to pre-allocate a good number of elements
             ports.reserve (32);
 
@@ -307,6 +368,32 @@ private:
         }
     }
 
+    void startTimestampQueue()
+    {
+        queueId = snd_seq_alloc_named_queue (handle, "JUCE MIDI Input");
+
+        if (queueId < 0)
+            return;
+
+        snd_seq_start_queue (handle, queueId, nullptr);
+        snd_seq_drain_output (handle);
+
+        // Find out where the queue's clock is relative to ours, so that event times can be converted
+        snd_seq_queue_status_t* status = nullptr;
+        snd_seq_queue_status_alloca (&status);
+
+        if (snd_seq_get_queue_status (handle, queueId, status) < 0)
+        {
+            snd_seq_free_queue (handle, queueId);
+            queueId = -1;
+            return;
+        }
+
+        const auto* queueTime = snd_seq_queue_status_get_real_time (status);
+        queueTimeOffset = Time::getMillisecondCounterHiRes() * 0.001
+                            - ((double) queueTime->tv_sec + (double) queueTime->tv_nsec * 1.0e-9);
+    }
+
     Port* findPort (int portId)
     {
         if (const auto iter = findPortIterator (portId); iter != ports.end())
@@ -318,6 +405,8 @@ private:
     snd_seq_t* handle = nullptr;
     int clientId = 0;
     int announcementsIn = 0;
+    int queueId = -1;
+    double queueTimeOffset = 0.0;
     std::vector<std::unique_ptr<Port>> ports;
     Atomic<int> activeCallbacks;
     CriticalSection callbackLock;
@@ -387,11 +476,27 @@ private:
                 while (! shouldStop)
                 {
                     // This timeout shouldn't be too long, so that the program can exit in a timely manner
-                    if (poll (pfd.data(), (nfds_t) numPfds, 100) > 0)
+                    if (poll (pfd.data(), (nfds_t) numPfds, 100) <= 0)
+                        continue;
+
+                    if (shouldStop)
+                        break;
+
+                    // poll() also wakes up on errors, which would otherwise be reported again
+                    // straight away and keep this thread spinning
+                    unsigned short revents = 0;
+
+                    if (snd_seq_poll_descriptors_revents (seqHandle, pfd.data(), (unsigned int) numPfds, &revents) < 0
+                        || (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
                     {
-                        if (shouldStop)
-                            break;
+                        DBG ("ALSA sequencer input stopped: poll() returned an error");
+                        break;
+                    }
 
+                    // Passing 1 here reads everything the kernel has queued in one go; the inner loop
+                    // then takes those events from the library's buffer without any more system calls
+                    while (snd_seq_event_input_pending (seqHandle, 1) > 0)
+                    {
                         do
                         {
                             snd_seq_event_t* inputEvent = nullptr;
@@ -431,7 +536,7 @@ private:
                                 snd_midi_event_reset_decode (midiParser);
 
                                 concatenator.pushMidiData (buffer.data(), (int) numBytes,
-                                                           Time::getMillisecondCounter() * 0.001,
+                                                           client.getEventTime (inputEvent),
                                                            inputEvent, client);
                             }
                         }
@@ -445,6 +550,163 @@ private:
     std::optional<SequencerThread> inputThread;
 };
 
+#if JUCE_ALSA_RAW_MIDI
+//==============================================================================
+/*  Reads a raw MIDI device directly, bypassing the sequencer. The bytes are read in
+    whatever batches the driver hands them over, and each batch is timestamped as soon
+    as poll() wakes the thread up.
+*/
+class AlsaRawMidiInput
+{
+public:
+    AlsaRawMidiInput (snd_rawmidi_t* h, MidiInput& input, MidiInputCallback& cb)
+        : handle (h), midiInput (input), callback (cb)
+    {
+        thread = std::thread ([this] { run(); });
+    }
+
+    ~AlsaRawMidiInput()
+    {
+        shouldStop = true;
+        thread.join();
+        snd_rawmidi_close (handle);
+    }
+
+    static constexpr const char* identifierPrefix = "rawmidi:";
+
+    static Array<MidiDeviceInfo> findDevices()
+    {
+        Array<MidiDeviceInfo> devices;
+        int cardNum = -1;
+
+        snd_rawmidi_info_t* info = nullptr;
+        snd_rawmidi_info_alloca (&info);
+
+        while (snd_card_next (&cardNum) >= 0 && cardNum >= 0)
+        {
+            snd_ctl_t* ctl = nullptr;
+
+            if (snd_ctl_open (&ctl, ("hw:" + String (cardNum)).toRawUTF8(), SND_CTL_NONBLOCK) < 0)
+                continue;
+
+            for (int device = -1; snd_ctl_rawmidi_next_device (ctl, &device) >= 0 && device >= 0;)
+            {
+                snd_rawmidi_info_set_device (info, (unsigned int) device);
+                snd_rawmidi_info_set_subdevice (info, 0);
+                snd_rawmidi_info_set_stream (info, SND_RAWMIDI_STREAM_INPUT);
+
+                if (snd_ctl_rawmidi_info (ctl, info) < 0)
+                    continue;
+
+                const auto numSubdevices = (int) snd_rawmidi_info_get_subdevices_count (info);
+
+                for (int subdevice = 0; subdevice < numSubdevices; ++subdevice)
+                {
+                    snd_rawmidi_info_set_subdevice (info, (unsigned int) subdevice);
+
+                    if (snd_ctl_rawmidi_info (ctl, info) < 0)
+                        continue;
+
+                    String name (snd_rawmidi_info_get_subdevice_name (info));
+
+                    if (name.isEmpty())
+                        name = snd_rawmidi_info_get_name (info);
+
+                    devices.add ({ name + " (raw)",
+                                   identifierPrefix + ("hw:" + String (cardNum) + "," + String (device) + "," + String (subdevice)) });
+                }
+            }
+
+            snd_ctl_close (ctl);
+        }
+
+        return devices;
+    }
+
+    static std::unique_ptr<AlsaRawMidiInput> open (const String& identifier, MidiInput& input, MidiInputCallback& cb)
+    {
+        snd_rawmidi_t* h = nullptr;
+
+        if (snd_rawmidi_open (&h, nullptr, identifier.fromFirstOccurrenceOf (identifierPrefix, false, false).toRawUTF8(),
+                              SND_RAWMIDI_NONBLOCK) < 0)
+            return {};
+
+        return std::make_unique<AlsaRawMidiInput> (h, input, cb);
+    }
+
+    void enableCallback (bool enable)                   { callbackEnabled = enable; }
+
+    void handleIncomingMidiMessage (void*, const MidiMessage& message)
+    {
+        if (callbackEnabled)
+            callback.handleIncomingMidiMessage (&midiInput, message);
+    }
+
+    void handlePartialSysexMessage (void*, const uint8* messageData, int numBytesSoFar, double timeStamp)
+    {
+        if (callbackEnabled)
+            callback.handlePartialSysexMessage (&midiInput, messageData, numBytesSoFar, timeStamp);
+    }
+
+private:
+    void run()
+    {
+        Thread::setCurrentThreadName ("JUCE Raw MIDI Input");
+
+        const auto numPfds = snd_rawmidi_poll_descriptors_count (handle);
+        std::vector<pollfd> pfd (static_cast<size_t> (numPfds));
+        snd_rawmidi_poll_descriptors (handle, pfd.data(), (unsigned int) numPfds);
+
+        uint8 buffer[1024];
+
+        while (! shouldStop)
+        {
+            // This timeout shouldn't be too long, so that the program can exit in a timely manner
+            if (poll (pfd.data(), (nfds_t) numPfds, 100) <= 0)
+                continue;
+
+            // poll() also wakes up when the device has gone away, e.g. because it was unplugged,
+            // and would keep doing so straight away, so there's nothing more to read
+            unsigned short revents = 0;
+
+            if (snd_rawmidi_poll_descriptors_revents (handle, pfd.data(), (unsigned int) numPfds, &revents) < 0
+                || (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0)
+            {
+                DBG ("ALSA raw MIDI input stopped: poll() returned an error");
+                return;
+            }
+
+            const auto time = Time::getMillisecondCounterHiRes() * 0.001;
+
+            for (;;)
+            {
+                const auto numRead = snd_rawmidi_read (handle, buffer, sizeof (buffer));
+
+                if (numRead == -ENODEV || numRead == -EIO)
+                {
+                    DBG ("ALSA raw MIDI input stopped: " << snd_strerror ((int) numRead));
+                    return;
+                }
+
+                if (numRead <= 0)
+                    break;
+
+                concatenator.pushMidiData (buffer, (int) numRead, time, (void*) nullptr, *this);
+            }
+        }
+    }
+
+    snd_rawmidi_t* const handle;
+    MidiInput& midiInput;
+    MidiInputCallback& callback;
+    MidiDataConcatenator concatenator { 2048 };
+    std::atomic<bool> shouldStop { false }, callbackEnabled { false };
+    std::thread thread;
+
+    JUCE_DECLARE_NON_COPYABLE (AlsaRawMidiInput)
+};
+#endif
+
 //==============================================================================
 static String getFormattedPortIdentifier (int clientId, int portId)
 {
@@ -551,10 +813,35 @@ struct AlsaPortPtr
 };
 
 //==============================================================================
-class MidiInput::Pimpl final : public AlsaPortPtr
+class MidiInput::Pimpl final
 {
 public:
-    using AlsaPortPtr::AlsaPortPtr;
+    explicit Pimpl (AlsaClient::Port* p)
+        : port (std::make_unique<AlsaPortPtr> (p)) {}
+
+   #if JUCE_ALSA_RAW_MIDI
+    explicit Pimpl (std::unique_ptr<AlsaRawMidiInput> r)
+        : rawInput (std::move (r)) {}
+   #endif
+
+    void enableCallback (bool enable)
+    {
+       #if JUCE_ALSA_RAW_MIDI
+        if (rawInput != nullptr)
+        {
+            rawInput->enableCallback (enable);
+            return;
+        }
+       #endif
+
+        port->ptr->enableCallback (enable);
+    }
+
+private:
+    std::unique_ptr<AlsaPortPtr> port;
+   #if JUCE_ALSA_RAW_MIDI
+    std::unique_ptr<AlsaRawMidiInput> rawInput;
+   #endif
 };
 
 Array<MidiDeviceInfo> MidiInput::getAvailableDevices()
@@ -562,6 +849,10 @@ Array<MidiDeviceInfo> MidiInput::getAvailableDevices()
     Array<MidiDeviceInfo> devices;
     iterateMidiDevices (true, devices, {});
 
+   #if JUCE_ALSA_RAW_MIDI
+    devices.addArray (AlsaRawMidiInput::findDevices());
+   #endif
+
     return devices;
 }
 
@@ -575,6 +866,30 @@ std::unique_ptr<MidiInput> MidiInput::openDevice (const String& deviceIdentifier
     if (deviceIdentifier.isEmpty())
         return {};
 
+   #if JUCE_ALSA_RAW_MIDI
+    if (deviceIdentifier.startsWith (AlsaRawMidiInput::identifierPrefix))
+    {
+        jassert (callback != nullptr);
+
+        const auto rawDevices = AlsaRawMidiInput::findDevices();
+        const auto iter = std::find_if (rawDevices.begin(), rawDevices.end(),
+                                        [&] (const auto& d) { return d.identifier == deviceIdentifier; });
+
+        if (iter == rawDevices.end())
+            return {};
+
+        std::unique_ptr<MidiInput> midiInput (new MidiInput (iter->name, deviceIdentifier));
+
+        if (auto rawInput = AlsaRawMidiInput::open (deviceIdentifier, *midiInput, *callback))
+        {
+            midiInput->internal = std::make_unique<Pimpl> (std::move (rawInput));
+            return midiInput;
+        }
+
+        return {};
+    }
+   #endif
+
     Array<MidiDeviceInfo> devices;
     auto* port = iterateMidiDevices (true, devices, deviceIdentifier);
 
@@ -641,12 +956,12 @@ MidiInput::~MidiInput()
 
 void MidiInput::start()
 {
-    internal->ptr->enableCallback (true);
+    internal->enableCallback (true);
 }
 
 void MidiInput::stop()
 {
-    internal->ptr->enableCallback (false);
+    internal->enableCallback (false);
 }
 
 //==============================================================================
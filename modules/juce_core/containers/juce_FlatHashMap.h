@@ -0,0 +1,709 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #include <emmintrin.h>
+ #define JUCE_FLAT_HASH_USE_SSE2 1
+#elif JUCE_ARM && defined (__ARM_NEON) && defined (__aarch64__)
+ #include <arm_neon.h>
+ #define JUCE_FLAT_HASH_USE_NEON 1
+#endif
+
+namespace juce
+{
+
+namespace detail
+{
+
+/*  The table that FlatHashMap and FlatHashSet are built on.
+
+    This is an open-addressing table in the style of the "Swiss table": alongside the
+    array of items there's an array of control bytes, one per item, which hold either a
+    marker for an empty or deleted item, or 7 bits of the item's hash. The control bytes
+    are probed a group at a time, so a single SIMD comparison finds every item in the
+    group that might match, and the keys themselves are only compared for those.
+*/
+template <typename KeyType, typename ItemType, class HashFunctionType>
+class FlatHashTable
+{
+public:
+    using KeyTypeParameter = typename TypeHelpers::ParameterType<KeyType>::type;
+
+    //==============================================================================
+    explicit FlatHashTable (HashFunctionType hashFunction)
+        : hashFunctionToUse (std::move (hashFunction))
+    {
+    }
+
+    FlatHashTable (const FlatHashTable& other)
+        : hashFunctionToUse (other.hashFunctionToUse)
+    {
+        allocate (other.capacity);
+
+        for (size_t i = 0; i < other.capacity; ++i)
+            if (isFull (other.control[i]))
+                insertNew (other.hashFor (other.items()[i].key), other.items()[i]);
+    }
+
+    FlatHashTable (FlatHashTable&& other) noexcept
+        : hashFunctionToUse (other.hashFunctionToUse)
+    {
+        swapWith (other);
+    }
+
+    FlatHashTable& operator= (const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            auto copy (other);
+            swapWith (copy);
+        }
+
+        return *this;
+    }
+
+    FlatHashTable& operator= (FlatHashTable&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            swapWith (other);
+        }
+
+        return *this;
+    }
+
+    ~FlatHashTable()
+    {
+        release();
+    }
+
+    //==============================================================================
+    int size() const noexcept           { return (int) numItems; }
+    int getCapacity() const noexcept    { return (int) capacity; }
+
+    void clear()
+    {
+        destroyItems();
+
+        if (capacity > 0)
+            std::memset (control.get(), emptyControl, capacity);
+
+        numItems = 0;
+        growthLeft = maxItemsForCapacity (capacity);
+    }
+
+    void ensureStorageAllocated (int minNumItems)
+    {
+        if ((size_t) minNumItems > (size_t) numItems + growthLeft)
+            rehash (capacityForItems ((size_t) minNumItems));
+    }
+
+    void swapWith (FlatHashTable& other) noexcept
+    {
+        std::swap (hashFunctionToUse, other.hashFunctionToUse);
+        std::swap (control, other.control);
+        std::swap (storage, other.storage);
+        std::swap (capacity, other.capacity);
+        std::swap (numItems, other.numItems);
+        std::swap (growthLeft, other.growthLeft);
+    }
+
+    //==============================================================================
+    ItemType* find (KeyTypeParameter key) const noexcept
+    {
+        if (numItems == 0)
+            return nullptr;
+
+        return findWithHash (key, hashFor (key));
+    }
+
+    /*  Returns the item with this key, creating it if it doesn't exist. The second member
+        of the result is true if the item was created.
+    */
+    std::pair<ItemType*, bool> findOrInsert (KeyTypeParameter key)
+    {
+        const auto hash = hashFor (key);
+
+        if (numItems > 0)
+            if (auto* item = findWithHash (key, hash))
+                return { item, false };
+
+        if (growthLeft == 0)
+            grow();
+
+        return { insertNew (hash, ItemType { key }), true };
+    }
+
+    bool remove (KeyTypeParameter key)
+    {
+        if (auto* item = find (key))
+        {
+            removeAt ((size_t) (item - items()));
+            return true;
+        }
+
+        return false;
+    }
+
+    template <typename Predicate>
+    void removeIf (Predicate&& predicate)
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            if (isFull (control[i]) && predicate (items()[i]))
+                removeAt (i);
+    }
+
+    //==============================================================================
+    ItemType* getItem (size_t index) const noexcept     { return items() + index; }
+
+    // Returns the index of the first item at or after the given index, or the capacity
+    size_t findNextItem (size_t index) const noexcept
+    {
+        while (index < capacity && ! isFull (control[index]))
+            ++index;
+
+        return index;
+    }
+
+    size_t getNumSlots() const noexcept                 { return capacity; }
+
+private:
+    //==============================================================================
+    static constexpr int8 emptyControl = -128;
+    static constexpr int8 deletedControl = -2;
+
+   #if JUCE_FLAT_HASH_USE_SSE2 || JUCE_FLAT_HASH_USE_NEON
+    static constexpr size_t groupSize = 16;
+   #else
+    static constexpr size_t groupSize = 8;
+   #endif
+
+    static bool isFull (int8 c) noexcept                { return c >= 0; }
+
+    // A set of positions within a group, which is iterated in ascending order
+    struct BitMask
+    {
+       #if JUCE_FLAT_HASH_USE_SSE2
+        static constexpr int bitsPerItem = 1;
+       #elif JUCE_FLAT_HASH_USE_NEON
+        static constexpr int bitsPerItem = 4;
+       #else
+        static constexpr int bitsPerItem = 8;
+       #endif
+
+        explicit operator bool() const noexcept         { return bits != 0; }
+
+        size_t lowestIndex() const noexcept
+        {
+           #if JUCE_MSVC
+            unsigned long index;
+
+            if (_BitScanForward (&index, (unsigned long) bits))
+                return (size_t) index / bitsPerItem;
+
+            _BitScanForward (&index, (unsigned long) (bits >> 32));
+            return (size_t) (index + 32) / bitsPerItem;
+           #else
+            return (size_t) __builtin_ctzll (bits) / bitsPerItem;
+           #endif
+        }
+
+        void removeLowest() noexcept                    { bits &= bits - 1; }
+
+        uint64 bits;
+    };
+
+    struct Group
+    {
+        explicit Group (const int8* c) noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            data = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (c));
+           #elif JUCE_FLAT_HASH_USE_NEON
+            data = vld1q_s8 (c);
+           #else
+            std::memcpy (&data, c, sizeof (data));
+           #endif
+        }
+
+        BitMask match (int8 h2) const noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            return { (uint64) (uint32) _mm_movemask_epi8 (_mm_cmpeq_epi8 (data, _mm_set1_epi8 (h2))) };
+           #elif JUCE_FLAT_HASH_USE_NEON
+            return toBitMask (vceqq_s8 (data, vdupq_n_s8 (h2)));
+           #else
+            // This can give false positives above a real match, which is fine as the keys are compared anyway
+            const auto x = data ^ (lsbs * (uint8) h2);
+            return { (x - lsbs) & ~x & msbs };
+           #endif
+        }
+
+        BitMask matchEmpty() const noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            return { (uint64) (uint32) _mm_movemask_epi8 (_mm_cmpeq_epi8 (data, _mm_set1_epi8 (emptyControl))) };
+           #elif JUCE_FLAT_HASH_USE_NEON
+            return toBitMask (vceqq_s8 (data, vdupq_n_s8 (emptyControl)));
+           #else
+            // Empty is the only control value with the top bit set and the next one clear
+            return { data & ~(data << 1) & msbs };
+           #endif
+        }
+
+        BitMask matchEmptyOrDeleted() const noexcept
+        {
+           #if JUCE_FLAT_HASH_USE_SSE2
+            return { (uint64) (uint32) _mm_movemask_epi8 (data) };
+           #elif JUCE_FLAT_HASH_USE_NEON
+            return toBitMask (vcltq_s8 (data, vdupq_n_s8 (0)));
+           #else
+            return { data & msbs };
+           #endif
+        }
+
+       #if JUCE_FLAT_HASH_USE_SSE2
+        __m128i data;
+       #elif JUCE_FLAT_HASH_USE_NEON
+        static BitMask toBitMask (uint8x16_t matches) noexcept
+        {
+            // Narrowing each byte to 4 bits is the cheapest way to get a mask out of NEON, and
+            // keeping one bit of each lets removeLowest() clear a whole position at once
+            const auto nibbles = vget_lane_u64 (vreinterpret_u64_u8 (vshrn_n_u16 (vreinterpretq_u16_u8 (matches), 4)), 0);
+            return { nibbles & 0x8888888888888888ull };
+        }
+
+        int8x16_t data;
+       #else
+        static constexpr uint64 lsbs = 0x0101010101010101ull, msbs = 0x8080808080808080ull;
+        uint64 data;
+       #endif
+    };
+
+    // Uninitialised space for an item, so the table can be allocated without constructing any
+    struct alignas (ItemType) ItemStorage
+    {
+        char bytes[sizeof (ItemType)];
+    };
+
+    //==============================================================================
+    uint64 hashFor (KeyTypeParameter key) const noexcept
+    {
+        const auto hash = hashFunctionToUse.generateHash (key, std::numeric_limits<int>::max());
+        jassert (isPositiveAndBelow (hash, std::numeric_limits<int>::max())); // your hash function is generating out-of-range numbers!
+
+        // The hash functions are only expected to spread their keys over the range they're
+        // given, so the bits are mixed before any of them are used to choose a group
+        auto mixed = (uint64) hash * 0x9e3779b97f4a7c15ull;
+        return mixed ^ (mixed >> 29);
+    }
+
+    static int8 h2 (uint64 hash) noexcept               { return (int8) (hash & 0x7f); }
+    size_t firstGroup (uint64 hash) const noexcept      { return (size_t) (hash >> 7) & (capacity / groupSize - 1); }
+
+    ItemType* items() const noexcept                    { return reinterpret_cast<ItemType*> (storage.get()); }
+
+    ItemType* findWithHash (KeyTypeParameter key, uint64 hash) const noexcept
+    {
+        const auto groupMask = capacity / groupSize - 1;
+        auto groupIndex = firstGroup (hash);
+
+        for (size_t probe = 1;; ++probe)
+        {
+            const auto offset = groupIndex * groupSize;
+            const Group group (control.get() + offset);
+
+            for (auto matches = group.match (h2 (hash)); matches; matches.removeLowest())
+            {
+                auto* item = items() + offset + matches.lowestIndex();
+
+                if (item->key == key)
+                    return item;
+            }
+
+            // A group with an empty slot ends every probe sequence that reaches it
+            if (group.matchEmpty())
+                return nullptr;
+
+            groupIndex = (groupIndex + probe) & groupMask;
+        }
+    }
+
+    ItemType* insertNew (uint64 hash, ItemType&& newItem)
+    {
+        const auto index = findInsertPosition (hash);
+
+        if (control[index] == emptyControl)
+            --growthLeft;
+
+        control[index] = h2 (hash);
+        ++numItems;
+
+        return new (items() + index) ItemType (std::move (newItem));
+    }
+
+    ItemType* insertNew (uint64 hash, const ItemType& newItem)
+    {
+        const auto index = findInsertPosition (hash);
+
+        if (control[index] == emptyControl)
+            --growthLeft;
+
+        control[index] = h2 (hash);
+        ++numItems;
+
+        return new (items() + index) ItemType (newItem);
+    }
+
+    size_t findInsertPosition (uint64 hash) const noexcept
+    {
+        const auto groupMask = capacity / groupSize - 1;
+        auto groupIndex = firstGroup (hash);
+
+        for (size_t probe = 1;; ++probe)
+        {
+            const auto offset = groupIndex * groupSize;
+
+            if (auto available = Group (control.get() + offset).matchEmptyOrDeleted())
+                return offset + available.lowestIndex();
+
+            groupIndex = (groupIndex + probe) & groupMask;
+        }
+    }
+
+    void removeAt (size_t index)
+    {
+        items()[index].~ItemType();
+        --numItems;
+
+        // If the item's group still has an empty slot, no probe sequence can have passed
+        // through it, so it can be made empty again rather than leaving a tombstone
+        const auto groupStart = index & ~(groupSize - 1);
+
+        if (Group (control.get() + groupStart).matchEmpty())
+        {
+            control[index] = emptyControl;
+            ++growthLeft;
+        }
+        else
+        {
+            control[index] = deletedControl;
+        }
+    }
+
+    //==============================================================================
+    // Tables are kept at most 7/8 full, so that a probe always finds an empty slot quickly
+    static size_t maxItemsForCapacity (size_t numSlots) noexcept    { return numSlots - numSlots / 8; }
+
+    static size_t capacityForItems (size_t minNumItems) noexcept
+    {
+        size_t numSlots = groupSize;
+
+        while (maxItemsForCapacity (numSlots) < minNumItems)
+            numSlots *= 2;
+
+        return numSlots;
+    }
+
+    void grow()
+    {
+        // If most of the used slots are tombstones, rehashing at the same size is enough
+        const auto newCapacity = (capacity > 0 && numItems < maxItemsForCapacity (capacity) / 2) ? capacity
+                                                                                               : capacityForItems (numItems + 1);
+        rehash (newCapacity);
+    }
+
+    void rehash (size_t newCapacity)
+    {
+        auto oldControl = std::move (control);
+        auto oldStorage = std::move (storage);
+        const auto oldCapacity = capacity;
+        auto* oldItems = reinterpret_cast<ItemType*> (oldStorage.get());
+
+        allocate (newCapacity);
+
+        for (size_t i = 0; i < oldCapacity; ++i)
+        {
+            if (isFull (oldControl[i]))
+            {
+                insertNew (hashFor (oldItems[i].key), std::move (oldItems[i]));
+                oldItems[i].~ItemType();
+            }
+        }
+    }
+
+    void allocate (size_t newCapacity)
+    {
+        capacity = newCapacity;
+        numItems = 0;
+        growthLeft = maxItemsForCapacity (capacity);
+
+        if (capacity == 0)
+            return;
+
+        control.malloc (capacity);
+        storage.malloc (capacity);
+        std::memset (control.get(), emptyControl, capacity);
+    }
+
+    void destroyItems()
+    {
+        if constexpr (! std::is_trivially_destructible_v<ItemType>)
+            for (size_t i = 0; i < capacity; ++i)
+                if (isFull (control[i]))
+                    items()[i].~ItemType();
+    }
+
+    void release()
+    {
+        destroyItems();
+        control.free();
+        storage.free();
+        capacity = numItems = growthLeft = 0;
+    }
+
+    //==============================================================================
+    HashFunctionType hashFunctionToUse;
+    HeapBlock<int8> control;
+    HeapBlock<ItemStorage> storage;
+    size_t capacity = 0, numItems = 0, growthLeft = 0;
+};
+
+} // namespace detail
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, in a flat table that's
+    faster to search and iterate than a HashMap.
+
+    HashMap keeps each item in its own heap allocation, chained from an array of slots,
+    so every lookup follows several pointers. This class stores the keys and values
+    directly in one array, using open addressing, and keeps a separate array of one-byte
+    tags taken from each key's hash. Lookups compare a whole group of tags at once using
+    SIMD instructions where they're available, and only compare keys whose tags match,
+    so a lookup usually touches just two cache lines.
+
+    It uses the same hash functions as HashMap, so it works with any key type that
+    DefaultHashFunctions supports, including Identifiers, which are hashed by address.
+    Unlike HashMap, it has no built-in lock, and adding or removing items can move the
+    other items, so any pointers or iterators to them become invalid.
+
+    @code
+    FlatHashMap<Identifier, int> map;
+    map.set ("gain", 1);
+    map.set ("pan", 2);
+
+    DBG (map["gain"]); // prints "1"
+
+    for (auto i = map.begin(); i != map.end(); ++i)
+        DBG (i.getKey().toString() << " -> " << i.getValue());
+    @endcode
+
+    @see HashMap, FlatHashSet, DefaultHashFunctions
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultHashFunctions>
+class FlatHashMap
+{
+private:
+    using KeyTypeParameter   = typename TypeHelpers::ParameterType<KeyType>::type;
+    using ValueTypeParameter = typename TypeHelpers::ParameterType<ValueType>::type;
+
+    struct Item
+    {
+        KeyType key;
+        ValueType value {};
+    };
+
+    using Table = detail::FlatHashTable<KeyType, Item, HashFunctionType>;
+
+public:
+    //==============================================================================
+    /** Creates an empty map. No memory is allocated until the first item is added. */
+    explicit FlatHashMap (HashFunctionType hashFunction = HashFunctionType())
+        : table (std::move (hashFunction))
+    {
+    }
+
+    FlatHashMap (const FlatHashMap&) = default;
+    FlatHashMap (FlatHashMap&&) noexcept = default;
+    FlatHashMap& operator= (const FlatHashMap&) = default;
+    FlatHashMap& operator= (FlatHashMap&&) noexcept = default;
+
+    //==============================================================================
+    /** Removes all values from the map, but keeps the memory that it's using. */
+    void clear()                                        { table.clear(); }
+
+    /** Returns the current number of items in the map. */
+    int size() const noexcept                           { return table.size(); }
+
+    /** Returns true if the map is empty. */
+    bool isEmpty() const noexcept                       { return table.size() == 0; }
+
+    /** Makes sure the map can hold at least this many items without reallocating. */
+    void ensureStorageAllocated (int minNumItems)       { table.ensureStorageAllocated (minNumItems); }
+
+    /** Returns the number of items that the map could hold in its current storage,
+        if they were spread perfectly.
+    */
+    int getCapacity() const noexcept                    { return table.getCapacity(); }
+
+    //==============================================================================
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+    */
+    ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        if (auto* item = table.find (keyToLookFor))
+            return item->value;
+
+        return ValueType();
+    }
+
+    /** Returns a reference to the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is
+        added to the map and a reference to this is returned.
+    */
+    ValueType& getReference (KeyTypeParameter keyToLookFor)
+    {
+        return table.findOrInsert (keyToLookFor).first->value;
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the
+        map doesn't contain it. The pointer is only valid until the map is next modified.
+    */
+    ValueType* getValuePointer (KeyTypeParameter keyToLookFor) noexcept
+    {
+        if (auto* item = table.find (keyToLookFor))
+            return &item->value;
+
+        return nullptr;
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the
+        map doesn't contain it. The pointer is only valid until the map is next modified.
+    */
+    const ValueType* getValuePointer (KeyTypeParameter keyToLookFor) const noexcept
+    {
+        if (auto* item = table.find (keyToLookFor))
+            return &item->value;
+
+        return nullptr;
+    }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the specified key. */
+    bool contains (KeyTypeParameter keyToLookFor) const noexcept
+    {
+        return table.find (keyToLookFor) != nullptr;
+    }
+
+    /** Returns true if the map contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        for (auto i = begin(); i != end(); ++i)
+            if (i.getValue() == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an element in the map.
+        If there's already an item with the given key, this will replace its value.
+        Otherwise, a new item will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)        { getReference (newKey) = newValue; }
+
+    /** Removes an item with the given key, and returns true if there was one. */
+    bool remove (KeyTypeParameter keyToRemove)          { return table.remove (keyToRemove); }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        table.removeIf ([&] (const Item& item) { return item.value == valueToRemove; });
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& other) noexcept         { table.swapWith (other.table); }
+
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        The order in which items are iterated bears no resemblance to the order in which
+        they were originally added, and as soon as you add or remove an item, any iterators
+        that were created beforehand will cease to be valid, and should not be used.
+    */
+    template <bool isConst>
+    class IteratorBase
+    {
+    public:
+        using MapType = std::conditional_t<isConst, const FlatHashMap, FlatHashMap>;
+        using ValueReference = std::conditional_t<isConst, const ValueType&, ValueType&>;
+
+        IteratorBase (MapType& mapToIterate, size_t startIndex) noexcept
+            : map (&mapToIterate), index (map->table.findNextItem (startIndex))
+        {}
+
+        /** Returns the current item's key. */
+        const KeyType& getKey() const noexcept          { return map->table.getItem (index)->key; }
+
+        /** Returns the current item's value. */
+        ValueReference getValue() const noexcept        { return map->table.getItem (index)->value; }
+
+        IteratorBase& operator++() noexcept             { index = map->table.findNextItem (index + 1); return *this; }
+        ValueReference operator*() const noexcept       { return getValue(); }
+        bool operator== (const IteratorBase& other) const noexcept  { return index == other.index; }
+        bool operator!= (const IteratorBase& other) const noexcept  { return index != other.index; }
+
+    private:
+        MapType* map;
+        size_t index;
+    };
+
+    using Iterator = IteratorBase<false>;
+    using ConstIterator = IteratorBase<true>;
+
+    /** Returns a start iterator for the values in this map. */
+    Iterator begin() noexcept                           { return { *this, 0 }; }
+
+    /** Returns an end iterator for the values in this map. */
+    Iterator end() noexcept                             { return { *this, table.getNumSlots() }; }
+
+    /** Returns a start iterator for the values in this map. */
+    ConstIterator begin() const noexcept                { return { *this, 0 }; }
+
+    /** Returns an end iterator for the values in this map. */
+    ConstIterator end() const noexcept                  { return { *this, table.getNumSlots() }; }
+
+private:
+    //==============================================================================
+    Table table;
+
+    JUCE_LEAK_DETECTOR (FlatHashMap)
+};
+
+} // namespace juce
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of unique keys in a flat hash table.
+
+    This uses the same open-addressing table as FlatHashMap, so checking whether a key
+    is in the set is much faster than searching a SortedSet, and doesn't need the keys
+    to be ordered. The order of iteration bears no resemblance to the order in which the
+    keys were added, and adding or removing a key invalidates any iterators.
+
+    @code
+    FlatHashSet<Identifier> seen;
+
+    for (auto& property : object.getProperties())
+        if (! seen.add (property.name))
+            DBG ("duplicate: " << property.name.toString());
+    @endcode
+
+    @see FlatHashMap, SortedSet, DefaultHashFunctions
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          class HashFunctionType = DefaultHashFunctions>
+class FlatHashSet
+{
+private:
+    using KeyTypeParameter = typename TypeHelpers::ParameterType<KeyType>::type;
+
+    struct Item
+    {
+        KeyType key;
+    };
+
+    using Table = detail::FlatHashTable<KeyType, Item, HashFunctionType>;
+
+public:
+    //==============================================================================
+    /** Creates an empty set. No memory is allocated until the first key is added. */
+    explicit FlatHashSet (HashFunctionType hashFunction = HashFunctionType())
+        : table (std::move (hashFunction))
+    {
+    }
+
+    /** Creates a set containing some keys. */
+    FlatHashSet (std::initializer_list<KeyType> keys)
+        : table (HashFunctionType())
+    {
+        table.ensureStorageAllocated ((int) keys.size());
+
+        for (auto& key : keys)
+            add (key);
+    }
+
+    FlatHashSet (const FlatHashSet&) = default;
+    FlatHashSet (FlatHashSet&&) noexcept = default;
+    FlatHashSet& operator= (const FlatHashSet&) = default;
+    FlatHashSet& operator= (FlatHashSet&&) noexcept = default;
+
+    //==============================================================================
+    /** Removes all keys from the set, but keeps the memory that it's using. */
+    void clear()                                        { table.clear(); }
+
+    /** Returns the number of keys in the set. */
+    int size() const noexcept                           { return table.size(); }
+
+    /** Returns true if the set is empty. */
+    bool isEmpty() const noexcept                       { return table.size() == 0; }
+
+    /** Makes sure the set can hold at least this many keys without reallocating. */
+    void ensureStorageAllocated (int minNumKeys)        { table.ensureStorageAllocated (minNumKeys); }
+
+    //==============================================================================
+    /** Returns true if the set contains the given key. */
+    bool contains (KeyTypeParameter keyToLookFor) const noexcept
+    {
+        return table.find (keyToLookFor) != nullptr;
+    }
+
+    /** Adds a key to the set, and returns true if it wasn't already there. */
+    bool add (KeyTypeParameter newKey)                  { return table.findOrInsert (newKey).second; }
+
+    /** Removes a key from the set, and returns true if it was there. */
+    bool remove (KeyTypeParameter keyToRemove)          { return table.remove (keyToRemove); }
+
+    /** Efficiently swaps the contents of two sets. */
+    void swapWith (FlatHashSet& other) noexcept         { table.swapWith (other.table); }
+
+    //==============================================================================
+    /** Iterates over the keys in a FlatHashSet. */
+    class Iterator
+    {
+    public:
+        Iterator (const FlatHashSet& setToIterate, size_t startIndex) noexcept
+            : set (&setToIterate), index (set->table.findNextItem (startIndex))
+        {}
+
+        Iterator& operator++() noexcept                 { index = set->table.findNextItem (index + 1); return *this; }
+        const KeyType& operator*() const noexcept       { return set->table.getItem (index)->key; }
+        bool operator== (const Iterator& other) const noexcept  { return index == other.index; }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+
+    private:
+        const FlatHashSet* set;
+        size_t index;
+    };
+
+    /** Returns a start iterator for the keys in this set. */
+    Iterator begin() const noexcept                     { return { *this, 0 }; }
+
+    /** Returns an end iterator for the keys in this set. */
+    Iterator end() const noexcept                       { return { *this, table.getNumSlots() }; }
+
+private:
+    //==============================================================================
+    Table table;
+
+    JUCE_LEAK_DETECTOR (FlatHashSet)
+};
+
+} // namespace juce
@@ -66,6 +66,17 @@ struct DefaultHashFunctions
     static int generateHash (const void* key, int upperLimit) noexcept      { return generateHash ((uint64) (pointer_sized_uint) key, upperLimit); }
     /** Generates a simple hash from a UUID. */
     static int generateHash (const Uuid& key, int upperLimit) noexcept      { return generateHash (key.hash(), upperLimit); }
+    /** Generates a hash from an Identifier. Identifiers are pooled, so this uses the address of the name. */
+    static int generateHash (const Identifier& key, int upperLimit) noexcept
+    {
+        // The low bits of a heap address are always the same, and the rest only vary a little
+        // between names that were allocated together, so they're mixed before being reduced
+        auto bits = (uint64) (pointer_sized_uint) key.getCharPointer().getAddress() >> 4;
+        bits ^= bits >> 33;
+        bits *= 0xff51afd7ed558ccdull;
+        bits ^= bits >> 33;
+        return generateHash (bits, upperLimit);
+    }
 };
 
 
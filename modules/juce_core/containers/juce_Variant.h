@@ -287,8 +287,9 @@ public:
 
     //==============================================================================
     /** Writes a binary representation of this value to a stream.
-        The data can be read back later using readFromStream().
-        @see JSON
+        The data can be read back later using readFromStream(). For large values that only
+        need to be partly read, BinaryVarDocument provides an indexed format instead.
+        @see JSON, BinaryVarDocument
     */
     void writeToStream (OutputStream& output) const;
 
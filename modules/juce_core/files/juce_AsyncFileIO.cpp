@@ -0,0 +1,312 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+AsyncFile::AsyncFile (const File& fileToOpen, AccessMode mode, bool bypassCache)
+    : file (fileToOpen), accessMode (mode)
+{
+    jassert (mode == readOnly || mode == readWrite);
+    openHandle (bypassCache);
+}
+
+AsyncFile::~AsyncFile()
+{
+    closeHandle();
+}
+
+//==============================================================================
+AsyncFile::AlignedBuffer::AlignedBuffer (size_t minimumSize)
+    : size ((minimumSize + alignment - 1) & ~(alignment - 1))
+{
+    if (size > 0)
+    {
+       #if JUCE_WINDOWS
+        data = static_cast<uint8*> (_aligned_malloc (size, alignment));
+       #else
+        void* memory = nullptr;
+
+        if (posix_memalign (&memory, alignment, size) == 0)
+            data = static_cast<uint8*> (memory);
+       #endif
+
+        if (data == nullptr)
+            size = 0;
+    }
+}
+
+AsyncFile::AlignedBuffer::~AlignedBuffer()
+{
+   #if JUCE_WINDOWS
+    _aligned_free (data);
+   #else
+    free (data);
+   #endif
+}
+
+AsyncFile::AlignedBuffer::AlignedBuffer (AlignedBuffer&& other) noexcept
+    : data (std::exchange (other.data, nullptr)),
+      size (std::exchange (other.size, 0))
+{
+}
+
+AsyncFile::AlignedBuffer& AsyncFile::AlignedBuffer::operator= (AlignedBuffer&& other) noexcept
+{
+    std::swap (data, other.data);
+    std::swap (size, other.size);
+    return *this;
+}
+
+//==============================================================================
+namespace
+{
+    // The engine whose callback this thread is running, if any
+    thread_local const AsyncFileIO* engineInCallback = nullptr;
+}
+
+struct AsyncFileIO::Request
+{
+    AsyncFile* file = nullptr;
+    int64 position = 0;
+    uint8* buffer = nullptr;
+    size_t numBytes = 0, numBytesDone = 0;
+    bool isWrite = false;
+    Callback callback;
+    int index = 0;
+};
+
+class AsyncFileIO::Backend
+{
+public:
+    virtual ~Backend() = default;
+
+    // Starts a batch of requests. Each one must end with a call to AsyncFileIO::complete().
+    virtual void start (Request* const* requestsToStart, int numRequests) = 0;
+};
+
+//==============================================================================
+class AsyncFileIO::ThreadPoolBackend final : public AsyncFileIO::Backend
+{
+public:
+    ThreadPoolBackend (AsyncFileIO& io, int numThreads)
+        : owner (io),
+          pool (ThreadPoolOptions{}.withThreadName ("AsyncFileIO")
+                                   .withNumberOfThreads (jmax (1, numThreads)))
+    {
+    }
+
+    void start (Request* const* requestsToStart, int numRequests) override
+    {
+        for (int i = 0; i < numRequests; ++i)
+            pool.addJob ([this, request = requestsToStart[i]] { perform (*request); });
+    }
+
+private:
+    AsyncFileIO& owner;
+    ThreadPool pool;
+
+    void perform (Request& request)
+    {
+        if (request.isWrite)
+        {
+            auto result = request.file->write (request.position, request.buffer, request.numBytes);
+            request.numBytesDone = result.wasOk() ? request.numBytes : 0;
+            owner.complete (request, result);
+        }
+        else
+        {
+            auto result = request.file->read (request.position, request.buffer, request.numBytes, request.numBytesDone);
+            owner.complete (request, result);
+        }
+    }
+};
+
+#if ! (JUCE_LINUX && JUCE_USE_IO_URING)
+std::unique_ptr<AsyncFileIO::Backend> AsyncFileIO::createIOUringBackend (AsyncFileIO&, int)
+{
+    return {};
+}
+#endif
+
+//==============================================================================
+AsyncFileIO::AsyncFileIO (const AsyncFileIOOptions& options)
+    : requests ((size_t) jmax (1, options.queueDepth))
+{
+    const auto queueDepth = (int) requests.size();
+
+    freeRequests.reserve ((size_t) queueDepth);
+    queuedRequests.reserve ((size_t) queueDepth);
+
+    for (int i = queueDepth; --i >= 0;)
+    {
+        requests[(size_t) i].index = i;
+        freeRequests.push_back (i);
+    }
+
+    if (options.useIOUring)
+        backend = createIOUringBackend (*this, queueDepth);
+
+    usingIOUring = (backend != nullptr);
+
+    if (backend == nullptr)
+        backend = std::make_unique<ThreadPoolBackend> (*this, options.numberOfThreads);
+}
+
+AsyncFileIO::~AsyncFileIO()
+{
+    waitForAll();
+    backend.reset();
+}
+
+void AsyncFileIO::read (AsyncFile& file, int64 position, void* destBuffer, size_t numBytes, Callback onCompletion)
+{
+    queue (file, position, destBuffer, numBytes, false, std::move (onCompletion));
+}
+
+void AsyncFileIO::write (AsyncFile& file, int64 position, const void* sourceData, size_t numBytes, Callback onCompletion)
+{
+    // You can't write to a file that was opened as read-only!
+    jassert (file.getAccessMode() == AsyncFile::readWrite);
+
+    queue (file, position, const_cast<void*> (sourceData), numBytes, true, std::move (onCompletion));
+}
+
+void AsyncFileIO::queue (AsyncFile& file, int64 position, void* buffer, size_t numBytes, bool isWrite, Callback onCompletion)
+{
+    // When a file is bypassing the cache, the OS can only transfer whole, aligned blocks
+    jassert (! file.isBypassingCache() || AsyncFile::isAligned (position, buffer, numBytes));
+    jassert (position >= 0);
+
+    if (! file.openedOk())
+    {
+        if (onCompletion != nullptr)
+            onCompletion (file.getStatus(), 0);
+
+        return;
+    }
+
+    std::unique_lock<std::mutex> sl (lock);
+
+    while (freeRequests.empty())
+    {
+        if (! queuedRequests.empty())
+        {
+            sl.unlock();
+            submit();
+            sl.lock();
+        }
+        else
+        {
+            // A callback can't wait for a free place in the queue, because it may be running on the
+            // only thread that could report the transfer that frees one. Each callback can queue one
+            // transfer without waiting, in the place that its own transfer has given back.
+            jassert (engineInCallback != this);
+
+            requestFinished.wait (sl);
+        }
+    }
+
+    auto& request = requests[(size_t) freeRequests.back()];
+    freeRequests.pop_back();
+
+    request.file = &file;
+    request.position = position;
+    request.buffer = static_cast<uint8*> (buffer);
+    request.numBytes = numBytes;
+    request.numBytesDone = 0;
+    request.isWrite = isWrite;
+    request.callback = std::move (onCompletion);
+
+    queuedRequests.push_back (request.index);
+}
+
+int AsyncFileIO::submit()
+{
+    std::vector<Request*> batch;
+
+    {
+        const std::lock_guard<std::mutex> sl (lock);
+        batch.reserve (queuedRequests.size());
+
+        for (auto index : queuedRequests)
+            batch.push_back (&requests[(size_t) index]);
+
+        queuedRequests.clear();
+    }
+
+    if (! batch.empty())
+        backend->start (batch.data(), (int) batch.size());
+
+    return (int) batch.size();
+}
+
+void AsyncFileIO::complete (Request& request, const Result& result)
+{
+    auto callback = std::exchange (request.callback, nullptr);
+    const auto numBytesDone = request.numBytesDone;
+
+    // The request is given back before the callback is called, so that the callback can queue another one
+    {
+        const std::lock_guard<std::mutex> sl (lock);
+        request.file = nullptr;
+        freeRequests.push_back (request.index);
+        ++numCallbacksRunning;
+    }
+
+    requestFinished.notify_all();
+
+    if (callback != nullptr)
+    {
+        const auto* previousEngine = std::exchange (engineInCallback, this);
+        callback (result, numBytesDone);
+        engineInCallback = previousEngine;
+    }
+
+    // This notifies with the lock held, because waitForAll() may return and the engine be deleted as soon as it's released
+    const std::lock_guard<std::mutex> sl (lock);
+    --numCallbacksRunning;
+    requestFinished.notify_all();
+}
+
+bool AsyncFileIO::waitForAll (int timeOutMilliseconds)
+{
+    submit();
+
+    std::unique_lock<std::mutex> sl (lock);
+    const auto allFinished = [this] { return freeRequests.size() == requests.size() && numCallbacksRunning == 0; };
+
+    if (timeOutMilliseconds < 0)
+    {
+        requestFinished.wait (sl, allFinished);
+        return true;
+    }
+
+    return requestFinished.wait_for (sl, std::chrono::milliseconds (timeOutMilliseconds), allFinished);
+}
+
+int AsyncFileIO::getNumPending() const
+{
+    const std::lock_guard<std::mutex> sl (lock);
+    return (int) (requests.size() - freeRequests.size());
+}
+
+} // namespace juce
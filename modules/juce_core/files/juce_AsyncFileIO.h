@@ -0,0 +1,329 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An open file that can be read and written at any position, from several threads
+    at once, without a shared file pointer.
+
+    This is the file type that AsyncFileIO works with, but its read() and write()
+    methods can also be called directly, in which case they block until they're done.
+
+    If the file is opened with bypassCache set to true, the OS is asked not to keep
+    the file's data in its cache (O_DIRECT on Linux, F_NOCACHE on macOS and
+    FILE_FLAG_NO_BUFFERING on Windows). This avoids an extra copy of every byte and
+    stops a large stream from pushing everything else out of the cache, but the file
+    positions, sizes and buffer addresses of every transfer then have to be multiples
+    of AsyncFile::alignment - an AlignedBuffer is the easiest way to get suitable memory.
+    Not every file system can do this, in which case the file is opened normally and
+    isBypassingCache() returns false.
+
+    @see AsyncFileIO, AsyncFileInputStream, AsyncFileOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncFile
+{
+public:
+    /** The read/write flags used when opening the file. */
+    enum AccessMode
+    {
+        readOnly,   /**< The file must exist, and can only be read. */
+        readWrite   /**< The file is created if it doesn't exist, and can be read and written.
+                         Any existing content is kept. */
+    };
+
+    //==============================================================================
+    /** Opens a file.
+        Use openedOk() or getStatus() to find out whether this succeeded.
+    */
+    AsyncFile (const File& file, AccessMode mode, bool bypassCache = false);
+
+    /** Destructor.
+        Any transfers that were queued for this file must have finished before it is deleted.
+    */
+    ~AsyncFile();
+
+    //==============================================================================
+    /** Returns the file that was opened. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the status of the file, which will show an error if it couldn't be opened. */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the file was opened successfully. */
+    bool openedOk() const noexcept                      { return status.wasOk(); }
+
+    /** Returns the mode that the file was opened with. */
+    AccessMode getAccessMode() const noexcept           { return accessMode; }
+
+    /** Returns true if transfers are going straight to and from the disk, in which case
+        they must be aligned to AsyncFile::alignment.
+    */
+    bool isBypassingCache() const noexcept              { return bypassingCache; }
+
+    /** Returns the current size of the file in bytes. */
+    int64 getSize() const;
+
+    //==============================================================================
+    /** Reads a block of data from the given position, blocking until it has been read.
+
+        Fewer bytes than were asked for are read only when the end of the file is reached.
+
+        @returns an error if the read failed
+    */
+    Result read (int64 position, void* destBuffer, size_t numBytes, size_t& numBytesRead) const;
+
+    /** Writes a block of data at the given position, blocking until all of it has been written.
+        The file grows if the block goes past its end.
+
+        @returns an error if the write failed
+    */
+    Result write (int64 position, const void* sourceData, size_t numBytes);
+
+    /** Truncates or extends the file to the given size.
+        This doesn't need to be aligned, even if the file is bypassing the cache.
+    */
+    Result setSize (int64 newSize);
+
+    /** Waits for everything that has been written to reach the disk. */
+    Result flush();
+
+    //==============================================================================
+    /** The alignment that positions, sizes and buffers must have when the file is
+        bypassing the cache.
+    */
+    static constexpr size_t alignment = 4096;
+
+    /** Returns true if a transfer with these parameters can be used with a file that's
+        bypassing the cache.
+    */
+    static bool isAligned (int64 position, const void* buffer, size_t numBytes) noexcept
+    {
+        return (position % (int64) alignment) == 0
+            && (((pointer_sized_uint) buffer) % alignment) == 0
+            && (numBytes % alignment) == 0;
+    }
+
+    //==============================================================================
+    /**
+        A block of memory whose address and size are multiples of AsyncFile::alignment.
+
+        @tags{Core}
+    */
+    class JUCE_API  AlignedBuffer
+    {
+    public:
+        /** Creates an empty buffer. */
+        AlignedBuffer() = default;
+
+        /** Allocates a buffer of at least the given size, which is rounded up to a
+            multiple of AsyncFile::alignment. The contents are not cleared.
+        */
+        explicit AlignedBuffer (size_t minimumSize);
+
+        /** Destructor. */
+        ~AlignedBuffer();
+
+        AlignedBuffer (AlignedBuffer&&) noexcept;
+        AlignedBuffer& operator= (AlignedBuffer&&) noexcept;
+
+        /** Returns the buffer's memory. */
+        uint8* getData() const noexcept                 { return data; }
+
+        /** Returns the size of the buffer in bytes. */
+        size_t getSize() const noexcept                 { return size; }
+
+    private:
+        uint8* data = nullptr;
+        size_t size = 0;
+
+        JUCE_DECLARE_NON_COPYABLE (AlignedBuffer)
+    };
+
+private:
+    //==============================================================================
+    const File file;
+    void* fileHandle = nullptr;
+    Result status { Result::ok() };
+    const AccessMode accessMode;
+    bool bypassingCache = false;
+
+    void openHandle (bool bypassCache);
+    void closeHandle();
+
+    friend class AsyncFileIO;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFile)
+};
+
+//==============================================================================
+/**
+    Options used to create an AsyncFileIO.
+
+    @tags{Core}
+*/
+struct AsyncFileIOOptions
+{
+    /** The number of threads that perform transfers when io_uring isn't being used.
+        Reads on different disks, or on SSDs, can overlap, so more threads let more of
+        them be in flight at once.
+    */
+    [[nodiscard]] AsyncFileIOOptions withNumberOfThreads (int newNumberOfThreads) const
+    {
+        return withMember (*this, &AsyncFileIOOptions::numberOfThreads, newNumberOfThreads);
+    }
+
+    /** The most transfers that can be queued or in flight at once. Queueing another one
+        when this many are outstanding waits until one of them finishes.
+    */
+    [[nodiscard]] AsyncFileIOOptions withQueueDepth (int newQueueDepth) const
+    {
+        return withMember (*this, &AsyncFileIOOptions::queueDepth, newQueueDepth);
+    }
+
+    /** Whether to use io_uring on Linux, when the kernel supports it and juce_core was
+        built with JUCE_USE_IO_URING enabled. When it's disabled or unavailable, a pool
+        of threads performs the transfers instead.
+    */
+    [[nodiscard]] AsyncFileIOOptions withIOUringEnabled (bool shouldUseIOUring) const
+    {
+        return withMember (*this, &AsyncFileIOOptions::useIOUring, shouldUseIOUring);
+    }
+
+    int numberOfThreads { 2 };
+    int queueDepth { 64 };
+    bool useIOUring { true };
+};
+
+//==============================================================================
+/**
+    Performs reads and writes on AsyncFile objects in the background, and calls a
+    function when each one has finished.
+
+    Transfers are queued with read() and write(), and then handed to the OS together
+    when submit() is called, so a whole batch costs a single system call. On Linux,
+    io_uring is used, so no threads are blocked while the disk is busy. Elsewhere, or
+    if io_uring isn't available, a pool of threads performs the transfers.
+
+    @code
+    AsyncFileIO io;
+    AsyncFile file (sampleFile, AsyncFile::readOnly);
+
+    for (auto& voice : voices)
+        io.read (file, voice.nextPosition, voice.buffer, voice.bufferSize,
+                 [&voice] (const Result& result, size_t numBytesRead) { voice.bufferArrived (result, numBytesRead); });
+
+    io.submit();
+    @endcode
+
+    The callbacks are called on a background thread. They can queue and submit more
+    transfers, but mustn't wait for other transfers to finish, because the thread that
+    would report them may be the one that's waiting. A transfer's place in the queue is
+    given back before its callback is called, so a callback can always queue at least one
+    more transfer without waiting, even when the queue depth is 1.
+
+    Buffers and files have to stay valid until their transfers have finished.
+
+    @see AsyncFile, AsyncFileInputStream, AsyncFileOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncFileIO
+{
+public:
+    //==============================================================================
+    /** Creates an engine, starting its background threads. */
+    explicit AsyncFileIO (const AsyncFileIOOptions& options = {});
+
+    /** Destructor.
+        Any queued transfers are submitted, and the destructor waits for all of them to finish.
+    */
+    ~AsyncFileIO();
+
+    //==============================================================================
+    /** The function called when a transfer has finished.
+
+        The result shows whether it failed. A read can transfer fewer bytes than were asked
+        for if it reaches the end of the file; a successful write always transfers them all.
+    */
+    using Callback = std::function<void (const Result& result, size_t numBytesTransferred)>;
+
+    /** Queues a read, which will start when submit() is called.
+
+        If as many transfers as the queue depth are already outstanding, this waits for one
+        of them to finish first.
+    */
+    void read (AsyncFile& file, int64 position, void* destBuffer, size_t numBytes, Callback onCompletion);
+
+    /** Queues a write, which will start when submit() is called.
+
+        If as many transfers as the queue depth are already outstanding, this waits for one
+        of them to finish first.
+    */
+    void write (AsyncFile& file, int64 position, const void* sourceData, size_t numBytes, Callback onCompletion);
+
+    /** Starts all the transfers that have been queued since the last call.
+        @returns the number of transfers that were started
+    */
+    int submit();
+
+    /** Submits anything that's queued and waits for every outstanding transfer to finish,
+        including calling its callback.
+
+        @param timeOutMilliseconds  the longest time to wait, or -1 to wait forever
+        @returns true if everything finished within the time limit
+    */
+    bool waitForAll (int timeOutMilliseconds = -1);
+
+    /** Returns the number of transfers that are queued or in flight. */
+    int getNumPending() const;
+
+    /** Returns true if the transfers are being done by io_uring rather than by a pool of threads. */
+    bool isUsingIOUring() const noexcept                { return usingIOUring; }
+
+private:
+    //==============================================================================
+    struct Request;
+    class Backend;
+    class ThreadPoolBackend;
+    class IOUringBackend;
+
+    std::vector<Request> requests;
+    std::vector<int> freeRequests, queuedRequests;
+    int numCallbacksRunning = 0;
+    mutable std::mutex lock;
+    std::condition_variable requestFinished;
+    std::unique_ptr<Backend> backend;
+    bool usingIOUring = false;
+
+    void queue (AsyncFile&, int64, void*, size_t, bool, Callback);
+    void complete (Request&, const Result&);
+
+    static std::unique_ptr<Backend> createIOUringBackend (AsyncFileIO&, int queueDepth);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileIO)
+};
+
+} // namespace juce
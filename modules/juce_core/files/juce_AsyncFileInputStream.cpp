@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+AsyncFileInputStream::AsyncFileInputStream (const File& fileToRead, AsyncFileIO* ioEngine, bool bypassCache,
+                                            size_t bufferSizeToUse, int numBuffers)
+    : file (fileToRead, AsyncFile::readOnly, bypassCache),
+      ownedEngine (ioEngine == nullptr ? std::make_unique<AsyncFileIO> (AsyncFileIOOptions{}.withQueueDepth (jmax (1, numBuffers)))
+                                       : nullptr),
+      io (ioEngine != nullptr ? *ioEngine : *ownedEngine),
+      bufferSize ((jmax ((size_t) 1, bufferSizeToUse) + AsyncFile::alignment - 1) & ~(AsyncFile::alignment - 1)),
+      buffers ((size_t) jmax (1, numBuffers)),
+      status (file.getStatus())
+{
+    if (status.wasOk())
+    {
+        totalLength = file.getSize();
+
+        for (auto& buffer : buffers)
+            buffer.data = AsyncFile::AlignedBuffer (bufferSize);
+
+        prefetch (0);
+    }
+}
+
+AsyncFileInputStream::~AsyncFileInputStream()
+{
+    std::unique_lock<std::mutex> sl (lock);
+    readFinished.wait (sl, [this] { return numInFlight == 0; });
+}
+
+//==============================================================================
+void AsyncFileInputStream::prefetch (int64 firstBlock)
+{
+    lastPrefetchBlock = firstBlock;
+    auto numStarted = 0;
+
+    for (int i = 0; i < (int) buffers.size(); ++i)
+    {
+        const auto blockNumber = firstBlock + i;
+        const auto position = blockNumber * (int64) bufferSize;
+
+        if (position >= totalLength)
+            break;
+
+        auto& buffer = buffers[(size_t) (blockNumber % (int64) buffers.size())];
+
+        {
+            const std::lock_guard<std::mutex> sl (lock);
+
+            if (buffer.blockNumber == blockNumber || buffer.inFlight)
+                continue;
+
+            buffer.blockNumber = blockNumber;
+            buffer.numBytesValid = 0;
+            buffer.inFlight = true;
+            ++numInFlight;
+        }
+
+        io.read (file, position, buffer.data.getData(), bufferSize, [this, &buffer] (const Result& result, size_t numBytesRead)
+        {
+            const std::lock_guard<std::mutex> sl (lock);
+            buffer.numBytesValid = numBytesRead;
+            buffer.result = result;
+            buffer.inFlight = false;
+            --numInFlight;
+            readFinished.notify_all();
+        });
+
+        ++numStarted;
+    }
+
+    if (numStarted > 0)
+        io.submit();
+}
+
+const AsyncFileInputStream::Buffer* AsyncFileInputStream::waitForBlock (int64 blockNumber)
+{
+    auto& buffer = buffers[(size_t) (blockNumber % (int64) buffers.size())];
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> sl (lock);
+            readFinished.wait (sl, [&buffer] { return ! buffer.inFlight; });
+
+            if (buffer.blockNumber == blockNumber)
+            {
+                if (buffer.result.failed())
+                {
+                    status = buffer.result;
+                    return nullptr;
+                }
+
+                break;
+            }
+        }
+
+        // The buffer held a different block, which means the stream has moved somewhere new
+        prefetch (blockNumber);
+    }
+
+    // Keep the blocks after this one coming while it's being read
+    if (blockNumber != lastPrefetchBlock)
+        prefetch (blockNumber);
+
+    return &buffer;
+}
+
+//==============================================================================
+int64 AsyncFileInputStream::getTotalLength()
+{
+    return totalLength;
+}
+
+int AsyncFileInputStream::read (void* destBuffer, int maxBytesToRead)
+{
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    if (status.failed())
+        return 0;
+
+    auto numBytesRead = 0;
+
+    while (numBytesRead < maxBytesToRead && currentPosition < totalLength)
+    {
+        const auto blockNumber = currentPosition / (int64) bufferSize;
+        auto* buffer = waitForBlock (blockNumber);
+
+        if (buffer == nullptr)
+            break;
+
+        const auto offsetInBlock = (size_t) (currentPosition - blockNumber * (int64) bufferSize);
+
+        // The file has got shorter since the stream was opened
+        if (offsetInBlock >= buffer->numBytesValid)
+            break;
+
+        const auto numToCopy = (int) jmin ((size_t) (maxBytesToRead - numBytesRead), buffer->numBytesValid - offsetInBlock);
+        memcpy (addBytesToPointer (destBuffer, numBytesRead), buffer->data.getData() + offsetInBlock, (size_t) numToCopy);
+
+        numBytesRead += numToCopy;
+        currentPosition += numToCopy;
+    }
+
+    return numBytesRead;
+}
+
+bool AsyncFileInputStream::isExhausted()
+{
+    return currentPosition >= totalLength;
+}
+
+int64 AsyncFileInputStream::getPosition()
+{
+    return currentPosition;
+}
+
+bool AsyncFileInputStream::setPosition (int64 pos)
+{
+    currentPosition = jlimit ((int64) 0, totalLength, pos);
+    return true;
+}
+
+} // namespace juce
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An input stream that reads from a file ahead of the current position.
+
+    The file is read in blocks by an AsyncFileIO, keeping several of them in flight
+    beyond the one that's being read, so a thread that reads the file sequentially
+    only has to wait when it gets ahead of the disk.
+
+    The stream can move to any position, after which the blocks around the new
+    position are fetched.
+
+    @see AsyncFileOutputStream, AsyncFileIO, FileInputStream
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncFileInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileInputStream to read from the given file.
+
+        After creating one, you should use openedOk() or failedToOpen() to make sure it
+        opened the file successfully before reading from it.
+
+        @param fileToRead       the file to read
+        @param ioEngine         the engine that performs the reads, which must outlive the
+                                stream. If this is nullptr, the stream creates its own.
+        @param bypassCache      whether to ask the OS not to cache the file's data - see AsyncFile
+        @param bufferSize       the size of each block that's read, which is rounded up to a
+                                multiple of AsyncFile::alignment
+        @param numBuffers       the number of blocks that can be held or in flight at once
+    */
+    explicit AsyncFileInputStream (const File& fileToRead,
+                                   AsyncFileIO* ioEngine = nullptr,
+                                   bool bypassCache = false,
+                                   size_t bufferSize = 256 * 1024,
+                                   int numBuffers = 4);
+
+    /** Destructor.
+        This waits for any reads that are still in flight.
+    */
+    ~AsyncFileInputStream() override;
+
+    //==============================================================================
+    /** Returns the file that this stream is reading from. */
+    const File& getFile() const noexcept                { return file.getFile(); }
+
+    /** Returns the status of the file stream.
+        The result will be ok if the file opened successfully and no errors have occurred
+        reading it. If an error occurs, the result will indicate what went wrong.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason.
+        @see getStatus()
+    */
+    bool failedToOpen() const noexcept                  { return status.failed(); }
+
+    /** Returns true if the stream opened without problems.
+        @see getStatus()
+    */
+    bool openedOk() const noexcept                      { return status.wasOk(); }
+
+    //==============================================================================
+    int64 getTotalLength() override;
+    int read (void*, int) override;
+    bool isExhausted() override;
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+
+private:
+    //==============================================================================
+    struct Buffer
+    {
+        AsyncFile::AlignedBuffer data;
+        int64 blockNumber = -1;
+        size_t numBytesValid = 0;
+        Result result { Result::ok() };
+        bool inFlight = false;
+    };
+
+    AsyncFile file;
+    std::unique_ptr<AsyncFileIO> ownedEngine;
+    AsyncFileIO& io;
+    const size_t bufferSize;
+    std::vector<Buffer> buffers;
+    int64 totalLength = 0, currentPosition = 0, lastPrefetchBlock = -1;
+    Result status;
+
+    std::mutex lock;
+    std::condition_variable readFinished;
+    int numInFlight = 0;
+
+    void prefetch (int64 firstBlock);
+    const Buffer* waitForBlock (int64 blockNumber);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileInputStream)
+};
+
+} // namespace juce
@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+AsyncFileOutputStream::AsyncFileOutputStream (const File& fileToWriteTo, AsyncFileIO* ioEngine, bool bypassCache,
+                                              size_t bufferSizeToUse, int numBuffers)
+    : file (fileToWriteTo, AsyncFile::readWrite, bypassCache),
+      ownedEngine (ioEngine == nullptr ? std::make_unique<AsyncFileIO> (AsyncFileIOOptions{}.withQueueDepth (jmax (1, numBuffers)))
+                                       : nullptr),
+      io (ioEngine != nullptr ? *ioEngine : *ownedEngine),
+      bufferSize ((jmax ((size_t) 1, bufferSizeToUse) + AsyncFile::alignment - 1) & ~(AsyncFile::alignment - 1)),
+      buffers ((size_t) jmax (1, numBuffers)),
+      status (file.getStatus())
+{
+    if (status.wasOk())
+    {
+        status = file.setSize (0);
+
+        for (auto& buffer : buffers)
+            buffer.data = AsyncFile::AlignedBuffer (bufferSize);
+    }
+}
+
+AsyncFileOutputStream::~AsyncFileOutputStream()
+{
+    if (status.wasOk())
+        writeCurrentBuffer();
+
+    waitForWrites();
+
+    if (status.wasOk() && file.isBypassingCache())
+        file.setSize (endOfFile);
+}
+
+//==============================================================================
+void AsyncFileOutputStream::startWrite (Buffer& buffer, size_t numBytes)
+{
+    auto numBytesToWrite = numBytes;
+
+    // Only whole blocks can be written when bypassing the cache, so the end of the
+    // last one is padded, and the file is trimmed back to the right length afterwards
+    if (file.isBypassingCache())
+    {
+        numBytesToWrite = (numBytes + AsyncFile::alignment - 1) & ~(AsyncFile::alignment - 1);
+        zeromem (buffer.data.getData() + numBytes, numBytesToWrite - numBytes);
+    }
+
+    {
+        const std::lock_guard<std::mutex> sl (lock);
+        buffer.inFlight = true;
+        ++numInFlight;
+    }
+
+    io.write (file, bufferPosition, buffer.data.getData(), numBytesToWrite, [this, &buffer] (const Result& result, size_t)
+    {
+        const std::lock_guard<std::mutex> sl (lock);
+
+        if (result.failed() && writeError.wasOk())
+            writeError = result;
+
+        buffer.inFlight = false;
+        --numInFlight;
+        writeFinished.notify_all();
+    });
+}
+
+void AsyncFileOutputStream::writeCurrentBuffer()
+{
+    // The buffer is kept, so that writing more data will write the whole block again
+    if (numBytesInBuffer > 0)
+    {
+        startWrite (buffers[currentBuffer], numBytesInBuffer);
+        io.submit();
+    }
+}
+
+void AsyncFileOutputStream::waitForWrites()
+{
+    std::unique_lock<std::mutex> sl (lock);
+    writeFinished.wait (sl, [this] { return numInFlight == 0; });
+}
+
+bool AsyncFileOutputStream::checkForErrors()
+{
+    if (status.wasOk())
+    {
+        const std::lock_guard<std::mutex> sl (lock);
+
+        if (writeError.failed())
+            status = writeError;
+    }
+
+    return status.wasOk();
+}
+
+//==============================================================================
+void AsyncFileOutputStream::flush()
+{
+    if (! checkForErrors())
+        return;
+
+    writeCurrentBuffer();
+    waitForWrites();
+
+    if (file.isBypassingCache())
+        status = file.setSize (endOfFile);
+
+    if (checkForErrors())
+        status = file.flush();
+}
+
+int64 AsyncFileOutputStream::getPosition()
+{
+    return bufferPosition + (int64) numBytesInBuffer;
+}
+
+bool AsyncFileOutputStream::setPosition (int64 newPosition)
+{
+    if (newPosition == getPosition())
+        return true;
+
+    // A file that bypasses the cache can only be written in whole blocks, so the stream can't move around in it
+    if (file.isBypassingCache() || newPosition < 0 || ! checkForErrors())
+        return false;
+
+    writeCurrentBuffer();
+    waitForWrites();
+
+    bufferPosition = newPosition;
+    numBytesInBuffer = 0;
+
+    return checkForErrors();
+}
+
+bool AsyncFileOutputStream::write (const void* src, size_t numBytes)
+{
+    jassert (src != nullptr && ((ssize_t) numBytes) >= 0);
+
+    if (! checkForErrors())
+        return false;
+
+    while (numBytes > 0)
+    {
+        auto& buffer = buffers[currentBuffer];
+        const auto numToCopy = jmin (numBytes, bufferSize - numBytesInBuffer);
+
+        memcpy (buffer.data.getData() + numBytesInBuffer, src, numToCopy);
+        src = addBytesToPointer (src, numToCopy);
+        numBytes -= numToCopy;
+        numBytesInBuffer += numToCopy;
+        endOfFile = jmax (endOfFile, getPosition());
+
+        if (numBytesInBuffer == bufferSize)
+        {
+            startWrite (buffer, bufferSize);
+            io.submit();
+
+            bufferPosition += (int64) bufferSize;
+            numBytesInBuffer = 0;
+            currentBuffer = (currentBuffer + 1) % buffers.size();
+
+            auto& nextBuffer = buffers[currentBuffer];
+            std::unique_lock<std::mutex> sl (lock);
+            writeFinished.wait (sl, [&nextBuffer] { return ! nextBuffer.inFlight; });
+        }
+    }
+
+    return checkForErrors();
+}
+
+} // namespace juce
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    An output stream that writes to a file in the background.
+
+    Data is collected into blocks, and each full block is handed to an AsyncFileIO
+    to be written while the next one is filled, so the writing thread only has to
+    wait when every block is still on its way to the disk.
+
+    Unlike FileOutputStream, this replaces any existing content of the file rather
+    than appending to it.
+
+    Errors from the background writes are reported by getStatus(), and make later
+    calls to write() return false. Call flush() to make sure that everything has been
+    written and to find out whether it succeeded.
+
+    @see AsyncFileInputStream, AsyncFileIO, FileOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncFileOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileOutputStream to write to the given file, creating it if it
+        doesn't exist and emptying it if it does.
+
+        After creating one, you should use openedOk() or failedToOpen() to make sure it
+        opened the file successfully before writing to it.
+
+        @param fileToWriteTo    the file to write to
+        @param ioEngine         the engine that performs the writes, which must outlive the
+                                stream. If this is nullptr, the stream creates its own.
+        @param bypassCache      whether to ask the OS not to cache the file's data - see AsyncFile.
+                                If the file bypasses the cache, setPosition() can't be used.
+        @param bufferSize       the size of each block that's written, which is rounded up to a
+                                multiple of AsyncFile::alignment
+        @param numBuffers       the number of blocks that can be filled or in flight at once
+    */
+    explicit AsyncFileOutputStream (const File& fileToWriteTo,
+                                    AsyncFileIO* ioEngine = nullptr,
+                                    bool bypassCache = false,
+                                    size_t bufferSize = 256 * 1024,
+                                    int numBuffers = 4);
+
+    /** Destructor.
+        This writes out any remaining data and waits for it to be written, but doesn't
+        wait for it to reach the disk - call flush() for that.
+    */
+    ~AsyncFileOutputStream() override;
+
+    //==============================================================================
+    /** Returns the file that this stream is writing to. */
+    const File& getFile() const noexcept                { return file.getFile(); }
+
+    /** Returns the status of the file stream.
+        The result will be ok if the file opened successfully and no errors have occurred
+        writing it. If an error occurs, the result will indicate what went wrong.
+    */
+    const Result& getStatus() const noexcept            { return status; }
+
+    /** Returns true if the stream couldn't be opened for some reason.
+        @see getStatus()
+    */
+    bool failedToOpen() const noexcept                  { return status.failed(); }
+
+    /** Returns true if the stream opened without problems.
+        @see getStatus()
+    */
+    bool openedOk() const noexcept                      { return status.wasOk(); }
+
+    //==============================================================================
+    /** Writes out everything that has been written to the stream, waits for it to be
+        written, and then waits for it to reach the disk.
+    */
+    void flush() override;
+
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    struct Buffer
+    {
+        AsyncFile::AlignedBuffer data;
+        bool inFlight = false;
+    };
+
+    AsyncFile file;
+    std::unique_ptr<AsyncFileIO> ownedEngine;
+    AsyncFileIO& io;
+    const size_t bufferSize;
+    std::vector<Buffer> buffers;
+    size_t currentBuffer = 0, numBytesInBuffer = 0;
+    int64 bufferPosition = 0, endOfFile = 0;
+    Result status;
+
+    std::mutex lock;
+    std::condition_variable writeFinished;
+    Result writeError { Result::ok() };
+    int numInFlight = 0;
+
+    void startWrite (Buffer&, size_t numBytes);
+    void writeCurrentBuffer();
+    void waitForWrites();
+    bool checkForErrors();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileOutputStream)
+};
+
+} // namespace juce
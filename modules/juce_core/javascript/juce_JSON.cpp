@@ -527,6 +527,56 @@ Result JSON::parse (const String& text, var& result)
     return Result::ok();
 }
 
+Result JSON::parseUTF8 (std::string_view utf8Text, var& result)
+{
+    JSONReader reader (utf8Text.data(), utf8Text.size());
+    result = var();
+
+    switch (reader.next())
+    {
+        case JSONReader::Token::endOfInput:
+            return Result::ok();
+
+        case JSONReader::Token::beginObject:
+        case JSONReader::Token::beginArray:
+        {
+            auto value = reader.readValue();
+
+            if (reader.getCurrentToken() == JSONReader::Token::error)
+                return reader.getError();
+
+            result = std::move (value);
+            return Result::ok();
+        }
+
+        case JSONReader::Token::error:
+            return reader.getError();
+
+        default:
+            break;
+    }
+
+    int line = 1, column = 1;
+
+    for (size_t i = 0; i < (size_t) reader.getPosition(); ++i)
+    {
+        if (utf8Text[i] == '\n')  { column = 1; ++line; }
+        else                      { ++column; }
+    }
+
+    return Result::fail (String (line) + ":" + String (column) + ": error: Expected '{' or '['");
+}
+
+var JSON::parseUTF8 (std::string_view utf8Text)
+{
+    var result;
+
+    if (parseUTF8 (utf8Text, result))
+        return result;
+
+    return {};
+}
+
 String JSON::toString (const var& data, const bool allOnOneLine, int maximumDecimalPlaces)
 {
     return toString (data, FormatOptions{}.withSpacing (allOnOneLine ? Spacing::singleLine : Spacing::multiLine)
@@ -48,7 +48,10 @@ namespace juce
     functions allow you to parse JSON into a var object, and to convert a var
     object to JSON-formatted text.
 
-    @see var
+    To read or write large documents without holding them in memory as a var, use
+    JSONReader and JSONWriter.
+
+    @see var, JSONReader, JSONWriter
 
     @tags{Core}
 */
@@ -105,6 +108,26 @@ public:
     */
     static var parse (InputStream& input);
 
+    /** Parses some UTF-8 JSON text without copying it into a String first, and returns a
+        result code containing any parse errors.
+
+        The text doesn't need to be null-terminated, so this can be used on part of a larger
+        buffer. It's read by a JSONReader, so unlike parse(), it only accepts strict JSON
+        (for example, strings must use double quotes). As with parse(), the text must
+        contain an object or an array, and anything after it is ignored.
+
+        @see JSONReader
+    */
+    static Result parseUTF8 (std::string_view utf8Text, var& parsedResult);
+
+    /** Parses some UTF-8 JSON text without copying it into a String first, and returns the
+        result as a var object.
+
+        If the parsing fails, this simply returns var() - if you need to find out more
+        detail about the parse error, use the alternative parseUTF8() method which returns a Result.
+    */
+    static var parseUTF8 (std::string_view utf8Text);
+
     enum class Spacing
     {
         none,           ///< All optional whitespace should be omitted
@@ -0,0 +1,806 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #include <emmintrin.h>
+ #define JUCE_JSON_READER_USE_SSE2 1
+#elif JUCE_ARM && defined (__ARM_NEON) && defined (__aarch64__)
+ #include <arm_neon.h>
+ #define JUCE_JSON_READER_USE_NEON 1
+#endif
+
+namespace juce
+{
+
+namespace JSONReaderHelpers
+{
+    static bool isWhitespace (char c) noexcept
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    static bool isDigit (char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool isNumberChar (char c) noexcept
+    {
+        return isDigit (c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    // Returns the first character in the range that isn't whitespace
+    static const char* findEndOfWhitespace (const char* p, const char* end) noexcept
+    {
+        // Most tokens are separated by a single space or nothing at all, so it's only
+        // worth scanning in blocks for the indentation of a multi-line document
+        if (p == end || ! isWhitespace (*p))
+            return p;
+
+        ++p;
+
+       #if JUCE_JSON_READER_USE_SSE2
+        const auto space = _mm_set1_epi8 (' '), tab = _mm_set1_epi8 ('\t');
+        const auto newLine = _mm_set1_epi8 ('\n'), carriageReturn = _mm_set1_epi8 ('\r');
+
+        for (; end - p >= 16; p += 16)
+        {
+            const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+            const auto isSpace = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, space), _mm_cmpeq_epi8 (chunk, tab)),
+                                               _mm_or_si128 (_mm_cmpeq_epi8 (chunk, newLine), _mm_cmpeq_epi8 (chunk, carriageReturn)));
+
+            if (_mm_movemask_epi8 (isSpace) != 0xffff)
+                break;
+        }
+       #elif JUCE_JSON_READER_USE_NEON
+        const auto space = vdupq_n_u8 (' '), tab = vdupq_n_u8 ('\t');
+        const auto newLine = vdupq_n_u8 ('\n'), carriageReturn = vdupq_n_u8 ('\r');
+
+        for (; end - p >= 16; p += 16)
+        {
+            const auto chunk = vld1q_u8 (reinterpret_cast<const uint8_t*> (p));
+            const auto isSpace = vorrq_u8 (vorrq_u8 (vceqq_u8 (chunk, space), vceqq_u8 (chunk, tab)),
+                                           vorrq_u8 (vceqq_u8 (chunk, newLine), vceqq_u8 (chunk, carriageReturn)));
+
+            if (vminvq_u8 (isSpace) == 0)
+                break;
+        }
+       #else
+        for (; end - p >= 8; p += 8)
+        {
+            uint64 word;
+            std::memcpy (&word, p, sizeof (word));
+
+            if (word != 0x2020202020202020ull)
+                break;
+        }
+       #endif
+
+        while (p != end && isWhitespace (*p))
+            ++p;
+
+        return p;
+    }
+
+    // Returns the first quote or backslash in the range, or the end of the range
+    static const char* findQuoteOrBackslash (const char* p, const char* end) noexcept
+    {
+       #if JUCE_JSON_READER_USE_SSE2
+        const auto quote = _mm_set1_epi8 ('"'), backslash = _mm_set1_epi8 ('\\');
+
+        for (; end - p >= 16; p += 16)
+        {
+            const auto chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+
+            if (_mm_movemask_epi8 (_mm_or_si128 (_mm_cmpeq_epi8 (chunk, quote), _mm_cmpeq_epi8 (chunk, backslash))) != 0)
+                break;
+        }
+       #elif JUCE_JSON_READER_USE_NEON
+        const auto quote = vdupq_n_u8 ('"'), backslash = vdupq_n_u8 ('\\');
+
+        for (; end - p >= 16; p += 16)
+        {
+            const auto chunk = vld1q_u8 (reinterpret_cast<const uint8_t*> (p));
+
+            if (vmaxvq_u8 (vorrq_u8 (vceqq_u8 (chunk, quote), vceqq_u8 (chunk, backslash))) != 0)
+                break;
+        }
+       #else
+        constexpr uint64 ones = 0x0101010101010101ull, highBits = 0x8080808080808080ull;
+        const auto hasZeroByte = [] (uint64 v) { return ((v - ones) & ~v & highBits) != 0; };
+
+        for (; end - p >= 8; p += 8)
+        {
+            uint64 word;
+            std::memcpy (&word, p, sizeof (word));
+
+            if (hasZeroByte (word ^ (ones * '"')) || hasZeroByte (word ^ (ones * '\\')))
+                break;
+        }
+       #endif
+
+        while (p != end && *p != '"' && *p != '\\')
+            ++p;
+
+        return p;
+    }
+
+    static bool readHexValue (const char*& p, const char* end, juce_wchar& result) noexcept
+    {
+        if (end - p < 4)
+            return false;
+
+        result = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            const auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) *p++);
+
+            if (digitValue < 0)
+                return false;
+
+            result = (juce_wchar) ((result << 4) + (juce_wchar) digitValue);
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+JSONReader::JSONReader (const void* data, size_t numBytes)
+    : buffer (static_cast<const char*> (data)),
+      bufferSize (data != nullptr ? numBytes : 0)
+{
+}
+
+JSONReader::JSONReader (const File& file)
+    : mappedFile (std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly))
+{
+    if (mappedFile->getData() != nullptr)
+    {
+        buffer = static_cast<const char*> (mappedFile->getData());
+        bufferSize = mappedFile->getSize();
+        return;
+    }
+
+    // An empty file can't be mapped, and some file systems don't support it
+    mappedFile.reset();
+    ownedStream = file.createInputStream();
+
+    if (ownedStream != nullptr)
+    {
+        setStream (*ownedStream, 65536);
+    }
+    else
+    {
+        errorMessage = "Couldn't open " + file.getFullPathName();
+        currentToken = Token::error;
+    }
+}
+
+JSONReader::JSONReader (InputStream& source, size_t bufferSizeBytes)
+{
+    setStream (source, bufferSizeBytes);
+}
+
+JSONReader::~JSONReader() = default;
+
+void JSONReader::setStream (InputStream& source, size_t bufferSizeBytes)
+{
+    stream = &source;
+    streamBufferCapacity = jmax ((size_t) 64, bufferSizeBytes);
+    streamBuffer.malloc (streamBufferCapacity);
+    buffer = streamBuffer;
+}
+
+//==============================================================================
+JSONReader::Token JSONReader::next()
+{
+    if (currentToken == Token::error)
+        return currentToken;
+
+    if (! started)
+    {
+        started = true;
+
+        if (ensureAvailable (3) && std::memcmp (buffer + position, "\xef\xbb\xbf", 3) == 0)
+            position += 3;
+    }
+
+    currentToken = readNextToken();
+    return currentToken;
+}
+
+JSONReader::Token JSONReader::readNextToken()
+{
+    const auto atEnd = ! skipWhitespace();
+    tokenStart = position;
+
+    if (atEnd)
+        return state == State::topLevel ? Token::endOfInput : fail ("Unexpected end of input");
+
+    const auto c = buffer[position];
+    const auto inObject = ! containers.empty() && containers.back();
+
+    switch (state)
+    {
+        case State::topLevel:
+        case State::value:
+            return readValueToken();
+
+        case State::valueOrEnd:
+            if (c == (inObject ? '}' : ']'))
+                return closeContainer();
+
+            return inObject ? readName() : readValueToken();
+
+        case State::name:
+            return readName();
+
+        case State::colon:
+            if (c != ':')
+                return fail ("Expected ':'");
+
+            ++position;
+            state = State::value;
+            return readNextToken();
+
+        case State::commaOrEnd:
+            if (c == ',')
+            {
+                ++position;
+                state = inObject ? State::name : State::value;
+                return readNextToken();
+            }
+
+            if (c == (inObject ? '}' : ']'))
+                return closeContainer();
+
+            return fail (inObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+    }
+
+    return fail ("Syntax error");
+}
+
+JSONReader::Token JSONReader::readValueToken()
+{
+    switch (buffer[position])
+    {
+        case '{':
+            ++position;
+            containers.push_back (true);
+            state = State::valueOrEnd;
+            return Token::beginObject;
+
+        case '[':
+            ++position;
+            containers.push_back (false);
+            state = State::valueOrEnd;
+            return Token::beginArray;
+
+        case '"':
+            return readString (Token::string);
+
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return readNumber();
+
+        case 't':
+            currentBool = true;
+            return readLiteral ("true", 4, Token::boolean);
+
+        case 'f':
+            currentBool = false;
+            return readLiteral ("false", 5, Token::boolean);
+
+        case 'n':
+            return readLiteral ("null", 4, Token::null);
+
+        default:
+            break;
+    }
+
+    return fail ("Syntax error");
+}
+
+JSONReader::Token JSONReader::readName()
+{
+    if (buffer[position] != '"')
+        return fail ("Expected a property name in double-quotes");
+
+    return readString (Token::propertyName);
+}
+
+JSONReader::Token JSONReader::readString (Token token)
+{
+    ++position;
+    bool hasEscapes = false;
+
+    for (;;)
+    {
+        position = (size_t) (JSONReaderHelpers::findQuoteOrBackslash (buffer + position, buffer + bufferSize) - buffer);
+
+        if (position == bufferSize)
+        {
+            if (! refill())
+                return fail ("Unexpected end of input in string");
+
+            continue;
+        }
+
+        if (buffer[position] == '"')
+            break;
+
+        // A backslash, so skip over the character after it, which might be a quote
+        hasEscapes = true;
+
+        if (! ensureAvailable (2))
+            return fail ("Unexpected end of input in string");
+
+        position += 2;
+    }
+
+    const auto contentStart = tokenStart + 1, contentEnd = position;
+    ++position;
+
+    if (hasEscapes)
+    {
+        if (! unescape (contentStart, contentEnd))
+            return Token::error;
+    }
+    else
+    {
+        currentString = std::string_view (buffer + contentStart, contentEnd - contentStart);
+    }
+
+    if (token == Token::propertyName)
+    {
+        state = State::colon;
+        return token;
+    }
+
+    return finishValue (token);
+}
+
+bool JSONReader::unescape (size_t start, size_t end)
+{
+    // The unescaped text is never longer than the original
+    const auto length = end - start;
+
+    if (unescapedCapacity < length)
+    {
+        unescapedCapacity = jmax (length, unescapedCapacity * 2, (size_t) 256);
+        unescaped.malloc (unescapedCapacity);
+    }
+
+    auto* dest = unescaped.get();
+    auto* s = buffer + start;
+    auto* e = buffer + end;
+
+    while (s < e)
+    {
+        auto* backslash = static_cast<const char*> (std::memchr (s, '\\', (size_t) (e - s)));
+
+        if (backslash == nullptr)
+            backslash = e;
+
+        std::memcpy (dest, s, (size_t) (backslash - s));
+        dest += backslash - s;
+
+        if (backslash == e)
+            break;
+
+        s = backslash + 1;
+        const auto c = *s++;
+
+        switch (c)
+        {
+            case 'a':  *dest++ = '\a'; break;
+            case 'b':  *dest++ = '\b'; break;
+            case 'f':  *dest++ = '\f'; break;
+            case 'n':  *dest++ = '\n'; break;
+            case 'r':  *dest++ = '\r'; break;
+            case 't':  *dest++ = '\t'; break;
+
+            case 'u':
+            {
+                juce_wchar character = 0;
+
+                if (! JSONReaderHelpers::readHexValue (s, e, character))
+                {
+                    position = (size_t) (backslash - buffer);
+                    fail ("Syntax error in unicode escape sequence");
+                    return false;
+                }
+
+                // Join up a UTF-16 surrogate pair
+                if (character >= 0xd800 && character <= 0xdbff && e - s >= 6 && s[0] == '\\' && s[1] == 'u')
+                {
+                    auto* lowSurrogateText = s + 2;
+                    juce_wchar lowSurrogate = 0;
+
+                    if (JSONReaderHelpers::readHexValue (lowSurrogateText, e, lowSurrogate)
+                         && lowSurrogate >= 0xdc00 && lowSurrogate <= 0xdfff)
+                    {
+                        character = (juce_wchar) (0x10000 + ((character - 0xd800) << 10) + (lowSurrogate - 0xdc00));
+                        s = lowSurrogateText;
+                    }
+                }
+
+                CharPointer_UTF8 utf8 (dest);
+                utf8.write (character);
+                dest = utf8.getAddress();
+                break;
+            }
+
+            default:
+                *dest++ = c;
+                break;
+        }
+    }
+
+    currentString = std::string_view (unescaped.get(), (size_t) (dest - unescaped.get()));
+    return true;
+}
+
+JSONReader::Token JSONReader::readNumber()
+{
+    using namespace JSONReaderHelpers;
+
+    auto end = position;
+
+    for (;;)
+    {
+        while (end < bufferSize && isNumberChar (buffer[end]))
+            ++end;
+
+        if (end < bufferSize)
+            break;
+
+        const auto numScanned = end - tokenStart;
+        const auto gotMore = refill();
+        end = tokenStart + numScanned;
+
+        if (! gotMore)
+            break;
+    }
+
+    const auto* text = buffer + position;
+    const auto length = end - position;
+    size_t i = 0;
+
+    const auto negative = text[0] == '-';
+
+    if (negative)
+        ++i;
+
+    if (i == length || ! isDigit (text[i]))
+        return fail ("Syntax error in number");
+
+    uint64 magnitude = 0;
+    bool isInteger = true;
+
+    if (text[i] == '0')
+    {
+        ++i;
+    }
+    else
+    {
+        for (; i < length && isDigit (text[i]); ++i)
+        {
+            const auto digit = (uint64) (text[i] - '0');
+
+            if (magnitude > (std::numeric_limits<uint64>::max() - digit) / 10)
+                isInteger = false;
+            else
+                magnitude = magnitude * 10 + digit;
+        }
+    }
+
+    if (i < length && text[i] == '.')
+    {
+        isInteger = false;
+
+        if (++i == length || ! isDigit (text[i]))
+            return fail ("Syntax error in number");
+
+        while (i < length && isDigit (text[i]))
+            ++i;
+    }
+
+    if (i < length && (text[i] == 'e' || text[i] == 'E'))
+    {
+        isInteger = false;
+
+        if (++i < length && (text[i] == '+' || text[i] == '-'))
+            ++i;
+
+        if (i == length || ! isDigit (text[i]))
+            return fail ("Syntax error in number");
+
+        while (i < length && isDigit (text[i]))
+            ++i;
+    }
+
+    if (i != length)
+    {
+        position += i;
+        return fail ("Syntax error in number");
+    }
+
+    const auto maxMagnitude = (uint64) std::numeric_limits<int64>::max() + (negative ? 1 : 0);
+
+    currentIsInteger = isInteger && magnitude <= maxMagnitude;
+    currentInteger = negative ? (int64) (0 - magnitude) : (int64) magnitude;
+    currentString = std::string_view (text, length);
+
+    position = end;
+    return finishValue (Token::number);
+}
+
+JSONReader::Token JSONReader::readLiteral (const char* text, size_t length, Token token)
+{
+    if (! ensureAvailable (length) || std::memcmp (buffer + position, text, length) != 0)
+        return fail ("Syntax error");
+
+    position += length;
+    return finishValue (token);
+}
+
+JSONReader::Token JSONReader::finishValue (Token token)
+{
+    state = containers.empty() ? State::topLevel : State::commaOrEnd;
+    return token;
+}
+
+JSONReader::Token JSONReader::closeContainer()
+{
+    ++position;
+    const auto wasObject = containers.back();
+    containers.pop_back();
+    return finishValue (wasObject ? Token::endObject : Token::endArray);
+}
+
+JSONReader::Token JSONReader::fail (const char* message)
+{
+    errorMessage = message;
+    errorLine = linesBeforeBuffer;
+    errorColumn = columnAtBufferStart;
+
+    for (size_t i = 0; i < jmin (position, bufferSize); ++i)
+    {
+        if (buffer[i] == '\n')
+        {
+            ++errorLine;
+            errorColumn = 1;
+        }
+        else
+        {
+            ++errorColumn;
+        }
+    }
+
+    return Token::error;
+}
+
+//==============================================================================
+bool JSONReader::skipWhitespace()
+{
+    for (;;)
+    {
+        position = (size_t) (JSONReaderHelpers::findEndOfWhitespace (buffer + position, buffer + bufferSize) - buffer);
+
+        if (position < bufferSize)
+            return true;
+
+        tokenStart = position;
+
+        if (! refill())
+            return false;
+    }
+}
+
+bool JSONReader::ensureAvailable (size_t numBytes)
+{
+    while (bufferSize - position < numBytes)
+        if (! refill())
+            return false;
+
+    return true;
+}
+
+bool JSONReader::refill()
+{
+    if (stream == nullptr)
+        return false;
+
+    // Everything before the start of the current token can be thrown away
+    if (const auto numToDiscard = tokenStart; numToDiscard > 0)
+    {
+        linesBeforeBuffer += (int) std::count (buffer, buffer + numToDiscard, '\n');
+
+        auto lineStart = numToDiscard;
+
+        while (lineStart > 0 && buffer[lineStart - 1] != '\n')
+            --lineStart;
+
+        columnAtBufferStart = (lineStart > 0 ? 1 : columnAtBufferStart) + (int) (numToDiscard - lineStart);
+
+        std::memmove (streamBuffer, streamBuffer + numToDiscard, bufferSize - numToDiscard);
+        bufferSize -= numToDiscard;
+        position -= numToDiscard;
+        tokenStart = 0;
+        bufferStartPosition += (int64) numToDiscard;
+    }
+
+    // If a single token fills the buffer, it needs to grow
+    if (bufferSize == streamBufferCapacity)
+    {
+        streamBufferCapacity *= 2;
+        streamBuffer.realloc (streamBufferCapacity);
+        buffer = streamBuffer;
+    }
+
+    const auto numRead = stream->read (streamBuffer + bufferSize, (int) jmin ((size_t) std::numeric_limits<int>::max(),
+                                                                             streamBufferCapacity - bufferSize));
+
+    if (numRead <= 0)
+        return false;
+
+    bufferSize += (size_t) numRead;
+    return true;
+}
+
+//==============================================================================
+int64 JSONReader::getInt64() const noexcept
+{
+    if (currentIsInteger)
+        return currentInteger;
+
+    const auto value = getDouble();
+
+    if (value >= 9.2233720368547758e18)
+        return std::numeric_limits<int64>::max();
+
+    if (value <= -9.2233720368547758e18)
+        return std::numeric_limits<int64>::min();
+
+    return (int64) value;
+}
+
+double JSONReader::getDouble() const noexcept
+{
+    if (currentIsInteger)
+        return (double) currentInteger;
+
+    // The number needs to be null-terminated, so it's copied first
+    char text[128];
+
+    if (currentString.size() >= sizeof (text))
+        return String::fromUTF8 (currentString.data(), (int) currentString.size()).getDoubleValue();
+
+    std::memcpy (text, currentString.data(), currentString.size());
+    text[currentString.size()] = 0;
+
+    CharPointer_ASCII t (text);
+    return CharacterFunctions::readDoubleValue (t);
+}
+
+void JSONReader::skipValue()
+{
+    if (currentToken != Token::beginObject && currentToken != Token::beginArray)
+        return;
+
+    for (const auto depth = containers.size(); containers.size() >= depth;)
+    {
+        const auto token = next();
+
+        if (token == Token::error || token == Token::endOfInput)
+            return;
+    }
+}
+
+var JSONReader::readValue()
+{
+    switch (currentToken)
+    {
+        case Token::beginObject:
+        {
+            auto* object = new DynamicObject();
+            var result (object);
+
+            while (next() == Token::propertyName)
+            {
+                if (currentString.empty())
+                {
+                    currentToken = fail ("Invalid property name");
+                    return {};
+                }
+
+                const Identifier name (String::fromUTF8 (currentString.data(), (int) currentString.size()));
+                next();
+
+                auto value = readValue();
+
+                if (currentToken == Token::error)
+                    return {};
+
+                object->setProperty (name, std::move (value));
+            }
+
+            return currentToken == Token::endObject ? result : var();
+        }
+
+        case Token::beginArray:
+        {
+            Array<var> items;
+
+            while (next() != Token::endArray)
+            {
+                if (currentToken == Token::error)
+                    return {};
+
+                items.add (readValue());
+            }
+
+            return items;
+        }
+
+        case Token::string:
+            return String::fromUTF8 (currentString.data(), (int) currentString.size());
+
+        case Token::number:
+            if (! currentIsInteger)
+                return getDouble();
+
+            if (currentInteger >= std::numeric_limits<int>::min() && currentInteger <= std::numeric_limits<int>::max())
+                return (int) currentInteger;
+
+            return currentInteger;
+
+        case Token::boolean:
+            return currentBool;
+
+        case Token::endOfInput:
+        case Token::error:
+        case Token::endObject:
+        case Token::endArray:
+        case Token::propertyName:
+        case Token::null:
+            break;
+    }
+
+    return {};
+}
+
+Result JSONReader::getError() const
+{
+    if (currentToken != Token::error)
+        return Result::ok();
+
+    if (errorLine <= 0)
+        return Result::fail (errorMessage);
+
+    return Result::fail (String (errorLine) + ":" + String (errorColumn) + ": error: " + errorMessage);
+}
+
+} // namespace juce
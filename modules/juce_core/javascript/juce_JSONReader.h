@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads JSON as a sequence of tokens, without building a var for the whole document.
+
+    Each call to next() reads the next token, such as the start of an object, a
+    property name or a number, and the methods of the reader return its value. Strings
+    are returned as views of UTF-8 text, pointing straight into the source wherever
+    they don't contain any escape sequences, so reading a document doesn't need to
+    allocate anything per value. The text is scanned several bytes at a time when
+    skipping whitespace and looking for the end of a string.
+
+    The source can be a block of memory, a file, which is memory-mapped, or an
+    InputStream, which is read in chunks into a buffer. Only the buffer needs to stay in
+    memory, so documents much larger than the available memory can be read.
+
+    @code
+    JSONReader reader (file);
+
+    while (reader.next() != JSONReader::Token::endOfInput)
+    {
+        if (reader.getCurrentToken() == JSONReader::Token::propertyName && reader.getString() == "presets")
+        {
+            reader.next();              // the beginArray token
+            auto presets = reader.readValue();
+        }
+        else if (reader.getCurrentToken() == JSONReader::Token::error)
+        {
+            DBG (reader.getError().getErrorMessage());
+            break;
+        }
+    }
+    @endcode
+
+    The views returned by getString() and the raw text of numbers are only valid until
+    the next call to next().
+
+    A source can contain several values one after another, as in JSON Lines files, and
+    next() returns endOfInput once they've all been read.
+
+    @see JSON, JSONWriter
+
+    @tags{Core}
+*/
+class JUCE_API  JSONReader
+{
+public:
+    //==============================================================================
+    /** The kinds of token that the reader returns. */
+    enum class Token
+    {
+        endOfInput,     /**< There's nothing left to read. */
+        error,          /**< The input wasn't valid JSON. Use getError() to find out why. */
+        beginObject,    /**< A '{' */
+        endObject,      /**< A '}' */
+        beginArray,     /**< A '[' */
+        endArray,       /**< A ']' */
+        propertyName,   /**< The name of a property in an object. Use getString() to get it. */
+        string,         /**< A string value. Use getString() to get it. */
+        number,         /**< A number. Use isInteger(), getInt64() and getDouble() to get its value. */
+        boolean,        /**< A true or false value. Use getBool() to get it. */
+        null            /**< A null value. */
+    };
+
+    //==============================================================================
+    /** Creates a reader for a block of UTF-8 text.
+        The data isn't copied, so it must stay valid for the lifetime of the reader.
+    */
+    JSONReader (const void* data, size_t numBytes);
+
+    /** Creates a reader for a file, which will be memory-mapped if possible. */
+    explicit JSONReader (const File& file);
+
+    /** Creates a reader that pulls its input from a stream.
+
+        The stream is read in blocks of the given size, and the buffer only grows if a single
+        token is bigger than that. The stream must stay valid for the lifetime of the reader.
+    */
+    explicit JSONReader (InputStream& source, size_t bufferSizeBytes = 65536);
+
+    /** Destructor. */
+    ~JSONReader();
+
+    //==============================================================================
+    /** Reads the next token and returns it.
+        Once an error has been found, this keeps returning Token::error.
+    */
+    Token next();
+
+    /** Returns the token that was returned by the last call to next(). */
+    Token getCurrentToken() const noexcept             { return currentToken; }
+
+    /** Returns the text of the current propertyName or string token as UTF-8, with any
+        escape sequences replaced. For a number, this returns the text of the number.
+    */
+    std::string_view getString() const noexcept         { return currentString; }
+
+    /** Returns true if the current number has no fraction or exponent, and fits into an int64. */
+    bool isInteger() const noexcept                     { return currentIsInteger; }
+
+    /** Returns the value of the current number as an integer.
+        If it isn't an integer, this returns it rounded towards zero.
+    */
+    int64 getInt64() const noexcept;
+
+    /** Returns the value of the current number as a double. */
+    double getDouble() const noexcept;
+
+    /** Returns the value of the current boolean token. */
+    bool getBool() const noexcept                       { return currentBool; }
+
+    /** Returns the number of objects and arrays that the current token is inside.
+        A beginObject or beginArray token counts as being inside its own container.
+    */
+    int getDepth() const noexcept                       { return (int) containers.size(); }
+
+    //==============================================================================
+    /** If the current token is a beginObject or beginArray, this skips to its matching
+        end token. Otherwise this does nothing.
+    */
+    void skipValue();
+
+    /** Reads the current value into a var.
+
+        If the current token is a beginObject or beginArray, this reads the whole object
+        or array, leaving the reader at its end token, so this can be used to load a part
+        of a document as a var. A property name or end token returns a void var.
+    */
+    var readValue();
+
+    /** Returns the error that stopped the reader, or Result::ok() if there hasn't been one. */
+    Result getError() const;
+
+    /** Returns the position in the source at which the current token starts, in bytes. */
+    int64 getPosition() const noexcept                  { return bufferStartPosition + (int64) tokenStart; }
+
+private:
+    //==============================================================================
+    enum class State : uint8
+    {
+        topLevel,
+        valueOrEnd,
+        value,
+        name,
+        colon,
+        commaOrEnd
+    };
+
+    void setStream (InputStream&, size_t);
+
+    Token readNextToken();
+    Token readValueToken();
+    Token readName();
+    Token readString (Token);
+    Token readNumber();
+    Token readLiteral (const char* text, size_t length, Token);
+    Token finishValue (Token);
+    Token closeContainer();
+    Token fail (const char* message);
+
+    bool skipWhitespace();
+    bool refill();
+    bool ensureAvailable (size_t numBytes);
+    bool unescape (size_t start, size_t end);
+
+    const char* buffer = nullptr;
+    size_t bufferSize = 0, position = 0, tokenStart = 0;
+    int64 bufferStartPosition = 0;
+    int linesBeforeBuffer = 1, columnAtBufferStart = 1;
+
+    InputStream* stream = nullptr;
+    std::unique_ptr<InputStream> ownedStream;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    HeapBlock<char> streamBuffer, unescaped;
+    size_t streamBufferCapacity = 0, unescapedCapacity = 0;
+
+    std::vector<bool> containers;
+    State state = State::topLevel;
+    bool started = false;
+
+    Token currentToken = Token::endOfInput;
+    std::string_view currentString;
+    int64 currentInteger = 0;
+    bool currentIsInteger = false, currentBool = false;
+
+    String errorMessage;
+    int errorLine = 0, errorColumn = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONReader)
+};
+
+} // namespace juce
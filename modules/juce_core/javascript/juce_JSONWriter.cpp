@@ -0,0 +1,418 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONWriter::JSONWriter (OutputStream& destination, const JSON::FormatOptions& formatOptions)
+    : out (destination),
+      format (formatOptions),
+      newLineString (destination.getNewLineString().toStdString())
+{
+    levels.reserve (32);
+}
+
+JSONWriter::~JSONWriter()
+{
+    // All the objects and arrays should have been ended!
+    jassert (levels.empty());
+
+    flush();
+}
+
+//==============================================================================
+void JSONWriter::beginObject()
+{
+    beginContainer (true, '{');
+
+    // An object always starts on a new line, even when it's empty
+    if (format.getSpacing() == JSON::Spacing::multiLine)
+        write (newLineString.data(), newLineString.size());
+}
+
+void JSONWriter::endObject()
+{
+    endContainer (true, '}');
+}
+
+void JSONWriter::beginArray()
+{
+    beginContainer (false, '[');
+}
+
+void JSONWriter::endArray()
+{
+    endContainer (false, ']');
+}
+
+void JSONWriter::writeName (std::string_view utf8Name)
+{
+    // Names can only be written inside an object, and each one needs a value!
+    jassert (! levels.empty() && levels.back().isObject && ! hasName);
+
+    if (levels.empty())
+        return;
+
+    writeSeparator (levels.back());
+
+    write ('"');
+    writeEscaped (utf8Name.data(), utf8Name.data() + utf8Name.size());
+    write ("\":", 2);
+
+    if (format.getSpacing() != JSON::Spacing::none)
+        write (' ');
+
+    hasName = true;
+}
+
+//==============================================================================
+void JSONWriter::writeString (std::string_view utf8Text)
+{
+    beginValue();
+    write ('"');
+    writeEscaped (utf8Text.data(), utf8Text.data() + utf8Text.size());
+    write ('"');
+}
+
+void JSONWriter::writeString (const String& text)
+{
+    writeString (std::string_view (text.toRawUTF8(), text.getNumBytesAsUTF8()));
+}
+
+void JSONWriter::writeInt (int64 value)
+{
+    beginValue();
+
+    char text[24];
+    auto* end = text + sizeof (text);
+    auto* start = end;
+    auto magnitude = value < 0 ? (uint64) 0 - (uint64) value : (uint64) value;
+
+    do
+    {
+        *--start = (char) ('0' + (char) (magnitude % 10));
+        magnitude /= 10;
+    }
+    while (magnitude > 0);
+
+    if (value < 0)
+        *--start = '-';
+
+    write (start, (size_t) (end - start));
+}
+
+void JSONWriter::writeDouble (double value)
+{
+    beginValue();
+
+    if (! juce_isfinite (value))
+    {
+        write ("null", 4);
+        return;
+    }
+
+    char text[NumberToStringConverters::charsNeededForDouble];
+    write (text, serialiseDouble (text, value, format.getMaxDecimalPlaces()));
+}
+
+void JSONWriter::writeBool (bool value)
+{
+    beginValue();
+
+    if (value)
+        write ("true", 4);
+    else
+        write ("false", 5);
+}
+
+void JSONWriter::writeNull()
+{
+    beginValue();
+    write ("null", 4);
+}
+
+void JSONWriter::writeValue (const var& value)
+{
+    if (value.isString())
+    {
+        writeString (value.toString());
+    }
+    else if (value.isVoid())
+    {
+        writeNull();
+    }
+    else if (value.isUndefined())
+    {
+        beginValue();
+        write ("undefined", 9);
+    }
+    else if (value.isBool())
+    {
+        writeBool (static_cast<bool> (value));
+    }
+    else if (value.isDouble())
+    {
+        writeDouble (static_cast<double> (value));
+    }
+    else if (value.isInt() || value.isInt64())
+    {
+        writeInt (static_cast<int64> (value));
+    }
+    else if (auto* array = value.getArray())
+    {
+        beginArray();
+
+        for (auto& item : *array)
+            writeValue (item);
+
+        endArray();
+    }
+    else if (value.isObject())
+    {
+        if (auto* object = value.getDynamicObject())
+        {
+            beginObject();
+
+            for (auto& property : object->getProperties())
+            {
+                const auto& name = property.name.toString();
+                writeName (std::string_view (name.toRawUTF8(), name.getNumBytesAsUTF8()));
+                writeValue (property.value);
+            }
+
+            endObject();
+        }
+        else
+        {
+            jassertfalse; // Only DynamicObjects can be converted to JSON!
+        }
+    }
+    else
+    {
+        // Can't convert these other types of object to JSON!
+        jassert (! (value.isMethod() || value.isBinaryData()));
+
+        const auto text = value.toString();
+        beginValue();
+        write (text.toRawUTF8(), text.getNumBytesAsUTF8());
+    }
+}
+
+//==============================================================================
+void JSONWriter::flush()
+{
+    writeBuffer();
+    out.flush();
+}
+
+//==============================================================================
+void JSONWriter::beginValue()
+{
+    if (levels.empty())
+        return;
+
+    auto& level = levels.back();
+
+    if (level.isObject)
+    {
+        // Inside an object, each value must follow a call to writeName()!
+        jassert (hasName);
+        hasName = false;
+        return;
+    }
+
+    writeSeparator (level);
+}
+
+void JSONWriter::beginContainer (bool isObject, char openingBracket)
+{
+    beginValue();
+    write (openingBracket);
+    levels.push_back ({ isObject, true });
+}
+
+void JSONWriter::endContainer (bool isObject, char closingBracket)
+{
+    // The object or array being ended must match the last one that was started!
+    jassert (! levels.empty() && levels.back().isObject == isObject && ! hasName);
+
+    if (levels.empty())
+        return;
+
+    const auto isEmpty = levels.back().isEmpty;
+    levels.pop_back();
+
+    if (format.getSpacing() == JSON::Spacing::multiLine && (isObject || ! isEmpty))
+    {
+        if (! isEmpty)
+            write (newLineString.data(), newLineString.size());
+
+        writeIndent (levels.size());
+    }
+
+    write (closingBracket);
+}
+
+void JSONWriter::writeSeparator (Level& level)
+{
+    const auto spacing = format.getSpacing();
+
+    if (! level.isEmpty)
+    {
+        write (',');
+
+        if (spacing == JSON::Spacing::singleLine)
+            write (' ');
+        else if (spacing == JSON::Spacing::multiLine)
+            write (newLineString.data(), newLineString.size());
+    }
+    else if (! level.isObject && spacing == JSON::Spacing::multiLine)
+    {
+        write (newLineString.data(), newLineString.size());
+    }
+
+    level.isEmpty = false;
+
+    if (spacing == JSON::Spacing::multiLine)
+        writeIndent (levels.size());
+}
+
+void JSONWriter::writeIndent (size_t depth)
+{
+    for (auto numSpaces = (size_t) format.getIndentLevel() + depth * JSONFormatter::indentSize; numSpaces > 0;)
+    {
+        if (bufferUsed == sizeof (buffer))
+            writeBuffer();
+
+        const auto numToWrite = jmin (numSpaces, sizeof (buffer) - bufferUsed);
+        std::memset (buffer + bufferUsed, ' ', numToWrite);
+        bufferUsed += numToWrite;
+        numSpaces -= numToWrite;
+    }
+}
+
+void JSONWriter::writeEscaped (const char* text, const char* end)
+{
+    while (text < end)
+    {
+        // Copy the longest run of characters that don't need escaping in one go
+        auto* runEnd = text;
+
+        while (runEnd < end && *runEnd >= 32 && *runEnd < 127 && *runEnd != '"' && *runEnd != '\\')
+            ++runEnd;
+
+        write (text, (size_t) (runEnd - text));
+        text = runEnd;
+
+        if (text == end)
+            break;
+
+        const auto c = (uint8) *text++;
+
+        switch (c)
+        {
+            case '\"':  write ("\\\"", 2); break;
+            case '\\':  write ("\\\\", 2); break;
+            case '\a':  write ("\\a", 2);  break;
+            case '\b':  write ("\\b", 2);  break;
+            case '\f':  write ("\\f", 2);  break;
+            case '\t':  write ("\\t", 2);  break;
+            case '\r':  write ("\\r", 2);  break;
+            case '\n':  write ("\\n", 2);  break;
+
+            default:
+            {
+                auto character = (uint32) c;
+
+                // Decode the rest of a UTF-8 sequence in the same way as CharPointer_UTF8 does
+                if ((c & 0x80) != 0)
+                {
+                    uint32 mask = 0x7f, bit = 0x40;
+                    int numExtraBytes = 0;
+
+                    while ((c & bit) != 0 && bit > 0x8)
+                    {
+                        mask >>= 1;
+                        bit >>= 1;
+                        ++numExtraBytes;
+                    }
+
+                    character &= mask;
+
+                    for (; numExtraBytes > 0 && text < end && (*text & 0xc0) == 0x80; --numExtraBytes)
+                        character = (character << 6) | (uint32) (*text++ & 0x3f);
+                }
+
+                if (character >= 0x10000)
+                {
+                    character -= 0x10000;
+                    writeEscapedChar (0xd800 + (character >> 10));
+                    writeEscapedChar (0xdc00 + (character & 0x3ff));
+                }
+                else
+                {
+                    writeEscapedChar (character);
+                }
+
+                break;
+            }
+        }
+    }
+}
+
+void JSONWriter::writeEscapedChar (uint32 value)
+{
+    const char text[] = { '\\', 'u',
+                          "0123456789abcdef"[(value >> 12) & 15],
+                          "0123456789abcdef"[(value >> 8) & 15],
+                          "0123456789abcdef"[(value >> 4) & 15],
+                          "0123456789abcdef"[value & 15] };
+
+    write (text, sizeof (text));
+}
+
+//==============================================================================
+void JSONWriter::write (const char* text, size_t numBytes)
+{
+    if (numBytes > sizeof (buffer) - bufferUsed)
+    {
+        writeBuffer();
+
+        if (numBytes > sizeof (buffer))
+        {
+            out.write (text, numBytes);
+            return;
+        }
+    }
+
+    std::memcpy (buffer + bufferUsed, text, numBytes);
+    bufferUsed += numBytes;
+}
+
+void JSONWriter::writeBuffer()
+{
+    if (bufferUsed > 0)
+        out.write (buffer, bufferUsed);
+
+    bufferUsed = 0;
+}
+
+} // namespace juce
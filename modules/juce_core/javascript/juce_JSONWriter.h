@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes JSON to a stream one value at a time, without building a var first.
+
+    The text is collected in a fixed-size internal buffer and written to the stream in
+    large blocks, and numbers and strings are formatted straight into that buffer, so
+    writing doesn't allocate any memory once the writer has been created.
+
+    The output is formatted in exactly the same way as JSON::writeToStream() formats
+    the equivalent var.
+
+    @code
+    JSONWriter writer (stream, JSON::FormatOptions{}.withSpacing (JSON::Spacing::none));
+
+    writer.beginObject();
+    writer.writeName ("name");
+    writer.writeString ("Lead");
+    writer.writeName ("levels");
+    writer.beginArray();
+
+    for (auto level : levels)
+        writer.writeDouble (level);
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    Inside an object, each value must be preceded by a call to writeName().
+
+    @see JSON, JSONReader
+
+    @tags{Core}
+*/
+class JUCE_API  JSONWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer that writes to the given stream.
+        The stream must stay valid for the lifetime of the writer.
+    */
+    explicit JSONWriter (OutputStream& destination, const JSON::FormatOptions& formatOptions = {});
+
+    /** Destructor. This writes any buffered text to the stream. */
+    ~JSONWriter();
+
+    //==============================================================================
+    /** Starts an object. Each of its values must be preceded by a call to writeName(). */
+    void beginObject();
+
+    /** Ends the object that was started by the last unmatched beginObject(). */
+    void endObject();
+
+    /** Starts an array. */
+    void beginArray();
+
+    /** Ends the array that was started by the last unmatched beginArray(). */
+    void endArray();
+
+    /** Writes the name of the next property in the current object. */
+    void writeName (std::string_view utf8Name);
+
+    //==============================================================================
+    /** Writes a string value, escaping any characters that need it. */
+    void writeString (std::string_view utf8Text);
+
+    /** Writes a string value, escaping any characters that need it. */
+    void writeString (const String& text);
+
+    /** Writes a string value, escaping any characters that need it. */
+    void writeString (const char* utf8Text)         { writeString (std::string_view (utf8Text)); }
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating-point value.
+        Numbers that aren't finite can't be represented in JSON, so are written as null.
+    */
+    void writeDouble (double value);
+
+    /** Writes a true or false value. */
+    void writeBool (bool value);
+
+    /** Writes a null value. */
+    void writeNull();
+
+    /** Writes a var, including any objects or arrays that it contains. */
+    void writeValue (const var& value);
+
+    //==============================================================================
+    /** Writes any buffered text to the stream, and flushes the stream. */
+    void flush();
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        bool isObject, isEmpty;
+    };
+
+    void beginValue();
+    void beginContainer (bool isObject, char openingBracket);
+    void endContainer (bool isObject, char closingBracket);
+    void writeSeparator (Level&);
+    void writeIndent (size_t depth);
+    void writeEscaped (const char* text, const char* end);
+    void writeEscapedChar (uint32 value);
+
+    void write (char c)
+    {
+        if (bufferUsed == sizeof (buffer))
+            writeBuffer();
+
+        buffer[bufferUsed++] = c;
+    }
+
+    void write (const char* text, size_t numBytes);
+    void writeBuffer();
+
+    OutputStream& out;
+    const JSON::FormatOptions format;
+    std::string newLineString;
+    std::vector<Level> levels;
+    bool hasName = false;
+
+    char buffer[4096];
+    size_t bufferUsed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONWriter)
+};
+
+} // namespace juce
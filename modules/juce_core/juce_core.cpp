@@ -54,7 +54,9 @@
 #include "juce_core.h"
 
 #include <cctype>
+#include <clocale>
 #include <cstdarg>
+#include <cstdio>
 #include <locale>
 #include <thread>
 
@@ -115,6 +117,21 @@
   #endif
  #endif
 
+ #if JUCE_LINUX && JUCE_USE_IO_URING
+  #include <linux/io_uring.h>
+
+  // Kernel headers from before 5.4 don't have everything the io_uring backend needs
+  #ifndef IORING_FEAT_SINGLE_MMAP
+   #undef  JUCE_USE_IO_URING
+   #define JUCE_USE_IO_URING 0
+  #endif
+ #endif
+
+ #if JUCE_LINUX && JUCE_USE_IO_URING
+  #include <sys/syscall.h>
+  #include <sys/uio.h>
+ #endif
+
  #include <pwd.h>
  #include <fcntl.h>
  #include <netdb.h>
@@ -124,6 +141,10 @@
  #include <net/if.h>
  #include <sys/ioctl.h>
 
+ #if ! (JUCE_MAC || JUCE_IOS)
+  #include <semaphore.h>
+ #endif
+
  #if ! (JUCE_WASM || (JUCE_ANDROID && __ANDROID_API__ < 33))
   #include <execinfo.h>
  #endif
@@ -138,6 +159,7 @@
 #if JUCE_MAC || JUCE_IOS
  #include <xlocale.h>
  #include <mach/mach.h>
+ #include <dispatch/dispatch.h>
 #endif
 
 #if JUCE_ANDROID
@@ -148,6 +170,8 @@
 
 #undef check
 
+#include <zstd/zstd.h>
+
 //==============================================================================
 #include "containers/juce_AbstractFifo.cpp"
 #include "containers/juce_ArrayBase.cpp"
@@ -161,10 +185,14 @@
 #include "files/juce_File.cpp"
 #include "files/juce_FileInputStream.cpp"
 #include "files/juce_FileOutputStream.cpp"
+#include "files/juce_AsyncFileIO.cpp"
+#include "files/juce_AsyncFileInputStream.cpp"
+#include "files/juce_AsyncFileOutputStream.cpp"
 #include "files/juce_FileSearchPath.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "logging/juce_FileLogger.cpp"
 #include "logging/juce_Logger.cpp"
+#include "logging/juce_AsyncLogger.cpp"
 #include "maths/juce_BigInteger.cpp"
 #include "maths/juce_Expression.cpp"
 #include "maths/juce_Random.cpp"
@@ -196,8 +224,10 @@
 #include "text/juce_StringPool.cpp"
 #include "text/juce_TextDiff.cpp"
 #include "text/juce_Base64.cpp"
+#include "threads/juce_LightweightSemaphore.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
+#include "threads/juce_WorkStealingScheduler.cpp"
 #include "threads/juce_ThreadPool.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
@@ -207,13 +237,23 @@
 #include "containers/juce_Variant.cpp"
 #include "javascript/juce_JSON.cpp"
 #include "javascript/juce_JSONUtils.cpp"
+#include "javascript/juce_JSONReader.cpp"
+#include "javascript/juce_JSONWriter.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
+#include "serialisation/juce_BinaryVar.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlStreamReader.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
+#include "zip/juce_ParallelGZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
+#include "zip/juce_LZ4DecompressorInputStream.cpp"
+#include "zip/juce_LZ4CompressorOutputStream.cpp"
+#include "zip/juce_ZstdDecompressorInputStream.cpp"
+#include "zip/juce_ZstdCompressorOutputStream.cpp"
+#include "zip/juce_CompressionFormat.cpp"
 #include "files/juce_FileFilter.cpp"
 #include "files/juce_WildcardFileFilter.cpp"
 #include "native/juce_ThreadPriorities_native.h"
@@ -259,6 +299,7 @@
  #include "native/juce_SystemStats_linux.cpp"
  #include "native/juce_Threads_linux.cpp"
  #include "native/juce_PlatformTimer_generic.cpp"
+ #include "native/juce_AsyncFileIO_linux.cpp"
 
 //==============================================================================
 #elif JUCE_BSD
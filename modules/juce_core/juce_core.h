@@ -56,7 +56,7 @@
   license:            ISC
   minimumCppStandard: 17
 
-  dependencies:
+  dependencies:       zstd
   OSXFrameworks:      Cocoa Foundation IOKit Security
   iOSFrameworks:      Foundation
   linuxLibs:          rt dl pthread
@@ -157,6 +157,25 @@
  #define JUCE_USE_CURL 1
 #endif
 
+/** Config: JUCE_USE_IO_URING
+    Enables io_uring for AsyncFileIO on Linux, which needs the kernel headers from
+    Linux 5.4 or later to build. By default it's only enabled when those headers are
+    found, and it's turned off again if they turn out to be too old. Whether or not this
+    is enabled, AsyncFileIO will fall back to a pool of threads when the running kernel
+    doesn't support io_uring.
+*/
+#ifndef JUCE_USE_IO_URING
+ #if defined (__has_include)
+  #if __has_include (<linux/io_uring.h>)
+   #define JUCE_USE_IO_URING 1
+  #endif
+ #endif
+
+ #ifndef JUCE_USE_IO_URING
+  #define JUCE_USE_IO_URING 0
+ #endif
+#endif
+
 /** Config: JUCE_LOAD_CURL_SYMBOLS_LAZILY
     If enabled, JUCE will load libcurl lazily when required (for example, when WebInputStream
     is used). Enabling this flag may also help with library dependency errors as linking
@@ -309,6 +328,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "javascript/juce_JSON.h"
 #include "containers/juce_DynamicObject.h"
 #include "containers/juce_HashMap.h"
+#include "containers/juce_FlatHashMap.h"
+#include "containers/juce_FlatHashSet.h"
 #include "containers/juce_FixedSizeFunction.h"
 #include "time/juce_RelativeTime.h"
 #include "time/juce_Time.h"
@@ -324,6 +345,9 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "files/juce_RangedDirectoryIterator.h"
 #include "files/juce_FileInputStream.h"
 #include "files/juce_FileOutputStream.h"
+#include "files/juce_AsyncFileIO.h"
+#include "files/juce_AsyncFileInputStream.h"
+#include "files/juce_AsyncFileOutputStream.h"
 #include "files/juce_FileSearchPath.h"
 #include "files/juce_MemoryMappedFile.h"
 #include "files/juce_TemporaryFile.h"
@@ -332,7 +356,10 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSONUtils.h"
+#include "javascript/juce_JSONReader.h"
+#include "javascript/juce_JSONWriter.h"
 #include "serialisation/juce_Serialisation.h"
+#include "serialisation/juce_BinaryVar.h"
 #include "javascript/juce_JSONSerialisation.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
@@ -346,11 +373,14 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "threads/juce_Process.h"
 #include "threads/juce_SpinLock.h"
 #include "threads/juce_WaitableEvent.h"
+#include "threads/juce_LightweightSemaphore.h"
 #include "threads/juce_Thread.h"
 #include "threads/juce_HighResolutionTimer.h"
 #include "threads/juce_ThreadLocalValue.h"
+#include "threads/juce_WorkStealingScheduler.h"
 #include "threads/juce_ThreadPool.h"
 #include "threads/juce_TimeSliceThread.h"
+#include "logging/juce_AsyncLogger.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
 #include "threads/juce_ScopedWriteLock.h"
@@ -365,8 +395,15 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlStreamReader.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
+#include "zip/juce_ParallelGZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
+#include "zip/juce_LZ4CompressorOutputStream.h"
+#include "zip/juce_LZ4DecompressorInputStream.h"
+#include "zip/juce_ZstdCompressorOutputStream.h"
+#include "zip/juce_ZstdDecompressorInputStream.h"
+#include "zip/juce_CompressionFormat.h"
 #include "zip/juce_ZipFile.h"
 #include "containers/juce_PropertySet.h"
 #include "memory/juce_SharedResourcePointer.h"
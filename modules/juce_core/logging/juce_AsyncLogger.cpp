@@ -0,0 +1,680 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace AsyncLoggerHelpers
+{
+    /*  Each buffer is a ring of records, each starting on a 16-byte boundary. A record
+        that won't fit before the end of the ring is preceded by a padding record that
+        fills the rest of it.
+
+        A text record's payload is just its UTF-8 bytes. A formatted record's payload is:
+            uint32 formatLength, uint32 numArguments
+            StoredArgument arguments[numArguments]
+            format string, followed by the text of any string arguments
+    */
+    enum RecordKind : uint32 { paddingRecord, textRecord, formattedRecord };
+
+    struct RecordHeader
+    {
+        uint32 payloadSize;
+        uint32 kind;
+        int64 ticks;
+    };
+
+    struct StoredArgument
+    {
+        uint32 type;
+        uint32 textSize;
+        uint64 value;       // for strings, this is the offset of the text in the payload
+    };
+
+    static_assert (sizeof (RecordHeader) == 16 && sizeof (StoredArgument) == 16);
+
+    constexpr size_t recordAlignment = 16;
+
+    static constexpr size_t getRecordSize (size_t payloadSize) noexcept
+    {
+        return (sizeof (RecordHeader) + payloadSize + recordAlignment - 1) & ~(recordAlignment - 1);
+    }
+
+    static std::atomic<uint64> nextLoggerId { 1 };
+}
+
+//==============================================================================
+struct AsyncLogger::Buffer
+{
+    enum Ownership { available, owned, released };
+
+    explicit Buffer (size_t size)
+        : capacity (size)
+    {
+        data.malloc (size);
+
+        // Touch every page now, so that a realtime thread won't be the one to fault them in
+        for (size_t i = 0; i < size; i += 4096)
+            data[i] = 0;
+    }
+
+    /*  Called by the thread that owns the buffer, this copies a record into it and then
+        publishes it. The fill function is given a pointer to the payload.
+    */
+    template <typename FillFunction>
+    bool write (uint32 kind, int64 ticks, size_t payloadSize, FillFunction&& fill) noexcept
+    {
+        using namespace AsyncLoggerHelpers;
+
+        const auto recordSize = getRecordSize (payloadSize);
+        const auto writePos = writePosition.load (std::memory_order_relaxed);
+        const auto readPos = readPosition.load (std::memory_order_acquire);
+
+        auto offset = (size_t) (writePos & (capacity - 1));
+        const auto bytesBeforeEnd = capacity - offset;
+        const auto padding = bytesBeforeEnd < recordSize ? bytesBeforeEnd : 0;
+
+        if (recordSize + padding > capacity - (size_t) (writePos - readPos))
+            return false;
+
+        if (padding > 0)
+        {
+            auto* header = reinterpret_cast<RecordHeader*> (data + offset);
+            header->payloadSize = (uint32) (padding - sizeof (RecordHeader));
+            header->kind = paddingRecord;
+            header->ticks = 0;
+            offset = 0;
+        }
+
+        auto* header = reinterpret_cast<RecordHeader*> (data + offset);
+        header->payloadSize = (uint32) payloadSize;
+        header->kind = kind;
+        header->ticks = ticks;
+        fill (reinterpret_cast<char*> (header + 1));
+
+        writePosition.store (writePos + padding + recordSize, std::memory_order_release);
+        return true;
+    }
+
+    bool writeText (int64 ticks, const char* text, size_t numBytes) noexcept
+    {
+        return write (AsyncLoggerHelpers::textRecord, ticks, numBytes, [&] (char* dest)
+        {
+            memcpy (dest, text, numBytes);
+        });
+    }
+
+    size_t getNumBytesPending() const noexcept
+    {
+        return (size_t) (writePosition.load (std::memory_order_relaxed) - readPosition.load (std::memory_order_relaxed));
+    }
+
+    HeapBlock<char> data;
+    const size_t capacity;
+    alignas (64) std::atomic<uint64> writePosition { 0 };
+    alignas (64) std::atomic<uint64> readPosition { 0 };
+    std::atomic<int> ownership { available };
+    SpinLock producerLock;
+};
+
+//==============================================================================
+/*  The buffers are owned by this object rather than the logger, so that a thread that
+    exits after its logger has been deleted can still safely find out whether it has.
+*/
+struct AsyncLogger::SharedState
+{
+    SharedState (int numThreadBuffers, size_t bufferSize)
+    {
+        for (int i = 0; i < numThreadBuffers; ++i)
+            buffers.add (new Buffer (bufferSize));
+
+        sharedBuffer = buffers.add (new Buffer (bufferSize));
+    }
+
+    Buffer* claimBuffer() noexcept
+    {
+        for (auto* buffer : buffers)
+        {
+            auto expected = (int) Buffer::available;
+
+            if (buffer != sharedBuffer
+                 && buffer->ownership.compare_exchange_strong (expected, Buffer::owned, std::memory_order_acquire))
+                return buffer;
+        }
+
+        return sharedBuffer;
+    }
+
+    OwnedArray<Buffer> buffers;
+    Buffer* sharedBuffer = nullptr;
+};
+
+//==============================================================================
+/*  This is trivially destructible, so using it doesn't make the runtime allocate anything
+    to register a destructor for the thread.
+*/
+struct AsyncLogger::ThreadCache
+{
+    struct Slot
+    {
+        uint64 loggerId;
+        Buffer* buffer;
+        bool registeredForThreadExit;
+    };
+
+    static ThreadCache& get() noexcept
+    {
+        thread_local ThreadCache cache {};
+        return cache;
+    }
+
+    Slot slots[4];
+    uint32 nextSlot;
+    bool hasExitHandler, threadIsExiting;
+};
+
+/*  Gives the buffers that a thread has claimed back to their loggers when the thread exits. */
+struct AsyncLogger::ThreadExitHandler
+{
+    struct Entry
+    {
+        std::weak_ptr<SharedState> owner;
+        Buffer* buffer = nullptr;
+    };
+
+    ~ThreadExitHandler()
+    {
+        ThreadCache::get().threadIsExiting = true;
+
+        for (auto& entry : entries)
+            if (auto owner = entry.owner.lock())
+                entry.buffer->ownership.store (Buffer::released, std::memory_order_release);
+    }
+
+    static ThreadExitHandler& get()
+    {
+        thread_local ThreadExitHandler handler;
+        ThreadCache::get().hasExitHandler = true;
+        return handler;
+    }
+
+    bool add (const std::shared_ptr<SharedState>& owner, Buffer* buffer, bool canReuseEntries) noexcept
+    {
+        for (auto& entry : entries)
+        {
+            // Overwriting an expired entry could free its control block, which isn't allowed on a realtime thread
+            if (entry.buffer == nullptr || (canReuseEntries && entry.owner.expired()))
+            {
+                entry.owner = owner;
+                entry.buffer = buffer;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    Entry entries[8];
+};
+
+//==============================================================================
+class AsyncLogger::Flusher  : public Thread
+{
+public:
+    explicit Flusher (AsyncLogger& o)
+        : Thread ("AsyncLogger"), owner (o)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (owner.options.flushIntervalMilliseconds);
+            owner.flush();
+        }
+    }
+
+private:
+    AsyncLogger& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (Flusher)
+};
+
+//==============================================================================
+AsyncLogger::AsyncLogger (const File& fileToWriteTo, const AsyncLoggerOptions& opts)
+    : logFile (fileToWriteTo),
+      options (opts),
+      loggerId (AsyncLoggerHelpers::nextLoggerId++),
+      state (std::make_shared<SharedState> (jmax (0, opts.maxNumThreads),
+                                            (size_t) nextPowerOfTwo (jlimit (1024, 1 << 30, opts.bufferSizeBytesPerThread))))
+{
+    startTicks = Time::getHighResolutionTicks();
+    startMillis = Time::currentTimeMillis();
+    millisecondsPerTick = 1000.0 / (double) Time::getHighResolutionTicksPerSecond();
+
+    if (! logFile.exists())
+        logFile.create();  // (to create the parent directories)
+
+    flusher = std::make_unique<Flusher> (*this);
+    flusher->startThread (options.flusherThreadPriority);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    flusher->signalThreadShouldExit();
+    flusher->notify();
+    flusher->stopThread (-1);
+
+    flush();
+}
+
+File AsyncLogger::getBackupFile (int index) const
+{
+    return logFile.getSiblingFile (logFile.getFileNameWithoutExtension()
+                                     + "." + String (index)
+                                     + logFile.getFileExtension());
+}
+
+//==============================================================================
+AsyncLogger::Buffer* AsyncLogger::getBufferForCurrentThread (bool registerForThreadExit) noexcept
+{
+    auto& cache = ThreadCache::get();
+
+    if (cache.threadIsExiting)
+        return state->sharedBuffer;
+
+    ThreadCache::Slot* slot = nullptr;
+
+    for (auto& s : cache.slots)
+    {
+        if (s.loggerId == loggerId)
+        {
+            slot = &s;
+            break;
+        }
+    }
+
+    if (slot == nullptr)
+    {
+        // The buffer in an evicted slot stays claimed, and will still be released when the thread exits
+        slot = &cache.slots[cache.nextSlot++ % (uint32) numElementsInArray (cache.slots)];
+        slot->loggerId = loggerId;
+        slot->buffer = state->claimBuffer();
+        slot->registeredForThreadExit = false;
+    }
+
+    if (! slot->registeredForThreadExit
+         && slot->buffer != state->sharedBuffer
+         && (registerForThreadExit || cache.hasExitHandler))
+    {
+        slot->registeredForThreadExit = ThreadExitHandler::get().add (state, slot->buffer, registerForThreadExit);
+    }
+
+    return slot->buffer;
+}
+
+void AsyncLogger::prepareCurrentThread()
+{
+    getBufferForCurrentThread (true);
+}
+
+void AsyncLogger::logMessage (const String& message)
+{
+    auto* buffer = getBufferForCurrentThread (true);
+    auto* text = message.toRawUTF8();
+    auto numBytes = message.getNumBytesAsUTF8();
+    auto ticks = Time::getHighResolutionTicks();
+
+    // A record bigger than half the buffer might need more space than it has, once the
+    // padding before the wrap point is included, even after the buffer has been drained
+    if (AsyncLoggerHelpers::getRecordSize (numBytes) <= buffer->capacity / 2)
+    {
+        for (;;)
+        {
+            bool written;
+
+            if (buffer == state->sharedBuffer)
+            {
+                const SpinLock::ScopedLockType sl (buffer->producerLock);
+                written = buffer->writeText (ticks, text, numBytes);
+            }
+            else
+            {
+                written = buffer->writeText (ticks, text, numBytes);
+            }
+
+            if (written)
+            {
+                if (buffer->getNumBytesPending() > buffer->capacity / 2)
+                    flusher->notify();
+
+                return;
+            }
+
+            // The buffer is full, so rather than dropping the message, write out what's pending
+            const ScopedLock sl (writeLock);
+            writePendingMessages();
+        }
+    }
+
+    // This message is too big to be sure of fitting into the buffer, so write it out directly
+    const ScopedLock sl (writeLock);
+    writePendingMessages();
+
+    batch.reset();
+
+    if (options.includeTimestamps)
+        appendTimestamp (ticks);
+
+    batch.write (text, numBytes);
+    batch << newLine;
+    writeToFile (static_cast<const char*> (batch.getData()), batch.getDataSize());
+}
+
+bool AsyncLogger::writeRealtime (std::string_view format, const Argument* arguments, size_t numArguments) noexcept
+{
+    using namespace AsyncLoggerHelpers;
+
+    auto ticks = Time::getHighResolutionTicks();
+    auto* buffer = getBufferForCurrentThread (false);
+
+    auto payloadSize = 2 * sizeof (uint32) + numArguments * sizeof (StoredArgument) + format.size();
+
+    for (size_t i = 0; i < numArguments; ++i)
+        if (arguments[i].type == Argument::text)
+            payloadSize += arguments[i].string.size();
+
+    auto writeRecord = [&]
+    {
+        if (payloadSize > buffer->capacity)
+            return false;
+
+        return buffer->write (formattedRecord, ticks, payloadSize, [&] (char* payload)
+        {
+            auto* counts = reinterpret_cast<uint32*> (payload);
+            counts[0] = (uint32) format.size();
+            counts[1] = (uint32) numArguments;
+
+            auto* stored = reinterpret_cast<StoredArgument*> (payload + 2 * sizeof (uint32));
+            auto textOffset = 2 * sizeof (uint32) + numArguments * sizeof (StoredArgument);
+
+            memcpy (payload + textOffset, format.data(), format.size());
+            textOffset += format.size();
+
+            for (size_t i = 0; i < numArguments; ++i)
+            {
+                const auto& argument = arguments[i];
+                stored[i].type = argument.type;
+                stored[i].textSize = 0;
+                memcpy (&stored[i].value, &argument.value, sizeof (stored[i].value));
+
+                if (argument.type == Argument::text)
+                {
+                    memcpy (payload + textOffset, argument.string.data(), argument.string.size());
+                    stored[i].textSize = (uint32) argument.string.size();
+                    stored[i].value = textOffset;
+                    textOffset += argument.string.size();
+                }
+            }
+        });
+    };
+
+    bool written;
+
+    if (buffer == state->sharedBuffer)
+    {
+        const SpinLock::ScopedTryLockType tl (buffer->producerLock);
+        written = tl.isLocked() && writeRecord();
+    }
+    else
+    {
+        written = writeRecord();
+    }
+
+    if (! written)
+        numDropped.fetch_add (1, std::memory_order_relaxed);
+
+    return written;
+}
+
+//==============================================================================
+void AsyncLogger::flush()
+{
+    const ScopedLock sl (writeLock);
+    writePendingMessages();
+}
+
+void AsyncLogger::writePendingMessages()
+{
+    using namespace AsyncLoggerHelpers;
+
+    auto& buffers = state->buffers;
+    pendingRecords.clear();
+    pendingEnds.resize ((size_t) buffers.size());
+
+    for (int i = 0; i < buffers.size(); ++i)
+    {
+        auto* buffer = buffers.getUnchecked (i);
+        auto readPos = buffer->readPosition.load (std::memory_order_relaxed);
+        auto writePos = buffer->writePosition.load (std::memory_order_acquire);
+        pendingEnds[(size_t) i] = writePos;
+
+        while (readPos != writePos)
+        {
+            auto* header = reinterpret_cast<const RecordHeader*> (buffer->data + (readPos & (buffer->capacity - 1)));
+
+            if (header->kind != paddingRecord)
+                pendingRecords.emplace_back (header->ticks, header);
+
+            readPos += getRecordSize (header->payloadSize);
+        }
+    }
+
+    // Each buffer is already in order, so this just interleaves the messages from different threads
+    std::stable_sort (pendingRecords.begin(), pendingRecords.end(),
+                      [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+    batch.reset();
+
+    for (auto& record : pendingRecords)
+        appendRecord (record.second);
+
+    auto dropped = numDropped.load (std::memory_order_relaxed);
+
+    if (dropped != numDroppedReported)
+    {
+        if (options.includeTimestamps)
+            appendTimestamp (Time::getHighResolutionTicks());
+
+        batch << "AsyncLogger: " << String (dropped - numDroppedReported) << " messages were dropped" << newLine;
+        numDroppedReported = dropped;
+    }
+
+    writeToFile (static_cast<const char*> (batch.getData()), batch.getDataSize());
+
+    for (int i = 0; i < buffers.size(); ++i)
+    {
+        auto* buffer = buffers.getUnchecked (i);
+        auto end = pendingEnds[(size_t) i];
+        buffer->readPosition.store (end, std::memory_order_release);
+
+        auto expected = (int) Buffer::released;
+
+        if (buffer->ownership.load (std::memory_order_acquire) == Buffer::released
+             && buffer->writePosition.load (std::memory_order_acquire) == end)
+            buffer->ownership.compare_exchange_strong (expected, Buffer::available);
+    }
+}
+
+void AsyncLogger::appendTimestamp (int64 ticks)
+{
+    auto millis = startMillis + (int64) ((double) (ticks - startTicks) * millisecondsPerTick);
+    auto second = millis >= 0 ? millis / 1000 : (millis - 999) / 1000;
+
+    if (second != lastTimestampSecond)
+    {
+        lastTimestampSecond = second;
+        lastTimestamp = Time (second * 1000).formatted ("%Y-%m-%d %H:%M:%S");
+    }
+
+    auto ms = (int) (millis - second * 1000);
+    const char fraction[] = { '.', (char) ('0' + ms / 100), (char) ('0' + (ms / 10) % 10), (char) ('0' + ms % 10), ' ' };
+
+    batch << lastTimestamp;
+    batch.write (fraction, sizeof (fraction));
+}
+
+void AsyncLogger::appendRecord (const void* record)
+{
+    using namespace AsyncLoggerHelpers;
+
+    auto* header = static_cast<const RecordHeader*> (record);
+    auto* payload = reinterpret_cast<const char*> (header + 1);
+
+    if (options.includeTimestamps)
+        appendTimestamp (header->ticks);
+
+    if (header->kind == textRecord)
+    {
+        batch.write (payload, header->payloadSize);
+    }
+    else
+    {
+        auto* counts = reinterpret_cast<const uint32*> (payload);
+        auto* arguments = reinterpret_cast<const StoredArgument*> (payload + 2 * sizeof (uint32));
+        auto* format = reinterpret_cast<const char*> (arguments + counts[1]);
+        auto* formatEnd = format + counts[0];
+        uint32 nextArgument = 0;
+
+        for (auto* p = format; p < formatEnd;)
+        {
+            auto* placeholder = p;
+
+            while (placeholder + 1 < formatEnd && ! (placeholder[0] == '{' && placeholder[1] == '}'))
+                ++placeholder;
+
+            if (placeholder + 1 >= formatEnd)
+            {
+                batch.write (p, (size_t) (formatEnd - p));
+                break;
+            }
+
+            batch.write (p, (size_t) (placeholder - p));
+
+            if (nextArgument < counts[1])
+                appendArgument (arguments + nextArgument++, payload);
+            else
+                batch.write (placeholder, 2);
+
+            p = placeholder + 2;
+        }
+    }
+
+    batch << newLine;
+}
+
+void AsyncLogger::appendArgument (const void* argument, const char* payload)
+{
+    auto& stored = *static_cast<const AsyncLoggerHelpers::StoredArgument*> (argument);
+
+    switch (stored.type)
+    {
+        case Argument::signedInt:       batch << String ((int64) stored.value); break;
+        case Argument::unsignedInt:     batch << String (stored.value); break;
+        case Argument::boolean:         batch << (stored.value != 0 ? "true" : "false"); break;
+        case Argument::character:       batch.writeByte ((char) stored.value); break;
+        case Argument::pointer:         batch << "0x" << String::toHexString ((int64) stored.value); break;
+        case Argument::text:            batch.write (payload + stored.value, stored.textSize); break;
+
+        case Argument::floatingPoint:
+        {
+            double value;
+            memcpy (&value, &stored.value, sizeof (value));
+            batch << String (value);
+            break;
+        }
+
+        default:                        jassertfalse; break;
+    }
+}
+
+//==============================================================================
+void AsyncLogger::writeToFile (const char* data, size_t numBytes)
+{
+    if (numBytes == 0)
+        return;
+
+    if (output == nullptr)
+    {
+        output = std::make_unique<FileOutputStream> (logFile);
+
+        if (output->failedToOpen())
+        {
+            output.reset();
+            return;
+        }
+    }
+
+    auto position = output->getPosition();
+
+    if (options.maxFileSizeBytes > 0 && position > 0 && position + (int64) numBytes > options.maxFileSizeBytes)
+    {
+        rotate();
+
+        if (output == nullptr)
+            return;
+    }
+
+    output->write (data, numBytes);
+    output->flush();
+}
+
+void AsyncLogger::rotate()
+{
+    output.reset();
+
+    if (options.maxNumBackupFiles > 0)
+    {
+        getBackupFile (options.maxNumBackupFiles).deleteFile();
+
+        for (int i = options.maxNumBackupFiles - 1; i > 0; --i)
+        {
+            auto backup = getBackupFile (i);
+
+            if (backup.existsAsFile())
+                backup.moveFileTo (getBackupFile (i + 1));
+        }
+
+        logFile.moveFileTo (getBackupFile (1));
+    }
+    else
+    {
+        logFile.deleteFile();
+    }
+
+    output = std::make_unique<FileOutputStream> (logFile);
+
+    if (output->failedToOpen())
+        output.reset();
+}
+
+} // namespace juce
@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    The set of options used to create an AsyncLogger.
+
+    @tags{Core}
+*/
+struct AsyncLoggerOptions
+{
+    /** When writing a batch of messages would make the log file bigger than this, the file
+        is rotated first. If this is zero or less, the file is never rotated.
+    */
+    [[nodiscard]] AsyncLoggerOptions withMaxFileSizeBytes (int64 newMaxFileSizeBytes) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::maxFileSizeBytes, newMaxFileSizeBytes);
+    }
+
+    /** The number of rotated files to keep. When the log is rotated, "name.log" becomes
+        "name.1.log", "name.1.log" becomes "name.2.log", and so on, and the oldest is deleted.
+    */
+    [[nodiscard]] AsyncLoggerOptions withMaxNumBackupFiles (int newMaxNumBackupFiles) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::maxNumBackupFiles, newMaxNumBackupFiles);
+    }
+
+    /** The size of the buffer that each logging thread writes its messages into.
+        This is rounded up to a power of two. It needs to be big enough to hold all the
+        messages a thread might log in one flush interval, or some of them will be dropped.
+    */
+    [[nodiscard]] AsyncLoggerOptions withBufferSizeBytesPerThread (int newBufferSizeBytes) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::bufferSizeBytesPerThread, newBufferSizeBytes);
+    }
+
+    /** The number of per-thread buffers that are allocated up front. Any threads beyond this
+        number share one extra buffer, which is protected by a spin lock.
+    */
+    [[nodiscard]] AsyncLoggerOptions withMaxNumThreads (int newMaxNumThreads) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::maxNumThreads, newMaxNumThreads);
+    }
+
+    /** How often the background thread writes pending messages to the file. */
+    [[nodiscard]] AsyncLoggerOptions withFlushIntervalMilliseconds (int newFlushIntervalMs) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::flushIntervalMilliseconds, newFlushIntervalMs);
+    }
+
+    /** If true, each line in the file starts with the local time at which it was logged. */
+    [[nodiscard]] AsyncLoggerOptions withTimestamps (bool shouldIncludeTimestamps) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::includeTimestamps, shouldIncludeTimestamps);
+    }
+
+    /** The priority of the thread that writes to the file. */
+    [[nodiscard]] AsyncLoggerOptions withFlusherThreadPriority (Thread::Priority newPriority) const
+    {
+        return withMember (*this, &AsyncLoggerOptions::flusherThreadPriority, newPriority);
+    }
+
+    int64 maxFileSizeBytes { 1024 * 1024 };
+    int maxNumBackupFiles { 3 };
+    int bufferSizeBytesPerThread { 16384 };
+    int maxNumThreads { 16 };
+    int flushIntervalMilliseconds { 100 };
+    bool includeTimestamps { true };
+    Thread::Priority flusherThreadPriority { Thread::Priority::background };
+};
+
+//==============================================================================
+/**
+    A Logger that writes to a file on a background thread, so that logging a message
+    never waits for the disk or for other threads.
+
+    Each thread that logs gets its own lock-free buffer, taken from a pool that's allocated
+    when the logger is created. Messages are copied into it along with a timestamp, and the
+    background thread collects them every few milliseconds, puts them in time order and
+    writes them to the file in one go, rotating it when it gets too big.
+
+    logMessage() is what Logger::writeToLog() calls. It never loses a message: if its
+    thread's buffer is full, it writes the pending messages itself.
+
+    logRealtime() is safe to call from an audio callback or other realtime thread: it never
+    waits for a lock and never allocates memory. If the buffer is full, the message is
+    dropped and counted instead, and the number that were lost is written to the log. Any
+    arguments are copied as they are, and only turned into text by the background thread.
+
+    @code
+    void audioDeviceIOCallbackWithContext (...) override
+    {
+        if (numSamples > expectedBlockSize)
+            logger.logRealtime ("Block size changed from {} to {}", expectedBlockSize, numSamples);
+    }
+    @endcode
+
+    A thread claims its buffer the first time it logs something. Threads that log from a
+    realtime context should call prepareCurrentThread() beforehand, so that this doesn't
+    happen in the callback, and so that the buffer is given back when the thread exits.
+
+    @see Logger, FileLogger, AsyncLoggerOptions
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncLogger  : public Logger
+{
+public:
+    //==============================================================================
+    /** Creates a logger that appends to the given file, creating it and its parent
+        directories if needed, and starts its background thread.
+    */
+    explicit AsyncLogger (const File& fileToWriteTo,
+                          const AsyncLoggerOptions& options = AsyncLoggerOptions());
+
+    /** Destructor. This writes any pending messages before returning. */
+    ~AsyncLogger() override;
+
+    //==============================================================================
+    /** Returns the file that this logger is writing to. */
+    const File& getLogFile() const noexcept                 { return logFile; }
+
+    /** Returns the file that a rotated log is moved to, where 1 is the most recent. */
+    File getBackupFile (int index) const;
+
+    //==============================================================================
+    /** Logs a message, without blocking unless the calling thread's buffer is full. */
+    void logMessage (const String& message) override;
+
+    /** Logs a message from a thread that mustn't block or allocate.
+
+        The format string can contain "{}" placeholders, which are replaced by the arguments
+        in order. Numbers, bools, characters, pointers and strings (as const char*,
+        std::string_view, std::string or String) can be passed; strings are copied, so they
+        don't need to outlive the call.
+
+        Returns false if the message was dropped because there wasn't enough room for it.
+    */
+    template <typename... Args>
+    bool logRealtime (std::string_view format, const Args&... args) noexcept
+    {
+        if constexpr (sizeof... (Args) == 0)
+        {
+            return writeRealtime (format, nullptr, 0);
+        }
+        else
+        {
+            const Argument arguments[] = { Argument (args)... };
+            return writeRealtime (format, arguments, sizeof... (Args));
+        }
+    }
+
+    /** Claims a buffer for the calling thread, so that its first logRealtime() call doesn't
+        have to, and makes sure the buffer is given back to the pool when the thread exits.
+    */
+    void prepareCurrentThread();
+
+    /** Writes all the messages that have been logged so far to the file. */
+    void flush();
+
+    /** Returns the number of messages that logRealtime() has had to drop. */
+    int64 getNumDroppedMessages() const noexcept            { return numDropped.load (std::memory_order_relaxed); }
+
+private:
+    //==============================================================================
+    struct Argument
+    {
+        enum Type : uint32 { signedInt, unsignedInt, floatingPoint, boolean, character, pointer, text };
+
+        Argument (bool v) noexcept                          : type (boolean)            { value.u = v ? 1 : 0; }
+        Argument (char v) noexcept                          : type (character)          { value.u = (uint8) v; }
+        Argument (float v) noexcept                         : type (floatingPoint)      { value.d = v; }
+        Argument (double v) noexcept                        : type (floatingPoint)      { value.d = v; }
+        Argument (const char* v) noexcept                   : type (text), string (v != nullptr ? v : "(null)") {}
+        Argument (std::string_view v) noexcept              : type (text), string (v) {}
+        Argument (const std::string& v) noexcept            : type (text), string (v) {}
+        Argument (const String& v) noexcept                 : type (text), string (v.toRawUTF8(), v.getNumBytesAsUTF8()) {}
+        Argument (const void* v) noexcept                   : type (pointer)            { value.u = (uint64) (pointer_sized_uint) v; }
+
+        template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+        Argument (T v) noexcept                             : type (std::is_signed_v<T> ? signedInt : unsignedInt)
+        {
+            if constexpr (std::is_signed_v<T>)
+                value.i = (int64) v;
+            else
+                value.u = (uint64) v;
+        }
+
+        template <typename T, std::enable_if_t<std::is_enum_v<T>, int> = 0>
+        Argument (T v) noexcept                             : Argument (static_cast<std::underlying_type_t<T>> (v)) {}
+
+        Type type;
+        union { int64 i; uint64 u; double d; } value { 0 };
+        std::string_view string;
+    };
+
+    struct Buffer;
+    struct SharedState;
+    struct ThreadCache;
+    struct ThreadExitHandler;
+    class Flusher;
+
+    bool writeRealtime (std::string_view format, const Argument* arguments, size_t numArguments) noexcept;
+    Buffer* getBufferForCurrentThread (bool registerForThreadExit) noexcept;
+    void writePendingMessages();
+    void writeToFile (const char* data, size_t numBytes);
+    void rotate();
+    void appendTimestamp (int64 ticks);
+    void appendRecord (const void* record);
+    void appendArgument (const void* argument, const char* payload);
+
+    File logFile;
+    AsyncLoggerOptions options;
+    const uint64 loggerId;
+    std::shared_ptr<SharedState> state;
+    std::atomic<int64> numDropped { 0 };
+
+    CriticalSection writeLock;
+    std::unique_ptr<FileOutputStream> output;
+    MemoryOutputStream batch;
+    std::vector<std::pair<int64, const void*>> pendingRecords;
+    std::vector<uint64> pendingEnds;
+    int64 numDroppedReported = 0;
+    int64 startTicks = 0, startMillis = 0, lastTimestampSecond = -1;
+    double millisecondsPerTick = 0;
+    String lastTimestamp;
+
+    std::unique_ptr<Flusher> flusher;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncLogger)
+};
+
+} // namespace juce
@@ -44,7 +44,11 @@ namespace juce
 /**
     A simple implementation of a Logger that writes to a file.
 
-    @see Logger
+    Each message is written to the file before logMessage() returns, and a lock is held
+    while it's written, so this shouldn't be used from realtime threads. AsyncLogger does
+    the writing on a background thread instead.
+
+    @see Logger, AsyncLogger
 
     @tags{Core}
 */
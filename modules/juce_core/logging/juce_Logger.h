@@ -50,7 +50,7 @@ namespace juce
     The logger class also contains methods for writing messages to the debugger's
     output stream.
 
-    @see FileLogger
+    @see FileLogger, AsyncLogger
 
     @tags{Core}
 */
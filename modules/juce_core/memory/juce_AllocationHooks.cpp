@@ -50,10 +50,10 @@ static AllocationHooks& getAllocationHooksForThread()
 
 void notifyAllocationHooksForThread()
 {
-    getAllocationHooksForThread().listenerList.call ([] (AllocationHooks::Listener& l)
-    {
-        l.newOrDeleteCalled();
-    });
+    auto& hooks = getAllocationHooksForThread();
+
+    for (int i = 0; i < hooks.numListeners; ++i)
+        hooks.listeners[i]->newOrDeleteCalled();
 }
 
 }
@@ -112,6 +112,23 @@ UnitTestAllocationChecker::~UnitTestAllocationChecker() noexcept
 
 void UnitTestAllocationChecker::newOrDeleteCalled() noexcept { ++calls; }
 
+//==============================================================================
+ScopedAllocationTripwire::ScopedAllocationTripwire()
+{
+    getAllocationHooksForThread().addListener (this);
+}
+
+ScopedAllocationTripwire::~ScopedAllocationTripwire() noexcept
+{
+    getAllocationHooksForThread().removeListener (this);
+
+    // Memory was allocated or freed while this tripwire was active. If this is
+    // an audio callback, the allocation needs to move to your prepare method!
+    jassert (calls == 0);
+}
+
+void ScopedAllocationTripwire::newOrDeleteCalled() noexcept { ++calls; }
+
 }
 
 #endif
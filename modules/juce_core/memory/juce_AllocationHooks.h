@@ -51,12 +51,29 @@ public:
         virtual void newOrDeleteCalled() noexcept = 0;
     };
 
-    void addListener    (Listener* l)          { listenerList.add (l); }
-    void removeListener (Listener* l) noexcept { listenerList.remove (l); }
+    void addListener (Listener* l) noexcept
+    {
+        // Too many checkers are active on this thread at once!
+        jassert (numListeners < maxNumListeners);
+
+        if (numListeners < maxNumListeners)
+            listeners[numListeners++] = l;
+    }
+
+    void removeListener (Listener* l) noexcept
+    {
+        const auto end = std::remove (listeners, listeners + numListeners, l);
+        numListeners = (int) (end - listeners);
+    }
 
 private:
     friend void notifyAllocationHooksForThread();
-    ListenerList<Listener> listenerList;
+
+    // This is called from inside operator new, so it mustn't allocate anything itself.
+    // A ListenerList would, and the allocation would call the hooks again.
+    static constexpr int maxNumListeners = 16;
+    Listener* listeners[maxNumListeners] {};
+    int numListeners = 0;
 };
 
 //==============================================================================
@@ -85,6 +102,55 @@ private:
     size_t calls = 0;
 };
 
+//==============================================================================
+/** Scoped checker which asserts if any memory is allocated or freed on the current
+    thread during its lifetime.
+
+    Put one at the start of an audio callback to catch code that allocates on the audio
+    thread. As well as calls to new and delete, this catches the memory that HeapBlock
+    allocates and frees, and so that of Array, AudioBuffer, MidiBuffer and most other
+    containers.
+
+    The assertion is made when the checker is destroyed, because asserting from inside
+    the allocation itself could allocate again.
+
+    When JUCE_ENABLE_ALLOCATION_HOOKS is disabled this class does nothing, so it can be
+    left in place in release builds.
+*/
+class ScopedAllocationTripwire  : private AllocationHooks::Listener
+{
+public:
+    /** Starts watching for allocations on the calling thread. */
+    ScopedAllocationTripwire();
+
+    /** Asserts if any memory was allocated or freed during this object's lifetime. */
+    ~ScopedAllocationTripwire() noexcept override;
+
+    /** Returns the number of times that memory has been allocated or freed on this thread
+        since the checker was created.
+    */
+    size_t getNumAllocations() const noexcept       { return calls; }
+
+private:
+    void newOrDeleteCalled() noexcept override;
+
+    size_t calls = 0;
+};
+
+}
+
+#else
+
+namespace juce
+{
+
+class ScopedAllocationTripwire
+{
+public:
+    ScopedAllocationTripwire() noexcept {}
+    size_t getNumAllocations() const noexcept       { return 0; }
+};
+
 }
 
 #endif
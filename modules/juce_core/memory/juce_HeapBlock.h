@@ -40,6 +40,10 @@
 namespace juce
 {
 
+#if JUCE_ENABLE_ALLOCATION_HOOKS
+void notifyAllocationHooksForThread();
+#endif
+
 #if ! (DOXYGEN || JUCE_EXCEPTIONS_DISABLED)
 namespace HeapBlockHelper
 {
@@ -147,7 +151,7 @@ public:
     */
     ~HeapBlock()
     {
-        std::free (data);
+        freeWrapper (data);
     }
 
     /** Move constructor */
@@ -265,7 +269,7 @@ public:
     template <typename SizeType>
     void malloc (SizeType newNumElements, size_t elementSize = sizeof (ElementType))
     {
-        std::free (data);
+        freeWrapper (data);
         data = mallocWrapper (static_cast<size_t> (newNumElements) * elementSize);
     }
 
@@ -275,7 +279,7 @@ public:
     template <typename SizeType>
     void calloc (SizeType newNumElements, const size_t elementSize = sizeof (ElementType))
     {
-        std::free (data);
+        freeWrapper (data);
         data = callocWrapper (static_cast<size_t> (newNumElements), elementSize);
     }
 
@@ -286,7 +290,7 @@ public:
     template <typename SizeType>
     void allocate (SizeType newNumElements, bool initialiseToZero)
     {
-        std::free (data);
+        freeWrapper (data);
         data = initialiseToZero ? callocWrapper (static_cast<size_t> (newNumElements), sizeof (ElementType))
                                 : mallocWrapper (static_cast<size_t> (newNumElements) * sizeof (ElementType));
     }
@@ -307,7 +311,7 @@ public:
     */
     void free() noexcept
     {
-        std::free (data);
+        freeWrapper (data);
         data = nullptr;
     }
 
@@ -343,6 +347,10 @@ private:
         if (size == 0)
             return nullptr;
 
+       #if JUCE_ENABLE_ALLOCATION_HOOKS
+        notifyAllocationHooksForThread();
+       #endif
+
         auto* memory = static_cast<ElementType*> (f());
 
        #if JUCE_EXCEPTIONS_DISABLED
@@ -369,6 +377,18 @@ private:
         return wrapper (newSize, [ptr, newSize] { return std::realloc (ptr, newSize); });
     }
 
+    static void freeWrapper (void* ptr) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+       #if JUCE_ENABLE_ALLOCATION_HOOKS
+        notifyAllocationHooksForThread();
+       #endif
+
+        std::free (ptr);
+    }
+
     template <class OtherElementType, bool otherThrowOnFailure>
     friend class HeapBlock;
 
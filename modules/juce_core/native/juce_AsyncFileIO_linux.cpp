@@ -0,0 +1,298 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if JUCE_USE_IO_URING
+
+//==============================================================================
+/*  Talks to io_uring through its system calls directly, so there's no dependency on liburing.
+
+    The submission ring is filled under a lock by whichever thread submits, and a single
+    thread waits for completions and calls the callbacks. Only the vectored read and write
+    operations are used, because they work on every kernel that has io_uring (5.1 onwards).
+*/
+class AsyncFileIO::IOUringBackend final : public AsyncFileIO::Backend,
+                                          private Thread
+{
+public:
+    IOUringBackend (AsyncFileIO& io, int queueDepth)
+        : Thread ("AsyncFileIO"), owner (io), iovecs ((size_t) queueDepth)
+    {
+    }
+
+    ~IOUringBackend() override
+    {
+        if (isThreadRunning())
+        {
+            signalThreadShouldExit();
+
+            {
+                const std::lock_guard<std::mutex> sl (submissionLock);
+
+                // If the ring is full, submitting what's already in it makes room for the wake-up
+                if (! push (IORING_OP_NOP, -1, nullptr, 0, 0, wakeUpTag))
+                {
+                    enter();
+
+                    [[maybe_unused]] const auto pushed = push (IORING_OP_NOP, -1, nullptr, 0, 0, wakeUpTag);
+                    jassert (pushed);
+                }
+
+                enter();
+            }
+
+            stopThread (-1);
+        }
+
+        if (sqes != nullptr)                        munmap (sqes, sqesSize);
+        if (cqRing != nullptr && cqRing != sqRing)  munmap (cqRing, cqRingSize);
+        if (sqRing != nullptr)                      munmap (sqRing, sqRingSize);
+        if (ringFd >= 0)                            close (ringFd);
+    }
+
+    bool open (unsigned numEntries)
+    {
+        io_uring_params params;
+        zerostruct (params);
+
+        ringFd = (int) syscall (__NR_io_uring_setup, numEntries, &params);
+
+        if (ringFd < 0)
+            return false;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof (io_uring_cqe);
+
+        const auto singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (singleMapping)
+            sqRingSize = cqRingSize = jmax (sqRingSize, cqRingSize);
+
+        sqRing = mapRegion (sqRingSize, IORING_OFF_SQ_RING);
+        cqRing = singleMapping ? sqRing : mapRegion (cqRingSize, IORING_OFF_CQ_RING);
+
+        sqesSize = params.sq_entries * sizeof (io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*> (mapRegion (sqesSize, IORING_OFF_SQES));
+
+        if (sqRing == nullptr || cqRing == nullptr || sqes == nullptr)
+            return false;
+
+        auto* sq = static_cast<char*> (sqRing);
+        sqHead  = reinterpret_cast<unsigned*> (sq + params.sq_off.head);
+        sqTail  = reinterpret_cast<unsigned*> (sq + params.sq_off.tail);
+        sqMask  = *reinterpret_cast<unsigned*> (sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*> (sq + params.sq_off.array);
+        numSqEntries = params.sq_entries;
+
+        auto* cq = static_cast<char*> (cqRing);
+        cqHead = reinterpret_cast<unsigned*> (cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*> (cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned*> (cq + params.cq_off.ring_mask);
+        cqes   = reinterpret_cast<io_uring_cqe*> (cq + params.cq_off.cqes);
+
+        return startThread();
+    }
+
+    void start (Request* const* requestsToStart, int numRequests) override
+    {
+        const std::lock_guard<std::mutex> sl (submissionLock);
+
+        for (int i = 0; i < numRequests; ++i)
+            pushRequest (*requestsToStart[i]);
+
+        enter();
+    }
+
+private:
+    static constexpr __u64 wakeUpTag = ~(__u64) 0;
+
+    AsyncFileIO& owner;
+    std::vector<iovec> iovecs;
+    std::mutex submissionLock;
+
+    int ringFd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqRingSize = 0, cqRingSize = 0, sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0, numSqEntries = 0, numUnsubmitted = 0;
+
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cqMask = 0;
+
+    void* mapRegion (size_t size, off_t offset) const
+    {
+        auto* m = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+        return m != MAP_FAILED ? m : nullptr;
+    }
+
+    // These must be called with the submission lock held
+    bool push (__u8 opcode, int fd, const void* address, unsigned length, int64 offset, __u64 userData)
+    {
+        const auto tail = *sqTail;
+
+        if (tail - __atomic_load_n (sqHead, __ATOMIC_ACQUIRE) >= numSqEntries)
+            return false;
+
+        const auto index = tail & sqMask;
+        auto& sqe = sqes[index];
+        zerostruct (sqe);
+        sqe.opcode = opcode;
+        sqe.fd = fd;
+        sqe.addr = (__u64) (pointer_sized_uint) address;
+        sqe.len = length;
+        sqe.off = (__u64) offset;
+        sqe.user_data = userData;
+
+        sqArray[index] = index;
+        __atomic_store_n (sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++numUnsubmitted;
+        return true;
+    }
+
+    void pushRequest (Request& request)
+    {
+        auto& vec = iovecs[(size_t) request.index];
+        vec.iov_base = request.buffer + request.numBytesDone;
+        vec.iov_len = request.numBytes - request.numBytesDone;
+
+        // There's always room, because no more requests than the ring holds can be in flight
+        [[maybe_unused]] const auto pushed = push (request.isWrite ? IORING_OP_WRITEV : IORING_OP_READV,
+                                                   getFD (request.file->fileHandle), &vec, 1,
+                                                   request.position + (int64) request.numBytesDone,
+                                                   (__u64) request.index);
+        jassert (pushed);
+    }
+
+    void enter()
+    {
+        while (numUnsubmitted > 0)
+        {
+            const auto result = syscall (__NR_io_uring_enter, ringFd, numUnsubmitted, 0, 0, nullptr, 0);
+
+            if (result >= 0)
+                numUnsubmitted -= (unsigned) result;
+            else if (errno == EAGAIN || errno == EBUSY)
+                Thread::yield();
+            else if (errno != EINTR)
+                break;
+        }
+
+        // If this fails, the requests stay in the ring until the next submission
+        jassert (numUnsubmitted == 0);
+    }
+
+    //==============================================================================
+    void run() override
+    {
+        for (;;)
+        {
+            if (syscall (__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0
+                 && errno != EINTR && errno != EAGAIN)
+            {
+                jassertfalse;
+                Thread::sleep (1);
+            }
+
+            auto head = *cqHead;
+            const auto tail = __atomic_load_n (cqTail, __ATOMIC_ACQUIRE);
+            auto finished = false;
+
+            // Every completion comes from a submission made with this lock held, so taking it
+            // here makes the submitting thread's writes to the requests visible to this one
+            if (head != tail)
+                const std::lock_guard<std::mutex> sl (submissionLock);
+
+            while (head != tail)
+            {
+                const auto cqe = cqes[head & cqMask];
+                __atomic_store_n (cqHead, ++head, __ATOMIC_RELEASE);
+
+                if (cqe.user_data == wakeUpTag)
+                    finished = true;
+                else
+                    handleCompletion (owner.requests[(size_t) cqe.user_data], cqe.res);
+            }
+
+            if (finished && threadShouldExit())
+                return;
+        }
+    }
+
+    void handleCompletion (Request& request, int result)
+    {
+        if (result < 0)
+        {
+            owner.complete (request, Result::fail (String (strerror (-result))));
+            return;
+        }
+
+        request.numBytesDone += (size_t) result;
+
+        if (request.numBytesDone < request.numBytes)
+        {
+            if (result == 0 && request.isWrite)
+            {
+                owner.complete (request, Result::fail ("Couldn't write to the file"));
+                return;
+            }
+
+            // A short read that doesn't end on a block boundary can only be the end of the file
+            const auto reachedEnd = (result == 0)
+                                 || (request.file->isBypassingCache() && (request.numBytesDone % AsyncFile::alignment) != 0);
+
+            if (! reachedEnd)
+            {
+                const std::lock_guard<std::mutex> sl (submissionLock);
+                pushRequest (request);
+                enter();
+                return;
+            }
+        }
+
+        owner.complete (request, Result::ok());
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (IOUringBackend)
+};
+
+std::unique_ptr<AsyncFileIO::Backend> AsyncFileIO::createIOUringBackend (AsyncFileIO& io, int queueDepth)
+{
+    auto backend = std::make_unique<IOUringBackend> (io, queueDepth);
+
+    // The kernel may not support io_uring, or it may be blocked, in which case a thread pool is used instead
+    if (! backend->open ((unsigned) queueDepth))
+        return {};
+
+    return backend;
+}
+
+#endif
+
+} // namespace juce
@@ -487,6 +487,133 @@ Result FileOutputStream::truncate()
                                               : WindowsFileHelpers::getResultForLastError();
 }
 
+//==============================================================================
+void AsyncFile::openHandle (bool bypassCache)
+{
+    const auto access = accessMode == readWrite ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+    const auto share = accessMode == readWrite ? FILE_SHARE_READ : (FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE);
+    const auto disposition = accessMode == readWrite ? OPEN_ALWAYS : OPEN_EXISTING;
+    const auto flags = FILE_ATTRIBUTE_NORMAL | (bypassCache ? (FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH) : 0);
+
+    auto h = CreateFile (file.getFullPathName().toWideCharPointer(),
+                         access, share, nullptr, disposition, (DWORD) flags, nullptr);
+
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        fileHandle = (void*) h;
+        bypassingCache = bypassCache;
+    }
+    else
+    {
+        status = WindowsFileHelpers::getResultForLastError();
+    }
+}
+
+void AsyncFile::closeHandle()
+{
+    if (fileHandle != nullptr)
+    {
+        CloseHandle ((HANDLE) fileHandle);
+        fileHandle = nullptr;
+    }
+}
+
+int64 AsyncFile::getSize() const
+{
+    LARGE_INTEGER size;
+
+    if (fileHandle != nullptr && GetFileSizeEx ((HANDLE) fileHandle, &size))
+        return (int64) size.QuadPart;
+
+    return 0;
+}
+
+Result AsyncFile::read (int64 position, void* destBuffer, size_t numBytes, size_t& numBytesRead) const
+{
+    numBytesRead = 0;
+
+    if (fileHandle == nullptr)
+        return status;
+
+    while (numBytesRead < numBytes)
+    {
+        const auto readPosition = position + (int64) numBytesRead;
+
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD) readPosition;
+        overlapped.OffsetHigh = (DWORD) (readPosition >> 32);
+
+        DWORD actualNum = 0;
+
+        if (! ReadFile ((HANDLE) fileHandle, addBytesToPointer (destBuffer, numBytesRead),
+                        (DWORD) jmin (numBytes - numBytesRead, (size_t) 0x40000000), &actualNum, &overlapped))
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+                break;
+
+            return WindowsFileHelpers::getResultForLastError();
+        }
+
+        numBytesRead += (size_t) actualNum;
+
+        // A short read that doesn't end on a block boundary can only be the end of the file
+        if (actualNum == 0 || (bypassingCache && (numBytesRead % alignment) != 0))
+            break;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::write (int64 position, const void* sourceData, size_t numBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    for (size_t numWritten = 0; numWritten < numBytes;)
+    {
+        const auto writePosition = position + (int64) numWritten;
+
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD) writePosition;
+        overlapped.OffsetHigh = (DWORD) (writePosition >> 32);
+
+        DWORD actualNum = 0;
+
+        if (! WriteFile ((HANDLE) fileHandle, addBytesToPointer (sourceData, numWritten),
+                         (DWORD) jmin (numBytes - numWritten, (size_t) 0x40000000), &actualNum, &overlapped))
+            return WindowsFileHelpers::getResultForLastError();
+
+        if (actualNum == 0)
+            return Result::fail ("Couldn't write to the file");
+
+        numWritten += (size_t) actualNum;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::setSize (int64 newSize)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    FILE_END_OF_FILE_INFO info;
+    info.EndOfFile.QuadPart = newSize;
+
+    return SetFileInformationByHandle ((HANDLE) fileHandle, FileEndOfFileInfo, &info, sizeof (info))
+             ? Result::ok()
+             : WindowsFileHelpers::getResultForLastError();
+}
+
+Result AsyncFile::flush()
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    return FlushFileBuffers ((HANDLE) fileHandle) ? Result::ok()
+                                                  : WindowsFileHelpers::getResultForLastError();
+}
+
 //==============================================================================
 void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive)
 {
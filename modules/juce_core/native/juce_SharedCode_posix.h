@@ -598,6 +598,131 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+//==============================================================================
+void AsyncFile::openHandle (bool bypassCache)
+{
+    const auto flags = accessMode == readWrite ? (O_RDWR | O_CREAT) : O_RDONLY;
+    auto path = file.getFullPathName().toUTF8();
+    auto f = -1;
+
+   #ifdef O_DIRECT
+    if (bypassCache)
+    {
+        // Some file systems, like tmpfs, refuse O_DIRECT, so the file is opened normally instead
+        f = open (path, flags | O_DIRECT, 00644);
+        bypassingCache = (f != -1);
+    }
+   #endif
+
+    if (f == -1)
+        f = open (path, flags, 00644);
+
+    if (f == -1)
+    {
+        status = getResultForErrno();
+        return;
+    }
+
+   #if JUCE_MAC || JUCE_IOS
+    if (bypassCache)
+        bypassingCache = (fcntl (f, F_NOCACHE, 1) != -1);
+   #endif
+
+    fileHandle = fdToVoidPointer (f);
+}
+
+void AsyncFile::closeHandle()
+{
+    if (fileHandle != nullptr)
+    {
+        close (getFD (fileHandle));
+        fileHandle = nullptr;
+    }
+}
+
+int64 AsyncFile::getSize() const
+{
+    struct stat info;
+
+    if (fileHandle != nullptr && fstat (getFD (fileHandle), &info) == 0)
+        return (int64) info.st_size;
+
+    return 0;
+}
+
+Result AsyncFile::read (int64 position, void* destBuffer, size_t numBytes, size_t& numBytesRead) const
+{
+    numBytesRead = 0;
+
+    if (fileHandle == nullptr)
+        return status;
+
+    while (numBytesRead < numBytes)
+    {
+        auto result = pread (getFD (fileHandle), addBytesToPointer (destBuffer, numBytesRead),
+                             numBytes - numBytesRead, (off_t) (position + (int64) numBytesRead));
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return getResultForErrno();
+        }
+
+        numBytesRead += (size_t) result;
+
+        // A short read that doesn't end on a block boundary can only be the end of the file
+        if (result == 0 || (bypassingCache && (numBytesRead % alignment) != 0))
+            break;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::write (int64 position, const void* sourceData, size_t numBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    for (size_t numWritten = 0; numWritten < numBytes;)
+    {
+        auto result = pwrite (getFD (fileHandle), addBytesToPointer (sourceData, numWritten),
+                              numBytes - numWritten, (off_t) (position + (int64) numWritten));
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return getResultForErrno();
+        }
+
+        if (result == 0)
+            return Result::fail ("Couldn't write to the file");
+
+        numWritten += (size_t) result;
+    }
+
+    return Result::ok();
+}
+
+Result AsyncFile::setSize (int64 newSize)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) newSize));
+}
+
+Result AsyncFile::flush()
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    return getResultForReturnValue (fsync (getFD (fileHandle)));
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
@@ -0,0 +1,711 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+/*  The layout of a document, in which every number is little-endian:
+
+    Header (32 bytes):
+        char[4]     magic ("YVAR")
+        uint32      format version
+        uint32      offset of the key table
+        uint32      reserved (0)
+        entry       the root value
+
+    Entry (16 bytes):
+        uint32      type
+        uint32      key index, for the properties of an object
+        uint64      payload: the value of a scalar, the offset of an array or object,
+                    or the offset (low 32 bits) and size (high 32 bits) of a string or
+                    block of binary data
+
+    Array or object (8-byte aligned):
+        uint32      number of items
+        uint32      reserved (0)
+        entry[n]    the items, in their original order
+        uint32[n]   objects only: the indexes of the items, sorted by their names
+
+    Key table (4-byte aligned):
+        uint32      number of keys
+        { uint32 offset, uint32 size }[n]
+
+    Strings, keys and binary data are stored as UTF-8 or raw bytes followed by a zero byte.
+
+    An array or object is always written before the one that contains it, so a nested
+    container's offset is lower than its parent's. Anything else is treated as damage,
+    because it could make a container contain itself.
+*/
+namespace BinaryVarFormat
+{
+    static constexpr char magic[] = { 'Y', 'V', 'A', 'R' };
+    static constexpr uint32 version = 1;
+    static constexpr size_t headerSize = 32;
+    static constexpr size_t rootEntryOffset = 16;
+    static constexpr size_t entrySize = 16;
+    static constexpr size_t containerHeaderSize = 8;
+    static constexpr int maxNestingDepth = 512;
+
+    enum Type : uint32
+    {
+        typeVoid = 0,
+        typeUndefined,
+        typeBool,
+        typeInt,
+        typeInt64,
+        typeDouble,
+        typeString,
+        typeBinary,
+        typeArray,
+        typeObject
+    };
+
+    static bool isInRange (size_t dataSize, uint64 offset, uint64 numBytes) noexcept
+    {
+        return offset <= dataSize && numBytes <= dataSize - offset;
+    }
+
+    static uint32 readUint32 (const char* data, size_t offset) noexcept
+    {
+        return ByteOrder::littleEndianInt (data + offset);
+    }
+
+    //==============================================================================
+    struct Entry
+    {
+        uint32 type, key;
+        uint64 payload;
+    };
+
+    class Writer
+    {
+    public:
+        explicit Writer (MemoryBlock& destination)
+            : out (destination, false)
+        {
+        }
+
+        bool write (const var& value)
+        {
+            out.writeRepeatedByte (0, headerSize);
+            const auto root = writeValue (value);
+            const auto keyTableOffset = writeKeyTable();
+
+            out.setPosition (0);
+            out.write (magic, sizeof (magic));
+            out.writeInt ((int) version);
+            out.writeInt ((int) keyTableOffset);
+            out.writeInt (0);
+            writeEntry (root);
+            out.flush();
+
+            return ! overflowed;
+        }
+
+    private:
+        Entry writeValue (const var& value)
+        {
+            if (value.isVoid())       return { typeVoid, 0, 0 };
+            if (value.isUndefined())  return { typeUndefined, 0, 0 };
+            if (value.isBool())       return { typeBool, 0, static_cast<bool> (value) ? 1u : 0u };
+            if (value.isInt())        return { typeInt, 0, (uint64) (int64) static_cast<int> (value) };
+            if (value.isInt64())      return { typeInt64, 0, (uint64) static_cast<int64> (value) };
+
+            if (value.isDouble())
+            {
+                const auto number = static_cast<double> (value);
+                uint64 bits;
+                std::memcpy (&bits, &number, sizeof (bits));
+                return { typeDouble, 0, bits };
+            }
+
+            if (value.isString())
+            {
+                const auto text = value.toString();
+                return { typeString, 0, writeBytes (text.toRawUTF8(), text.getNumBytesAsUTF8()) };
+            }
+
+            if (auto* block = value.getBinaryData())
+                return { typeBinary, 0, writeBytes (block->getData(), block->getSize()) };
+
+            const auto* array = value.getArray();
+            auto* object = value.getDynamicObject();
+
+            if (array != nullptr || object != nullptr)
+            {
+                if (depth >= maxNestingDepth)
+                {
+                    overflowed = true;
+                    return { typeVoid, 0, 0 };
+                }
+
+                ++depth;
+                const auto entry = array != nullptr ? writeArray (*array) : writeObject (*object);
+                --depth;
+
+                return entry;
+            }
+
+            // Methods and other kinds of object can't be serialised!
+            jassert (value.isMethod() || value.isObject());
+            return { typeVoid, 0, 0 };
+        }
+
+        Entry writeArray (const Array<var>& array)
+        {
+            std::vector<Entry> items;
+            items.reserve ((size_t) array.size());
+
+            for (auto& item : array)
+                items.push_back (writeValue (item));
+
+            const auto offset = beginContainer (items);
+            return { typeArray, 0, offset };
+        }
+
+        Entry writeObject (DynamicObject& object)
+        {
+            auto& properties = object.getProperties();
+            std::vector<Entry> items;
+            items.reserve ((size_t) properties.size());
+
+            for (auto& property : properties)
+            {
+                auto item = writeValue (property.value);
+                item.key = getKeyIndex (property.name);
+                items.push_back (item);
+            }
+
+            std::vector<uint32> sorted (items.size());
+
+            for (size_t i = 0; i < sorted.size(); ++i)
+                sorted[i] = (uint32) i;
+
+            std::sort (sorted.begin(), sorted.end(), [&] (uint32 a, uint32 b)
+            {
+                return getKeyText (items[a].key) < getKeyText (items[b].key);
+            });
+
+            const auto offset = beginContainer (items);
+
+            for (auto index : sorted)
+                out.writeInt ((int) index);
+
+            return { typeObject, 0, offset };
+        }
+
+        uint64 beginContainer (const std::vector<Entry>& items)
+        {
+            align (8);
+            const auto offset = getOffset();
+
+            out.writeInt ((int) items.size());
+            out.writeInt (0);
+
+            for (auto& item : items)
+                writeEntry (item);
+
+            return offset;
+        }
+
+        uint64 writeBytes (const void* bytes, size_t numBytes)
+        {
+            const auto offset = getOffset();
+
+            if (numBytes > std::numeric_limits<uint32>::max())
+                overflowed = true;
+
+            out.write (bytes, numBytes);
+            out.writeByte (0);
+
+            return offset | ((uint64) (uint32) numBytes << 32);
+        }
+
+        void writeEntry (const Entry& entry)
+        {
+            out.writeInt ((int) entry.type);
+            out.writeInt ((int) entry.key);
+            out.writeInt64 ((int64) entry.payload);
+        }
+
+        uint32 getKeyIndex (const Identifier& name)
+        {
+            // Identifiers are pooled, so the text pointer is unique to each name
+            const auto result = keyIndices.emplace (name.getCharPointer().getAddress(), (uint32) keys.size());
+
+            if (result.second)
+                keys.push_back (name);
+
+            return result.first->second;
+        }
+
+        std::string_view getKeyText (uint32 keyIndex) const
+        {
+            const auto& name = keys[(size_t) keyIndex].toString();
+            return { name.toRawUTF8(), name.getNumBytesAsUTF8() };
+        }
+
+        uint32 writeKeyTable()
+        {
+            std::vector<uint64> locations;
+            locations.reserve (keys.size());
+
+            for (size_t i = 0; i < keys.size(); ++i)
+            {
+                const auto text = getKeyText ((uint32) i);
+                locations.push_back (writeBytes (text.data(), text.size()));
+            }
+
+            align (4);
+            const auto offset = (uint32) getOffset();
+
+            out.writeInt ((int) keys.size());
+
+            for (auto location : locations)
+                out.writeInt64 ((int64) location);
+
+            return offset;
+        }
+
+        uint32 getOffset()
+        {
+            const auto position = (uint64) out.getPosition();
+
+            if (position > std::numeric_limits<uint32>::max())
+                overflowed = true;
+
+            return (uint32) position;
+        }
+
+        void align (size_t alignment)
+        {
+            const auto position = (size_t) out.getPosition();
+            out.writeRepeatedByte (0, (alignment - position % alignment) % alignment);
+        }
+
+        MemoryOutputStream out;
+        std::unordered_map<const void*, uint32> keyIndices;
+        std::vector<Identifier> keys;
+        int depth = 0;
+        bool overflowed = false;
+    };
+}
+
+//==============================================================================
+BinaryVarView::BinaryVarView (const char* d, size_t size, const char* entry) noexcept
+    : data (d),
+      dataSize (size),
+      type (ByteOrder::littleEndianInt (entry)),
+      key (ByteOrder::littleEndianInt (entry + 4)),
+      payload (ByteOrder::littleEndianInt64 (entry + 8))
+{
+    if (type > BinaryVarFormat::typeObject)
+        type = BinaryVarFormat::typeVoid;
+}
+
+bool BinaryVarView::isVoid() const noexcept         { return type == BinaryVarFormat::typeVoid; }
+bool BinaryVarView::isUndefined() const noexcept    { return type == BinaryVarFormat::typeUndefined; }
+bool BinaryVarView::isInt() const noexcept          { return type == BinaryVarFormat::typeInt; }
+bool BinaryVarView::isInt64() const noexcept        { return type == BinaryVarFormat::typeInt64; }
+bool BinaryVarView::isBool() const noexcept         { return type == BinaryVarFormat::typeBool; }
+bool BinaryVarView::isDouble() const noexcept       { return type == BinaryVarFormat::typeDouble; }
+bool BinaryVarView::isString() const noexcept       { return type == BinaryVarFormat::typeString; }
+bool BinaryVarView::isArray() const noexcept        { return type == BinaryVarFormat::typeArray; }
+bool BinaryVarView::isObject() const noexcept       { return type == BinaryVarFormat::typeObject; }
+bool BinaryVarView::isBinaryData() const noexcept   { return type == BinaryVarFormat::typeBinary; }
+
+//==============================================================================
+int BinaryVarView::toInt() const noexcept
+{
+    if (type == BinaryVarFormat::typeDouble)
+        return (int) toDouble();
+
+    return (int) toInt64();
+}
+
+int64 BinaryVarView::toInt64() const noexcept
+{
+    switch (type)
+    {
+        case BinaryVarFormat::typeBool:
+        case BinaryVarFormat::typeInt:
+        case BinaryVarFormat::typeInt64:    return (int64) payload;
+        case BinaryVarFormat::typeDouble:   return (int64) toDouble();
+        case BinaryVarFormat::typeString:   return toString().getLargeIntValue();
+        default:                            return 0;
+    }
+}
+
+double BinaryVarView::toDouble() const noexcept
+{
+    switch (type)
+    {
+        case BinaryVarFormat::typeBool:
+        case BinaryVarFormat::typeInt:
+        case BinaryVarFormat::typeInt64:    return (double) (int64) payload;
+        case BinaryVarFormat::typeString:   return toString().getDoubleValue();
+
+        case BinaryVarFormat::typeDouble:
+        {
+            double result;
+            std::memcpy (&result, &payload, sizeof (result));
+            return result;
+        }
+
+        default:                            return 0.0;
+    }
+}
+
+bool BinaryVarView::toBool() const noexcept
+{
+    switch (type)
+    {
+        case BinaryVarFormat::typeBool:
+        case BinaryVarFormat::typeInt:
+        case BinaryVarFormat::typeInt64:    return payload != 0;
+        case BinaryVarFormat::typeDouble:   return toDouble() != 0.0;
+        case BinaryVarFormat::typeString:   return static_cast<bool> (toVar());
+        default:                            return false;
+    }
+}
+
+std::string_view BinaryVarView::getString() const noexcept
+{
+    return type == BinaryVarFormat::typeString ? getBytes() : std::string_view();
+}
+
+String BinaryVarView::toString() const
+{
+    if (type == BinaryVarFormat::typeString)
+    {
+        const auto text = getBytes();
+        return String::fromUTF8 (text.data(), (int) text.size());
+    }
+
+    if (type == BinaryVarFormat::typeArray || type == BinaryVarFormat::typeObject)
+        return {};
+
+    return toVar().toString();
+}
+
+const void* BinaryVarView::getBinaryData() const noexcept
+{
+    return type == BinaryVarFormat::typeBinary ? getBytes().data() : nullptr;
+}
+
+size_t BinaryVarView::getBinaryDataSize() const noexcept
+{
+    return type == BinaryVarFormat::typeBinary ? getBytes().size() : 0;
+}
+
+//==============================================================================
+int BinaryVarView::size() const noexcept
+{
+    uint32 numItems;
+    size_t itemsOffset;
+
+    if (getContainer (BinaryVarFormat::typeArray, numItems, itemsOffset)
+         || getContainer (BinaryVarFormat::typeObject, numItems, itemsOffset))
+        return (int) numItems;
+
+    return 0;
+}
+
+BinaryVarView BinaryVarView::operator[] (int arrayIndex) const noexcept
+{
+    uint32 numItems;
+    size_t itemsOffset;
+
+    if (getContainer (BinaryVarFormat::typeArray, numItems, itemsOffset) && isPositiveAndBelow (arrayIndex, numItems))
+        return getItem (itemsOffset, (uint32) arrayIndex);
+
+    return {};
+}
+
+BinaryVarView BinaryVarView::operator[] (const Identifier& propertyName) const noexcept
+{
+    const auto& name = propertyName.toString();
+    return getProperty (std::string_view (name.toRawUTF8(), name.getNumBytesAsUTF8()));
+}
+
+BinaryVarView BinaryVarView::operator[] (const char* propertyName) const noexcept
+{
+    return getProperty (std::string_view (propertyName));
+}
+
+BinaryVarView BinaryVarView::getProperty (std::string_view utf8PropertyName) const noexcept
+{
+    uint32 numItems;
+    size_t itemsOffset;
+
+    if (! getContainer (BinaryVarFormat::typeObject, numItems, itemsOffset))
+        return {};
+
+    const auto sortedOffset = itemsOffset + numItems * BinaryVarFormat::entrySize;
+    uint32 start = 0, end = numItems;
+
+    while (start < end)
+    {
+        const auto middle = start + (end - start) / 2;
+        const auto index = BinaryVarFormat::readUint32 (data, sortedOffset + middle * sizeof (uint32));
+
+        if (index >= numItems)
+            return {};
+
+        const auto item = getItem (itemsOffset, index);
+        const auto comparison = getKey (item.key).compare (utf8PropertyName);
+
+        if (comparison == 0)
+            return item;
+
+        if (comparison < 0)
+            start = middle + 1;
+        else
+            end = middle;
+    }
+
+    return {};
+}
+
+bool BinaryVarView::hasProperty (std::string_view utf8PropertyName) const noexcept
+{
+    return getProperty (utf8PropertyName).data != nullptr;
+}
+
+std::string_view BinaryVarView::getPropertyName (int index) const noexcept
+{
+    uint32 numItems;
+    size_t itemsOffset;
+
+    if (getContainer (BinaryVarFormat::typeObject, numItems, itemsOffset) && isPositiveAndBelow (index, numItems))
+        return getKey (getItem (itemsOffset, (uint32) index).key);
+
+    return {};
+}
+
+BinaryVarView BinaryVarView::getPropertyValue (int index) const noexcept
+{
+    uint32 numItems;
+    size_t itemsOffset;
+
+    if (getContainer (BinaryVarFormat::typeObject, numItems, itemsOffset) && isPositiveAndBelow (index, numItems))
+        return getItem (itemsOffset, (uint32) index);
+
+    return {};
+}
+
+//==============================================================================
+var BinaryVarView::toVar() const
+{
+    return toVar (0);
+}
+
+var BinaryVarView::toVar (int depth) const
+{
+    // The offset check in getItem() stops a container from containing itself, but a damaged
+    // document could still nest deeply enough to overflow the stack
+    if ((type == BinaryVarFormat::typeArray || type == BinaryVarFormat::typeObject)
+         && depth >= BinaryVarFormat::maxNestingDepth)
+        return {};
+
+    switch (type)
+    {
+        case BinaryVarFormat::typeUndefined:    return var::undefined();
+        case BinaryVarFormat::typeBool:         return var (payload != 0);
+        case BinaryVarFormat::typeInt:          return var ((int) (int64) payload);
+        case BinaryVarFormat::typeInt64:        return var ((int64) payload);
+        case BinaryVarFormat::typeDouble:       return var (toDouble());
+        case BinaryVarFormat::typeString:       return var (toString());
+
+        case BinaryVarFormat::typeBinary:
+        {
+            const auto bytes = getBytes();
+            return var (bytes.data(), bytes.size());
+        }
+
+        case BinaryVarFormat::typeArray:
+        {
+            const auto numItems = size();
+            Array<var> items;
+            items.ensureStorageAllocated (numItems);
+
+            for (int i = 0; i < numItems; ++i)
+                items.add ((*this)[i].toVar (depth + 1));
+
+            return items;
+        }
+
+        case BinaryVarFormat::typeObject:
+        {
+            const auto numItems = size();
+            auto* object = new DynamicObject();
+            var result (object);
+
+            for (int i = 0; i < numItems; ++i)
+            {
+                const auto name = getPropertyName (i);
+
+                if (! name.empty())
+                    object->setProperty (String::fromUTF8 (name.data(), (int) name.size()), getPropertyValue (i).toVar (depth + 1));
+            }
+
+            return result;
+        }
+
+        default:
+            return {};
+    }
+}
+
+//==============================================================================
+bool BinaryVarView::getContainer (uint32 expectedType, uint32& numItems, size_t& itemsOffset) const noexcept
+{
+    if (type != expectedType || ! BinaryVarFormat::isInRange (dataSize, payload, BinaryVarFormat::containerHeaderSize))
+        return false;
+
+    numItems = BinaryVarFormat::readUint32 (data, (size_t) payload);
+    itemsOffset = (size_t) payload + BinaryVarFormat::containerHeaderSize;
+
+    const auto itemSize = BinaryVarFormat::entrySize + (type == BinaryVarFormat::typeObject ? sizeof (uint32) : 0);
+    return BinaryVarFormat::isInRange (dataSize, itemsOffset, (uint64) numItems * itemSize);
+}
+
+BinaryVarView BinaryVarView::getItem (size_t itemsOffset, uint32 index) const noexcept
+{
+    BinaryVarView item { data, dataSize, data + itemsOffset + index * BinaryVarFormat::entrySize };
+
+    // A nested container must have been written before this one, so one that isn't must be
+    // damage, and could refer back to this container or one of its parents
+    if ((item.type == BinaryVarFormat::typeArray || item.type == BinaryVarFormat::typeObject) && item.payload >= payload)
+        return {};
+
+    return item;
+}
+
+std::string_view BinaryVarView::getKey (uint32 keyIndex) const noexcept
+{
+    const auto keyTableOffset = BinaryVarFormat::readUint32 (data, 8);
+    const auto numKeys = BinaryVarFormat::readUint32 (data, keyTableOffset);
+
+    if (keyIndex >= numKeys)
+        return {};
+
+    const auto* location = data + keyTableOffset + sizeof (uint32) + keyIndex * sizeof (uint64);
+    const auto offset = ByteOrder::littleEndianInt (location);
+    const auto numBytes = ByteOrder::littleEndianInt (location + 4);
+
+    if (! BinaryVarFormat::isInRange (dataSize, offset, numBytes))
+        return {};
+
+    return { data + offset, numBytes };
+}
+
+std::string_view BinaryVarView::getBytes() const noexcept
+{
+    const auto offset = (uint32) payload;
+    const auto numBytes = (uint32) (payload >> 32);
+
+    if (! BinaryVarFormat::isInRange (dataSize, offset, numBytes))
+        return {};
+
+    return { data + offset, numBytes };
+}
+
+//==============================================================================
+BinaryVarDocument::BinaryVarDocument (const void* sourceData, size_t numBytes)
+{
+    setData (sourceData, numBytes);
+}
+
+BinaryVarDocument::BinaryVarDocument (MemoryBlock sourceData)
+    : ownedData (std::move (sourceData))
+{
+    setData (ownedData.getData(), ownedData.getSize());
+}
+
+BinaryVarDocument::BinaryVarDocument (const File& file)
+    : mappedFile (std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly))
+{
+    if (mappedFile->getData() != nullptr)
+    {
+        setData (mappedFile->getData(), mappedFile->getSize());
+        return;
+    }
+
+    // Some file systems don't support mapping, so fall back to reading the whole file
+    mappedFile.reset();
+
+    if (file.loadFileAsData (ownedData))
+        setData (ownedData.getData(), ownedData.getSize());
+}
+
+BinaryVarDocument::~BinaryVarDocument() = default;
+
+void BinaryVarDocument::setData (const void* sourceData, size_t numBytes)
+{
+    data = static_cast<const char*> (sourceData);
+    dataSize = numBytes;
+
+    if (data == nullptr
+         || dataSize < BinaryVarFormat::headerSize
+         || std::memcmp (data, BinaryVarFormat::magic, sizeof (BinaryVarFormat::magic)) != 0
+         || BinaryVarFormat::readUint32 (data, 4) != BinaryVarFormat::version)
+        return;
+
+    // The key table is checked here, so views only need to check the keys themselves
+    const auto keyTableOffset = BinaryVarFormat::readUint32 (data, 8);
+
+    if (! BinaryVarFormat::isInRange (dataSize, keyTableOffset, sizeof (uint32)))
+        return;
+
+    const auto numKeys = BinaryVarFormat::readUint32 (data, keyTableOffset);
+    valid = BinaryVarFormat::isInRange (dataSize, keyTableOffset + sizeof (uint32), (uint64) numKeys * sizeof (uint64));
+}
+
+BinaryVarView BinaryVarDocument::getRoot() const noexcept
+{
+    if (! valid)
+        return {};
+
+    return { data, dataSize, data + BinaryVarFormat::rootEntryOffset };
+}
+
+//==============================================================================
+bool BinaryVarDocument::writeToStream (const var& value, OutputStream& output)
+{
+    const auto block = toMemoryBlock (value);
+    return ! block.isEmpty() && output.write (block.getData(), block.getSize());
+}
+
+MemoryBlock BinaryVarDocument::toMemoryBlock (const var& value)
+{
+    MemoryBlock block;
+
+    if (! BinaryVarFormat::Writer (block).write (value))
+    {
+        jassertfalse; // The data is too large for this format!
+        return {};
+    }
+
+    return block;
+}
+
+} // namespace juce
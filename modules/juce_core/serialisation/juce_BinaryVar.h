@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only view of a value inside a BinaryVarDocument.
+
+    A view is just a small handle to some data inside the document, so it's cheap to
+    copy, and looking up an array element or an object property only reads the parts of
+    the document that are needed to find it. Strings and binary data are returned as
+    pointers straight into the document, so nothing is copied unless you call toVar().
+
+    Every offset is checked against the size of the document before it's used, so a
+    damaged or truncated document can't cause a read outside it: an invalid value just
+    behaves like a void one. A damaged document can't make a container contain itself
+    either, and toVar() gives up on containers nested more than 512 deep.
+
+    A view is only valid for as long as the document it came from.
+
+    @see BinaryVarDocument
+
+    @tags{Core}
+*/
+class JUCE_API  BinaryVarView
+{
+public:
+    //==============================================================================
+    /** Creates a view of a void value. */
+    BinaryVarView() noexcept = default;
+
+    //==============================================================================
+    bool isVoid() const noexcept;
+    bool isUndefined() const noexcept;
+    bool isInt() const noexcept;
+    bool isInt64() const noexcept;
+    bool isBool() const noexcept;
+    bool isDouble() const noexcept;
+    bool isString() const noexcept;
+    bool isArray() const noexcept;
+    bool isObject() const noexcept;
+    bool isBinaryData() const noexcept;
+
+    //==============================================================================
+    /** Returns the value as an int, converting numbers and bools in the same way as var does. */
+    int toInt() const noexcept;
+
+    /** Returns the value as an int64, converting numbers and bools in the same way as var does. */
+    int64 toInt64() const noexcept;
+
+    /** Returns the value as a double, converting numbers and bools in the same way as var does. */
+    double toDouble() const noexcept;
+
+    /** Returns the value as a bool, converting numbers in the same way as var does. */
+    bool toBool() const noexcept;
+
+    /** If this is a string, returns its UTF-8 text, which points into the document.
+        For any other type, this returns an empty view.
+    */
+    std::string_view getString() const noexcept;
+
+    /** Returns the value as a String, converting it in the same way as var::toString(). */
+    String toString() const;
+
+    /** If this is a block of binary data, returns a pointer to it inside the document. */
+    const void* getBinaryData() const noexcept;
+
+    /** If this is a block of binary data, returns its size in bytes. */
+    size_t getBinaryDataSize() const noexcept;
+
+    //==============================================================================
+    /** Returns the number of elements in an array, or the number of properties of an object.
+        For any other type, this returns 0.
+    */
+    int size() const noexcept;
+
+    /** Returns one of the elements of an array.
+        If this isn't an array or the index is out of range, this returns a void value.
+    */
+    BinaryVarView operator[] (int arrayIndex) const noexcept;
+
+    /** Returns the value of one of an object's properties, or a void value if there's no
+        property with this name. The properties are kept sorted, so this is a binary search.
+    */
+    BinaryVarView operator[] (const Identifier& propertyName) const noexcept;
+
+    /** Returns the value of one of an object's properties, or a void value if there's no
+        property with this name. The properties are kept sorted, so this is a binary search.
+    */
+    BinaryVarView operator[] (const char* propertyName) const noexcept;
+
+    /** Returns the value of one of an object's properties, or a void value if there's no
+        property with this name. The properties are kept sorted, so this is a binary search.
+    */
+    BinaryVarView getProperty (std::string_view utf8PropertyName) const noexcept;
+
+    /** Returns true if this is an object and it has a property with the given name. */
+    bool hasProperty (std::string_view utf8PropertyName) const noexcept;
+
+    /** Returns the name of one of an object's properties, in the order they were written.
+        If this isn't an object or the index is out of range, this returns an empty view.
+    */
+    std::string_view getPropertyName (int index) const noexcept;
+
+    /** Returns the value of one of an object's properties, in the order they were written.
+        If this isn't an object or the index is out of range, this returns a void value.
+    */
+    BinaryVarView getPropertyValue (int index) const noexcept;
+
+    //==============================================================================
+    /** Decodes this value, including any arrays or objects that it contains, into a var. */
+    var toVar() const;
+
+private:
+    //==============================================================================
+    friend class BinaryVarDocument;
+
+    BinaryVarView (const char* data, size_t dataSize, const char* entry) noexcept;
+
+    bool getContainer (uint32 expectedType, uint32& numItems, size_t& itemsOffset) const noexcept;
+    BinaryVarView getItem (size_t itemsOffset, uint32 index) const noexcept;
+    var toVar (int depth) const;
+    std::string_view getKey (uint32 keyIndex) const noexcept;
+    std::string_view getBytes() const noexcept;
+
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    uint32 type = 0;
+    uint32 key = 0;
+    uint64 payload = 0;
+};
+
+//==============================================================================
+/**
+    Holds a var that has been serialised in a compact, indexed binary format, and gives
+    random access to its contents without decoding the whole thing.
+
+    var::writeToStream() produces a stream of tagged values that has to be read from the
+    start and decoded completely. This format instead stores each array and object as a
+    table of fixed-size entries, so any element can be found directly from its index, and
+    an object's properties are also indexed in sorted order so they can be found by a binary
+    search. Property names are interned, so each distinct name is only stored once, and all
+    scalars are stored as little-endian fixed-width values.
+
+    That means a document can be memory-mapped and used straight away: only the parts that
+    are actually accessed are read, so loading a large preset cache or undo history costs
+    time in proportion to what's used rather than the size of the file.
+
+    @code
+    // Writing
+    FileOutputStream out (file);
+    BinaryVarDocument::writeToStream (state, out);
+
+    // Reading
+    BinaryVarDocument document (file);
+    auto presets = document.getRoot()["presets"];
+
+    for (int i = 0; i < presets.size(); ++i)
+        if (presets[i]["name"].getString() == "Lead")
+            loadPreset (presets[i].toVar());
+    @endcode
+
+    DynamicObjects, arrays, strings, numbers, bools and binary data are stored. Methods and
+    any other kinds of object can't be serialised, so they're written as void values.
+
+    @see BinaryVarView, var::writeToStream
+
+    @tags{Core}
+*/
+class JUCE_API  BinaryVarDocument
+{
+public:
+    //==============================================================================
+    /** Creates a document that reads from a block of memory.
+        The data isn't copied, so it must stay valid for the lifetime of the document.
+    */
+    BinaryVarDocument (const void* data, size_t numBytes);
+
+    /** Creates a document that takes ownership of a block of data. */
+    explicit BinaryVarDocument (MemoryBlock data);
+
+    /** Creates a document that reads from a file, which will be memory-mapped if possible. */
+    explicit BinaryVarDocument (const File& file);
+
+    /** Destructor. */
+    ~BinaryVarDocument();
+
+    //==============================================================================
+    /** Returns true if the data starts with a valid header. */
+    bool isValid() const noexcept                   { return valid; }
+
+    /** Returns the top-level value of the document.
+        If the document isn't valid, this returns a void value.
+    */
+    BinaryVarView getRoot() const noexcept;
+
+    //==============================================================================
+    /** Writes a var to a stream in the binary format.
+        This returns false if the stream couldn't be written to, or the data would be
+        larger than the format's limit of 4GB, or arrays and objects are nested more than
+        512 deep.
+    */
+    static bool writeToStream (const var& value, OutputStream& output);
+
+    /** Returns a block of memory containing a var in the binary format. */
+    static MemoryBlock toMemoryBlock (const var& value);
+
+private:
+    //==============================================================================
+    void setData (const void*, size_t);
+
+    MemoryBlock ownedData;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    bool valid = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BinaryVarDocument)
+};
+
+} // namespace juce
@@ -84,7 +84,18 @@ public:
     static CharPointerType createUninitialisedBytes (size_t numBytes)
     {
         numBytes = (numBytes + 3) & ~(size_t) 3;
-        auto* bytes = new char [sizeof (StringHolder) - sizeof (CharType) + numBytes];
+        char* bytes = nullptr;
+
+        if (numBytes <= SmallBlockCache::numTextBytes)
+        {
+            numBytes = SmallBlockCache::numTextBytes;
+            bytes = SmallBlockCache::allocate();
+        }
+        else
+        {
+            bytes = new char [sizeof (StringHolder) - sizeof (CharType) + numBytes];
+        }
+
         auto s = unalignedPointerCast<StringHolder*> (bytes);
         s->refCount = 0;
         s->allocatedNumBytes = numBytes;
@@ -158,6 +169,15 @@ public:
         return dest;
     }
 
+    static CharPointerType createFromUTF8Bytes (const char* const src, const size_t numBytes)
+    {
+        // The source doesn't need to be null-terminated, so an empty one mustn't be read at all
+        if (numBytes == 0)
+            return CharPointerType (emptyString.text);
+
+        return createFromCharPointer (CharPointer_UTF8 (src), CharPointer_UTF8 (src + numBytes));
+    }
+
     static CharPointerType createFromFixedLength (const char* const src, const size_t numChars)
     {
         auto dest = createUninitialisedBytes (numChars * sizeof (CharType) + sizeof (CharType));
@@ -176,9 +196,11 @@ public:
 
     static void release (StringHolder* const b) noexcept
     {
+        // A count of zero means this is the only reference, so nothing else can be changing
+        // it and the atomic decrement can be skipped
         if (! isEmptyString (b))
-            if (--(b->refCount) == -1)
-                delete[] reinterpret_cast<char*> (b);
+            if (b->refCount.load (std::memory_order_acquire) == 0 || --(b->refCount) == -1)
+                SmallBlockCache::deallocate (reinterpret_cast<char*> (b), b->allocatedNumBytes);
     }
 
     static void release (const CharPointerType text) noexcept
@@ -192,7 +214,7 @@ public:
     }
 
     //==============================================================================
-    static CharPointerType makeUniqueWithByteSize (const CharPointerType text, size_t numBytes)
+    static CharPointerType makeUniqueWithByteSize (const CharPointerType text, size_t numBytes, bool growGeometrically = false)
     {
         auto* b = bufferFromText (text);
 
@@ -203,10 +225,15 @@ public:
             return newText;
         }
 
-        if (b->allocatedNumBytes >= numBytes && b->refCount <= 0)
+        const auto isUnique = b->refCount <= 0;
+
+        if (b->allocatedNumBytes >= numBytes && isUnique)
             return text;
 
-        auto newText = createUninitialisedBytes (jmax (b->allocatedNumBytes, numBytes));
+        const auto newSize = (isUnique && growGeometrically) ? jmax (b->allocatedNumBytes + b->allocatedNumBytes / 2, numBytes)
+                                                             : jmax (b->allocatedNumBytes, numBytes);
+
+        auto newText = createUninitialisedBytes (newSize);
         memcpy (newText.getAddress(), text.getAddress(), b->allocatedNumBytes);
         release (b);
 
@@ -219,6 +246,78 @@ public:
     }
 
 private:
+    /*  Short strings are the most common ones, and are created and destroyed far more often
+        than long ones, so their blocks are all the same size and a few of them are kept
+        by each thread to be reused, rather than going back to the heap every time.
+    */
+    struct SmallBlockCache
+    {
+        static constexpr size_t numTextBytes = 16;
+        static constexpr size_t blockSize = sizeof (StringHolder) - sizeof (CharType) + numTextBytes;
+
+        ~SmallBlockCache()
+        {
+            for (int i = 0; i < numBlocks; ++i)
+                delete[] blocks[i];
+
+            numBlocks = 0;
+            getState() = State::destroyed;
+        }
+
+        static char* allocate()
+        {
+            if (auto* cache = get())
+                if (cache->numBlocks > 0)
+                    return cache->blocks[--cache->numBlocks];
+
+            return new char [blockSize];
+        }
+
+        static void deallocate (char* block, size_t numBytes) noexcept
+        {
+            if (numBytes == numTextBytes)
+            {
+                if (auto* cache = get())
+                {
+                    if (cache->numBlocks < maxNumBlocks)
+                    {
+                        cache->blocks[cache->numBlocks++] = block;
+                        return;
+                    }
+                }
+            }
+
+            delete[] block;
+        }
+
+    private:
+        enum class State : uint8  { unused, active, destroyed };
+
+        static State& getState() noexcept
+        {
+            // This is trivially destructible, so it can still be checked while the thread's
+            // other objects are being destroyed
+            static thread_local State state = State::unused;
+            return state;
+        }
+
+        static SmallBlockCache* get() noexcept
+        {
+            auto& state = getState();
+
+            if (state == State::destroyed)
+                return nullptr;
+
+            static thread_local SmallBlockCache cache;
+            state = State::active;
+            return &cache;
+        }
+
+        static constexpr int maxNumBlocks = 64;
+        char* blocks[maxNumBlocks];
+        int numBlocks = 0;
+    };
+
     StringHolderUtils() = delete;
     ~StringHolderUtils() = delete;
 
@@ -303,6 +402,13 @@ void String::preallocateBytes (const size_t numBytesNeeded)
     text = StringHolderUtils::makeUniqueWithByteSize (text, numBytesNeeded + sizeof (CharPointerType::CharType));
 }
 
+void String::preallocateBytesToAppend (const size_t numBytesNeeded)
+{
+    // A string that isn't shared and keeps growing is being appended to, so its buffer grows
+    // geometrically to avoid copying the whole string for every append
+    text = StringHolderUtils::makeUniqueWithByteSize (text, numBytesNeeded + sizeof (CharPointerType::CharType), true);
+}
+
 int String::getReferenceCount() const noexcept
 {
     return StringHolderUtils::getReferenceCount (text);
@@ -370,8 +476,8 @@ String::String (CharPointer_UTF8  start, CharPointer_UTF8  end)  : text (StringH
 String::String (CharPointer_UTF16 start, CharPointer_UTF16 end)  : text (StringHolderUtils::createFromCharPointer (start, end)) {}
 String::String (CharPointer_UTF32 start, CharPointer_UTF32 end)  : text (StringHolderUtils::createFromCharPointer (start, end)) {}
 
-String::String (const std::string& s) : text (StringHolderUtils::createFromFixedLength (s.data(), s.size())) {}
-String::String (std::string_view s)   : text (StringHolderUtils::createFromFixedLength (s.data(), s.size())) {}
+String::String (const std::string& s) : text (StringHolderUtils::createFromUTF8Bytes (s.data(), s.size())) {}
+String::String (std::string_view s)   : text (StringHolderUtils::createFromUTF8Bytes (s.data(), s.size())) {}
 String::String (StringRef s)          : text (StringHolderUtils::createFromCharPointer (s.text)) {}
 
 String String::charToString (juce_wchar character)
@@ -457,38 +563,34 @@ namespace NumberToStringConverters
         return printDigits (t, v);
     }
 
-    struct StackArrayStream final : public std::basic_streambuf<char, std::char_traits<char>>
+    // Unlike a std::ostream, snprintf doesn't allocate, so this can be used on any thread.
+    // The formats are the ones a classic-locale stream would use for the same settings.
+    static char* doubleToString (char* buffer, double n, int numDecPlaces, bool useScientificNotation, size_t& len) noexcept
     {
-        explicit StackArrayStream (char* d)
-        {
-            static const std::locale classicLocale (std::locale::classic());
-            imbue (classicLocale);
-            setp (d, d + charsNeededForDouble);
-        }
+        // one more character than the result, for the terminator that snprintf adds
+        char text[charsNeededForDouble + 1];
 
-        size_t writeDouble (double n, int numDecPlaces, bool useScientificNotation)
-        {
-            {
-                std::ostream o (this);
+        const auto numChars = numDecPlaces > 0
+                                ? std::snprintf (text, sizeof (text), useScientificNotation ? "%.*e" : "%.*f", numDecPlaces, n)
+                                : std::snprintf (text, sizeof (text), "%g", n);
 
-                if (numDecPlaces > 0)
-                {
-                    o.setf (useScientificNotation ? std::ios_base::scientific : std::ios_base::fixed);
-                    o.precision ((std::streamsize) numDecPlaces);
-                }
+        len = (size_t) jlimit (0, (int) charsNeededForDouble, numChars);
+        std::memcpy (buffer, text, len);
 
-                o << n;
-            }
+        // snprintf uses the C library's locale, which may have a different decimal point
+        const auto* localPoint = std::localeconv()->decimal_point;
+        const auto pointLength = std::strlen (localPoint);
 
-            return (size_t) (pptr() - pbase());
+        if (pointLength > 0 && std::strcmp (localPoint, ".") != 0)
+        {
+            if (auto* point = std::search (buffer, buffer + len, localPoint, localPoint + pointLength); point != buffer + len)
+            {
+                *point = '.';
+                std::memmove (point + 1, point + pointLength, (size_t) (buffer + len - point) - pointLength);
+                len -= pointLength - 1;
+            }
         }
-    };
 
-    static char* doubleToString (char* buffer, double n, int numDecPlaces, bool useScientificNotation, size_t& len) noexcept
-    {
-        StackArrayStream strm (buffer);
-        len = strm.writeDouble (n, numDecPlaces, useScientificNotation);
-        jassert (len <= charsNeededForDouble);
         return buffer;
     }
 
@@ -588,6 +690,29 @@ JUCE_API bool JUCE_CALLTYPE operator!= (const String& s1, const CharPointer_UTF1
 JUCE_API bool JUCE_CALLTYPE operator== (const String& s1, const CharPointer_UTF32 s2) noexcept  { return s1.getCharPointer().compare (s2) == 0; }
 JUCE_API bool JUCE_CALLTYPE operator!= (const String& s1, const CharPointer_UTF32 s2) noexcept  { return s1.getCharPointer().compare (s2) != 0; }
 
+static bool stringEqualsUTF8 (const String& s1, std::string_view s2) noexcept
+{
+   #if JUCE_STRING_UTF_TYPE == 8
+    // The string's length has to be found first, as the view may be longer than its buffer
+    return s1.getNumBytesAsUTF8() == s2.size()
+            && (s2.empty() || std::memcmp (s1.toRawUTF8(), s2.data(), s2.size()) == 0);
+   #else
+    auto t = s1.getCharPointer();
+    CharPointer_UTF8 other (s2.data());
+
+    for (const auto* end = s2.data() + s2.size(); other.getAddress() < end;)
+        if (t.getAndAdvance() != other.getAndAdvance())
+            return false;
+
+    return t.isEmpty();
+   #endif
+}
+
+JUCE_API bool JUCE_CALLTYPE operator== (const String& s1, std::string_view s2) noexcept         { return stringEqualsUTF8 (s1, s2); }
+JUCE_API bool JUCE_CALLTYPE operator!= (const String& s1, std::string_view s2) noexcept         { return ! stringEqualsUTF8 (s1, s2); }
+JUCE_API bool JUCE_CALLTYPE operator== (const String& s1, const std::string& s2) noexcept       { return stringEqualsUTF8 (s1, s2); }
+JUCE_API bool JUCE_CALLTYPE operator!= (const String& s1, const std::string& s2) noexcept       { return ! stringEqualsUTF8 (s1, s2); }
+
 bool String::equalsIgnoreCase (const wchar_t* const t) const noexcept
 {
     return t != nullptr ? text.compareIgnoreCase (castToCharPointer_wchar_t (t)) == 0
@@ -744,7 +869,7 @@ void String::appendCharPointer (const CharPointerType startOfTextToAppend,
     if (extraBytesNeeded > 0)
     {
         auto byteOffsetOfNull = getByteOffsetOfEnd();
-        preallocateBytes ((size_t) extraBytesNeeded + byteOffsetOfNull);
+        preallocateBytesToAppend ((size_t) extraBytesNeeded + byteOffsetOfNull);
 
         auto* newStringStart = addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull);
         memcpy (newStringStart, startOfTextToAppend.getAddress(), (size_t) extraBytesNeeded);
@@ -856,6 +981,14 @@ JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const String& s2)      {
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, StringRef s2)          { return s1 += s2; }
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, const std::string& s2) { return s1 += s2.c_str(); }
 
+JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, std::string_view s2)
+{
+    if (! s2.empty())
+        s1.appendCharPointer (CharPointer_UTF8 (s2.data()), CharPointer_UTF8 (s2.data() + s2.size()));
+
+    return s1;
+}
+
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, uint8  number)         { return s1 += (int) number; }
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, short  number)         { return s1 += (int) number; }
 JUCE_API String& JUCE_CALLTYPE operator<< (String& s1, int    number)         { return s1 += number; }
@@ -2219,20 +2352,23 @@ StringRef::StringRef (const String& string) noexcept   : text (string.getCharPoi
 StringRef::StringRef (const std::string& string)       : StringRef (string.c_str()) {}
 
 //==============================================================================
-static String reduceLengthOfFloatString (const String& input)
+// Removes any redundant zeros from a number, in place, and returns its new length
+static size_t reduceLengthOfFloatString (char* text, size_t length) noexcept
 {
-    const auto start = input.getCharPointer();
-    const auto end = start + (int) input.length();
+    if (length == 0)
+        return 0;
+
+    const size_t end = length;
     auto trimStart = end;
     auto trimEnd = trimStart;
     auto exponentTrimStart = end;
     auto exponentTrimEnd = exponentTrimStart;
 
-    decltype (*start) currentChar = '\0';
+    char currentChar = '\0';
 
-    for (auto c = end - 1; c > start; --c)
+    for (auto c = end - 1; c > 0; --c)
     {
-        currentChar = *c;
+        currentChar = text[c];
 
         if (currentChar == '0' && c + 1 == trimStart)
         {
@@ -2240,7 +2376,7 @@ static String reduceLengthOfFloatString (const String& input)
         }
         else if (currentChar == '.')
         {
-            if (trimStart == c + 1 && trimStart != end && *trimStart == '0')
+            if (trimStart == c + 1 && trimStart != end && text[trimStart] == '0')
                 ++trimStart;
 
             break;
@@ -2251,18 +2387,18 @@ static String reduceLengthOfFloatString (const String& input)
 
             if (cNext != end)
             {
-                if (*cNext == '-')
+                if (text[cNext] == '-')
                     ++cNext;
 
                 exponentTrimStart = cNext;
 
-                if (cNext != end && *cNext == '+')
+                if (cNext != end && text[cNext] == '+')
                     ++cNext;
 
                 exponentTrimEnd = cNext;
             }
 
-            while (cNext != end && *cNext++ == '0')
+            while (cNext != end && text[cNext++] == '0')
                 exponentTrimEnd = cNext;
 
             if (exponentTrimEnd == end)
@@ -2275,34 +2411,44 @@ static String reduceLengthOfFloatString (const String& input)
 
     if ((trimStart != trimEnd && currentChar == '.') || exponentTrimStart != exponentTrimEnd)
     {
-        if (trimStart == trimEnd)
-            return String (start, exponentTrimStart) + String (exponentTrimEnd, end);
-
-        if (exponentTrimStart == exponentTrimEnd)
-            return String (start, trimStart) + String (trimEnd, end);
-
-        if (trimEnd == exponentTrimStart)
-            return String (start, trimStart) + String (exponentTrimEnd, end);
+        const auto removeRange = [&] (size_t rangeStart, size_t rangeEnd)
+        {
+            std::memmove (text + rangeStart, text + rangeEnd, length - rangeEnd);
+            length -= rangeEnd - rangeStart;
+        };
 
-        return String (start, trimStart) + String (trimEnd, exponentTrimStart) + String (exponentTrimEnd, end);
+        // the exponent comes after the mantissa, so removing it first leaves the
+        // mantissa's range where it was
+        removeRange (exponentTrimStart, exponentTrimEnd);
+        removeRange (trimStart, trimEnd);
     }
 
-    return input;
+    return length;
 }
 
 /*  maxDecimalPlaces <= 0 means "use as many decimal places as necessary"
+
+    This writes the number into a buffer of NumberToStringConverters::charsNeededForDouble
+    characters, without a null terminator, and returns its length.
 */
-static String serialiseDouble (double input, int maxDecimalPlaces = 0)
+static size_t serialiseDouble (char* buffer, double input, int maxDecimalPlaces) noexcept
 {
     auto absInput = std::abs (input);
+    size_t length = 0;
 
     if (absInput >= 1.0e6 || absInput <= 1.0e-5)
-        return reduceLengthOfFloatString ({ input, maxDecimalPlaces > 0 ? maxDecimalPlaces : 15, true });
+    {
+        NumberToStringConverters::doubleToString (buffer, input, maxDecimalPlaces > 0 ? maxDecimalPlaces : 15, true, length);
+        return reduceLengthOfFloatString (buffer, length);
+    }
 
     int intInput = (int) input;
 
     if (exactlyEqual ((double) intInput, input))
-        return { input, 1 };
+    {
+        NumberToStringConverters::doubleToString (buffer, input, 1, false, length);
+        return length;
+    }
 
     auto numberOfDecimalPlaces = [absInput, maxDecimalPlaces]
     {
@@ -2334,7 +2480,14 @@ static String serialiseDouble (double input, int maxDecimalPlaces = 0)
         return 10;
     }();
 
-    return reduceLengthOfFloatString (String (input, numberOfDecimalPlaces));
+    NumberToStringConverters::doubleToString (buffer, input, numberOfDecimalPlaces, false, length);
+    return reduceLengthOfFloatString (buffer, length);
+}
+
+static String serialiseDouble (double input, int maxDecimalPlaces = 0)
+{
+    char buffer[NumberToStringConverters::charsNeededForDouble];
+    return String (buffer, serialiseDouble (buffer, input, maxDecimalPlaces));
 }
 
 //==============================================================================
@@ -2357,6 +2510,13 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #define STRINGIFY2(X) #X
 #define STRINGIFY(X) STRINGIFY2(X)
 
+static String reduceLengthOfFloatString (const String& input)
+{
+    auto text = input.toStdString();
+    text.resize (reduceLengthOfFloatString (text.data(), text.size()));
+    return String (text);
+}
+
 class StringTests final : public UnitTest
 {
 public:
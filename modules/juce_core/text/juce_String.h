@@ -165,7 +165,7 @@ public:
     /** Creates a string from a UTF-8 encoded std::string. */
     explicit String (const std::string& text);
 
-    /** Creates a string from a UTF-8 encoded std::string_view. */
+    /** Creates a string from a UTF-8 encoded std::string_view, which doesn't need to be null-terminated. */
     explicit String (std::string_view start);
 
     //==============================================================================
@@ -279,7 +279,7 @@ public:
         {
             auto byteOffsetOfNull = getByteOffsetOfEnd();
 
-            preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
+            preallocateBytesToAppend (byteOffsetOfNull + extraBytesNeeded);
             CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull))
                 .writeWithCharLimit (startOfTextToAppend, (int) numChars);
         }
@@ -307,7 +307,7 @@ public:
             {
                 auto byteOffsetOfNull = getByteOffsetOfEnd();
 
-                preallocateBytes (byteOffsetOfNull + extraBytesNeeded);
+                preallocateBytesToAppend (byteOffsetOfNull + extraBytesNeeded);
                 CharPointerType (addBytesToPointer (text.getAddress(), (int) byteOffsetOfNull))
                     .writeWithCharLimit (textToAppend, (int) numChars);
             }
@@ -1372,6 +1372,7 @@ private:
 
     explicit String (const PreallocationBytes&); // This constructor preallocates a certain amount of memory
     size_t getByteOffsetOfEnd() const noexcept;
+    void preallocateBytesToAppend (size_t numBytesNeeded);
 
     // This private cast operator should prevent strings being accidentally cast
     // to bools (this is possible because the compiler can add an implicit cast
@@ -1441,6 +1442,8 @@ JUCE_API String& JUCE_CALLTYPE operator<< (String& string1, const String& string
 JUCE_API String& JUCE_CALLTYPE operator<< (String& string1, StringRef string2);
 /** Appends a string to the end of the first one. */
 JUCE_API String& JUCE_CALLTYPE operator<< (String& string1, const std::string& string2);
+/** Appends some UTF-8 text to the end of a string. The text doesn't need to be null-terminated. */
+JUCE_API String& JUCE_CALLTYPE operator<< (String& string1, std::string_view string2);
 
 /** Appends a decimal number to the end of a string. */
 JUCE_API String& JUCE_CALLTYPE operator<< (String& string1, uint8 number);
@@ -1480,6 +1483,10 @@ JUCE_API bool JUCE_CALLTYPE operator== (const String& string1, CharPointer_UTF8
 JUCE_API bool JUCE_CALLTYPE operator== (const String& string1, CharPointer_UTF16 string2) noexcept;
 /** Case-sensitive comparison of two strings. */
 JUCE_API bool JUCE_CALLTYPE operator== (const String& string1, CharPointer_UTF32 string2) noexcept;
+/** Case-sensitive comparison of a string with some UTF-8 text, which doesn't need to be null-terminated. */
+JUCE_API bool JUCE_CALLTYPE operator== (const String& string1, std::string_view string2) noexcept;
+/** Case-sensitive comparison of a string with some UTF-8 text. */
+JUCE_API bool JUCE_CALLTYPE operator== (const String& string1, const std::string& string2) noexcept;
 
 /** Case-sensitive comparison of two strings. */
 JUCE_API bool JUCE_CALLTYPE operator!= (const String& string1, const String& string2) noexcept;
@@ -1493,6 +1500,10 @@ JUCE_API bool JUCE_CALLTYPE operator!= (const String& string1, CharPointer_UTF8
 JUCE_API bool JUCE_CALLTYPE operator!= (const String& string1, CharPointer_UTF16 string2) noexcept;
 /** Case-sensitive comparison of two strings. */
 JUCE_API bool JUCE_CALLTYPE operator!= (const String& string1, CharPointer_UTF32 string2) noexcept;
+/** Case-sensitive comparison of a string with some UTF-8 text, which doesn't need to be null-terminated. */
+JUCE_API bool JUCE_CALLTYPE operator!= (const String& string1, std::string_view string2) noexcept;
+/** Case-sensitive comparison of a string with some UTF-8 text. */
+JUCE_API bool JUCE_CALLTYPE operator!= (const String& string1, const std::string& string2) noexcept;
 
 //==============================================================================
 /** This operator allows you to write a juce String directly to std output streams.
@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+#if JUCE_WINDOWS
+
+class LightweightSemaphore::NativeSemaphore
+{
+public:
+    NativeSemaphore() : handle (CreateSemaphoreW (nullptr, 0, std::numeric_limits<LONG>::max(), nullptr)) {}
+    ~NativeSemaphore()                      { CloseHandle (handle); }
+
+    bool wait (int timeOutMilliseconds) noexcept
+    {
+        return WaitForSingleObject (handle, timeOutMilliseconds < 0 ? INFINITE : (DWORD) timeOutMilliseconds) == WAIT_OBJECT_0;
+    }
+
+    bool tryWait() noexcept                 { return wait (0); }
+    void signal (int count) noexcept        { ReleaseSemaphore (handle, (LONG) count, nullptr); }
+
+private:
+    HANDLE handle;
+};
+
+#elif JUCE_MAC || JUCE_IOS
+
+class LightweightSemaphore::NativeSemaphore
+{
+public:
+    NativeSemaphore() : semaphore (dispatch_semaphore_create (0)) {}
+    ~NativeSemaphore()                      { dispatch_release (semaphore); }
+
+    bool wait (int timeOutMilliseconds) noexcept
+    {
+        const auto timeout = timeOutMilliseconds < 0 ? DISPATCH_TIME_FOREVER
+                                                     : dispatch_time (DISPATCH_TIME_NOW, (int64_t) timeOutMilliseconds * 1000000);
+        return dispatch_semaphore_wait (semaphore, timeout) == 0;
+    }
+
+    bool tryWait() noexcept                 { return dispatch_semaphore_wait (semaphore, DISPATCH_TIME_NOW) == 0; }
+
+    void signal (int count) noexcept
+    {
+        while (--count >= 0)
+            dispatch_semaphore_signal (semaphore);
+    }
+
+private:
+    dispatch_semaphore_t semaphore;
+};
+
+#else
+
+class LightweightSemaphore::NativeSemaphore
+{
+public:
+    NativeSemaphore()                       { sem_init (&semaphore, 0, 0); }
+    ~NativeSemaphore()                      { sem_destroy (&semaphore); }
+
+    bool wait (int timeOutMilliseconds) noexcept
+    {
+        if (timeOutMilliseconds < 0)
+        {
+            while (sem_wait (&semaphore) != 0)
+                if (errno != EINTR)
+                    return false;
+
+            return true;
+        }
+
+        timespec deadline;
+        clock_gettime (CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeOutMilliseconds / 1000;
+        deadline.tv_nsec += (long) (timeOutMilliseconds % 1000) * 1000000;
+
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_nsec -= 1000000000;
+            ++deadline.tv_sec;
+        }
+
+        while (sem_timedwait (&semaphore, &deadline) != 0)
+            if (errno != EINTR)
+                return false;
+
+        return true;
+    }
+
+    bool tryWait() noexcept
+    {
+        while (sem_trywait (&semaphore) != 0)
+            if (errno != EINTR)
+                return false;
+
+        return true;
+    }
+
+    void signal (int count) noexcept
+    {
+        while (--count >= 0)
+            sem_post (&semaphore);
+    }
+
+private:
+    sem_t semaphore;
+};
+
+#endif
+
+//==============================================================================
+LightweightSemaphore::LightweightSemaphore (int initialCount)
+    : count (initialCount),
+      native (std::make_unique<NativeSemaphore>())
+{
+    jassert (initialCount >= 0);
+}
+
+LightweightSemaphore::~LightweightSemaphore() = default;
+
+bool LightweightSemaphore::tryWait() noexcept
+{
+    auto oldCount = count.load (std::memory_order_relaxed);
+
+    while (oldCount > 0)
+        if (count.compare_exchange_weak (oldCount, oldCount - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+
+    return false;
+}
+
+bool LightweightSemaphore::wait (int timeOutMilliseconds) noexcept
+{
+    // A signal usually follows soon after a worker runs out of work, so spinning for a
+    // little while first avoids most trips through the OS
+    for (int spin = 0; spin < 1000; ++spin)
+    {
+        if (tryWait())
+            return true;
+
+        if (timeOutMilliseconds == 0)
+            return false;
+    }
+
+    if (count.fetch_sub (1, std::memory_order_acquire) > 0)
+        return true;
+
+    if (native->wait (timeOutMilliseconds))
+        return true;
+
+    // The wait timed out, so this thread has to take itself off the count again. If a
+    // signal has slipped in and already counted it as parked, the signal is consumed instead.
+    for (;;)
+    {
+        auto oldCount = count.load (std::memory_order_acquire);
+
+        if (oldCount >= 0 && native->tryWait())
+            return true;
+
+        if (oldCount < 0 && count.compare_exchange_strong (oldCount, oldCount + 1, std::memory_order_relaxed))
+            return false;
+    }
+}
+
+void LightweightSemaphore::signal (int numToSignal) noexcept
+{
+    jassert (numToSignal >= 0);
+
+    const auto oldCount = count.fetch_add (numToSignal, std::memory_order_release);
+    const auto numToWake = jmin (-oldCount, numToSignal);
+
+    if (numToWake > 0)
+        native->signal (numToWake);
+}
+
+} // namespace juce
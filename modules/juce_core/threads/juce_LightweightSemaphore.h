@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A counting semaphore that can be signalled from a realtime thread.
+
+    Unlike WaitableEvent, signal() never takes a lock: it's a single atomic add,
+    and it only calls into the OS semaphore when a thread is actually parked. The
+    waiting side spins for a short while before parking, so a thread that's woken
+    up again quickly doesn't have to go through the OS at all.
+
+    This makes it suitable for waking worker threads from an audio callback.
+
+    @see WaitableEvent
+
+    @tags{Core}
+*/
+class JUCE_API  LightweightSemaphore
+{
+public:
+    //==============================================================================
+    /** Creates a semaphore with the given count. */
+    explicit LightweightSemaphore (int initialCount = 0);
+
+    /** Destructor. */
+    ~LightweightSemaphore();
+
+    //==============================================================================
+    /** Waits until the count is above zero, and then decrements it.
+
+        @param timeOutMilliseconds  the maximum time to wait, in milliseconds. A negative
+                                    value will cause it to wait forever.
+
+        @returns    true if the count was decremented, false if the timeout expired first.
+    */
+    bool wait (int timeOutMilliseconds = -1) noexcept;
+
+    /** Decrements the count if it's above zero, without waiting.
+        @returns    true if the count was decremented.
+    */
+    bool tryWait() noexcept;
+
+    /** Increments the count, waking up to that many waiting threads.
+        This is lock-free, and is safe to call from a realtime thread.
+    */
+    void signal (int count = 1) noexcept;
+
+private:
+    //==============================================================================
+    class NativeSemaphore;
+
+    // A negative count is the number of threads that are parked on the native semaphore
+    std::atomic<int> count;
+    std::unique_ptr<NativeSemaphore> native;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LightweightSemaphore)
+};
+
+} // namespace juce
@@ -40,29 +40,7 @@
 namespace juce
 {
 
-struct ThreadPool::ThreadPoolThread final : public Thread
-{
-    ThreadPoolThread (ThreadPool& p, const Options& options)
-       : Thread { options.threadName, options.threadStackSizeBytes },
-         pool { p }
-    {
-    }
-
-    void run() override
-    {
-        while (! threadShouldExit())
-        {
-            if (! pool.runNextJob (*this))
-                wait (500);
-        }
-    }
-
-    std::atomic<ThreadPoolJob*> currentJob { nullptr };
-
-    ThreadPool& pool;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
-};
+static thread_local ThreadPoolJob* currentThreadPoolJob = nullptr;
 
 //==============================================================================
 ThreadPoolJob::ThreadPoolJob (const String& name)  : jobName (name)
@@ -104,23 +82,195 @@ void ThreadPoolJob::removeListener (Thread::Listener* listener)
 
 ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 {
-    if (auto* t = dynamic_cast<ThreadPool::ThreadPoolThread*> (Thread::getCurrentThread()))
-        return t->currentJob.load();
-
-    return nullptr;
+    return currentThreadPoolJob;
 }
 
+//==============================================================================
+/*  The queue of jobs that are waiting to run.
+
+    Most entries go into a fixed-size ring that any number of threads can push to and pop
+    from without locking. If that fills up, entries wait in an overflow list until there's
+    room, and jobs that have been moved to the front go into a separate list that's checked
+    first. Both of those lists have their own lock, but it's only taken when they aren't empty.
+
+    An entry stays valid only while its ticket matches the one stored in the job, so moving
+    or removing a job just leaves its old entry behind to be skipped.
+*/
+class ThreadPool::JobQueue
+{
+public:
+    struct Entry
+    {
+        ThreadPoolJob* job = nullptr;
+        int64 ticket = 0;
+    };
+
+    JobQueue()
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            cells[i].sequence.store (i, std::memory_order_relaxed);
+    }
+
+    void push (const Entry& entry)
+    {
+        // Once anything has overflowed, new entries have to go after it to keep them in order
+        if (numOverflowing.load() == 0 && tryPush (entry))
+            return;
+
+        const SpinLock::ScopedLockType sl (overflowLock);
+        overflow.add (entry);
+        numOverflowing.store (overflow.size());
+    }
+
+    void pushFront (const Entry& entry)
+    {
+        const SpinLock::ScopedLockType sl (frontLock);
+        front.add (entry);
+        numAtFront.store (front.size());
+    }
+
+    bool pop (Entry& result)
+    {
+        if (numAtFront.load() > 0)
+        {
+            const SpinLock::ScopedLockType sl (frontLock);
+
+            if (! front.isEmpty())
+            {
+                result = front.removeAndReturn (front.size() - 1);
+                numAtFront.store (front.size());
+                return true;
+            }
+        }
+
+        if (tryPop (result))
+            return true;
+
+        if (numOverflowing.load() > 0)
+        {
+            const SpinLock::ScopedLockType sl (overflowLock);
+
+            int numMoved = 0;
+
+            while (numMoved < overflow.size() && tryPush (overflow.getReference (numMoved)))
+                ++numMoved;
+
+            overflow.removeRange (0, numMoved);
+            numOverflowing.store (overflow.size());
+        }
+
+        return tryPop (result);
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return numAtFront.load() == 0
+            && numOverflowing.load() == 0
+            && enqueuePosition.load() == dequeuePosition.load();
+    }
+
+private:
+    static constexpr size_t capacity = 1024;
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence { 0 };
+        Entry entry;
+    };
+
+    // Each cell's sequence number says whether it's ready to be written or read at a given
+    // position, so producers and consumers only ever compete for the position counters
+    bool tryPush (const Entry& entry)
+    {
+        auto position = enqueuePosition.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[position & (capacity - 1)];
+            const auto difference = (intptr_t) cell.sequence.load (std::memory_order_acquire) - (intptr_t) position;
+
+            if (difference == 0)
+            {
+                if (enqueuePosition.compare_exchange_weak (position, position + 1))
+                {
+                    cell.entry = entry;
+                    cell.sequence.store (position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = enqueuePosition.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop (Entry& result)
+    {
+        auto position = dequeuePosition.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& cell = cells[position & (capacity - 1)];
+            const auto difference = (intptr_t) cell.sequence.load (std::memory_order_acquire) - (intptr_t) (position + 1);
+
+            if (difference == 0)
+            {
+                if (dequeuePosition.compare_exchange_weak (position, position + 1))
+                {
+                    result = cell.entry;
+                    cell.sequence.store (position + capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = dequeuePosition.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Cell cells[capacity];
+    std::atomic<size_t> enqueuePosition { 0 }, dequeuePosition { 0 };
+
+    SpinLock overflowLock, frontLock;
+    Array<Entry> overflow, front;
+    std::atomic<int> numOverflowing { 0 }, numAtFront { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (JobQueue)
+};
+
+//==============================================================================
+/*  The jobs in the pool are spread over several of these according to their addresses, so
+    that threads working on different jobs don't contend for the same lock.
+*/
+struct alignas (64) ThreadPool::JobShard
+{
+    CriticalSection lock;
+    Array<ThreadPoolJob*> jobs;
+};
+
 //==============================================================================
 ThreadPool::ThreadPool (const Options& options)
+    : shards (std::make_unique<JobShard[]> (numShards)),
+      queue (std::make_unique<JobQueue>())
 {
     // not much point having a pool without any threads!
     jassert (options.numberOfThreads > 0);
 
-    for (int i = jmax (1, options.numberOfThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this, options));
-
-    for (auto* t : threads)
-        t->startThread (options.desiredThreadPriority);
+    scheduler = std::make_unique<WorkStealingScheduler> (WorkStealingScheduler::Options{}
+                                                             .withThreadName (options.threadName)
+                                                             .withNumberOfThreads (jmax (1, options.numberOfThreads))
+                                                             .withThreadStackSizeBytes (options.threadStackSizeBytes)
+                                                             .withDesiredThreadPriority (options.desiredThreadPriority));
 }
 
 ThreadPool::ThreadPool (int numberOfThreads,
@@ -140,11 +290,43 @@ ThreadPool::~ThreadPool()
 
 void ThreadPool::stopThreads()
 {
-    for (auto* t : threads)
-        t->signalThreadShouldExit();
+    scheduler->stopThreads (500);
+}
+
+ThreadPool::JobShard& ThreadPool::getShardFor (const ThreadPoolJob* job) const noexcept
+{
+    const auto address = (pointer_sized_uint) job;
+    return shards[((address >> 4) ^ (address >> 12)) & (numShards - 1)];
+}
 
-    for (auto* t : threads)
-        t->stopThread (500);
+void ThreadPool::removeFromShard (JobShard& shard, ThreadPoolJob* job)
+{
+    shard.jobs.removeFirstMatchingValue (job);
+    numJobs.fetch_sub (1);
+}
+
+void ThreadPool::queueJob (ThreadPoolJob* job, int64 ticket, bool atFront)
+{
+    if (atFront)
+        queue->pushFront ({ job, ticket });
+    else
+        queue->push ({ job, ticket });
+
+    // Each runner keeps running jobs until there are none left, so there's
+    // only any need to start another one if some of the threads are idle
+    if (tryToAddRunner())
+        scheduler->submit ([this] { runJobs(); });
+}
+
+bool ThreadPool::tryToAddRunner() noexcept
+{
+    auto num = numRunners.load();
+
+    while (num < scheduler->getNumThreads())
+        if (numRunners.compare_exchange_weak (num, num + 1))
+            return true;
+
+    return false;
 }
 
 void ThreadPool::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished)
@@ -159,13 +341,17 @@ void ThreadPool::addJob (ThreadPoolJob* job, bool deleteJobWhenFinished)
         job->isActive = false;
         job->shouldBeDeleted = deleteJobWhenFinished;
 
+        const auto ticket = nextTicket.fetch_add (1);
+
         {
-            const ScopedLock sl (lock);
-            jobs.add (job);
+            auto& shard = getShardFor (job);
+            const ScopedLock sl (shard.lock);
+            job->queueTicket = ticket;
+            shard.jobs.add (job);
+            numJobs.fetch_add (1);
         }
 
-        for (auto* t : threads)
-            t->notify();
+        queueJob (job, ticket, false);
     }
 }
 
@@ -197,41 +383,75 @@ void ThreadPool::addJob (std::function<void()> jobToRun)
 
 int ThreadPool::getNumJobs() const noexcept
 {
-    const ScopedLock sl (lock);
-    return jobs.size();
+    return numJobs.load();
 }
 
 int ThreadPool::getNumThreads() const noexcept
 {
-    return threads.size();
+    return scheduler->getNumThreads();
 }
 
-ThreadPoolJob* ThreadPool::getJob (int index) const noexcept
+Array<ThreadPoolJob*> ThreadPool::getJobsInQueueOrder() const
 {
-    const ScopedLock sl (lock);
-    return jobs [index];
+    Array<std::pair<int64, ThreadPoolJob*>> tickets;
+
+    for (int i = 0; i < numShards; ++i)
+    {
+        auto& shard = shards[i];
+        const ScopedLock sl (shard.lock);
+
+        for (auto* job : shard.jobs)
+            tickets.add ({ job->queueTicket, job });
+    }
+
+    std::sort (tickets.begin(), tickets.end());
+
+    Array<ThreadPoolJob*> result;
+    result.ensureStorageAllocated (tickets.size());
+
+    for (auto& t : tickets)
+        result.add (t.second);
+
+    return result;
+}
+
+ThreadPoolJob* ThreadPool::getJob (int index) const
+{
+    return getJobsInQueueOrder()[index];
 }
 
 bool ThreadPool::contains (const ThreadPoolJob* job) const noexcept
 {
-    const ScopedLock sl (lock);
-    return jobs.contains (const_cast<ThreadPoolJob*> (job));
+    auto& shard = getShardFor (job);
+    const ScopedLock sl (shard.lock);
+    return shard.jobs.contains (const_cast<ThreadPoolJob*> (job));
 }
 
 bool ThreadPool::isJobRunning (const ThreadPoolJob* job) const noexcept
 {
-    const ScopedLock sl (lock);
-    return jobs.contains (const_cast<ThreadPoolJob*> (job)) && job->isActive;
+    auto& shard = getShardFor (job);
+    const ScopedLock sl (shard.lock);
+    return shard.jobs.contains (const_cast<ThreadPoolJob*> (job)) && job->isActive;
 }
 
 void ThreadPool::moveJobToFront (const ThreadPoolJob* job) noexcept
 {
-    const ScopedLock sl (lock);
+    auto* jobToMove = const_cast<ThreadPoolJob*> (job);
+    int64 ticket = 0;
+
+    {
+        auto& shard = getShardFor (jobToMove);
+        const ScopedLock sl (shard.lock);
 
-    auto index = jobs.indexOf (const_cast<ThreadPoolJob*> (job));
+        if (! shard.jobs.contains (jobToMove) || jobToMove->isActive)
+            return;
+
+        // Front tickets count downwards, so that the last job moved comes first
+        ticket = nextFrontTicket.fetch_sub (1);
+        jobToMove->queueTicket = ticket;
+    }
 
-    if (index > 0 && ! job->isActive)
-        jobs.move (index, 0);
+    queueJob (jobToMove, ticket, true);
 }
 
 bool ThreadPool::waitForJobToFinish (const ThreadPoolJob* job, int timeOutMs) const
@@ -259,9 +479,10 @@ bool ThreadPool::removeJob (ThreadPoolJob* job, bool interruptIfRunning, int tim
 
     if (job != nullptr)
     {
-        const ScopedLock sl (lock);
+        auto& shard = getShardFor (job);
+        const ScopedLock sl (shard.lock);
 
-        if (jobs.contains (job))
+        if (shard.jobs.contains (job))
         {
             if (job->isActive)
             {
@@ -272,7 +493,7 @@ bool ThreadPool::removeJob (ThreadPoolJob* job, bool interruptIfRunning, int tim
             }
             else
             {
-                jobs.removeFirstMatchingValue (job);
+                removeFromShard (shard, job);
                 addToDeleteList (deletionList, job);
             }
         }
@@ -286,15 +507,17 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
 {
     Array<ThreadPoolJob*> jobsToWaitFor;
 
+    for (int s = 0; s < numShards; ++s)
     {
         OwnedArray<ThreadPoolJob> deletionList;
 
         {
-            const ScopedLock sl (lock);
+            auto& shard = shards[s];
+            const ScopedLock sl (shard.lock);
 
-            for (int i = jobs.size(); --i >= 0;)
+            for (int i = shard.jobs.size(); --i >= 0;)
             {
-                auto* job = jobs.getUnchecked (i);
+                auto* job = shard.jobs.getUnchecked (i);
 
                 if (selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
                 {
@@ -307,7 +530,7 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
                     }
                     else
                     {
-                        jobs.remove (i);
+                        removeFromShard (shard, job);
                         addToDeleteList (deletionList, job);
                     }
                 }
@@ -342,9 +565,8 @@ bool ThreadPool::removeAllJobs (bool interruptRunningJobs, int timeOutMs,
 StringArray ThreadPool::getNamesOfAllJobs (bool onlyReturnActiveJobs) const
 {
     StringArray s;
-    const ScopedLock sl (lock);
 
-    for (auto* job : jobs)
+    for (auto* job : getJobsInQueueOrder())
         if (job->isActive || ! onlyReturnActiveJobs)
             s.add (job->getJobName());
 
@@ -353,41 +575,60 @@ StringArray ThreadPool::getNamesOfAllJobs (bool onlyReturnActiveJobs) const
 
 ThreadPoolJob* ThreadPool::pickNextJobToRun()
 {
-    OwnedArray<ThreadPoolJob> deletionList;
+    JobQueue::Entry entry;
 
+    while (queue->pop (entry))
     {
-        const ScopedLock sl (lock);
+        OwnedArray<ThreadPoolJob> deletionList;
 
-        for (int i = 0; i < jobs.size(); ++i)
-        {
-            if (auto* job = jobs[i])
-            {
-                if (! job->isActive)
-                {
-                    if (job->shouldStop)
-                    {
-                        jobs.remove (i);
-                        addToDeleteList (deletionList, job);
-                        --i;
-                        continue;
-                    }
+        // The job might have been removed, finished or moved since it was queued, and if
+        // it's not in the pool any more, it may have been deleted, so this checks that it's
+        // still there before looking at it
+        auto& shard = getShardFor (entry.job);
+        const ScopedLock sl (shard.lock);
 
-                    job->isActive = true;
-                    return job;
-                }
-            }
+        auto* job = entry.job;
+
+        if (! shard.jobs.contains (job) || job->queueTicket != entry.ticket || job->isActive)
+            continue;
+
+        if (job->shouldStop)
+        {
+            removeFromShard (shard, job);
+            addToDeleteList (deletionList, job);
+            continue;
         }
+
+        job->isActive = true;
+        return job;
     }
 
     return nullptr;
 }
 
-bool ThreadPool::runNextJob (ThreadPoolThread& thread)
+void ThreadPool::runJobs()
+{
+    for (;;)
+    {
+        while (runNextJob())
+        {}
+
+        // The count is dropped before checking the queue again, so if a job was added
+        // after this runner found the queue empty, either its addJob() call sees this
+        // runner stopping and starts another one, or this runner sees the job
+        numRunners.fetch_sub (1);
+
+        if (queue->isEmpty() || ! tryToAddRunner())
+            return;
+    }
+}
+
+bool ThreadPool::runNextJob()
 {
     if (auto* job = pickNextJobToRun())
     {
         auto result = ThreadPoolJob::jobHasFinished;
-        thread.currentJob = job;
+        currentThreadPoolJob = job;
 
         try
         {
@@ -398,20 +639,22 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
             jassertfalse; // Your runJob() method mustn't throw any exceptions!
         }
 
-        thread.currentJob = nullptr;
+        currentThreadPoolJob = nullptr;
 
+        int64 ticketToQueue = 0;
         OwnedArray<ThreadPoolJob> deletionList;
 
         {
-            const ScopedLock sl (lock);
+            auto& shard = getShardFor (job);
+            const ScopedLock sl (shard.lock);
 
-            if (jobs.contains (job))
+            if (shard.jobs.contains (job))
             {
                 job->isActive = false;
 
                 if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
                 {
-                    jobs.removeFirstMatchingValue (job);
+                    removeFromShard (shard, job);
                     addToDeleteList (deletionList, job);
 
                     jobFinishedSignal.signal();
@@ -419,11 +662,17 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
                 else
                 {
                     // move the job to the end of the queue if it wants another go
-                    jobs.move (jobs.indexOf (job), -1);
+                    ticketToQueue = nextTicket.fetch_add (1);
+                    job->queueTicket = ticketToQueue;
                 }
             }
         }
 
+        // The job may be removed as soon as the lock is released, so it mustn't be
+        // touched again here
+        if (ticketToQueue != 0)
+            queueJob (job, ticketToQueue, false);
+
         return true;
     }
 
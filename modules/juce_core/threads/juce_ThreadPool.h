@@ -151,6 +151,7 @@ private:
     friend class ThreadPool;
     String jobName;
     ThreadPool* pool = nullptr;
+    int64 queueTicket = 0;
     std::atomic<bool> shouldStop { false }, isActive { false }, shouldBeDeleted { false };
     ListenerList<Thread::Listener, Array<Thread::Listener*, CriticalSection>> listeners;
 
@@ -210,7 +211,10 @@ struct ThreadPoolOptions
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
-    @see ThreadPoolJob, Thread
+    The threads are the workers of a WorkStealingScheduler, so use one of those directly
+    if you have lots of small tasks to run rather than a list of long-running jobs.
+
+    @see ThreadPoolJob, Thread, WorkStealingScheduler
 
     @tags{Core}
 */
@@ -351,8 +355,11 @@ public:
 
         Note that this can be a very volatile list as jobs might be continuously getting shifted
         around in the list, and this method may return nullptr if the index is currently out-of-range.
+
+        The jobs are spread over several internal queues, so this has to gather and sort them
+        all to find the one at this index, which allocates memory.
     */
-    ThreadPoolJob* getJob (int index) const noexcept;
+    ThreadPoolJob* getJob (int index) const;
 
     /** Returns true if the given job is currently queued or running.
 
@@ -386,16 +393,26 @@ public:
 
 private:
     //==============================================================================
-    Array<ThreadPoolJob*> jobs;
+    class JobQueue;
+    struct JobShard;
+    static constexpr int numShards = 32;
 
-    struct ThreadPoolThread;
     friend class ThreadPoolJob;
-    OwnedArray<ThreadPoolThread> threads;
+    std::unique_ptr<JobShard[]> shards;
+    std::unique_ptr<JobQueue> queue;
+    std::unique_ptr<WorkStealingScheduler> scheduler;
+    std::atomic<int> numJobs { 0 }, numRunners { 0 };
+    std::atomic<int64> nextTicket { 1 }, nextFrontTicket { -1 };
 
-    CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
-    bool runNextJob (ThreadPoolThread&);
+    JobShard& getShardFor (const ThreadPoolJob*) const noexcept;
+    void removeFromShard (JobShard&, ThreadPoolJob*);
+    Array<ThreadPoolJob*> getJobsInQueueOrder() const;
+    void queueJob (ThreadPoolJob*, int64 ticket, bool atFront);
+    bool tryToAddRunner() noexcept;
+    void runJobs();
+    bool runNextJob();
     ThreadPoolJob* pickNextJobToRun();
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     void stopThreads();
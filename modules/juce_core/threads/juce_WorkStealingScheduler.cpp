@@ -0,0 +1,479 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static constexpr uint32 noTaskSlot = 0xffffffff;
+
+//==============================================================================
+struct WorkStealingScheduler::Slot
+{
+    Task task;
+    TaskGroup* group = nullptr;
+    std::atomic<uint32> next { noTaskSlot };
+};
+
+//==============================================================================
+/*  A fixed-size Chase-Lev deque of slot indices. The worker that owns it pushes and pops
+    at the bottom, and other threads steal from the top.
+*/
+class WorkStealingScheduler::TaskQueue
+{
+public:
+    explicit TaskQueue (uint32 capacity)
+        : mask ((int64) nextPowerOfTwo ((int) jmax ((uint32) 1, capacity)) - 1)
+        , items (new std::atomic<uint32>[(size_t) (mask + 1)])
+    {
+    }
+
+    bool push (uint32 item) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+
+        if (b - top.load (std::memory_order_acquire) > mask)
+            return false;
+
+        items[(size_t) (b & mask)].store (item, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop (uint32& item) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = items[(size_t) (b & mask)].load (std::memory_order_relaxed);
+
+        if (t < b)
+            return true;
+
+        // This was the last item, so race any thieves for it
+        const auto won = top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store (b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    bool steal (uint32& item) noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        item = items[(size_t) (t & mask)].load (std::memory_order_relaxed);
+        return top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    const int64 mask;
+    std::unique_ptr<std::atomic<uint32>[]> items;
+    std::atomic<int64> top { 0 }, bottom { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (TaskQueue)
+};
+
+//==============================================================================
+class WorkStealingScheduler::Worker final : public Thread
+{
+public:
+    Worker (WorkStealingScheduler& o, int workerIndex, const Options& options)
+        : Thread (options.threadName, options.threadStackSizeBytes),
+          owner (o),
+          index (workerIndex),
+          queue (o.numSlots),
+          randomState ((uint32) workerIndex * 0x9e3779b9u + 1)
+    {
+    }
+
+    void run() override
+    {
+        current = this;
+        uint32 slot;
+
+        while (! owner.stopping.load())
+        {
+            if (findTaskSpinning (slot))
+            {
+                owner.runTask (slot);
+                continue;
+            }
+
+            // Anything submitted after reading the epoch will change it, so if it's the
+            // same once we're waiting, there can't be any work that we missed
+            const auto epoch = owner.workEpoch.load();
+
+            if (owner.findTask (this, slot))
+            {
+                owner.runTask (slot);
+                continue;
+            }
+
+            owner.numSleeping.fetch_add (1);
+
+            {
+                std::unique_lock<std::mutex> lock (owner.sleepMutex);
+                owner.workAvailable.wait (lock, [this, epoch] { return owner.workEpoch.load() != epoch || owner.stopping.load(); });
+            }
+
+            owner.numSleeping.fetch_sub (1);
+        }
+
+        current = nullptr;
+    }
+
+    uint32 getNextRandom() noexcept
+    {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return randomState;
+    }
+
+    WorkStealingScheduler& owner;
+    const int index;
+    TaskQueue queue;
+
+    inline static thread_local Worker* current = nullptr;
+
+private:
+    // Spins for a little while before going to sleep, as there's often more work on its
+    // way in a burst of tasks
+    bool findTaskSpinning (uint32& slot) noexcept
+    {
+        for (int i = 0; i < 32; ++i)
+        {
+            if (owner.findTask (this, slot))
+                return true;
+
+            Thread::yield();
+        }
+
+        return false;
+    }
+
+    uint32 randomState;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+WorkStealingScheduler::TaskGroup::TaskGroup (WorkStealingScheduler& schedulerToUse) noexcept
+    : scheduler (schedulerToUse)
+{
+}
+
+WorkStealingScheduler::TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void WorkStealingScheduler::TaskGroup::wait()
+{
+    while (numPending.load() > 0)
+    {
+        if (scheduler.runPendingTask())
+            continue;
+
+        // Nothing left to help with, so just wait for the group's running tasks to finish,
+        // waking up now and again in case they queue any more work
+        std::unique_lock<std::mutex> lock (scheduler.sleepMutex);
+        scheduler.groupFinished.wait_for (lock, std::chrono::milliseconds (1), [this] { return numPending.load() == 0; });
+    }
+}
+
+//==============================================================================
+WorkStealingScheduler::WorkStealingScheduler (const Options& options)
+{
+    // not much point having a scheduler without any threads!
+    jassert (options.numberOfThreads > 0);
+    jassert (options.maxNumQueuedTasks > 0);
+
+    numSlots = (uint32) jmax (1, options.maxNumQueuedTasks);
+    slots.reset (new Slot[numSlots]);
+
+    for (uint32 i = 0; i < numSlots; ++i)
+        slots[i].next.store (i + 1 < numSlots ? i + 1 : noTaskSlot);
+
+    freeSlots.store (0);
+    sharedQueue.reset (new uint32[numSlots]);
+
+    const auto numCpus = jlimit (1, 32, SystemStats::getNumCpus());
+
+    for (int i = 0; i < jmax (1, options.numberOfThreads); ++i)
+    {
+        auto* worker = workers.add (new Worker (*this, i, options));
+
+        if (options.pinThreadsToCores)
+            worker->setAffinityMask ((uint32) 1 << (i % numCpus));
+    }
+
+    for (auto* worker : workers)
+        worker->startThread (options.desiredThreadPriority);
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+    stopThreads (-1);
+}
+
+void WorkStealingScheduler::stopThreads (int timeOutMilliseconds)
+{
+    {
+        const std::lock_guard<std::mutex> lock (sleepMutex);
+        stopping.store (true);
+    }
+
+    workAvailable.notify_all();
+
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto* worker : workers)
+        worker->stopThread (timeOutMilliseconds);
+
+    // Throw away the tasks that never got to run, so that nothing waits for them
+    uint32 slot;
+
+    while (findTask (nullptr, slot))
+    {
+        auto* group = slots[slot].group;
+        slots[slot].task = nullptr;
+        releaseSlot (slot);
+
+        if (group != nullptr)
+            finishTask (*group);
+    }
+}
+
+int WorkStealingScheduler::getNumThreads() const noexcept
+{
+    return workers.size();
+}
+
+int WorkStealingScheduler::getCurrentWorkerIndex() const noexcept
+{
+    auto* worker = Worker::current;
+    return worker != nullptr && &worker->owner == this ? worker->index : -1;
+}
+
+//==============================================================================
+bool WorkStealingScheduler::acquireSlot (uint32& slot) noexcept
+{
+    // The free list is a stack of slot indices, with a counter in the top half of
+    // the head to stop a slot being popped and pushed again from fooling the CAS
+    auto head = freeSlots.load (std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto index = (uint32) head;
+
+        if (index == noTaskSlot)
+            return false;
+
+        const auto next = slots[index].next.load (std::memory_order_relaxed);
+        const auto newHead = (((head >> 32) + 1) << 32) | next;
+
+        if (freeSlots.compare_exchange_weak (head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+        {
+            slot = index;
+            return true;
+        }
+    }
+}
+
+void WorkStealingScheduler::releaseSlot (uint32 slot) noexcept
+{
+    auto head = freeSlots.load (std::memory_order_relaxed);
+    uint64 newHead;
+
+    do
+    {
+        slots[slot].next.store ((uint32) head, std::memory_order_relaxed);
+        newHead = (((head >> 32) + 1) << 32) | slot;
+    }
+    while (! freeSlots.compare_exchange_weak (head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void WorkStealingScheduler::submit (Task&& task, TaskGroup* group)
+{
+    if (stopping.load())
+    {
+        // You can't add any tasks after the scheduler has been stopped!
+        jassertfalse;
+
+        if (group != nullptr)
+            finishTask (*group);
+
+        return;
+    }
+
+    auto* worker = Worker::current;
+
+    if (worker != nullptr && &worker->owner != this)
+        worker = nullptr;
+
+    uint32 slot;
+
+    while (! acquireSlot (slot))
+    {
+        // A worker just runs the task straight away when the pool is full, which also
+        // stops a recursive split from using up all the slots. Other threads help out
+        // with the queued tasks until one finishes.
+        if (worker != nullptr)
+        {
+            runTaskNow (task, group);
+            return;
+        }
+
+        if (! runPendingTask())
+            Thread::yield();
+    }
+
+    slots[slot].task = std::move (task);
+    slots[slot].group = group;
+
+    if (worker != nullptr)
+    {
+        if (! worker->queue.push (slot))
+        {
+            runTask (slot);
+            return;
+        }
+    }
+    else
+    {
+        const SpinLock::ScopedLockType sl (sharedQueueLock);
+
+        // each slot can only be in one queue, so this can't overflow
+        sharedQueue[(sharedQueueStart + sharedQueueSize++) % numSlots] = slot;
+        sharedQueueCount.fetch_add (1);
+    }
+
+    wakeWorker();
+}
+
+bool WorkStealingScheduler::findTask (Worker* worker, uint32& slot) noexcept
+{
+    if (worker != nullptr && worker->queue.pop (slot))
+        return true;
+
+    if (sharedQueueCount.load() > 0)
+    {
+        const SpinLock::ScopedLockType sl (sharedQueueLock);
+
+        if (sharedQueueSize > 0)
+        {
+            slot = sharedQueue[sharedQueueStart];
+            sharedQueueStart = (sharedQueueStart + 1) % numSlots;
+            --sharedQueueSize;
+            sharedQueueCount.fetch_sub (1);
+            return true;
+        }
+    }
+
+    const auto numWorkers = (uint32) workers.size();
+    const auto start = worker != nullptr ? worker->getNextRandom() : 0;
+
+    for (uint32 i = 0; i < numWorkers; ++i)
+    {
+        auto* victim = workers.getUnchecked ((int) ((start + i) % numWorkers));
+
+        if (victim != worker && victim->queue.steal (slot))
+            return true;
+    }
+
+    return false;
+}
+
+bool WorkStealingScheduler::runPendingTask()
+{
+    auto* worker = Worker::current;
+    uint32 slot;
+
+    if (! findTask (worker != nullptr && &worker->owner == this ? worker : nullptr, slot))
+        return false;
+
+    runTask (slot);
+    return true;
+}
+
+void WorkStealingScheduler::runTask (uint32 slot)
+{
+    // The task is moved out so that its slot can be reused by any tasks that it submits
+    auto task = std::move (slots[slot].task);
+    auto* group = slots[slot].group;
+    slots[slot].task = nullptr;
+    releaseSlot (slot);
+
+    runTaskNow (task, group);
+}
+
+void WorkStealingScheduler::runTaskNow (Task& task, TaskGroup* group)
+{
+    if (group == nullptr || ! group->isCancelled())
+        task();
+
+    if (group != nullptr)
+        finishTask (*group);
+}
+
+void WorkStealingScheduler::finishTask (TaskGroup& group)
+{
+    // The group can be deleted as soon as its count reaches zero, so it mustn't be
+    // touched again after this
+    if (group.numPending.fetch_sub (1) == 1)
+    {
+        {
+            const std::lock_guard<std::mutex> lock (sleepMutex);
+        }
+
+        groupFinished.notify_all();
+    }
+}
+
+void WorkStealingScheduler::wakeWorker()
+{
+    workEpoch.fetch_add (1);
+
+    if (numSleeping.load() > 0)
+    {
+        {
+            const std::lock_guard<std::mutex> lock (sleepMutex);
+        }
+
+        workAvailable.notify_one();
+    }
+}
+
+} // namespace juce
@@ -0,0 +1,347 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    The options used to create a WorkStealingScheduler.
+
+    @see WorkStealingScheduler
+
+    @tags{Core}
+*/
+struct WorkStealingSchedulerOptions
+{
+    /** The name to give each worker thread. */
+    [[nodiscard]] WorkStealingSchedulerOptions withThreadName (String newThreadName) const
+    {
+        return withMember (*this, &WorkStealingSchedulerOptions::threadName, newThreadName);
+    }
+
+    /** The number of worker threads to run.
+        These will be started when the scheduler is created, and run until it is destroyed.
+    */
+    [[nodiscard]] WorkStealingSchedulerOptions withNumberOfThreads (int newNumberOfThreads) const
+    {
+        return withMember (*this, &WorkStealingSchedulerOptions::numberOfThreads, newNumberOfThreads);
+    }
+
+    /** The size of the stack of each worker thread. */
+    [[nodiscard]] WorkStealingSchedulerOptions withThreadStackSizeBytes (size_t newThreadStackSizeBytes) const
+    {
+        return withMember (*this, &WorkStealingSchedulerOptions::threadStackSizeBytes, newThreadStackSizeBytes);
+    }
+
+    /** The desired priority of each worker thread. */
+    [[nodiscard]] WorkStealingSchedulerOptions withDesiredThreadPriority (Thread::Priority newDesiredThreadPriority) const
+    {
+        return withMember (*this, &WorkStealingSchedulerOptions::desiredThreadPriority, newDesiredThreadPriority);
+    }
+
+    /** If true, each worker thread is pinned to its own CPU core, wrapping around if there
+        are more workers than cores.
+    */
+    [[nodiscard]] WorkStealingSchedulerOptions withThreadsPinnedToCores (bool shouldPinThreadsToCores) const
+    {
+        return withMember (*this, &WorkStealingSchedulerOptions::pinThreadsToCores, shouldPinThreadsToCores);
+    }
+
+    /** The maximum number of tasks that can be waiting to run at once.
+
+        This is the size of the pool of task slots that is allocated up-front, so that
+        submitting a task never allocates. When it's full, a worker thread runs a new task
+        straight away instead of queueing it, and any other thread helps to run queued
+        tasks until there's space.
+    */
+    [[nodiscard]] WorkStealingSchedulerOptions withMaxNumQueuedTasks (int newMaxNumQueuedTasks) const
+    {
+        return withMember (*this, &WorkStealingSchedulerOptions::maxNumQueuedTasks, newMaxNumQueuedTasks);
+    }
+
+    String threadName { "Worker" };
+    int numberOfThreads { SystemStats::getNumCpus() };
+    size_t threadStackSizeBytes { Thread::osDefaultStackSize };
+    Thread::Priority desiredThreadPriority { Thread::Priority::normal };
+    bool pinThreadsToCores { false };
+    int maxNumQueuedTasks { 4096 };
+};
+
+//==============================================================================
+/**
+    A set of worker threads that share out small tasks by work-stealing.
+
+    Each worker has its own double-ended queue of tasks. A worker pushes the tasks that it
+    creates onto the bottom of its own queue and pops them from there, so that the most
+    recently created (and most likely cached) work is run first without any contention.
+    When a worker runs out of tasks, it steals the oldest one from the top of another
+    worker's queue. Tasks submitted by threads that aren't workers go into a shared queue
+    that the workers check before stealing from each other.
+
+    Tasks are stored in a fixed-size buffer inside a preallocated slot, so submitting and
+    running them doesn't allocate, and no virtual calls are involved. The callable objects
+    must fit into maxTaskSize bytes, which is enough for a lambda capturing a handful of
+    pointers or references.
+
+    @code
+    WorkStealingScheduler scheduler;
+
+    // run a loop in parallel
+    scheduler.parallelFor (0, numItems, [&] (int i) { processItem (i); });
+
+    // or run some tasks and wait for them
+    WorkStealingScheduler::TaskGroup group (scheduler);
+    group.run ([&] { doSomething(); });
+    group.run ([&] { doSomethingElse(); });
+    group.wait();
+    @endcode
+
+    @see ThreadPool
+
+    @tags{Core}
+*/
+class JUCE_API  WorkStealingScheduler
+{
+public:
+    using Options = WorkStealingSchedulerOptions;
+
+    /** The maximum size of the callable object in a task. */
+    static constexpr size_t maxTaskSize = 6 * sizeof (void*);
+
+    /** A task to run on the scheduler. */
+    using Task = FixedSizeFunction<maxTaskSize, void()>;
+
+    //==============================================================================
+    /**
+        A set of tasks that can be waited for or cancelled together.
+
+        A group must not be destroyed while any of its tasks are pending, so the destructor
+        waits for them.
+    */
+    class JUCE_API  TaskGroup
+    {
+    public:
+        /** Creates an empty group of tasks that will run on the given scheduler. */
+        explicit TaskGroup (WorkStealingScheduler& schedulerToUse) noexcept;
+
+        /** Destructor. This will wait for any pending tasks to finish. */
+        ~TaskGroup();
+
+        /** Adds a task to the group and queues it to be run. */
+        template <typename Callable>
+        void run (Callable&& callable)
+        {
+            numPending.fetch_add (1);
+            scheduler.submit (Task (std::forward<Callable> (callable)), this);
+        }
+
+        /** Waits until all the tasks in the group have finished.
+
+            While waiting, the calling thread helps by running queued tasks, so it's safe
+            to wait for a group from inside one of the scheduler's tasks.
+        */
+        void wait();
+
+        /** Cancels the group's tasks.
+
+            Any tasks that haven't started yet will be skipped, and tasks that are running can
+            call isCancelled() to find out that they should return early. This doesn't wait,
+            so call wait() if you need to know when the running tasks have finished.
+        */
+        void cancel() noexcept                          { cancelled.store (true); }
+
+        /** Returns true if cancel() has been called. */
+        bool isCancelled() const noexcept               { return cancelled.load (std::memory_order_relaxed); }
+
+        /** Returns the number of tasks that haven't finished yet. */
+        int getNumPendingTasks() const noexcept         { return numPending.load(); }
+
+    private:
+        friend class WorkStealingScheduler;
+
+        WorkStealingScheduler& scheduler;
+        std::atomic<int> numPending { 0 };
+        std::atomic<bool> cancelled { false };
+
+        JUCE_DECLARE_NON_COPYABLE (TaskGroup)
+    };
+
+    //==============================================================================
+    /** Creates a scheduler, and starts its worker threads. */
+    explicit WorkStealingScheduler (const Options& options);
+
+    /** Creates a scheduler using the default options. */
+    WorkStealingScheduler() : WorkStealingScheduler { Options{} } {}
+
+    /** Destructor. This calls stopThreads(), waiting for any running tasks to finish. */
+    ~WorkStealingScheduler();
+
+    //==============================================================================
+    /** Queues a task that doesn't belong to any group. */
+    template <typename Callable>
+    void submit (Callable&& callable)
+    {
+        submit (Task (std::forward<Callable> (callable)), nullptr);
+    }
+
+    /** Calls body (i) for each index in the range [begin, end), in parallel, and waits
+        for them all to finish.
+
+        The range is split in half recursively, with one half being left for other workers
+        to steal, until the pieces are no bigger than grainSize. If grainSize is 0, a size is
+        picked that gives each thread several pieces to balance the load between them.
+        The calling thread takes part in the work.
+    */
+    template <typename Function>
+    void parallelFor (int begin, int end, Function&& body, int grainSize = 0)
+    {
+        if (end <= begin)
+            return;
+
+        if (grainSize <= 0)
+            grainSize = jmax (1, (end - begin) / (8 * (getNumThreads() + 1)));
+
+        TaskGroup group (*this);
+
+        struct Splitter
+        {
+            void operator() (int b, int e) const
+            {
+                while (e - b > grain)
+                {
+                    const auto middle = b + (e - b) / 2;
+                    group->run ([self = *this, middle, e] { self (middle, e); });
+                    e = middle;
+                }
+
+                for (int i = b; i < e && ! group->isCancelled(); ++i)
+                    (*fn) (i);
+            }
+
+            std::remove_reference_t<Function>* fn;
+            TaskGroup* group;
+            int grain;
+        };
+
+        Splitter { &body, &group, grainSize } (begin, end);
+        group.wait();
+    }
+
+    /** Calculates reduce (... reduce (reduce (identity, map (begin)), map (begin + 1)) ..., map (end - 1))
+        in parallel.
+
+        The range is split into pieces of up to grainSize indices, each of which is reduced
+        by a task, and the results of the pieces are then combined in order on the calling
+        thread. So reduce needs to be associative, but it doesn't need to be commutative,
+        and the result is always the same for the same number of pieces.
+    */
+    template <typename ValueType, typename MapFunction, typename ReduceFunction>
+    ValueType parallelReduce (int begin, int end, ValueType identity, MapFunction&& map, ReduceFunction&& reduce, int grainSize = 0)
+    {
+        if (end <= begin)
+            return identity;
+
+        if (grainSize <= 0)
+            grainSize = jmax (1, (end - begin) / (4 * (getNumThreads() + 1)));
+
+        const auto numPieces = (end - begin + grainSize - 1) / grainSize;
+        std::vector<ValueType> results ((size_t) numPieces, identity);
+
+        parallelFor (0, numPieces, [&] (int piece)
+        {
+            const auto pieceStart = begin + piece * grainSize;
+            const auto pieceEnd = jmin (end, pieceStart + grainSize);
+            auto result = identity;
+
+            for (int i = pieceStart; i < pieceEnd; ++i)
+                result = reduce (result, map (i));
+
+            results[(size_t) piece] = std::move (result);
+        }, 1);
+
+        auto result = std::move (identity);
+
+        for (auto& r : results)
+            result = reduce (result, r);
+
+        return result;
+    }
+
+    //==============================================================================
+    /** Runs one of the queued tasks on the calling thread, if there are any.
+        Returns false if there weren't any tasks to run.
+    */
+    bool runPendingTask();
+
+    /** Returns the number of worker threads. */
+    int getNumThreads() const noexcept;
+
+    /** If the calling thread is one of this scheduler's workers, this returns its index,
+        otherwise -1.
+    */
+    int getCurrentWorkerIndex() const noexcept;
+
+    /** Stops the worker threads.
+
+        The workers finish the tasks that they're running, and any tasks that haven't been
+        started are discarded. If the timeout expires before the workers have stopped, they
+        are killed in the same way as Thread::stopThread() does. A negative timeout waits
+        forever.
+    */
+    void stopThreads (int timeOutMilliseconds);
+
+private:
+    //==============================================================================
+    struct Slot;
+    class TaskQueue;
+    class Worker;
+
+    void submit (Task&&, TaskGroup*);
+    bool acquireSlot (uint32&) noexcept;
+    void releaseSlot (uint32) noexcept;
+    bool findTask (Worker*, uint32&) noexcept;
+    void runTask (uint32);
+    void runTaskNow (Task&, TaskGroup*);
+    void finishTask (TaskGroup&);
+    void wakeWorker();
+
+    std::unique_ptr<Slot[]> slots;
+    uint32 numSlots = 0;
+    std::atomic<uint64> freeSlots { 0 };
+
+    std::unique_ptr<uint32[]> sharedQueue;
+    uint32 sharedQueueStart = 0, sharedQueueSize = 0;
+    std::atomic<int> sharedQueueCount { 0 };
+    SpinLock sharedQueueLock;
+
+    OwnedArray<Worker> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable workAvailable, groupFinished;
+    std::atomic<uint32> workEpoch { 0 };
+    std::atomic<int> numSleeping { 0 };
+    std::atomic<bool> stopping { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WorkStealingScheduler)
+};
+
+} // namespace juce
@@ -47,6 +47,9 @@ namespace juce
     The parser will parse DTDs to load external entities but won't
     check the document for validity against the DTD.
 
+    To read large documents without building a tree of XmlElements for the whole of
+    them, use an XmlStreamReader instead.
+
     e.g.
     @code
     XmlDocument myDocument (File ("myfile.xml"));
@@ -73,7 +76,7 @@ namespace juce
     }
     @endcode
 
-    @see XmlElement
+    @see XmlElement, XmlStreamReader
 
     @tags{Core}
 */
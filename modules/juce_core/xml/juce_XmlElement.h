@@ -791,6 +791,7 @@ private:
     };
 
     friend class XmlDocument;
+    friend class XmlStreamReader;
     friend class LinkedListPointer<XmlAttributeNode>;
     friend class LinkedListPointer<XmlElement>;
     friend class LinkedListPointer<XmlElement>::Appender;
@@ -0,0 +1,766 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace XmlStreamReaderHelpers
+{
+    static bool isWhitespace (char c) noexcept
+    {
+        return c == ' ' || (c <= 13 && c >= 9);
+    }
+
+    static bool isNameChar (char c) noexcept
+    {
+        // Any byte of a multi-byte UTF-8 sequence is treated as part of a name
+        return (uint8) c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) (uint8) c);
+    }
+
+    static bool containsNonWhitespace (const char* text, size_t length) noexcept
+    {
+        for (size_t i = 0; i < length; ++i)
+            if (! isWhitespace (text[i]))
+                return true;
+
+        return false;
+    }
+
+    // Expands the entity that starts at the given ampersand, returning a pointer to the end
+    // of it. Entities that aren't recognised are copied as they are.
+    static const char* appendEntity (const char* text, const char* end, MemoryOutputStream& out)
+    {
+        auto* semicolon = static_cast<const char*> (std::memchr (text, ';', (size_t) jmin ((ptrdiff_t) 32, end - text)));
+
+        if (semicolon == nullptr)
+        {
+            out.writeByte ('&');
+            return text + 1;
+        }
+
+        const auto matches = [text, semicolon] (const char* name)
+        {
+            const auto length = (size_t) (semicolon - text - 1);
+            return std::strlen (name) == length && CharacterFunctions::compareIgnoreCaseUpTo (CharPointer_ASCII (text + 1),
+                                                                                              CharPointer_ASCII (name),
+                                                                                              (int) length) == 0;
+        };
+
+        if      (matches ("amp"))   out.writeByte ('&');
+        else if (matches ("quot"))  out.writeByte ('"');
+        else if (matches ("apos"))  out.writeByte ('\'');
+        else if (matches ("lt"))    out.writeByte ('<');
+        else if (matches ("gt"))    out.writeByte ('>');
+        else if (text[1] == '#' && semicolon - text > 2)
+        {
+            const auto isHex = text[2] == 'x' || text[2] == 'X';
+            uint32 charCode = 0;
+            bool isValid = semicolon - text > (isHex ? 3 : 2);
+
+            for (auto* p = text + (isHex ? 3 : 2); p < semicolon && isValid; ++p)
+            {
+                const auto digit = isHex ? CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) *p)
+                                         : (*p >= '0' && *p <= '9' ? *p - '0' : -1);
+
+                isValid = digit >= 0 && charCode <= 0x10ffff;
+                charCode = charCode * (isHex ? 16u : 10u) + (uint32) digit;
+            }
+
+            if (! isValid || charCode == 0 || charCode > 0x10ffff)
+                out.write (text, (size_t) (semicolon + 1 - text));
+            else
+                out.appendUTF8Char ((juce_wchar) charCode);
+        }
+        else
+        {
+            out.write (text, (size_t) (semicolon + 1 - text));
+        }
+
+        return semicolon + 1;
+    }
+}
+
+//==============================================================================
+XmlStreamReader::XmlStreamReader (const void* data, size_t numBytes)
+    : buffer (static_cast<const char*> (data)),
+      bufferSize (data != nullptr ? numBytes : 0)
+{
+}
+
+XmlStreamReader::XmlStreamReader (const File& file)
+    : mappedFile (std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly))
+{
+    if (mappedFile->getData() != nullptr)
+    {
+        buffer = static_cast<const char*> (mappedFile->getData());
+        bufferSize = mappedFile->getSize();
+        return;
+    }
+
+    // An empty file can't be mapped, and some file systems don't support it
+    mappedFile.reset();
+    ownedStream = file.createInputStream();
+
+    if (ownedStream != nullptr)
+    {
+        setStream (*ownedStream, 65536);
+    }
+    else
+    {
+        lastError = "Couldn't open " + file.getFullPathName();
+        currentEvent = Event::error;
+    }
+}
+
+XmlStreamReader::XmlStreamReader (InputStream& source, size_t bufferSizeBytes)
+{
+    setStream (source, bufferSizeBytes);
+}
+
+XmlStreamReader::~XmlStreamReader() = default;
+
+void XmlStreamReader::setStream (InputStream& source, size_t bufferSizeBytes)
+{
+    stream = &source;
+    streamBufferCapacity = jmax ((size_t) 64, bufferSizeBytes);
+    streamBuffer.malloc (streamBufferCapacity);
+    buffer = streamBuffer;
+}
+
+//==============================================================================
+const Identifier& XmlStreamReader::getTagName() const noexcept
+{
+    if (currentEvent == Event::startElement)
+        return elementStack.back();
+
+    return endTagName;
+}
+
+const Identifier& XmlStreamReader::getAttributeName (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, numAttributes));
+
+    if (isPositiveAndBelow (index, numAttributes))
+        return attributes[(size_t) index].name;
+
+    return endTagName;
+}
+
+const String& XmlStreamReader::getAttributeValue (int index) const noexcept
+{
+    jassert (isPositiveAndBelow (index, numAttributes));
+
+    if (isPositiveAndBelow (index, numAttributes))
+        return attributes[(size_t) index].value;
+
+    return currentText;
+}
+
+const String& XmlStreamReader::getStringAttribute (const Identifier& attributeName, const String& defaultReturnValue) const noexcept
+{
+    for (int i = 0; i < numAttributes; ++i)
+        if (attributes[(size_t) i].name == attributeName)
+            return attributes[(size_t) i].value;
+
+    return defaultReturnValue;
+}
+
+bool XmlStreamReader::hasAttribute (const Identifier& attributeName) const noexcept
+{
+    for (int i = 0; i < numAttributes; ++i)
+        if (attributes[(size_t) i].name == attributeName)
+            return true;
+
+    return false;
+}
+
+//==============================================================================
+XmlStreamReader::Event XmlStreamReader::next()
+{
+    if (currentEvent == Event::error)
+        return currentEvent;
+
+    if (! started)
+    {
+        started = true;
+
+        if (startsWith ("\xef\xbb\xbf", 3))
+            position += 3;
+        else if (startsWith ("\xfe\xff", 2) || startsWith ("\xff\xfe", 2))
+            return currentEvent = fail ("UTF-16 documents aren't supported");
+    }
+
+    currentEvent = readNextEvent();
+    return currentEvent;
+}
+
+XmlStreamReader::Event XmlStreamReader::readNextEvent()
+{
+    numAttributes = 0;
+
+    if (endTagName.isValid())
+        endTagName = {};
+
+    if (currentText.isNotEmpty())
+        currentText.clear();
+
+    if (emptyElementPending)
+    {
+        emptyElementPending = false;
+        endTagName = elementStack.back();
+        elementStack.pop_back();
+        finished = elementStack.empty();
+        return Event::endElement;
+    }
+
+    if (finished)
+        return Event::endOfDocument;
+
+    for (;;)
+    {
+        tokenStart = position;
+
+        if (! ensureAvailable (1))
+            return fail (elementStack.empty() ? "not enough input" : "unmatched tags");
+
+        if (buffer[position] != '<')
+        {
+            if (elementStack.empty())
+            {
+                skipWhitespace();
+
+                if (ensureAvailable (1) && buffer[position] != '<')
+                    return fail ("illegal characters found outside the document element");
+
+                continue;
+            }
+
+            const auto event = readText();
+
+            // text that only contains whitespace is ignored, and so is all the text while skipping
+            if (event == Event::text && currentText.isEmpty())
+                continue;
+
+            return event;
+        }
+
+        const auto secondChar = ensureAvailable (2) ? buffer[position + 1] : 0;
+
+        if (secondChar == '/')
+            return readEndTag();
+
+        if (secondChar == '?')
+        {
+            if (! skipPast ("?>", 2))
+                return fail ("unterminated processing instruction");
+
+            continue;
+        }
+
+        if (secondChar == '!')
+        {
+            if (startsWith ("<!--", 4))
+            {
+                if (! skipPast ("-->", 3))
+                    return fail ("unterminated comment");
+
+                continue;
+            }
+
+            if (startsWith ("<![CDATA[", 9))
+            {
+                if (elementStack.empty())
+                    return fail ("illegal characters found outside the document element");
+
+                return readCData();
+            }
+
+            if (startsWith ("<!DOCTYPE", 9))
+            {
+                if (! skipDocType())
+                    return fail ("malformed DTD");
+
+                continue;
+            }
+        }
+
+        return readStartTag();
+    }
+}
+
+XmlStreamReader::Event XmlStreamReader::readStartTag()
+{
+    ++position;
+
+    // allow for a gap after the '<' before giving an error, as XmlDocument does
+    skipWhitespace();
+
+    Identifier tagName;
+
+    if (! readName (skipping ? nullptr : &tagName))
+        return fail ("tag name missing");
+
+    elementStack.push_back (std::move (tagName));
+    const auto& name = elementStack.back();
+
+    for (;;)
+    {
+        skipWhitespace();
+
+        if (! ensureAvailable (1))
+            return fail ("unmatched tags");
+
+        const auto c = buffer[position];
+
+        if (c == '>')
+        {
+            ++position;
+            return Event::startElement;
+        }
+
+        if (c == '/')
+        {
+            if (! ensureAvailable (2) || buffer[position + 1] != '>')
+                return fail ("illegal character found in " + name.toString() + ": '/'");
+
+            position += 2;
+            emptyElementPending = true;
+            return Event::startElement;
+        }
+
+        Identifier attributeName;
+
+        if (! readName (skipping ? nullptr : &attributeName))
+            return fail ("illegal character found in " + name.toString() + ": '" + String::charToString ((juce_wchar) (uint8) c) + "'");
+
+        skipWhitespace();
+
+        if (! ensureAvailable (1) || buffer[position] != '=')
+            return fail ("expected '=' after attribute '" + attributeName.toString() + "'");
+
+        ++position;
+        skipWhitespace();
+
+        String* value = nullptr;
+
+        if (! skipping)
+        {
+            if ((size_t) numAttributes == attributes.size())
+                attributes.emplace_back();
+
+            auto& attribute = attributes[(size_t) numAttributes++];
+            attribute.name = std::move (attributeName);
+            value = &attribute.value;
+        }
+
+        if (! readAttributeValue (value))
+            return Event::error;
+    }
+}
+
+XmlStreamReader::Event XmlStreamReader::readEndTag()
+{
+    position += 2;
+
+    Identifier tagName;
+
+    if (! readName (skipping ? nullptr : &tagName))
+        return fail ("tag name missing");
+
+    skipWhitespace();
+
+    if (! ensureAvailable (1) || buffer[position] != '>')
+        return fail ("expected '>' after closing tag");
+
+    ++position;
+
+    if (elementStack.empty())
+        return fail ("unexpected closing tag");
+
+    if (! skipping && elementStack.back() != tagName)
+        return fail ("closing tag '" + tagName.toString() + "' doesn't match '" + elementStack.back().toString() + "'");
+
+    endTagName = elementStack.back();
+    elementStack.pop_back();
+    finished = elementStack.empty();
+    return Event::endElement;
+}
+
+XmlStreamReader::Event XmlStreamReader::readText()
+{
+    textBuffer.reset();
+    bool hasContent = ! ignoreEmptyTextElements;
+
+    for (;;)
+    {
+        tokenStart = position;
+
+        if (! findNext ('<'))
+            return fail ("unmatched tags");
+
+        if (! skipping)
+        {
+            const auto start = textBuffer.getDataSize();
+            appendText (tokenStart, position, textBuffer);
+
+            hasContent = hasContent || XmlStreamReaderHelpers::containsNonWhitespace (static_cast<const char*> (textBuffer.getData()) + start,
+                                                                                      textBuffer.getDataSize() - start);
+        }
+
+        // a comment in the middle of some text doesn't split it up
+        if (! startsWith ("<!--", 4))
+            break;
+
+        if (! skipPast ("-->", 3))
+            return fail ("unterminated comment");
+    }
+
+    if (hasContent)
+        currentText = textBuffer.toUTF8();
+
+    return Event::text;
+}
+
+XmlStreamReader::Event XmlStreamReader::readCData()
+{
+    position += 9;
+    tokenStart = position;
+
+    for (;;)
+    {
+        if (! findNext (']'))
+            return fail ("unterminated CDATA section");
+
+        if (startsWith ("]]>", 3))
+            break;
+
+        ++position;
+    }
+
+    if (! skipping)
+        currentText = String::fromUTF8 (buffer + tokenStart, (int) (position - tokenStart));
+
+    position += 3;
+    return Event::text;
+}
+
+bool XmlStreamReader::readName (Identifier* result)
+{
+    tokenStart = position;
+
+    while (position < bufferSize || refill())
+    {
+        if (! XmlStreamReaderHelpers::isNameChar (buffer[position]))
+            break;
+
+        ++position;
+    }
+
+    const auto length = position - tokenStart;
+
+    if (length == 0)
+        return false;
+
+    if (result == nullptr)
+        return true;
+
+    // Most documents use a small set of names, so the last Identifier created for
+    // each one is cached to avoid locking the global StringPool
+    const auto* name = buffer + tokenStart;
+    uint32 hash = 2166136261u;
+
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ (uint8) name[i]) * 16777619u;
+
+    auto& cached = nameCache[(hash ^ (hash >> 8)) & (uint32) (numElementsInArray (nameCache) - 1)];
+    const auto* cachedName = cached.getCharPointer().getAddress();
+
+    if (cached.isNull() || std::strncmp (cachedName, name, length) != 0 || cachedName[length] != 0)
+        cached = Identifier (String::CharPointerType (name), String::CharPointerType (name + length));
+
+    *result = cached;
+    return true;
+}
+
+bool XmlStreamReader::readAttributeValue (String* result)
+{
+    const auto quote = ensureAvailable (1) ? buffer[position] : 0;
+
+    if (quote != '"' && quote != '\'')
+    {
+        fail ("expected a quoted attribute value");
+        return false;
+    }
+
+    tokenStart = ++position;
+
+    if (! findNext (quote))
+    {
+        fail ("unmatched quotes");
+        return false;
+    }
+
+    if (result != nullptr)
+    {
+        const auto length = position - tokenStart;
+
+        if (std::memchr (buffer + tokenStart, '&', length) == nullptr)
+        {
+            *result = String::fromUTF8 (buffer + tokenStart, (int) length);
+        }
+        else
+        {
+            textBuffer.reset();
+            appendText (tokenStart, position, textBuffer);
+            *result = textBuffer.toUTF8();
+        }
+    }
+
+    ++position;
+    return true;
+}
+
+void XmlStreamReader::appendText (size_t start, size_t end, MemoryOutputStream& out)
+{
+    const auto* text = buffer + start;
+    const auto* textEnd = buffer + end;
+
+    while (text < textEnd)
+    {
+        auto* run = text;
+
+        while (text < textEnd && *text != '&' && *text != '\r')
+            ++text;
+
+        out.write (run, (size_t) (text - run));
+
+        if (text == textEnd)
+            break;
+
+        if (*text == '&')
+        {
+            text = XmlStreamReaderHelpers::appendEntity (text, textEnd, out);
+        }
+        else
+        {
+            // line endings are normalised to a single newline, as XmlDocument does
+            out.writeByte ('\n');
+
+            if (++text < textEnd && *text == '\n')
+                ++text;
+        }
+    }
+}
+
+bool XmlStreamReader::skipPast (const char* text, size_t length)
+{
+    for (;;)
+    {
+        tokenStart = position;
+
+        if (! findNext (text[0]))
+            return false;
+
+        if (startsWith (text, length))
+        {
+            position += length;
+            return true;
+        }
+
+        ++position;
+    }
+}
+
+bool XmlStreamReader::skipDocType()
+{
+    position += 9;
+
+    for (int depth = 1; depth > 0; ++position)
+    {
+        tokenStart = position;
+
+        while (position < bufferSize || refill())
+        {
+            if (buffer[position] == '<' || buffer[position] == '>')
+                break;
+
+            ++position;
+        }
+
+        if (position == bufferSize)
+            return false;
+
+        depth += buffer[position] == '<' ? 1 : -1;
+    }
+
+    return true;
+}
+
+void XmlStreamReader::skipWhitespace()
+{
+    if (position < bufferSize && ! XmlStreamReaderHelpers::isWhitespace (buffer[position]))
+        return;
+
+    tokenStart = position;
+
+    while (position < bufferSize || refill())
+    {
+        if (! XmlStreamReaderHelpers::isWhitespace (buffer[position]))
+            break;
+
+        ++position;
+    }
+}
+
+XmlStreamReader::Event XmlStreamReader::fail (const String& message)
+{
+    lastError = message;
+    return Event::error;
+}
+
+//==============================================================================
+bool XmlStreamReader::findNext (char c)
+{
+    for (;;)
+    {
+        if (auto* found = static_cast<const char*> (std::memchr (buffer + position, c, bufferSize - position)))
+        {
+            position = (size_t) (found - buffer);
+            return true;
+        }
+
+        position = bufferSize;
+
+        if (! refill())
+            return false;
+    }
+}
+
+bool XmlStreamReader::startsWith (const char* text, size_t length)
+{
+    return ensureAvailable (length) && std::memcmp (buffer + position, text, length) == 0;
+}
+
+bool XmlStreamReader::ensureAvailable (size_t numBytes)
+{
+    while (bufferSize - position < numBytes)
+        if (! refill())
+            return false;
+
+    return true;
+}
+
+bool XmlStreamReader::refill()
+{
+    if (stream == nullptr)
+        return false;
+
+    // Everything before the start of the current token has been dealt with
+    if (tokenStart > 0)
+    {
+        std::memmove (streamBuffer, streamBuffer + tokenStart, bufferSize - tokenStart);
+        bufferSize -= tokenStart;
+        position -= tokenStart;
+        tokenStart = 0;
+    }
+
+    // If a single token fills the buffer, it needs to grow
+    if (bufferSize == streamBufferCapacity)
+    {
+        streamBufferCapacity *= 2;
+        streamBuffer.realloc (streamBufferCapacity);
+        buffer = streamBuffer;
+    }
+
+    const auto numRead = stream->read (streamBuffer + bufferSize, (int) jmin ((size_t) std::numeric_limits<int>::max(),
+                                                                             streamBufferCapacity - bufferSize));
+
+    if (numRead <= 0)
+        return false;
+
+    bufferSize += (size_t) numRead;
+    return true;
+}
+
+//==============================================================================
+std::unique_ptr<XmlElement> XmlStreamReader::readElement()
+{
+    if (currentEvent != Event::startElement || skipping)
+        return {};
+
+    auto element = std::make_unique<XmlElement> (elementStack.back());
+
+    {
+        LinkedListPointer<XmlElement::XmlAttributeNode>::Appender appender (element->attributes);
+
+        for (int i = 0; i < numAttributes; ++i)
+            appender.append (new XmlElement::XmlAttributeNode (attributes[(size_t) i].name, attributes[(size_t) i].value));
+    }
+
+    LinkedListPointer<XmlElement>::Appender childAppender (element->firstChildElement);
+    const auto depth = getDepth();
+
+    for (;;)
+    {
+        switch (next())
+        {
+            case Event::startElement:
+                if (auto child = readElement())
+                    childAppender.append (child.release());
+                else
+                    return {};
+
+                break;
+
+            case Event::text:
+                childAppender.append (XmlElement::createTextElement (currentText));
+                break;
+
+            case Event::endElement:
+                if (getDepth() < depth)
+                    return element;
+
+                break;
+
+            case Event::endOfDocument:
+            case Event::error:
+                return {};
+        }
+    }
+}
+
+void XmlStreamReader::skipElement()
+{
+    if (currentEvent != Event::startElement)
+        return;
+
+    const ScopedValueSetter<bool> setter (skipping, true);
+
+    for (const auto depth = getDepth(); getDepth() >= depth;)
+    {
+        const auto event = next();
+
+        if (event == Event::error || event == Event::endOfDocument)
+            return;
+    }
+}
+
+} // namespace juce
@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads an XML document as a sequence of events, without building a tree of
+    XmlElement objects for the whole document.
+
+    Each call to next() moves to the next start tag, end tag or block of text, and the
+    methods of the reader describe it. Tag and attribute names are returned as
+    Identifiers, so they're pooled rather than allocated for every element. Any element
+    can be turned into an XmlElement with readElement(), or passed over with
+    skipElement(), which doesn't decode any of its text or attributes.
+
+    The source can be a block of memory, a file, which is memory-mapped, or an
+    InputStream, which is read in chunks into a buffer, so documents much larger than the
+    available memory can be read.
+
+    @code
+    XmlStreamReader reader (file);
+    const Identifier partTag ("part");
+
+    for (auto event = reader.next(); event != XmlStreamReader::Event::endOfDocument; event = reader.next())
+    {
+        if (event == XmlStreamReader::Event::error)
+        {
+            DBG (reader.getLastParseError());
+            break;
+        }
+
+        if (event == XmlStreamReader::Event::startElement && reader.getTagName() == partTag)
+        {
+            if (auto part = reader.readElement())
+                ...
+        }
+    }
+    @endcode
+
+    The input must be UTF-8. Unlike XmlDocument, the reader doesn't load DTDs, so only
+    the standard and numeric character entities are expanded, and any others are left
+    in the text as they are.
+
+    @see XmlDocument, XmlElement
+
+    @tags{Core}
+*/
+class JUCE_API  XmlStreamReader
+{
+public:
+    //==============================================================================
+    /** The kinds of event that the reader returns. */
+    enum class Event
+    {
+        endOfDocument,  /**< The end of the outer element has been read. */
+        error,          /**< The input wasn't valid. Use getLastParseError() to find out why. */
+        startElement,   /**< A start tag, or an empty-element tag. */
+        endElement,     /**< An end tag. An empty-element tag is followed by one of these too. */
+        text            /**< A block of text or a CDATA section inside an element. */
+    };
+
+    //==============================================================================
+    /** Creates a reader for a block of UTF-8 text.
+        The data isn't copied, so it must stay valid for the lifetime of the reader.
+    */
+    XmlStreamReader (const void* data, size_t numBytes);
+
+    /** Creates a reader for a file, which will be memory-mapped if possible. */
+    explicit XmlStreamReader (const File& file);
+
+    /** Creates a reader that pulls its input from a stream.
+
+        The stream is read in blocks of the given size, and the buffer only grows if a single
+        tag or block of text is bigger than that. The stream must stay valid for the lifetime
+        of the reader.
+    */
+    explicit XmlStreamReader (InputStream& source, size_t bufferSizeBytes = 65536);
+
+    /** Destructor. */
+    ~XmlStreamReader();
+
+    //==============================================================================
+    /** Reads the next event and returns it.
+        Once an error has been found, this keeps returning Event::error.
+    */
+    Event next();
+
+    /** Returns the event that was returned by the last call to next(). */
+    Event getCurrentEvent() const noexcept                  { return currentEvent; }
+
+    /** Returns the tag name of the current startElement or endElement. */
+    const Identifier& getTagName() const noexcept;
+
+    /** Returns the number of attributes of the current startElement. */
+    int getNumAttributes() const noexcept                   { return numAttributes; }
+
+    /** Returns the name of one of the current element's attributes. */
+    const Identifier& getAttributeName (int index) const noexcept;
+
+    /** Returns the value of one of the current element's attributes. */
+    const String& getAttributeValue (int index) const noexcept;
+
+    /** Returns the value of the current element's attribute with the given name, or the
+        default value if it doesn't have one.
+    */
+    const String& getStringAttribute (const Identifier& attributeName, const String& defaultReturnValue = {}) const noexcept;
+
+    /** Returns true if the current element has an attribute with the given name. */
+    bool hasAttribute (const Identifier& attributeName) const noexcept;
+
+    /** Returns the content of the current text event, with any entities expanded. */
+    const String& getText() const noexcept                  { return currentText; }
+
+    /** Returns the number of elements that the current event is inside.
+        A startElement or endElement counts as being inside its own element.
+    */
+    int getDepth() const noexcept                           { return (int) elementStack.size(); }
+
+    //==============================================================================
+    /** Reads the whole of the current startElement, including its attributes and children,
+        into a new XmlElement.
+
+        This leaves the reader at the element's endElement event. If the current event isn't
+        a startElement, or the element contains an error, this returns nullptr.
+    */
+    std::unique_ptr<XmlElement> readElement();
+
+    /** If the current event is a startElement, this skips to its endElement without
+        decoding any of its contents. Otherwise this does nothing.
+    */
+    void skipElement();
+
+    //==============================================================================
+    /** Sets a flag to change the treatment of text that only contains whitespace.
+
+        If this is true (the default state), then any blocks of text that contain only
+        whitespace characters will be ignored, as they are by XmlDocument.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept    { ignoreEmptyTextElements = shouldBeIgnored; }
+
+    /** Returns the error that stopped the reader, or an empty string if there hasn't been one. */
+    const String& getLastParseError() const noexcept        { return lastError; }
+
+private:
+    //==============================================================================
+    struct Attribute
+    {
+        Identifier name;
+        String value;
+    };
+
+    void setStream (InputStream&, size_t);
+
+    Event readNextEvent();
+    Event readStartTag();
+    Event readEndTag();
+    Event readText();
+    Event readCData();
+    bool readName (Identifier*);
+    bool readAttributeValue (String*);
+    bool skipPast (const char* text, size_t length);
+    bool skipDocType();
+    void skipWhitespace();
+    void appendText (size_t start, size_t end, MemoryOutputStream&);
+    Event fail (const String& message);
+
+    bool findNext (char);
+    bool refill();
+    bool ensureAvailable (size_t numBytes);
+    bool startsWith (const char* text, size_t length);
+
+    const char* buffer = nullptr;
+    size_t bufferSize = 0, position = 0, tokenStart = 0;
+
+    InputStream* stream = nullptr;
+    std::unique_ptr<InputStream> ownedStream;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    HeapBlock<char> streamBuffer;
+    size_t streamBufferCapacity = 0;
+
+    std::vector<Identifier> elementStack;
+    std::vector<Attribute> attributes;
+    int numAttributes = 0;
+    Identifier endTagName;
+    String currentText;
+    MemoryOutputStream textBuffer;
+    Identifier nameCache[256];
+
+    Event currentEvent = Event::endOfDocument;
+    bool started = false, finished = false, emptyElementPending = false;
+    bool ignoreEmptyTextElements = true, skipping = false;
+    String lastError;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlStreamReader)
+};
+
+} // namespace juce
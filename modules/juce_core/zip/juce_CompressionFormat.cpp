@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+CompressionFormat::Type CompressionFormat::detectFormat (InputStream& stream)
+{
+    constexpr uint32 zstdFrameMagic = 0xFD2FB528;
+
+    const auto startPosition = stream.getPosition();
+
+    uint8 header[4] = {};
+    auto numRead = stream.read (header, (int) sizeof (header));
+    auto skippedFrames = false;
+
+    // LZ4 and Zstandard share their skippable frames, so the format is decided by the frame after them
+    while (numRead == 4 && (ByteOrder::littleEndianInt (header) & LZ4Helpers::skippableFrameMask) == LZ4Helpers::skippableFrameMagic)
+    {
+        skippedFrames = true;
+
+        uint8 frameSize[4];
+
+        if (stream.read (frameSize, 4) != 4)
+            break;
+
+        stream.skipNextBytes ((int64) ByteOrder::littleEndianInt (frameSize));
+        numRead = stream.read (header, (int) sizeof (header));
+    }
+
+    if (! stream.setPosition (startPosition))
+    {
+        jassertfalse; // This stream can't go back, so the bytes that were looked at have been lost!
+        return unknown;
+    }
+
+    if (numRead == 4)
+    {
+        const auto magic = ByteOrder::littleEndianInt (header);
+
+        if (magic == LZ4Helpers::frameMagic)
+            return lz4;
+
+        if (magic == zstdFrameMagic)
+            return zstd;
+    }
+
+    if (skippedFrames)
+        return lz4;
+
+    if (numRead >= 2)
+    {
+        if (header[0] == 0x1f && header[1] == 0x8b)
+            return gzip;
+
+        // The zlib header's compression method is deflate, and the two bytes are a multiple of 31
+        if ((header[0] & 0x0f) == 8 && (header[0] >> 4) <= 7 && ((header[0] << 8) | header[1]) % 31 == 0)
+            return zlib;
+    }
+
+    return unknown;
+}
+
+std::unique_ptr<InputStream> CompressionFormat::createDecompressorFor (InputStream* sourceStream,
+                                                                       bool deleteSourceWhenDestroyed,
+                                                                       const MemoryBlock& dictionary)
+{
+    jassert (sourceStream != nullptr);
+
+    OptionalScopedPointer<InputStream> source (sourceStream, deleteSourceWhenDestroyed);
+    const auto format = detectFormat (*source);
+
+    if (format == lz4)
+    {
+        auto stream = std::make_unique<LZ4DecompressorInputStream> (source.release(), deleteSourceWhenDestroyed);
+
+        if (! dictionary.isEmpty())
+            stream->setDictionary (dictionary.getData(), dictionary.getSize());
+
+        return stream;
+    }
+
+    if (format == zstd)
+    {
+        auto stream = std::make_unique<ZstdDecompressorInputStream> (source.release(), deleteSourceWhenDestroyed);
+
+        if (! dictionary.isEmpty())
+            stream->setDictionary (dictionary.getData(), dictionary.getSize());
+
+        return stream;
+    }
+
+    if (format == zlib || format == gzip)
+    {
+        auto stream = std::make_unique<GZIPDecompressorInputStream> (source.release(), deleteSourceWhenDestroyed,
+                                                                     format == gzip ? GZIPDecompressorInputStream::gzipFormat
+                                                                                    : GZIPDecompressorInputStream::zlibFormat);
+
+        if (! dictionary.isEmpty())
+            stream->setDictionary (dictionary.getData(), dictionary.getSize());
+
+        return stream;
+    }
+
+    return {};
+}
+
+} // namespace juce
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Recognises the compressed formats that juce_core can read, and creates the right
+    decompressor for a stream.
+
+    @code
+    if (auto in = CompressionFormat::createDecompressorFor (new MemoryInputStream (block, false), true))
+        return in->readEntireStreamAsString();
+    @endcode
+
+    Raw deflate data has no header, so it can't be recognised.
+
+    @see GZIPDecompressorInputStream, LZ4DecompressorInputStream, ZstdDecompressorInputStream
+
+    @tags{Core}
+*/
+struct JUCE_API  CompressionFormat
+{
+    enum Type
+    {
+        unknown = 0,
+        zlib,
+        gzip,
+        lz4,
+        zstd
+    };
+
+    /** Looks at the first few bytes from the stream's current position to work out which
+        format they're in, and then moves the stream back to where it was.
+
+        The stream must be able to go back to its position; if it can't, you can read it
+        through a BufferedInputStream.
+    */
+    static Type detectFormat (InputStream& stream);
+
+    /** Creates a stream that will decompress the data in the source stream, whichever of the
+        supported formats it's in.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether the returned stream should delete the source
+                                            stream when it's destroyed. If the format isn't recognised,
+                                            this function deletes it instead.
+        @param dictionary                   the dictionary that the data was compressed with, if any
+        @returns the decompressor, or nullptr if the format wasn't recognised
+    */
+    static std::unique_ptr<InputStream> createDecompressorFor (InputStream* sourceStream,
+                                                               bool deleteSourceWhenDestroyed,
+                                                               const MemoryBlock& dictionary = {});
+};
+
+} // namespace juce
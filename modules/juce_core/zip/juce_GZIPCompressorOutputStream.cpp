@@ -60,6 +60,16 @@ public:
             zlibNamespace::deflateEnd (&stream);
     }
 
+    bool setDictionary (const void* data, size_t dataSize)
+    {
+        using namespace zlibNamespace;
+
+        // The dictionary has to be set before anything is written!
+        jassert (isFirstDeflate);
+
+        return streamIsValid && deflateSetDictionary (&stream, static_cast<const Bytef*> (data), (z_uInt) dataSize) == Z_OK;
+    }
+
     bool write (const uint8* data, size_t dataSize, OutputStream& out)
     {
         // When you call flush() on a gzip stream, the stream is closed, and you can
@@ -147,6 +157,15 @@ GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
     flush();
 }
 
+void GZIPCompressorOutputStream::setDictionary (const void* dictionaryData, size_t dictionarySize)
+{
+    jassert (dictionaryData != nullptr || dictionarySize == 0);
+
+    // If this fails, you're probably trying to use a dictionary with the gzip format
+    [[maybe_unused]] const auto ok = helper->setDictionary (dictionaryData, dictionarySize);
+    jassert (ok);
+}
+
 void GZIPCompressorOutputStream::flush()
 {
     helper->finish (*destStream);
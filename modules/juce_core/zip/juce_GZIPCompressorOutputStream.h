@@ -91,6 +91,18 @@ public:
     /** Destructor. */
     ~GZIPCompressorOutputStream() override;
 
+    //==============================================================================
+    /** Sets a dictionary of data that's likely to appear in the stream.
+
+        Small pieces of data compress much better when the compressor can refer back to
+        similar data that the decompressor already has. The last 32KB of the dictionary
+        are used, and the same dictionary has to be given to the GZIPDecompressorInputStream.
+
+        This must be called before anything is written to the stream. The gzip format has
+        no way of storing a dictionary, so this only works with the zlib and raw formats.
+    */
+    void setDictionary (const void* dictionaryData, size_t dictionarySize);
+
     //==============================================================================
     /** Flushes and closes the stream.
         Note that unlike most streams, when you call flush() on a GZIPCompressorOutputStream,
@@ -110,7 +110,9 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 class GZIPDecompressorInputStream::GZIPDecompressHelper
 {
 public:
-    GZIPDecompressHelper (Format f)
+    GZIPDecompressHelper (Format f, const MemoryBlock& dict)
+        : dictionary (dict),
+          needsRawDictionary (f == deflateFormat)
     {
         using namespace zlibNamespace;
         zerostruct (stream);
@@ -138,6 +140,13 @@ public:
 
         if (streamIsValid && data != nullptr && ! finished)
         {
+            // A raw stream doesn't say whether it needs a dictionary, so any that was given is used
+            if (std::exchange (needsRawDictionary, false) && ! dictionary.isEmpty() && ! applyDictionary())
+            {
+                error = true;
+                return 0;
+            }
+
             stream.next_in  = data;
             stream.next_out = dest;
             stream.avail_in  = (z_uInt) dataSize;
@@ -154,9 +163,9 @@ public:
                 return (int) (destSize - stream.avail_out);
 
             case Z_NEED_DICT:
-                needsDictionary = true;
                 data += dataSize - stream.avail_in;
                 dataSize = (size_t) stream.avail_in;
+                needsDictionary = dictionary.isEmpty() || ! applyDictionary();
                 break;
 
             case Z_DATA_ERROR:
@@ -189,7 +198,17 @@ public:
     enum { gzipDecompBufferSize = 32768 };
 
 private:
+    bool applyDictionary()
+    {
+        using namespace zlibNamespace;
+
+        return inflateSetDictionary (&stream, static_cast<const Bytef*> (dictionary.getData()),
+                                     (z_uInt) dictionary.getSize()) == Z_OK;
+    }
+
     zlibNamespace::z_stream stream;
+    const MemoryBlock& dictionary;
+    bool needsRawDictionary;
     uint8* data = nullptr;
     size_t dataSize = 0;
 
@@ -204,7 +223,7 @@ GZIPDecompressorInputStream::GZIPDecompressorInputStream (InputStream* source, b
     format (f),
     originalSourcePos (source->getPosition()),
     buffer ((size_t) GZIPDecompressHelper::gzipDecompBufferSize),
-    helper (new GZIPDecompressHelper (f))
+    helper (new GZIPDecompressHelper (f, dictionary))
 {
 }
 
@@ -214,7 +233,7 @@ GZIPDecompressorInputStream::GZIPDecompressorInputStream (InputStream& source)
     format (zlibFormat),
     originalSourcePos (source.getPosition()),
     buffer ((size_t) GZIPDecompressHelper::gzipDecompBufferSize),
-    helper (new GZIPDecompressHelper (zlibFormat))
+    helper (new GZIPDecompressHelper (zlibFormat, dictionary))
 {
 }
 
@@ -222,6 +241,14 @@ GZIPDecompressorInputStream::~GZIPDecompressorInputStream()
 {
 }
 
+void GZIPDecompressorInputStream::setDictionary (const void* dictionaryData, size_t dictionarySize)
+{
+    // The dictionary has to be set before anything is read!
+    jassert (currentPos == 0);
+
+    dictionary.replaceAll (dictionaryData, dictionarySize);
+}
+
 int64 GZIPDecompressorInputStream::getTotalLength()
 {
     return uncompressedStreamLength;
@@ -297,7 +324,7 @@ bool GZIPDecompressorInputStream::setPosition (int64 newPos)
         isEof = false;
         activeBufferSize = 0;
         currentPos = 0;
-        helper.reset (new GZIPDecompressHelper (format));
+        helper.reset (new GZIPDecompressHelper (format, dictionary));
 
         sourceStream->setPosition (originalSourcePos);
     }
@@ -89,6 +89,12 @@ public:
     /** Destructor. */
     ~GZIPDecompressorInputStream() override;
 
+    //==============================================================================
+    /** Sets the dictionary that the data was compressed with.
+        This must be called before anything is read from the stream.
+    */
+    void setDictionary (const void* dictionaryData, size_t dictionarySize);
+
     //==============================================================================
     int64 getPosition() override;
     bool setPosition (int64 pos) override;
@@ -105,6 +111,7 @@ private:
     int activeBufferSize = 0;
     int64 originalSourcePos, currentPos = 0;
     HeapBlock<uint8> buffer;
+    MemoryBlock dictionary;
 
     class GZIPDecompressHelper;
     std::unique_ptr<GZIPDecompressHelper> helper;
@@ -0,0 +1,429 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class LZ4CompressorOutputStream::LZ4CompressorHelper
+{
+public:
+    LZ4CompressorHelper (int compressionLevel)
+        : level ((compressionLevel < 0 || compressionLevel > 9) ? 1 : compressionLevel),
+          hashBits (level > 1 ? 15 : 12),
+          maxAttempts (level > 1 ? 1 << (level - 1) : 0)
+    {
+        buffer.malloc (LZ4Helpers::windowSize + blockSize);
+        compressed.malloc (blockSize + blockSize / 255 + 16);
+
+        if (level > 0)
+            hashTable.calloc ((size_t) 1 << hashBits);
+
+        // Levels above 1 keep a chain of the earlier positions with the same hash
+        if (level > 1)
+            chainTable.calloc (LZ4Helpers::windowSize);
+    }
+
+    void setDictionary (const void* data, size_t dataSize)
+    {
+        // The dictionary has to be set before anything is written!
+        jassert (! headerWritten && bufferUsed == 0);
+
+        if (dataSize == 0)
+            return;
+
+        dictionaryID = LZ4Helpers::XXHash32::calculate (data, dataSize);
+        hasDictionary = true;
+
+        auto numBytes = jmin (dataSize, LZ4Helpers::windowSize);
+        memcpy (buffer, addBytesToPointer (data, dataSize - numBytes), numBytes);
+        bufferUsed = blockStart = numBytes;
+
+        if (level == 1)
+        {
+            for (size_t i = 0; i + 4 <= numBytes; ++i)
+                hashTable[hash (buffer + i)] = (uint32) i;
+        }
+        else if (level > 1 && numBytes >= 4)
+        {
+            insertPositionsUpTo (buffer + numBytes - 3);
+        }
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on an LZ4 stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        contentChecksum.update (data, dataSize);
+
+        while (dataSize > 0)
+        {
+            auto numToCopy = jmin (dataSize, blockSize - (bufferUsed - blockStart));
+            memcpy (buffer + bufferUsed, data, numToCopy);
+            bufferUsed += numToCopy;
+            data += numToCopy;
+            dataSize -= numToCopy;
+
+            if (bufferUsed - blockStart == blockSize && ! writeBlock (out))
+                return false;
+        }
+
+        return true;
+    }
+
+    void finish (OutputStream& out)
+    {
+        if (finished)
+            return;
+
+        finished = true;
+
+        if (writeBlock (out))
+        {
+            out.writeInt (0);
+            out.writeInt ((int) contentChecksum.getResult());
+        }
+    }
+
+private:
+    static constexpr size_t blockSize = 65536;
+    static constexpr size_t minMatch = 4;
+    static constexpr size_t lastLiterals = 5;       // the last 5 bytes of a block must be literals..
+    static constexpr size_t matchStartLimit = 12;   // ..and the last match must start 12 bytes before its end
+
+    uint32 hash (const uint8* p) const noexcept
+    {
+        return (readUnaligned<uint32> (p) * 2654435761u) >> (32 - hashBits);
+    }
+
+    uint32 getPosition (const uint8* p) const noexcept
+    {
+        // Positions are counted from the start of the stream, so that they stay the same when
+        // the buffer moves along. They wrap around after 4GB, but any match that's found is
+        // checked against the data, so that can't cause any harm.
+        return bufferBase + (uint32) (p - buffer.get());
+    }
+
+    //==============================================================================
+    bool writeBlock (OutputStream& out)
+    {
+        if (! headerWritten && ! writeHeader (out))
+            return false;
+
+        const auto numBytes = bufferUsed - blockStart;
+
+        if (numBytes == 0)
+            return true;
+
+        const auto compressedSize = level > 0 ? compressBlock (buffer + blockStart, buffer + bufferUsed) : numBytes;
+
+        bool ok;
+
+        if (compressedSize < numBytes)
+            ok = out.writeInt ((int) compressedSize) && out.write (compressed, compressedSize);
+        else
+            ok = out.writeInt ((int) (numBytes | LZ4Helpers::uncompressedBlockFlag)) && out.write (buffer + blockStart, numBytes);
+
+        blockStart = bufferUsed;
+
+        // Keep the last 64KB, which the next block can refer back to, and make room after it
+        if (bufferUsed > LZ4Helpers::windowSize)
+        {
+            const auto shift = bufferUsed - LZ4Helpers::windowSize;
+            memmove (buffer, buffer + shift, LZ4Helpers::windowSize);
+            bufferBase += (uint32) shift;
+            bufferUsed = blockStart = LZ4Helpers::windowSize;
+        }
+
+        return ok;
+    }
+
+    bool writeHeader (OutputStream& out)
+    {
+        using namespace LZ4Helpers;
+
+        headerWritten = true;
+
+        uint8 header[11];
+        size_t size = 0;
+
+        auto writeInt = [&] (uint32 value)
+        {
+            for (int i = 0; i < 4; ++i)
+                header[size++] = (uint8) (value >> (8 * i));
+        };
+
+        writeInt (frameMagic);
+        header[size++] = (uint8) (flagVersion | flagContentChecksum | (hasDictionary ? flagDictionaryID : 0));
+        header[size++] = 4 << 4; // 64KB blocks
+
+        if (hasDictionary)
+            writeInt (dictionaryID);
+
+        header[size] = (uint8) (XXHash32::calculate (header + 4, size - 4) >> 8);
+        return out.write (header, size + 1);
+    }
+
+    //==============================================================================
+    size_t compressBlock (const uint8* const start, const uint8* const end) noexcept
+    {
+        const uint8* ip = start;
+        const uint8* anchor = start;
+        op = compressed;
+
+        if ((size_t) (end - start) > matchStartLimit)
+        {
+            const auto* const matchStartEnd = end - matchStartLimit;
+            const auto* const matchEnd = end - lastLiterals;
+
+            while (ip < matchStartEnd)
+            {
+                size_t distance = 0;
+                auto length = level == 1 ? findMatchFast (ip, matchEnd, distance)
+                                         : findMatchInChain (ip, matchEnd, distance);
+
+                if (length < minMatch)
+                {
+                    // When nothing has matched for a while, the data probably won't compress, so skip through it faster
+                    ip += level == 1 ? 1 + ((size_t) (ip - anchor) >> 6) : 1;
+                    continue;
+                }
+
+                // See if the match also covers some of the bytes before it
+                while (ip > anchor && ip - distance > buffer.get() && ip[-1] == ip[-1 - (ptrdiff_t) distance])
+                {
+                    --ip;
+                    ++length;
+                }
+
+                writeSequence (anchor, ip, distance, length);
+                ip += length;
+                anchor = ip;
+
+                if (level == 1 && ip < matchStartEnd)
+                    hashTable[hash (ip - 2)] = getPosition (ip - 2);
+            }
+        }
+
+        writeSequence (anchor, end, 0, 0);
+        return (size_t) (op - compressed.get());
+    }
+
+    size_t findMatchFast (const uint8* ip, const uint8* matchEnd, size_t& distance) noexcept
+    {
+        auto& entry = hashTable[hash (ip)];
+        const auto position = getPosition (ip);
+        distance = (size_t) (uint32) (position - entry);
+        entry = position;
+
+        if (! isValidMatch (ip, distance))
+            return 0;
+
+        return minMatch + countMatchingBytes (ip + minMatch, ip + minMatch - distance, matchEnd);
+    }
+
+    size_t findMatchInChain (const uint8* ip, const uint8* matchEnd, size_t& distance) noexcept
+    {
+        insertPositionsUpTo (ip);
+
+        const auto position = getPosition (ip);
+        auto candidate = hashTable[hash (ip)];
+        size_t bestLength = 0;
+
+        for (int attempts = maxAttempts; --attempts >= 0;)
+        {
+            const auto candidateDistance = (size_t) (uint32) (position - candidate);
+
+            if (candidateDistance == 0 || candidateDistance >= LZ4Helpers::windowSize
+                 || candidateDistance > (size_t) (ip - buffer.get()))
+                break;
+
+            const auto* match = ip - candidateDistance;
+
+            // (checking the byte that would make it longer than the best so far rejects most candidates quickly)
+            if (match[bestLength] == ip[bestLength] && readUnaligned<uint32> (match) == readUnaligned<uint32> (ip))
+            {
+                auto length = minMatch + countMatchingBytes (ip + minMatch, match + minMatch, matchEnd);
+
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    distance = candidateDistance;
+
+                    if (ip + length >= matchEnd)
+                        break;
+                }
+            }
+
+            const auto delta = chainTable[candidate & 0xffff];
+
+            if (delta == 0)
+                break;
+
+            candidate -= delta;
+        }
+
+        return bestLength;
+    }
+
+    void insertPositionsUpTo (const uint8* ip) noexcept
+    {
+        const auto end = getPosition (ip);
+
+        if ((int32) (nextToInsert - bufferBase) < 0)
+            nextToInsert = bufferBase;
+
+        for (; nextToInsert < end; ++nextToInsert)
+        {
+            auto& entry = hashTable[hash (buffer + (nextToInsert - bufferBase))];
+            chainTable[nextToInsert & 0xffff] = (uint16) jmin ((uint32) 0xffff, nextToInsert - entry);
+            entry = nextToInsert;
+        }
+    }
+
+    bool isValidMatch (const uint8* ip, size_t distance) const noexcept
+    {
+        return distance > 0 && distance < LZ4Helpers::windowSize
+                && distance <= (size_t) (ip - buffer.get())
+                && readUnaligned<uint32> (ip - distance) == readUnaligned<uint32> (ip);
+    }
+
+    static size_t countMatchingBytes (const uint8* p, const uint8* match, const uint8* end) noexcept
+    {
+        const auto* const start = p;
+
+        while (p + 8 <= end && readUnaligned<uint64> (p) == readUnaligned<uint64> (match))
+        {
+            p += 8;
+            match += 8;
+        }
+
+        while (p < end && *p == *match)
+        {
+            ++p;
+            ++match;
+        }
+
+        return (size_t) (p - start);
+    }
+
+    void writeSequence (const uint8* literals, const uint8* literalsEnd, size_t distance, size_t matchLength) noexcept
+    {
+        auto writeLength = [this] (size_t length)
+        {
+            for (; length >= 255; length -= 255)
+                *op++ = 255;
+
+            *op++ = (uint8) length;
+        };
+
+        auto* token = op++;
+        const auto numLiterals = (size_t) (literalsEnd - literals);
+
+        *token = (uint8) (jmin ((size_t) 15, numLiterals) << 4);
+
+        if (numLiterals >= 15)
+            writeLength (numLiterals - 15);
+
+        memcpy (op, literals, numLiterals);
+        op += numLiterals;
+
+        // The last sequence in a block has no match
+        if (matchLength == 0)
+            return;
+
+        *op++ = (uint8) distance;
+        *op++ = (uint8) (distance >> 8);
+
+        matchLength -= minMatch;
+        *token |= (uint8) jmin ((size_t) 15, matchLength);
+
+        if (matchLength >= 15)
+            writeLength (matchLength - 15);
+    }
+
+    //==============================================================================
+    const int level, hashBits, maxAttempts;
+
+    HeapBlock<uint8> buffer, compressed;
+    HeapBlock<uint32> hashTable;
+    HeapBlock<uint16> chainTable;
+    uint8* op = nullptr;
+
+    size_t bufferUsed = 0, blockStart = 0;
+    uint32 bufferBase = 0, nextToInsert = 0, dictionaryID = 0;
+    LZ4Helpers::XXHash32 contentChecksum;
+    bool hasDictionary = false, headerWritten = false, finished = false;
+
+    JUCE_DECLARE_NON_COPYABLE (LZ4CompressorHelper)
+};
+
+//==============================================================================
+LZ4CompressorOutputStream::LZ4CompressorOutputStream (OutputStream& s, int compressionLevel)
+   : LZ4CompressorOutputStream (&s, compressionLevel, false)
+{
+}
+
+LZ4CompressorOutputStream::LZ4CompressorOutputStream (OutputStream* out, int compressionLevel, bool deleteDestStream)
+   : destStream (out, deleteDestStream),
+     helper (new LZ4CompressorHelper (compressionLevel))
+{
+    jassert (out != nullptr);
+}
+
+LZ4CompressorOutputStream::~LZ4CompressorOutputStream()
+{
+    flush();
+}
+
+void LZ4CompressorOutputStream::setDictionary (const void* dictionaryData, size_t dictionarySize)
+{
+    jassert (dictionaryData != nullptr || dictionarySize == 0);
+
+    helper->setDictionary (dictionaryData, dictionarySize);
+}
+
+void LZ4CompressorOutputStream::flush()
+{
+    helper->finish (*destStream);
+    destStream->flush();
+}
+
+bool LZ4CompressorOutputStream::write (const void* destBuffer, size_t howMany)
+{
+    jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
+
+    return helper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
+}
+
+int64 LZ4CompressorOutputStream::getPosition()
+{
+    return destStream->getPosition();
+}
+
+bool LZ4CompressorOutputStream::setPosition (int64 /*newPosition*/)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
+
+} // namespace juce
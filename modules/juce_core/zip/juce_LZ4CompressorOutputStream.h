@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A stream which compresses the data written into it using LZ4.
+
+    LZ4 compresses several times faster than zlib and decompresses faster still, at the cost
+    of a lower compression ratio, which makes it a good choice for data like state snapshots
+    that is written often and needs to be small rather than as small as possible.
+
+    The output is a standard LZ4 frame, made of linked 64KB blocks followed by a checksum of
+    the content, which can also be read by the lz4 command line tool and library.
+
+    All the memory that the stream needs is allocated when it is created, so writing to it
+    doesn't allocate anything unless the destination stream does.
+
+    Important note: When you call flush() on an LZ4CompressorOutputStream, the frame is
+    closed - this means that no more data can be written to it, and any subsequent attempts
+    to call write() will cause an assertion.
+
+    @see LZ4DecompressorInputStream, GZIPCompressorOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  LZ4CompressorOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a compression stream.
+        @param destStream                       the stream into which the compressed data will be written
+        @param compressionLevel                 how much to compress the data, between 0 and 9, where
+                                                0 is non-compressed storage, 1 is the fastest/lowest compression,
+                                                and 9 is the slowest/highest compression. Any value outside this range
+                                                indicates that the default, fastest, level should be used.
+    */
+    LZ4CompressorOutputStream (OutputStream& destStream,
+                               int compressionLevel = -1);
+
+    /** Creates a compression stream.
+        @param destStream                       the stream into which the compressed data will be written.
+                                                Ownership of this object depends on the value of deleteDestStreamWhenDestroyed
+        @param compressionLevel                 how much to compress the data, between 0 and 9, where
+                                                0 is non-compressed storage, 1 is the fastest/lowest compression,
+                                                and 9 is the slowest/highest compression. Any value outside this range
+                                                indicates that the default, fastest, level should be used.
+        @param deleteDestStreamWhenDestroyed    whether or not the LZ4CompressorOutputStream will delete the
+                                                destStream object when it is destroyed
+    */
+    LZ4CompressorOutputStream (OutputStream* destStream,
+                               int compressionLevel = -1,
+                               bool deleteDestStreamWhenDestroyed = false);
+
+    /** Destructor. */
+    ~LZ4CompressorOutputStream() override;
+
+    //==============================================================================
+    /** Sets a dictionary of data that's likely to appear in the stream.
+
+        Small pieces of data compress much better when the compressor can refer back to
+        similar data that the decompressor already has. The last 64KB of the dictionary
+        are used, and the same dictionary has to be given to the LZ4DecompressorInputStream.
+
+        This must be called before anything is written to the stream.
+    */
+    void setDictionary (const void* dictionaryData, size_t dictionarySize);
+
+    //==============================================================================
+    /** Flushes and closes the stream.
+        Note that unlike most streams, when you call flush() on an LZ4CompressorOutputStream,
+        the stream is closed - this means that no more data can be written to it, and any
+        subsequent attempts to call write() will cause an assertion.
+    */
+    void flush() override;
+
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<OutputStream> destStream;
+
+    class LZ4CompressorHelper;
+    std::unique_ptr<LZ4CompressorHelper> helper;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LZ4CompressorOutputStream)
+};
+
+} // namespace juce
@@ -0,0 +1,654 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// The parts of the LZ4 frame format that the compressor and decompressor share.
+// See https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+namespace LZ4Helpers
+{
+    enum : uint32
+    {
+        frameMagic          = 0x184D2204,
+        skippableFrameMagic = 0x184D2A50,
+        skippableFrameMask  = 0xFFFFFFF0,
+        uncompressedBlockFlag = 0x80000000
+    };
+
+    enum : uint8
+    {
+        flagVersion         = 0x40,
+        flagIndependent     = 0x20,
+        flagBlockChecksum   = 0x10,
+        flagContentSize     = 0x08,
+        flagContentChecksum = 0x04,
+        flagDictionaryID    = 0x01
+    };
+
+    constexpr size_t windowSize = 65536;   // the furthest back that a match can refer to
+    constexpr size_t wildCopySlack = 32;   // the amount that a copy can overrun its destination
+
+    inline uint32 rotateLeft (uint32 value, int bits) noexcept  { return (value << bits) | (value >> (32 - bits)); }
+
+    //==============================================================================
+    /** The xxHash32 checksum that the frame format uses, which can be calculated in pieces. */
+    class XXHash32
+    {
+    public:
+        explicit XXHash32 (uint32 seedToUse = 0) noexcept
+            : seed (seedToUse),
+              accumulators { seed + prime1 + prime2, seed + prime2, seed, seed - prime1 }
+        {
+        }
+
+        static uint32 calculate (const void* data, size_t numBytes, uint32 seed = 0) noexcept
+        {
+            XXHash32 hash (seed);
+            hash.update (data, numBytes);
+            return hash.getResult();
+        }
+
+        void update (const void* data, size_t numBytes) noexcept
+        {
+            auto* input = static_cast<const uint8*> (data);
+            totalLength += numBytes;
+
+            if (numPending > 0)
+            {
+                auto numToCopy = jmin (numBytes, (size_t) 16 - numPending);
+                memcpy (pending + numPending, input, numToCopy);
+                numPending += numToCopy;
+                input += numToCopy;
+                numBytes -= numToCopy;
+
+                if (numPending < 16)
+                    return;
+
+                processStripe (pending);
+                numPending = 0;
+            }
+
+            for (; numBytes >= 16; input += 16, numBytes -= 16)
+                processStripe (input);
+
+            memcpy (pending, input, numBytes);
+            numPending = numBytes;
+        }
+
+        uint32 getResult() const noexcept
+        {
+            auto hash = totalLength >= 16 ? rotateLeft (accumulators[0], 1) + rotateLeft (accumulators[1], 7)
+                                              + rotateLeft (accumulators[2], 12) + rotateLeft (accumulators[3], 18)
+                                          : seed + prime5;
+
+            hash += (uint32) totalLength;
+
+            size_t i = 0;
+
+            for (; i + 4 <= numPending; i += 4)
+                hash = rotateLeft (hash + ByteOrder::littleEndianInt (pending + i) * prime3, 17) * prime4;
+
+            for (; i < numPending; ++i)
+                hash = rotateLeft (hash + pending[i] * prime5, 11) * prime1;
+
+            hash ^= hash >> 15;
+            hash *= prime2;
+            hash ^= hash >> 13;
+            hash *= prime3;
+            hash ^= hash >> 16;
+            return hash;
+        }
+
+    private:
+        static constexpr uint32 prime1 = 2654435761u, prime2 = 2246822519u, prime3 = 3266489917u,
+                                prime4 = 668265263u,  prime5 = 374761393u;
+
+        void processStripe (const uint8* input) noexcept
+        {
+            for (int i = 0; i < 4; ++i)
+                accumulators[i] = rotateLeft (accumulators[i] + ByteOrder::littleEndianInt (input + 4 * i) * prime2, 13) * prime1;
+        }
+
+        uint32 seed;
+        uint32 accumulators[4];
+        uint64 totalLength = 0;
+        uint8 pending[16];
+        size_t numPending = 0;
+    };
+
+    /** Copies 8 bytes at a time, so may write up to 7 bytes beyond the end of the destination. */
+    inline void wildCopy (uint8* dest, const uint8* source, uint8* destEnd) noexcept
+    {
+        do
+        {
+            memcpy (dest, source, 8);
+            dest += 8;
+            source += 8;
+        }
+        while (dest < destEnd);
+    }
+}
+
+//==============================================================================
+class LZ4DecompressorInputStream::LZ4DecompressHelper
+{
+public:
+    LZ4DecompressHelper (InputStream& in, const MemoryBlock& dict)
+        : source (in), dictionary (dict)
+    {
+    }
+
+    /** Returns the number of decoded bytes waiting to be read, decoding the next block if
+        there are none. A result of zero means that the stream has ended, or has an error.
+    */
+    size_t getNumAvailable()
+    {
+        while (readPosition == decodedEnd && ! (finished || error))
+        {
+            if (! headerRead)
+                readHeader();
+            else
+                decodeNextBlock();
+        }
+
+        return decodedEnd - readPosition;
+    }
+
+    size_t read (uint8* dest, size_t numBytes)
+    {
+        numBytes = jmin (numBytes, getNumAvailable());
+
+        if (numBytes > 0)
+        {
+            memcpy (dest, window + readPosition, numBytes);
+            readPosition += numBytes;
+        }
+
+        return numBytes;
+    }
+
+    bool isExhausted() const noexcept   { return (finished || error) && readPosition == decodedEnd; }
+
+    /** Adds up the sizes in the headers of all the frames from the source's position to its
+        end, stepping over their blocks without decoding them. This returns -1 if any of the
+        frames doesn't say how big it is, or the data is damaged.
+    */
+    static int64 findTotalContentSize (InputStream& in)
+    {
+        using namespace LZ4Helpers;
+
+        auto readInt = [&in] (uint32& value)
+        {
+            uint8 bytes[4];
+
+            if (in.read (bytes, 4) != 4)
+                return false;
+
+            value = ByteOrder::littleEndianInt (bytes);
+            return true;
+        };
+
+        auto skip = [&in] (int64 numBytes)
+        {
+            const auto newPosition = in.getPosition() + numBytes;
+            return newPosition <= in.getTotalLength() && in.setPosition (newPosition);
+        };
+
+        int64 total = 0;
+        int numFrames = 0;
+
+        for (;;)
+        {
+            uint32 magic;
+
+            if (! readInt (magic))
+                return numFrames > 0 ? total : -1;
+
+            if ((magic & skippableFrameMask) == skippableFrameMagic)
+            {
+                uint32 size;
+
+                if (! readInt (size) || ! skip (size))
+                    return -1;
+
+                continue;
+            }
+
+            uint8 descriptor[2], sizeBytes[8];
+
+            if (magic != frameMagic || in.read (descriptor, 2) != 2
+                 || (descriptor[0] & flagContentSize) == 0 || in.read (sizeBytes, 8) != 8)
+                return -1;
+
+            total += (int64) ByteOrder::littleEndianInt64 (sizeBytes);
+
+            // (the dictionary ID and header checksum)
+            if (! skip (((descriptor[0] & flagDictionaryID) != 0 ? 4 : 0) + 1))
+                return -1;
+
+            for (;;)
+            {
+                uint32 blockSize;
+
+                if (! readInt (blockSize))
+                    return -1;
+
+                if (blockSize == 0)
+                {
+                    if (! skip ((descriptor[0] & flagContentChecksum) != 0 ? 4 : 0))
+                        return -1;
+
+                    break;
+                }
+
+                if (! skip ((blockSize & ~(uint32) uncompressedBlockFlag) + ((descriptor[0] & flagBlockChecksum) != 0 ? 4 : 0)))
+                    return -1;
+            }
+
+            ++numFrames;
+        }
+    }
+
+    bool error = false;
+
+private:
+    bool readFully (void* dest, size_t numBytes)
+    {
+        auto* d = static_cast<char*> (dest);
+
+        while (numBytes > 0)
+        {
+            auto numRead = source.read (d, (int) jmin (numBytes, (size_t) 0x10000000));
+
+            if (numRead <= 0)
+                return false;
+
+            d += numRead;
+            numBytes -= (size_t) numRead;
+        }
+
+        return true;
+    }
+
+    void fail() noexcept
+    {
+        error = true;
+        readPosition = decodedEnd = 0;
+    }
+
+    void readHeader()
+    {
+        using namespace LZ4Helpers;
+
+        uint8 header[16];
+        const auto numRead = source.read (header, 4);
+
+        // Another frame can follow the end of one, so running out of data here is the normal end
+        if (numRead <= 0 && numFramesRead > 0)
+        {
+            finished = true;
+            return;
+        }
+
+        if (! readFully (header + jmax (0, numRead), (size_t) (4 - jmax (0, numRead))))
+            return fail();
+
+        auto magic = ByteOrder::littleEndianInt (header);
+
+        if ((magic & skippableFrameMask) == skippableFrameMagic)
+        {
+            uint8 sizeBytes[4];
+
+            if (! readFully (sizeBytes, 4))
+                return fail();
+
+            source.skipNextBytes (ByteOrder::littleEndianInt (sizeBytes));
+            return;
+        }
+
+        if (magic != frameMagic || ! readFully (header, 2))
+            return fail();
+
+        const auto flags = header[0];
+        const auto blockSizeCode = (header[1] >> 4) & 7;
+
+        if ((flags & 0xc0) != flagVersion || (flags & 2) != 0 || (header[1] & 0x8f) != 0 || blockSizeCode < 4)
+            return fail();
+
+        size_t headerSize = 2;
+
+        if ((flags & flagContentSize) != 0)
+        {
+            if (! readFully (header + headerSize, 8))
+                return fail();
+
+            headerSize += 8;
+        }
+
+        if ((flags & flagDictionaryID) != 0)
+        {
+            if (! readFully (header + headerSize, 4))
+                return fail();
+
+            headerSize += 4;
+
+            // This data can only be decompressed with the dictionary it was compressed with
+            if (dictionary.isEmpty())
+                return fail();
+        }
+
+        uint8 headerChecksum;
+
+        if (! readFully (&headerChecksum, 1)
+             || headerChecksum != (uint8) (XXHash32::calculate (header, headerSize) >> 8))
+            return fail();
+
+        independentBlocks   = (flags & flagIndependent) != 0;
+        hasBlockChecksums   = (flags & flagBlockChecksum) != 0;
+        hasContentChecksum  = (flags & flagContentChecksum) != 0;
+        maxBlockSize = (size_t) 1 << (8 + 2 * blockSizeCode);
+
+        // The window holds the 64KB of history that a block can refer back to, followed by the block
+        window.malloc (windowSize + maxBlockSize + wildCopySlack);
+        compressed.malloc (maxBlockSize + wildCopySlack);
+
+        contentChecksum = XXHash32();
+        readPosition = decodedEnd = loadDictionary();
+        headerRead = true;
+    }
+
+    size_t loadDictionary() noexcept
+    {
+        auto numBytes = jmin (dictionary.getSize(), LZ4Helpers::windowSize);
+
+        if (numBytes > 0)
+            memcpy (window, addBytesToPointer (dictionary.getData(), dictionary.getSize() - numBytes), numBytes);
+
+        return numBytes;
+    }
+
+    void decodeNextBlock()
+    {
+        using namespace LZ4Helpers;
+
+        uint8 sizeBytes[4];
+
+        if (! readFully (sizeBytes, 4))
+            return fail();
+
+        auto blockSize = ByteOrder::littleEndianInt (sizeBytes);
+
+        if (blockSize == 0)
+        {
+            uint8 checksum[4];
+
+            if (hasContentChecksum
+                 && (! readFully (checksum, 4) || ByteOrder::littleEndianInt (checksum) != contentChecksum.getResult()))
+                return fail();
+
+            // Go back to look for another frame
+            headerRead = false;
+            ++numFramesRead;
+            return;
+        }
+
+        const bool isCompressed = (blockSize & uncompressedBlockFlag) == 0;
+        blockSize &= ~(uint32) uncompressedBlockFlag;
+
+        if (blockSize > maxBlockSize || ! readFully (compressed, blockSize))
+            return fail();
+
+        if (hasBlockChecksums)
+        {
+            // The block checksum covers the block as it's stored, so is checked before decoding it
+            uint8 checksum[4];
+
+            if (! readFully (checksum, 4) || ByteOrder::littleEndianInt (checksum) != XXHash32::calculate (compressed, blockSize))
+                return fail();
+        }
+
+        // Make room for the next block, keeping whatever it can refer back to
+        if (independentBlocks)
+        {
+            decodedEnd = loadDictionary();
+        }
+        else if (decodedEnd + maxBlockSize > windowSize + maxBlockSize)
+        {
+            memmove (window, window + decodedEnd - windowSize, windowSize);
+            decodedEnd = windowSize;
+        }
+
+        readPosition = decodedEnd;
+
+        if (! isCompressed)
+        {
+            memcpy (window + decodedEnd, compressed, blockSize);
+            decodedEnd += blockSize;
+        }
+        else if (! decodeBlock (blockSize))
+        {
+            return fail();
+        }
+
+        if (hasContentChecksum)
+            contentChecksum.update (window + readPosition, decodedEnd - readPosition);
+    }
+
+    bool decodeBlock (size_t blockSize) noexcept
+    {
+        const uint8* ip = compressed;
+        const auto* const inputEnd = ip + blockSize;
+        auto* const windowStart = window.get();
+        auto* op = windowStart + decodedEnd;
+        auto* const outputEnd = op + maxBlockSize;
+
+        auto readLength = [&ip, inputEnd] (size_t length) -> size_t
+        {
+            if (length == 15)
+            {
+                for (;;)
+                {
+                    if (ip >= inputEnd)
+                        return std::numeric_limits<size_t>::max();
+
+                    auto byte = *ip++;
+                    length += byte;
+
+                    if (byte != 255)
+                        break;
+                }
+            }
+
+            return length;
+        };
+
+        for (;;)
+        {
+            if (ip >= inputEnd)
+                return false;
+
+            const auto token = *ip++;
+            const auto numLiterals = readLength ((size_t) (token >> 4));
+
+            if (numLiterals > (size_t) (inputEnd - ip) || numLiterals > (size_t) (outputEnd - op))
+                return false;
+
+            // (both buffers have enough slack after them for the copy to overrun)
+            LZ4Helpers::wildCopy (op, ip, op + numLiterals);
+            ip += numLiterals;
+            op += numLiterals;
+
+            // The last sequence in a block has no match
+            if (ip == inputEnd)
+                break;
+
+            if (inputEnd - ip < 2)
+                return false;
+
+            const auto offset = (size_t) ByteOrder::littleEndianShort (ip);
+            ip += 2;
+
+            if (offset == 0 || offset > (size_t) (op - windowStart))
+                return false;
+
+            auto matchLength = readLength ((size_t) (token & 15));
+
+            if (matchLength == std::numeric_limits<size_t>::max() || matchLength + 4 > (size_t) (outputEnd - op))
+                return false;
+
+            matchLength += 4;
+            const auto* match = op - offset;
+
+            if (offset >= 8)
+            {
+                LZ4Helpers::wildCopy (op, match, op + matchLength);
+            }
+            else
+            {
+                // The match overlaps the bytes it's producing, so they have to be copied one at a time
+                for (size_t i = 0; i < matchLength; ++i)
+                    op[i] = match[i];
+            }
+
+            op += matchLength;
+        }
+
+        decodedEnd = (size_t) (op - windowStart);
+        return true;
+    }
+
+    InputStream& source;
+    const MemoryBlock& dictionary;
+    HeapBlock<uint8> window, compressed;
+    LZ4Helpers::XXHash32 contentChecksum;
+    size_t maxBlockSize = 0, readPosition = 0, decodedEnd = 0;
+    int numFramesRead = 0;
+    bool headerRead = false, finished = false;
+    bool independentBlocks = false, hasBlockChecksums = false, hasContentChecksum = false;
+
+    JUCE_DECLARE_NON_COPYABLE (LZ4DecompressHelper)
+};
+
+//==============================================================================
+LZ4DecompressorInputStream::LZ4DecompressorInputStream (InputStream* source, bool deleteSourceWhenDestroyed,
+                                                        int64 uncompressedLength)
+  : sourceStream (source, deleteSourceWhenDestroyed),
+    uncompressedStreamLength (uncompressedLength),
+    originalSourcePos (source->getPosition()),
+    helper (new LZ4DecompressHelper (*source, dictionary))
+{
+}
+
+LZ4DecompressorInputStream::LZ4DecompressorInputStream (InputStream& source)
+  : LZ4DecompressorInputStream (&source, false)
+{
+}
+
+LZ4DecompressorInputStream::~LZ4DecompressorInputStream()
+{
+}
+
+void LZ4DecompressorInputStream::setDictionary (const void* dictionaryData, size_t dictionarySize)
+{
+    // The dictionary has to be set before anything is read!
+    jassert (currentPos == 0);
+
+    dictionary.replaceAll (dictionaryData, dictionarySize);
+}
+
+int64 LZ4DecompressorInputStream::getTotalLength()
+{
+    if (uncompressedStreamLength >= 0)
+        return uncompressedStreamLength;
+
+    // Any number of frames can follow the first one, so the only way to know the total is to
+    // step through all of them, which needs a source that can seek
+    if (! hasFoundContentSize)
+    {
+        hasFoundContentSize = true;
+
+        if (sourceStream->getTotalLength() >= 0)
+        {
+            const auto sourcePos = sourceStream->getPosition();
+
+            if (sourceStream->setPosition (originalSourcePos))
+                contentSize = LZ4DecompressHelper::findTotalContentSize (*sourceStream);
+
+            sourceStream->setPosition (sourcePos);
+        }
+    }
+
+    return contentSize;
+}
+
+int LZ4DecompressorInputStream::read (void* destBuffer, int howMany)
+{
+    jassert (destBuffer != nullptr && howMany >= 0);
+
+    int numRead = 0;
+    auto d = static_cast<uint8*> (destBuffer);
+
+    while (howMany > 0)
+    {
+        auto n = (int) helper->read (d + numRead, (size_t) howMany);
+
+        if (n == 0)
+            break;
+
+        numRead += n;
+        howMany -= n;
+    }
+
+    currentPos += numRead;
+    return numRead;
+}
+
+bool LZ4DecompressorInputStream::hasError() const noexcept
+{
+    return helper->error;
+}
+
+bool LZ4DecompressorInputStream::isExhausted()
+{
+    return helper->isExhausted();
+}
+
+int64 LZ4DecompressorInputStream::getPosition()
+{
+    return currentPos;
+}
+
+bool LZ4DecompressorInputStream::setPosition (int64 newPos)
+{
+    if (newPos < currentPos)
+    {
+        // to go backwards, reset the stream and start again..
+        currentPos = 0;
+        helper.reset (new LZ4DecompressHelper (*sourceStream, dictionary));
+        sourceStream->setPosition (originalSourcePos);
+    }
+
+    skipNextBytes (newPos - currentPos);
+    return true;
+}
+
+} // namespace juce
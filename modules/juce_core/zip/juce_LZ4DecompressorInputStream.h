@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    This stream will decompress a source-stream that holds data in the LZ4 frame format.
+
+    It can read any LZ4 frame, including those written by the lz4 command line tool and
+    library, with any block size and with linked or independent blocks. Several frames one
+    after another are read as one stream, and skippable frames are ignored. Block and content
+    checksums are verified when the frame has them, and a mismatch ends the stream with an
+    error, see hasError().
+
+    Unless a length is passed to the constructor, getTotalLength() can only find the size
+    if every frame recorded its size and the source stream can seek. Otherwise it returns -1.
+
+    If the data was compressed with a dictionary, the same dictionary must be passed to
+    setDictionary() before anything is read.
+
+    @see LZ4CompressorOutputStream, CompressionFormat
+
+    @tags{Core}
+*/
+class JUCE_API  LZ4DecompressorInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a decompressor stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether or not to delete the source stream
+                                            when this object is destroyed
+        @param uncompressedStreamLength     if the creator knows the length that the
+                                            uncompressed stream will be, then it can supply this
+                                            value, which will be returned by getTotalLength()
+    */
+    LZ4DecompressorInputStream (InputStream* sourceStream,
+                                bool deleteSourceWhenDestroyed,
+                                int64 uncompressedStreamLength = -1);
+
+    /** Creates a decompressor stream.
+
+        @param sourceStream     the stream to read from - the source stream must not be
+                                deleted until this object has been destroyed
+    */
+    LZ4DecompressorInputStream (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~LZ4DecompressorInputStream() override;
+
+    //==============================================================================
+    /** Sets the dictionary that the data was compressed with.
+        This must be called before anything is read from the stream.
+    */
+    void setDictionary (const void* dictionaryData, size_t dictionarySize);
+
+    /** Returns true if the stream ended early because the data was damaged or incomplete.
+
+        This includes a block or content checksum that doesn't match the data. Because the
+        content checksum comes at the end of the frame, all of the data may already have
+        been read by the time that a mismatch is found.
+    */
+    bool hasError() const noexcept;
+
+    //==============================================================================
+    int64 getPosition() override;
+    bool setPosition (int64 pos) override;
+    int64 getTotalLength() override;
+    bool isExhausted() override;
+    int read (void* destBuffer, int maxBytesToRead) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> sourceStream;
+    const int64 uncompressedStreamLength;
+    int64 originalSourcePos, currentPos = 0, contentSize = -1;
+    bool hasFoundContentSize = false;
+    MemoryBlock dictionary;
+
+    class LZ4DecompressHelper;
+    std::unique_ptr<LZ4DecompressHelper> helper;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LZ4DecompressorInputStream)
+};
+
+} // namespace juce
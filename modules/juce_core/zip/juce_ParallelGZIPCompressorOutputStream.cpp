@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct ParallelGZIPCompressorOutputStream::Block
+{
+    static constexpr size_t dictionarySize = 32768;
+
+    Block (WorkStealingScheduler& scheduler, int level, int bits, size_t blockSize)
+        : group (scheduler), capacity (blockSize)
+    {
+        using namespace zlibNamespace;
+        zerostruct (stream);
+
+        // The blocks are raw deflate data: the stream writes the header and trailer itself
+        streamIsValid = (deflateInit2 (&stream, level, Z_DEFLATED, -bits, 8, 0) == Z_OK);
+
+        input.malloc (blockSize);
+    }
+
+    ~Block()
+    {
+        if (streamIsValid)
+            zlibNamespace::deflateEnd (&stream);
+    }
+
+    void compress (bool isGZIP, bool isRaw)
+    {
+        using namespace zlibNamespace;
+
+        failed = true;
+        outputSize = 0;
+
+        if (! streamIsValid || deflateReset (&stream) != Z_OK)
+            return;
+
+        if (dictionaryLength > 0 && deflateSetDictionary (&stream, dictionary, (uInt) dictionaryLength) != Z_OK)
+            return;
+
+        // (the extra space covers the empty stored block that a sync flush adds)
+        auto outputCapacity = (size_t) deflateBound (&stream, (uLong) inputSize) + 64;
+
+        if (outputCapacity > allocatedOutputSize)
+        {
+            output.realloc (outputCapacity);
+            allocatedOutputSize = outputCapacity;
+        }
+
+        stream.next_in   = input.get();
+        stream.avail_in  = (uInt) inputSize;
+        stream.next_out  = output.get();
+        stream.avail_out = (uInt) allocatedOutputSize;
+
+        // Every block but the last ends with a sync flush, which leaves the output on a byte
+        // boundary without marking the end of the stream, so the next block can follow on.
+        const auto flushMode = isLast ? Z_FINISH : Z_SYNC_FLUSH;
+
+        for (;;)
+        {
+            auto result = deflate (&stream, flushMode);
+
+            if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR)
+                return;
+
+            if (isLast ? result == Z_STREAM_END : (stream.avail_in == 0 && stream.avail_out > 0))
+                break;
+
+            auto used = allocatedOutputSize - stream.avail_out;
+            allocatedOutputSize *= 2;
+            output.realloc (allocatedOutputSize);
+            stream.next_out  = output.get() + used;
+            stream.avail_out = (uInt) (allocatedOutputSize - used);
+        }
+
+        outputSize = allocatedOutputSize - stream.avail_out;
+
+        if (isGZIP)
+            checksum = (uint32) crc32 (0, input.get(), (uInt) inputSize);
+        else if (! isRaw)
+            checksum = (uint32) adler32 (1, input.get(), (uInt) inputSize);
+
+        failed = false;
+    }
+
+    WorkStealingScheduler::TaskGroup group;
+    zlibNamespace::z_stream stream;
+    bool streamIsValid = false;
+
+    HeapBlock<uint8> input, output;
+    const size_t capacity;
+    size_t inputSize = 0, outputSize = 0, allocatedOutputSize = 0, dictionaryLength = 0;
+    uint8 dictionary[dictionarySize];
+    uint32 checksum = 0;
+    bool isLast = false, failed = false;
+
+    JUCE_DECLARE_NON_COPYABLE (Block)
+};
+
+//==============================================================================
+ParallelGZIPCompressorOutputStream::ParallelGZIPCompressorOutputStream (OutputStream& dest,
+                                                                        WorkStealingScheduler& scheduler,
+                                                                        int level,
+                                                                        int bits,
+                                                                        int blockSizeBytes)
+    : destStream (dest),
+      compressionLevel ((level < 0 || level > 9) ? 6 : level),
+      windowBits (bits == 0 ? 15 : (std::abs (bits) & 15)),
+      isGZIP (bits > 15),
+      isRaw (bits < 0)
+{
+    const auto blockSize = (size_t) jmax ((int) Block::dictionarySize, blockSizeBytes);
+
+    // Enough blocks to keep all the workers busy while the finished ones are written out
+    const auto numBlocks = 2 * (scheduler.getNumThreads() + 1);
+
+    for (int i = 0; i < numBlocks; ++i)
+        freeBlocks.add (blocks.add (new Block (scheduler, compressionLevel, windowBits, blockSize)));
+
+    currentBlock = freeBlocks.removeAndReturn (freeBlocks.size() - 1);
+}
+
+ParallelGZIPCompressorOutputStream::~ParallelGZIPCompressorOutputStream()
+{
+    flush();
+}
+
+//==============================================================================
+bool ParallelGZIPCompressorOutputStream::write (const void* data, size_t numBytes)
+{
+    // When you call flush() on a gzip stream, the stream is closed, and you can
+    // no longer continue to write data to it!
+    jassert (! finished);
+    jassert (data != nullptr && (ssize_t) numBytes >= 0);
+
+    auto* source = static_cast<const uint8*> (data);
+
+    while (numBytes > 0 && ! (finished || failed))
+    {
+        auto numToCopy = jmin (numBytes, currentBlock->capacity - currentBlock->inputSize);
+        memcpy (currentBlock->input + currentBlock->inputSize, source, numToCopy);
+        currentBlock->inputSize += numToCopy;
+        source += numToCopy;
+        numBytes -= numToCopy;
+
+        if (currentBlock->inputSize == currentBlock->capacity)
+            submitCurrentBlock (false);
+    }
+
+    return ! (finished || failed);
+}
+
+void ParallelGZIPCompressorOutputStream::flush()
+{
+    if (! finished)
+    {
+        submitCurrentBlock (true);
+
+        while (! pendingBlocks.isEmpty())
+            writeOldestBlock();
+
+        if (! (failed || isRaw))
+        {
+            if (isGZIP)
+            {
+                destStream.writeInt ((int) checksum);
+                destStream.writeInt ((int) (uint32) totalBytesIn);
+            }
+            else
+            {
+                destStream.writeIntBigEndian ((int) checksum);
+            }
+        }
+
+        finished = true;
+    }
+
+    destStream.flush();
+}
+
+int64 ParallelGZIPCompressorOutputStream::getPosition()
+{
+    return destStream.getPosition();
+}
+
+bool ParallelGZIPCompressorOutputStream::setPosition (int64)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
+
+//==============================================================================
+void ParallelGZIPCompressorOutputStream::submitCurrentBlock (bool isLast)
+{
+    auto* block = currentBlock;
+    block->isLast = isLast;
+    block->dictionaryLength = 0;
+
+    if (previousBlock != nullptr)
+    {
+        // The previous block can't have been reused yet, because it's still pending
+        block->dictionaryLength = jmin (Block::dictionarySize, previousBlock->inputSize);
+        memcpy (block->dictionary, previousBlock->input + previousBlock->inputSize - block->dictionaryLength, block->dictionaryLength);
+    }
+
+    pendingBlocks.add (block);
+    block->group.run ([block, gzip = isGZIP, raw = isRaw] { block->compress (gzip, raw); });
+    previousBlock = block;
+    currentBlock = nullptr;
+
+    if (isLast)
+        return;
+
+    if (freeBlocks.isEmpty())
+        writeOldestBlock();
+
+    currentBlock = freeBlocks.removeAndReturn (freeBlocks.size() - 1);
+    currentBlock->inputSize = 0;
+}
+
+void ParallelGZIPCompressorOutputStream::writeOldestBlock()
+{
+    auto* block = pendingBlocks.removeAndReturn (0);
+    block->group.wait();
+
+    if (block->failed)
+        failed = true;
+
+    if (! failed)
+    {
+        if (! headerWritten)
+            writeHeader();
+
+        if (! destStream.write (block->output, block->outputSize))
+            failed = true;
+
+        if (totalBytesIn == 0)
+            checksum = block->checksum;
+        else if (isGZIP)
+            checksum = (uint32) zlibNamespace::crc32_combine (checksum, block->checksum, (long) block->inputSize);
+        else
+            checksum = (uint32) zlibNamespace::adler32_combine (checksum, block->checksum, (long) block->inputSize);
+
+        totalBytesIn += (int64) block->inputSize;
+    }
+
+    // The following block has taken its dictionary by now, so this one can be reused
+    if (block == previousBlock)
+        previousBlock = nullptr;
+
+    freeBlocks.add (block);
+}
+
+void ParallelGZIPCompressorOutputStream::writeHeader()
+{
+    headerWritten = true;
+
+    if (isRaw)
+        return;
+
+    if (isGZIP)
+    {
+        // Magic number, deflate method, no flags, no timestamp, and an unknown OS
+        const uint8 header[] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0,
+                                 (uint8) (compressionLevel == 9 ? 2 : (compressionLevel < 2 ? 4 : 0)), 0xff };
+        destStream.write (header, sizeof (header));
+    }
+    else
+    {
+        const auto levelFlags = compressionLevel < 2 ? 0 : (compressionLevel < 6 ? 1 : (compressionLevel == 6 ? 2 : 3));
+        auto header = (((windowBits - 8) << 4 | 8) << 8) | (levelFlags << 6);
+        header += 31 - (header % 31);
+        destStream.writeShortBigEndian ((short) header);
+    }
+}
+
+} // namespace juce
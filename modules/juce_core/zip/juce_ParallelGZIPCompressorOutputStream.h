@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A stream which compresses the data written into it on several threads at once.
+
+    The data is split into blocks, which are compressed independently by the workers of
+    a WorkStealingScheduler. Each block uses the end of the block before it as its
+    dictionary and ends on a byte boundary, so the compressed blocks can simply be joined
+    together, and the result is an ordinary zlib, gzip or raw deflate stream that any
+    decompressor, including GZIPDecompressorInputStream, can read. The checksums of the
+    blocks are combined in the same way.
+
+    The compression ratio is within a fraction of a percent of GZIPCompressorOutputStream's
+    for the default block size, and the speed scales with the number of threads, which makes
+    this worthwhile for anything more than a few megabytes.
+
+    As with GZIPCompressorOutputStream, calling flush() finishes the compressed data, so no
+    more can be written after that.
+
+    @see GZIPCompressorOutputStream, WorkStealingScheduler
+
+    @tags{Core}
+*/
+class JUCE_API  ParallelGZIPCompressorOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a compression stream.
+
+        @param destStream           the stream into which the compressed data will be written
+        @param scheduler            the scheduler whose worker threads will compress the blocks
+        @param compressionLevel     how much to compress the data, between 0 and 9, where 0 is
+                                    non-compressed storage, 1 is the fastest and 9 is the slowest.
+                                    Any value outside this range selects the default level.
+        @param windowBits           one of the GZIPCompressorOutputStream::WindowBitsValues, or 0 to
+                                    write the zlib format, as GZIPCompressorOutputStream does
+        @param blockSizeBytes       the amount of data in each block. Blocks smaller than 32KB can't
+                                    make use of the whole dictionary, so this is never less than that.
+    */
+    ParallelGZIPCompressorOutputStream (OutputStream& destStream,
+                                        WorkStealingScheduler& scheduler,
+                                        int compressionLevel = -1,
+                                        int windowBits = 0,
+                                        int blockSizeBytes = 128 * 1024);
+
+    /** Destructor. This will flush the stream if it hasn't already been flushed. */
+    ~ParallelGZIPCompressorOutputStream() override;
+
+    //==============================================================================
+    /** Waits for all the blocks to be compressed, writes them and closes the stream.
+        No more data can be written after this has been called.
+    */
+    void flush() override;
+
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    struct Block;
+
+    void submitCurrentBlock (bool isLast);
+    void writeOldestBlock();
+    void writeHeader();
+
+    OutputStream& destStream;
+    const int compressionLevel, windowBits;
+    const bool isGZIP, isRaw;
+
+    OwnedArray<Block> blocks;
+    Array<Block*> pendingBlocks, freeBlocks;
+    Block* currentBlock = nullptr;
+    Block* previousBlock = nullptr;
+
+    uint32 checksum = 0;
+    int64 totalBytesIn = 0;
+    bool headerWritten = false, finished = false, failed = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelGZIPCompressorOutputStream)
+};
+
+} // namespace juce
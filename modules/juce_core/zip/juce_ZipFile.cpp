@@ -268,7 +268,9 @@ ZipFile::ZipFile (InputStream& stream)  : inputStream (&stream)
     init();
 }
 
-ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
+ZipFile::ZipFile (const File& file)
+    : inputSource (new FileInputSource (file)),
+      archiveFile (file)
 {
     init();
 }
@@ -334,7 +336,19 @@ InputStream* ZipFile::createStreamForEntry (const int index)
 
     if (auto* zei = entries[index])
     {
-        stream = new ZipInputStream (*this, *zei);
+        if (sourceData != nullptr)
+        {
+            auto* data = getEntryData (*zei, sourceData, sourceDataSize);
+
+            if (data == nullptr)
+                return nullptr;
+
+            stream = new MemoryInputStream (data, (size_t) zei->compressedSize, false);
+        }
+        else
+        {
+            stream = new ZipInputStream (*this, *zei);
+        }
 
         if (zei->isCompressed)
         {
@@ -371,7 +385,18 @@ void ZipFile::init()
     std::unique_ptr<InputStream> toDelete;
     InputStream* in = inputStream;
 
-    if (inputSource != nullptr)
+    if (auto* memoryStream = dynamic_cast<MemoryInputStream*> (inputStream))
+    {
+        sourceData = static_cast<const char*> (memoryStream->getData());
+        sourceDataSize = memoryStream->getDataSize();
+    }
+
+    if (sourceData != nullptr)
+    {
+        in = new MemoryInputStream (sourceData, sourceDataSize, false);
+        toDelete.reset (in);
+    }
+    else if (inputSource != nullptr)
     {
         in = inputSource->createInputStream();
         toDelete.reset (in);
@@ -429,6 +454,98 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory,
+                              const bool shouldOverwriteFiles,
+                              WorkStealingScheduler& scheduler)
+{
+    // Entries can't be read in parallel from a single shared stream
+    if (sourceData == nullptr && inputSource == nullptr)
+        return uncompressTo (targetDirectory, shouldOverwriteFiles);
+
+    std::vector<int> fileEntries, linkEntries;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries.getUnchecked (i)->entry;
+        (entry.isSymbolicLink ? linkEntries : fileEntries).push_back (i);
+
+       #if JUCE_WINDOWS
+        auto entryPath = entry.filename;
+       #else
+        auto entryPath = entry.filename.replaceCharacter ('\\', '/');
+       #endif
+
+        // Create all the folders first, so that the threads don't race to create the same ones.
+        // Any entries that are outside the target or lead through a link are left for
+        // uncompressEntry() to report.
+        auto targetFile = targetDirectory.getChildFile (entryPath);
+        auto folder = (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\')) ? targetFile
+                                                                                      : targetFile.getParentDirectory();
+
+        if (entryPath.isNotEmpty()
+             && (folder == targetDirectory || folder.isAChildOf (targetDirectory))
+             && ! hasSymbolicPart (targetDirectory, folder))
+            folder.createDirectory();
+    }
+
+    // Starting with the biggest entries means that no thread is left with a big one at the end
+    std::stable_sort (fileEntries.begin(), fileEntries.end(), [this] (int a, int b)
+    {
+        return entries.getUnchecked (a)->compressedSize > entries.getUnchecked (b)->compressedSize;
+    });
+
+    // The file is only mapped while the entries are being expanded, so that it isn't kept
+    // locked, and a stream is used for each entry if it can't be mapped
+    const char* archiveData = sourceData;
+    auto archiveSize = sourceDataSize;
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+
+    if (archiveData == nullptr && archiveFile != File())
+    {
+        mappedFile = std::make_unique<MemoryMappedFile> (archiveFile, MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() != nullptr)
+        {
+            archiveData = static_cast<const char*> (mappedFile->getData());
+            archiveSize = mappedFile->getSize();
+        }
+    }
+
+    std::vector<Result> results ((size_t) entries.size(), Result::ok());
+    std::atomic<bool> anyFailed { false };
+
+    scheduler.parallelFor (0, (int) fileEntries.size(), [&] (int i)
+    {
+        if (anyFailed.load())
+            return;
+
+        auto index = fileEntries[(size_t) i];
+        auto result = uncompressEntry (index,
+                                       targetDirectory,
+                                       shouldOverwriteFiles ? OverwriteFiles::yes : OverwriteFiles::no,
+                                       FollowSymlinks::no,
+                                       archiveData,
+                                       archiveSize);
+
+        if (result.failed())
+        {
+            results[(size_t) index] = result;
+            anyFailed = true;
+        }
+    }, 1);
+
+    // Links are only created once all the files have been written, so nothing can be written through them
+    for (auto index : linkEntries)
+        if (! anyFailed.load())
+            results[(size_t) index] = uncompressEntry (index, targetDirectory, shouldOverwriteFiles);
+
+    for (auto& result : results)
+        if (result.failed())
+            return result;
+
+    return Result::ok();
+}
+
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     return uncompressEntry (index,
@@ -438,6 +555,12 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
 }
 
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, OverwriteFiles overwriteFiles, FollowSymlinks followSymlinks)
+{
+    return uncompressEntry (index, targetDirectory, overwriteFiles, followSymlinks, sourceData, sourceDataSize);
+}
+
+Result ZipFile::uncompressEntry (int index, const File& targetDirectory, OverwriteFiles overwriteFiles, FollowSymlinks followSymlinks,
+                                 const char* archiveData, size_t archiveSize)
 {
     auto* zei = entries.getUnchecked (index);
 
@@ -458,9 +581,13 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
     if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
-    std::unique_ptr<InputStream> in (createStreamForEntry (index));
+    // When the whole zip file is in memory, files are inflated straight from it
+    std::unique_ptr<InputStream> in;
+
+    if (archiveData == nullptr || zei->entry.isSymbolicLink)
+        in.reset (createStreamForEntry (index));
 
-    if (in == nullptr)
+    if (in == nullptr && getEntryData (*zei, archiveData, archiveSize) == nullptr)
         return Result::fail ("Failed to open the zip file for reading");
 
     if (targetFile.exists())
@@ -493,7 +620,24 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
         if (out.failedToOpen())
             return Result::fail ("Failed to write to target file: " + targetFile.getFullPathName());
 
-        out << *in;
+        if (in != nullptr)
+        {
+            // A short read means that the archive has changed since it was opened
+            if (out.writeFromInputStream (*in, -1) != zei->entry.uncompressedSize)
+                return Result::fail ("Failed to read " + zei->entry.filename);
+        }
+        else
+        {
+            auto result = writeEntryData (*zei, archiveData, archiveSize, out);
+
+            if (result.failed())
+                return result;
+
+            out.flush();
+
+            if (out.getStatus().failed())
+                return Result::fail ("Failed to write to target file: " + targetFile.getFullPathName());
+        }
     }
 
     targetFile.setCreationTime (zei->entry.fileTime);
@@ -503,6 +647,87 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
     return Result::ok();
 }
 
+const char* ZipFile::getEntryData (const ZipEntryHolder& zei, const char* archiveData, size_t archiveSize) noexcept
+{
+    if (archiveData == nullptr
+         || zei.streamOffset < 0
+         || (uint64) zei.streamOffset + 30 > (uint64) archiveSize)
+        return nullptr;
+
+    auto* header = archiveData + zei.streamOffset;
+
+    if (readUnalignedLittleEndianInt (header) != 0x04034b50)
+        return nullptr;
+
+    auto dataStart = (uint64) zei.streamOffset + 30
+                       + readUnalignedLittleEndianShort (header + 26)
+                       + readUnalignedLittleEndianShort (header + 28);
+
+    if (zei.compressedSize < 0 || dataStart + (uint64) zei.compressedSize > (uint64) archiveSize)
+        return nullptr;
+
+    return archiveData + dataStart;
+}
+
+Result ZipFile::writeEntryData (const ZipEntryHolder& zei, const char* archiveData, size_t archiveSize, OutputStream& out)
+{
+    auto* data = getEntryData (zei, archiveData, archiveSize);
+
+    if (data == nullptr)
+        return Result::fail ("Failed to open the zip file for reading");
+
+    if (! zei.isCompressed)
+    {
+        if (! out.write (data, (size_t) zei.compressedSize))
+            return Result::fail ("Failed to write " + zei.entry.filename);
+
+        return Result::ok();
+    }
+
+    using namespace zlibNamespace;
+
+    z_stream stream;
+    zerostruct (stream);
+
+    if (inflateInit2 (&stream, -MAX_WBITS) != Z_OK)
+        return Result::fail ("Failed to uncompress " + zei.entry.filename);
+
+    const auto bufferSize = (size_t) jlimit ((int64) 4096, (int64) 262144, zei.entry.uncompressedSize);
+    HeapBlock<Bytef> buffer (bufferSize);
+
+    stream.next_in  = reinterpret_cast<Bytef*> (const_cast<char*> (data));
+    stream.avail_in = (uInt) zei.compressedSize;
+
+    auto result = Result::ok();
+
+    for (;;)
+    {
+        stream.next_out  = buffer;
+        stream.avail_out = (uInt) bufferSize;
+
+        auto status = inflate (&stream, Z_NO_FLUSH);
+        auto numBytes = bufferSize - stream.avail_out;
+
+        if (numBytes > 0 && ! out.write (buffer, numBytes))
+        {
+            result = Result::fail ("Failed to write " + zei.entry.filename);
+            break;
+        }
+
+        if (status == Z_STREAM_END)
+            break;
+
+        if (status != Z_OK || (stream.avail_in == 0 && numBytes == 0))
+        {
+            result = Result::fail ("Failed to uncompress " + zei.entry.filename);
+            break;
+        }
+    }
+
+    inflateEnd (&stream);
+    return result;
+}
+
 
 //==============================================================================
 struct ZipFile::Builder::Item
@@ -513,7 +738,7 @@ struct ZipFile::Builder::Item
         symbolicLink = (file.exists() && file.isSymbolicLink());
     }
 
-    bool writeData (OutputStream& target, const int64 overallStartPosition)
+    bool writeData (OutputStream& target, const int64 overallStartPosition, WorkStealingScheduler* scheduler)
     {
         MemoryOutputStream compressedData ((size_t) file.getSize());
 
@@ -526,6 +751,13 @@ struct ZipFile::Builder::Item
             checksum = zlibNamespace::crc32 (0, (uint8_t*) relativePath.toRawUTF8(), (unsigned int) uncompressedSize);
             compressedData << relativePath;
         }
+        else if (compressionLevel > 0 && scheduler != nullptr)
+        {
+            ParallelGZIPCompressorOutputStream compressor (compressedData, *scheduler, compressionLevel,
+                                                           GZIPCompressorOutputStream::windowBitsRaw);
+            if (! writeSource (compressor))
+                return false;
+        }
         else if (compressionLevel > 0)
         {
             GZIPCompressorOutputStream compressor (compressedData, compressionLevel,
@@ -647,6 +879,16 @@ void ZipFile::Builder::addEntry (InputStream* stream, int compression, const Str
 }
 
 bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress) const
+{
+    return writeToStream (target, progress, nullptr);
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, WorkStealingScheduler& scheduler) const
+{
+    return writeToStream (target, progress, &scheduler);
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, WorkStealingScheduler* scheduler) const
 {
     auto fileStart = target.getPosition();
 
@@ -655,7 +897,7 @@ bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progre
         if (progress != nullptr)
             *progress = (i + 0.5) / items.size();
 
-        if (! items.getUnchecked (i)->writeData (target, fileStart))
+        if (! items.getUnchecked (i)->writeData (target, fileStart, scheduler))
             return false;
     }
 
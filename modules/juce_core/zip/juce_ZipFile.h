@@ -47,6 +47,10 @@ namespace juce
     This can enumerate the items in a ZIP file and can create suitable stream objects
     to read each one.
 
+    A ZipFile that's created from a MemoryInputStream uses its data directly, so the entries
+    can be read on any number of threads at once without sharing a stream or taking a lock.
+    One that's created from a File or an InputSource opens a new stream for each entry.
+
     @tags{Core}
 */
 class JUCE_API  ZipFile
@@ -149,7 +153,8 @@ public:
         Note that if the ZipFile was created with a user-supplied InputStream object,
         then all the streams which are created by this method will by trying to share
         the same source stream, so cannot be safely used on  multiple threads! (But if
-        you create the ZipFile from a File or InputSource, then it is safe to do this).
+        you create the ZipFile from a File, InputSource or MemoryInputStream, then it is
+        safe to do this).
     */
     InputStream* createStreamForEntry (int index);
 
@@ -164,7 +169,8 @@ public:
         Note that if the ZipFile was created with a user-supplied InputStream object,
         then all the streams which are created by this method will by trying to share
         the same source stream, so cannot be safely used on  multiple threads! (But if
-        you create the ZipFile from a File or InputSource, then it is safe to do this).
+        you create the ZipFile from a File, InputSource or MemoryInputStream, then it is
+        safe to do this).
     */
     InputStream* createStreamForEntry (const ZipEntry& entry);
 
@@ -181,6 +187,29 @@ public:
     Result uncompressTo (const File& targetDirectory,
                          bool shouldOverwriteFiles = true);
 
+    /** Uncompresses all of the files in the zip file, using the worker threads of a
+        scheduler to expand several entries at once.
+
+        The folders are all created first, then the files are written in parallel, starting
+        with the largest ones, and any symbolic links are created last, once all the files
+        have been written. If any entries fail, this returns the error for the first of them.
+
+        This is only faster than uncompressTo() if the ZipFile was created from a File,
+        InputSource or MemoryInputStream, because other kinds of stream have to be shared
+        between the threads.
+
+        If the ZipFile was created from a File, the file is memory-mapped while this runs,
+        and it mustn't be changed or truncated by anything else until this returns.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param shouldOverwriteFiles whether to overwrite existing files with similarly-named ones
+        @param scheduler            the scheduler whose threads will uncompress the entries
+        @returns success if the file is successfully unzipped
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         bool shouldOverwriteFiles,
+                         WorkStealingScheduler& scheduler);
+
     /** Uncompresses one of the entries from the zip file.
 
         This will expand the entry and write it in a target directory. The entry's path is used to
@@ -263,9 +292,20 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, writing it to the specified stream.
+
+            This compresses each file in blocks on the worker threads of a scheduler, using a
+            ParallelGZIPCompressorOutputStream, so large files are packed much more quickly.
+            If the progress parameter is non-null, it will be updated with an approximate
+            progress status between 0 and 1.0
+        */
+        bool writeToStream (OutputStream& target, double* progress, WorkStealingScheduler& scheduler) const;
+
         //==============================================================================
     private:
         struct Item;
+
+        bool writeToStream (OutputStream&, double*, WorkStealingScheduler*) const;
         OwnedArray<Item> items;
 
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Builder)
@@ -281,6 +321,9 @@ private:
     InputStream* inputStream = nullptr;
     std::unique_ptr<InputStream> streamToDelete;
     std::unique_ptr<InputSource> inputSource;
+    File archiveFile;
+    const char* sourceData = nullptr;
+    size_t sourceDataSize = 0;
 
    #if JUCE_DEBUG
     struct OpenStreamCounter
@@ -295,6 +338,9 @@ private:
    #endif
 
     void init();
+    Result uncompressEntry (int, const File&, OverwriteFiles, FollowSymlinks, const char* archiveData, size_t archiveSize);
+    static const char* getEntryData (const ZipEntryHolder&, const char* archiveData, size_t archiveSize) noexcept;
+    static Result writeEntryData (const ZipEntryHolder&, const char* archiveData, size_t archiveSize, OutputStream&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class ZstdCompressorOutputStream::ZstdCompressorHelper
+{
+public:
+    ZstdCompressorHelper (int compressionLevel)
+        : context (ZSTD_createCCtx()),
+          bufferSize (ZSTD_CStreamOutSize())
+    {
+        if (compressionLevel < 1 || compressionLevel > ZSTD_maxCLevel())
+            compressionLevel = ZSTD_CLEVEL_DEFAULT;
+
+        buffer.malloc (bufferSize);
+
+        ZSTD_CCtx_setParameter (context, ZSTD_c_compressionLevel, compressionLevel);
+        ZSTD_CCtx_setParameter (context, ZSTD_c_checksumFlag, 1);
+    }
+
+    ~ZstdCompressorHelper()
+    {
+        ZSTD_freeCCtx (context);
+    }
+
+    void setDictionary (const void* data, size_t dataSize)
+    {
+        // The dictionary has to be set before anything is written!
+        jassert (! started);
+
+        if (ZSTD_isError (ZSTD_CCtx_loadDictionary (context, data, dataSize)))
+            error = true;
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on a zstd stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        if (finished || error)
+            return false;
+
+        started = true;
+        ZSTD_inBuffer input { data, dataSize, 0 };
+
+        while (input.pos < input.size)
+            if (! compress (input, ZSTD_e_continue, out))
+                return false;
+
+        return true;
+    }
+
+    void finish (OutputStream& out)
+    {
+        if (finished || error)
+            return;
+
+        finished = true;
+        ZSTD_inBuffer input { nullptr, 0, 0 };
+
+        // The frame is only complete once zstd has nothing left to write
+        while (compress (input, ZSTD_e_end, out) && numBytesLeftToFlush > 0)
+        {
+        }
+    }
+
+private:
+    bool compress (ZSTD_inBuffer& input, ZSTD_EndDirective mode, OutputStream& out)
+    {
+        ZSTD_outBuffer output { buffer.getData(), bufferSize, 0 };
+        numBytesLeftToFlush = ZSTD_compressStream2 (context, &output, &input, mode);
+
+        if (ZSTD_isError (numBytesLeftToFlush) || (output.pos > 0 && ! out.write (buffer, output.pos)))
+        {
+            error = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    ZSTD_CCtx* const context;
+    const size_t bufferSize;
+    HeapBlock<char> buffer;
+    size_t numBytesLeftToFlush = 0;
+    bool started = false, finished = false, error = false;
+
+    JUCE_DECLARE_NON_COPYABLE (ZstdCompressorHelper)
+};
+
+//==============================================================================
+ZstdCompressorOutputStream::ZstdCompressorOutputStream (OutputStream& s, int compressionLevel)
+   : ZstdCompressorOutputStream (&s, compressionLevel, false)
+{
+}
+
+ZstdCompressorOutputStream::ZstdCompressorOutputStream (OutputStream* out, int compressionLevel, bool deleteDestStream)
+   : destStream (out, deleteDestStream),
+     helper (new ZstdCompressorHelper (compressionLevel))
+{
+    jassert (out != nullptr);
+}
+
+ZstdCompressorOutputStream::~ZstdCompressorOutputStream()
+{
+    flush();
+}
+
+void ZstdCompressorOutputStream::setDictionary (const void* dictionaryData, size_t dictionarySize)
+{
+    jassert (dictionaryData != nullptr || dictionarySize == 0);
+
+    helper->setDictionary (dictionaryData, dictionarySize);
+}
+
+MemoryBlock ZstdCompressorOutputStream::trainDictionary (const Array<MemoryBlock>& samples, size_t maxDictionarySize)
+{
+    MemoryBlock allSamples;
+    std::vector<size_t> sampleSizes;
+    sampleSizes.reserve ((size_t) samples.size());
+
+    for (auto& sample : samples)
+    {
+        allSamples.append (sample.getData(), sample.getSize());
+        sampleSizes.push_back (sample.getSize());
+    }
+
+    MemoryBlock dictionary (maxDictionarySize);
+    auto dictionarySize = ZDICT_trainFromBuffer (dictionary.getData(), dictionary.getSize(),
+                                                 allSamples.getData(), sampleSizes.data(), (unsigned) sampleSizes.size());
+
+    if (ZDICT_isError (dictionarySize))
+        return {};
+
+    dictionary.setSize (dictionarySize);
+    return dictionary;
+}
+
+void ZstdCompressorOutputStream::flush()
+{
+    helper->finish (*destStream);
+    destStream->flush();
+}
+
+bool ZstdCompressorOutputStream::write (const void* destBuffer, size_t howMany)
+{
+    jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
+
+    return helper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
+}
+
+int64 ZstdCompressorOutputStream::getPosition()
+{
+    return destStream->getPosition();
+}
+
+bool ZstdCompressorOutputStream::setPosition (int64 /*newPosition*/)
+{
+    jassertfalse; // can't do it!
+    return false;
+}
+
+} // namespace juce
@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A stream which compresses the data written into it using Zstandard.
+
+    Zstandard compresses better than zlib at every speed, and decompresses several times
+    faster, which makes it a good choice for data like presets that is written once and
+    read many times. Its higher levels are slow, but get close to the ratio of much
+    slower formats.
+
+    The output is a standard Zstandard frame with a checksum of the content, which can
+    also be read by the zstd command line tool and library.
+
+    Important note: When you call flush() on a ZstdCompressorOutputStream, the frame is
+    closed - this means that no more data can be written to it, and any subsequent attempts
+    to call write() will cause an assertion.
+
+    @see ZstdDecompressorInputStream, LZ4CompressorOutputStream, GZIPCompressorOutputStream
+
+    @tags{Core}
+*/
+class JUCE_API  ZstdCompressorOutputStream  : public OutputStream
+{
+public:
+    //==============================================================================
+    /** Creates a compression stream.
+        @param destStream                       the stream into which the compressed data will be written
+        @param compressionLevel                 how much to compress the data, between 1 and 22, where
+                                                1 is the fastest/lowest compression, and 22 is the
+                                                slowest/highest compression. Any value outside this range
+                                                indicates that the default level, 3, should be used.
+    */
+    ZstdCompressorOutputStream (OutputStream& destStream,
+                                int compressionLevel = -1);
+
+    /** Creates a compression stream.
+        @param destStream                       the stream into which the compressed data will be written.
+                                                Ownership of this object depends on the value of deleteDestStreamWhenDestroyed
+        @param compressionLevel                 how much to compress the data, between 1 and 22, where
+                                                1 is the fastest/lowest compression, and 22 is the
+                                                slowest/highest compression. Any value outside this range
+                                                indicates that the default level, 3, should be used.
+        @param deleteDestStreamWhenDestroyed    whether or not the ZstdCompressorOutputStream will delete the
+                                                destStream object when it is destroyed
+    */
+    ZstdCompressorOutputStream (OutputStream* destStream,
+                                int compressionLevel = -1,
+                                bool deleteDestStreamWhenDestroyed = false);
+
+    /** Destructor. */
+    ~ZstdCompressorOutputStream() override;
+
+    //==============================================================================
+    /** Sets a dictionary of data that's likely to appear in the stream.
+
+        Small pieces of data compress much better when the compressor can refer back to
+        similar data that the decompressor already has. This can be any data, or a
+        dictionary made by trainDictionary(), and the same dictionary has to be given to
+        the ZstdDecompressorInputStream.
+
+        This must be called before anything is written to the stream.
+    */
+    void setDictionary (const void* dictionaryData, size_t dictionarySize);
+
+    /** Builds a dictionary from some samples of the kind of data that will be compressed.
+
+        A trained dictionary usually works much better than a piece of sample data, and
+        carries an ID that's written into each frame, so that a decompressor given the
+        wrong dictionary can tell. A few hundred samples are needed for good results.
+
+        @param samples                  the samples to learn from
+        @param maxDictionarySize        the largest that the dictionary may be
+        @returns the dictionary, or an empty block if there wasn't enough data to build one
+    */
+    static MemoryBlock trainDictionary (const Array<MemoryBlock>& samples,
+                                        size_t maxDictionarySize = 112640);
+
+    //==============================================================================
+    /** Flushes and closes the stream.
+        Note that unlike most streams, when you call flush() on a ZstdCompressorOutputStream,
+        the stream is closed - this means that no more data can be written to it, and any
+        subsequent attempts to call write() will cause an assertion.
+    */
+    void flush() override;
+
+    int64 getPosition() override;
+    bool setPosition (int64) override;
+    bool write (const void*, size_t) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<OutputStream> destStream;
+
+    class ZstdCompressorHelper;
+    std::unique_ptr<ZstdCompressorHelper> helper;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZstdCompressorOutputStream)
+};
+
+} // namespace juce
@@ -0,0 +1,218 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class ZstdDecompressorInputStream::ZstdDecompressHelper
+{
+public:
+    ZstdDecompressHelper (InputStream& in)
+        : source (in),
+          context (ZSTD_createDCtx()),
+          bufferSize (ZSTD_DStreamInSize())
+    {
+        buffer.malloc (bufferSize);
+    }
+
+    ~ZstdDecompressHelper()
+    {
+        ZSTD_freeDCtx (context);
+    }
+
+    void setDictionary (const void* data, size_t dataSize)
+    {
+        if (ZSTD_isError (ZSTD_DCtx_loadDictionary (context, data, dataSize)))
+            error = true;
+    }
+
+    /** Goes back to the start of the data, keeping the dictionary. */
+    void reset()
+    {
+        ZSTD_DCtx_reset (context, ZSTD_reset_session_only);
+        input = { buffer.getData(), 0, 0 };
+        atEndOfFrame = true;
+        finished = error = false;
+    }
+
+    size_t read (uint8* dest, size_t numBytes)
+    {
+        ZSTD_outBuffer output { dest, numBytes, 0 };
+
+        while (output.pos < output.size && ! (finished || error))
+        {
+            const auto inputStart = input.pos;
+            const auto outputStart = output.pos;
+            const auto result = ZSTD_decompressStream (context, &output, &input);
+
+            if (ZSTD_isError (result))
+            {
+                error = true;
+                break;
+            }
+
+            if (input.pos != inputStart || output.pos != outputStart)
+            {
+                atEndOfFrame = (result == 0);
+                continue;
+            }
+
+            // Nothing more can be decoded from what has been read so far
+            if (! fillBuffer())
+            {
+                // The data stopped in the middle of a frame
+                error = ! atEndOfFrame;
+                finished = true;
+            }
+        }
+
+        return output.pos;
+    }
+
+    bool isExhausted() const noexcept   { return finished || error; }
+
+    int64 contentSize = -1;
+
+private:
+    bool fillBuffer()
+    {
+        const auto numRead = source.read (buffer, (int) bufferSize);
+
+        if (numRead <= 0)
+            return false;
+
+        // Each frame may say how big it is, if its size was known when it was written, but
+        // any number of frames can follow it. So the total is only known if all of the data
+        // arrived in the first read, and every frame in it has a size.
+        if (isFirstRead)
+        {
+            if (source.isExhausted())
+                contentSize = getTotalContentSize (buffer, (size_t) numRead);
+
+            isFirstRead = false;
+        }
+
+        input = { buffer.getData(), (size_t) numRead, 0 };
+        return true;
+    }
+
+    /** Adds up the sizes of all the frames in a block of data, or returns -1 if any of them
+        doesn't have one, or the data doesn't end with a whole frame.
+    */
+    static int64 getTotalContentSize (const char* data, size_t numBytes)
+    {
+        int64 total = 0;
+
+        while (numBytes > 0)
+        {
+            // (a skippable frame's size is zero)
+            const auto frameSize = ZSTD_getFrameContentSize (data, numBytes);
+            const auto numCompressedBytes = ZSTD_findFrameCompressedSize (data, numBytes);
+
+            if (frameSize == ZSTD_CONTENTSIZE_UNKNOWN || frameSize == ZSTD_CONTENTSIZE_ERROR
+                 || ZSTD_isError (numCompressedBytes))
+                return -1;
+
+            total += (int64) frameSize;
+            data += numCompressedBytes;
+            numBytes -= numCompressedBytes;
+        }
+
+        return total;
+    }
+
+    InputStream& source;
+    ZSTD_DCtx* const context;
+    const size_t bufferSize;
+    HeapBlock<char> buffer;
+    ZSTD_inBuffer input { nullptr, 0, 0 };
+    bool isFirstRead = true, atEndOfFrame = true, finished = false, error = false;
+
+    JUCE_DECLARE_NON_COPYABLE (ZstdDecompressHelper)
+};
+
+//==============================================================================
+ZstdDecompressorInputStream::ZstdDecompressorInputStream (InputStream* source, bool deleteSourceWhenDestroyed,
+                                                          int64 uncompressedLength)
+  : sourceStream (source, deleteSourceWhenDestroyed),
+    uncompressedStreamLength (uncompressedLength),
+    originalSourcePos (source->getPosition()),
+    helper (new ZstdDecompressHelper (*source))
+{
+}
+
+ZstdDecompressorInputStream::ZstdDecompressorInputStream (InputStream& source)
+  : ZstdDecompressorInputStream (&source, false)
+{
+}
+
+ZstdDecompressorInputStream::~ZstdDecompressorInputStream()
+{
+}
+
+void ZstdDecompressorInputStream::setDictionary (const void* dictionaryData, size_t dictionarySize)
+{
+    // The dictionary has to be set before anything is read!
+    jassert (currentPos == 0);
+    jassert (dictionaryData != nullptr || dictionarySize == 0);
+
+    helper->setDictionary (dictionaryData, dictionarySize);
+}
+
+int64 ZstdDecompressorInputStream::getTotalLength()
+{
+    return uncompressedStreamLength >= 0 ? uncompressedStreamLength : helper->contentSize;
+}
+
+int ZstdDecompressorInputStream::read (void* destBuffer, int howMany)
+{
+    jassert (destBuffer != nullptr && howMany >= 0);
+
+    auto numRead = (int) helper->read (static_cast<uint8*> (destBuffer), (size_t) howMany);
+    currentPos += numRead;
+    return numRead;
+}
+
+bool ZstdDecompressorInputStream::isExhausted()
+{
+    return helper->isExhausted();
+}
+
+int64 ZstdDecompressorInputStream::getPosition()
+{
+    return currentPos;
+}
+
+bool ZstdDecompressorInputStream::setPosition (int64 newPos)
+{
+    if (newPos < currentPos)
+    {
+        // to go backwards, reset the stream and start again..
+        currentPos = 0;
+        helper->reset();
+        sourceStream->setPosition (originalSourcePos);
+    }
+
+    skipNextBytes (newPos - currentPos);
+    return true;
+}
+
+} // namespace juce
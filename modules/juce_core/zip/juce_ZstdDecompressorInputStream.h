@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    This stream will decompress a source-stream that holds data in the Zstandard format.
+
+    It can read any Zstandard data, including that written by the zstd command line tool
+    and library. Several frames one after another are read as one stream, and skippable
+    frames are ignored. Content checksums are verified, and a mismatch ends the stream.
+
+    If the data was compressed with a dictionary, the same dictionary must be passed to
+    setDictionary() before anything is read.
+
+    Unless a length is passed to the constructor, getTotalLength() only knows the size once
+    something has been read, and only if all of the compressed data arrived in the first
+    read and each of its frames recorded its size. Otherwise it returns -1.
+
+    @see ZstdCompressorOutputStream, CompressionFormat
+
+    @tags{Core}
+*/
+class JUCE_API  ZstdDecompressorInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a decompressor stream.
+
+        @param sourceStream                 the stream to read from
+        @param deleteSourceWhenDestroyed    whether or not to delete the source stream
+                                            when this object is destroyed
+        @param uncompressedStreamLength     if the creator knows the length that the
+                                            uncompressed stream will be, then it can supply this
+                                            value, which will be returned by getTotalLength()
+    */
+    ZstdDecompressorInputStream (InputStream* sourceStream,
+                                 bool deleteSourceWhenDestroyed,
+                                 int64 uncompressedStreamLength = -1);
+
+    /** Creates a decompressor stream.
+
+        @param sourceStream     the stream to read from - the source stream must not be
+                                deleted until this object has been destroyed
+    */
+    ZstdDecompressorInputStream (InputStream& sourceStream);
+
+    /** Destructor. */
+    ~ZstdDecompressorInputStream() override;
+
+    //==============================================================================
+    /** Sets the dictionary that the data was compressed with.
+        This must be called before anything is read from the stream.
+    */
+    void setDictionary (const void* dictionaryData, size_t dictionarySize);
+
+    //==============================================================================
+    int64 getPosition() override;
+    bool setPosition (int64 pos) override;
+    int64 getTotalLength() override;
+    bool isExhausted() override;
+    int read (void* destBuffer, int maxBytesToRead) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<InputStream> sourceStream;
+    const int64 uncompressedStreamLength;
+    int64 originalSourcePos, currentPos = 0;
+
+    class ZstdDecompressHelper;
+    std::unique_ptr<ZstdDecompressHelper> helper;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZstdDecompressorInputStream)
+};
+
+} // namespace juce
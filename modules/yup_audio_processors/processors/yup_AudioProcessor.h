@@ -42,6 +42,13 @@ public:
 
     virtual void flush() {}
 
+    /** Returns the delay, in samples, that the processor adds to the audio passing through it.
+
+        AudioProcessorGraph uses this to line up signals that reach a node along paths with
+        different latencies.
+    */
+    virtual int getLatencySamples() const { return 0; }
+
     virtual bool hasEditor() const = 0;
     virtual AudioProcessorEditor* createEditor() { return nullptr; }
 };
@@ -0,0 +1,1110 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace yup
+{
+
+//==============================================================================
+struct AudioProcessorGraph::Node : public ReferenceCountedObject
+{
+    Node (NodeID id, std::unique_ptr<AudioProcessor> p)
+        : nodeID (id)
+        , processor (std::move (p))
+    {
+    }
+
+    ~Node() override
+    {
+        if (isPrepared)
+            processor->releaseResources();
+    }
+
+    const NodeID nodeID;
+    const std::unique_ptr<AudioProcessor> processor;
+    bool isPrepared = false;
+
+    JUCE_DECLARE_NON_COPYABLE (Node)
+};
+
+//==============================================================================
+class AudioProcessorGraph::DelayLine : public ReferenceCountedObject
+{
+public:
+    explicit DelayLine (int numSamples)
+        : length (numSamples)
+    {
+        buffer.calloc ((size_t) numSamples);
+    }
+
+    int getLength() const noexcept { return length; }
+
+    void addDelayed (float* dest, const float* source, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] += buffer[position];
+            buffer[position] = source[i];
+
+            if (++position == length)
+                position = 0;
+        }
+    }
+
+private:
+    HeapBlock<float> buffer;
+    const int length;
+    int position = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (DelayLine)
+};
+
+/*  Holds back the MIDI of a connection for latency compensation. The events waiting to come
+    out are kept sorted, with their times relative to the start of the next block.
+*/
+class AudioProcessorGraph::MidiDelayLine : public ReferenceCountedObject
+{
+public:
+    MidiDelayLine (int numSamples, size_t capacity)
+        : length (numSamples)
+    {
+        pending.setFixedCapacity (capacity);
+        spare.setFixedCapacity (capacity);
+    }
+
+    int getLength() const noexcept { return length; }
+    size_t getCapacity() const noexcept { return pending.getFixedCapacity(); }
+
+    void addDelayed (MidiBuffer& dest, const MidiBuffer& source, int numSamples) noexcept
+    {
+        pending.addEvents (source, 0, numSamples, length);
+        spare.clear();
+
+        for (const auto metadata : pending)
+        {
+            if (metadata.samplePosition < numSamples)
+                dest.addEvent (metadata.data, metadata.numBytes, metadata.samplePosition);
+            else
+                spare.addEvent (metadata.data, metadata.numBytes, metadata.samplePosition - numSamples);
+        }
+
+        pending.swapWith (spare);
+    }
+
+private:
+    MidiBuffer pending, spare;
+    const int length;
+
+    JUCE_DECLARE_NON_COPYABLE (MidiDelayLine)
+};
+
+namespace
+{
+// Finds the delay line a connection had in the previous sequence, if it's still the right length
+template <typename DelayLineType>
+ReferenceCountedObjectPtr<DelayLineType> findDelayLine (const std::vector<std::pair<AudioProcessorGraph::Connection,
+                                                                                    ReferenceCountedObjectPtr<DelayLineType>>>& delayLines,
+                                                        const AudioProcessorGraph::Connection& connection,
+                                                        int length)
+{
+    for (const auto& [c, delayLine] : delayLines)
+        if (c == connection && delayLine->getLength() == length)
+            return delayLine;
+
+    return {};
+}
+} // namespace
+
+//==============================================================================
+/*  A fixed-size Chase-Lev deque of node indices. The thread that owns it pushes and pops
+    at the bottom, and other threads steal from the top. It never needs to grow, because
+    each node is pushed once per block, and the audio thread resets it between blocks.
+*/
+class AudioProcessorGraph::WorkQueue
+{
+public:
+    explicit WorkQueue (int capacity)
+        : mask ((int64) nextPowerOfTwo (jmax (1, capacity)) - 1)
+        , items (new std::atomic<int>[(size_t) (mask + 1)])
+    {
+    }
+
+    void reset() noexcept
+    {
+        top.store (0);
+        bottom.store (0);
+    }
+
+    void push (int item) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        items[(size_t) (b & mask)].store (item, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+    }
+
+    bool pop (int& item) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = items[(size_t) (b & mask)].load (std::memory_order_relaxed);
+
+        if (t < b)
+            return true;
+
+        // This was the last item, so race any thieves for it
+        const auto won = top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store (b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return top.load() >= bottom.load();
+    }
+
+    bool steal (int& item) noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        item = items[(size_t) (t & mask)].load (std::memory_order_relaxed);
+        return top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+private:
+    const int64 mask;
+    std::unique_ptr<std::atomic<int>[]> items;
+    std::atomic<int64> top { 0 }, bottom { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (WorkQueue)
+};
+
+//==============================================================================
+struct AudioProcessorGraph::RenderNode
+{
+    struct AudioInput
+    {
+        int source, sourceChannel, destChannel;
+        DelayLine* delay;
+    };
+
+    struct MidiInput
+    {
+        int source;
+        MidiDelayLine* delay;
+    };
+
+    ReferenceCountedObjectPtr<Node> node;
+    AudioProcessor* processor = nullptr;
+
+    AudioSampleBuffer buffer;
+    MidiBuffer midi;
+
+    Array<AudioInput> audioInputs;
+    Array<MidiInput> midiInputs;
+    Array<int> successors;
+    int numPredecessors = 0;
+    std::atomic<int> numPendingInputs { 0 };
+};
+
+struct AudioProcessorGraph::RenderSequence : public ReferenceCountedObject
+{
+    OwnedArray<RenderNode> renderNodes;
+    std::vector<std::pair<Connection, ReferenceCountedObjectPtr<DelayLine>>> delayLines;
+    std::vector<std::pair<Connection, ReferenceCountedObjectPtr<MidiDelayLine>>> midiDelayLines;
+    OwnedArray<WorkQueue> queues;
+    int inputIndex = -1, outputIndex = -1;
+    int maxBlockSize = 0, latencySamples = 0;
+    uint32 preparation = 0;
+    std::atomic<int> numNodesDone { 0 };
+};
+
+//==============================================================================
+class AudioProcessorGraph::Worker : public Thread
+{
+public:
+    Worker (AudioProcessorGraph& o, int index)
+        : Thread ("Graph worker " + String (index))
+        , owner (o)
+        , queueIndex (index + 1)
+    {
+    }
+
+    ~Worker() override
+    {
+        stopThread (1000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (! owner.workAvailable.wait (100))
+                continue;
+
+            // The audio thread waits for the busy count to drop to zero before it finishes a
+            // block, so a sequence that's seen here can't be released while it's in use
+            owner.numBusyWorkers.fetch_add (1);
+
+            if (auto* sequence = owner.activeSequence.load())
+                if (queueIndex < sequence->queues.size())
+                    owner.runRenderJobs (*sequence, queueIndex);
+
+            if (owner.numBusyWorkers.fetch_sub (1) == 1 && owner.isWaitingForWorkers.exchange (false))
+                owner.workersFinished.signal();
+        }
+    }
+
+private:
+    AudioProcessorGraph& owner;
+    const int queueIndex;
+};
+
+class AudioProcessorGraph::Collector : public Thread
+{
+public:
+    explicit Collector (AudioProcessorGraph& o)
+        : Thread ("Graph garbage collector")
+        , owner (o)
+    {
+        startThread (Priority::low);
+    }
+
+    ~Collector() override
+    {
+        signalThreadShouldExit();
+        notify();
+        stopThread (2000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (50);
+            owner.collectGarbage (false);
+        }
+    }
+
+private:
+    AudioProcessorGraph& owner;
+};
+
+//==============================================================================
+AudioProcessorGraph::AudioProcessorGraph()
+{
+    rebuild();
+    collector = std::make_unique<Collector> (*this);
+}
+
+AudioProcessorGraph::~AudioProcessorGraph()
+{
+    collector.reset();
+    stopWorkers();
+
+    {
+        const ScopedLock sl (editLock);
+        nodes.clear();
+        connections.clear();
+    }
+
+    rebuild();
+    collectGarbage (true);
+}
+
+//==============================================================================
+void AudioProcessorGraph::setNumChannels (int newNumInputChannels, int newNumOutputChannels)
+{
+    {
+        const ScopedLock sl (editLock);
+
+        numInputChannels = jmax (0, newNumInputChannels);
+        numOutputChannels = jmax (0, newNumOutputChannels);
+        removeInvalidConnectionsLocked();
+    }
+
+    rebuild();
+}
+
+int AudioProcessorGraph::getNumInputChannels() const noexcept
+{
+    const ScopedLock sl (editLock);
+    return numInputChannels;
+}
+
+int AudioProcessorGraph::getNumOutputChannels() const noexcept
+{
+    const ScopedLock sl (editLock);
+    return numOutputChannels;
+}
+
+//==============================================================================
+AudioProcessorGraph::NodeID AudioProcessorGraph::addNode (std::unique_ptr<AudioProcessor> processor)
+{
+    if (processor == nullptr)
+        return 0;
+
+    ReferenceCountedObjectPtr<Node> node;
+    float sampleRate;
+    int maxBlockSize;
+
+    {
+        const ScopedLock sl (editLock);
+
+        node = new Node (++lastNodeID, std::move (processor));
+        sampleRate = currentSampleRate;
+        maxBlockSize = currentMaxBlockSize;
+    }
+
+    if (sampleRate > 0.0f)
+    {
+        node->processor->prepareToPlay (sampleRate, maxBlockSize);
+        node->isPrepared = true;
+    }
+
+    {
+        const ScopedLock sl (editLock);
+        nodes.add (node);
+    }
+
+    rebuild();
+    return node->nodeID;
+}
+
+bool AudioProcessorGraph::removeNode (NodeID nodeID)
+{
+    {
+        const ScopedLock sl (editLock);
+
+        int index = -1;
+
+        for (int i = 0; i < nodes.size(); ++i)
+            if (nodes.getUnchecked (i)->nodeID == nodeID)
+                index = i;
+
+        if (index < 0)
+            return false;
+
+        nodes.remove (index);
+        removeInvalidConnectionsLocked();
+    }
+
+    rebuild();
+    return true;
+}
+
+AudioProcessor* AudioProcessorGraph::getProcessor (NodeID nodeID) const
+{
+    const ScopedLock sl (editLock);
+
+    for (auto* node : nodes)
+        if (node->nodeID == nodeID)
+            return node->processor.get();
+
+    return nullptr;
+}
+
+int AudioProcessorGraph::getNumNodes() const
+{
+    const ScopedLock sl (editLock);
+    return nodes.size();
+}
+
+void AudioProcessorGraph::clear()
+{
+    {
+        const ScopedLock sl (editLock);
+        nodes.clear();
+        connections.clear();
+    }
+
+    rebuild();
+}
+
+//==============================================================================
+int AudioProcessorGraph::getNumChannelsLocked (NodeID nodeID, bool isInput) const
+{
+    if (nodeID == audioInputNodeID)
+        return isInput ? 0 : numInputChannels;
+
+    if (nodeID == audioOutputNodeID)
+        return isInput ? numOutputChannels : 0;
+
+    for (auto* node : nodes)
+        if (node->nodeID == nodeID)
+            return isInput ? node->processor->getNumAudioInputs() : node->processor->getNumAudioOutputs();
+
+    return -1;
+}
+
+bool AudioProcessorGraph::isReachableLocked (NodeID source, NodeID dest) const
+{
+    if (source == dest)
+        return true;
+
+    Array<NodeID> toVisit { source }, visited;
+
+    while (! toVisit.isEmpty())
+    {
+        const auto current = toVisit.removeAndReturn (toVisit.size() - 1);
+
+        if (visited.contains (current))
+            continue;
+
+        visited.add (current);
+
+        for (const auto& c : connections)
+        {
+            if (c.sourceNode == current)
+            {
+                if (c.destNode == dest)
+                    return true;
+
+                toVisit.add (c.destNode);
+            }
+        }
+    }
+
+    return false;
+}
+
+bool AudioProcessorGraph::canConnectLocked (const Connection& c) const
+{
+    const auto numSourceChannels = getNumChannelsLocked (c.sourceNode, false);
+    const auto numDestChannels = getNumChannelsLocked (c.destNode, true);
+
+    if (numSourceChannels < 0 || numDestChannels < 0)
+        return false;
+
+    if (c.isMidi() != (c.destChannel == midiChannelIndex))
+        return false;
+
+    if (c.isMidi())
+    {
+        if (c.sourceNode == audioOutputNodeID || c.destNode == audioInputNodeID)
+            return false;
+    }
+    else if (! isPositiveAndBelow (c.sourceChannel, numSourceChannels)
+             || ! isPositiveAndBelow (c.destChannel, numDestChannels))
+    {
+        return false;
+    }
+
+    if (std::find (connections.begin(), connections.end(), c) != connections.end())
+        return false;
+
+    return ! isReachableLocked (c.destNode, c.sourceNode);
+}
+
+bool AudioProcessorGraph::canConnect (const Connection& c) const
+{
+    const ScopedLock sl (editLock);
+    return canConnectLocked (c);
+}
+
+bool AudioProcessorGraph::addConnection (const Connection& c)
+{
+    {
+        const ScopedLock sl (editLock);
+
+        if (! canConnectLocked (c))
+            return false;
+
+        connections.push_back (c);
+    }
+
+    rebuild();
+    return true;
+}
+
+bool AudioProcessorGraph::removeConnection (const Connection& c)
+{
+    {
+        const ScopedLock sl (editLock);
+
+        const auto iter = std::find (connections.begin(), connections.end(), c);
+
+        if (iter == connections.end())
+            return false;
+
+        connections.erase (iter);
+    }
+
+    rebuild();
+    return true;
+}
+
+bool AudioProcessorGraph::isConnected (const Connection& c) const
+{
+    const ScopedLock sl (editLock);
+    return std::find (connections.begin(), connections.end(), c) != connections.end();
+}
+
+std::vector<AudioProcessorGraph::Connection> AudioProcessorGraph::getConnections() const
+{
+    const ScopedLock sl (editLock);
+    return connections;
+}
+
+void AudioProcessorGraph::removeInvalidConnectionsLocked()
+{
+    connections.erase (std::remove_if (connections.begin(), connections.end(), [this] (const Connection& c)
+    {
+        const auto numSourceChannels = getNumChannelsLocked (c.sourceNode, false);
+        const auto numDestChannels = getNumChannelsLocked (c.destNode, true);
+
+        if (numSourceChannels < 0 || numDestChannels < 0)
+            return true;
+
+        return ! c.isMidi() && (c.sourceChannel >= numSourceChannels || c.destChannel >= numDestChannels);
+    }), connections.end());
+}
+
+int AudioProcessorGraph::getLatencySamples() const
+{
+    const ScopedLock sl (editLock);
+    return sequenceHolder != nullptr ? sequenceHolder->latencySamples : 0;
+}
+
+//==============================================================================
+void AudioProcessorGraph::rebuild()
+{
+    ReferenceCountedObjectPtr<RenderSequence> sequence (new RenderSequence());
+
+    {
+        const ScopedLock sl (editLock);
+
+        // The input and output nodes are the first two entries, followed by the processors
+        Array<NodeID> ids { audioInputNodeID, audioOutputNodeID };
+        Array<int> ownLatencies { 0, 0 }, numChannels { numInputChannels, numOutputChannels };
+
+        for (auto* node : nodes)
+        {
+            ids.add (node->nodeID);
+            ownLatencies.add (node->processor->getLatencySamples());
+            numChannels.add (jmax (node->processor->getNumAudioInputs(), node->processor->getNumAudioOutputs()));
+        }
+
+        const auto numVertices = ids.size();
+        std::vector<Array<int>> successors ((size_t) numVertices);
+        std::vector<int> numPredecessors ((size_t) numVertices, 0);
+
+        for (const auto& c : connections)
+        {
+            const auto source = ids.indexOf (c.sourceNode);
+            const auto dest = ids.indexOf (c.destNode);
+
+            if (successors[(size_t) source].addIfNotAlreadyThere (dest))
+                ++numPredecessors[(size_t) dest];
+        }
+
+        // Kahn's algorithm: the order in which the nodes become ready is a valid render order
+        Array<int> order;
+        std::vector<int> remaining (numPredecessors);
+
+        for (int i = 0; i < numVertices; ++i)
+            if (remaining[(size_t) i] == 0)
+                order.add (i);
+
+        for (int i = 0; i < order.size(); ++i)
+            for (auto s : successors[(size_t) order[i]])
+                if (--remaining[(size_t) s] == 0)
+                    order.add (s);
+
+        jassert (order.size() == numVertices); // canConnect() should have refused any cycles
+
+        std::vector<int> inputLatency ((size_t) numVertices, 0), outputLatency ((size_t) numVertices, 0);
+
+        for (auto v : order)
+        {
+            outputLatency[(size_t) v] = inputLatency[(size_t) v] + ownLatencies[v];
+
+            for (auto s : successors[(size_t) v])
+                inputLatency[(size_t) s] = jmax (inputLatency[(size_t) s], outputLatency[(size_t) v]);
+        }
+
+        Array<int> renderIndexOfVertex;
+        renderIndexOfVertex.insertMultiple (0, -1, numVertices);
+
+        for (int i = 0; i < order.size(); ++i)
+            renderIndexOfVertex.set (order[i], i);
+
+        for (auto v : order)
+        {
+            auto* renderNode = sequence->renderNodes.add (new RenderNode());
+
+            if (v >= 2)
+            {
+                renderNode->node = nodes.getUnchecked (v - 2);
+                renderNode->processor = renderNode->node->processor.get();
+            }
+
+            renderNode->buffer.setSize (numChannels[v], currentMaxBlockSize);
+            renderNode->midi.setFixedCapacity (midiBufferCapacity);
+            renderNode->numPredecessors = numPredecessors[(size_t) v];
+
+            for (auto s : successors[(size_t) v])
+                renderNode->successors.add (renderIndexOfVertex[s]);
+        }
+
+        // The delay lines are only carried over while the graph stays prepared in the same way,
+        // because they'd be holding audio from before it was last prepared
+        const auto* previous = sequenceHolder != nullptr && sequenceHolder->preparation == numPreparations
+                             ? sequenceHolder.get()
+                             : nullptr;
+
+        for (const auto& c : connections)
+        {
+            const auto source = ids.indexOf (c.sourceNode);
+            const auto dest = ids.indexOf (c.destNode);
+            const auto delay = inputLatency[(size_t) dest] - outputLatency[(size_t) source];
+            auto* renderNode = sequence->renderNodes.getUnchecked (renderIndexOfVertex[dest]);
+
+            if (c.isMidi())
+            {
+                ReferenceCountedObjectPtr<MidiDelayLine> delayLine;
+
+                if (delay > 0)
+                {
+                    if (previous != nullptr)
+                        delayLine = findDelayLine (previous->midiDelayLines, c, delay);
+
+                    if (delayLine == nullptr || delayLine->getCapacity() != midiBufferCapacity)
+                        delayLine = new MidiDelayLine (delay, midiBufferCapacity);
+
+                    sequence->midiDelayLines.push_back ({ c, delayLine });
+                }
+
+                renderNode->midiInputs.add ({ renderIndexOfVertex[source], delayLine.get() });
+                continue;
+            }
+
+            ReferenceCountedObjectPtr<DelayLine> delayLine;
+
+            if (delay > 0)
+            {
+                if (previous != nullptr)
+                    delayLine = findDelayLine (previous->delayLines, c, delay);
+
+                if (delayLine == nullptr)
+                    delayLine = new DelayLine (delay);
+
+                sequence->delayLines.push_back ({ c, delayLine });
+            }
+
+            renderNode->audioInputs.add ({ renderIndexOfVertex[source], c.sourceChannel, c.destChannel, delayLine.get() });
+        }
+
+        sequence->inputIndex = renderIndexOfVertex[0];
+        sequence->outputIndex = renderIndexOfVertex[1];
+        sequence->maxBlockSize = currentMaxBlockSize;
+        sequence->latencySamples = inputLatency[1];
+        sequence->preparation = numPreparations;
+
+        for (int i = 0; i <= workers.size(); ++i)
+            sequence->queues.add (new WorkQueue (numVertices));
+    }
+
+    publish (sequence);
+}
+
+void AudioProcessorGraph::publish (ReferenceCountedObjectPtr<RenderSequence> newSequence)
+{
+    {
+        const ScopedLock sl (editLock);
+
+        auto oldSequence = sequenceHolder;
+        sequenceHolder = newSequence;
+        currentSequence = newSequence.get();
+
+        // Any callback that starts after this point will see the new sequence, so the old one
+        // can be released once all the callbacks that had already started have finished.
+        if (oldSequence != nullptr)
+            retiredSequences.add ({ oldSequence, callbacksStarted.load() });
+    }
+
+    if (collector != nullptr)
+        collector->notify();
+}
+
+void AudioProcessorGraph::collectGarbage (bool force)
+{
+    Array<ReferenceCountedObjectPtr<RenderSequence>> toRelease;
+
+    {
+        const ScopedLock sl (editLock);
+        const auto finished = callbacksFinished.load();
+
+        for (int i = retiredSequences.size(); --i >= 0;)
+        {
+            if (force || finished >= retiredSequences.getReference (i).second)
+            {
+                toRelease.add (retiredSequences.getReference (i).first);
+                retiredSequences.remove (i);
+            }
+        }
+    }
+
+    // The sequences (and any removed nodes) are released here, outside the lock
+    toRelease.clear();
+}
+
+//==============================================================================
+void AudioProcessorGraph::setNumWorkerThreads (int numThreads)
+{
+    // The worker pool can't be changed while the audio thread may be using it!
+    jassert (currentSampleRate == 0.0f);
+
+    stopWorkers();
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        auto* worker = workers.add (new Worker (*this, i));
+
+        if (! worker->startRealtimeThread ({}))
+            worker->startThread (Thread::Priority::highest);
+    }
+
+    rebuild();
+}
+
+int AudioProcessorGraph::getNumWorkerThreads() const noexcept
+{
+    return workers.size();
+}
+
+void AudioProcessorGraph::stopWorkers()
+{
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    workAvailable.signal (workers.size());
+    workers.clear();
+
+    // Any wake-ups that weren't used would only make the next workers spin round once for nothing
+    while (workAvailable.tryWait())
+    {
+    }
+}
+
+//==============================================================================
+void AudioProcessorGraph::setMidiBufferCapacity (size_t maxNumBytes)
+{
+    {
+        const ScopedLock sl (editLock);
+        midiBufferCapacity = maxNumBytes;
+    }
+
+    rebuild();
+}
+
+size_t AudioProcessorGraph::getMidiBufferCapacity() const noexcept
+{
+    const ScopedLock sl (editLock);
+    return midiBufferCapacity;
+}
+
+//==============================================================================
+void AudioProcessorGraph::prepareToPlay (float sampleRate, int maxBlockSize)
+{
+    ReferenceCountedArray<Node> nodesToPrepare;
+
+    {
+        const ScopedLock sl (editLock);
+
+        currentSampleRate = sampleRate;
+        currentMaxBlockSize = maxBlockSize;
+        ++numPreparations;
+        nodesToPrepare = nodes;
+    }
+
+    for (auto* node : nodesToPrepare)
+    {
+        node->processor->prepareToPlay (sampleRate, maxBlockSize);
+        node->isPrepared = true;
+    }
+
+    rebuild();
+}
+
+void AudioProcessorGraph::releaseResources()
+{
+    ReferenceCountedArray<Node> nodesToRelease;
+
+    {
+        const ScopedLock sl (editLock);
+
+        currentSampleRate = 0.0f;
+        currentMaxBlockSize = 0;
+        ++numPreparations;
+        nodesToRelease = nodes;
+    }
+
+    rebuild();
+
+    for (auto* node : nodesToRelease)
+    {
+        if (node->isPrepared)
+            node->processor->releaseResources();
+
+        node->isPrepared = false;
+    }
+}
+
+//==============================================================================
+void AudioProcessorGraph::processBlock (AudioSampleBuffer& audioBuffer, MidiBuffer& midiBuffer)
+{
+    callbacksStarted.fetch_add (1);
+
+    auto& sequence = *currentSequence.load();
+    const auto numSamples = audioBuffer.getNumSamples();
+
+    if (numSamples > sequence.maxBlockSize)
+    {
+        // The graph hasn't been prepared, or has been prepared for smaller blocks!
+        jassert (sequence.maxBlockSize == 0);
+
+        audioBuffer.clear();
+        midiBuffer.clear();
+        callbacksFinished.fetch_add (1);
+        return;
+    }
+
+    auto& input = *sequence.renderNodes.getUnchecked (sequence.inputIndex);
+    input.buffer.setSize (input.buffer.getNumChannels(), numSamples, false, false, true);
+
+    for (int i = 0; i < input.buffer.getNumChannels(); ++i)
+    {
+        if (i < audioBuffer.getNumChannels())
+            input.buffer.copyFrom (i, 0, audioBuffer, i, 0, numSamples);
+        else
+            input.buffer.clear (i, 0, numSamples);
+    }
+
+    input.midi.clear();
+    input.midi.addEvents (midiBuffer, 0, numSamples, 0);
+
+    if (workers.isEmpty())
+    {
+        for (int i = 0; i < sequence.renderNodes.size(); ++i)
+            renderNode (sequence, i, numSamples);
+    }
+    else
+    {
+        renderInParallel (sequence, numSamples);
+    }
+
+    auto& output = *sequence.renderNodes.getUnchecked (sequence.outputIndex);
+
+    for (int i = 0; i < audioBuffer.getNumChannels(); ++i)
+    {
+        if (i < output.buffer.getNumChannels())
+            audioBuffer.copyFrom (i, 0, output.buffer, i, 0, numSamples);
+        else
+            audioBuffer.clear (i, 0, numSamples);
+    }
+
+    midiBuffer.clear();
+    midiBuffer.addEvents (output.midi, 0, numSamples, 0);
+
+    callbacksFinished.fetch_add (1);
+}
+
+void AudioProcessorGraph::renderNode (RenderSequence& sequence, int index, int numSamples) noexcept
+{
+    if (index == sequence.inputIndex)
+        return;
+
+    auto& renderNode = *sequence.renderNodes.getUnchecked (index);
+    auto& buffer = renderNode.buffer;
+
+    buffer.setSize (buffer.getNumChannels(), numSamples, false, false, true);
+    buffer.clear();
+
+    for (const auto& input : renderNode.audioInputs)
+    {
+        const auto* source = sequence.renderNodes.getUnchecked (input.source)->buffer.getReadPointer (input.sourceChannel);
+        auto* dest = buffer.getWritePointer (input.destChannel);
+
+        if (input.delay != nullptr)
+            input.delay->addDelayed (dest, source, numSamples);
+        else
+            FloatVectorOperations::add (dest, source, numSamples);
+    }
+
+    renderNode.midi.clear();
+
+    for (const auto& input : renderNode.midiInputs)
+    {
+        const auto& source = sequence.renderNodes.getUnchecked (input.source)->midi;
+
+        if (input.delay != nullptr)
+            input.delay->addDelayed (renderNode.midi, source, numSamples);
+        else
+            renderNode.midi.addEvents (source, 0, numSamples, 0);
+    }
+
+    if (renderNode.processor != nullptr)
+        renderNode.processor->processBlock (buffer, renderNode.midi);
+}
+
+void AudioProcessorGraph::renderInParallel (RenderSequence& sequence, int numSamples) noexcept
+{
+    for (auto* queue : sequence.queues)
+        queue->reset();
+
+    for (int i = 0; i < sequence.renderNodes.size(); ++i)
+    {
+        auto& renderNode = *sequence.renderNodes.getUnchecked (i);
+        renderNode.numPendingInputs.store (renderNode.numPredecessors, std::memory_order_relaxed);
+
+        if (renderNode.numPredecessors == 0)
+            sequence.queues.getUnchecked (0)->push (i);
+    }
+
+    sequence.numNodesDone = 0;
+    jobNumSamples = numSamples;
+
+    // Wake-ups left over from the last block would only make threads check for work needlessly
+    while (jobsReady.tryWait())
+    {
+    }
+
+    activeSequence = &sequence;
+    workAvailable.signal (workers.size());
+
+    runRenderJobs (sequence, 0);
+
+    activeSequence = nullptr;
+    waitForWorkers();
+}
+
+void AudioProcessorGraph::runRenderJobs (RenderSequence& sequence, int queueIndex) noexcept
+{
+    auto& ownQueue = *sequence.queues.getUnchecked (queueIndex);
+    const auto numNodes = sequence.renderNodes.size();
+
+    while (sequence.numNodesDone.load() < numNodes)
+    {
+        int index = -1;
+
+        if (! findRenderJob (sequence, queueIndex, index))
+        {
+            waitForRenderJob (sequence);
+            continue;
+        }
+
+        renderNode (sequence, index, jobNumSamples);
+
+        // Successors are queued before this node counts as done, so that once every node is
+        // done, nothing can be left in any of the queues
+        auto numQueued = 0;
+
+        for (auto successor : sequence.renderNodes.getUnchecked (index)->successors)
+        {
+            if (sequence.renderNodes.getUnchecked (successor)->numPendingInputs.fetch_sub (1) == 1)
+            {
+                ownQueue.push (successor);
+                ++numQueued;
+            }
+        }
+
+        const auto isLastNode = sequence.numNodesDone.fetch_add (1) + 1 == numNodes;
+
+        // This thread takes one of the new jobs itself, and sleeping threads are woken for the
+        // rest. When the block is finished, they're all woken so that they can return.
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto numParked = numParkedThreads.load();
+        const auto numToWake = isLastNode ? numParked : jmin (numParked, numQueued - 1);
+
+        if (numToWake > 0)
+            jobsReady.signal (numToWake);
+    }
+}
+
+bool AudioProcessorGraph::findRenderJob (RenderSequence& sequence, int queueIndex, int& index) noexcept
+{
+    if (sequence.queues.getUnchecked (queueIndex)->pop (index))
+        return true;
+
+    const auto numQueues = sequence.queues.size();
+
+    for (int i = 1; i < numQueues; ++i)
+        if (sequence.queues.getUnchecked ((queueIndex + i) % numQueues)->steal (index))
+            return true;
+
+    return false;
+}
+
+void AudioProcessorGraph::waitForRenderJob (RenderSequence& sequence) noexcept
+{
+    const auto canContinue = [&sequence]
+    {
+        if (sequence.numNodesDone.load() >= sequence.renderNodes.size())
+            return true;
+
+        for (auto* queue : sequence.queues)
+            if (! queue->isEmpty())
+                return true;
+
+        return false;
+    };
+
+    // The node that's being waited for is usually about to finish, so spin for a while first
+    for (int spin = 0; spin < 1000; ++spin)
+        if (canContinue())
+            return;
+
+    // A thread that queues new jobs after this has been counted will see it, and wake it up
+    numParkedThreads.fetch_add (1);
+
+    if (! canContinue())
+        jobsReady.wait();
+
+    numParkedThreads.fetch_sub (1);
+}
+
+void AudioProcessorGraph::waitForWorkers() noexcept
+{
+    // Whichever worker brings the busy count down to zero while this flag is set clears it and
+    // signals the semaphore, so there's exactly one signal for each wait
+    isWaitingForWorkers.store (true);
+
+    if (numBusyWorkers.load() == 0 && isWaitingForWorkers.exchange (false))
+        return;
+
+    workersFinished.wait();
+}
+
+} // namespace yup
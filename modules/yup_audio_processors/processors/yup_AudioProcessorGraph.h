@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace yup
+{
+
+//==============================================================================
+/**
+    A graph of AudioProcessors, connected channel by channel.
+
+    The graph has an input node and an output node, which stand for the audio and MIDI
+    passed to processBlock(), and any number of nodes that each own an AudioProcessor.
+    Connections go from an output channel of one node to an input channel of another;
+    a connection whose channels are both midiChannelIndex carries MIDI. Connections
+    that would make a cycle are refused.
+
+    Every edit builds a new render sequence on the calling thread: the nodes in
+    topological order, with their buffers, and with a delay line on every connection,
+    audio or MIDI, whose source has less latency (see AudioProcessor::getLatencySamples())
+    than the other signals arriving at the same node. The delay lines of connections
+    that survive an edit are carried over, so the audio in them isn't lost. The sequence
+    is then published to the audio thread atomically, so processBlock() never waits for
+    an edit, and replaced sequences (along with any removed processors) are released
+    later on a background thread, once no callback can still be using them.
+
+    With setNumWorkerThreads(), nodes that don't depend on each other are rendered in
+    parallel by a pool of realtime worker threads, with the audio thread joining in.
+    Each thread has its own queue of nodes that are ready to run, and threads that
+    run out of work steal from the others. Threads that are waiting for work spin for
+    a short while and then sleep, and are woken without taking any locks.
+
+    Methods that change the graph must be called from one thread at a time (normally the
+    message thread), and not concurrently with prepareToPlay() or releaseResources().
+*/
+class JUCE_API AudioProcessorGraph
+{
+public:
+    //==============================================================================
+    /** Identifies a node in the graph. */
+    using NodeID = uint32;
+
+    /** The node that outputs the audio and MIDI passed in to processBlock(). */
+    static constexpr NodeID audioInputNodeID = 1;
+
+    /** The node whose inputs become the audio and MIDI returned by processBlock(). */
+    static constexpr NodeID audioOutputNodeID = 2;
+
+    /** The channel index used by connections that carry MIDI rather than audio. */
+    static constexpr int midiChannelIndex = 0x1000;
+
+    /** A connection between two channels of two nodes. */
+    struct JUCE_API Connection
+    {
+        NodeID sourceNode = 0;
+        int sourceChannel = 0;
+        NodeID destNode = 0;
+        int destChannel = 0;
+
+        bool isMidi() const noexcept { return sourceChannel == midiChannelIndex; }
+
+        bool operator== (const Connection& other) const noexcept
+        {
+            return sourceNode == other.sourceNode && sourceChannel == other.sourceChannel
+                && destNode == other.destNode && destChannel == other.destChannel;
+        }
+
+        bool operator!= (const Connection& other) const noexcept { return ! operator== (other); }
+    };
+
+    //==============================================================================
+    /** Creates an empty graph, with two input and two output channels. */
+    AudioProcessorGraph();
+
+    /** Destructor. */
+    ~AudioProcessorGraph();
+
+    //==============================================================================
+    /** Sets the number of channels that the input and output nodes have.
+
+        Any connections to channels that no longer exist are removed.
+    */
+    void setNumChannels (int numInputChannels, int numOutputChannels);
+
+    /** Returns the number of channels of the input node. */
+    int getNumInputChannels() const noexcept;
+
+    /** Returns the number of channels of the output node. */
+    int getNumOutputChannels() const noexcept;
+
+    //==============================================================================
+    /** Adds a processor to the graph, and returns the ID of its node.
+
+        If the graph has been prepared, the processor is prepared before it is published
+        to the audio thread. Returns 0 if the processor is null.
+    */
+    NodeID addNode (std::unique_ptr<AudioProcessor> processor);
+
+    /** Removes a node and all its connections.
+
+        The processor stops being rendered as soon as this returns, but it's released and
+        deleted later on, from a background thread, once the audio thread can't be using it.
+    */
+    bool removeNode (NodeID nodeID);
+
+    /** Returns the processor of a node, or nullptr if there's no such node. */
+    AudioProcessor* getProcessor (NodeID nodeID) const;
+
+    /** Returns the number of processor nodes, not counting the input and output nodes. */
+    int getNumNodes() const;
+
+    /** Removes all the processor nodes and connections. */
+    void clear();
+
+    //==============================================================================
+    /** Returns true if the connection could be added: both channels exist, it isn't
+        already there, and it wouldn't create a cycle.
+    */
+    bool canConnect (const Connection& connection) const;
+
+    /** Adds a connection, returning false if canConnect() would refuse it. */
+    bool addConnection (const Connection& connection);
+
+    /** Removes a connection, returning false if it wasn't there. */
+    bool removeConnection (const Connection& connection);
+
+    /** Returns true if the connection exists. */
+    bool isConnected (const Connection& connection) const;
+
+    /** Returns all the connections in the graph. */
+    std::vector<Connection> getConnections() const;
+
+    //==============================================================================
+    /** Returns the latency of the whole graph, i.e. of the longest path to the output node. */
+    int getLatencySamples() const;
+
+    //==============================================================================
+    /** Enables parallel rendering of the nodes.
+
+        With 0 worker threads (the default), the nodes are rendered one after the other on
+        the audio thread. The worker threads are realtime threads, so you shouldn't create
+        more of them than there are spare cores. This must not be called while the graph
+        is being played.
+    */
+    void setNumWorkerThreads (int numThreads);
+
+    /** Returns the number of worker threads used for parallel rendering. */
+    int getNumWorkerThreads() const noexcept;
+
+    //==============================================================================
+    /** The default for setMidiBufferCapacity(). */
+    static constexpr size_t defaultMidiBufferCapacity = 8192;
+
+    /** Sets the number of bytes of MIDI that each node's buffer can hold.
+
+        The buffers have a fixed size so that the audio thread never allocates, and any
+        events that don't fit are dropped. The same size is used for the buffers that
+        delay MIDI for latency compensation.
+    */
+    void setMidiBufferCapacity (size_t maxNumBytes);
+
+    /** Returns the number of bytes of MIDI that each node's buffer can hold. */
+    size_t getMidiBufferCapacity() const noexcept;
+
+    //==============================================================================
+    /** Prepares all the processors, and allocates the buffers for blocks of up to
+        maxBlockSize samples.
+    */
+    void prepareToPlay (float sampleRate, int maxBlockSize);
+
+    /** Releases all the processors. */
+    void releaseResources();
+
+    /** Renders a block.
+
+        The buffer's channels are fed to the input node's channels, and then replaced with
+        the output node's. The MIDI buffer is replaced in the same way.
+    */
+    void processBlock (AudioSampleBuffer& audioBuffer, MidiBuffer& midiBuffer);
+
+private:
+    //==============================================================================
+    struct Node;
+    struct RenderNode;
+    struct RenderSequence;
+    class WorkQueue;
+    class DelayLine;
+    class MidiDelayLine;
+    class Worker;
+    class Collector;
+
+    bool canConnectLocked (const Connection&) const;
+    bool isReachableLocked (NodeID source, NodeID dest) const;
+    int getNumChannelsLocked (NodeID, bool isInput) const;
+    void removeInvalidConnectionsLocked();
+    void rebuild();
+    void publish (ReferenceCountedObjectPtr<RenderSequence>);
+    void collectGarbage (bool force);
+
+    void renderNode (RenderSequence&, int index, int numSamples) noexcept;
+    void renderInParallel (RenderSequence&, int numSamples) noexcept;
+    void runRenderJobs (RenderSequence&, int queueIndex) noexcept;
+    bool findRenderJob (RenderSequence&, int queueIndex, int& index) noexcept;
+    void waitForRenderJob (RenderSequence&) noexcept;
+    void waitForWorkers() noexcept;
+    void stopWorkers();
+
+    //==============================================================================
+    std::atomic<RenderSequence*> currentSequence { nullptr };
+    std::atomic<uint64> callbacksStarted { 0 }, callbacksFinished { 0 };
+
+    CriticalSection editLock;
+    ReferenceCountedArray<Node> nodes;
+    std::vector<Connection> connections;
+    NodeID lastNodeID = audioOutputNodeID;
+    int numInputChannels = 2, numOutputChannels = 2;
+    float currentSampleRate = 0.0f;
+    int currentMaxBlockSize = 0;
+    size_t midiBufferCapacity = defaultMidiBufferCapacity;
+    uint32 numPreparations = 0;
+
+    ReferenceCountedObjectPtr<RenderSequence> sequenceHolder;
+    Array<std::pair<ReferenceCountedObjectPtr<RenderSequence>, uint64>> retiredSequences;
+
+    std::atomic<RenderSequence*> activeSequence { nullptr };
+    std::atomic<int> numBusyWorkers { 0 }, numParkedThreads { 0 };
+    std::atomic<bool> isWaitingForWorkers { false };
+    LightweightSemaphore workAvailable, jobsReady, workersFinished;
+    int jobNumSamples = 0;
+
+    OwnedArray<Worker> workers;
+    std::unique_ptr<Collector> collector;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorGraph)
+};
+
+} // namespace yup
@@ -0,0 +1,101 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace yup
+{
+
+//==============================================================================
+AudioProcessorGraphPlayer::AudioProcessorGraphPlayer (AudioProcessorGraph& graphToPlay)
+    : graph (graphToPlay)
+{
+}
+
+AudioProcessorGraphPlayer::~AudioProcessorGraphPlayer()
+{
+}
+
+//==============================================================================
+void AudioProcessorGraphPlayer::audioDeviceAboutToStart (AudioIODevice* device)
+{
+    const auto sampleRate = device->getCurrentSampleRate();
+    const auto blockSize = device->getCurrentBufferSizeSamples();
+    const auto numChannels = jmax (device->getActiveInputChannels().countNumberOfSetBits(),
+                                   device->getActiveOutputChannels().countNumberOfSetBits(),
+                                   graph.getNumInputChannels(),
+                                   graph.getNumOutputChannels());
+
+    preparedBlockSize = blockSize;
+    preparedNumChannels = jmax (1, numChannels);
+    buffer.setSize (preparedNumChannels, preparedBlockSize);
+    incomingMidi.setFixedCapacity (graph.getMidiBufferCapacity());
+    midiCollector.reset (sampleRate);
+    graph.prepareToPlay ((float) sampleRate, blockSize);
+}
+
+void AudioProcessorGraphPlayer::audioDeviceStopped()
+{
+    graph.releaseResources();
+}
+
+void AudioProcessorGraphPlayer::audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
+                                                                  int numInputChannels,
+                                                                  float* const* outputChannelData,
+                                                                  int numOutputChannels,
+                                                                  int numSamples,
+                                                                  const AudioIODeviceCallbackContext& context)
+{
+    // AudioProcessor has no way to be given a play head or host time, so there's nothing
+    // to pass these on to
+    ignoreUnused (context);
+
+    // The buffer should have been allocated in audioDeviceAboutToStart(). It's shrunk to fit
+    // each block without reallocating, so it's the prepared size that's checked here.
+    jassert (numSamples <= preparedBlockSize);
+    jassert (jmax (numInputChannels, numOutputChannels) <= preparedNumChannels);
+
+    buffer.setSize (preparedNumChannels, numSamples, false, false, true);
+
+    for (int i = 0; i < buffer.getNumChannels(); ++i)
+    {
+        if (i < numInputChannels && inputChannelData[i] != nullptr)
+            buffer.copyFrom (i, 0, inputChannelData[i], numSamples);
+        else
+            buffer.clear (i, 0, numSamples);
+    }
+
+    incomingMidi.clear();
+    midiCollector.removeNextBlockOfMessages (incomingMidi, numSamples);
+
+    graph.processBlock (buffer, incomingMidi);
+
+    for (int i = 0; i < numOutputChannels; ++i)
+    {
+        if (outputChannelData[i] == nullptr)
+            continue;
+
+        if (i < buffer.getNumChannels())
+            FloatVectorOperations::copy (outputChannelData[i], buffer.getReadPointer (i), numSamples);
+        else
+            FloatVectorOperations::clear (outputChannelData[i], numSamples);
+    }
+}
+
+} // namespace yup
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace yup
+{
+
+//==============================================================================
+/**
+    An AudioIODeviceCallback that plays an AudioProcessorGraph.
+
+    Add one of these to an AudioDeviceManager with addAudioCallback(). The device's
+    input channels are fed to the graph's input node, and the graph's output node is
+    sent to the device's outputs, channel by channel. MIDI comes from the player's
+    LockFreeMidiMessageCollector, which can be registered with the AudioDeviceManager
+    as a MIDI input callback.
+
+    @code
+    AudioProcessorGraph graph;
+    AudioProcessorGraphPlayer player (graph);
+
+    deviceManager.addAudioCallback (&player);
+    deviceManager.addMidiInputDeviceCallback ({}, &player.getMidiMessageCollector());
+    @endcode
+*/
+class JUCE_API AudioProcessorGraphPlayer : public AudioIODeviceCallback
+{
+public:
+    //==============================================================================
+    /** Creates a player for a graph, which must outlive it. */
+    explicit AudioProcessorGraphPlayer (AudioProcessorGraph& graphToPlay);
+
+    /** Destructor. */
+    ~AudioProcessorGraphPlayer() override;
+
+    //==============================================================================
+    /** Returns the graph being played. */
+    AudioProcessorGraph& getGraph() noexcept { return graph; }
+
+    /** Returns the collector that incoming MIDI messages should be added to. */
+    LockFreeMidiMessageCollector& getMidiMessageCollector() noexcept { return midiCollector; }
+
+    //==============================================================================
+    /** @internal */
+    void audioDeviceIOCallbackWithContext (const float* const* inputChannelData,
+                                           int numInputChannels,
+                                           float* const* outputChannelData,
+                                           int numOutputChannels,
+                                           int numSamples,
+                                           const AudioIODeviceCallbackContext& context) override;
+    /** @internal */
+    void audioDeviceAboutToStart (AudioIODevice* device) override;
+    /** @internal */
+    void audioDeviceStopped() override;
+
+private:
+    //==============================================================================
+    AudioProcessorGraph& graph;
+    LockFreeMidiMessageCollector midiCollector;
+    AudioSampleBuffer buffer;
+    int preparedBlockSize = 0, preparedNumChannels = 0;
+    MidiBuffer incomingMidi;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProcessorGraphPlayer)
+};
+
+} // namespace yup
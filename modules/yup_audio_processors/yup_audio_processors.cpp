@@ -34,3 +34,8 @@
 #include "processors/yup_AudioProcessorParameter.cpp"
 #include "processors/yup_AudioProcessorEditor.cpp"
 #include "processors/yup_AudioProcessor.cpp"
+#include "processors/yup_AudioProcessorGraph.cpp"
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_devices
+#include "processors/yup_AudioProcessorGraphPlayer.cpp"
+#endif
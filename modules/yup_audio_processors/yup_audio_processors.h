@@ -48,7 +48,16 @@
 
 #include <yup_gui/yup_gui.h>
 
+#if JUCE_MODULE_AVAILABLE_juce_audio_devices
+#include <juce_audio_devices/juce_audio_devices.h>
+#endif
+
 //==============================================================================
 #include "processors/yup_AudioProcessorParameter.h"
 #include "processors/yup_AudioProcessorEditor.h"
 #include "processors/yup_AudioProcessor.h"
+#include "processors/yup_AudioProcessorGraph.h"
+
+#if JUCE_MODULE_AVAILABLE_juce_audio_devices
+#include "processors/yup_AudioProcessorGraphPlayer.h"
+#endif
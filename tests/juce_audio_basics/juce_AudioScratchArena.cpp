@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+TEST (AudioScratchArenaTests, ViewsReferToTheUnderlyingBuffer)
+{
+    AudioBuffer<float> buffer (4, 64);
+    buffer.clear();
+
+    AudioBufferView<float> view (buffer);
+    EXPECT_EQ (view.getNumChannels(), 4);
+    EXPECT_EQ (view.getNumSamples(), 64);
+
+    auto sub = view.getChannelRange (1, 2).getSampleRange (16, 8);
+    EXPECT_EQ (sub.getNumChannels(), 2);
+    EXPECT_EQ (sub.getNumSamples(), 8);
+    EXPECT_EQ (sub.getWritePointer (0), buffer.getWritePointer (1, 16));
+
+    sub.setSample (1, 3, 0.5f);
+    EXPECT_EQ (buffer.getSample (2, 19), 0.5f);
+    EXPECT_EQ (view.getMagnitude(), 0.5f);
+
+    sub.applyGain (2.0f);
+    EXPECT_EQ (buffer.getSample (2, 19), 1.0f);
+
+    sub.clear();
+    EXPECT_EQ (buffer.getMagnitude (0, 64), 0.0f);
+}
+
+TEST (AudioScratchArenaTests, AllocatesAlignedBuffersUntilFull)
+{
+    AudioScratchArena arena;
+    arena.prepare (AudioScratchArena::getBytesNeeded<float> (2, 100, 2));
+
+    auto first = arena.allocateBuffer<float> (2, 100);
+    auto second = arena.allocateBuffer<float> (2, 100);
+
+    ASSERT_EQ (first.getNumChannels(), 2);
+    ASSERT_EQ (second.getNumChannels(), 2);
+    EXPECT_EQ (second.getMagnitude(), 0.0f);
+
+    for (auto* view : { &first, &second })
+        for (int ch = 0; ch < 2; ++ch)
+            EXPECT_EQ (reinterpret_cast<pointer_sized_uint> (view->getReadPointer (ch)) % AudioScratchArena::defaultAlignment, 0u);
+
+    FloatVectorOperations::fill (first.getWritePointer (1), 1.0f, 100);
+    second.addFrom (first, 0.5f);
+    EXPECT_EQ (second.getSample (1, 99), 0.5f);
+    EXPECT_EQ (second.getSample (0, 0), 0.0f);
+
+    EXPECT_GT (arena.getNumBytesUsed(), (size_t) 0);
+    EXPECT_LE (arena.getNumBytesUsed(), arena.getCapacity());
+
+    arena.reset();
+    EXPECT_EQ (arena.getNumBytesUsed(), (size_t) 0);
+    EXPECT_GT (arena.getPeakNumBytesUsed(), (size_t) 0);
+}
+
+TEST (AudioScratchArenaTests, ScopedRewindReleasesTemporaryBuffers)
+{
+    AudioScratchArena arena;
+    arena.prepare (4096);
+
+    arena.allocate (100);
+    const auto used = arena.getNumBytesUsed();
+
+    {
+        AudioScratchArena::ScopedRewind rewind (arena);
+        auto temp = arena.allocateBuffer<double> (2, 128);
+        EXPECT_FALSE (temp.isEmpty());
+        EXPECT_GT (arena.getNumBytesUsed(), used);
+    }
+
+    EXPECT_EQ (arena.getNumBytesUsed(), used);
+    EXPECT_EQ (arena.getNumFailedAllocations(), 0);
+}
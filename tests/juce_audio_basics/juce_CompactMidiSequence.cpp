@@ -0,0 +1,262 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+namespace
+{
+MidiMessage at (MidiMessage message, double time)
+{
+    message.setTimeStamp (time);
+    return message;
+}
+
+MemoryBlock createMidiFileData()
+{
+    MidiMessageSequence conductor;
+    conductor.addEvent (at (MidiMessage::textMetaEvent (3, "Conductor"), 0));
+    conductor.addEvent (at (MidiMessage::tempoMetaEvent (500000), 0));
+    conductor.addEvent (at (MidiMessage::timeSignatureMetaEvent (3, 4), 0));
+    conductor.addEvent (at (MidiMessage::tempoMetaEvent (750000), 1920));
+    conductor.addEvent (at (MidiMessage::tempoMetaEvent (400000), 4000));
+
+    MidiMessageSequence notes;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        notes.addEvent (at (MidiMessage::noteOn (1 + (i % 3), 40 + (i % 24), (uint8) 100), i * 120));
+        notes.addEvent (at (MidiMessage::noteOff (1 + (i % 3), 40 + (i % 24)), i * 120 + 240));
+    }
+
+    // a retriggered note, which has no note-off of its own before the next note-on
+    notes.addEvent (at (MidiMessage::noteOn (10, 36, (uint8) 90), 1920));
+    notes.addEvent (at (MidiMessage::noteOn (10, 36, (uint8) 90), 2000));
+    notes.addEvent (at (MidiMessage::noteOn (10, 36, (uint8) 0), 2100));
+
+    const uint8 sysexData[] = { 0x7e, 0x7f, 0x09, 0x01 };
+    notes.addEvent (at (MidiMessage::createSysExMessage (sysexData, (int) sizeof (sysexData)), 1920));
+    notes.addEvent (at (MidiMessage::controllerEvent (1, 7, 64), 1920));
+
+    MidiFile file;
+    file.setTicksPerQuarterNote (480);
+    file.addTrack (conductor);
+    file.addTrack (notes);
+
+    MemoryOutputStream out;
+    file.writeTo (out, 1);
+    return out.getMemoryBlock();
+}
+
+bool hasSameBytes (const uint8* data, int size, const MidiMessage& message)
+{
+    return size == message.getRawDataSize() && memcmp (data, message.getRawData(), (size_t) size) == 0;
+}
+} // namespace
+
+TEST (CompactMidiSequenceTests, MidiMessageSequenceMatchesPairsAndInsertsNoteOffs)
+{
+    MidiMessageSequence s;
+    s.addEvent (at (MidiMessage::noteOn (1, 60, (uint8) 100), 0.0));
+    s.addEvent (at (MidiMessage::noteOn (1, 62, (uint8) 100), 1.0));
+    s.addEvent (at (MidiMessage::noteOn (1, 60, (uint8) 100), 2.0));
+    s.addEvent (at (MidiMessage::noteOff (1, 62), 3.0));
+    s.addEvent (at (MidiMessage::noteOn (2, 60, (uint8) 0), 4.0));
+    s.addEvent (at (MidiMessage::noteOff (1, 60), 5.0));
+
+    s.updateMatchedPairs();
+
+    // a note-off was inserted before the second note-on of 60, at the same time
+    ASSERT_EQ (s.getNumEvents(), 7);
+    EXPECT_TRUE (s.getEventPointer (2)->message.isNoteOff());
+    EXPECT_EQ (s.getEventTime (2), 2.0);
+
+    EXPECT_EQ (s.getIndexOfMatchingKeyUp (0), 2);
+    EXPECT_EQ (s.getIndexOfMatchingKeyUp (1), 4);
+    EXPECT_EQ (s.getIndexOfMatchingKeyUp (3), 6);
+
+    EXPECT_EQ (s.getNextIndexAtTime (-1.0), 0);
+    EXPECT_EQ (s.getNextIndexAtTime (2.0), 2);
+    EXPECT_EQ (s.getNextIndexAtTime (2.5), 4);
+    EXPECT_EQ (s.getNextIndexAtTime (9.0), 7);
+
+    CompactMidiSequence compact;
+
+    for (int i : { 0, 1, 3, 4, 5, 6 })
+        compact.addEvent (s.getEventPointer (i)->message);
+
+    compact.updateMatchedPairs();
+
+    ASSERT_EQ (compact.getNumEvents(), 7);
+
+    for (int i = 0; i < 7; ++i)
+    {
+        EXPECT_EQ (compact.getEventTime (i), s.getEventTime (i));
+        EXPECT_TRUE (hasSameBytes (compact.getEventData (i), compact.getEventDataSize (i), s.getEventPointer (i)->message));
+        EXPECT_EQ (compact.getIndexOfMatchingNoteOff (i), s.getEventPointer (i)->message.isNoteOn() ? s.getIndexOfMatchingKeyUp (i) : -1);
+    }
+}
+
+TEST (CompactMidiSequenceTests, LoadsTheSameEventsAsMidiFile)
+{
+    const auto data = createMidiFileData();
+
+    MidiFile reference;
+    MemoryInputStream in (data, false);
+    ASSERT_TRUE (reference.readFrom (in));
+    reference.convertTimestampTicksToSeconds();
+
+    CompactMidiFile compact;
+    int fileType = -1;
+    ASSERT_TRUE (compact.readFrom (data.getData(), data.getSize(), true, &fileType));
+    compact.convertTimestampTicksToSeconds();
+
+    EXPECT_EQ (fileType, 1);
+    EXPECT_EQ (compact.getTimeFormat(), reference.getTimeFormat());
+    ASSERT_EQ (compact.getNumTracks(), reference.getNumTracks());
+    EXPECT_EQ (compact.getLastTimestamp(), reference.getLastTimestamp());
+
+    for (int t = 0; t < reference.getNumTracks(); ++t)
+    {
+        auto& expected = *reference.getTrack (t);
+        auto& actual = *compact.getTrack (t);
+
+        ASSERT_EQ (actual.getNumEvents(), expected.getNumEvents());
+
+        for (int i = 0; i < expected.getNumEvents(); ++i)
+        {
+            const auto& message = expected.getEventPointer (i)->message;
+
+            EXPECT_EQ (actual.getEventTime (i), message.getTimeStamp());
+            EXPECT_TRUE (hasSameBytes (actual.getEventData (i), actual.getEventDataSize (i), message));
+
+            if (message.isNoteOn())
+            {
+                EXPECT_EQ (actual.getIndexOfMatchingNoteOff (i), expected.getIndexOfMatchingKeyUp (i));
+            }
+        }
+    }
+
+    // 120 bpm for the first 4 beats, then 80 bpm
+    auto& notes = *compact.getTrack (1);
+    const auto controller = notes.getNextIndexAtTime (2.0);
+    EXPECT_NEAR (notes.getEventTime (controller), 2.0, 1.0e-9);
+    EXPECT_NEAR (notes.getEventTime (notes.getNextIndexAtTime (2.1)), 2.0 + 0.75 * 80.0 / 480.0, 1.0e-9);
+
+    const auto roundTrip = compact.toMidiFile();
+    ASSERT_EQ (roundTrip.getNumTracks(), 2);
+    EXPECT_EQ (roundTrip.getTrack (1)->getNumEvents(), notes.getNumEvents());
+    EXPECT_EQ (CompactMidiSequence (*roundTrip.getTrack (1)).getIndexOfMatchingNoteOff (0), notes.getIndexOfMatchingNoteOff (0));
+}
+
+TEST (CompactMidiSequenceTests, SortPutsNoteOffsFirstAndAddsEventsToBuffers)
+{
+    CompactMidiSequence s;
+    s.addEvent (at (MidiMessage::noteOn (1, 60, (uint8) 100), 0.5));
+    s.addEvent (at (MidiMessage::noteOn (1, 60, (uint8) 100), 0.0));
+    s.addEvent (at (MidiMessage::noteOff (1, 60), 0.5));
+    s.addEvent (at (MidiMessage::tempoMetaEvent (500000), 0.25));
+    s.addEvent (at (MidiMessage::noteOff (1, 60), 1.0));
+
+    s.sort();
+    s.updateMatchedPairs();
+
+    ASSERT_EQ (s.getNumEvents(), 5);
+    EXPECT_EQ (s.getEventTime (0), 0.0);
+    EXPECT_EQ (s.getEventStatus (2), 0x80);
+    EXPECT_EQ (s.getEventStatus (3), 0x90);
+    EXPECT_EQ (s.getIndexOfMatchingNoteOff (0), 2);
+    EXPECT_EQ (s.getTimeOfMatchingNoteOff (3), 1.0);
+
+    MidiBuffer buffer;
+    auto next = s.addEventsToBuffer (buffer, 0, 0.0, 0.5, 1000.0);
+
+    // the meta event is skipped
+    EXPECT_EQ (next, 2);
+    ASSERT_EQ (buffer.getNumEvents(), 1);
+
+    buffer.clear();
+    next = s.addEventsToBuffer (buffer, next, 0.5, 1.0, 1000.0);
+    EXPECT_EQ (next, 4);
+    ASSERT_EQ (buffer.getNumEvents(), 2);
+    EXPECT_EQ ((*buffer.cbegin()).samplePosition, 0);
+}
+
+TEST (CompactMidiSequenceTests, StreamReaderPlaysTheFileInOrder)
+{
+    const auto data = createMidiFileData();
+
+    MidiFile reference;
+    MemoryInputStream in (data, false);
+    ASSERT_TRUE (reference.readFrom (in, false));
+    reference.convertTimestampTicksToSeconds();
+
+    TemporaryFile tempFile (".mid");
+    ASSERT_TRUE (tempFile.getFile().replaceWithData (data.getData(), data.getSize()));
+
+    MidiFileStreamReader reader (tempFile.getFile());
+    ASSERT_TRUE (reader.isValid());
+    EXPECT_EQ (reader.getNumTracks(), 2);
+    EXPECT_NEAR (reader.getLengthInSeconds(), reference.getLastTimestamp(), 1.0e-9);
+
+    int nextIndex[2] = {};
+    double lastTime = 0.0;
+    MidiFileStreamReader::Event event;
+
+    while (reader.readNextEvent (event))
+    {
+        EXPECT_GE (event.time, lastTime);
+        lastTime = event.time;
+
+        auto& message = reference.getTrack (event.track)->getEventPointer (nextIndex[event.track]++)->message;
+        EXPECT_NEAR (event.time, message.getTimeStamp(), 1.0e-9);
+        EXPECT_TRUE (hasSameBytes (event.data, event.numBytes, message));
+    }
+
+    EXPECT_EQ (nextIndex[0], reference.getTrack (0)->getNumEvents());
+    EXPECT_EQ (nextIndex[1], reference.getTrack (1)->getNumEvents());
+    EXPECT_TRUE (reader.isFinished());
+
+    // seeking back, and then playing a few blocks
+    reader.seek (2.0);
+    EXPECT_NEAR (reader.getNextEventTime(), 2.0, 1.0e-9);
+
+    MidiBuffer buffer;
+    reader.renderNextBlock (buffer, 2.0, 441, 44100.0);
+
+    int numControllers = 0, numSysexes = 0;
+
+    for (const auto metadata : buffer)
+    {
+        const auto message = metadata.getMessage();
+        EXPECT_FALSE (message.isMetaEvent());
+        EXPECT_EQ (metadata.samplePosition, 0);
+        numControllers += message.isController() ? 1 : 0;
+        numSysexes += message.isSysEx() ? 1 : 0;
+    }
+
+    EXPECT_EQ (numControllers, 1);
+    EXPECT_EQ (numSysexes, 1);
+    EXPECT_GT (reader.getNextEventTime(), 2.01);
+}
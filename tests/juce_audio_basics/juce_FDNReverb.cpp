@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+namespace
+{
+bool allFinite (const AudioBuffer<float>& buffer)
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            if (! std::isfinite (buffer.getSample (ch, i)))
+                return false;
+
+    return true;
+}
+} // namespace
+
+TEST (FDNReverbTests, ImpulseProducesDecayingTailOnAllChannels)
+{
+    FDNReverb reverb;
+    reverb.prepare (44100.0);
+
+    ReverbParameters params;
+    params.dryLevel = 0.0f;
+    params.roomSize = 0.3f;
+    reverb.setParameters (params);
+
+    AudioBuffer<float> buffer (6, 44100 * 2);
+    buffer.clear();
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        buffer.setSample (ch, 0, 1.0f);
+
+    reverb.process (buffer, 0, buffer.getNumSamples());
+
+    EXPECT_TRUE (allFinite (buffer));
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+    {
+        EXPECT_GT (buffer.getMagnitude (ch, 0, 22050), 1.0e-3f);
+        EXPECT_LT (buffer.getMagnitude (ch, 44100, 44100), buffer.getMagnitude (ch, 0, 22050) * 0.1f);
+    }
+}
+
+TEST (FDNReverbTests, OutputChannelsAreDecorrelated)
+{
+    FDNReverb reverb;
+    reverb.prepare (48000.0);
+
+    ReverbParameters params;
+    params.dryLevel = 0.0f;
+    reverb.setParameters (params);
+
+    AudioBuffer<float> buffer (2, 4800);
+    buffer.clear();
+    buffer.setSample (0, 0, 1.0f);
+    buffer.setSample (1, 0, 1.0f);
+
+    reverb.process (buffer, 0, buffer.getNumSamples());
+
+    bool differs = false;
+
+    for (int i = 0; i < buffer.getNumSamples() && ! differs; ++i)
+        differs = std::abs (buffer.getSample (0, i) - buffer.getSample (1, i)) > 1.0e-4f;
+
+    EXPECT_TRUE (differs);
+}
+
+TEST (FDNReverbTests, ResetClearsTail)
+{
+    FDNReverb reverb;
+    reverb.prepare (44100.0);
+
+    AudioBuffer<float> buffer (2, 4096);
+    buffer.clear();
+    buffer.setSample (0, 0, 1.0f);
+    reverb.process (buffer, 0, buffer.getNumSamples());
+
+    reverb.reset();
+    buffer.clear();
+    reverb.process (buffer, 0, buffer.getNumSamples());
+
+    EXPECT_EQ (buffer.getMagnitude (0, buffer.getNumSamples()), 0.0f);
+}
+
+TEST (FDNReverbTests, ReverbCanSwitchToFeedbackDelayNetwork)
+{
+    Reverb reverb;
+    reverb.setSampleRate (44100.0);
+
+    Reverb::Parameters params;
+    params.dryLevel = 0.0f;
+    reverb.setParameters (params);
+
+    reverb.setAlgorithm (Reverb::Algorithm::feedbackDelayNetwork);
+    EXPECT_EQ (reverb.getAlgorithm(), Reverb::Algorithm::feedbackDelayNetwork);
+
+    AudioBuffer<float> buffer (4, 8192);
+    buffer.clear();
+    buffer.setSample (2, 0, 1.0f);
+
+    reverb.processChannels (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+
+    EXPECT_TRUE (allFinite (buffer));
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        EXPECT_GT (buffer.getMagnitude (ch, 0, buffer.getNumSamples()), 0.0f);
+}
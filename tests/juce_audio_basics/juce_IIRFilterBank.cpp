@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+namespace
+{
+void fillWithNoise (AudioBuffer<float>& buffer)
+{
+    Random random (1234);
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+}
+} // namespace
+
+TEST (IIRFilterBankTests, InactiveBankPassesThrough)
+{
+    AudioBuffer<float> buffer (3, 64);
+    fillWithNoise (buffer);
+
+    AudioBuffer<float> original;
+    original.makeCopyOf (buffer);
+
+    IIRFilterBank bank;
+    bank.prepare (3, 2);
+    bank.process (buffer, 0, buffer.getNumSamples());
+
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            EXPECT_FLOAT_EQ (buffer.getSample (ch, i), original.getSample (ch, i));
+}
+
+TEST (IIRFilterBankTests, MatchesCascadedIIRFilters)
+{
+    constexpr int numChannels = 5;
+    constexpr int numSamples = 256;
+
+    const auto lowPass = IIRCoefficients::makeLowPass (44100.0, 1000.0);
+    const auto peak = IIRCoefficients::makePeakFilter (44100.0, 3000.0, 0.7, 2.0f);
+
+    AudioBuffer<float> buffer (numChannels, numSamples);
+    fillWithNoise (buffer);
+
+    AudioBuffer<float> expected;
+    expected.makeCopyOf (buffer);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        SingleThreadedIIRFilter first, second;
+        first.setCoefficients (lowPass);
+        second.setCoefficients (peak);
+        first.processSamples (expected.getWritePointer (ch), numSamples);
+        second.processSamples (expected.getWritePointer (ch), numSamples);
+    }
+
+    IIRFilterBank bank;
+    bank.prepare (numChannels, 2);
+    EXPECT_TRUE (bank.setCoefficients (0, lowPass));
+    EXPECT_TRUE (bank.setCoefficients (1, peak));
+
+    bank.process (buffer, 0, numSamples / 2);
+    bank.process (buffer, numSamples / 2, numSamples / 2);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            EXPECT_NEAR (buffer.getSample (ch, i), expected.getSample (ch, i), 1.0e-5f);
+}
+
+TEST (IIRFilterBankTests, PerLaneCoefficients)
+{
+    AudioBuffer<float> buffer (2, 32);
+    fillWithNoise (buffer);
+
+    AudioBuffer<float> original;
+    original.makeCopyOf (buffer);
+
+    IIRFilterBank bank;
+    bank.prepare (2);
+    bank.setCoefficients (1, 0, IIRCoefficients::makeHighPass (48000.0, 500.0));
+    bank.process (buffer, 0, buffer.getNumSamples());
+
+    SingleThreadedIIRFilter reference;
+    reference.setCoefficients (IIRCoefficients::makeHighPass (48000.0, 500.0));
+    reference.processSamples (original.getWritePointer (1), original.getNumSamples());
+
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+    {
+        EXPECT_FLOAT_EQ (buffer.getSample (0, i), original.getSample (0, i));
+        EXPECT_NEAR (buffer.getSample (1, i), original.getSample (1, i), 1.0e-5f);
+    }
+}
+
+TEST (IIRFilterBankTests, SmoothingRampsTowardsTarget)
+{
+    IIRFilterBank bank;
+    bank.prepare (1, 1, 8);
+    bank.setCoefficients (0, IIRCoefficients (0.0, 0.0, 0.0, 1.0, 0.0, 0.0));
+
+    float ones[16];
+    std::fill (std::begin (ones), std::end (ones), 1.0f);
+    float* channels[] = { ones };
+
+    bank.process (channels, 1, 16);
+
+    EXPECT_NEAR (ones[0], 1.0f - 1.0f / 8.0f, 1.0e-6f);
+    EXPECT_NEAR (ones[3], 1.0f - 4.0f / 8.0f, 1.0e-6f);
+    EXPECT_FLOAT_EQ (ones[7], 0.0f);
+    EXPECT_FLOAT_EQ (ones[15], 0.0f);
+}
+
+TEST (IIRFilterBankTests, DroppedUpdatesAreCounted)
+{
+    IIRFilterBank bank;
+    bank.prepare (1, 1, 0, 2);
+
+    EXPECT_TRUE (bank.setCoefficients (0, IIRCoefficients::makeLowPass (44100.0, 100.0)));
+    EXPECT_TRUE (bank.setCoefficients (0, IIRCoefficients::makeLowPass (44100.0, 200.0)));
+    EXPECT_FALSE (bank.setCoefficients (0, IIRCoefficients::makeLowPass (44100.0, 300.0)));
+    EXPECT_EQ (bank.getNumDroppedUpdates(), 1);
+}
+
+TEST (IIRFilterBankTests, OutOfRangeUpdatesAreRejected)
+{
+    IIRFilterBank bank;
+    bank.prepare (2, 1, 0, 4);
+
+    const auto lowPass = IIRCoefficients::makeLowPass (44100.0, 100.0);
+    EXPECT_FALSE (bank.setCoefficients (2, 0, lowPass));
+    EXPECT_FALSE (bank.setCoefficients (-1, 0, lowPass));
+    EXPECT_FALSE (bank.setCoefficients (0, 1, lowPass));
+    EXPECT_FALSE (bank.setCoefficients (-1, lowPass));
+    EXPECT_FALSE (bank.makeInactive (0, 5));
+    EXPECT_EQ (bank.getNumDroppedUpdates(), 0);
+
+    AudioBuffer<float> buffer (2, 8);
+    buffer.clear();
+    buffer.setSample (0, 0, 1.0f);
+    buffer.setSample (1, 0, 1.0f);
+    bank.process (buffer, 0, buffer.getNumSamples());
+
+    EXPECT_FLOAT_EQ (buffer.getSample (0, 0), 1.0f);
+    EXPECT_FLOAT_EQ (buffer.getSample (1, 0), 1.0f);
+}
@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+namespace
+{
+class ConstantSource : public AudioSource
+{
+public:
+    ConstantSource (float v, std::atomic<int>* releaseCounter = nullptr)
+        : value (v), releases (releaseCounter)
+    {
+    }
+
+    void prepareToPlay (int, double) override {}
+
+    void releaseResources() override
+    {
+        if (releases != nullptr)
+            ++(*releases);
+    }
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+    {
+        for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+            FloatVectorOperations::fill (info.buffer->getWritePointer (ch, info.startSample), value, info.numSamples);
+    }
+
+private:
+    float value;
+    std::atomic<int>* releases;
+};
+
+class SlowSource : public AudioSource
+{
+public:
+    explicit SlowSource (std::atomic<int>& counter)
+        : renderedOffThread (counter)
+    {
+    }
+
+    void prepareToPlay (int, double) override {}
+    void releaseResources() override {}
+
+    void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+    {
+        // Gives the workers time to wake up and take some of the inputs
+        Thread::sleep (1);
+
+        if (Thread::getCurrentThreadId() != callingThread)
+            ++renderedOffThread;
+
+        info.clearActiveBufferRegion();
+    }
+
+    Thread::ThreadID callingThread = Thread::getCurrentThreadId();
+
+private:
+    std::atomic<int>& renderedOffThread;
+};
+
+void expectBufferEquals (const AudioBuffer<float>& buffer, float expected)
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            EXPECT_FLOAT_EQ (buffer.getSample (ch, i), expected);
+}
+} // namespace
+
+TEST (LockFreeMixerAudioSourceTests, EmptyMixerProducesSilence)
+{
+    LockFreeMixerAudioSource mixer;
+    mixer.prepareToPlay (64, 44100.0);
+
+    AudioBuffer<float> buffer (2, 64);
+    buffer.clear();
+    buffer.setSample (0, 0, 1.0f);
+
+    mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+    expectBufferEquals (buffer, 0.0f);
+}
+
+TEST (LockFreeMixerAudioSourceTests, SumsInputsSerially)
+{
+    LockFreeMixerAudioSource mixer;
+    mixer.addInputSource (new ConstantSource (0.25f), true);
+    mixer.addInputSource (new ConstantSource (0.5f), true);
+    mixer.addInputSource (new ConstantSource (1.0f), true);
+    mixer.prepareToPlay (64, 44100.0);
+
+    EXPECT_EQ (mixer.getNumInputs(), 3);
+
+    AudioBuffer<float> buffer (2, 64);
+    mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+    expectBufferEquals (buffer, 1.75f);
+}
+
+TEST (LockFreeMixerAudioSourceTests, SumsInputsInParallel)
+{
+    LockFreeMixerAudioSource mixer;
+    mixer.setNumWorkerThreads (3);
+    EXPECT_EQ (mixer.getNumWorkerThreads(), 3);
+
+    for (int i = 0; i < 16; ++i)
+        mixer.addInputSource (new ConstantSource (0.125f), true);
+
+    mixer.prepareToPlay (128, 48000.0);
+
+    AudioBuffer<float> buffer (2, 128);
+
+    for (int block = 0; block < 50; ++block)
+    {
+        mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+        expectBufferEquals (buffer, 2.0f);
+    }
+
+    mixer.releaseResources();
+}
+
+TEST (LockFreeMixerAudioSourceTests, BlocksSmallerThanExpectedDontStopParallelRendering)
+{
+    LockFreeMixerAudioSource mixer;
+    mixer.setNumWorkerThreads (3);
+
+    std::atomic<int> renderedOffThread { 0 };
+
+    for (int i = 0; i < 8; ++i)
+        mixer.addInputSource (new SlowSource (renderedOffThread), true);
+
+    mixer.prepareToPlay (128, 48000.0);
+
+    // The smaller block shrinks the scratch buffers, but the full size still fits their storage
+    AudioBuffer<float> small (2, 32), large (2, 128);
+    mixer.getNextAudioBlock (AudioSourceChannelInfo (small));
+    renderedOffThread = 0;
+
+    for (int block = 0; block < 5; ++block)
+    {
+        mixer.getNextAudioBlock (AudioSourceChannelInfo (large));
+        expectBufferEquals (large, 0.0f);
+    }
+
+    EXPECT_GT (renderedOffThread.load(), 0);
+    mixer.releaseResources();
+}
+
+TEST (LockFreeMixerAudioSourceTests, RemovedInputsAreReleasedWhenRemoved)
+{
+    std::atomic<int> releases { 0 };
+    ConstantSource source (1.0f, &releases);
+
+    LockFreeMixerAudioSource mixer;
+    mixer.addInputSource (&source, false);
+    mixer.addInputSource (new ConstantSource (2.0f), true);
+    mixer.prepareToPlay (32, 44100.0);
+
+    AudioBuffer<float> buffer (1, 32);
+    mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+    expectBufferEquals (buffer, 3.0f);
+
+    mixer.removeInputSource (&source);
+    EXPECT_EQ (mixer.getNumInputs(), 1);
+    EXPECT_EQ (releases.load(), 1);
+
+    mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+    expectBufferEquals (buffer, 2.0f);
+}
+
+TEST (LockFreeMixerAudioSourceTests, ReaddedInputsAreNotReleasedWhenOldListsAreCollected)
+{
+    std::atomic<int> releases { 0 };
+    ConstantSource source (1.0f, &releases);
+
+    LockFreeMixerAudioSource mixer;
+    mixer.addInputSource (&source, false);
+    mixer.prepareToPlay (32, 44100.0);
+
+    AudioBuffer<float> buffer (1, 32);
+    mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+
+    mixer.removeInputSource (&source);
+    mixer.addInputSource (&source, false);
+    EXPECT_EQ (releases.load(), 1);
+
+    // Give the background thread time to collect the lists that held the old input
+    for (int i = 0; i < 10; ++i)
+    {
+        mixer.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+        expectBufferEquals (buffer, 1.0f);
+        Thread::sleep (10);
+    }
+
+    EXPECT_EQ (releases.load(), 1);
+
+    mixer.removeAllInputs();
+    EXPECT_EQ (releases.load(), 2);
+}
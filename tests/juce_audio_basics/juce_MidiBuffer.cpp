@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+namespace
+{
+std::vector<std::pair<int, int>> getTimesAndNotes (const MidiBuffer& buffer)
+{
+    std::vector<std::pair<int, int>> result;
+
+    for (const auto metadata : buffer)
+        result.emplace_back (metadata.samplePosition, metadata.getMessage().getNoteNumber());
+
+    return result;
+}
+} // namespace
+
+TEST (MidiBufferTests, AddEventKeepsEventsSorted)
+{
+    MidiBuffer buffer;
+    buffer.addEvent (MidiMessage::noteOn (1, 1, 1.0f), 10);
+    buffer.addEvent (MidiMessage::noteOn (1, 2, 1.0f), 20);
+    buffer.addEvent (MidiMessage::noteOn (1, 3, 1.0f), 5);
+    buffer.addEvent (MidiMessage::noteOn (1, 4, 1.0f), 10);
+    buffer.addEvent (MidiMessage::noteOn (1, 5, 1.0f), 30);
+
+    const std::vector<std::pair<int, int>> expected { { 5, 3 }, { 10, 1 }, { 10, 4 }, { 20, 2 }, { 30, 5 } };
+    EXPECT_EQ (getTimesAndNotes (buffer), expected);
+    EXPECT_EQ (buffer.getFirstEventTime(), 5);
+    EXPECT_EQ (buffer.getLastEventTime(), 30);
+
+    buffer.clear (25, 10);
+    EXPECT_EQ (buffer.getLastEventTime(), 20);
+
+    buffer.addEvent (MidiMessage::noteOn (1, 6, 1.0f), 15);
+    buffer.addEvent (MidiMessage::noteOn (1, 7, 1.0f), 40);
+    EXPECT_EQ (buffer.getLastEventTime(), 40);
+    EXPECT_EQ (buffer.getNumEvents(), 6);
+}
+
+TEST (MidiBufferTests, UnsortedEventsAreStablySorted)
+{
+    MidiBuffer buffer;
+    Random random (42);
+    std::vector<std::pair<int, int>> expected;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        const auto time = random.nextInt (64);
+        const auto note = i % 128;
+
+        buffer.addEventUnsorted (MidiMessage::noteOn (1, note, 1.0f), time);
+        expected.emplace_back (time, note);
+    }
+
+    buffer.addEventUnsorted (MidiMessage::createSysExMessage ("abcdef", 6), 3);
+    expected.emplace_back (3, (int) 'a');
+
+    buffer.sortEvents();
+
+    std::stable_sort (expected.begin(), expected.end(),
+                      [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+    EXPECT_EQ (getTimesAndNotes (buffer), expected);
+    EXPECT_EQ (buffer.getLastEventTime(), expected.back().first);
+}
+
+TEST (MidiBufferTests, FixedCapacityDropsEventsInsteadOfGrowing)
+{
+    MidiBuffer buffer;
+    buffer.setFixedCapacity (90);
+    EXPECT_EQ (buffer.getFixedCapacity(), (size_t) 90);
+
+    const auto* storage = buffer.data.begin();
+
+    // Each note-on takes 9 bytes
+    for (int i = 0; i < 12; ++i)
+        buffer.addEvent (MidiMessage::noteOn (1, i, 1.0f), 11 - i);
+
+    EXPECT_EQ (buffer.getNumEvents(), 10);
+    EXPECT_EQ (buffer.getNumDroppedEvents(), 2);
+    EXPECT_EQ (buffer.data.begin(), storage);
+
+    buffer.clear();
+
+    for (int i = 0; i < 10; ++i)
+        buffer.addEventUnsorted (MidiMessage::noteOn (1, i, 1.0f), 9 - i);
+
+    buffer.sortEvents();
+
+    EXPECT_EQ (buffer.data.begin(), storage);
+    EXPECT_EQ (buffer.getFirstEventTime(), 0);
+    EXPECT_EQ (buffer.getLastEventTime(), 9);
+
+    buffer.resetNumDroppedEvents();
+    EXPECT_EQ (buffer.getNumDroppedEvents(), 0);
+}
+
+TEST (MidiBufferTests, FixedCapacityClearAndSortDoNotReallocate)
+{
+    MidiBuffer buffer;
+    buffer.setFixedCapacity (90);
+
+    const auto* storage = buffer.data.begin();
+
+    for (int i = 0; i < 10; ++i)
+        buffer.addEvent (MidiMessage::noteOn (1, i, 1.0f), i);
+
+    {
+        ScopedAllocationTripwire tripwire;
+
+        buffer.clear (2, 5);
+        EXPECT_EQ (buffer.getNumEvents(), 5);
+        EXPECT_EQ (buffer.getFirstEventTime(), 0);
+        EXPECT_EQ (buffer.getLastEventTime(), 9);
+
+        // Filling it right up again shows that none of the reserved space was given back
+        for (int i = 0; i < 5; ++i)
+            buffer.addEventUnsorted (MidiMessage::noteOn (1, 20 + i, 1.0f), 8 - i);
+
+        buffer.sortEvents();
+
+        EXPECT_EQ (tripwire.getNumAllocations(), 0);
+    }
+
+    EXPECT_EQ (buffer.getNumEvents(), 10);
+    EXPECT_EQ (buffer.getNumDroppedEvents(), 0);
+    EXPECT_EQ (buffer.data.begin(), storage);
+
+    int lastTime = -1;
+
+    for (const auto metadata : buffer)
+    {
+        EXPECT_GE (metadata.samplePosition, lastTime);
+        lastTime = metadata.samplePosition;
+    }
+}
+
+TEST (MidiBufferTests, CopiesKeepTheFixedCapacity)
+{
+    MidiBuffer buffer;
+    buffer.setFixedCapacity (90);
+
+    for (int i = 0; i < 4; ++i)
+        buffer.addEvent (MidiMessage::noteOn (1, i, 1.0f), i);
+
+    MidiBuffer copy (buffer);
+    EXPECT_EQ (copy.getFixedCapacity(), (size_t) 90);
+    EXPECT_EQ (copy.getNumEvents(), 4);
+
+    MidiBuffer assigned;
+    assigned.setFixedCapacity (90);
+    const auto* storage = assigned.data.begin();
+
+    {
+        ScopedAllocationTripwire tripwire;
+
+        assigned = buffer;
+
+        for (int i = 0; i < 6; ++i)
+            assigned.addEvent (MidiMessage::noteOn (1, i, 1.0f), 10 + i);
+
+        EXPECT_EQ (tripwire.getNumAllocations(), 0);
+    }
+
+    EXPECT_EQ (assigned.data.begin(), storage);
+    EXPECT_EQ (assigned.getNumEvents(), 10);
+    EXPECT_EQ (assigned.getNumDroppedEvents(), 0);
+}
+
+TEST (MidiBufferTests, MovedFromBuffersCanBeReused)
+{
+    MidiBuffer buffer;
+    buffer.setFixedCapacity (90);
+
+    for (int i = 0; i < 4; ++i)
+        buffer.addEvent (MidiMessage::noteOn (1, i, 1.0f), i);
+
+    MidiBuffer moved (std::move (buffer));
+    EXPECT_EQ (moved.getFixedCapacity(), (size_t) 90);
+    EXPECT_EQ (moved.getNumEvents(), 4);
+    EXPECT_EQ (buffer.getFixedCapacity(), (size_t) 0);
+    EXPECT_TRUE (buffer.isEmpty());
+
+    buffer.addEventUnsorted (MidiMessage::noteOn (1, 10, 1.0f), 5);
+    buffer.addEventUnsorted (MidiMessage::noteOn (1, 11, 1.0f), 2);
+    buffer.sortEvents();
+    buffer.clear (4, 2);
+    EXPECT_EQ (getTimesAndNotes (buffer), (std::vector<std::pair<int, int>> { { 2, 11 } }));
+
+    MidiBuffer assigned;
+    assigned = std::move (moved);
+    EXPECT_EQ (assigned.getFixedCapacity(), (size_t) 90);
+    EXPECT_EQ (assigned.getNumEvents(), 4);
+    EXPECT_EQ (moved.getFixedCapacity(), (size_t) 0);
+
+    moved.addEventUnsorted (MidiMessage::noteOn (1, 12, 1.0f), 3);
+    moved.addEventUnsorted (MidiMessage::noteOn (1, 13, 1.0f), 1);
+    moved.sortEvents();
+    EXPECT_EQ (getTimesAndNotes (moved), (std::vector<std::pair<int, int>> { { 1, 13 }, { 3, 12 } }));
+}
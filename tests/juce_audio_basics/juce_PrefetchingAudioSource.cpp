@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+namespace
+{
+AudioBuffer<float> makeRamp (int numChannels, int numSamples)
+{
+    AudioBuffer<float> buffer (numChannels, numSamples);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample (ch, i, (float) i + (float) ch * 0.5f);
+
+    return buffer;
+}
+
+class SeekCountingSource : public MemoryAudioSource
+{
+public:
+    using MemoryAudioSource::MemoryAudioSource;
+
+    void setNextReadPosition (int64 newPosition) override
+    {
+        ++numSeeks;
+        MemoryAudioSource::setNextReadPosition (newPosition);
+    }
+
+    std::atomic<int> numSeeks { 0 };
+};
+} // namespace
+
+TEST (PrefetchingAudioSourceTests, PlaysSourceInOrder)
+{
+    auto ramp = makeRamp (2, 48000);
+
+    AudioPrefetchScheduler scheduler (2);
+    PrefetchingAudioSource source (new MemoryAudioSource (ramp, true), scheduler, true, 8192);
+    source.prepareToPlay (256, 48000.0);
+
+    EXPECT_EQ (scheduler.getNumStreams(), 1);
+
+    AudioBuffer<float> block (2, 256);
+
+    for (int b = 0; b < 8; ++b)
+    {
+        source.getNextAudioBlock (AudioSourceChannelInfo (block));
+
+        for (int i = 0; i < block.getNumSamples(); ++i)
+        {
+            EXPECT_FLOAT_EQ (block.getSample (0, i), (float) (b * 256 + i));
+            EXPECT_FLOAT_EQ (block.getSample (1, i), (float) (b * 256 + i) + 0.5f);
+        }
+    }
+
+    EXPECT_EQ (source.getNextReadPosition(), 8 * 256);
+    EXPECT_EQ (source.getStatistics().numUnderruns, 0);
+
+    source.releaseResources();
+    EXPECT_EQ (scheduler.getNumStreams(), 0);
+}
+
+TEST (PrefetchingAudioSourceTests, SeekDiscardsStaleData)
+{
+    auto ramp = makeRamp (1, 48000);
+
+    AudioPrefetchScheduler scheduler (1);
+    PrefetchingAudioSource source (new MemoryAudioSource (ramp, true), scheduler, true, 4096, 1);
+    source.prepareToPlay (128, 48000.0);
+
+    source.setNextReadPosition (20000);
+
+    while (source.getStatistics().readAheadSamples < 1024)
+        Thread::sleep (1);
+
+    AudioBuffer<float> block (1, 128);
+    source.getNextAudioBlock (AudioSourceChannelInfo (block));
+
+    for (int i = 0; i < block.getNumSamples(); ++i)
+        EXPECT_FLOAT_EQ (block.getSample (0, i), (float) (20000 + i));
+
+    EXPECT_EQ (source.getNextReadPosition(), 20128);
+}
+
+TEST (PrefetchingAudioSourceTests, UnderrunsAreCounted)
+{
+    auto ramp = makeRamp (1, 48000);
+
+    AudioPrefetchScheduler scheduler (1);
+    PrefetchingAudioSource source (new MemoryAudioSource (ramp, true), scheduler, true, 2048, 1, false);
+    source.prepareToPlay (4096, 48000.0);
+
+    const auto stats = source.getStatistics();
+    EXPECT_GE (stats.capacitySamples, 8192);
+
+    AudioBuffer<float> block (1, 4096 * 4);
+    source.getNextAudioBlock (AudioSourceChannelInfo (block));
+
+    EXPECT_GE (source.getStatistics().numUnderruns, 1);
+
+    source.resetStatistics();
+    EXPECT_EQ (source.getStatistics().numUnderruns, 0);
+}
+
+TEST (PrefetchingAudioSourceTests, LoopingSourcesAreOnlySeekedWhenTheirPositionChanges)
+{
+    auto ramp = makeRamp (1, 1000);
+    auto* looping = new SeekCountingSource (ramp, true, true);
+
+    AudioPrefetchScheduler scheduler (1);
+    PrefetchingAudioSource source (looping, scheduler, true, 4096, 1);
+    source.prepareToPlay (256, 48000.0);
+
+    AudioBuffer<float> block (1, 256);
+
+    for (int b = 0; b < 40; ++b)
+    {
+        // Give the disk thread time to refill the space that the last block freed
+        while (source.getStatistics().readAheadSamples < 2048)
+            Thread::sleep (1);
+
+        source.getNextAudioBlock (AudioSourceChannelInfo (block));
+
+        for (int i = 0; i < block.getNumSamples(); ++i)
+            ASSERT_FLOAT_EQ (block.getSample (0, i), (float) ((b * 256 + i) % 1000));
+    }
+
+    EXPECT_EQ (source.getNextReadPosition(), (40 * 256) % 1000);
+    EXPECT_EQ (source.getStatistics().numUnderruns, 0);
+
+    // Only the first read needed a seek, even though the source has looped ten times
+    EXPECT_EQ (looping->numSeeks.load(), 1);
+}
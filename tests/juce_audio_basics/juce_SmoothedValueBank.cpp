@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+using namespace juce;
+
+TEST (SmoothedValueBankTests, LinearBlockRampMatchesPerSampleValues)
+{
+    SmoothedValue<float> perSample (0.0f), block (0.0f);
+    perSample.reset (100);
+    block.reset (100);
+    perSample.setTargetValue (1.0f);
+    block.setTargetValue (1.0f);
+
+    float ramp[150];
+    block.getNextValues (ramp, 150);
+
+    for (int i = 0; i < 150; ++i)
+        EXPECT_NEAR (ramp[i], perSample.getNextValue(), 1.0e-5f);
+
+    EXPECT_FALSE (block.isSmoothing());
+    EXPECT_EQ (block.getCurrentValue(), 1.0f);
+}
+
+TEST (SmoothedValueBankTests, MultiplicativeBlockRampMatchesPerSampleValues)
+{
+    SmoothedValue<double, ValueSmoothingTypes::Multiplicative> perSample (100.0), block (100.0);
+    perSample.reset (37);
+    block.reset (37);
+    perSample.setTargetValue (1000.0);
+    block.setTargetValue (1000.0);
+
+    double ramp[20];
+
+    for (int blockStart = 0; blockStart < 60; blockStart += 20)
+    {
+        block.getNextValues (ramp, 20);
+
+        for (int i = 0; i < 20; ++i)
+            EXPECT_NEAR (ramp[i], perSample.getNextValue(), 1.0e-9);
+    }
+
+    EXPECT_EQ (block.getCurrentValue(), 1000.0);
+}
+
+TEST (SmoothedValueBankTests, ApplyGainUsesRamp)
+{
+    SmoothedValue<float> gain (0.0f);
+    gain.reset (200);
+    gain.setTargetValue (1.0f);
+
+    AudioBuffer<float> buffer (2, 256);
+
+    for (int ch = 0; ch < 2; ++ch)
+        FloatVectorOperations::fill (buffer.getWritePointer (ch), 1.0f, 256);
+
+    gain.applyGain (buffer, 256);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        EXPECT_NEAR (buffer.getSample (ch, 99), 0.5f, 1.0e-5f);
+        EXPECT_EQ (buffer.getSample (ch, 199), 1.0f);
+        EXPECT_EQ (buffer.getSample (ch, 255), 1.0f);
+    }
+}
+
+TEST (SmoothedValueBankTests, BankMatchesIndividualSmoothedValues)
+{
+    constexpr int numValues = 130;
+
+    SmoothedValueBank<float> bank (numValues);
+    std::vector<SmoothedValue<float>> values (numValues);
+
+    bank.reset (48000.0, 0.01);
+
+    for (auto& value : values)
+        value.reset (48000.0, 0.01);
+
+    for (int i = 0; i < numValues; i += 3)
+    {
+        bank.setTargetValue (i, (float) i);
+        values[(size_t) i].setTargetValue ((float) i);
+    }
+
+    EXPECT_TRUE (bank.isAnySmoothing());
+    EXPECT_TRUE (bank.isSmoothing (3));
+    EXPECT_FALSE (bank.isSmoothing (4));
+
+    for (int block = 0; block < 4; ++block)
+    {
+        bank.skip (128);
+
+        for (int i = 0; i < numValues; ++i)
+            EXPECT_NEAR (bank.getCurrentValue (i), values[(size_t) i].skip (128), 1.0e-3f);
+    }
+
+    EXPECT_FALSE (bank.isAnySmoothing());
+    EXPECT_EQ (bank.getCurrentValues()[129], 129.0f);
+}
+
+TEST (SmoothedValueBankTests, FillRampDoesNotAdvance)
+{
+    SmoothedValueBank<float, ValueSmoothingTypes::Multiplicative> bank (2);
+    bank.reset (64);
+    bank.setTargetValue (1, 4.0f);
+
+    float ramp[64];
+    bank.fillRamp (1, ramp, 64);
+
+    EXPECT_EQ (bank.getCurrentValue (1), 1.0f);
+    EXPECT_NEAR (ramp[31], 2.0f, 1.0e-4f);
+    EXPECT_EQ (ramp[63], 4.0f);
+
+    bank.skip (32);
+    EXPECT_NEAR (bank.getCurrentValue (1), 2.0f, 1.0e-4f);
+    EXPECT_EQ (bank.getCurrentValue (0), 1.0f);
+}
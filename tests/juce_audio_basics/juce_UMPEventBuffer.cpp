@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_basics/midi/juce_MidiDataConcatenator.h>
+#include <juce_audio_basics/midi/ump/juce_UMP.h>
+
+using namespace juce;
+
+namespace
+{
+std::vector<std::pair<int, uint32_t>> getPositionsAndFirstWords (const ump::EventBuffer& buffer)
+{
+    std::vector<std::pair<int, uint32_t>> result;
+
+    for (const auto event : buffer)
+        result.emplace_back (event.samplePosition, event.packet[0]);
+
+    return result;
+}
+
+MidiBuffer createMidiBuffer()
+{
+    MidiBuffer buffer;
+    buffer.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+    buffer.addEvent (MidiMessage::controllerEvent (2, 7, 90), 10);
+    buffer.addEvent (MidiMessage::pitchWheel (3, 12000), 20);
+
+    HeapBlock<uint8> sysexData (20);
+
+    for (int i = 0; i < 20; ++i)
+        sysexData[i] = (uint8) i;
+
+    buffer.addEvent (MidiMessage::createSysExMessage (sysexData, 20), 30);
+    buffer.addEvent (MidiMessage::noteOff (1, 60), 40);
+    return buffer;
+}
+} // namespace
+
+TEST (UMPEventBufferTests, EventsAreKeptInTimeOrder)
+{
+    ump::EventBuffer buffer;
+    buffer.addEvent (ump::Factory::makeNoteOnV1 (0, 0, 1, 100), 10);
+    buffer.addEvent (ump::Factory::makeNoteOnV2 (0, 0, 2, ump::Factory::NoteAttributeKind::none, 0x8000, 0), 30);
+    buffer.addEvent (ump::Factory::makeNoteOnV1 (0, 0, 3, 100), 5);
+    buffer.addEvent (ump::Factory::makeNoteOnV1 (0, 0, 4, 100), 10);
+
+    EXPECT_EQ (buffer.getNumEvents(), 4);
+    EXPECT_EQ (buffer.getNumWords(), (size_t) (4 + 3 + 2));
+    EXPECT_EQ (buffer.getFirstEventTime(), 5);
+    EXPECT_EQ (buffer.getLastEventTime(), 30);
+
+    std::vector<int> positions, notes;
+
+    for (const auto event : buffer)
+    {
+        positions.push_back (event.samplePosition);
+        notes.push_back ((int) ((event.packet[0] >> 8) & 0x7f));
+    }
+
+    EXPECT_EQ (positions, (std::vector<int> { 5, 10, 10, 30 }));
+    EXPECT_EQ (notes, (std::vector<int> { 3, 1, 4, 2 }));
+
+    ump::EventBuffer copy;
+    copy.addEvents (buffer, 10, 15, 100);
+    EXPECT_EQ (copy.getNumEvents(), 2);
+    EXPECT_EQ (copy.getFirstEventTime(), 110);
+}
+
+TEST (UMPEventBufferTests, FixedCapacityDropsEventsInsteadOfGrowing)
+{
+    ump::EventBuffer buffer;
+    buffer.setFixedCapacity (8);
+
+    EXPECT_TRUE (buffer.addEvent (ump::Factory::makeNoteOnV1 (0, 0, 1, 100), 0));
+    EXPECT_TRUE (buffer.addEvent (ump::Factory::makeNoteOnV2 (0, 0, 2, ump::Factory::NoteAttributeKind::none, 0x8000, 0), 1));
+    EXPECT_TRUE (buffer.addEvent (ump::Factory::makeNoteOnV1 (0, 0, 3, 100), 2));
+    EXPECT_FALSE (buffer.addEvent (ump::Factory::makeNoteOnV2 (0, 0, 4, ump::Factory::NoteAttributeKind::none, 0x8000, 0), 3));
+
+    EXPECT_EQ (buffer.getNumEvents(), 3);
+    EXPECT_EQ (buffer.getNumDroppedEvents(), 1);
+
+    buffer.clear();
+    EXPECT_TRUE (buffer.isEmpty());
+    EXPECT_TRUE (buffer.addEvent (ump::Factory::makeNoteOnV2 (0, 0, 4, ump::Factory::NoteAttributeKind::none, 0x8000, 0), 3));
+}
+
+TEST (UMPEventBufferTests, CopiesKeepTheFixedCapacity)
+{
+    ump::EventBuffer buffer;
+    buffer.setFixedCapacity (64);
+    EXPECT_TRUE (buffer.addEvent (ump::Factory::makeNoteOnV1 (0, 0, 1, 100), 0));
+
+    ump::EventBuffer copy (buffer);
+    EXPECT_EQ (copy.getFixedCapacity(), (size_t) 64);
+    EXPECT_GE (copy.getNumWordsAllocated(), (size_t) 64);
+    EXPECT_EQ (copy.getNumEvents(), 1);
+
+    ump::EventBuffer assigned;
+    assigned = buffer;
+    EXPECT_EQ (assigned.getFixedCapacity(), (size_t) 64);
+    EXPECT_GE (assigned.getNumWordsAllocated(), (size_t) 64);
+    EXPECT_EQ (assigned.getNumEvents(), 1);
+
+    ump::EventBuffer moved (std::move (copy));
+    EXPECT_EQ (moved.getFixedCapacity(), (size_t) 64);
+    EXPECT_GE (moved.getNumWordsAllocated(), (size_t) 64);
+    EXPECT_EQ (copy.getFixedCapacity(), (size_t) 0);
+    EXPECT_TRUE (copy.isEmpty());
+}
+
+TEST (UMPEventBufferTests, BulkConversionMatchesPerPacketConversion)
+{
+    const auto midiBuffer = createMidiBuffer();
+
+    // the per-packet path, as used by the devices
+    ump::EventBuffer expected1, expected2;
+    ump::Midi1ToMidi2DefaultTranslator expectedTranslator;
+
+    for (const auto metadata : midiBuffer)
+    {
+        ump::Conversion::toMidi1 (ump::BytestreamMidiView (metadata), [&] (const ump::View& view)
+        {
+            expected1.addEvent (view, metadata.samplePosition);
+            expectedTranslator.dispatch (view, [&] (const ump::View& translated)
+            {
+                expected2.addEvent (translated, metadata.samplePosition);
+            });
+        });
+    }
+
+    ump::EventBuffer midi1, midi2, midi2FromMidi1;
+    ump::Midi1ToMidi2DefaultTranslator translator, otherTranslator;
+
+    ump::BufferConversion::toMidi1 (midiBuffer, midi1);
+    ump::BufferConversion::toMidi2 (midiBuffer, midi2, translator);
+    ump::BufferConversion::midi1ToMidi2 (midi1, midi2FromMidi1, otherTranslator);
+
+    EXPECT_EQ (getPositionsAndFirstWords (midi1), getPositionsAndFirstWords (expected1));
+    EXPECT_EQ (getPositionsAndFirstWords (midi2), getPositionsAndFirstWords (expected2));
+    EXPECT_EQ (getPositionsAndFirstWords (midi2FromMidi1), getPositionsAndFirstWords (expected2));
+
+    // 4 channel messages, and 20 bytes of sysex in 4 packets
+    EXPECT_EQ (midi1.getNumEvents(), 8);
+
+    ump::BytestreamToUMPDispatcher dispatcher (ump::PacketProtocol::MIDI_2_0, 1024);
+    ump::EventBuffer dispatched;
+    dispatcher.dispatch (midiBuffer, dispatched);
+    EXPECT_EQ (getPositionsAndFirstWords (dispatched), getPositionsAndFirstWords (expected2));
+
+    // and back to a MidiBuffer, from either protocol
+    for (auto* source : { &midi1, &midi2 })
+    {
+        ump::EventBuffer downConverted;
+        ump::BufferConversion::midi2ToMidi1 (*source, downConverted);
+        EXPECT_EQ (getPositionsAndFirstWords (downConverted), getPositionsAndFirstWords (midi1));
+
+        MidiBuffer roundTrip;
+        ump::Midi1ToBytestreamTranslator bytestreamTranslator (256);
+        ump::BufferConversion::toMidiBuffer (*source, roundTrip, bytestreamTranslator);
+
+        ASSERT_EQ (roundTrip.getNumEvents(), midiBuffer.getNumEvents());
+
+        for (auto a = roundTrip.cbegin(), b = midiBuffer.cbegin(); a != roundTrip.cend(); ++a, ++b)
+        {
+            const auto original = (*b).getMessage();
+            const auto converted = (*a).getMessage();
+
+            EXPECT_EQ ((*a).samplePosition, (*b).samplePosition);
+
+            // MIDI 1.0 values are scaled up to MIDI 2.0 and back without loss
+            EXPECT_EQ (converted.getRawDataSize(), original.getRawDataSize());
+            EXPECT_EQ (memcmp (converted.getRawData(), original.getRawData(), (size_t) original.getRawDataSize()), 0);
+        }
+    }
+}
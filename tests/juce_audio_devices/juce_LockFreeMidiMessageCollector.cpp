@@ -0,0 +1,174 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <thread>
+
+using namespace juce;
+
+namespace
+{
+MidiMessage noteOnAt (int noteNumber, double timeStamp)
+{
+    auto message = MidiMessage::noteOn (1, noteNumber, (uint8) 100);
+    message.setTimeStamp (timeStamp);
+    return message;
+}
+} // namespace
+
+TEST (LockFreeMidiMessageCollectorTests, MessagesArePlacedAtTheirPositionInThePreviousBlock)
+{
+    LockFreeMidiMessageCollector collector;
+    collector.reset (1000.0);
+
+    MidiBuffer buffer;
+    collector.removeNextBlockOfMessages (buffer, 100, 10.0);
+    EXPECT_TRUE (buffer.isEmpty());
+
+    // the first block covers 10.0 to 10.1 seconds, and is delivered by the callback at 10.1
+    collector.addMessageToQueue (noteOnAt (60, 10.025));
+    collector.addMessageToQueue (noteOnAt (61, 10.05));
+    collector.addMessageToQueue (noteOnAt (62, 10.15)); // after the next callback starts
+
+    collector.removeNextBlockOfMessages (buffer, 100, 10.1);
+    ASSERT_EQ (buffer.getNumEvents(), 2);
+
+    auto iter = buffer.cbegin();
+    EXPECT_EQ ((*iter).samplePosition, 25);
+    EXPECT_EQ ((*iter).getMessage().getNoteNumber(), 60);
+    ++iter;
+    EXPECT_EQ ((*iter).samplePosition, 50);
+
+    buffer.clear();
+    collector.removeNextBlockOfMessages (buffer, 100, 10.2);
+    ASSERT_EQ (buffer.getNumEvents(), 1);
+    EXPECT_EQ ((*buffer.cbegin()).samplePosition, 50);
+    EXPECT_EQ ((*buffer.cbegin()).getMessage().getNoteNumber(), 62);
+}
+
+TEST (LockFreeMidiMessageCollectorTests, CallbackJitterDoesNotMoveMessages)
+{
+    LockFreeMidiMessageCollector collector;
+    collector.reset (48000.0);
+
+    MidiBuffer buffer;
+    const auto period = 480.0 / 48000.0;
+    Random random (1234);
+    Range<int> positions;
+
+    for (int block = 0; block < 500; ++block)
+    {
+        // the callbacks arrive up to half a millisecond late, but the messages are regular
+        const auto blockStart = 100.0 + block * period;
+        collector.addMessageToQueue (noteOnAt (60, blockStart - 0.5 * period));
+
+        buffer.clear();
+        collector.removeNextBlockOfMessages (buffer, 480, blockStart + random.nextDouble() * 0.0005);
+
+        if (block > 300)
+        {
+            ASSERT_EQ (buffer.getNumEvents(), 1);
+            const auto position = (*buffer.cbegin()).samplePosition;
+            positions = block == 301 ? Range<int>::emptyRange (position) : positions.getUnionWith (position);
+        }
+    }
+
+    // the jitter is up to 24 samples, but the messages should move by much less than that
+    EXPECT_NEAR (positions.getStart(), 240, 24);
+    EXPECT_LE (positions.getLength(), 4);
+}
+
+TEST (LockFreeMidiMessageCollectorTests, SysexSpanningSeveralSlotsSurvives)
+{
+    LockFreeMidiMessageCollector collector;
+    collector.reset (44100.0);
+
+    HeapBlock<uint8> sysexData (300);
+
+    for (int i = 0; i < 300; ++i)
+        sysexData[i] = (uint8) (i & 0x7f);
+
+    auto sysex = MidiMessage::createSysExMessage (sysexData, 300);
+    sysex.setTimeStamp (10.001);
+    EXPECT_TRUE (collector.addMessageToQueue (sysex));
+
+    MidiBuffer buffer;
+    collector.removeNextBlockOfMessages (buffer, 256, 10.0058);
+    ASSERT_EQ (buffer.getNumEvents(), 1);
+
+    const auto received = (*buffer.cbegin()).getMessage();
+    ASSERT_TRUE (received.isSysEx());
+    ASSERT_EQ (received.getSysExDataSize(), 300);
+    EXPECT_EQ (memcmp (received.getSysExData(), sysexData, 300), 0);
+}
+
+TEST (LockFreeMidiMessageCollectorTests, ConcurrentProducersLoseNothingUntilFull)
+{
+    LockFreeMidiMessageCollector collector (1 << 20);
+    collector.reset (44100.0);
+
+    constexpr int numThreads = 4, numMessagesPerThread = 2000;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < numThreads; ++t)
+    {
+        threads.emplace_back ([&collector, t]
+        {
+            for (int i = 0; i < numMessagesPerThread; ++i)
+                collector.addMessageToQueue (noteOnAt (t, 1.0));
+        });
+    }
+
+    MidiBuffer buffer;
+    int counts[numThreads] = {};
+    int total = 0;
+
+    for (int block = 0; total < numThreads * numMessagesPerThread && block < 100000; ++block)
+    {
+        buffer.clear();
+        collector.removeNextBlockOfMessages (buffer, 64);
+
+        for (const auto metadata : buffer)
+        {
+            ++counts[metadata.getMessage().getNoteNumber()];
+            ++total;
+        }
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ (collector.getNumDroppedMessages(), 0);
+
+    for (auto count : counts)
+        EXPECT_EQ (count, numMessagesPerThread);
+
+    LockFreeMidiMessageCollector smallCollector (16 * 44);
+    smallCollector.reset (44100.0);
+
+    for (int i = 0; i < 20; ++i)
+        smallCollector.addMessageToQueue (noteOnAt (60, 1.0));
+
+    EXPECT_EQ (smallCollector.getNumDroppedMessages(), 4);
+}
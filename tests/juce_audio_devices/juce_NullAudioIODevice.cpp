@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+using namespace juce;
+
+namespace
+{
+class CountingCallback : public AudioIODeviceCallback
+{
+public:
+    void audioDeviceIOCallbackWithContext (const float* const*, int,
+                                           float* const* outputChannelData, int numOutputChannels,
+                                           int numSamples, const AudioIODeviceCallbackContext& context) override
+    {
+        for (int ch = 0; ch < numOutputChannels; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                outputChannelData[ch][i] = (float) (ch + 1);
+
+        hadHostTime = hadHostTime && context.hostTimeNs != nullptr;
+        ++numCallbacks;
+    }
+
+    void audioDeviceAboutToStart (AudioIODevice* device) override   { blockSize = device->getCurrentBufferSizeSamples(); }
+    void audioDeviceStopped() override                              { stopped = true; }
+
+    std::atomic<int> numCallbacks { 0 };
+    int blockSize = 0;
+    bool hadHostTime = true, stopped = false;
+};
+
+class RampCallback : public AudioIODeviceCallback
+{
+public:
+    void audioDeviceIOCallbackWithContext (const float* const*, int,
+                                           float* const* outputChannelData, int numOutputChannels,
+                                           int numSamples, const AudioIODeviceCallbackContext&) override
+    {
+        for (int i = 0; i < numSamples; ++i)
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+                outputChannelData[ch][i] = (float) (nextValue + i);
+
+        nextValue += numSamples;
+    }
+
+    void audioDeviceAboutToStart (AudioIODevice*) override  {}
+    void audioDeviceStopped() override                      {}
+
+    int nextValue = 0;
+};
+} // namespace
+
+TEST (NullAudioIODeviceTests, OfflineDeviceRendersRequestedLengthToStream)
+{
+    std::unique_ptr<AudioIODeviceType> type (AudioIODeviceType::createAudioIODeviceType_Offline());
+    ASSERT_NE (type, nullptr);
+    EXPECT_EQ (type->getTypeName(), "Offline");
+
+    std::unique_ptr<AudioIODevice> device (type->createDevice (type->getDeviceNames()[0], {}));
+    auto* nullDevice = dynamic_cast<NullAudioIODevice*> (device.get());
+    ASSERT_NE (nullDevice, nullptr);
+    EXPECT_EQ (nullDevice->getTiming(), NullAudioIODevice::Timing::asFastAsPossible);
+
+    EXPECT_TRUE (device->open ({}, BigInteger (3), 48000.0, 256).isEmpty());
+
+    MemoryOutputStream stream;
+    nullDevice->setOutputStream (&stream, false);
+    nullDevice->setLengthToRender (1000);
+
+    CountingCallback callback;
+    device->start (&callback);
+    EXPECT_TRUE (nullDevice->waitUntilFinished (5000));
+
+    EXPECT_EQ (callback.blockSize, 256);
+    EXPECT_EQ (callback.numCallbacks.load(), 4);
+    EXPECT_TRUE (callback.hadHostTime);
+    EXPECT_EQ (nullDevice->getNumSamplesRendered(), 1000);
+    EXPECT_TRUE (device->isPlaying());
+
+    device->stop();
+    EXPECT_TRUE (callback.stopped);
+
+    ASSERT_EQ (stream.getDataSize(), sizeof (float) * 2 * 1000);
+
+    auto* samples = static_cast<const float*> (stream.getData());
+    EXPECT_EQ (samples[0], 1.0f);
+    EXPECT_EQ (samples[1], 2.0f);
+    EXPECT_EQ (samples[1998], 1.0f);
+    EXPECT_EQ (samples[1999], 2.0f);
+}
+
+TEST (NullAudioIODeviceTests, RaisingTheLengthResumesRendering)
+{
+    NullAudioIODevice device ("Offline Device", "Offline", NullAudioIODevice::Timing::asFastAsPossible);
+    device.open ({}, BigInteger (1), 44100.0, 128);
+
+    CountingCallback callback;
+    device.setLengthToRender (0);
+    device.start (&callback);
+    EXPECT_TRUE (device.waitUntilFinished (1000));
+    EXPECT_EQ (callback.numCallbacks.load(), 0);
+
+    device.setLengthToRender (512);
+    EXPECT_TRUE (device.waitUntilFinished (5000));
+    EXPECT_EQ (callback.numCallbacks.load(), 4);
+
+    device.close();
+    EXPECT_FALSE (device.isOpen());
+}
+
+TEST (NullAudioIODeviceTests, PausingPartWayThroughABlockLeavesNoGap)
+{
+    NullAudioIODevice device ("Offline Device", "Offline", NullAudioIODevice::Timing::asFastAsPossible);
+    device.open ({}, BigInteger (1), 44100.0, 256);
+
+    MemoryOutputStream stream;
+    device.setOutputStream (&stream, false);
+
+    RampCallback callback;
+    device.setLengthToRender (1000);
+    device.start (&callback);
+    EXPECT_TRUE (device.waitUntilFinished (5000));
+
+    device.setLengthToRender (2000);
+    EXPECT_TRUE (device.waitUntilFinished (5000));
+    EXPECT_EQ (device.getNumSamplesRendered(), 2000);
+
+    device.stop();
+
+    ASSERT_EQ (stream.getDataSize(), sizeof (float) * 2000);
+
+    auto* samples = static_cast<const float*> (stream.getData());
+
+    for (int i = 0; i < 2000; ++i)
+        ASSERT_EQ (samples[i], (float) i);
+}
+
+TEST (NullAudioIODeviceTests, NullDeviceRunsInRealtime)
+{
+    std::unique_ptr<AudioIODeviceType> type (AudioIODeviceType::createAudioIODeviceType_Null());
+    std::unique_ptr<AudioIODevice> device (type->createDevice ({}, {}));
+    ASSERT_NE (device, nullptr);
+
+    device->open ({}, BigInteger (3), 48000.0, 480);
+    dynamic_cast<NullAudioIODevice&> (*device).setLengthToRender (4800);
+
+    CountingCallback callback;
+    const auto startTime = Time::getMillisecondCounterHiRes();
+    device->start (&callback);
+    EXPECT_TRUE (dynamic_cast<NullAudioIODevice&> (*device).waitUntilFinished (5000));
+
+    // 10 blocks of 10ms, the first of which starts straight away
+    EXPECT_GE (Time::getMillisecondCounterHiRes() - startTime, 80.0);
+    EXPECT_EQ (callback.numCallbacks.load(), 10);
+
+    device->close();
+}
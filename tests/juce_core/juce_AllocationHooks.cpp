@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <thread>
+
+#if JUCE_ENABLE_ALLOCATION_HOOKS
+
+using namespace juce;
+
+namespace
+{
+
+// Stops the compiler from optimising the allocation away
+int* volatile allocationSink = nullptr;
+
+void allocateAndFree()
+{
+    allocationSink = new int[16];
+    delete[] allocationSink;
+}
+
+} // namespace
+
+TEST (AllocationHooksTests, AllocationInsideTheScopeTripsTheTripwire)
+{
+    size_t numAllocations = 0;
+
+    {
+        ScopedAllocationTripwire tripwire;
+        allocateAndFree();
+        numAllocations = tripwire.getNumAllocations();
+    }
+
+    // One call to new and one to delete
+    EXPECT_EQ (numAllocations, (size_t) 2);
+}
+
+TEST (AllocationHooksTests, HeapBlockAllocationsAreCounted)
+{
+    size_t numAllocations = 0;
+
+    {
+        ScopedAllocationTripwire tripwire;
+        HeapBlock<float> block (256);
+        numAllocations = tripwire.getNumAllocations();
+    }
+
+    EXPECT_GT (numAllocations, (size_t) 0);
+}
+
+TEST (AllocationHooksTests, HeapBlockFreesAreCounted)
+{
+    HeapBlock<float> block (256), emptyBlock;
+    size_t numAllocations = 0;
+
+    {
+        ScopedAllocationTripwire tripwire;
+        block.free();
+        emptyBlock.free();
+        numAllocations = tripwire.getNumAllocations();
+    }
+
+    // Freeing an empty block doesn't touch the heap, so isn't counted
+    EXPECT_EQ (numAllocations, (size_t) 1);
+}
+
+TEST (AllocationHooksTests, AllocationOutsideTheScopeIsNotCounted)
+{
+    allocateAndFree();
+
+    size_t numAllocations = 0;
+
+    {
+        ScopedAllocationTripwire tripwire;
+
+        int onTheStack[16] = {};
+        onTheStack[3] = 1;
+        allocationSink = onTheStack;
+
+        numAllocations = tripwire.getNumAllocations();
+    }
+
+    allocateAndFree();
+
+    EXPECT_EQ (numAllocations, (size_t) 0);
+}
+
+TEST (AllocationHooksTests, NestedTripwiresOnlyCountTheirOwnLifetimes)
+{
+    size_t outerCount = 0, innerCount = 0, outerCountBeforeInner = 0;
+
+    {
+        ScopedAllocationTripwire outer;
+        allocateAndFree();
+        outerCountBeforeInner = outer.getNumAllocations();
+
+        {
+            ScopedAllocationTripwire inner;
+            allocateAndFree();
+            innerCount = inner.getNumAllocations();
+        }
+
+        allocateAndFree();
+        outerCount = outer.getNumAllocations();
+    }
+
+    EXPECT_EQ (outerCountBeforeInner, (size_t) 2);
+    EXPECT_EQ (innerCount, (size_t) 2);
+    EXPECT_EQ (outerCount, (size_t) 6);
+}
+
+TEST (AllocationHooksTests, AllocationsOnOtherThreadsAreNotCounted)
+{
+    std::atomic<int> step { 0 };
+    size_t otherThreadCount = 0;
+
+    // The thread is started before the tripwire, because starting it allocates
+    std::thread other ([&]
+    {
+        while (step.load() != 1)
+            std::this_thread::yield();
+
+        {
+            ScopedAllocationTripwire tripwire;
+            allocateAndFree();
+            otherThreadCount = tripwire.getNumAllocations();
+        }
+
+        step = 2;
+    });
+
+    size_t thisThreadCount = 0;
+
+    {
+        ScopedAllocationTripwire tripwire;
+        step = 1;
+
+        while (step.load() != 2)
+            std::this_thread::yield();
+
+        thisThreadCount = tripwire.getNumAllocations();
+    }
+
+    other.join();
+
+    EXPECT_EQ (thisThreadCount, (size_t) 0);
+    EXPECT_EQ (otherThreadCount, (size_t) 2);
+}
+
+#endif
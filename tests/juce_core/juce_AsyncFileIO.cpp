@@ -0,0 +1,389 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+MemoryBlock createTestData (size_t numBytes)
+{
+    MemoryBlock data (numBytes);
+    Random random (4321);
+    random.fillBitsRandomly (data.getData(), data.getSize());
+    return data;
+}
+
+File createTestFile (const TemporaryFile& temp, const MemoryBlock& data)
+{
+    auto file = temp.getFile();
+    EXPECT_TRUE (file.replaceWithData (data.getData(), data.getSize()));
+    return file;
+}
+
+bool matches (const MemoryBlock& data, size_t offset, const void* bytes, size_t numBytes)
+{
+    return offset + numBytes <= data.getSize()
+        && memcmp (addBytesToPointer (data.getData(), offset), bytes, numBytes) == 0;
+}
+
+class AsyncFileIOTests : public ::testing::TestWithParam<bool>
+{
+protected:
+    AsyncFileIOOptions getOptions() const
+    {
+        return AsyncFileIOOptions{}.withIOUringEnabled (GetParam());
+    }
+};
+} // namespace
+
+TEST_P (AsyncFileIOTests, BatchedReadsCallTheirCallbacks)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (100000);
+    AsyncFile file (createTestFile (temp, data), AsyncFile::readOnly);
+    ASSERT_TRUE (file.openedOk());
+
+    AsyncFileIO io (getOptions());
+
+    if (! GetParam())
+    {
+        EXPECT_FALSE (io.isUsingIOUring());
+    }
+
+    constexpr int numReads = 20;
+    constexpr size_t readSize = 6000;
+    std::vector<MemoryBlock> buffers (numReads, MemoryBlock (readSize));
+    std::vector<size_t> numBytesRead (numReads, 0);
+    std::atomic<int> numSucceeded { 0 };
+
+    for (int i = 0; i < numReads; ++i)
+    {
+        io.read (file, (int64) i * 5003, buffers[(size_t) i].getData(), readSize, [&, i] (const Result& result, size_t numBytes)
+        {
+            numBytesRead[(size_t) i] = numBytes;
+
+            if (result.wasOk())
+                ++numSucceeded;
+        });
+    }
+
+    EXPECT_EQ (io.getNumPending(), numReads);
+    EXPECT_EQ (io.submit(), numReads);
+    EXPECT_TRUE (io.waitForAll());
+    EXPECT_EQ (io.getNumPending(), 0);
+    EXPECT_EQ (numSucceeded.load(), numReads);
+
+    for (int i = 0; i < numReads; ++i)
+    {
+        const auto position = (size_t) i * 5003;
+        const auto expectedSize = jmin (readSize, data.getSize() - position);
+
+        EXPECT_EQ (numBytesRead[(size_t) i], expectedSize);
+        EXPECT_TRUE (matches (data, position, buffers[(size_t) i].getData(), expectedSize));
+    }
+}
+
+TEST_P (AsyncFileIOTests, WritesCanBeReadBack)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (64 * 1024);
+
+    {
+        AsyncFile file (temp.getFile(), AsyncFile::readWrite);
+        ASSERT_TRUE (file.openedOk());
+
+        AsyncFileIO io (getOptions());
+        std::atomic<int> numFailed { 0 };
+
+        // Written back to front, so that the file has to grow into holes
+        for (int i = 15; i >= 0; --i)
+        {
+            io.write (file, (int64) i * 4096, addBytesToPointer (data.getData(), i * 4096), 4096, [&] (const Result& result, size_t numBytes)
+            {
+                if (result.failed() || numBytes != 4096)
+                    ++numFailed;
+            });
+        }
+
+        io.submit();
+        io.waitForAll();
+        EXPECT_EQ (numFailed.load(), 0);
+        EXPECT_EQ (file.getSize(), (int64) data.getSize());
+        EXPECT_TRUE (file.flush().wasOk());
+    }
+
+    MemoryBlock written;
+    EXPECT_TRUE (temp.getFile().loadFileAsData (written));
+    EXPECT_EQ (written, data);
+}
+
+TEST_P (AsyncFileIOTests, QueueingMoreThanTheQueueDepthSubmitsAndWaits)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (50000);
+    AsyncFile file (createTestFile (temp, data), AsyncFile::readOnly);
+
+    AsyncFileIO io (getOptions().withQueueDepth (2));
+    std::vector<MemoryBlock> buffers (25, MemoryBlock (2000));
+    std::atomic<int> numFinished { 0 };
+
+    for (int i = 0; i < 25; ++i)
+        io.read (file, i * 2000, buffers[(size_t) i].getData(), 2000, [&] (const Result&, size_t) { ++numFinished; });
+
+    EXPECT_LE (io.getNumPending(), 2);
+    io.waitForAll();
+    EXPECT_EQ (numFinished.load(), 25);
+
+    for (int i = 0; i < 25; ++i)
+        EXPECT_TRUE (matches (data, (size_t) i * 2000, buffers[(size_t) i].getData(), 2000));
+}
+
+TEST_P (AsyncFileIOTests, CallbacksCanQueueMoreTransfers)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (40000);
+    AsyncFile file (createTestFile (temp, data), AsyncFile::readOnly);
+
+    AsyncFileIO io (getOptions());
+    MemoryBlock result (data.getSize() + 3000, true);
+    std::function<void (int64)> readChunk;
+
+    readChunk = [&] (int64 position)
+    {
+        io.read (file, position, addBytesToPointer (result.getData(), position), 3000, [&, position] (const Result& r, size_t numBytes)
+        {
+            if (r.wasOk() && numBytes == 3000)
+            {
+                readChunk (position + 3000);
+                io.submit();
+            }
+        });
+    };
+
+    readChunk (0);
+
+    // Each read queues the next before it finishes, so this waits for the whole chain
+    EXPECT_TRUE (io.waitForAll (5000));
+    EXPECT_TRUE (matches (result, 0, data.getData(), data.getSize()));
+}
+
+TEST_P (AsyncFileIOTests, CallbacksCanChainTransfersAtQueueDepthOne)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (40000);
+    AsyncFile file (createTestFile (temp, data), AsyncFile::readOnly);
+
+    // With one place in the queue and one thread, nothing else can free a place for the next read
+    AsyncFileIO io (getOptions().withQueueDepth (1).withNumberOfThreads (1));
+    MemoryBlock result (data.getSize() + 1000, true);
+    std::function<void (int64)> readChunk;
+
+    readChunk = [&] (int64 position)
+    {
+        io.read (file, position, addBytesToPointer (result.getData(), position), 1000, [&, position] (const Result& r, size_t numBytes)
+        {
+            if (r.wasOk() && numBytes == 1000)
+            {
+                readChunk (position + 1000);
+                io.submit();
+            }
+        });
+    };
+
+    readChunk (0);
+
+    EXPECT_TRUE (io.waitForAll (5000));
+    EXPECT_EQ (io.getNumPending(), 0);
+    EXPECT_TRUE (matches (result, 0, data.getData(), data.getSize()));
+}
+
+TEST_P (AsyncFileIOTests, BypassingTheCacheRoundTrips)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (5 * AsyncFile::alignment);
+
+    AsyncFile file (temp.getFile(), AsyncFile::readWrite, true);
+    ASSERT_TRUE (file.openedOk());
+
+    // Not every file system can do this, in which case the file has been opened normally
+    AsyncFile::AlignedBuffer buffer (data.getSize());
+    EXPECT_EQ (buffer.getSize(), data.getSize());
+    EXPECT_TRUE (AsyncFile::isAligned (0, buffer.getData(), buffer.getSize()));
+    memcpy (buffer.getData(), data.getData(), data.getSize());
+
+    AsyncFileIO io (getOptions());
+    Result writeResult = Result::fail ("not called");
+    io.write (file, 0, buffer.getData(), buffer.getSize(), [&] (const Result& r, size_t) { writeResult = r; });
+    io.waitForAll();
+    EXPECT_TRUE (writeResult.wasOk()) << writeResult.getErrorMessage();
+
+    EXPECT_TRUE (file.setSize ((int64) data.getSize() - 100).wasOk());
+
+    // Reading a whole block at the end of the file gives the part that's there
+    AsyncFile::AlignedBuffer readBuffer (data.getSize());
+    zeromem (readBuffer.getData(), readBuffer.getSize());
+    size_t numBytesRead = 0;
+    io.read (file, 0, readBuffer.getData(), readBuffer.getSize(), [&] (const Result&, size_t n) { numBytesRead = n; });
+    io.waitForAll();
+
+    EXPECT_EQ (numBytesRead, data.getSize() - 100);
+    EXPECT_TRUE (matches (data, 0, readBuffer.getData(), numBytesRead));
+}
+
+TEST_P (AsyncFileIOTests, FailuresAreReported)
+{
+    AsyncFile missing (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("missing", ".dat"),
+                       AsyncFile::readOnly);
+    EXPECT_FALSE (missing.openedOk());
+
+    AsyncFileIO io (getOptions());
+    char buffer[16];
+    Result readResult = Result::ok();
+    io.read (missing, 0, buffer, sizeof (buffer), [&] (const Result& r, size_t) { readResult = r; });
+    io.waitForAll();
+    EXPECT_TRUE (readResult.failed());
+
+    // Reading past the end of a file isn't an error, it just doesn't read anything
+    TemporaryFile temp;
+    AsyncFile readOnly (createTestFile (temp, createTestData (100)), AsyncFile::readOnly);
+    size_t numBytesRead = 1;
+    Result badRead = Result::ok();
+    io.read (readOnly, 1000, buffer, sizeof (buffer), [&] (const Result& r, size_t n) { badRead = r; numBytesRead = n; });
+    io.waitForAll();
+    EXPECT_TRUE (badRead.wasOk());
+    EXPECT_EQ (numBytesRead, 0u);
+}
+
+INSTANTIATE_TEST_SUITE_P (AsyncFileIO, AsyncFileIOTests, ::testing::Bool(),
+                          [] (const auto& info) { return info.param ? "IOUring" : "ThreadPool"; });
+
+//==============================================================================
+TEST (AsyncFileStreamTests, InputStreamReadsAndSeeks)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (200000);
+    const auto file = createTestFile (temp, data);
+
+    for (auto bypassCache : { false, true })
+    {
+        AsyncFileIO io;
+        AsyncFileInputStream in (file, &io, bypassCache, 8192, 3);
+        ASSERT_TRUE (in.openedOk());
+        EXPECT_EQ (in.getTotalLength(), (int64) data.getSize());
+
+        MemoryOutputStream out;
+        char chunk[3001];
+
+        while (! in.isExhausted())
+        {
+            const auto numRead = in.read (chunk, (int) sizeof (chunk));
+            ASSERT_GT (numRead, 0);
+            out.write (chunk, (size_t) numRead);
+        }
+
+        EXPECT_EQ (out.getMemoryBlock(), data);
+        EXPECT_EQ (in.read (chunk, (int) sizeof (chunk)), 0);
+
+        Random random (99);
+
+        for (int i = 0; i < 50; ++i)
+        {
+            const auto position = random.nextInt ((int) data.getSize());
+            EXPECT_TRUE (in.setPosition (position));
+            EXPECT_EQ (in.getPosition(), position);
+
+            const auto numRead = in.read (chunk, (int) sizeof (chunk));
+            EXPECT_EQ (numRead, jmin ((int) sizeof (chunk), (int) data.getSize() - position));
+            EXPECT_TRUE (matches (data, (size_t) position, chunk, (size_t) numRead));
+        }
+    }
+
+    AsyncFileInputStream missing (temp.getFile().getSiblingFile ("doesNotExist"));
+    EXPECT_TRUE (missing.failedToOpen());
+    char buffer[16];
+    EXPECT_EQ (missing.read (buffer, (int) sizeof (buffer)), 0);
+}
+
+TEST (AsyncFileStreamTests, OutputStreamWritesAndReplacesTheFile)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (100000);
+    ASSERT_TRUE (temp.getFile().replaceWithText ("old content that should disappear"));
+
+    for (auto bypassCache : { false, true })
+    {
+        {
+            AsyncFileOutputStream out (temp.getFile(), nullptr, bypassCache, 8192, 3);
+            ASSERT_TRUE (out.openedOk());
+
+            for (size_t pos = 0; pos < data.getSize();)
+            {
+                const auto numBytes = jmin ((size_t) 7001, data.getSize() - pos);
+                EXPECT_TRUE (out.write (addBytesToPointer (data.getData(), pos), numBytes));
+                pos += numBytes;
+
+                if (pos == 7001 * 5)
+                {
+                    out.flush();
+                    EXPECT_TRUE (out.getStatus().wasOk());
+                    EXPECT_EQ (temp.getFile().getSize(), (int64) pos);
+                }
+            }
+
+            EXPECT_EQ (out.getPosition(), (int64) data.getSize());
+        }
+
+        MemoryBlock written;
+        EXPECT_TRUE (temp.getFile().loadFileAsData (written));
+        EXPECT_EQ (written, data);
+    }
+}
+
+TEST (AsyncFileStreamTests, OutputStreamCanGoBackToRewriteAHeader)
+{
+    TemporaryFile temp;
+    const auto data = createTestData (50000);
+
+    {
+        AsyncFileOutputStream out (temp.getFile(), nullptr, false, 4096, 2);
+        EXPECT_TRUE (out.writeInt (0));
+        EXPECT_TRUE (out.write (data.getData(), data.getSize()));
+        EXPECT_TRUE (out.setPosition (0));
+        EXPECT_TRUE (out.writeInt ((int) data.getSize()));
+        EXPECT_TRUE (out.setPosition (4 + (int64) data.getSize()));
+        EXPECT_TRUE (out.writeInt (-1));
+        out.flush();
+        EXPECT_TRUE (out.getStatus().wasOk());
+    }
+
+    FileInputStream in (temp.getFile());
+    EXPECT_EQ (in.getTotalLength(), 8 + (int64) data.getSize());
+    EXPECT_EQ (in.readInt(), (int) data.getSize());
+
+    MemoryBlock body;
+    in.readIntoMemoryBlock (body, (ssize_t) data.getSize());
+    EXPECT_EQ (body, data);
+    EXPECT_EQ (in.readInt(), -1);
+}
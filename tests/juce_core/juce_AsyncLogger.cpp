@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+#include <thread>
+
+using namespace juce;
+
+namespace
+{
+const auto untimedOptions = AsyncLoggerOptions().withTimestamps (false);
+
+StringArray readLines (const File& file)
+{
+    StringArray lines;
+    file.readLines (lines);
+    lines.removeEmptyStrings();
+    return lines;
+}
+} // namespace
+
+TEST (AsyncLoggerTests, WritesMessagesInOrder)
+{
+    TemporaryFile tempFile (".log");
+
+    {
+        AsyncLogger logger (tempFile.getFile(), untimedOptions);
+
+        for (int i = 0; i < 100; ++i)
+            logger.logMessage ("message " + String (i));
+    }
+
+    auto lines = readLines (tempFile.getFile());
+    ASSERT_EQ (lines.size(), 100);
+
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ (lines[i], "message " + String (i));
+}
+
+TEST (AsyncLoggerTests, FormatsRealtimeArgumentsLater)
+{
+    TemporaryFile tempFile (".log");
+    AsyncLogger logger (tempFile.getFile(), untimedOptions);
+
+    char transient[] = "copied";
+    EXPECT_TRUE (logger.logRealtime ("ints {} {} {}", 42, -7, (uint64) 18446744073709551615ull));
+    EXPECT_TRUE (logger.logRealtime ("mixed {}, {}, {}, {}", 0.5, true, 'x', transient));
+    EXPECT_TRUE (logger.logRealtime ("strings {} {} {}", String ("juce"), std::string ("std"), std::string_view ("view")));
+    EXPECT_TRUE (logger.logRealtime ("missing {} {}", 1));
+    EXPECT_TRUE (logger.logRealtime ("plain text {"));
+    transient[0] = 'X';
+
+    logger.flush();
+
+    auto lines = readLines (tempFile.getFile());
+    ASSERT_EQ (lines.size(), 5);
+    EXPECT_EQ (lines[0], "ints 42 -7 18446744073709551615");
+    EXPECT_EQ (lines[1], "mixed 0.5, true, x, copied");
+    EXPECT_EQ (lines[2], "strings juce std view");
+    EXPECT_EQ (lines[3], "missing 1 {}");
+    EXPECT_EQ (lines[4], "plain text {");
+}
+
+TEST (AsyncLoggerTests, TimestampsPrefixEachLine)
+{
+    TemporaryFile tempFile (".log");
+
+    {
+        AsyncLogger logger (tempFile.getFile());
+        logger.logMessage ("hello");
+    }
+
+    auto lines = readLines (tempFile.getFile());
+    ASSERT_EQ (lines.size(), 1);
+
+    // e.g. "2024-01-31 12:34:56.789 hello"
+    EXPECT_TRUE (lines[0].endsWith (" hello"));
+    EXPECT_EQ (lines[0].indexOfChar ('.'), 19);
+    EXPECT_TRUE (lines[0].startsWith (Time::getCurrentTime().formatted ("%Y-")));
+}
+
+TEST (AsyncLoggerTests, MessagesFromManyThreadsAreAllWritten)
+{
+    TemporaryFile tempFile (".log");
+    constexpr int numThreads = 6, numMessages = 2000;
+
+    {
+        // Fewer buffers than threads, so some of them have to share
+        AsyncLogger logger (tempFile.getFile(), untimedOptions.withMaxNumThreads (4)
+                                                              .withBufferSizeBytesPerThread (4096)
+                                                              .withFlushIntervalMilliseconds (5));
+
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back ([&logger, t]
+            {
+                for (int i = 0; i < numMessages; ++i)
+                    logger.logMessage (String (t) + " " + String (i));
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    auto lines = readLines (tempFile.getFile());
+    ASSERT_EQ (lines.size(), numThreads * numMessages);
+
+    std::vector<int> nextExpected (numThreads, 0);
+
+    for (auto& line : lines)
+    {
+        auto thread = line.upToFirstOccurrenceOf (" ", false, false).getIntValue();
+        auto index = line.fromFirstOccurrenceOf (" ", false, false).getIntValue();
+        ASSERT_TRUE (isPositiveAndBelow (thread, numThreads));
+        EXPECT_EQ (index, nextExpected[(size_t) thread]++);
+    }
+}
+
+TEST (AsyncLoggerTests, RealtimeMessagesAreDroppedWhenFull)
+{
+    TemporaryFile tempFile (".log");
+    AsyncLogger logger (tempFile.getFile(), untimedOptions.withBufferSizeBytesPerThread (1024)
+                                                          .withFlushIntervalMilliseconds (60000));
+
+    int numWritten = 0;
+
+    for (int i = 0; i < 100; ++i)
+        numWritten += logger.logRealtime ("value {}", i) ? 1 : 0;
+
+    EXPECT_GT (numWritten, 0);
+    EXPECT_LT (numWritten, 100);
+    EXPECT_EQ (logger.getNumDroppedMessages(), 100 - numWritten);
+
+    logger.flush();
+    EXPECT_TRUE (logger.logRealtime ("after flush"));
+    logger.flush();
+
+    auto lines = readLines (tempFile.getFile());
+    ASSERT_EQ (lines.size(), numWritten + 2);
+    EXPECT_EQ (lines[numWritten], "AsyncLogger: " + String (100 - numWritten) + " messages were dropped");
+    EXPECT_EQ (lines[numWritten + 1], "after flush");
+
+    // A message that could never fit into the buffer is still written by logMessage
+    logger.logMessage (String::repeatedString ("x", 5000));
+    logger.flush();
+    EXPECT_EQ (readLines (tempFile.getFile())[numWritten + 2].length(), 5000);
+}
+
+TEST (AsyncLoggerTests, LargeMessagesAreWrittenAfterTheBufferHasWrapped)
+{
+    TemporaryFile tempFile (".log");
+
+    {
+        AsyncLogger logger (tempFile.getFile(), untimedOptions);
+
+        // Moves the write position, so that a big message would need padding before the wrap point
+        for (int i = 0; i < 64; ++i)
+            logger.logMessage (String::repeatedString ("a", 100));
+
+        logger.logMessage (String::repeatedString ("b", 9000));
+        logger.logMessage ("done");
+    }
+
+    auto lines = readLines (tempFile.getFile());
+    ASSERT_EQ (lines.size(), 66);
+    EXPECT_EQ (lines[64], String::repeatedString ("b", 9000));
+    EXPECT_EQ (lines[65], "done");
+}
+
+TEST (AsyncLoggerTests, RotatesFiles)
+{
+    TemporaryFile tempFile (".log");
+    auto options = untimedOptions.withMaxFileSizeBytes (1000).withMaxNumBackupFiles (2);
+
+    {
+        AsyncLogger logger (tempFile.getFile(), options);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            logger.logMessage (String::formatted ("line %03d", i) + String::repeatedString (".", 40));
+            logger.flush();
+        }
+
+        EXPECT_TRUE (logger.getBackupFile (1).existsAsFile());
+        EXPECT_TRUE (logger.getBackupFile (2).existsAsFile());
+        EXPECT_FALSE (logger.getBackupFile (3).existsAsFile());
+        EXPECT_EQ (logger.getBackupFile (1).getFileName(),
+                   tempFile.getFile().getFileNameWithoutExtension() + ".1.log");
+    }
+
+    AsyncLogger logger (tempFile.getFile(), options);
+    auto current = readLines (tempFile.getFile());
+    auto previous = readLines (logger.getBackupFile (1));
+
+    EXPECT_LE (tempFile.getFile().getSize(), 1000);
+    EXPECT_LE (logger.getBackupFile (1).getSize(), 1000);
+    EXPECT_TRUE (current[current.size() - 1].startsWith ("line 099"));
+    EXPECT_EQ (previous[previous.size() - 1].substring (5, 8).getIntValue() + 1,
+               current[0].substring (5, 8).getIntValue());
+
+    logger.getBackupFile (1).deleteFile();
+    logger.getBackupFile (2).deleteFile();
+}
+
+TEST (AsyncLoggerTests, BuffersAreReusedAfterThreadsExit)
+{
+    TemporaryFile tempFile (".log");
+    AsyncLogger logger (tempFile.getFile(), untimedOptions.withMaxNumThreads (1)
+                                                          .withBufferSizeBytesPerThread (1024)
+                                                          .withFlushIntervalMilliseconds (60000));
+
+    auto fillBuffer = [&logger]
+    {
+        int numWritten = 0;
+
+        while (logger.logRealtime ("0123456789"))
+            ++numWritten;
+
+        return numWritten;
+    };
+
+    // The only buffer is claimed by a thread that exits, and given back once it's been written out
+    std::thread ([&] { logger.prepareCurrentThread(); logger.logRealtime ("first"); }).join();
+    logger.flush();
+
+    // If that worked, this thread gets that buffer and the next one gets the shared buffer,
+    // otherwise they'd both be sharing, and the second one would find it already full
+    EXPECT_GT (fillBuffer(), 0);
+
+    int numWrittenByOtherThread = 0;
+    std::thread ([&] { numWrittenByOtherThread = fillBuffer(); }).join();
+    EXPECT_GT (numWrittenByOtherThread, 0);
+}
@@ -0,0 +1,292 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+var createTestValue()
+{
+    auto* preset = new DynamicObject();
+    preset->setProperty ("name", String::fromUTF8 ("Lead \xe2\x9c\x93"));
+    preset->setProperty ("gain", 0.75);
+    preset->setProperty ("voices", 8);
+    preset->setProperty ("seed", (int64) 0x123456789abcLL);
+    preset->setProperty ("enabled", true);
+    preset->setProperty ("missing", var());
+    preset->setProperty ("notSet", var::undefined());
+
+    const char bytes[] = { 1, 2, 3, 0, 5 };
+    preset->setProperty ("blob", var (bytes, sizeof (bytes)));
+
+    Array<var> presets;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto* item = new DynamicObject();
+        item->setProperty ("name", "Preset " + String (i));
+        item->setProperty ("index", i);
+        presets.add (item);
+    }
+
+    auto* root = new DynamicObject();
+    root->setProperty ("version", 2);
+    root->setProperty ("current", preset);
+    root->setProperty ("presets", presets);
+    root->setProperty ("empty", Array<var>());
+
+    return root;
+}
+
+// Builds a document by hand in which each array contains the previous one
+MemoryBlock createNestedArrays (int depth)
+{
+    MemoryOutputStream out;
+    out.writeRepeatedByte (0, 32);
+
+    auto innerOffset = (int64) out.getPosition();
+    out.writeInt (0);
+    out.writeInt (0);
+
+    for (int i = 1; i < depth; ++i)
+    {
+        const auto offset = (int64) out.getPosition();
+        out.writeInt (1);
+        out.writeInt (0);
+        out.writeInt (8);
+        out.writeInt (0);
+        out.writeInt64 (innerOffset);
+        innerOffset = offset;
+    }
+
+    const auto keyTableOffset = (int) out.getPosition();
+    out.writeInt (0);
+
+    out.setPosition (0);
+    out.write ("YVAR", 4);
+    out.writeInt (1);
+    out.writeInt (keyTableOffset);
+    out.writeInt (0);
+    out.writeInt (8);
+    out.writeInt (0);
+    out.writeInt64 (innerOffset);
+    out.flush();
+
+    return out.getMemoryBlock();
+}
+
+int getNestingDepth (const var& value)
+{
+    if (auto* array = value.getArray(); array != nullptr && ! array->isEmpty())
+        return 1 + getNestingDepth (array->getFirst());
+
+    return value.isArray() ? 1 : 0;
+}
+} // namespace
+
+TEST (BinaryVarTests, RoundTripsThroughVar)
+{
+    const auto value = createTestValue();
+    BinaryVarDocument document (BinaryVarDocument::toMemoryBlock (value));
+
+    ASSERT_TRUE (document.isValid());
+
+    const auto decoded = document.getRoot().toVar();
+    EXPECT_EQ (JSON::toString (decoded), JSON::toString (value));
+
+    auto* blob = decoded["current"]["blob"].getBinaryData();
+    ASSERT_NE (blob, nullptr);
+    EXPECT_EQ (*blob, *value["current"]["blob"].getBinaryData());
+    EXPECT_TRUE (decoded["current"]["seed"].isInt64());
+    EXPECT_TRUE (decoded["current"]["notSet"].isUndefined());
+}
+
+TEST (BinaryVarTests, RandomAccessWithoutDecoding)
+{
+    const auto block = BinaryVarDocument::toMemoryBlock (createTestValue());
+    BinaryVarDocument document (block.getData(), block.getSize());
+    const auto root = document.getRoot();
+
+    ASSERT_TRUE (root.isObject());
+    EXPECT_EQ (root.size(), 4);
+    EXPECT_EQ (root.getPropertyName (0), "version");
+    EXPECT_EQ (root.getPropertyName (3), "empty");
+    EXPECT_EQ (root["version"].toInt(), 2);
+
+    const auto current = root["current"];
+    EXPECT_EQ (current["name"].getString(), "Lead \xe2\x9c\x93");
+    EXPECT_EQ (current["name"].toString(), String::fromUTF8 ("Lead \xe2\x9c\x93"));
+    EXPECT_DOUBLE_EQ (current["gain"].toDouble(), 0.75);
+    EXPECT_EQ (current["voices"].toInt(), 8);
+    EXPECT_EQ (current["seed"].toInt64(), (int64) 0x123456789abcLL);
+    EXPECT_TRUE (current["enabled"].toBool());
+    EXPECT_TRUE (current["missing"].isVoid());
+    EXPECT_TRUE (current["notSet"].isUndefined());
+    EXPECT_EQ (current["blob"].getBinaryDataSize(), 5u);
+    EXPECT_EQ (static_cast<const char*> (current["blob"].getBinaryData())[4], 5);
+
+    // Strings point straight into the document
+    const auto name = current["name"].getString();
+    EXPECT_GE (name.data(), static_cast<const char*> (block.getData()));
+    EXPECT_LT (name.data(), static_cast<const char*> (block.getData()) + block.getSize());
+
+    const auto presets = root[Identifier ("presets")];
+    ASSERT_TRUE (presets.isArray());
+    EXPECT_EQ (presets.size(), 3);
+    EXPECT_EQ (presets[2]["name"].getString(), "Preset 2");
+    EXPECT_EQ (presets[1]["index"].toInt(), 1);
+    EXPECT_TRUE (root["empty"].isArray());
+    EXPECT_EQ (root["empty"].size(), 0);
+
+    EXPECT_TRUE (root["nonexistent"].isVoid());
+    EXPECT_FALSE (root.hasProperty ("nonexistent"));
+    EXPECT_TRUE (root.hasProperty ("presets"));
+    EXPECT_TRUE (presets[3].isVoid());
+    EXPECT_TRUE (presets[-1].isVoid());
+    EXPECT_TRUE (presets["name"].isVoid());
+    EXPECT_EQ (root["version"].size(), 0);
+}
+
+TEST (BinaryVarTests, FindsPropertiesOfLargeObjects)
+{
+    auto* object = new DynamicObject();
+    var value (object);
+    Random random (1234);
+
+    for (int i = 0; i < 500; ++i)
+        object->setProperty ("key" + String (random.nextInt (100000)) + "_" + String (i), i);
+
+    BinaryVarDocument document (BinaryVarDocument::toMemoryBlock (value));
+    const auto root = document.getRoot();
+    ASSERT_EQ (root.size(), object->getProperties().size());
+
+    for (auto& property : object->getProperties())
+    {
+        const auto& name = property.name.toString();
+        EXPECT_EQ (root[name.toRawUTF8()].toInt(), (int) property.value);
+    }
+}
+
+TEST (BinaryVarTests, ScalarRootsAndFiles)
+{
+    for (const auto& value : { var(), var (42), var (-1.5), var (false), var ("text"), var ((int64) -7) })
+    {
+        BinaryVarDocument document (BinaryVarDocument::toMemoryBlock (value));
+        ASSERT_TRUE (document.isValid());
+        EXPECT_TRUE (document.getRoot().toVar().equalsWithSameType (value));
+    }
+
+    TemporaryFile tempFile;
+
+    {
+        FileOutputStream out (tempFile.getFile());
+        ASSERT_TRUE (BinaryVarDocument::writeToStream (createTestValue(), out));
+    }
+
+    BinaryVarDocument document (tempFile.getFile());
+    ASSERT_TRUE (document.isValid());
+    EXPECT_EQ (document.getRoot()["presets"][0]["name"].getString(), "Preset 0");
+}
+
+TEST (BinaryVarTests, RejectsDamagedData)
+{
+    EXPECT_FALSE (BinaryVarDocument (nullptr, 0).isValid());
+    EXPECT_FALSE (BinaryVarDocument ("not a binary var document", 26).isValid());
+
+    const auto block = BinaryVarDocument::toMemoryBlock (createTestValue());
+
+    // Truncated documents and random damage must never read outside the data
+    for (size_t size = 0; size < block.getSize(); size += 7)
+    {
+        BinaryVarDocument document (block.getData(), size);
+        document.getRoot().toVar();
+    }
+
+    Random random (42);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto damaged = block;
+
+        for (int j = 0; j < 4; ++j)
+            damaged[random.nextInt ((int) damaged.getSize())] = (char) random.nextInt (256);
+
+        BinaryVarDocument document (damaged.getData(), damaged.getSize());
+        const auto root = document.getRoot();
+        root.toVar();
+        root["current"]["name"].toString();
+        root["presets"][1]["index"].toInt();
+    }
+}
+
+TEST (BinaryVarTests, RejectsContainersThatContainThemselves)
+{
+    Array<var> inner;
+    inner.add (1);
+    Array<var> outer;
+    outer.add (inner);
+
+    auto block = BinaryVarDocument::toMemoryBlock (outer);
+    const auto outerOffset = ByteOrder::littleEndianInt64 (addBytesToPointer (block.getData(), 24));
+
+    // Point the outer array's first item back at the outer array itself
+    auto* itemPayload = addBytesToPointer (block.getData(), (size_t) outerOffset + 8 + 8);
+    const auto selfReference = ByteOrder::swapIfBigEndian ((uint64) outerOffset);
+    std::memcpy (itemPayload, &selfReference, sizeof (selfReference));
+
+    BinaryVarDocument document (block.getData(), block.getSize());
+    ASSERT_TRUE (document.isValid());
+
+    const auto root = document.getRoot();
+    EXPECT_TRUE (root.isArray());
+    EXPECT_EQ (root.size(), 1);
+    EXPECT_TRUE (root[0].isVoid());
+    EXPECT_EQ (root[0].size(), 0);
+
+    const auto decoded = root.toVar();
+    ASSERT_TRUE (decoded.isArray());
+    EXPECT_TRUE (decoded[0].isVoid());
+}
+
+TEST (BinaryVarTests, LimitsTheNestingDepth)
+{
+    const auto deep = createNestedArrays (100000);
+    BinaryVarDocument document (deep.getData(), deep.getSize());
+    ASSERT_TRUE (document.isValid());
+    EXPECT_EQ (getNestingDepth (document.getRoot().toVar()), 512);
+
+    const auto shallow = createNestedArrays (512);
+    BinaryVarDocument shallowDocument (shallow.getData(), shallow.getSize());
+    const auto decoded = shallowDocument.getRoot().toVar();
+    EXPECT_EQ (getNestingDepth (decoded), 512);
+
+    MemoryOutputStream out;
+    EXPECT_TRUE (BinaryVarDocument::writeToStream (decoded, out));
+
+    Array<var> tooDeep;
+    tooDeep.add (decoded);
+    MemoryOutputStream tooDeepOut;
+    EXPECT_FALSE (BinaryVarDocument::writeToStream (tooDeep, tooDeepOut));
+}
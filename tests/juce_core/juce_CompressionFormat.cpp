@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+const String testText = String::repeatedString ("Some text that will be compressed. ", 100);
+
+template <typename CompressorType>
+MemoryBlock compress (const String& text, int windowBits = 0, const MemoryBlock& dictionary = {})
+{
+    MemoryOutputStream out;
+
+    {
+        std::unique_ptr<CompressorType> compressor;
+
+        if constexpr (std::is_same_v<CompressorType, GZIPCompressorOutputStream>)
+            compressor = std::make_unique<CompressorType> (out, 9, windowBits);
+        else
+            compressor = std::make_unique<CompressorType> (out);
+
+        if (! dictionary.isEmpty())
+            compressor->setDictionary (dictionary.getData(), dictionary.getSize());
+
+        compressor->writeString (text);
+    }
+
+    return out.getMemoryBlock();
+}
+} // namespace
+
+TEST (CompressionFormatTests, DetectsEachFormat)
+{
+    auto detect = [] (const MemoryBlock& data)
+    {
+        MemoryInputStream in (data, false);
+        auto format = CompressionFormat::detectFormat (in);
+        EXPECT_EQ (in.getPosition(), 0);
+        return format;
+    };
+
+    EXPECT_EQ (detect (compress<GZIPCompressorOutputStream> (testText)), CompressionFormat::zlib);
+    EXPECT_EQ (detect (compress<GZIPCompressorOutputStream> (testText, GZIPCompressorOutputStream::windowBitsGZIP)), CompressionFormat::gzip);
+    EXPECT_EQ (detect (compress<LZ4CompressorOutputStream> (testText)), CompressionFormat::lz4);
+    EXPECT_EQ (detect (compress<ZstdCompressorOutputStream> (testText)), CompressionFormat::zstd);
+    EXPECT_EQ (detect (MemoryBlock (testText.toRawUTF8(), 100)), CompressionFormat::unknown);
+    EXPECT_EQ (detect (MemoryBlock()), CompressionFormat::unknown);
+}
+
+TEST (CompressionFormatTests, LooksPastSkippableFrames)
+{
+    MemoryOutputStream out;
+    out.writeInt (0x184D2A50);
+    out.writeInt (3);
+    out.write ("abc", 3);
+    out << compress<ZstdCompressorOutputStream> (testText);
+
+    MemoryInputStream in (out.getData(), out.getDataSize(), false);
+    EXPECT_EQ (CompressionFormat::detectFormat (in), CompressionFormat::zstd);
+    EXPECT_EQ (in.getPosition(), 0);
+
+    auto stream = CompressionFormat::createDecompressorFor (&in, false);
+    ASSERT_NE (stream, nullptr);
+    EXPECT_EQ (stream->readString(), testText);
+}
+
+TEST (CompressionFormatTests, CreatesTheRightDecompressor)
+{
+    for (auto data : { compress<GZIPCompressorOutputStream> (testText),
+                       compress<GZIPCompressorOutputStream> (testText, GZIPCompressorOutputStream::windowBitsGZIP),
+                       compress<LZ4CompressorOutputStream> (testText),
+                       compress<ZstdCompressorOutputStream> (testText) })
+    {
+        auto stream = CompressionFormat::createDecompressorFor (new MemoryInputStream (data, true), true);
+        ASSERT_NE (stream, nullptr);
+        EXPECT_EQ (stream->readString(), testText);
+    }
+
+    MemoryInputStream plain (testText.toRawUTF8(), testText.getNumBytesAsUTF8(), false);
+    EXPECT_EQ (CompressionFormat::createDecompressorFor (&plain, false), nullptr);
+    EXPECT_EQ (plain.getPosition(), 0);
+}
+
+TEST (CompressionFormatTests, DictionariesArePassedOn)
+{
+    const MemoryBlock dictionary (testText.toRawUTF8(), testText.getNumBytesAsUTF8());
+    const String payload ("Some text that will be compressed. Or maybe some text that won't.");
+
+    for (auto data : { compress<GZIPCompressorOutputStream> (payload, 0, dictionary),
+                       compress<LZ4CompressorOutputStream> (payload, 0, dictionary),
+                       compress<ZstdCompressorOutputStream> (payload, 0, dictionary) })
+    {
+        auto stream = CompressionFormat::createDecompressorFor (new MemoryInputStream (data, true), true, dictionary);
+        ASSERT_NE (stream, nullptr);
+        EXPECT_EQ (stream->readString(), payload);
+
+        auto withoutDictionary = CompressionFormat::createDecompressorFor (new MemoryInputStream (data, true), true);
+        ASSERT_NE (withoutDictionary, nullptr);
+        EXPECT_NE (withoutDictionary->readString(), payload);
+    }
+}
+
+TEST (CompressionFormatTests, GZIPDictionaryWorksWithRawDeflate)
+{
+    const MemoryBlock dictionary (testText.toRawUTF8(), testText.getNumBytesAsUTF8());
+    const String payload ("Some text that will be compressed, again.");
+
+    auto withDictionary = compress<GZIPCompressorOutputStream> (payload, GZIPCompressorOutputStream::windowBitsRaw, dictionary);
+    auto withoutDictionary = compress<GZIPCompressorOutputStream> (payload, GZIPCompressorOutputStream::windowBitsRaw);
+    EXPECT_LT (withDictionary.getSize(), withoutDictionary.getSize());
+
+    MemoryInputStream in (withDictionary, false);
+    GZIPDecompressorInputStream decompressor (&in, false, GZIPDecompressorInputStream::deflateFormat);
+    decompressor.setDictionary (dictionary.getData(), dictionary.getSize());
+    EXPECT_EQ (decompressor.readString(), payload);
+}
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace juce;
+
+TEST (FlatHashMapTests, BasicOperations)
+{
+    FlatHashMap<int, String> map;
+    EXPECT_TRUE (map.isEmpty());
+    EXPECT_EQ (map[1], String());
+    EXPECT_FALSE (map.contains (1));
+
+    map.set (1, "one");
+    map.set (2, "two");
+    map.set (1, "uno");
+
+    EXPECT_EQ (map.size(), 2);
+    EXPECT_EQ (map[1], "uno");
+    EXPECT_EQ (map[2], "two");
+    EXPECT_TRUE (map.containsValue ("two"));
+    EXPECT_FALSE (map.containsValue ("one"));
+
+    ASSERT_NE (map.getValuePointer (2), nullptr);
+    *map.getValuePointer (2) = "dos";
+    EXPECT_EQ (map[2], "dos");
+    EXPECT_EQ (map.getValuePointer (3), nullptr);
+
+    map.getReference (3) += "tres";
+    EXPECT_EQ (map[3], "tres");
+
+    EXPECT_TRUE (map.remove (1));
+    EXPECT_FALSE (map.remove (1));
+    EXPECT_EQ (map.size(), 2);
+
+    map.set (4, "dos");
+    map.removeValue ("dos");
+    EXPECT_EQ (map.size(), 1);
+    EXPECT_TRUE (map.contains (3));
+
+    map.clear();
+    EXPECT_TRUE (map.isEmpty());
+    EXPECT_FALSE (map.contains (3));
+}
+
+TEST (FlatHashMapTests, MatchesStandardMapUnderRandomOperations)
+{
+    FlatHashMap<int64, int> map;
+    std::unordered_map<int64, int> reference;
+    Random random (1234);
+
+    for (int i = 0; i < 200000; ++i)
+    {
+        // A small key range gives plenty of collisions, updates and tombstones
+        const auto key = (int64) random.nextInt (5000) * 4096;
+        const auto operation = random.nextInt (10);
+
+        if (operation < 5)
+        {
+            map.set (key, i);
+            reference[key] = i;
+        }
+        else if (operation < 8)
+        {
+            EXPECT_EQ (map.remove (key), reference.erase (key) > 0);
+        }
+        else
+        {
+            const auto found = reference.find (key);
+            ASSERT_EQ (map.contains (key), found != reference.end());
+
+            if (found != reference.end())
+            {
+                EXPECT_EQ (map[key], found->second);
+            }
+        }
+
+        ASSERT_EQ ((size_t) map.size(), reference.size());
+    }
+
+    size_t numIterated = 0;
+
+    for (auto i = map.begin(); i != map.end(); ++i)
+    {
+        EXPECT_EQ (reference.at (i.getKey()), i.getValue());
+        ++numIterated;
+    }
+
+    EXPECT_EQ (numIterated, reference.size());
+}
+
+TEST (FlatHashMapTests, CopiesMovesAndReserves)
+{
+    FlatHashMap<String, std::unique_ptr<int>> owning;
+    owning.getReference ("a") = std::make_unique<int> (1);
+    auto moved = std::move (owning);
+    EXPECT_EQ (*moved.getReference ("a"), 1);
+
+    FlatHashMap<String, int> map;
+    map.ensureStorageAllocated (1000);
+    const auto capacity = map.getCapacity();
+    EXPECT_GE (capacity, 1000);
+
+    for (int i = 0; i < 1000; ++i)
+        map.set ("key" + String (i), i);
+
+    EXPECT_EQ (map.getCapacity(), capacity);
+
+    auto copy = map;
+    map.clear();
+    EXPECT_EQ (copy.size(), 1000);
+    EXPECT_EQ (copy["key123"], 123);
+
+    int total = 0;
+
+    for (auto value : static_cast<const FlatHashMap<String, int>&> (copy))
+        total += value;
+
+    EXPECT_EQ (total, 999 * 1000 / 2);
+
+    map.swapWith (copy);
+    EXPECT_EQ (map.size(), 1000);
+    EXPECT_TRUE (copy.isEmpty());
+}
+
+TEST (FlatHashMapTests, IdentifierKeys)
+{
+    FlatHashMap<Identifier, var> properties;
+    properties.set ("gain", 0.5);
+    properties.set (Identifier ("pan"), -1);
+
+    EXPECT_EQ ((double) properties["gain"], 0.5);
+    EXPECT_EQ ((int) properties[Identifier (String ("p") + "an")], -1);
+    EXPECT_FALSE (properties.contains ("width"));
+}
+
+TEST (FlatHashSetTests, BasicOperations)
+{
+    FlatHashSet<String> set { "a", "b", "c" };
+    EXPECT_EQ (set.size(), 3);
+    EXPECT_TRUE (set.contains ("b"));
+    EXPECT_FALSE (set.add ("b"));
+    EXPECT_TRUE (set.add ("d"));
+    EXPECT_TRUE (set.remove ("a"));
+    EXPECT_FALSE (set.remove ("a"));
+    EXPECT_FALSE (set.contains ("a"));
+
+    StringArray keys;
+
+    for (auto& key : set)
+        keys.add (key);
+
+    keys.sort (false);
+    EXPECT_EQ (keys.joinIntoString (","), "b,c,d");
+}
+
+TEST (FlatHashSetTests, MatchesStandardSetUnderRandomOperations)
+{
+    FlatHashSet<void*> set;
+    std::unordered_set<void*> reference;
+    Random random (42);
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        auto* key = reinterpret_cast<void*> ((pointer_sized_uint) random.nextInt (3000) * 64);
+
+        if (random.nextBool())
+            EXPECT_EQ (set.add (key), reference.insert (key).second);
+        else
+            EXPECT_EQ (set.remove (key), reference.erase (key) > 0);
+
+        ASSERT_EQ ((size_t) set.size(), reference.size());
+    }
+
+    for (auto* key : reference)
+        EXPECT_TRUE (set.contains (key));
+}
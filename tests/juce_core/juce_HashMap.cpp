@@ -395,3 +395,14 @@ TEST_F (HashMapTests, PersistentMemoryLocationOfValues)
         }
     }
 }
+
+TEST_F (HashMapTests, IdentifierHashesAreSpreadOverSmallTables)
+{
+    std::set<int> slotsUsed;
+
+    for (int i = 0; i < 64; ++i)
+        slotsUsed.insert (juce::DefaultHashFunctions::generateHash (juce::Identifier ("param" + juce::String (i)), 16));
+
+    // Pooled names all have aligned addresses, which mustn't all end up in the same slot
+    EXPECT_GE (slotsUsed.size(), 12u);
+}
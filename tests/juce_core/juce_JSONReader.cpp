@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+using Token = JSONReader::Token;
+
+const char* const testDocument = R"({
+    "name": "Lead \"synth\"",
+    "escapes": "tab\there\nline \u00e9 \ud83d\ude00 \/",
+    "levels": [ 0.5, -1.25e-3, 42, -9223372036854775807, 1e300 ],
+    "flags": { "on": true, "off": false, "none": null, "empty": {}, "list": [] }
+})";
+
+std::vector<Token> readAllTokens (JSONReader& reader)
+{
+    std::vector<Token> tokens;
+
+    for (;;)
+    {
+        tokens.push_back (reader.next());
+
+        if (tokens.back() == Token::endOfInput || tokens.back() == Token::error)
+            return tokens;
+    }
+}
+} // namespace
+
+TEST (JSONReaderTests, ReadsTokensAndValues)
+{
+    JSONReader reader (testDocument, std::strlen (testDocument));
+
+    EXPECT_EQ (reader.next(), Token::beginObject);
+    EXPECT_EQ (reader.getDepth(), 1);
+
+    EXPECT_EQ (reader.next(), Token::propertyName);
+    EXPECT_EQ (reader.getString(), "name");
+    EXPECT_EQ (reader.next(), Token::string);
+    EXPECT_EQ (reader.getString(), "Lead \"synth\"");
+
+    EXPECT_EQ (reader.next(), Token::propertyName);
+    EXPECT_EQ (reader.next(), Token::string);
+    EXPECT_EQ (String::fromUTF8 (reader.getString().data(), (int) reader.getString().size()),
+               String (CharPointer_UTF8 ("tab\there\nline \xc3\xa9 \xf0\x9f\x98\x80 /")));
+
+    EXPECT_EQ (reader.next(), Token::propertyName);
+    EXPECT_EQ (reader.getString(), "levels");
+    EXPECT_EQ (reader.next(), Token::beginArray);
+    EXPECT_EQ (reader.getDepth(), 2);
+
+    EXPECT_EQ (reader.next(), Token::number);
+    EXPECT_FALSE (reader.isInteger());
+    EXPECT_DOUBLE_EQ (reader.getDouble(), 0.5);
+
+    EXPECT_EQ (reader.next(), Token::number);
+    EXPECT_DOUBLE_EQ (reader.getDouble(), -1.25e-3);
+
+    EXPECT_EQ (reader.next(), Token::number);
+    EXPECT_TRUE (reader.isInteger());
+    EXPECT_EQ (reader.getInt64(), 42);
+
+    EXPECT_EQ (reader.next(), Token::number);
+    EXPECT_TRUE (reader.isInteger());
+    EXPECT_EQ (reader.getInt64(), -std::numeric_limits<int64>::max());
+
+    EXPECT_EQ (reader.next(), Token::number);
+    EXPECT_FALSE (reader.isInteger());
+    EXPECT_DOUBLE_EQ (reader.getDouble(), 1e300);
+    EXPECT_EQ (reader.getInt64(), std::numeric_limits<int64>::max());
+
+    EXPECT_EQ (reader.next(), Token::endArray);
+    EXPECT_EQ (reader.getDepth(), 1);
+
+    EXPECT_EQ (reader.next(), Token::propertyName);
+    EXPECT_EQ (reader.next(), Token::beginObject);
+    reader.skipValue();
+    EXPECT_EQ (reader.getCurrentToken(), Token::endObject);
+
+    EXPECT_EQ (reader.next(), Token::endObject);
+    EXPECT_EQ (reader.getDepth(), 0);
+    EXPECT_EQ (reader.next(), Token::endOfInput);
+    EXPECT_TRUE (reader.getError().wasOk());
+
+    // integers that don't fit into an int64 are read as doubles
+    const char* limits = "[-9223372036854775808, 18446744073709551616, -9223372036854775809]";
+    JSONReader overflow (limits, std::strlen (limits));
+    overflow.next();
+    EXPECT_EQ (overflow.next(), Token::number);
+    EXPECT_TRUE (overflow.isInteger());
+    EXPECT_EQ (overflow.getInt64(), std::numeric_limits<int64>::min());
+    EXPECT_EQ (overflow.next(), Token::number);
+    EXPECT_FALSE (overflow.isInteger());
+    EXPECT_DOUBLE_EQ (overflow.getDouble(), 18446744073709551616.0);
+    EXPECT_EQ (overflow.next(), Token::number);
+    EXPECT_FALSE (overflow.isInteger());
+    EXPECT_EQ (overflow.getInt64(), std::numeric_limits<int64>::min());
+}
+
+TEST (JSONReaderTests, ReadValueMatchesParse)
+{
+    JSONReader reader (testDocument, std::strlen (testDocument));
+    reader.next();
+
+    const auto value = reader.readValue();
+    EXPECT_TRUE (reader.getError().wasOk());
+    EXPECT_EQ (JSON::toString (value), JSON::toString (JSON::parse (testDocument)));
+    EXPECT_TRUE (value["levels"][2].isInt());
+    EXPECT_TRUE (value["levels"][3].isInt64());
+}
+
+TEST (JSONReaderTests, StreamedTokensCanSpanBufferRefills)
+{
+    String document ("[");
+
+    for (int i = 0; i < 200; ++i)
+        document << (i > 0 ? ",\n  " : "") << "{ \"item" << i << "\": [\"" << String::repeatedString ("ab\\\"", i) << "\", " << i * 1000003 << ", true, null] }";
+
+    document << "]";
+
+    const auto expected = JSON::toString (JSON::parse (document), true);
+
+    MemoryInputStream stream (document.toRawUTF8(), document.getNumBytesAsUTF8(), false);
+    JSONReader reader (stream, 16);
+
+    reader.next();
+    EXPECT_EQ (JSON::toString (reader.readValue(), true), expected);
+    EXPECT_EQ (reader.next(), Token::endOfInput);
+    EXPECT_TRUE (reader.getError().wasOk());
+}
+
+TEST (JSONReaderTests, ReadsConsecutiveTopLevelValues)
+{
+    const char* lines = "\xef\xbb\xbf{\"a\":1}\n{\"a\":2}\n\"text\"\n3\n";
+    JSONReader reader (lines, std::strlen (lines));
+
+    std::vector<String> values;
+
+    while (reader.next() != Token::endOfInput && reader.getCurrentToken() != Token::error)
+        values.push_back (JSON::toString (reader.readValue(), true));
+
+    EXPECT_EQ (values, (std::vector<String> { "{\"a\": 1}", "{\"a\": 2}", "\"text\"", "3" }));
+    EXPECT_TRUE (reader.getError().wasOk());
+}
+
+TEST (JSONReaderTests, ReportsErrorPositions)
+{
+    const auto getError = [] (const char* text)
+    {
+        JSONReader reader (text, std::strlen (text));
+        const auto tokens = readAllTokens (reader);
+        EXPECT_EQ (tokens.back(), Token::error);
+        EXPECT_EQ (reader.next(), Token::error);
+        return reader.getError().getErrorMessage();
+    };
+
+    EXPECT_EQ (getError ("{\n  \"a\": 1,\n  \"b\" 2 }"), "3:7: error: Expected ':'");
+    EXPECT_EQ (getError ("[1, 2"), "1:6: error: Unexpected end of input");
+    EXPECT_EQ (getError ("[1 2]"), "1:4: error: Expected ',' or ']'");
+    EXPECT_EQ (getError ("{ 1: 2 }"), "1:3: error: Expected a property name in double-quotes");
+    EXPECT_EQ (getError ("[01]"), "1:3: error: Syntax error in number");
+    EXPECT_EQ (getError ("[1.]"), "1:2: error: Syntax error in number");
+    EXPECT_EQ (getError ("[tru]"), "1:2: error: Syntax error");
+    EXPECT_EQ (getError ("\"abc"), "1:5: error: Unexpected end of input in string");
+    EXPECT_EQ (getError ("\"\\u12x4\""), "1:2: error: Syntax error in unicode escape sequence");
+
+    // the line numbers are still right once the start of the input has been discarded
+    const String text = String::repeatedString ("[ 1,\n", 100) + "[ }";
+    MemoryInputStream stream (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+    JSONReader reader (stream, 16);
+    readAllTokens (reader);
+    EXPECT_EQ (reader.getError().getErrorMessage(), "101:3: error: Syntax error");
+}
+
+TEST (JSONReaderTests, ReadsFiles)
+{
+    TemporaryFile temp (".json");
+    ASSERT_TRUE (temp.getFile().replaceWithText (testDocument));
+
+    JSONReader reader (temp.getFile());
+    reader.next();
+    EXPECT_EQ (JSON::toString (reader.readValue()), JSON::toString (JSON::parse (testDocument)));
+
+    JSONReader missing (temp.getFile().getSiblingFile ("missing.json"));
+    EXPECT_EQ (missing.next(), Token::error);
+    EXPECT_TRUE (missing.getError().failed());
+}
+
+TEST (JSONReaderTests, ParsesStringViewsWithoutNullTerminators)
+{
+    const std::string text (testDocument);
+    EXPECT_EQ (JSON::toString (JSON::parseUTF8 (text)), JSON::toString (JSON::parse (testDocument)));
+
+    // Only the part of the buffer that's in the view should be read
+    const std::string buffer = R"([1, 2, 3]garbage, "with no terminator")";
+    var result;
+    EXPECT_TRUE (JSON::parseUTF8 (std::string_view (buffer.data(), 9), result).wasOk());
+    EXPECT_EQ (JSON::toString (result, true), "[1, 2, 3]");
+
+    const std::string truncated = "{ \"a\": [1, 2";
+    EXPECT_TRUE (JSON::parseUTF8 (std::string_view (truncated.data(), truncated.size()), result).failed());
+    EXPECT_TRUE (result.isVoid());
+
+    EXPECT_TRUE (JSON::parseUTF8 ({}, result).wasOk());
+    EXPECT_TRUE (result.isVoid());
+
+    const auto notAContainer = JSON::parseUTF8 ("\n  42", result);
+    EXPECT_EQ (notAContainer.getErrorMessage(), "2:3: error: Expected '{' or '['");
+    EXPECT_EQ (JSON::parse ("\n  42", result).getErrorMessage(), notAContainer.getErrorMessage());
+}
@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+const JSON::Spacing allSpacings[] = { JSON::Spacing::none, JSON::Spacing::singleLine, JSON::Spacing::multiLine };
+
+var createTestValue()
+{
+    auto* nested = new DynamicObject();
+    nested->setProperty ("empty object", new DynamicObject());
+    nested->setProperty ("empty array", Array<var>());
+    nested->setProperty ("nothing", var());
+
+    Array<var> numbers { 0, -1, (int64) 1 << 40, 0.5, 1.0e-7, 123456789.25, -3.0,
+                         std::numeric_limits<double>::infinity() };
+
+    auto* object = new DynamicObject();
+    object->setProperty ("name", "Quote \" backslash \\ tab \t bell \a");
+    object->setProperty ("unicode", String (CharPointer_UTF8 ("caf\xc3\xa9 \xf0\x9f\x98\x80 \x7f")));
+    object->setProperty ("numbers", numbers);
+    object->setProperty ("flags", Array<var> { true, false, Array<var> { Array<var>() } });
+    object->setProperty ("nested", nested);
+
+    return object;
+}
+
+String writeWithWriter (const var& value, const JSON::FormatOptions& format)
+{
+    MemoryOutputStream out;
+
+    {
+        JSONWriter writer (out, format);
+        writer.writeValue (value);
+    }
+
+    return out.toString();
+}
+} // namespace
+
+TEST (JSONWriterTests, WriteValueMatchesJSONToString)
+{
+    const auto value = createTestValue();
+
+    for (auto spacing : allSpacings)
+    {
+        for (auto indent : { 0, 3 })
+        {
+            const auto format = JSON::FormatOptions{}.withSpacing (spacing).withIndentLevel (indent).withMaxDecimalPlaces (6);
+            EXPECT_EQ (writeWithWriter (value, format), JSON::toString (value, format));
+        }
+
+        for (const auto& item : { var (1.5), var ("text"), var (Array<var>()), var (new DynamicObject()) })
+            EXPECT_EQ (writeWithWriter (item, JSON::FormatOptions{}.withSpacing (spacing)),
+                       JSON::toString (item, JSON::FormatOptions{}.withSpacing (spacing)));
+    }
+}
+
+TEST (JSONWriterTests, WritesValuesOneAtATime)
+{
+    MemoryOutputStream out;
+
+    {
+        JSONWriter writer (out, JSON::FormatOptions{}.withSpacing (JSON::Spacing::none));
+
+        writer.beginObject();
+        writer.writeName ("levels");
+        writer.beginArray();
+
+        for (int i = 0; i < 3; ++i)
+            writer.writeDouble (i * 0.25);
+
+        writer.writeDouble (std::nan (""));
+        writer.endArray();
+
+        writer.writeName ("count");
+        writer.writeInt (std::numeric_limits<int64>::min());
+        writer.writeName ("na\"me");
+        writer.writeString (std::string_view ("abc\0def", 3));
+        writer.writeName ("ok");
+        writer.writeBool (true);
+        writer.writeName ("none");
+        writer.writeNull();
+        writer.endObject();
+    }
+
+    EXPECT_EQ (out.toString(), "{\"levels\":[0.0,0.25,0.5,null],\"count\":-9223372036854775808,\"na\\\"me\":\"abc\",\"ok\":true,\"none\":null}");
+}
+
+TEST (JSONWriterTests, LargeOutputRoundTrips)
+{
+    Array<var> items;
+
+    for (int i = 0; i < 5000; ++i)
+        items.add (String::repeatedString ("x", i % 100) + String (i));
+
+    MemoryOutputStream out;
+
+    {
+        JSONWriter writer (out);
+        writer.writeValue (items);
+        writer.writeValue (String::repeatedString ("long string ", 1000));
+    }
+
+    MemoryInputStream in (out.getData(), out.getDataSize(), false);
+    JSONReader reader (in, 256);
+
+    reader.next();
+    EXPECT_EQ (JSON::toString (reader.readValue()), JSON::toString (items));
+    reader.next();
+    EXPECT_EQ (reader.readValue(), var (String::repeatedString ("long string ", 1000)));
+    EXPECT_EQ (reader.next(), JSONReader::Token::endOfInput);
+}
+
+TEST (JSONWriterTests, WritingNumbersDoesNotAllocate)
+{
+    const double values[] = { 0.0, -3.0, 0.5, 1.0 / 3.0, -123.456, 99999.875, 1.0e-7, 2.5e12, -6.02e23,
+                              std::numeric_limits<double>::infinity() };
+
+    MemoryOutputStream out;
+    out.preallocate (8192);
+
+    {
+        JSONWriter writer (out, JSON::FormatOptions{}.withSpacing (JSON::Spacing::none));
+
+        ScopedAllocationTripwire tripwire;
+
+        writer.beginArray();
+
+        for (auto value : values)
+            writer.writeDouble (value);
+
+        writer.writeInt (-42);
+        writer.endArray();
+        writer.flush();
+
+        EXPECT_EQ (tripwire.getNumAllocations(), 0);
+    }
+
+    Array<var> expected;
+
+    for (auto value : values)
+        expected.add (value);
+
+    expected.add (-42);
+
+    EXPECT_EQ (out.toString(), JSON::toString (expected, JSON::FormatOptions{}.withSpacing (JSON::Spacing::none)));
+}
@@ -0,0 +1,336 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+MemoryBlock createTestData (size_t numBytes)
+{
+    MemoryOutputStream out;
+    Random random (1234);
+
+    while (out.getDataSize() < numBytes)
+        out << "<param id=\"" << random.nextInt (100) << "\" value=\"" << random.nextInt (1000) << "\"/>\n";
+
+    return MemoryBlock (out.getData(), numBytes);
+}
+
+MemoryBlock compress (const MemoryBlock& data, int level, const MemoryBlock& dictionary = {})
+{
+    MemoryOutputStream out;
+
+    {
+        LZ4CompressorOutputStream compressor (out, level);
+
+        if (! dictionary.isEmpty())
+            compressor.setDictionary (dictionary.getData(), dictionary.getSize());
+
+        // Uneven writes, so that they don't line up with the blocks
+        for (size_t pos = 0; pos < data.getSize();)
+        {
+            auto numBytes = jmin ((size_t) 7919, data.getSize() - pos);
+            EXPECT_TRUE (compressor.write (addBytesToPointer (data.getData(), pos), numBytes));
+            pos += numBytes;
+        }
+    }
+
+    return out.getMemoryBlock();
+}
+
+MemoryBlock decompress (const MemoryBlock& compressed, const MemoryBlock& dictionary = {})
+{
+    MemoryInputStream in (compressed, false);
+    LZ4DecompressorInputStream decompressor (in);
+
+    if (! dictionary.isEmpty())
+        decompressor.setDictionary (dictionary.getData(), dictionary.getSize());
+
+    MemoryOutputStream out;
+    out.writeFromInputStream (decompressor, -1);
+    EXPECT_TRUE (decompressor.isExhausted());
+    return out.getMemoryBlock();
+}
+
+uint32 rotateLeft (uint32 value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+/** xxHash32 of fewer than 16 bytes, which is all that a frame header needs. */
+uint32 hashShortInput (const uint8* data, size_t numBytes)
+{
+    constexpr uint32 prime1 = 2654435761u, prime2 = 2246822519u, prime3 = 3266489917u,
+                     prime4 = 668265263u,  prime5 = 374761393u;
+
+    auto hash = prime5 + (uint32) numBytes;
+    size_t i = 0;
+
+    for (; i + 4 <= numBytes; i += 4)
+        hash = rotateLeft (hash + ByteOrder::littleEndianInt (data + i) * prime3, 17) * prime4;
+
+    for (; i < numBytes; ++i)
+        hash = rotateLeft (hash + data[i] * prime5, 11) * prime1;
+
+    hash ^= hash >> 15;
+    hash *= prime2;
+    hash ^= hash >> 13;
+    hash *= prime3;
+    return hash ^ (hash >> 16);
+}
+
+/** Writes a frame that records its content size, as the lz4 command line tool does, with
+    the data stored in uncompressed blocks.
+*/
+MemoryBlock createFrameWithContentSize (const MemoryBlock& data)
+{
+    MemoryOutputStream out;
+    out.writeInt ((int) 0x184D2204);
+
+    uint8 descriptor[10] = { 0x48, 0x40 };
+    const auto size = (uint64) data.getSize();
+
+    for (int i = 0; i < 8; ++i)
+        descriptor[2 + i] = (uint8) (size >> (8 * i));
+
+    out.write (descriptor, sizeof (descriptor));
+    out.writeByte ((char) (hashShortInput (descriptor, sizeof (descriptor)) >> 8));
+
+    for (size_t pos = 0; pos < data.getSize();)
+    {
+        auto numBytes = jmin ((size_t) 65536, data.getSize() - pos);
+        out.writeInt ((int) (0x80000000u | (uint32) numBytes));
+        out.write (addBytesToPointer (data.getData(), pos), numBytes);
+        pos += numBytes;
+    }
+
+    out.writeInt (0);
+    return out.getMemoryBlock();
+}
+} // namespace
+
+TEST (LZ4CompressorOutputStreamTests, RoundTripsAtEveryLevel)
+{
+    const auto data = createTestData (300000);
+    size_t previousSize = data.getSize() + 1024;
+
+    for (int level = 0; level <= 9; ++level)
+    {
+        auto compressed = compress (data, level);
+        EXPECT_EQ (decompress (compressed), data) << "level " << level;
+
+        // Each level compresses better than the one before
+        EXPECT_LT (compressed.getSize(), previousSize) << "level " << level;
+        previousSize = compressed.getSize();
+    }
+}
+
+TEST (LZ4CompressorOutputStreamTests, HandlesAllSizesOfInput)
+{
+    for (auto size : { 0, 1, 12, 13, 65535, 65536, 65537, 200000 })
+    {
+        const auto data = createTestData ((size_t) size);
+        EXPECT_EQ (decompress (compress (data, 1)), data) << "size " << size;
+        EXPECT_EQ (decompress (compress (data, 9)), data) << "size " << size;
+    }
+
+    // Data that doesn't compress is stored as it is
+    MemoryBlock noise (100000);
+    Random (42).fillBitsRandomly (noise.getData(), noise.getSize());
+
+    auto compressed = compress (noise, 1);
+    EXPECT_EQ (decompress (compressed), noise);
+    EXPECT_LT (compressed.getSize(), noise.getSize() + 64);
+}
+
+TEST (LZ4CompressorOutputStreamTests, DictionaryImprovesSmallPayloads)
+{
+    const auto dictionary = createTestData (32768);
+    MemoryBlock payload (addBytesToPointer (createTestData (100000).getData(), 50000), 1000);
+
+    auto withoutDictionary = compress (payload, 1);
+    auto withDictionary = compress (payload, 1, dictionary);
+
+    EXPECT_LT (withDictionary.getSize(), withoutDictionary.getSize());
+    EXPECT_EQ (decompress (withDictionary, dictionary), payload);
+
+    // Without the dictionary, the data can't be read
+    EXPECT_NE (decompress (withDictionary), payload);
+}
+
+TEST (LZ4CompressorOutputStreamTests, WritesTheFrameFormat)
+{
+    auto compressed = compress (createTestData (1000), 1);
+    auto* bytes = static_cast<const uint8*> (compressed.getData());
+
+    // The magic number, followed by the flags for version 1 with a content checksum, and 64KB blocks
+    ASSERT_GT (compressed.getSize(), 7u);
+    EXPECT_EQ (ByteOrder::littleEndianInt (bytes), 0x184D2204u);
+    EXPECT_EQ (bytes[4], 0x44);
+    EXPECT_EQ (bytes[5], 0x40);
+
+    // ..and ends with an empty block and the checksum
+    EXPECT_EQ (ByteOrder::littleEndianInt (bytes + compressed.getSize() - 8), 0u);
+}
+
+TEST (LZ4DecompressorInputStreamTests, ReadsConcatenatedFrames)
+{
+    const auto first = createTestData (5000);
+    const auto second = createTestData (70000);
+
+    MemoryBlock both (compress (first, 1));
+    both.append (compress (second, 9).getData(), compress (second, 9).getSize());
+
+    MemoryBlock expected (first);
+    expected.append (second.getData(), second.getSize());
+
+    EXPECT_EQ (decompress (both), expected);
+
+    // The frames don't say how big they are, so the total can't be known
+    MemoryInputStream in (both, false);
+    EXPECT_EQ (LZ4DecompressorInputStream (in).getTotalLength(), -1);
+}
+
+TEST (LZ4DecompressorInputStreamTests, ConcatenatedFramesReportTheirTotalSize)
+{
+    const auto first = createTestData (5000);
+    const auto second = createTestData (70000);
+    const uint8 skippableFrame[] = { 0x50, 0x2a, 0x4d, 0x18, 3, 0, 0, 0, 1, 2, 3 };
+
+    MemoryBlock frames (createFrameWithContentSize (first));
+    frames.append (skippableFrame, sizeof (skippableFrame));
+    frames.append (createFrameWithContentSize (second).getData(), createFrameWithContentSize (second).getSize());
+
+    MemoryInputStream in (frames, false);
+    LZ4DecompressorInputStream decompressor (in);
+
+    char buffer[10];
+    EXPECT_EQ (decompressor.read (buffer, 10), 10);
+    EXPECT_EQ (decompressor.getTotalLength(), 75000);
+
+    MemoryOutputStream out;
+    out.writeFromInputStream (decompressor, -1);
+    EXPECT_EQ (out.getDataSize(), 74990u);
+    EXPECT_EQ (memcmp (addBytesToPointer (out.getData(), 74980), addBytesToPointer (second.getData(), 69990), 10), 0);
+    EXPECT_FALSE (decompressor.hasError());
+
+    // If any of the frames doesn't have a size, neither does the stream
+    frames.append (compress (first, 1).getData(), compress (first, 1).getSize());
+    MemoryInputStream mixedIn (frames, false);
+    EXPECT_EQ (LZ4DecompressorInputStream (mixedIn).getTotalLength(), -1);
+}
+
+TEST (LZ4DecompressorInputStreamTests, CanSeekBackwards)
+{
+    const auto data = createTestData (200000);
+    const auto compressed = compress (data, 1);
+
+    MemoryInputStream in (compressed, false);
+    LZ4DecompressorInputStream decompressor (in);
+
+    char buffer[100];
+    EXPECT_TRUE (decompressor.setPosition (150000));
+    EXPECT_EQ (decompressor.read (buffer, 100), 100);
+    EXPECT_EQ (memcmp (buffer, addBytesToPointer (data.getData(), 150000), 100), 0);
+
+    EXPECT_TRUE (decompressor.setPosition (10));
+    EXPECT_EQ (decompressor.read (buffer, 100), 100);
+    EXPECT_EQ (memcmp (buffer, addBytesToPointer (data.getData(), 10), 100), 0);
+}
+
+TEST (LZ4DecompressorInputStreamTests, RejectsCorruptData)
+{
+    const auto data = createTestData (100000);
+    const auto compressed = compress (data, 1);
+
+    Random random (7);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto corrupted = compressed;
+        corrupted[random.nextInt ((int) corrupted.getSize())] ^= (char) (1 + random.nextInt (255));
+
+        // This mustn't crash or read outside its buffers, and the content checksum catches
+        // any damage that still decodes
+        MemoryInputStream in (corrupted, false);
+        LZ4DecompressorInputStream decompressor (in);
+        MemoryOutputStream out;
+        out.writeFromInputStream (decompressor, -1);
+        EXPECT_TRUE (decompressor.hasError());
+    }
+
+    // A damaged header is rejected outright
+    auto badHeader = compressed;
+    badHeader[6] ^= 1;
+    EXPECT_TRUE (decompress (badHeader).isEmpty());
+
+    MemoryBlock truncated (compressed.getData(), compressed.getSize() / 2);
+    EXPECT_LT (decompress (truncated).getSize(), data.getSize());
+}
+
+TEST (LZ4DecompressorInputStreamTests, VerifiesBlockAndContentChecksums)
+{
+    // Written by the lz4 library with block checksums and a content checksum
+    const uint8 frame[] = { 0x04, 0x22, 0x4d, 0x18, 0x74, 0x40, 0xbd, 0x38, 0x00, 0x00, 0x00, 0xff, 0x1e, 0x54, 0x68, 0x65,
+                            0x20, 0x71, 0x75, 0x69, 0x63, 0x6b, 0x20, 0x62, 0x72, 0x6f, 0x77, 0x6e, 0x20, 0x66, 0x6f, 0x78,
+                            0x20, 0x6a, 0x75, 0x6d, 0x70, 0x73, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20,
+                            0x6c, 0x61, 0x7a, 0x79, 0x20, 0x64, 0x6f, 0x67, 0x2e, 0x20, 0x2d, 0x00, 0x6f, 0x50, 0x64, 0x6f,
+                            0x67, 0x2e, 0x20, 0x1c, 0x4b, 0x49, 0x34, 0x00, 0x00, 0x00, 0x00, 0x51, 0x99, 0xf1, 0xc4 };
+
+    const auto blockChecksumOffset = 67, contentChecksumOffset = 75;
+
+    auto readFrame = [&] (int byteToCorrupt, bool& hadError)
+    {
+        MemoryBlock data (frame, sizeof (frame));
+
+        if (byteToCorrupt >= 0)
+            data[byteToCorrupt] ^= 1;
+
+        MemoryInputStream in (data, false);
+        LZ4DecompressorInputStream decompressor (in);
+        auto text = decompressor.readEntireStreamAsString();
+        hadError = decompressor.hasError();
+        EXPECT_TRUE (decompressor.isExhausted());
+        return text;
+    };
+
+    String expected;
+
+    for (int i = 0; i < 4; ++i)
+        expected << "The quick brown fox jumps over the lazy dog. ";
+
+    bool hadError = true;
+    EXPECT_EQ (readFrame (-1, hadError), expected);
+    EXPECT_FALSE (hadError);
+
+    // A damaged block is rejected before it's decoded..
+    EXPECT_TRUE (readFrame (blockChecksumOffset, hadError).isEmpty());
+    EXPECT_TRUE (hadError);
+
+    // ..but the content checksum can only be checked once all the data has been read
+    EXPECT_EQ (readFrame (contentChecksumOffset, hadError), expected);
+    EXPECT_TRUE (hadError);
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+#include <thread>
+#include <vector>
+
+using namespace juce;
+
+TEST (LightweightSemaphoreTests, CountsSignals)
+{
+    LightweightSemaphore semaphore (1);
+
+    EXPECT_TRUE (semaphore.tryWait());
+    EXPECT_FALSE (semaphore.tryWait());
+
+    semaphore.signal (2);
+    EXPECT_TRUE (semaphore.wait (0));
+    EXPECT_TRUE (semaphore.wait());
+    EXPECT_FALSE (semaphore.tryWait());
+}
+
+TEST (LightweightSemaphoreTests, WaitTimesOutAndCanBeSignalledAfterwards)
+{
+    LightweightSemaphore semaphore;
+
+    const auto start = Time::getMillisecondCounterHiRes();
+    EXPECT_FALSE (semaphore.wait (20));
+    EXPECT_GE (Time::getMillisecondCounterHiRes() - start, 15.0);
+
+    // The timed-out waiter mustn't be left on the count, or this signal would be lost
+    semaphore.signal();
+    EXPECT_TRUE (semaphore.tryWait());
+}
+
+TEST (LightweightSemaphoreTests, SignalWakesParkedThreads)
+{
+    constexpr int numThreads = 4;
+    constexpr int numRounds = 200;
+
+    LightweightSemaphore semaphore;
+    std::atomic<int> numWoken { 0 };
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back ([&]
+        {
+            for (int round = 0; round < numRounds; ++round)
+            {
+                semaphore.wait();
+                ++numWoken;
+            }
+        });
+    }
+
+    for (int round = 0; round < numRounds; ++round)
+    {
+        semaphore.signal (numThreads);
+
+        while (numWoken.load() < (round + 1) * numThreads)
+            std::this_thread::yield();
+    }
+
+    for (auto& t : threads)
+        t.join();
+
+    EXPECT_EQ (numWoken.load(), numThreads * numRounds);
+    EXPECT_FALSE (semaphore.tryWait());
+}
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+MemoryBlock createTestData (size_t numBytes)
+{
+    // Repetitive enough to compress, with some noise so the blocks aren't all alike
+    MemoryOutputStream out;
+    Random random (1234);
+
+    while (out.getDataSize() < numBytes)
+        out << "line " << random.nextInt (1000) << " of some compressible text\n";
+
+    MemoryBlock data (out.getData(), numBytes);
+    return data;
+}
+
+MemoryBlock compress (WorkStealingScheduler& scheduler, const MemoryBlock& data, int windowBits, int blockSize = 64 * 1024)
+{
+    MemoryOutputStream out;
+
+    {
+        ParallelGZIPCompressorOutputStream compressor (out, scheduler, 6, windowBits, blockSize);
+
+        // Uneven writes, so that the blocks don't line up with them
+        for (size_t pos = 0; pos < data.getSize();)
+        {
+            auto numBytes = jmin ((size_t) 10007, data.getSize() - pos);
+            EXPECT_TRUE (compressor.write (static_cast<const char*> (data.getData()) + pos, numBytes));
+            pos += numBytes;
+        }
+    }
+
+    return out.getMemoryBlock();
+}
+
+MemoryBlock decompress (const MemoryBlock& compressed, GZIPDecompressorInputStream::Format format)
+{
+    MemoryInputStream in (compressed, false);
+    GZIPDecompressorInputStream decompressor (&in, false, format);
+
+    MemoryOutputStream out;
+    out.writeFromInputStream (decompressor, -1);
+    return out.getMemoryBlock();
+}
+} // namespace
+
+TEST (ParallelGZIPCompressorOutputStreamTests, RoundTripsInEachFormat)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (4));
+    const auto data = createTestData (1000000);
+
+    EXPECT_EQ (decompress (compress (scheduler, data, 0), GZIPDecompressorInputStream::zlibFormat), data);
+    EXPECT_EQ (decompress (compress (scheduler, data, GZIPCompressorOutputStream::windowBitsGZIP), GZIPDecompressorInputStream::gzipFormat), data);
+    EXPECT_EQ (decompress (compress (scheduler, data, GZIPCompressorOutputStream::windowBitsRaw), GZIPDecompressorInputStream::deflateFormat), data);
+}
+
+TEST (ParallelGZIPCompressorOutputStreamTests, ChecksumsMatchTheSerialStream)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (3));
+    const auto data = createTestData (300000);
+
+    auto parallel = compress (scheduler, data, GZIPCompressorOutputStream::windowBitsGZIP);
+
+    MemoryOutputStream serial;
+    GZIPCompressorOutputStream (serial, 6, GZIPCompressorOutputStream::windowBitsGZIP).write (data.getData(), data.getSize());
+
+    // The gzip trailer holds the CRC and the length of the uncompressed data
+    ASSERT_GT (parallel.getSize(), 8u);
+    EXPECT_EQ (memcmp (addBytesToPointer (parallel.getData(), parallel.getSize() - 8),
+                       addBytesToPointer (serial.getData(), serial.getDataSize() - 8), 8), 0);
+
+    // Joining the blocks costs a little, but not much
+    EXPECT_LT ((double) parallel.getSize(), (double) serial.getDataSize() * 1.02);
+}
+
+TEST (ParallelGZIPCompressorOutputStreamTests, HandlesEmptyAndSmallInputs)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (2));
+
+    for (auto size : { 0, 1, 32767, 32768, 65536, 65537 })
+    {
+        const auto data = createTestData ((size_t) size);
+        EXPECT_EQ (decompress (compress (scheduler, data, 0, 32768), GZIPDecompressorInputStream::zlibFormat), data);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+#include <set>
+#include <thread>
+
+using namespace juce;
+
+TEST (StringTests, StringViewsDontNeedNullTerminators)
+{
+    const char text[] = { 'a', 'b', 'c', 'd', '\xe2', '\x9c', '\x93' };
+
+    EXPECT_EQ (String (std::string_view (text, 3)), "abc");
+    EXPECT_EQ (String (std::string_view (text, 7)), String::fromUTF8 ("abcd\xe2\x9c\x93"));
+    EXPECT_TRUE (String (std::string_view (text + 7, 0)).isEmpty());
+    EXPECT_TRUE (String (std::string_view()).isEmpty());
+    EXPECT_TRUE (String (std::string()).isEmpty());
+
+    String s ("x");
+    s << std::string_view (text + 1, 2) << std::string_view() << std::string ("!");
+    EXPECT_EQ (s, "xbc!");
+}
+
+TEST (StringTests, ComparesWithStringViews)
+{
+    const String s ("abc");
+
+    EXPECT_TRUE (s == std::string_view ("abcdef", 3));
+    EXPECT_FALSE (s == std::string_view ("abcdef", 2));
+    EXPECT_FALSE (s == std::string_view ("abcdef", 4));
+    EXPECT_TRUE (s != std::string_view ("abd"));
+    EXPECT_TRUE (String() == std::string_view());
+    EXPECT_FALSE (String() == std::string_view ("a"));
+
+    EXPECT_TRUE (s == std::string ("abc"));
+    EXPECT_TRUE (s != std::string ("ab"));
+    EXPECT_TRUE (String::fromUTF8 ("\xe2\x9c\x93") == std::string_view ("\xe2\x9c\x93"));
+}
+
+TEST (StringTests, RepeatedAppendsKeepTheirContent)
+{
+    String s;
+    std::string reference;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        s << i << ",";
+        reference += std::to_string (i) + ",";
+    }
+
+    EXPECT_EQ (s.toStdString(), reference);
+
+    // Appending to a shared string mustn't change the other copy
+    auto copy = s;
+    copy << "end";
+    EXPECT_EQ (s.toStdString(), reference);
+    EXPECT_TRUE (copy.endsWith (",end"));
+}
+
+TEST (StringTests, OnlyAppendsGrowTheBufferGeometrically)
+{
+    String appended;
+    std::set<const void*> buffersUsed;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        appended << "x";
+        buffersUsed.insert (appended.getCharPointer().getAddress());
+    }
+
+    EXPECT_LT (buffersUsed.size(), 40u);
+
+    // An explicit request is allocated at the size asked for, rather than growing the buffer
+    // by half again like an append would
+    String preallocated ("abc");
+    preallocated.preallocateBytes (700);
+    preallocated.preallocateBytes (799);
+    const auto* buffer = preallocated.getCharPointer().getAddress();
+
+    preallocated << String::repeatedString ("x", 796);
+    EXPECT_EQ (preallocated.getCharPointer().getAddress(), buffer);
+
+    preallocated << "x";
+    EXPECT_NE (preallocated.getCharPointer().getAddress(), buffer);
+    EXPECT_EQ (preallocated.length(), 800);
+}
+
+TEST (StringTests, StringsCanBeReleasedOnOtherThreads)
+{
+    std::vector<String> strings;
+
+    for (int i = 0; i < 1000; ++i)
+        strings.push_back ("s" + String (i));
+
+    std::vector<String> copies (strings);
+
+    std::thread releaser ([&] { strings.clear(); });
+
+    for (auto& s : copies)
+        s = "t" + s;
+
+    releaser.join();
+
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ (copies[(size_t) i], "ts" + String (i));
+}
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace juce;
+
+namespace
+{
+struct RecordingJob final : public ThreadPoolJob
+{
+    RecordingJob (String& log, CriticalSection& logLock, const String& name, int timesToRun = 1)
+        : ThreadPoolJob (name), runLog (log), lock (logLock), numRunsLeft (timesToRun)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        const ScopedLock sl (lock);
+        runLog << getJobName();
+        return --numRunsLeft > 0 ? jobNeedsRunningAgain : jobHasFinished;
+    }
+
+    String& runLog;
+    CriticalSection& lock;
+    int numRunsLeft;
+};
+
+struct BlockingJob final : public ThreadPoolJob
+{
+    BlockingJob() : ThreadPoolJob ("blocker") {}
+
+    JobStatus runJob() override
+    {
+        started.signal();
+        release.wait();
+        return jobHasFinished;
+    }
+
+    WaitableEvent started, release;
+};
+
+bool waitForAllJobs (ThreadPool& pool)
+{
+    for (int i = 0; i < 5000 && pool.getNumJobs() > 0; ++i)
+        Thread::sleep (1);
+
+    return pool.getNumJobs() == 0;
+}
+} // namespace
+
+TEST (ThreadPoolTests, RunsEveryJobAddedFromManyThreads)
+{
+    ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (4));
+
+    constexpr int numAddingThreads = 4, numJobsPerThread = 2000;
+    std::atomic<int> numRun { 0 };
+    std::vector<std::thread> addingThreads;
+
+    for (int t = 0; t < numAddingThreads; ++t)
+        addingThreads.emplace_back ([&]
+        {
+            for (int i = 0; i < numJobsPerThread; ++i)
+                pool.addJob ([&] { numRun.fetch_add (1); });
+        });
+
+    for (auto& t : addingThreads)
+        t.join();
+
+    EXPECT_TRUE (waitForAllJobs (pool));
+    EXPECT_EQ (numRun.load(), numAddingThreads * numJobsPerThread);
+}
+
+TEST (ThreadPoolTests, JobsThatNeedRunningAgainGoToTheBackOfTheQueue)
+{
+    ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+
+    String log;
+    CriticalSection logLock;
+    BlockingJob blocker;
+    RecordingJob a (log, logLock, "a", 3), b (log, logLock, "b");
+
+    pool.addJob (&blocker, false);
+    ASSERT_TRUE (blocker.started.wait (5000));
+
+    pool.addJob (&a, false);
+    pool.addJob (&b, false);
+    EXPECT_EQ (pool.getNumJobs(), 3);
+
+    blocker.release.signal();
+    EXPECT_TRUE (waitForAllJobs (pool));
+    EXPECT_EQ (log, "abaa");
+}
+
+TEST (ThreadPoolTests, QueuedJobsCanBeMovedAndRemoved)
+{
+    ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+
+    String log;
+    CriticalSection logLock;
+    BlockingJob blocker;
+    RecordingJob first (log, logLock, "1"), second (log, logLock, "2"), third (log, logLock, "3"), fourth (log, logLock, "4");
+
+    pool.addJob (&blocker, false);
+    ASSERT_TRUE (blocker.started.wait (5000));
+    EXPECT_TRUE (pool.isJobRunning (&blocker));
+
+    for (auto* job : { &first, &second, &third, &fourth })
+        pool.addJob (job, false);
+
+    pool.moveJobToFront (&third);
+    EXPECT_TRUE (pool.removeJob (&second, false, 0));
+    EXPECT_FALSE (pool.contains (&second));
+    EXPECT_TRUE (pool.contains (&third));
+    EXPECT_FALSE (pool.isJobRunning (&third));
+
+    EXPECT_EQ (pool.getNumJobs(), 4);
+    EXPECT_EQ (pool.getJob (0), &third);
+    EXPECT_EQ (pool.getJob (1), &blocker);
+    EXPECT_EQ (pool.getJob (4), nullptr);
+    EXPECT_EQ (pool.getNamesOfAllJobs (false), StringArray ({ "3", "blocker", "1", "4" }));
+    EXPECT_EQ (pool.getNamesOfAllJobs (true), StringArray ({ "blocker" }));
+
+    blocker.release.signal();
+    EXPECT_TRUE (pool.waitForJobToFinish (&fourth, 5000));
+    EXPECT_TRUE (waitForAllJobs (pool));
+    EXPECT_EQ (log, "314");
+}
+
+TEST (ThreadPoolTests, RemoveAllJobsInterruptsRunningOnes)
+{
+    ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (2));
+    std::atomic<int> numStarted { 0 };
+
+    for (int i = 0; i < 2; ++i)
+        pool.addJob (std::function<ThreadPoolJob::JobStatus()> ([&]
+        {
+            numStarted.fetch_add (1);
+
+            while (! ThreadPoolJob::getCurrentThreadPoolJob()->shouldExit())
+                Thread::sleep (1);
+
+            return ThreadPoolJob::jobHasFinished;
+        }));
+
+    for (int i = 0; i < 5000 && numStarted.load() < 2; ++i)
+        Thread::sleep (1);
+
+    for (int i = 0; i < 10; ++i)
+        pool.addJob ([] { FAIL(); });
+
+    EXPECT_TRUE (pool.removeAllJobs (true, 5000));
+    EXPECT_EQ (pool.getNumJobs(), 0);
+}
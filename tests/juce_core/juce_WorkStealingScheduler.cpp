@@ -0,0 +1,172 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+int fibonacci (WorkStealingScheduler& scheduler, int n)
+{
+    if (n < 12)
+        return n < 2 ? n : fibonacci (scheduler, n - 1) + fibonacci (scheduler, n - 2);
+
+    int a = 0, b = 0;
+
+    WorkStealingScheduler::TaskGroup group (scheduler);
+    group.run ([&] { a = fibonacci (scheduler, n - 1); });
+    b = fibonacci (scheduler, n - 2);
+    group.wait();
+
+    return a + b;
+}
+} // namespace
+
+TEST (WorkStealingSchedulerTests, ParallelForVisitsEachIndexOnce)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (4));
+    EXPECT_EQ (scheduler.getNumThreads(), 4);
+    EXPECT_EQ (scheduler.getCurrentWorkerIndex(), -1);
+
+    std::vector<std::atomic<int>> counts (10000);
+    scheduler.parallelFor (0, (int) counts.size(), [&] (int i) { counts[(size_t) i].fetch_add (1); });
+
+    for (auto& count : counts)
+        EXPECT_EQ (count.load(), 1);
+
+    std::atomic<int> numOutOfRange { 0 };
+    scheduler.parallelFor (100, 200, [&] (int i) { if (i < 100 || i >= 200) ++numOutOfRange; }, 7);
+    EXPECT_EQ (numOutOfRange.load(), 0);
+
+    scheduler.parallelFor (5, 5, [] (int) { FAIL(); });
+}
+
+TEST (WorkStealingSchedulerTests, ParallelReduceCombinesPiecesInOrder)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (3));
+
+    const auto sum = scheduler.parallelReduce (0, 100000, (int64) 0,
+                                               [] (int i) { return (int64) i; },
+                                               [] (int64 a, int64 b) { return a + b; });
+    EXPECT_EQ (sum, (int64) 100000 * 99999 / 2);
+
+    // string concatenation is associative but not commutative
+    const auto text = scheduler.parallelReduce (0, 26, String(),
+                                                [] (int i) { return String::charToString ((juce_wchar) ('a' + i)); },
+                                                [] (const String& a, const String& b) { return a + b; },
+                                                2);
+    EXPECT_EQ (text, "abcdefghijklmnopqrstuvwxyz");
+}
+
+TEST (WorkStealingSchedulerTests, NestedGroupsCanWaitInsideTasks)
+{
+    // with a tiny pool of slots, most of the tasks have to be run straight away
+    for (auto maxNumQueuedTasks : { 4096, 4 })
+    {
+        WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}
+                                             .withNumberOfThreads (4)
+                                             .withMaxNumQueuedTasks (maxNumQueuedTasks)
+                                             .withThreadsPinnedToCores (true));
+
+        EXPECT_EQ (fibonacci (scheduler, 25), 75025);
+    }
+}
+
+TEST (WorkStealingSchedulerTests, CancelledTasksAreSkipped)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (2));
+
+    WaitableEvent release (true);
+    std::atomic<int> numStarted { 0 }, numRun { 0 };
+
+    WorkStealingScheduler::TaskGroup blocker (scheduler);
+
+    // keep both workers busy, so that the group's tasks stay queued
+    for (int i = 0; i < 2; ++i)
+        blocker.run ([&] { ++numStarted; release.wait(); });
+
+    while (numStarted.load() < 2)
+        Thread::yield();
+
+    WorkStealingScheduler::TaskGroup group (scheduler);
+
+    for (int i = 0; i < 100; ++i)
+        group.run ([&] { ++numRun; });
+
+    group.cancel();
+    EXPECT_TRUE (group.isCancelled());
+
+    group.wait();
+    EXPECT_EQ (group.getNumPendingTasks(), 0);
+    EXPECT_EQ (numRun.load(), 0);
+
+    release.signal();
+    blocker.wait();
+}
+
+TEST (WorkStealingSchedulerTests, ThreadPoolRunsItsJobsOnTheScheduler)
+{
+    ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (3));
+    EXPECT_EQ (pool.getNumThreads(), 3);
+
+    struct CountingJob final : public ThreadPoolJob
+    {
+        CountingJob() : ThreadPoolJob ("counting") {}
+
+        JobStatus runJob() override
+        {
+            if (getCurrentThreadPoolJob() != this)
+                ++numWrongJobs;
+
+            return ++numRuns < 10 ? jobNeedsRunningAgain : jobHasFinished;
+        }
+
+        std::atomic<int> numRuns { 0 }, numWrongJobs { 0 };
+    };
+
+    CountingJob job;
+    pool.addJob (&job, false);
+
+    std::atomic<int> numLambdas { 0 };
+
+    for (int i = 0; i < 1000; ++i)
+        pool.addJob ([&] { ++numLambdas; });
+
+    EXPECT_TRUE (pool.waitForJobToFinish (&job, 5000));
+    EXPECT_EQ (job.numRuns.load(), 10);
+    EXPECT_EQ (job.numWrongJobs.load(), 0);
+    EXPECT_EQ (ThreadPoolJob::getCurrentThreadPoolJob(), nullptr);
+
+    for (int i = 0; i < 500 && pool.getNumJobs() > 0; ++i)
+        Thread::sleep (10);
+
+    EXPECT_EQ (pool.getNumJobs(), 0);
+    EXPECT_EQ (numLambdas.load(), 1000);
+
+    // the pool keeps going after it's been idle
+    WaitableEvent done;
+    pool.addJob ([&] { done.signal(); });
+    EXPECT_TRUE (done.wait (5000));
+    EXPECT_TRUE (pool.removeAllJobs (true, 5000));
+}
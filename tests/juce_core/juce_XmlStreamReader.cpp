@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+
+using namespace juce;
+
+namespace
+{
+using Event = XmlStreamReader::Event;
+
+const char* const testDocument = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE score-partwise PUBLIC "-//Recordare//DTD MusicXML 4.0 Partwise//EN" "http://www.musicxml.org/dtds/partwise.dtd">
+<!-- a comment before the document -->
+<score version="4.0">
+  <work title='Fish &amp; &quot;Chips&quot;'/>
+  <part id="P1" name="Lead &#x263A;">
+    <measure number="1">
+      <note pitch="C4" duration="4"/>
+      Some text &lt;here&gt;<!-- and a comment -->that continues&#33;
+      <![CDATA[ <raw> & unescaped ]]>
+    </measure>
+  </part>
+  <part id="P2"><measure number="1"><note pitch="E4"/></measure></part>
+</score>
+)";
+
+std::vector<Event> readAllEvents (XmlStreamReader& reader)
+{
+    std::vector<Event> events;
+
+    for (;;)
+    {
+        events.push_back (reader.next());
+
+        if (events.back() == Event::endOfDocument || events.back() == Event::error)
+            return events;
+    }
+}
+} // namespace
+
+TEST (XmlStreamReaderTests, ReadsEvents)
+{
+    XmlStreamReader reader (testDocument, std::strlen (testDocument));
+
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("score"));
+    EXPECT_EQ (reader.getStringAttribute ("version"), "4.0");
+    EXPECT_EQ (reader.getDepth(), 1);
+
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("work"));
+    EXPECT_EQ (reader.getNumAttributes(), 1);
+    EXPECT_EQ (reader.getAttributeName (0), Identifier ("title"));
+    EXPECT_EQ (reader.getAttributeValue (0), "Fish & \"Chips\"");
+
+    EXPECT_EQ (reader.next(), Event::endElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("work"));
+    EXPECT_EQ (reader.getDepth(), 1);
+
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.getStringAttribute ("name"), String (CharPointer_UTF8 ("Lead \xe2\x98\xba")));
+    EXPECT_TRUE (reader.hasAttribute ("id"));
+    EXPECT_FALSE (reader.hasAttribute ("missing"));
+
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("note"));
+    EXPECT_EQ (reader.next(), Event::endElement);
+
+    EXPECT_EQ (reader.next(), Event::text);
+    EXPECT_EQ (reader.getText().trim(), "Some text <here>that continues!");
+
+    EXPECT_EQ (reader.next(), Event::text);
+    EXPECT_EQ (reader.getText(), " <raw> & unescaped ");
+
+    EXPECT_EQ (reader.next(), Event::endElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("measure"));
+    EXPECT_EQ (reader.next(), Event::endElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("part"));
+
+    EXPECT_EQ (reader.next(), Event::startElement);
+    reader.skipElement();
+    EXPECT_EQ (reader.getCurrentEvent(), Event::endElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("part"));
+
+    EXPECT_EQ (reader.next(), Event::endElement);
+    EXPECT_EQ (reader.getTagName(), Identifier ("score"));
+    EXPECT_EQ (reader.getDepth(), 0);
+    EXPECT_EQ (reader.next(), Event::endOfDocument);
+    EXPECT_TRUE (reader.getLastParseError().isEmpty());
+}
+
+TEST (XmlStreamReaderTests, ReadElementMatchesXmlDocument)
+{
+    const auto expected = parseXML (testDocument);
+    ASSERT_NE (expected, nullptr);
+
+    for (auto bufferSize : { 16, 65536 })
+    {
+        MemoryInputStream stream (testDocument, std::strlen (testDocument), false);
+        XmlStreamReader reader (stream, (size_t) bufferSize);
+
+        EXPECT_EQ (reader.next(), Event::startElement);
+        const auto element = reader.readElement();
+        ASSERT_NE (element, nullptr);
+
+        EXPECT_TRUE (element->isEquivalentTo (expected.get(), false));
+        EXPECT_EQ (element->toString(), expected->toString());
+        EXPECT_EQ (reader.next(), Event::endOfDocument);
+    }
+}
+
+TEST (XmlStreamReaderTests, ReadsSubtreesOfLargeStreams)
+{
+    MemoryOutputStream out;
+    out << "<project>";
+
+    for (int i = 0; i < 2000; ++i)
+        out << "<track index=\"" << i << "\"><clip start=\"" << i * 10 << "\">" << String::repeatedString ("data ", i % 50) << "</clip></track>";
+
+    out << "</project>";
+
+    MemoryInputStream stream (out.getData(), out.getDataSize(), false);
+    XmlStreamReader reader (stream, 256);
+
+    int numTracks = 0, numSkipped = 0;
+
+    for (auto event = reader.next(); event != Event::endOfDocument; event = reader.next())
+    {
+        ASSERT_NE (event, Event::error) << reader.getLastParseError();
+
+        if (event == Event::startElement && reader.getTagName() == Identifier ("track"))
+        {
+            if (numTracks++ % 2 == 0)
+            {
+                const auto track = reader.readElement();
+                ASSERT_NE (track, nullptr);
+                EXPECT_EQ (track->getIntAttribute ("index"), numTracks - 1);
+                EXPECT_EQ (track->getChildElement (0)->getAllSubText().length(), 5 * ((numTracks - 1) % 50));
+            }
+            else
+            {
+                reader.skipElement();
+                ++numSkipped;
+            }
+
+            EXPECT_EQ (reader.getDepth(), 1);
+        }
+    }
+
+    EXPECT_EQ (numTracks, 2000);
+    EXPECT_EQ (numSkipped, 1000);
+}
+
+TEST (XmlStreamReaderTests, ReportsErrors)
+{
+    const auto getError = [] (const char* text)
+    {
+        XmlStreamReader reader (text, std::strlen (text));
+        const auto events = readAllEvents (reader);
+        EXPECT_EQ (events.back(), Event::error);
+        EXPECT_EQ (reader.next(), Event::error);
+        return reader.getLastParseError();
+    };
+
+    EXPECT_EQ (getError (""), "not enough input");
+    EXPECT_EQ (getError ("<a><b></a>"), "closing tag 'a' doesn't match 'b'");
+    EXPECT_EQ (getError ("<a><b>"), "unmatched tags");
+    EXPECT_EQ (getError ("<a x=\"1></a>"), "unmatched quotes");
+    EXPECT_EQ (getError ("<a x></a>"), "expected '=' after attribute 'x'");
+    EXPECT_EQ (getError ("<a><!-- x </a>"), "unterminated comment");
+    EXPECT_EQ (getError ("<a><![CDATA[ x </a>"), "unterminated CDATA section");
+    EXPECT_EQ (getError ("text"), "illegal characters found outside the document element");
+
+    XmlStreamReader missing (File::getSpecialLocation (File::tempDirectory).getChildFile ("missing_file.xml"));
+    EXPECT_EQ (missing.next(), Event::error);
+}
+
+TEST (XmlStreamReaderTests, KeepsWhitespaceWhenAsked)
+{
+    const char* text = "<a> <b/>\r\n</a>";
+
+    XmlStreamReader reader (text, std::strlen (text));
+    reader.setEmptyTextElementsIgnored (false);
+
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.next(), Event::text);
+    EXPECT_EQ (reader.getText(), " ");
+    EXPECT_EQ (reader.next(), Event::startElement);
+    EXPECT_EQ (reader.next(), Event::endElement);
+    EXPECT_EQ (reader.next(), Event::text);
+    EXPECT_EQ (reader.getText(), "\n");
+    EXPECT_EQ (reader.next(), Event::endElement);
+    EXPECT_EQ (reader.next(), Event::endOfDocument);
+}
@@ -270,6 +270,81 @@ TEST_F (ZipFileTests, UncompressEntry)
     */
 }
 
+TEST_F (ZipFileTests, ParallelBuildAndUncompress)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (4));
+    ZipFile::Builder builder;
+    StringArray entryNames;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        auto name = "folder" + String (i % 3) + "/entry" + String (i) + ".txt";
+        builder.addEntry (new MemoryInputStream (MemoryBlock (String::repeatedString (name, i * 5000).toRawUTF8(),
+                                                              (size_t) i * 5000 * (size_t) name.length()), true),
+                          i % 4 == 0 ? 0 : 9, name, Time::getCurrentTime());
+        entryNames.add (name);
+    }
+
+    TemporaryFile zipFile (".zip");
+
+    {
+        FileOutputStream out (zipFile.getFile());
+        ASSERT_TRUE (builder.writeToStream (out, nullptr, scheduler));
+    }
+
+    TemporaryFile targetDirectory;
+    ZipFile zip (zipFile.getFile());
+    ASSERT_EQ (zip.getNumEntries(), entryNames.size());
+    EXPECT_TRUE (zip.uncompressTo (targetDirectory.getFile(), true, scheduler).wasOk());
+
+    for (int i = 0; i < entryNames.size(); ++i)
+    {
+        auto expected = String::repeatedString (entryNames[i], i * 5000);
+        EXPECT_EQ (targetDirectory.getFile().getChildFile (entryNames[i]).loadFileAsString(), expected);
+
+        std::unique_ptr<InputStream> input (zip.createStreamForEntry (i));
+        ASSERT_NE (input, nullptr);
+        EXPECT_EQ (input->readEntireStreamAsString(), expected);
+    }
+
+    targetDirectory.getFile().deleteRecursively();
+}
+
+TEST_F (ZipFileTests, FileArchiveCanBeTruncatedAfterOpening)
+{
+    auto data = createZipMemoryBlock ({ "first", "second" });
+    TemporaryFile zipFile (".zip");
+    ASSERT_TRUE (zipFile.getFile().replaceWithData (data.getData(), data.getSize()));
+
+    ZipFile zip (zipFile.getFile());
+    ASSERT_EQ (zip.getNumEntries(), 2);
+
+    // The archive isn't kept open or mapped, so it can be replaced, and reading it fails cleanly
+    ASSERT_TRUE (zipFile.getFile().replaceWithData (data.getData(), 20));
+
+    TemporaryFile targetDirectory;
+    EXPECT_TRUE (zip.uncompressEntry (0, targetDirectory.getFile()).failed());
+
+    targetDirectory.getFile().deleteRecursively();
+}
+
+TEST_F (ZipFileTests, ParallelUncompressReportsCorruptEntries)
+{
+    WorkStealingScheduler scheduler (WorkStealingScheduler::Options{}.withNumberOfThreads (2));
+    auto data = createZipMemoryBlock ({ "first", "second" });
+
+    // Trash the compressed data of the first entry, which follows its 30 byte header and name
+    for (size_t i = 35; i < 40; ++i)
+        data[i] = (char) 0xff;
+
+    TemporaryFile targetDirectory;
+    MemoryInputStream mi (data, false);
+    ZipFile zip (mi);
+
+    EXPECT_TRUE (zip.uncompressTo (targetDirectory.getFile(), true, scheduler).failed());
+    targetDirectory.getFile().deleteRecursively();
+}
+
 TEST_F (ZipFileTests, BuilderAddFile)
 {
     ZipFile::Builder builder;
@@ -0,0 +1,258 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <juce_core/juce_core.h>
+#include <zstd/zstd.h>
+
+using namespace juce;
+
+namespace
+{
+MemoryBlock createTestData (size_t numBytes, int seed = 1234)
+{
+    MemoryOutputStream out;
+    Random random (seed);
+
+    while (out.getDataSize() < numBytes)
+        out << "<param id=\"" << random.nextInt (100) << "\" value=\"" << random.nextInt (1000) << "\"/>\n";
+
+    return MemoryBlock (out.getData(), numBytes);
+}
+
+MemoryBlock compress (const MemoryBlock& data, int level, const MemoryBlock& dictionary = {})
+{
+    MemoryOutputStream out;
+
+    {
+        ZstdCompressorOutputStream compressor (out, level);
+
+        if (! dictionary.isEmpty())
+            compressor.setDictionary (dictionary.getData(), dictionary.getSize());
+
+        // Uneven writes, so that they don't line up with zstd's blocks
+        for (size_t pos = 0; pos < data.getSize();)
+        {
+            auto numBytes = jmin ((size_t) 7919, data.getSize() - pos);
+            EXPECT_TRUE (compressor.write (addBytesToPointer (data.getData(), pos), numBytes));
+            pos += numBytes;
+        }
+    }
+
+    return out.getMemoryBlock();
+}
+
+MemoryBlock decompress (const MemoryBlock& compressed, const MemoryBlock& dictionary = {})
+{
+    MemoryInputStream in (compressed, false);
+    ZstdDecompressorInputStream decompressor (in);
+
+    if (! dictionary.isEmpty())
+        decompressor.setDictionary (dictionary.getData(), dictionary.getSize());
+
+    MemoryOutputStream out;
+    out.writeFromInputStream (decompressor, -1);
+    EXPECT_TRUE (decompressor.isExhausted());
+    return out.getMemoryBlock();
+}
+} // namespace
+
+TEST (ZstdCompressorOutputStreamTests, RoundTripsAtDifferentLevels)
+{
+    const auto data = createTestData (300000);
+
+    for (auto level : { -1, 1, 3, 9, 19 })
+        EXPECT_EQ (decompress (compress (data, level)), data) << "level " << level;
+
+    // The highest levels compress better than the fastest one
+    EXPECT_LT (compress (data, 19).getSize(), compress (data, 1).getSize());
+}
+
+TEST (ZstdCompressorOutputStreamTests, HandlesAllSizesOfInput)
+{
+    for (auto size : { 0, 1, 12, 131071, 131072, 131073, 500000 })
+    {
+        const auto data = createTestData ((size_t) size);
+        EXPECT_EQ (decompress (compress (data, 1)), data) << "size " << size;
+    }
+
+    // Data that doesn't compress is stored as it is
+    MemoryBlock noise (100000);
+    Random (42).fillBitsRandomly (noise.getData(), noise.getSize());
+
+    auto compressed = compress (noise, 3);
+    EXPECT_EQ (decompress (compressed), noise);
+    EXPECT_LT (compressed.getSize(), noise.getSize() + 64);
+}
+
+TEST (ZstdCompressorOutputStreamTests, DictionaryImprovesSmallPayloads)
+{
+    const auto dictionary = createTestData (32768);
+    MemoryBlock payload (addBytesToPointer (createTestData (100000).getData(), 50000), 1000);
+
+    auto withoutDictionary = compress (payload, 3);
+    auto withDictionary = compress (payload, 3, dictionary);
+
+    EXPECT_LT (withDictionary.getSize(), withoutDictionary.getSize());
+    EXPECT_EQ (decompress (withDictionary, dictionary), payload);
+
+    // Without the dictionary, the data can't be read
+    EXPECT_NE (decompress (withDictionary), payload);
+}
+
+TEST (ZstdCompressorOutputStreamTests, TrainsDictionaries)
+{
+    Array<MemoryBlock> samples;
+
+    for (int i = 0; i < 500; ++i)
+        samples.add (createTestData (500, i));
+
+    auto dictionary = ZstdCompressorOutputStream::trainDictionary (samples, 8192);
+    ASSERT_FALSE (dictionary.isEmpty());
+    EXPECT_LE (dictionary.getSize(), 8192u);
+
+    const auto payload = createTestData (500, 1000);
+    auto withDictionary = compress (payload, 3, dictionary);
+
+    EXPECT_LT (withDictionary.getSize(), compress (payload, 3).getSize());
+    EXPECT_EQ (decompress (withDictionary, dictionary), payload);
+
+    // A trained dictionary has an ID, so reading with the wrong one fails rather than producing garbage
+    EXPECT_TRUE (decompress (withDictionary).isEmpty());
+
+    // There's nothing to learn from too few samples
+    EXPECT_TRUE (ZstdCompressorOutputStream::trainDictionary ({ payload }).isEmpty());
+}
+
+TEST (ZstdCompressorOutputStreamTests, WritesTheFrameFormat)
+{
+    auto compressed = compress (createTestData (1000), 3);
+    auto* bytes = static_cast<const uint8*> (compressed.getData());
+
+    // The magic number, followed by a descriptor that asks for a content checksum
+    ASSERT_GT (compressed.getSize(), 5u);
+    EXPECT_EQ (ByteOrder::littleEndianInt (bytes), 0xFD2FB528u);
+    EXPECT_NE (bytes[4] & 0x04, 0);
+}
+
+TEST (ZstdDecompressorInputStreamTests, ReadsConcatenatedFrames)
+{
+    const auto first = createTestData (5000, 1);
+    const auto second = createTestData (7000, 2);
+
+    MemoryBlock both (compress (first, 3));
+    both.append (compress (second, 9).getData(), compress (second, 9).getSize());
+
+    MemoryBlock expected (first);
+    expected.append (second.getData(), second.getSize());
+
+    EXPECT_EQ (decompress (both), expected);
+}
+
+TEST (ZstdDecompressorInputStreamTests, ConcatenatedFramesReportTheirTotalSize)
+{
+    // Unlike the streaming compressor, ZSTD_compress() records each frame's size, as the command line tool does
+    auto compressWithSize = [] (const MemoryBlock& data)
+    {
+        MemoryBlock result (ZSTD_compressBound (data.getSize()));
+        auto size = ZSTD_compress (result.getData(), result.getSize(), data.getData(), data.getSize(), 3);
+        EXPECT_FALSE (ZSTD_isError (size));
+        result.setSize (size);
+        return result;
+    };
+
+    const auto first = createTestData (5000, 1);
+    const auto second = createTestData (5000, 2);
+
+    MemoryBlock both (compressWithSize (first));
+    both.append (compressWithSize (second).getData(), compressWithSize (second).getSize());
+
+    MemoryInputStream in (both, false);
+    ZstdDecompressorInputStream decompressor (in);
+
+    char buffer[10];
+    EXPECT_EQ (decompressor.read (buffer, 10), 10);
+    EXPECT_EQ (decompressor.getTotalLength(), 10000);
+
+    MemoryOutputStream out;
+    out.writeFromInputStream (decompressor, -1);
+    EXPECT_EQ (out.getDataSize(), 9990u);
+    EXPECT_EQ (memcmp (addBytesToPointer (out.getData(), 9980), addBytesToPointer (second.getData(), 4990), 10), 0);
+
+    // Only the first part of the data is read at the start, so the total isn't known
+    const auto large = createTestData (1000000, 3);
+    MemoryBlock frames (compressWithSize (large));
+    frames.append (compressWithSize (second).getData(), compressWithSize (second).getSize());
+
+    MemoryInputStream largeIn (frames, false);
+    ZstdDecompressorInputStream largeDecompressor (largeIn);
+    EXPECT_EQ (largeDecompressor.read (buffer, 10), 10);
+    EXPECT_EQ (largeDecompressor.getTotalLength(), -1);
+
+    MemoryOutputStream largeOut;
+    largeOut.writeFromInputStream (largeDecompressor, -1);
+    EXPECT_EQ (largeOut.getDataSize(), large.getSize() + second.getSize() - 10);
+}
+
+TEST (ZstdDecompressorInputStreamTests, CanSeekBackwards)
+{
+    const auto data = createTestData (400000);
+    const auto compressed = compress (data, 3);
+
+    MemoryInputStream in (compressed, false);
+    ZstdDecompressorInputStream decompressor (in);
+
+    char buffer[100];
+    EXPECT_TRUE (decompressor.setPosition (350000));
+    EXPECT_EQ (decompressor.read (buffer, 100), 100);
+    EXPECT_EQ (memcmp (buffer, addBytesToPointer (data.getData(), 350000), 100), 0);
+
+    EXPECT_TRUE (decompressor.setPosition (10));
+    EXPECT_EQ (decompressor.read (buffer, 100), 100);
+    EXPECT_EQ (memcmp (buffer, addBytesToPointer (data.getData(), 10), 100), 0);
+}
+
+TEST (ZstdDecompressorInputStreamTests, RejectsCorruptData)
+{
+    const auto data = createTestData (100000);
+    const auto compressed = compress (data, 3);
+
+    Random random (7);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto corrupted = compressed;
+        corrupted[random.nextInt ((int) corrupted.getSize())] ^= (char) (1 + random.nextInt (255));
+
+        // This mustn't crash or read outside its buffers, whatever it returns
+        decompress (corrupted);
+    }
+
+    // A damaged header is rejected outright
+    auto badHeader = compressed;
+    badHeader[0] ^= 1;
+    EXPECT_TRUE (decompress (badHeader).isEmpty());
+
+    MemoryBlock truncated (compressed.getData(), compressed.getSize() / 2);
+    EXPECT_LT (decompress (truncated).getSize(), data.getSize());
+}
@@ -0,0 +1,321 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <yup_audio_processors/yup_audio_processors.h>
+
+using namespace yup;
+
+namespace
+{
+using Connection = AudioProcessorGraph::Connection;
+
+/*  A mono processor that applies a gain and then delays its input by a number of samples,
+    reporting that delay as its latency. It can also record the order in which it was run.
+*/
+class TestProcessor : public AudioProcessor
+{
+public:
+    TestProcessor (float gainToUse, int latencyToUse = 0, std::vector<int>* orderLog = nullptr, int idToLog = 0)
+        : gain (gainToUse)
+        , latency (latencyToUse)
+        , log (orderLog)
+        , id (idToLog)
+    {
+    }
+
+    int getNumParameters() const override { return 0; }
+    AudioProcessorParameter& getParameter (int) override { return parameter; }
+
+    int getNumAudioOutputs() const override { return 1; }
+    int getNumAudioInputs() const override { return 1; }
+
+    void prepareToPlay (float, int) override
+    {
+        delay.calloc ((size_t) latency + 1);
+        position = 0;
+    }
+
+    void releaseResources() override {}
+
+    int getLatencySamples() const override { return latency; }
+
+    void processBlock (AudioSampleBuffer& buffer, MidiBuffer&) override
+    {
+        if (log != nullptr)
+            log->push_back (id);
+
+        auto* samples = buffer.getWritePointer (0);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const auto input = samples[i] * gain;
+
+            if (latency == 0)
+            {
+                samples[i] = input;
+                continue;
+            }
+
+            samples[i] = delay[position];
+            delay[position] = input;
+            position = (position + 1) % latency;
+        }
+    }
+
+    bool hasEditor() const override { return false; }
+
+private:
+    const float gain;
+    const int latency;
+    std::vector<int>* log;
+    const int id;
+
+    AudioProcessorParameter parameter { "unused", 0.0f, 1.0f, 0.0f };
+    HeapBlock<float> delay;
+    int position = 0;
+};
+
+void connectAudio (AudioProcessorGraph& graph, AudioProcessorGraph::NodeID source, AudioProcessorGraph::NodeID dest)
+{
+    EXPECT_TRUE (graph.addConnection ({ source, 0, dest, 0 }));
+}
+
+constexpr auto input = AudioProcessorGraph::audioInputNodeID;
+constexpr auto output = AudioProcessorGraph::audioOutputNodeID;
+constexpr auto midi = AudioProcessorGraph::midiChannelIndex;
+} // namespace
+
+TEST (AudioProcessorGraphTests, RendersNodesInTopologicalOrder)
+{
+    std::vector<int> order;
+
+    AudioProcessorGraph graph;
+    graph.setNumChannels (1, 1);
+
+    // The nodes are added in the reverse of the order they have to run in
+    const auto d = graph.addNode (std::make_unique<TestProcessor> (1.0f, 0, &order, 4));
+    const auto c = graph.addNode (std::make_unique<TestProcessor> (1.0f, 0, &order, 3));
+    const auto b = graph.addNode (std::make_unique<TestProcessor> (1.0f, 0, &order, 2));
+    const auto a = graph.addNode (std::make_unique<TestProcessor> (1.0f, 0, &order, 1));
+
+    connectAudio (graph, input, a);
+    connectAudio (graph, a, b);
+    connectAudio (graph, a, c);
+    connectAudio (graph, b, d);
+    connectAudio (graph, c, d);
+    connectAudio (graph, d, output);
+
+    EXPECT_FALSE (graph.canConnect ({ d, 0, a, 0 }));
+    EXPECT_FALSE (graph.addConnection ({ output, 0, a, 0 }));
+
+    graph.prepareToPlay (44100.0f, 64);
+
+    AudioSampleBuffer buffer (1, 64);
+    MidiBuffer midiBuffer;
+    buffer.clear();
+    graph.processBlock (buffer, midiBuffer);
+
+    ASSERT_EQ (order.size(), (size_t) 4);
+    EXPECT_EQ (order.front(), 1);
+    EXPECT_EQ (order.back(), 4);
+
+    graph.releaseResources();
+}
+
+TEST (AudioProcessorGraphTests, CompensatesTheLatencyOfParallelPaths)
+{
+    AudioProcessorGraph graph;
+    graph.setNumChannels (1, 1);
+
+    const auto latent = graph.addNode (std::make_unique<TestProcessor> (2.0f, 3));
+    const auto direct = graph.addNode (std::make_unique<TestProcessor> (0.5f));
+
+    connectAudio (graph, input, latent);
+    connectAudio (graph, input, direct);
+    connectAudio (graph, latent, output);
+    connectAudio (graph, direct, output);
+
+    EXPECT_EQ (graph.getLatencySamples(), 3);
+
+    graph.prepareToPlay (44100.0f, 64);
+
+    AudioSampleBuffer buffer (1, 64);
+    MidiBuffer midiBuffer;
+
+    for (int block = 0; block < 4; ++block)
+    {
+        buffer.clear();
+        buffer.setSample (0, 0, 1.0f);
+        graph.processBlock (buffer, midiBuffer);
+
+        for (int i = 0; i < 64; ++i)
+            ASSERT_FLOAT_EQ (buffer.getSample (0, i), i == 3 ? 2.5f : 0.0f) << "block " << block << ", sample " << i;
+    }
+
+    graph.releaseResources();
+}
+
+TEST (AudioProcessorGraphTests, DelaysMidiToMatchTheAudio)
+{
+    AudioProcessorGraph graph;
+    graph.setNumChannels (1, 1);
+
+    const auto latent = graph.addNode (std::make_unique<TestProcessor> (1.0f, 5));
+    connectAudio (graph, input, latent);
+    connectAudio (graph, latent, output);
+    EXPECT_TRUE (graph.addConnection ({ input, midi, output, midi }));
+
+    graph.prepareToPlay (44100.0f, 64);
+
+    AudioSampleBuffer buffer (1, 64);
+    buffer.clear();
+
+    MidiBuffer midiBuffer;
+    midiBuffer.addEvent (MidiMessage::noteOn (1, 60, 1.0f), 2);
+    midiBuffer.addEvent (MidiMessage::noteOff (1, 60), 62);
+    graph.processBlock (buffer, midiBuffer);
+
+    ASSERT_EQ (midiBuffer.getNumEvents(), 1);
+    EXPECT_EQ (midiBuffer.getFirstEventTime(), 7);
+
+    // The note-off was held back across the end of the block
+    midiBuffer.clear();
+    graph.processBlock (buffer, midiBuffer);
+
+    ASSERT_EQ (midiBuffer.getNumEvents(), 1);
+    EXPECT_EQ (midiBuffer.getFirstEventTime(), 3);
+    EXPECT_TRUE ((*midiBuffer.begin()).getMessage().isNoteOff());
+
+    graph.releaseResources();
+}
+
+TEST (AudioProcessorGraphTests, DelayLinesSurviveEdits)
+{
+    AudioProcessorGraph graph;
+    graph.setNumChannels (1, 1);
+
+    const auto latent = graph.addNode (std::make_unique<TestProcessor> (2.0f, 10));
+    const auto direct = graph.addNode (std::make_unique<TestProcessor> (0.5f));
+
+    connectAudio (graph, input, latent);
+    connectAudio (graph, input, direct);
+    connectAudio (graph, latent, output);
+    connectAudio (graph, direct, output);
+
+    graph.prepareToPlay (44100.0f, 64);
+
+    AudioSampleBuffer buffer (1, 64);
+    MidiBuffer midiBuffer;
+
+    // This impulse is still inside both paths' delays at the end of the block..
+    buffer.clear();
+    buffer.setSample (0, 60, 1.0f);
+    graph.processBlock (buffer, midiBuffer);
+
+    // ..and an edit in between the blocks mustn't lose the part held by the graph
+    graph.addNode (std::make_unique<TestProcessor> (1.0f));
+
+    buffer.clear();
+    graph.processBlock (buffer, midiBuffer);
+
+    EXPECT_FLOAT_EQ (buffer.getSample (0, 6), 2.5f);
+
+    graph.releaseResources();
+}
+
+TEST (AudioProcessorGraphTests, ParallelRenderingMatchesSerialRendering)
+{
+    const auto render = [] (int numWorkers)
+    {
+        AudioProcessorGraph graph;
+        graph.setNumChannels (1, 1);
+        graph.setNumWorkerThreads (numWorkers);
+
+        // Several chains of different lengths and latencies, all mixed at the output
+        for (int chain = 0; chain < 6; ++chain)
+        {
+            auto previous = input;
+
+            for (int i = 0; i <= chain % 3; ++i)
+            {
+                const auto node = graph.addNode (std::make_unique<TestProcessor> (0.5f + 0.1f * (float) chain, (chain + i) % 4));
+                connectAudio (graph, previous, node);
+                previous = node;
+            }
+
+            connectAudio (graph, previous, output);
+        }
+
+        graph.prepareToPlay (44100.0f, 64);
+
+        AudioSampleBuffer buffer (1, 64);
+        MidiBuffer midiBuffer;
+        std::vector<float> result;
+
+        for (int block = 0; block < 50; ++block)
+        {
+            for (int i = 0; i < 64; ++i)
+                buffer.setSample (0, i, (float) ((block * 64 + i) % 17) / 17.0f);
+
+            graph.processBlock (buffer, midiBuffer);
+            result.insert (result.end(), buffer.getReadPointer (0), buffer.getReadPointer (0) + 64);
+        }
+
+        graph.releaseResources();
+        return result;
+    };
+
+    const auto serial = render (0);
+    const auto parallel = render (3);
+
+    ASSERT_EQ (serial.size(), parallel.size());
+
+    for (size_t i = 0; i < serial.size(); ++i)
+        ASSERT_FLOAT_EQ (serial[i], parallel[i]) << "sample " << i;
+}
+
+TEST (AudioProcessorGraphTests, MidiBufferCapacityIsConfigurable)
+{
+    AudioProcessorGraph graph;
+    EXPECT_EQ (graph.getMidiBufferCapacity(), AudioProcessorGraph::defaultMidiBufferCapacity);
+
+    graph.setMidiBufferCapacity (90);
+    EXPECT_EQ (graph.getMidiBufferCapacity(), (size_t) 90);
+
+    EXPECT_TRUE (graph.addConnection ({ input, midi, output, midi }));
+    graph.prepareToPlay (44100.0f, 64);
+
+    AudioSampleBuffer buffer (2, 64);
+    buffer.clear();
+
+    MidiBuffer midiBuffer;
+
+    // Each note-on takes 9 bytes, so only 10 of them fit
+    for (int i = 0; i < 20; ++i)
+        midiBuffer.addEvent (MidiMessage::noteOn (1, i, 1.0f), i);
+
+    graph.processBlock (buffer, midiBuffer);
+    EXPECT_EQ (midiBuffer.getNumEvents(), 10);
+
+    graph.releaseResources();
+}
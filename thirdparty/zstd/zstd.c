@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+/* The library is built single threaded and without the legacy formats. The assembly
+   version of the Huffman decoder can't be built from a single source file, so the C
+   version is used instead. The only change to the library's sources is the include guard
+   added to lib/dictBuilder/cover.h, which is included by two of the files below. */
+#define DEBUGLEVEL 0
+#define MEM_MODULE
+#undef  XXH_NAMESPACE
+#define XXH_NAMESPACE ZSTD_
+#undef  XXH_PRIVATE_API
+#define XXH_PRIVATE_API
+#undef  XXH_INLINE_ALL
+#define XXH_INLINE_ALL
+#define ZSTD_LEGACY_SUPPORT 0
+#define ZSTD_TRACE 0
+#define ZSTD_DISABLE_ASM 1
+
+#define ZSTD_DEPS_NEED_MALLOC
+#define ZSTD_DEPS_NEED_MATH64
+#include "lib/common/zstd_deps.h"
+
+#include "zstd.h"
+
+#include "lib/common/debug.c"
+#include "lib/common/entropy_common.c"
+#include "lib/common/error_private.c"
+#include "lib/common/fse_decompress.c"
+#include "lib/common/threading.c"
+#include "lib/common/pool.c"
+#include "lib/common/zstd_common.c"
+
+#include "lib/compress/fse_compress.c"
+#include "lib/compress/hist.c"
+#include "lib/compress/huf_compress.c"
+#include "lib/compress/zstd_compress_literals.c"
+#include "lib/compress/zstd_compress_sequences.c"
+#include "lib/compress/zstd_compress_superblock.c"
+#include "lib/compress/zstd_compress.c"
+#include "lib/compress/zstd_double_fast.c"
+#include "lib/compress/zstd_fast.c"
+#include "lib/compress/zstd_lazy.c"
+#include "lib/compress/zstd_ldm.c"
+#include "lib/compress/zstd_opt.c"
+#include "lib/compress/zstd_preSplit.c"
+
+#include "lib/decompress/huf_decompress.c"
+#include "lib/decompress/zstd_ddict.c"
+#include "lib/decompress/zstd_decompress.c"
+#include "lib/decompress/zstd_decompress_block.c"
+
+#include "lib/dictBuilder/cover.c"
+#include "lib/dictBuilder/divsufsort.c"
+#include "lib/dictBuilder/fastcover.c"
+#include "lib/dictBuilder/zdict.c"
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+   This file is part of the YUP library.
+   Copyright (c) 2024 - kunitoki@gmail.com
+
+   YUP is an open source library subject to open-source licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   to use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   YUP IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+/*
+  ==============================================================================
+
+  BEGIN_JUCE_MODULE_DECLARATION
+
+    ID:               zstd
+    vendor:           facebook
+    version:          1.5.7
+    name:             Zstandard Compression Library
+    description:      Zstandard is a fast lossless compression algorithm with high compression ratios.
+    website:          https://github.com/facebook/zstd
+    license:          BSD-3-Clause
+
+    dependencies:
+    searchpaths:
+
+  END_JUCE_MODULE_DECLARATION
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "lib/zstd.h"
+#include "lib/zstd_errors.h"
+#include "lib/zdict.h"